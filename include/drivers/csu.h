@@ -0,0 +1,226 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        csu.h
+ * Module:      CSU Crypto Engine Driver Interface (SHA3-384 / AES-256-GCM)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (CSU @ 0xFFCA0000, CSU-DMA @ 0xFFC80000)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Image hashing and authenticated decryption on the Configuration and
+ * Security Unit. The secure stream switch (SSS) routes CSU-DMA into the
+ * SHA3 or AES engine; the CPU only programs the transfer and is free
+ * until it polls the operation (csu_poll) or waits for it (csu_wait).
+ *
+ * OPERATIONS:
+ * One operation in flight per device. csu_sha3_start() / csu_aes_start()
+ * return at once; the result is in the csu_op_t when csu_poll() returns 1.
+ * - SHA3-384: the engine does not pad. Whole 104-byte blocks are streamed
+ *   from the image, then the tail and its padding from a bounce buffer
+ *   with LAST_WORD set.
+ * - AES-256-GCM, 96-bit IV, no AAD: the CSU image layout. The tag follows
+ *   the data: encryption writes len + 16 bytes, decryption reads them.
+ *   The key goes through the KUP registers and is cleared afterwards.
+ *
+ * SOFTWARE FALLBACK:
+ * Without an engine (csu_init with csu_base 0), or for buffers the DMA
+ * cannot take (not word-aligned, odd length, an AES destination not on a
+ * cache line), operations run to
+ * completion inside the start call on lib/sha3 and lib/aes_gcm (ARMv8
+ * crypto extensions when present). op->sw records which path ran.
+ *
+ * CSU-DMA is not coherent: sources are cleaned and destinations
+ * invalidated by the driver, so an AES destination must not share its
+ * first or last cache line with other data.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_CSU_H_
+#define _PHOTONX_DRIVERS_CSU_H_
+
+#include <stdint.h>
+#include "platform/zynqmp_hardware.h"
+#include "lib/sha3.h"
+#include "lib/aes_gcm.h"
+
+#define ZYNQMP_CSU_DMA_BASE         0xFFC80000UL
+
+/* =========================================================================
+ * CSU REGISTER OFFSETS (Relative to ZYNQMP_CSU_BASE)
+ * ========================================================================= */
+#define CSU_SSS_CFG_OFFSET          0x0008
+#define CSU_DMA_RESET_OFFSET        0x000C
+
+#define CSU_AES_STATUS_OFFSET       0x1000
+#define CSU_AES_KEY_SRC_OFFSET      0x1004
+#define CSU_AES_KEY_LOAD_OFFSET     0x1008
+#define CSU_AES_START_MSG_OFFSET    0x100C
+#define CSU_AES_RESET_OFFSET        0x1010
+#define CSU_AES_KEY_CLEAR_OFFSET    0x1014
+#define CSU_AES_CFG_OFFSET          0x1018
+#define CSU_AES_KUP_WR_OFFSET       0x101C
+#define CSU_AES_KUP_OFFSET(n)       (0x1020 + 4 * (n))     // n = 0..7, KUP_0 = key bits 255:224
+#define CSU_AES_IV_OFFSET(n)        (0x1040 + 4 * (n))     // n = 0..3
+
+#define CSU_SHA_START_OFFSET        0x2000
+#define CSU_SHA_RESET_OFFSET        0x2004
+#define CSU_SHA_DONE_OFFSET         0x2008
+#define CSU_SHA_DIGEST_OFFSET(n)    (0x2010 + 4 * (n))     // n = 0..11, DIGEST_11 = bytes 0-3
+
+/* SSS_CFG: source per destination, 4 bits each */
+#define CSU_SSS_SRC_DMA             0x5
+#define CSU_SSS_SRC_AES             0xA
+#define CSU_SSS_SHA_SHIFT           12
+#define CSU_SSS_AES_SHIFT           8
+#define CSU_SSS_DMA_SHIFT           4
+#define CSU_SSS_SHA                 (CSU_SSS_SRC_DMA << CSU_SSS_SHA_SHIFT)
+#define CSU_SSS_AES                 ((CSU_SSS_SRC_DMA << CSU_SSS_AES_SHIFT) | \
+                                     (CSU_SSS_SRC_AES << CSU_SSS_DMA_SHIFT))
+
+/* AES_STATUS */
+#define CSU_AES_STS_BUSY            (1 << 0)
+#define CSU_AES_STS_READY           (1 << 1)
+#define CSU_AES_STS_DONE            (1 << 2)
+#define CSU_AES_STS_TAG_PASS        (1 << 3)
+#define CSU_AES_STS_KEY_INIT_DONE   (1 << 4)
+#define CSU_AES_STS_KEY_ZEROED      (1 << 8)
+#define CSU_AES_STS_KUP_ZEROED      (1 << 9)
+
+#define CSU_AES_KEY_SRC_KUP         0x0
+#define CSU_AES_CFG_ENCRYPT         0x1
+#define CSU_AES_KEY_CLEAR_ALL       0x3     // AES key and KUP
+
+/* =========================================================================
+ * CSU-DMA REGISTER OFFSETS (Relative to ZYNQMP_CSU_DMA_BASE)
+ * ========================================================================= */
+#define CSU_DMA_SRC                 0x000
+#define CSU_DMA_DST                 0x800
+#define CSU_DMA_ADDR_OFFSET         0x000
+#define CSU_DMA_SIZE_OFFSET         0x004   // Bytes, word multiple; starts the transfer
+#define CSU_DMA_STS_OFFSET          0x008
+#define CSU_DMA_CTRL_OFFSET         0x00C
+#define CSU_DMA_I_STS_OFFSET        0x014   // Write-1-to-clear
+#define CSU_DMA_I_EN_OFFSET         0x018
+#define CSU_DMA_ADDR_MSB_OFFSET     0x028
+
+#define CSU_DMA_SIZE_LAST_WORD      (1U << 0)   // Source: end of message
+#define CSU_DMA_STS_BUSY            (1U << 0)
+#define CSU_DMA_I_DONE              (1U << 1)
+#define CSU_DMA_MAX_XFER            0x1FFFFFFCU
+
+/* =========================================================================
+ * DRIVER TYPES
+ * ========================================================================= */
+#define CSU_OK                      0
+#define CSU_ERR_INVALID             (-1)
+#define CSU_ERR_BUSY                (-2)    // Another operation in flight
+#define CSU_ERR_HW                  (-3)
+#define CSU_ERR_TIMEOUT             (-4)
+#define CSU_ERR_AUTH                (-5)    // Tag or digest mismatch
+
+#define CSU_AES_TAG_SIZE            AES_GCM_TAG_SIZE
+
+typedef enum {
+    CSU_OP_SHA3 = 0,
+    CSU_OP_AES_ENCRYPT,
+    CSU_OP_AES_DECRYPT
+} csu_op_kind_t;
+
+typedef enum {
+    CSU_OP_IDLE = 0,
+    CSU_OP_BODY,                    // Streaming whole blocks from the image
+    CSU_OP_TAIL,                    // Padded last block (SHA3)
+    CSU_OP_FINISH,                  // Waiting for the engine to drain
+    CSU_OP_DONE
+} csu_op_state_t;
+
+/*
+ * struct csu_op_t
+ * One hash or cipher operation. Caller-owned; must stay put until done.
+ */
+typedef struct {
+    uint32_t kind;                  // csu_op_kind_t
+    volatile uint32_t state;        // csu_op_state_t
+    int result;                     // CSU_OK / CSU_ERR_* once done
+    uint8_t sw;                     // 1 = ran on the software fallback
+    const uint8_t *src;
+    uint8_t *dst;
+    uint64_t len;                   // Payload bytes (without the tag)
+    uint64_t pos;                   // Bytes handed to the DMA so far
+    uint32_t inflight;              // Bytes of the source transfer in flight
+    uint64_t start_ticks;
+    uint8_t digest[SHA3_384_DIGEST_SIZE];
+    uint8_t pad[SHA3_384_BLOCK_SIZE] __attribute__((aligned(64)));
+} csu_op_t;
+
+struct csu_model;
+
+/*
+ * struct csu_device_t
+ * The CSU crypto engines and their DMA.
+ */
+typedef struct {
+    uintptr_t base;                 // CSU register block, 0 = no engine
+    uintptr_t dma_base;
+    struct csu_model *model;        // Non-NULL: route MMIO to the stand-in model
+    csu_op_t *cur;                  // Operation in flight
+    aes_gcm_ctx_t sw_aes;           // Fallback key schedule
+
+    /* Statistics */
+    uint64_t hw_ops;
+    uint64_t sw_ops;
+    uint64_t bytes;
+    uint64_t auth_failures;
+} csu_device_t;
+
+extern csu_device_t csu0;
+
+/* =========================================================================
+ * MMIO ACCESSORS
+ * ========================================================================= */
+uint32_t csu_model_read(struct csu_model *m, uint32_t offset);
+void csu_model_write(struct csu_model *m, uint32_t offset, uint32_t val);
+uint32_t csu_model_dma_read(struct csu_model *m, uint32_t offset);
+void csu_model_dma_write(struct csu_model *m, uint32_t offset, uint32_t val);
+
+static inline uint32_t csu_rd(csu_device_t *dev, uint32_t offset) {
+    if (dev->model) return csu_model_read(dev->model, offset);
+    return *(volatile uint32_t *)(dev->base + offset);
+}
+
+static inline void csu_wr(csu_device_t *dev, uint32_t offset, uint32_t val) {
+    if (dev->model) {
+        csu_model_write(dev->model, offset, val);
+        return;
+    }
+    *(volatile uint32_t *)(dev->base + offset) = val;
+}
+
+static inline uint32_t csu_dma_rd(csu_device_t *dev, uint32_t offset) {
+    if (dev->model) return csu_model_dma_read(dev->model, offset);
+    return *(volatile uint32_t *)(dev->dma_base + offset);
+}
+
+static inline void csu_dma_wr(csu_device_t *dev, uint32_t offset, uint32_t val) {
+    if (dev->model) {
+        csu_model_dma_write(dev->model, offset, val);
+        return;
+    }
+    *(volatile uint32_t *)(dev->dma_base + offset) = val;
+}
+
+/* Function Prototypes */
+int csu_init(csu_device_t *dev, uintptr_t base, uintptr_t dma_base, struct csu_model *model);
+int csu_sha3_start(csu_device_t *dev, csu_op_t *op, const void *data, uint64_t len);
+int csu_aes_start(csu_device_t *dev, csu_op_t *op, const uint8_t key[AES_GCM_KEY_SIZE],
+                  const uint8_t iv[AES_GCM_IV_SIZE], const void *in, void *out,
+                  uint64_t len, int encrypt);
+int csu_poll(csu_device_t *dev, csu_op_t *op);
+int csu_wait(csu_device_t *dev, csu_op_t *op, uint64_t timeout_us);
+int csu_verify_image(csu_device_t *dev, const void *image, uint64_t len,
+                     const uint8_t digest[SHA3_384_DIGEST_SIZE]);
+int csu_selftest(csu_device_t *dev);
+void csu_benchmark(void);
+
+#endif /* _PHOTONX_DRIVERS_CSU_H_ */
@@ -0,0 +1,78 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        csu_model.h
+ * Module:      CSU Crypto Behavioral Model (QEMU / Host Stand-In)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Model of the CSU SSS, SHA3 and AES-GCM engines and the CSU-DMA channels,
+ * which QEMU does not emulate. The driver routes MMIO through
+ * csu_model_read/write (CSU block) and csu_model_dma_read/write (DMA
+ * block) when a model is attached.
+ *
+ * Like the HOCS model it is lazy: a source transfer completes once the
+ * attached clock has passed its modelled end, checked on register access.
+ *
+ * TIMING:
+ * xfer_ns = setup_ns + bytes * 1000 / (sha|aes)_bytes_per_us
+ * Transfers queue behind each other; the destination channel completes
+ * with the source transfer that ends the message.
+ *
+ * With functional = 1 the data really goes through lib/sha3 and
+ * lib/aes_gcm at completion (on the CPU, inside the register access).
+ * Set it to 0 for timing-only runs: digests read as zero, nothing is
+ * written to the destination and every tag passes.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_CSU_MODEL_H_
+#define _PHOTONX_DRIVERS_CSU_MODEL_H_
+
+#include <stdint.h>
+#include "drivers/csu.h"
+
+#define CSU_MODEL_AES_REG_WORDS     20      // 0x1000 - 0x104C
+#define CSU_MODEL_SHA_REG_WORDS     16      // 0x2000 - 0x203C
+#define CSU_MODEL_DMA_REG_WORDS     11      // 0x000 - 0x028, per channel
+
+/* Default Timing (CSU at 400 MHz, 32-bit stream switch) */
+#define CSU_MODEL_SETUP_NS          1000
+#define CSU_MODEL_SHA_BYTES_PER_US  400     // ~400 MB/s
+#define CSU_MODEL_AES_BYTES_PER_US  380
+
+typedef struct csu_model {
+    uint32_t sss_cfg;
+    uint32_t aes_regs[CSU_MODEL_AES_REG_WORDS];
+    uint32_t sha_regs[CSU_MODEL_SHA_REG_WORDS];
+    uint32_t dma_regs[2][CSU_MODEL_DMA_REG_WORDS];     // Source, destination
+
+    /* Timing Parameters */
+    uint32_t setup_ns;
+    uint32_t sha_bytes_per_us;
+    uint32_t aes_bytes_per_us;
+    uint8_t  functional;            // 1 = really hash / encrypt
+
+    /* Engine State */
+    uint8_t  busy;                  // Source transfer in flight
+    uint8_t  key_loaded;
+    uint64_t busy_until_ns;
+    sha3_ctx_t sha;
+    aes_gcm_ctx_t aes;
+
+    /* Environment */
+    uint64_t (*clock_ns)(void);
+
+    /* Statistics */
+    uint64_t xfers;
+    uint64_t busy_ns;
+    uint64_t sha_bytes;
+    uint64_t aes_bytes;
+} csu_model_t;
+
+/* Function Prototypes */
+void csu_model_init(csu_model_t *m, uint64_t (*clock_ns)(void));
+void csu_model_advance(csu_model_t *m);
+
+#endif /* _PHOTONX_DRIVERS_CSU_MODEL_H_ */
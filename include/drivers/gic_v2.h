@@ -38,6 +38,9 @@
 
 #define GIC_DIST_BASE       0xF9010000UL
 #define GIC_CPU_BASE        0xF9020000UL
+#define GIC_HYP_BASE        0xF9040000UL    // GICH: virtual interface control (EL2)
+#define GIC_VCPU_BASE       0xF9060000UL    // GICV: a guest's view of GICC
+#define GIC_CPU_SIZE        0x20000UL       // 4KB pages aliased over 64KB
 
 /* =========================================================================
  * DISTRIBUTOR REGISTERS (GICD_)
@@ -90,12 +93,39 @@
 #define GICC_HPPIR          (GIC_CPU_BASE + 0x0018) // Highest Pending Interrupt
 #define GICC_ABPR           (GIC_CPU_BASE + 0x001C) // Aliased Binary Point
 #define GICC_IIDR           (GIC_CPU_BASE + 0x00FC) // CPU Interface Identification
+#define GICC_DIR            (GIC_CPU_BASE + 0x10000) // Deactivate (second page, 64KB aliased)
+
+/* =========================================================================
+ * VIRTUAL INTERFACE CONTROL REGISTERS (GICH_, this core's view)
+ * Used by the hypervisor to inject interrupts into a guest.
+ * ========================================================================= */
+#define GICH_HCR            (GIC_HYP_BASE + 0x000)  // Hypervisor Control
+#define GICH_VTR            (GIC_HYP_BASE + 0x004)  // VGIC Type (ListRegs - 1)
+#define GICH_VMCR           (GIC_HYP_BASE + 0x008)  // Virtual Machine Control
+#define GICH_MISR           (GIC_HYP_BASE + 0x010)  // Maintenance Interrupt Status
+#define GICH_ELSR0          (GIC_HYP_BASE + 0x030)  // Empty List Register Status
+#define GICH_APR            (GIC_HYP_BASE + 0x0F0)  // Active Priorities
+#define GICH_LR(n)          (GIC_HYP_BASE + 0x100 + ((n) * 4))
+
+#define GICH_HCR_EN         (1U << 0)
+#define GICH_HCR_UIE        (1U << 1)   // Maintenance IRQ when at most one LR is in use
+#define GICH_MAINT_IRQ      25          // Maintenance interrupt (PPI)
+
+/* List register fields */
+#define GICH_LR_VID(id)     ((uint32_t)(id) & 0x3FF)
+#define GICH_LR_PID(id)     (((uint32_t)(id) & 0x3FF) << 10)    // With HW = 1
+#define GICH_LR_CPUID(c)    (((uint32_t)(c) & 0x7) << 10)       // SGI source, HW = 0
+#define GICH_LR_PRIO(p)     ((((uint32_t)(p) >> 3) & 0x1F) << 23)
+#define GICH_LR_PENDING     (1U << 28)
+#define GICH_LR_ACTIVE      (1U << 29)
+#define GICH_LR_HW          (1U << 31)  // Guest deactivation deactivates the physical IRQ
 
 /* =========================================================================
  * CONSTANTS & MASKS
  * ========================================================================= */
 #define GICD_CTLR_ENABLE    0x1     // Enable Distributor
 #define GICC_CTLR_ENABLE    0x1     // Enable CPU Interface
+#define GICC_CTLR_EOIMODE   (1 << 9) // EOImodeNS: EOIR drops priority, GICC_DIR deactivates
 
 #define MAX_IRQS            1024    // Maximum supported interrupts in GICv2
 #define IRQ_SGI_START       0       // Software Generated (0-15)
@@ -115,15 +145,25 @@
 #define TARGET_CPU2         (1 << 2)
 #define TARGET_CPU3         (1 << 3)
 
+/* =========================================================================
+ * IRQ DISPATCH
+ * ========================================================================= */
+typedef void (*irq_handler_t)(uint32_t irq_id, void *arg);
+
 /* =========================================================================
  * FUNCTION PROTOTYPES
  * ========================================================================= */
 void gic_init(void);
+void gic_cpu_interface_init(void);
 void gic_enable_irq(uint32_t irq_id);
 void gic_disable_irq(uint32_t irq_id);
 void gic_set_priority(uint32_t irq_id, uint8_t priority);
 void gic_set_target(uint32_t irq_id, uint8_t cpu_mask);
+void gic_send_sgi(uint32_t sgi_id, uint8_t cpu_mask);
 uint32_t gic_acknowledge_irq(void);
 void gic_end_of_irq(uint32_t irq_id);
+int gic_register_handler(uint32_t irq_id, irq_handler_t handler, void *arg);
+void gic_unregister_handler(uint32_t irq_id);
+void gic_handle_irq_c_handler(void);
 
 #endif /* _PHOTONX_DRIVERS_GIC_V2_H_ */
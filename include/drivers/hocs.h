@@ -0,0 +1,358 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs.h
+ * Module:      HOCS Optical Accelerator Driver Interface
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (PL @ AXI HPC0/HPC1)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Job submission interface for the Hybrid Optical Computing System IP.
+ *
+ * The IP consumes a ring of job descriptors in DDR. Software fills a
+ * descriptor, then writes the new producer index to RING_DOORBELL. The IP
+ * processes descriptors in order, writes their status word back and advances
+ * RING_COMPLETED. HOCS_IRQ_DONE is raised after every completed descriptor.
+ *
+ * JOB SEMANTICS:
+ * src_addr -> operand block [A | B], two NxN float32 matrices back to back
+ * dst_addr -> result C = A x B, NxN float32
+ *
+ * RESIDENT WEIGHTS (weight-stationary):
+ * The IP keeps up to HOCS_WEIGHT_SLOTS B matrices in PL URAM. A LOAD_W
+ * descriptor fills a slot from src_addr; a RESIDENT descriptor then streams
+ * only the activation rows (rows x N at src_addr, rows x N result at
+ * dst_addr) against the slot. hocs_weights_register() hides the slots
+ * behind handles and an LRU cache keyed by a content hash, so re-registering
+ * the same matrix costs a hash, not an upload. Keep the handle rather than
+ * re-registering per job when you can: hashing reads the whole matrix.
+ *
+ * ELEMENT FORMATS:
+ * Operands streamed from src_addr (A, and B of a full job) may be fp32,
+ * fp16 or int8 (HOCS_DESC_F_IN_FMT); the optical core has about 8 bits of
+ * effective precision, so the narrow formats lose little and cut the
+ * input DMA 2-4x. Results may be written as fp16 (HOCS_DESC_F_OUT_FP16),
+ * scaled by 2^-shift first to stay in range. Resident weights are always
+ * fp32. Scales are applied in software (hocs_quant.h).
+ *
+ * SHADOW DOORBELL:
+ * With CONTROL.DB_SHADOW set the IP takes the producer index from the
+ * 32-bit word at DB_ADDR + HOCS_DB_SQ_TAIL (polled over the coherent port
+ * while the ring is not idle) instead of RING_DOORBELL, and mirrors
+ * RING_COMPLETED to DB_ADDR + HOCS_DB_CQ_TAIL after each status write-back.
+ * Both live in one page that can be handed to an EL0 task (hocs_uring.h).
+ *
+ * SCRATCH:
+ * A job (or a batch of jobs) may name an arena for its temporaries. Each
+ * queued job holds a reference from hocs_submit() until its completion
+ * callback has returned; the arena is reset when the last one drops.
+ * Allocate with hocs_job_scratch() before submitting.
+ *
+ * PAYLOAD CHECKSUMS:
+ * With CONTROL.CRC_EN set the IP computes CRC-32C (lib/crc32c.h) over the
+ * bytes its input DMA read and its output DMA wrote, and stores both in
+ * the hocs_crc_t entry at CRC_BASE matching the descriptor's ring slot,
+ * ahead of the status word. hocs_set_verify() selects what the driver
+ * does with them on completion:
+ * - HOCS_VERIFY_INPUT: compare against the checksum of the source taken
+ *   at submit (or supplied by the producer, HOCS_JOB_F_SRC_CRC).
+ * - HOCS_VERIFY_FULL: also checksum the result and compare, unless the
+ *   job defers that to its consumer (HOCS_JOB_F_DST_DEFER, e.g. the
+ *   dequantize pass of hocs_quant_result()). The job then completes as
+ *   HOCS_VERIFY_PENDING until the consumer's check. Not with a linearity
+ *   correction attached: it rewrites the result before the consumer sees
+ *   it, so the driver checks first.
+ * A mismatch completes the job with HOCS_JOB_ERROR.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_HOCS_H_
+#define _PHOTONX_DRIVERS_HOCS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "platform/zynqmp_hardware.h"
+
+/* =========================================================================
+ * REGISTER OFFSETS (Relative to instance base)
+ * ========================================================================= */
+#define HOCS_CONTROL_OFFSET         0x0000
+#define HOCS_STATUS_OFFSET          0x0004
+#define HOCS_IRQ_ENABLE_OFFSET      0x0008
+#define HOCS_IRQ_STATUS_OFFSET      0x000C
+#define HOCS_MATRIX_DIM_OFFSET      0x0010
+#define HOCS_WAVELENGTH_OFFSET      0x0014
+#define HOCS_PHASE_SHIFT_OFFSET     0x0018
+#define HOCS_LASER_POWER_OFFSET     0x001C
+#define HOCS_TEMP_SENSOR_1_OFFSET   0x0040
+#define HOCS_TEMP_SENSOR_2_OFFSET   0x0044
+#define HOCS_TEC_CONTROL_OFFSET     0x0048
+#define HOCS_RING_BASE_L_OFFSET     0x0050
+#define HOCS_RING_BASE_H_OFFSET     0x0054
+#define HOCS_RING_SIZE_OFFSET       0x0058
+#define HOCS_RING_DOORBELL_OFFSET   0x005C
+#define HOCS_RING_COMPLETED_OFFSET  0x0060
+#define HOCS_CHAN_SEL_OFFSET        0x0064
+#define HOCS_CHAN_MONITOR_OFFSET    0x0068
+#define HOCS_DB_ADDR_L_OFFSET       0x0070
+#define HOCS_DB_ADDR_H_OFFSET       0x0074
+#define HOCS_CRC_BASE_L_OFFSET      0x0078
+#define HOCS_CRC_BASE_H_OFFSET      0x007C
+
+/* =========================================================================
+ * CONFIGURATION
+ * ========================================================================= */
+#define HOCS_RING_ENTRIES           256     // Must be a power of 2
+#define HOCS_MAX_DIM                256     // Largest NxN supported by the IP
+
+/* Optical Front-End */
+#define HOCS_NUM_CHANNELS           144     // VCSEL channels
+#define HOCS_CHANNEL_GROUPS         4       // Warm-up groups (36 channels each)
+#define HOCS_THERMAL_ZONES          2       // TEMP_SENSOR_1/2, one TEC loop each
+#define HOCS_DAC_MAX                0x0FFF  // LASER_POWER: 12-bit DAC code
+#define HOCS_PHASE_STEPS            4096    // PHASE_SHIFT: 12 bits per 2*pi
+
+/* TEC_CONTROL: [15:0] zone 1 setpoint, [31:16] zone 2 setpoint (0.01 C) */
+#define HOCS_TEC_PACK(z1, z2)       (((uint32_t)(z2) << 16) | ((z1) & 0xFFFF))
+#define HOCS_TEC_ZONE(v, z)         (((v) >> (16 * (z))) & 0xFFFF)
+
+/* Resident Weights (PL URAM: 4 x 256x256 float32) */
+#define HOCS_WEIGHT_SLOTS           4
+#define HOCS_WEIGHT_SLOT_BYTES      (HOCS_MAX_DIM * HOCS_MAX_DIM * sizeof(float))
+
+/* Descriptor Flags */
+#define HOCS_DESC_F_LOAD_W          (1U << 0)   // src -> B only, stored in the weight slot
+#define HOCS_DESC_F_RESIDENT        (1U << 1)   // src -> A rows only, B from the weight slot
+#define HOCS_DESC_F_IN_FMT(f)       (((uint32_t)(f) & 0x3) << 2)  // Streamed operand format
+#define HOCS_DESC_F_SLOT(s)         (((uint32_t)(s) & 0xF) << 4)
+#define HOCS_DESC_F_OUT_FP16        (1U << 8)   // Result stored as fp16
+#define HOCS_DESC_F_OUT_SHIFT(s)    (((uint32_t)(s) & 0xF) << 9)  // Result x 2^-s before the store
+#define HOCS_DESC_F_ROWS(r)         (((uint32_t)(r) & 0xFFFF) << 16)   // 0 = N
+#define HOCS_DESC_SLOT(f)           (((f) >> 4) & 0xF)
+#define HOCS_DESC_ROWS(f)           (((f) >> 16) & 0xFFFF)
+#define HOCS_DESC_IN_FMT(f)         (((f) >> 2) & 0x3)
+#define HOCS_DESC_OUT_SHIFT(f)      (((f) >> 9) & 0xF)
+
+/* Element Formats (HOCS_DESC_F_IN_FMT) */
+#define HOCS_FMT_FP32               0
+#define HOCS_FMT_FP16               1
+#define HOCS_FMT_INT8               2
+#define HOCS_DESC_F_DRIVER_MASK     0xFFFF00F3U // Set by the driver only
+
+/*
+ * Readout units: a result of v in the descriptor's output units was read
+ * out by the ADC as v * hocs_desc_readout_scale(flags) in fp32 units (the
+ * units of the ADC full scale and of the linearity calibration). int8
+ * codes drive the modulators at 1/127 of full swing per step; resident B
+ * is always fp32; the shift is applied after the ADC.
+ */
+static inline float hocs_desc_readout_scale(uint32_t flags) {
+    float k = (float)(1U << HOCS_DESC_OUT_SHIFT(flags));
+
+    if (HOCS_DESC_IN_FMT(flags) == HOCS_FMT_INT8) {
+        k /= (flags & HOCS_DESC_F_RESIDENT) ? 127.0f : 127.0f * 127.0f;
+    }
+    return k;
+}
+
+/* Job Flags (software only, never reach the descriptor) */
+#define HOCS_JOB_F_SRC_CRC          (1U << 13)  // job->src_crc already holds the source checksum
+#define HOCS_JOB_F_DST_DEFER        (1U << 14)  // Result checksum checked by the consumer
+#define HOCS_JOB_F_SW_MASK          (HOCS_JOB_F_SRC_CRC | HOCS_JOB_F_DST_DEFER)
+
+/* Payload Verification (hocs_set_verify) */
+#define HOCS_VERIFY_OFF             0
+#define HOCS_VERIFY_INPUT           1
+#define HOCS_VERIFY_FULL            2
+#define HOCS_VERIFY_PENDING         3           // job->verified only: input passed, result check deferred
+
+/* Shadow Doorbell Page Layout (separate cache lines) */
+#define HOCS_DB_SQ_TAIL             0x00    // Written by software
+#define HOCS_DB_CQ_TAIL             0x40    // Written by the IP
+
+/* Descriptor Status (written back by the IP) */
+#define HOCS_DESC_PENDING           0x0
+#define HOCS_DESC_DONE              0x1
+#define HOCS_DESC_ERROR             0x2
+
+/* Driver Return Codes */
+#define HOCS_OK                     0
+#define HOCS_ERR_INVALID            (-1)
+#define HOCS_ERR_BUSY               (-2)    // Ring full
+#define HOCS_ERR_HW                 (-3)
+#define HOCS_ERR_TIMEOUT            (-4)
+#define HOCS_ERR_EVICTED            (-5)    // Weight handle no longer resident
+#define HOCS_ERR_CRC                (-6)    // Payload checksum mismatch
+
+/* =========================================================================
+ * DATA STRUCTURES
+ * ========================================================================= */
+
+/*
+ * struct hocs_desc_t
+ * Hardware job descriptor (64 bytes, one cache line, DDR resident).
+ * The IP writes the phase timestamps back as it passes each phase, then
+ * the status word. Timestamps are system counter ticks (the PL sees the
+ * same counter as cntpct_el0); 0 = not reached.
+ */
+typedef struct {
+    uint64_t src_addr;
+    uint64_t dst_addr;
+    uint32_t matrix_dim;
+    uint32_t flags;
+    volatile uint32_t status;
+    uint32_t tag;
+    volatile uint64_t ts_start;     // Fetched, input DMA started
+    volatile uint64_t ts_dma_in;    // Operands in
+    volatile uint64_t ts_compute;   // Optical pass + ADC done
+    volatile uint64_t ts_dma_out;   // Result written
+} __attribute__((packed, aligned(64))) hocs_desc_t;
+
+/*
+ * struct hocs_crc_t
+ * Payload checksums of one descriptor (CONTROL.CRC_EN), indexed like the
+ * ring. Written by the IP before the descriptor's status word.
+ */
+typedef struct {
+    uint32_t src;                   // CRC-32C of the input DMA
+    uint32_t dst;                   // CRC-32C of the output DMA (0 for LOAD_W)
+} hocs_crc_t;
+
+typedef enum {
+    HOCS_JOB_IDLE = 0,
+    HOCS_JOB_QUEUED,
+    HOCS_JOB_DONE,
+    HOCS_JOB_ERROR
+} hocs_job_state_t;
+
+struct hocs_job;
+struct arena;
+typedef void (*hocs_done_fn)(struct hocs_job *job, void *ctx);
+
+/*
+ * struct hocs_job_t
+ * Software view of a submitted job. Owned by the caller until completion.
+ */
+typedef struct hocs_job {
+    uint64_t src_addr;
+    uint64_t dst_addr;
+    uint32_t matrix_dim;
+    uint32_t flags;
+    volatile uint32_t state;        // hocs_job_state_t
+    uint32_t tag;                   // Sequence number assigned at submit
+    hocs_done_fn done;              // Optional completion callback
+    void *ctx;
+    struct arena *scratch;          // Optional: temporaries, live until completion
+    uint32_t weights;               // Resident weight handle (0: A and B at src_addr)
+    uint32_t rows;                  // With 'weights': activation rows (0 = N)
+    uint32_t src_crc;               // Source checksum (in with HOCS_JOB_F_SRC_CRC, else out)
+    uint32_t dst_crc;               // Out: result checksum reported by the IP (HOCS_VERIFY_FULL)
+    uint32_t verified;              // Out: HOCS_VERIFY_* level the payload passed
+} hocs_job_t;
+
+/*
+ * struct hocs_weight_slot_t
+ * Driver view of one URAM weight slot.
+ */
+typedef struct {
+    uint64_t hash;                  // Content hash of the matrix
+    uint32_t dim;
+    uint32_t gen;                   // Bumped on every reload (stale handle check)
+    uint64_t last_use;              // LRU stamp
+    volatile uint32_t inflight;     // Queued jobs using the slot (load included)
+    uint8_t valid;
+    hocs_job_t load_job;
+} hocs_weight_slot_t;
+
+struct hocs_model;
+struct hocs_telem;
+struct hocs_lincal;
+struct hocs_recorder;
+
+/*
+ * struct hocs_device_t
+ * One HOCS instance (register block + descriptor ring).
+ */
+typedef struct {
+    const char *name;
+    uintptr_t base;                 // Register block base
+    uint32_t irq_num;
+    struct hocs_model *model;       // Non-NULL: route MMIO to behavioral model
+    uint32_t buf_flags;             // PMM flags of buffers homed on this port
+    volatile uint32_t user;         // Ring granted to an EL0 task (hocs_uring_attach)
+    struct hocs_telem *telem;       // Optional latency telemetry (hocs_telemetry_attach)
+    struct hocs_lincal *lincal;     // Optional result correction (hocs_lincal_attach)
+    struct hocs_recorder *rec;      // Optional job-stream capture (hocs_record_attach)
+    uint32_t verify;                // HOCS_VERIFY_* (hocs_set_verify)
+
+    /* Descriptor Ring */
+    hocs_desc_t *ring;
+    hocs_job_t *shadow[HOCS_RING_ENTRIES];
+    uint32_t prod;                  // Next slot to fill
+    uint32_t cons;                  // Next slot to reap
+    hocs_crc_t crc[HOCS_RING_ENTRIES];  // Payload checksums (CRC_BASE)
+
+    /* Resident Weights (LRU) */
+    hocs_weight_slot_t wslot[HOCS_WEIGHT_SLOTS];
+    float *wstage;                  // Staging copies the LOAD_W descriptors read
+    uint64_t wclock;
+
+    /* Statistics */
+    uint64_t submitted;
+    uint64_t completed;
+    uint64_t errors;
+    uint64_t irqs;
+    uint64_t weight_hits;
+    uint64_t weight_loads;
+    uint64_t weight_evictions;
+    uint64_t crc_errors;
+} hocs_device_t;
+
+/* Instances (one per AXI HPC port) */
+extern hocs_device_t hocs0;
+extern hocs_device_t hocs1;
+
+/* =========================================================================
+ * MMIO ACCESSORS
+ * ========================================================================= */
+uint32_t hocs_model_read(struct hocs_model *m, uint32_t offset);
+void hocs_model_write(struct hocs_model *m, uint32_t offset, uint32_t val);
+
+static inline uint32_t hocs_rd(hocs_device_t *dev, uint32_t offset) {
+    if (dev->model) return hocs_model_read(dev->model, offset);
+    return *(volatile uint32_t *)(dev->base + offset);
+}
+
+static inline void hocs_wr(hocs_device_t *dev, uint32_t offset, uint32_t val) {
+    if (dev->model) {
+        hocs_model_write(dev->model, offset, val);
+        return;
+    }
+    *(volatile uint32_t *)(dev->base + offset) = val;
+}
+
+/* Function Prototypes */
+int hocs_init(hocs_device_t *dev, uintptr_t base, uint32_t irq, struct hocs_model *model);
+int hocs_submit(hocs_device_t *dev, hocs_job_t *job);
+uint32_t hocs_poll(hocs_device_t *dev, uint32_t budget);
+int hocs_wait(hocs_device_t *dev, hocs_job_t *job, uint64_t timeout_us);
+void hocs_irq_mask(void *arg);
+void hocs_irq_unmask(void *arg);
+uint32_t hocs_irq_poll(void *arg, uint32_t budget);
+void hocs_irq_handler(uint32_t irq_id, void *arg);
+void *hocs_job_scratch(hocs_job_t *job, size_t size);
+void hocs_desc_bytes(uint32_t flags, uint32_t dim, uint64_t *in_bytes, uint64_t *out_bytes);
+int hocs_set_verify(hocs_device_t *dev, uint32_t mode);
+
+/* Resident Weights */
+int hocs_weights_register(hocs_device_t *dev, const float *b, uint32_t dim, uint32_t *handle);
+int hocs_weights_resident(hocs_device_t *dev, uint32_t handle);
+void hocs_weights_benchmark(void);
+
+/* Operand/Result Buffers (high DDR window when installed) */
+void *hocs_buf_alloc(size_t size);
+void *hocs_buf_alloc_on(hocs_device_t *dev, size_t size);
+void hocs_buf_free(void *buf, size_t size);
+
+#endif /* _PHOTONX_DRIVERS_HOCS_H_ */
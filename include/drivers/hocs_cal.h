@@ -0,0 +1,88 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_cal.h
+ * Module:      HOCS Laser Calibration (Full Run + Warm-Boot Restore)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * A full calibration brings both TEC loops to their setpoints, warms each
+ * VCSEL group up, then per channel finds the PHASE_SHIFT that peaks the
+ * monitor photodiode and the LASER_POWER code that hits the target optical
+ * power.
+ *
+ * The result is kept in a record in the persistent DDR block
+ * (ZYNQMP_CALSTORE_BASE), with a CRC and the sensor temperatures at the
+ * time of calibration. DDR keeps it across a warm reset, and the PL (and
+ * so the TECs) keeps running through an APU reset. If the live sensors
+ * still match the stamp and are stable, boot just writes the stored values
+ * back and spot-checks a few channels instead of recalibrating.
+ * After a power cycle the DDR copy is gone and the lasers are cold anyway.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_HOCS_CAL_H_
+#define _PHOTONX_DRIVERS_HOCS_CAL_H_
+
+#include <stdint.h>
+#include "drivers/hocs.h"
+
+/* =========================================================================
+ * CONFIGURATION
+ * ========================================================================= */
+#define HOCS_CAL_MAGIC              0x434C5850  // "PXLC"
+#define HOCS_CAL_VERSION            1
+
+#define HOCS_CAL_TARGET_UW          800     // Per-channel optical power
+#define HOCS_CAL_TEC_SETPOINT_CC    4500    // 45.00 C, both zones
+#define HOCS_CAL_TEC_SETTLE_TOL_MC  250     // TEC "at setpoint" band
+#define HOCS_CAL_TEC_TIMEOUT_MS     5000
+#define HOCS_CAL_WARMUP_MS          150     // Per group, VCSEL wavelength settle
+
+/* Warm-Boot Acceptance */
+#define HOCS_CAL_TEMP_TOL_MC        500     // Live vs stamped temperature
+#define HOCS_CAL_STABLE_WINDOW_MS   5       // Two samples this far apart...
+#define HOCS_CAL_STABLE_TOL_MC      100     // ...may differ at most this much
+#define HOCS_CAL_SPOT_CHECKS        8       // Channels re-measured after restore
+#define HOCS_CAL_SPOT_TOL_PCT       3
+
+/*
+ * struct hocs_cal_record_t
+ * Persisted calibration. 'crc' covers version .. full_cal_us.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t channels;
+    uint32_t size;
+    uint32_t cal_count;                         // Full calibrations so far
+    int32_t  temp_mc[HOCS_THERMAL_ZONES];       // Sensors when calibrated
+    uint16_t tec_setpoint[HOCS_THERMAL_ZONES];  // 0.01 C
+    uint16_t power[HOCS_NUM_CHANNELS];          // LASER_POWER DAC codes
+    uint16_t phase[HOCS_NUM_CHANNELS];          // PHASE_SHIFT offsets
+    uint32_t target_uw;
+    uint32_t full_cal_us;                       // Duration of the full run
+    uint32_t crc;
+} hocs_cal_record_t;
+
+typedef enum {
+    HOCS_CAL_PATH_FULL = 0,
+    HOCS_CAL_PATH_WARM
+} hocs_cal_path_t;
+
+typedef struct {
+    hocs_cal_path_t path;
+    const char *reason;             // Why the warm path was (not) taken
+    uint32_t elapsed_us;
+    uint32_t saved_us;              // Full-run time avoided (warm path only)
+} hocs_cal_result_t;
+
+/* Function Prototypes */
+int hocs_cal_boot(hocs_device_t *dev, hocs_cal_result_t *res);
+int hocs_cal_full(hocs_device_t *dev, hocs_cal_record_t *rec);
+int hocs_cal_apply(hocs_device_t *dev, const hocs_cal_record_t *rec);
+void hocs_cal_invalidate(void);
+
+#endif /* _PHOTONX_DRIVERS_HOCS_CAL_H_ */
@@ -0,0 +1,130 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_conv.h
+ * Module:      HOCS Convolution Front End (conv2d Lowering)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Lowers conv2d (CHW input, OIHW weights, CHW output, square kernel,
+ * cross-correlation as in CNN frameworks) onto the HOCS matrix engine.
+ * hocs_conv_plan() picks one of two lowerings from the layer shape:
+ *
+ * IM2COL: out[pixels x OC] = patches[pixels x IC*k*k] x W[IC*k*k x OC],
+ *         cut into N x N weight tiles that are made resident one at a
+ *         time (weight-stationary). Patch tiles are extracted lazily, one
+ *         job's worth at a time, into a ring of HOCS_CONV_DEPTH staging
+ *         buffers: the next tile is built while the previous ones run.
+ *         Partial products over the IC*k*k dimension are summed on the CPU.
+ *
+ * FFT:    overlap-save over n x n input tiles (n a power of 2, >= 2k). The
+ *         2-D DFT is itself two matrix products, X -> F X F, so both
+ *         transforms run on HOCS against the resident real and imaginary
+ *         DFT matrices; the per-bin complex multiply-accumulate over input
+ *         channels runs on the CPU. Cost grows with n^2 instead of k^2,
+ *         which pays off for large kernels. Stride 1 only.
+ *
+ * HOCS_CONV_AUTO compares rough cost estimates of both (DMA bytes and job
+ * setup at the IP's nominal rate, CPU flops at HOCS_CONV_CPU_MFLOPS).
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_HOCS_CONV_H_
+#define _PHOTONX_DRIVERS_HOCS_CONV_H_
+
+#include <stdint.h>
+#include "drivers/hocs.h"
+
+#define HOCS_CONV_DEPTH             4       // im2col jobs in flight
+#define HOCS_CONV_FFT_BATCH         32      // Transforms per batch
+#define HOCS_CONV_FFT_MIN           16      // DFT sizes tried, powers of 2
+#define HOCS_CONV_FFT_MAX           64
+#define HOCS_CONV_CPU_MFLOPS        2000    // A53 NEON, sustained (cost model)
+#define HOCS_CONV_TIMEOUT_US        1000000
+
+/* Lowering */
+#define HOCS_CONV_AUTO              0
+#define HOCS_CONV_IM2COL            1
+#define HOCS_CONV_FFT               2
+
+typedef struct {
+    uint32_t in_c;
+    uint32_t in_h;
+    uint32_t in_w;
+    uint32_t out_c;
+    uint32_t k;                     // Kernel is k x k
+    uint32_t stride;
+    uint32_t pad;                   // Zero padding on every side
+} hocs_conv_shape_t;
+
+/* One contiguous kx run of an im2col row: k floats from one input row */
+typedef struct {
+    uint32_t col;                   // First column in the patch row
+    uint32_t ic;
+    uint32_t ky;
+} hocs_conv_run_t;
+
+/* An im2col job in flight */
+typedef struct {
+    hocs_job_t job;
+    float *stage;                   // Patch rows [rows x N]
+    float *part;                    // Partial result [rows x N]
+    uint32_t pix;                   // First output pixel
+    uint32_t rows;
+    uint32_t ot;                    // Output-channel tile
+    uint32_t first;                 // First K tile: store instead of add
+} hocs_conv_slot_t;
+
+typedef struct {
+    hocs_conv_shape_t s;
+    hocs_device_t *dev;
+    uint32_t method;
+    uint32_t out_h;
+    uint32_t out_w;
+    uint64_t est_ns[3];             // Indexed by method (AUTO unused)
+
+    /* IM2COL */
+    uint32_t n;                     // Job dimension
+    uint32_t kt_size;               // Rows of W per K tile
+    uint32_t ot_size;               // Columns of W per output tile
+    uint32_t ktiles;
+    uint32_t otiles;
+    float *wtile;                   // [otiles][ktiles][n x n]
+    uint32_t *handle;               // Resident weight handle per tile
+    hocs_conv_run_t *runs;          // IC*k runs, in patch column order
+    hocs_conv_slot_t slot[HOCS_CONV_DEPTH];
+
+    /* FFT */
+    uint32_t fn;                    // DFT size
+    uint32_t step;                  // Output tile edge (fn - k + 1)
+    float *dft_r;                   // cos(2 pi ab / n)
+    float *dft_i;                   // -sin(2 pi ab / n)
+    uint32_t h_dft_r;
+    uint32_t h_dft_i;
+    float *wspec;                   // [oc][ic] spectra, re then im, n^2 each
+    float *xspec;                   // [ic] spectra of the current tile
+    float *pspec;                   // [oc] products of the current tile
+    float *work;                    // 9 n^2 scratch per batch item, then the real tiles
+    hocs_job_t fjob[4 * HOCS_CONV_FFT_BATCH];
+
+    /* Allocations */
+    void *mem[8];
+    size_t mem_size[8];
+    uint32_t nmem;
+
+    /* Statistics */
+    size_t bytes;                   // Planned memory
+    uint64_t jobs;
+} hocs_conv_t;
+
+/* Function Prototypes */
+int hocs_conv_plan(hocs_conv_t *c, hocs_device_t *dev, const hocs_conv_shape_t *s,
+                   const float *w, uint32_t method);
+int hocs_conv_run(hocs_conv_t *c, const float *in, float *out);
+void hocs_conv_free(hocs_conv_t *c);
+void hocs_conv_reference(const hocs_conv_shape_t *s, const float *in, const float *w, float *out);
+void hocs_conv_benchmark(void);
+
+#endif /* _PHOTONX_DRIVERS_HOCS_CONV_H_ */
@@ -0,0 +1,141 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_graph.h
+ * Module:      HOCS Job Graphs (DAG Executor with Operator Fusion)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Describes a chain of operations such as matmul -> bias -> relu -> matmul
+ * once, as a DAG, and runs it as few HOCS jobs and CPU passes as possible:
+ *
+ *   g = input(x)                       rows x n activations
+ *   h = relu(bias(matmul(g, W1), b1))  W1: n x n, resident on the port
+ *   y = output(matmul(h, W2), dst)
+ *
+ * hocs_graph_compile() groups the nodes. A group is one head (a HOCS
+ * matmul, or a CPU elementwise op) followed by the elementwise ops that
+ * consume its result and nothing else. Those are fused into an epilogue
+ * that runs as a single NEON pass over the result as soon as the job is
+ * reaped, in place, instead of one DDR round trip per op. Intermediates
+ * live in a small pool of cache-line aligned buffers that is recycled in
+ * topological order (the pool slot's next writer waits for its readers),
+ * so a narrow network keeps its working set in L2.
+ *
+ * hocs_graph_run() dispatches every group whose inputs are ready: matmul
+ * groups to their port (independent chains are spread over the ports, a
+ * chain stays on one port so its weights stay resident there), unfused
+ * CPU groups to an idle secondary core, or inline when none is free.
+ *
+ * A graph is built once and run many times. Node ids are returned by the
+ * builders (negative = HOCS_ERR_*), and nodes may only reference earlier
+ * ones, so insertion order is a topological order.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_HOCS_GRAPH_H_
+#define _PHOTONX_DRIVERS_HOCS_GRAPH_H_
+
+#include <stdint.h>
+#include "drivers/hocs.h"
+
+#define HOCS_GRAPH_MAX_NODES        32
+#define HOCS_GRAPH_MAX_PORTS        2
+#define HOCS_GRAPH_MAX_EPI          4       // Fused ops per group
+#define HOCS_GRAPH_MAX_DEPS         8       // Groups a group waits for
+#define HOCS_GRAPH_MAX_BUFS         8       // Intermediate buffer pool
+
+/* Node Operations */
+#define HOCS_GOP_INPUT              0
+#define HOCS_GOP_MATMUL             1       // HOCS: [rows x n] x W[n x n]
+#define HOCS_GOP_BIAS               2       // CPU: + b[col]
+#define HOCS_GOP_RELU               3       // CPU: max(x, 0)
+#define HOCS_GOP_ADD                4       // CPU: + other (same shape)
+
+/* Group Kinds / States */
+#define HOCS_GROUP_NONE             0       // Fused into another group
+#define HOCS_GROUP_INPUT            1
+#define HOCS_GROUP_HOCS             2
+#define HOCS_GROUP_CPU              3
+
+#define HOCS_GROUP_IDLE             0
+#define HOCS_GROUP_RUNNING          1
+#define HOCS_GROUP_DONE             2
+
+/* One fused elementwise op */
+typedef struct {
+    uint8_t op;                     // HOCS_GOP_BIAS / _RELU / _ADD
+    const float *vec;               // BIAS: per-column vector, ADD: second operand
+    int32_t other;                  // ADD: node id of the second operand
+} hocs_graph_epi_t;
+
+/*
+ * struct hocs_graph_node_t
+ * A node; heads of groups also carry the group's execution state.
+ */
+typedef struct {
+    uint8_t op;                     // HOCS_GOP_*
+    uint8_t kind;                   // HOCS_GROUP_* (heads only)
+    uint8_t nepi;
+    uint8_t ndeps;
+    int32_t in[2];
+    const float *arg;               // INPUT: data, MATMUL: W, BIAS: b
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t refs;                  // Consumers (+1 when marked as output)
+    int32_t group;                  // Head of the group computing this value
+    float *out;                     // User buffer for graph outputs
+
+    /* Group (head only) */
+    int32_t tail;                   // Last fused node: the group's value
+    hocs_graph_epi_t epi[HOCS_GRAPH_MAX_EPI];
+    int32_t dep[HOCS_GRAPH_MAX_DEPS];
+    int32_t slot;                   // Pool slot, -1: user or input buffer
+    uint32_t port;
+    uint32_t handle;                // Resident weights on 'port'
+    const float *src;               // Input of the first op (HOCS: the result)
+    float *buf;                     // The group's value
+    volatile uint32_t state;        // HOCS_GROUP_IDLE / _RUNNING / _DONE
+    uint32_t core;                  // CPU group on a secondary (0: inline)
+    hocs_job_t job;
+} hocs_graph_node_t;
+
+typedef struct {
+    float *mem;
+    size_t size;
+} hocs_graph_buf_t;
+
+typedef struct {
+    hocs_device_t *port[HOCS_GRAPH_MAX_PORTS];
+    uint32_t nports;
+    uint32_t nnodes;
+    uint32_t compiled;
+    hocs_graph_node_t node[HOCS_GRAPH_MAX_NODES];
+    hocs_graph_buf_t pool[HOCS_GRAPH_MAX_BUFS];
+    uint32_t npool;
+
+    /* Statistics */
+    uint32_t groups;                // After fusion
+    uint32_t fused;                 // Ops folded into an epilogue
+    uint64_t runs;
+    uint64_t hocs_jobs;
+    uint64_t cpu_offloads;          // CPU groups run on a secondary core
+    uint64_t weight_reloads;        // Evicted between runs, re-registered
+} hocs_graph_t;
+
+/* Function Prototypes */
+int hocs_graph_init(hocs_graph_t *g, hocs_device_t *const *ports, uint32_t nports);
+int hocs_graph_input(hocs_graph_t *g, const float *x, uint32_t rows, uint32_t cols);
+int hocs_graph_matmul(hocs_graph_t *g, int a, const float *w, uint32_t n);
+int hocs_graph_bias(hocs_graph_t *g, int a, const float *b);
+int hocs_graph_relu(hocs_graph_t *g, int a);
+int hocs_graph_add(hocs_graph_t *g, int a, int b);
+int hocs_graph_output(hocs_graph_t *g, int a, float *dst);
+int hocs_graph_compile(hocs_graph_t *g);
+int hocs_graph_run(hocs_graph_t *g, uint64_t timeout_us);
+void hocs_graph_destroy(hocs_graph_t *g);
+void hocs_graph_benchmark(void);
+
+#endif /* _PHOTONX_DRIVERS_HOCS_GRAPH_H_ */
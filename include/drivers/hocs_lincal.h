@@ -0,0 +1,80 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_lincal.h
+ * Module:      HOCS Result Linearity Calibration (Per-Channel LUT Correction)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Raw results come out of per-channel photodiode/ADC chains (result column
+ * j through channel j % HOCS_NUM_CHANNELS), each with its own gain, offset
+ * and compressive response, all of which drift with temperature and laser
+ * power. hocs_cal sets the lasers up; this corrects what they produce.
+ *
+ * Calibration runs reference jobs (a ladder of known levels against an
+ * identity weight matrix) and inverts each channel's measured response
+ * into a piecewise-linear LUT of HOCS_LINCAL_SEGS segments, uniform in the
+ * raw value, so a lookup is one multiply and one truncation. Gain, offset
+ * and nonlinearity are all folded into the table.
+ *
+ * Once attached, every completed job's result is corrected in place by
+ * the reaper before the job is handed back (NEON, one pass), quantized
+ * and fp16 results in their own readout units (hocs_desc_readout_scale). The table is
+ * stamped with the sensor temperatures it was taken at; hocs_lincal_service()
+ * (main loop) re-reads the sensors every HOCS_LINCAL_CHECK_MS and reruns
+ * the calibration when either zone has moved by HOCS_LINCAL_DRIFT_MC, as
+ * soon as the ring is idle.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_HOCS_LINCAL_H_
+#define _PHOTONX_DRIVERS_HOCS_LINCAL_H_
+
+#include <stdint.h>
+#include "drivers/hocs.h"
+
+#define HOCS_LINCAL_SEGS            16      // LUT segments per channel
+#define HOCS_LINCAL_LEVELS          64      // Reference levels measured per channel
+#define HOCS_LINCAL_FULL_SCALE      256.0f  // Levels span +-this (ADC full scale)
+#define HOCS_LINCAL_DRIFT_MC        2000    // Recalibrate after 2 C of drift
+#define HOCS_LINCAL_CHECK_MS        100     // Sensor poll period
+#define HOCS_LINCAL_TIMEOUT_US      100000
+
+typedef struct hocs_lincal {
+    hocs_device_t *dev;
+    volatile uint32_t valid;        // Tables usable (cleared while recalibrating)
+    uint32_t pending;               // Recalibration due, waiting for an idle ring
+    int32_t temp_mc[HOCS_THERMAL_ZONES];    // Sensors when calibrated
+    uint64_t last_check;            // Ticks
+
+    /* Per result column, for vector loads: raw -> segment position */
+    float lo[HOCS_MAX_DIM];
+    float inv_step[HOCS_MAX_DIM];
+    uint32_t base[HOCS_MAX_DIM];    // First segment of the column's channel
+
+    /* Per channel and segment: {value at the segment start, rise over it} */
+    float lut[HOCS_NUM_CHANNELS * HOCS_LINCAL_SEGS][2];
+
+    /* Fit (for reporting) */
+    float gain[HOCS_NUM_CHANNELS];
+    float offset[HOCS_NUM_CHANNELS];
+    uint32_t raw_err_ppm;           // Worst raw error over the levels, ppm of FS
+    uint32_t residual_ppm;          // Same after correction
+
+    /* Statistics */
+    uint32_t calibrations;
+    uint32_t drift_recals;
+    uint64_t corrected_bytes;
+} hocs_lincal_t;
+
+/* Function Prototypes */
+void hocs_lincal_attach(hocs_device_t *dev, hocs_lincal_t *lc);
+int hocs_lincal_calibrate(hocs_lincal_t *lc);
+void hocs_lincal_apply(const hocs_lincal_t *lc, float *buf, uint32_t rows, uint32_t n);
+void hocs_lincal_complete(hocs_device_t *dev, const hocs_desc_t *d);
+int hocs_lincal_service(hocs_lincal_t *lc);
+void hocs_lincal_benchmark(void);
+
+#endif /* _PHOTONX_DRIVERS_HOCS_LINCAL_H_ */
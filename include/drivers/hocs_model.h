@@ -0,0 +1,126 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_model.h
+ * Module:      HOCS Behavioral Model (QEMU / Host Stand-In for the PL IP)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Cycle-approximate model of the HOCS IP register block and descriptor
+ * engine. The driver routes MMIO through hocs_model_read/write when a model
+ * is attached, so the same driver code runs on QEMU (no PL) and in
+ * virtual-time benchmarks.
+ *
+ * The model is lazy: simulated time advances only on register access or an
+ * explicit hocs_model_advance() call, using the attached clock source.
+ *
+ * TIMING:
+ * job_ns = setup_ns + dma(2*N*N*4 bytes in) + compute_ns + dma(N*N*4 bytes out)
+ * LOAD_W:   setup_ns + dma(N*N*4 bytes in)
+ * RESIDENT: setup_ns + dma(R*N*4 bytes in) + compute_ns + dma(R*N*4 bytes out)
+ * with 4 bytes per element replaced by the descriptor's element formats.
+ * The descriptor phase timestamps are written in clock_ns units, not
+ * counter ticks.
+ *
+ * Weight slots hold the address of the loaded matrix instead of a copy;
+ * the driver's staging buffer stands in for the PL URAM and does not
+ * change while a slot is in use.
+ *
+ * READOUT (analog = 1):
+ * Result column j is read out through channel j % HOCS_NUM_CHANNELS, which
+ * has its own gain and offset, a compressive response up to the ADC full
+ * scale (v - v^3 / 12 in units of full scale, clipped at +-1) and a gain
+ * and offset drift with the zone 1 temperature. Off by default: results
+ * are then exact products. Every compute job goes through it, in fp32
+ * units at the ADC (hocs_desc_readout_scale), before the fp16 store.
+ *
+ * FAULT INJECTION:
+ * corrupt_every = N flips one result bit of every Nth job after its
+ * output checksum was taken (CONTROL.CRC_EN), so the driver's payload
+ * verification has something to catch.
+ *
+ * BENCHMARK FIXTURE:
+ * The HOCS benchmarks run one at a time and share hocs_bench: one
+ * model-backed device per port on its own ring, and a virtual clock.
+ * hocs_bench_init() brings a port up fresh; overrides (timing, analog,
+ * buf_flags) go on the model and device after it returns.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_HOCS_MODEL_H_
+#define _PHOTONX_DRIVERS_HOCS_MODEL_H_
+
+#include <stdint.h>
+#include "drivers/hocs.h"
+
+#define HOCS_MODEL_REG_WORDS        32      // 0x00 - 0x7C
+
+/* Default Timing (KV260, 300 MHz PL, 128-bit HPC0) */
+#define HOCS_MODEL_SETUP_NS         400
+#define HOCS_MODEL_COMPUTE_NS       50      // Optical propagation + ADC
+#define HOCS_MODEL_DMA_BYTES_PER_US 4800    // ~4.8 GB/s effective
+#define HOCS_MODEL_TEMP_MC          45000   // Sensor idle reading (milli-C)
+#define HOCS_MODEL_MONITOR_FULL_UW  1200    // Monitor reading at full DAC, best phase
+#define HOCS_MODEL_ADC_FULL_SCALE   256.0f  // Result magnitude at ADC full scale
+
+typedef struct hocs_model {
+    uint32_t regs[HOCS_MODEL_REG_WORDS];
+
+    /* Timing Parameters */
+    uint32_t setup_ns;
+    uint32_t compute_ns;
+    uint32_t dma_bytes_per_us;
+    uint8_t  functional;            // 1 = compute real C = A x B
+    uint8_t  analog;                // 1 = pass results through the readout model
+    uint32_t corrupt_every;         // Flip a result bit every Nth job (0 = never)
+
+    /* Engine State */
+    uint32_t hw_idx;                // Next descriptor to execute
+    uint8_t  busy;
+    uint64_t busy_until_ns;
+    uint64_t wslot_addr[HOCS_WEIGHT_SLOTS];
+    uint32_t wslot_dim[HOCS_WEIGHT_SLOTS];   // 0 = empty
+
+    /* Environment */
+    uint64_t (*clock_ns)(void);
+    void (*raise_irq)(void *arg);
+    void *irq_arg;
+
+    /* Optical Front-End (banked by CHAN_SEL) */
+    uint16_t chan_power[HOCS_NUM_CHANNELS];
+    uint16_t chan_phase[HOCS_NUM_CHANNELS];
+
+    /* Statistics */
+    uint64_t jobs;
+    uint64_t busy_ns;
+    uint64_t dma_bytes;
+    uint64_t corrupted;
+} hocs_model_t;
+
+/* Benchmark Fixture */
+#define HOCS_BENCH_PORTS            2
+
+typedef struct {
+    hocs_desc_t ring[HOCS_BENCH_PORTS][HOCS_RING_ENTRIES] __attribute__((aligned(4096)));
+    hocs_model_t model[HOCS_BENCH_PORTS];
+    hocs_device_t dev[HOCS_BENCH_PORTS];
+    uint64_t now;                   // Virtual time (ns)
+} hocs_bench_t;
+
+extern hocs_bench_t hocs_bench;
+
+/* Function Prototypes */
+void hocs_model_init(hocs_model_t *m, uint64_t (*clock_ns)(void));
+void hocs_model_advance(hocs_model_t *m);
+uint64_t hocs_model_job_ns(const hocs_model_t *m, uint32_t dim);
+void hocs_model_raise_gic(void *arg);
+void hocs_model_set_temp(hocs_model_t *m, int32_t mc);
+
+hocs_device_t *hocs_bench_init(uint32_t port, const char *name, uint64_t (*clock_ns)(void),
+                               uint8_t functional);
+uint64_t hocs_bench_virtual_ns(void);
+uint64_t hocs_bench_stepped_ns(void);
+uint64_t hocs_bench_real_ns(void);
+
+#endif /* _PHOTONX_DRIVERS_HOCS_MODEL_H_ */
@@ -0,0 +1,163 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_quant.h
+ * Module:      HOCS Operand Quantization (int8 / fp16 Pack and Unpack)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Packs fp32 operands into the IP's narrow input formats before DMA and
+ * turns narrow results back into fp32 afterwards (NEON both ways):
+ *
+ *   int8:  q = round(x / s), s = absmax / 127, symmetric. One scale per
+ *          tensor, or per channel: per row of A (each activation vector)
+ *          and per column of B (each output channel). Both factor out of
+ *          the product: C[i][j] = sA[i] * sB[j] * (qA x qB)[i][j].
+ *   fp16:  plain conversion (round to nearest even), scale 1.
+ *
+ * Results can come back as fp16; the shift that keeps them in fp16 range
+ * is chosen from the operand magnitudes and undone in the dequantize pass
+ * together with the scales.
+ *
+ * hocs_quant_job() fills a job from fp32 operands (quantizing into the
+ * caller's src buffer), hocs_quant_result() dequantizes its result.
+ * With cfg.crc both passes also carry the CRC-32C of the bytes they write
+ * or read (hocs_quantize_crc / hocs_dequantize_crc), which the driver's
+ * payload verification (hocs_set_verify) compares with the IP's checksums
+ * instead of reading the buffers again.
+ *
+ * hocs_quant_error() compares a result against a reference in square
+ * blocks, for choosing a format per layer.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_HOCS_QUANT_H_
+#define _PHOTONX_DRIVERS_HOCS_QUANT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "drivers/hocs.h"
+
+#define HOCS_QUANT_FP16_LIMIT       32768.0f    // Largest result magnitude aimed for
+
+/* Scale Granularity */
+#define HOCS_Q_TENSOR               0
+#define HOCS_Q_ROW                  1       // A: per activation vector
+#define HOCS_Q_COL                  2       // B: per output channel
+
+typedef struct {
+    uint32_t in_fmt;                // HOCS_FMT_FP32 / _FP16 / _INT8
+    uint32_t out_fmt;               // HOCS_FMT_FP32 / _FP16
+    uint32_t a_gran;                // HOCS_Q_TENSOR / HOCS_Q_ROW
+    uint32_t b_gran;                // HOCS_Q_TENSOR / HOCS_Q_COL (full jobs)
+    float w_absmax;                 // Resident weights: largest |B| (fp16 results)
+    uint32_t crc;                   // 1 = checksum operands and result in the pack/unpack passes
+} hocs_qcfg_t;
+
+/*
+ * struct hocs_qjob_t
+ * What it takes to turn a quantized job's result back into fp32.
+ */
+typedef struct {
+    hocs_qcfg_t cfg;
+    uint32_t rows;
+    uint32_t n;
+    uint32_t shift;                 // Result was scaled by 2^-shift
+    const void *dst;
+    hocs_job_t *job;                // With cfg.crc: the job, for its result checksum
+    float a_scale[HOCS_MAX_DIM];    // [0] only for HOCS_Q_TENSOR
+    float b_scale[HOCS_MAX_DIM];
+} hocs_qjob_t;
+
+/*
+ * struct hocs_qerr_t
+ * Error of x against ref, in ppm: whole tensor and worst block.
+ */
+typedef struct {
+    uint32_t blocks;
+    uint32_t rms_ppm;               // rms(x - ref) / rms(ref)
+    uint32_t max_ppm;               // max|x - ref| / max|ref|
+    uint32_t worst_block_ppm;       // Highest per-block rms(x - ref) / rms(ref)
+    uint32_t worst_row;             // That block's origin
+    uint32_t worst_col;
+} hocs_qerr_t;
+
+/* =========================================================================
+ * HALF PRECISION (bit-exact, no FPU support needed)
+ * ========================================================================= */
+
+static inline uint16_t hocs_f32_to_f16(float f) {
+    union { float f; uint32_t u; } v = { f };
+    uint32_t sign = (v.u >> 16) & 0x8000, man = v.u & 0x7FFFFF;
+    int32_t e = (int32_t)((v.u >> 23) & 0xFF) - 127 + 15;
+    uint32_t h, rem, half, shift;
+
+    if (e == 128 + 15) {
+        return (uint16_t)(sign | 0x7C00 | (man ? 0x200 : 0));      // Inf / NaN
+    }
+    if (e >= 31) {
+        return (uint16_t)(sign | 0x7C00);                          // Overflow
+    }
+    if (e <= 0) {
+        if (e < -10) {
+            return (uint16_t)sign;
+        }
+        man |= 0x800000;
+        shift = (uint32_t)(14 - e);
+        h = man >> shift;
+        rem = man & ((1U << shift) - 1);
+        half = 1U << (shift - 1);
+    } else {
+        h = ((uint32_t)e << 10) | (man >> 13);
+        rem = man & 0x1FFF;
+        half = 0x1000;
+    }
+    if (rem > half || (rem == half && (h & 1))) {
+        h++;                        // Carry into the exponent is correct
+    }
+    return (uint16_t)(sign | h);
+}
+
+static inline float hocs_f16_to_f32(uint16_t h) {
+    union { uint32_t u; float f; } v;
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1F, man = h & 0x3FF;
+
+    if (exp == 0x1F) {
+        v.u = sign | 0x7F800000 | (man << 13);
+    } else if (exp) {
+        v.u = sign | ((exp + 112) << 23) | (man << 13);
+    } else if (man) {
+        exp = 113;
+        while (!(man & 0x400)) {
+            man <<= 1;
+            exp--;
+        }
+        v.u = sign | (exp << 23) | ((man & 0x3FF) << 13);
+    } else {
+        v.u = sign;
+    }
+    return v.f;
+}
+
+/* Function Prototypes */
+size_t hocs_quant_bytes(uint32_t fmt, uint32_t rows, uint32_t cols);
+float hocs_quantize(const float *x, uint32_t rows, uint32_t cols, uint32_t fmt, uint32_t gran,
+                    void *q, float *scale);
+void hocs_dequantize(const void *q, uint32_t fmt, uint32_t rows, uint32_t cols,
+                     const float *row_scale, const float *col_scale, float k, float *out);
+float hocs_quantize_crc(const float *x, uint32_t rows, uint32_t cols, uint32_t fmt, uint32_t gran,
+                        void *q, float *scale, uint32_t *crc);
+void hocs_dequantize_crc(const void *q, uint32_t fmt, uint32_t rows, uint32_t cols,
+                         const float *row_scale, const float *col_scale, float k, float *out,
+                         uint32_t *crc);
+int hocs_quant_job(hocs_qjob_t *qj, hocs_job_t *job, const hocs_qcfg_t *cfg,
+                   const float *a, const float *b, uint32_t rows, uint32_t n, void *src, void *dst);
+int hocs_quant_result(const hocs_qjob_t *qj, float *c);
+void hocs_quant_error(const float *ref, const float *x, uint32_t rows, uint32_t cols,
+                      uint32_t block, hocs_qerr_t *e);
+void hocs_quant_benchmark(void);
+
+#endif /* _PHOTONX_DRIVERS_HOCS_QUANT_H_ */
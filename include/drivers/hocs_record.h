@@ -0,0 +1,142 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_record.h
+ * Module:      HOCS Job-Stream Record and Replay
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Captures the jobs submitted to a device (shape, flags, inter-arrival
+ * time and a hash of the operands, optionally the operands themselves)
+ * into a flat binary log, and re-issues a log against any device, model
+ * or PL, to compare driver versions on identical production traffic.
+ *
+ * LOG LAYOUT (one contiguous buffer, position independent):
+ *
+ *   hocs_rec_hdr_t | hocs_rec_t x count | payload (64-byte aligned chunks)
+ *
+ * Payload is only present in HOCS_REC_DATA mode: the streamed operands of
+ * every job and each distinct resident weight matrix once. Without it the
+ * replay streams a fixed pattern and synthesizes one matrix per recorded
+ * weight hash, which reproduces the shapes, the timing and the weight
+ * cache's hit/miss sequence but not the results.
+ *
+ * Recording hooks hocs_submit(); jobs EL0 tasks post on a granted ring
+ * (hocs_uring) bypass it and are not captured.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_HOCS_RECORD_H_
+#define _PHOTONX_DRIVERS_HOCS_RECORD_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "drivers/hocs.h"
+#include "drivers/hocs_telemetry.h"
+
+#define HOCS_REC_MAGIC              0x43455248U     // "HREC"
+#define HOCS_REC_VERSION            1
+#define HOCS_REC_ALIGN              64              // Payload chunk alignment
+#define HOCS_REC_NO_DATA            0xFFFFFFFFU
+#define HOCS_REC_WEIGHTS            16              // Weight matrices tracked at once
+#define HOCS_REPLAY_TIMEOUT_US      1000000
+
+/* Capture Modes */
+#define HOCS_REC_SHAPE              0       // Shapes and timing only
+#define HOCS_REC_HASH               1       // + operand content hashes
+#define HOCS_REC_DATA               2       // + operand contents
+
+/*
+ * struct hocs_rec_hdr_t
+ * Log header. 'crc' covers everything after the header.
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t mode;                  // HOCS_REC_*
+    uint32_t count;                 // Records
+    uint32_t dropped;               // Jobs not captured (log full)
+    uint64_t payload_bytes;
+    uint64_t span_ns;               // First to last submission
+    uint16_t crc;                   // CRC-16/CCITT
+    uint16_t rec_bytes;             // sizeof(hocs_rec_t)
+    uint32_t reserved;
+} hocs_rec_hdr_t;
+
+/*
+ * struct hocs_rec_t
+ * One submitted job (40 bytes).
+ */
+typedef struct {
+    uint32_t dt_ns;                 // Since the previous submission (saturates at ~4.3 s)
+    uint32_t flags;                 // Caller flags, plus HOCS_DESC_F_RESIDENT
+    uint16_t dim;
+    uint16_t rows;                  // Resident jobs: activation rows (0 = N)
+    uint32_t data;                  // Operands, in HOCS_REC_ALIGN units (or HOCS_REC_NO_DATA)
+    uint32_t wdata;                 // Weight matrix, likewise
+    uint32_t reserved;
+    uint64_t hash;                  // Streamed operands (0 below HOCS_REC_HASH)
+    uint64_t whash;                 // Resident weight matrix (driver's cache hash)
+} hocs_rec_t;
+
+/*
+ * struct hocs_recorder_t
+ * Capture state. The log buffer is owned by the caller.
+ */
+typedef struct hocs_recorder {
+    hocs_device_t *dev;
+    uint32_t mode;
+    hocs_rec_hdr_t *hdr;
+    hocs_rec_t *rec;
+    uint8_t *payload;
+    uint32_t max_recs;
+    uint64_t max_payload;
+    uint64_t t_first;
+    uint64_t t_last;
+
+    /* Weight matrices already in the payload */
+    uint64_t whash[HOCS_REC_WEIGHTS];
+    uint32_t wdata[HOCS_REC_WEIGHTS];
+    uint32_t wnext;
+} hocs_recorder_t;
+
+/*
+ * struct hocs_replay_t
+ * Replay setup (speed_pct) and results. 100 = recorded rate, 400 = four
+ * times faster, 0 = back to back.
+ */
+typedef struct {
+    uint32_t speed_pct;
+
+    /* Results */
+    uint64_t jobs;
+    uint64_t errors;
+    uint64_t busy_retries;          // Ring full or weight slots pinned
+    uint64_t weight_loads;          // Weight matrices (re)registered
+    uint64_t span_ns;               // Recorded stream duration
+    uint64_t wall_ns;               // Replay duration
+    uint64_t in_bytes;              // Streamed operand bytes
+    uint64_t max_lag_ns;            // Worst submission behind schedule
+    hocs_hist_t latency;            // Submit to reap
+
+    /* Private */
+    hocs_device_t *dev;
+    hocs_job_t job[HOCS_RING_ENTRIES];
+    uint64_t t_submit[HOCS_RING_ENTRIES];
+    uint64_t whash[HOCS_REC_WEIGHTS];
+    uint32_t handle[HOCS_REC_WEIGHTS];
+    uint32_t wnext;
+} hocs_replay_t;
+
+/* Function Prototypes */
+int hocs_record_attach(hocs_device_t *dev, hocs_recorder_t *r, void *log, size_t size,
+                       uint32_t max_jobs, uint32_t mode);
+void hocs_record_submit(hocs_device_t *dev, const hocs_job_t *job, uint32_t flags);
+size_t hocs_record_finish(hocs_recorder_t *r);
+int hocs_replay(hocs_device_t *dev, const void *log, size_t size, hocs_replay_t *rp);
+void hocs_replay_report(const hocs_replay_t *rp, const char *label);
+void hocs_record_benchmark(void);
+
+#endif /* _PHOTONX_DRIVERS_HOCS_RECORD_H_ */
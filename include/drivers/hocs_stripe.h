@@ -0,0 +1,68 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_stripe.h
+ * Module:      HOCS Multi-Port Striping (AXI HPC0 + HPC1)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * One HOCS instance per high-performance AXI port, each with its own
+ * descriptor ring (per-port queue) and IRQ. A stripe set spreads DMA
+ * traffic over them in two ways:
+ *
+ * JOBS:   hocs_stripe_submit() sends a whole job to the port its operand
+ *         buffer is homed on (hocs_buf_alloc_on()), unless that queue is
+ *         more than HOCS_STRIPE_SLACK deeper than the shortest one.
+ * MATRIX: hocs_stripe_matmul() splits one C = A x B by rows. B is made
+ *         resident on every port once, then each port streams its share
+ *         of A and C, so a single large product uses every port.
+ *
+ * Jobs that carry a resident weight handle are bound to the port holding
+ * the weights; submit them with hocs_submit() on that port.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_HOCS_STRIPE_H_
+#define _PHOTONX_DRIVERS_HOCS_STRIPE_H_
+
+#include <stdint.h>
+#include "drivers/hocs.h"
+
+#define HOCS_STRIPE_MAX_PORTS       2
+#define HOCS_STRIPE_SLACK           4       // Queue depth difference before spilling
+
+typedef struct {
+    hocs_device_t *port[HOCS_STRIPE_MAX_PORTS];
+    uint32_t nports;
+    uint32_t rr;                    // Tie-break rotation
+
+    /* Statistics */
+    uint64_t jobs[HOCS_STRIPE_MAX_PORTS];
+    uint64_t home_hits;             // Job ran on its buffer's home port
+    uint64_t spills;                // Moved off its home port to balance queues
+    uint64_t matmuls;
+} hocs_stripe_t;
+
+/*
+ * struct hocs_stripe_op_t
+ * One row-striped product. Owned by the caller until hocs_stripe_wait_op().
+ */
+typedef struct {
+    uint32_t nparts;
+    uint32_t handle[HOCS_STRIPE_MAX_PORTS];
+    hocs_job_t part[HOCS_STRIPE_MAX_PORTS];
+} hocs_stripe_op_t;
+
+/* Function Prototypes */
+int hocs_stripe_init(hocs_stripe_t *s, hocs_device_t *const *ports, uint32_t nports);
+int hocs_stripe_submit(hocs_stripe_t *s, hocs_job_t *job);
+uint32_t hocs_stripe_poll(hocs_stripe_t *s, uint32_t budget);
+int hocs_stripe_wait(hocs_stripe_t *s, hocs_job_t *job, uint64_t timeout_us);
+int hocs_stripe_matmul(hocs_stripe_t *s, hocs_stripe_op_t *op,
+                       const float *a, const float *b, float *c, uint32_t n);
+int hocs_stripe_wait_op(hocs_stripe_t *s, hocs_stripe_op_t *op, uint64_t timeout_us);
+void hocs_stripe_benchmark(void);
+
+#endif /* _PHOTONX_DRIVERS_HOCS_STRIPE_H_ */
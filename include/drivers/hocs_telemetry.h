@@ -0,0 +1,98 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_telemetry.h
+ * Module:      HOCS Per-Job Latency Telemetry
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Splits every job's latency into the phases it went through:
+ *
+ *   submit --queue--> start --dma_in--> operands in --compute--> result
+ *   computed --dma_out--> written --irq--> IRQ entry (or polled reap)
+ *   --wake--> consumer (completion callback, or the reaper itself)
+ *
+ * submit, IRQ and wake are stamped by the driver from cntpct_el0; the
+ * engine phases come from the timestamps the IP writes back into the
+ * descriptor. Each phase feeds a log2 histogram (bucket i holds
+ * [2^i, 2^(i+1)) ns), and the last HOCS_TELEM_RECORDS jobs are kept as
+ * per-job records for export. Completions are also emitted to the binary
+ * trace (TRACE_EV_HOCS_PHASES / TRACE_EV_HOCS_DELIVER).
+ *
+ * All times are nanoseconds. With the behavioral model they are in the
+ * model's clock, which may be virtual.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_HOCS_TELEMETRY_H_
+#define _PHOTONX_DRIVERS_HOCS_TELEMETRY_H_
+
+#include <stdint.h>
+#include "drivers/hocs.h"
+
+#define HOCS_TELEM_RECORDS          1024    // Per-job records kept, power of 2 >= ring
+#define HOCS_TELEM_BUCKETS          32      // 1 ns .. ~4 s
+
+typedef enum {
+    HOCS_PH_QUEUE = 0,
+    HOCS_PH_DMA_IN,
+    HOCS_PH_COMPUTE,
+    HOCS_PH_DMA_OUT,
+    HOCS_PH_IRQ,
+    HOCS_PH_WAKE,
+    HOCS_PH_TOTAL,
+    HOCS_PH_COUNT
+} hocs_phase_t;
+
+typedef struct {
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+    uint32_t bucket[HOCS_TELEM_BUCKETS];
+} hocs_hist_t;
+
+/*
+ * struct hocs_job_rec_t
+ * Export format: one job, 64 bytes. Absolute times in ns, 0 = not seen.
+ */
+typedef struct {
+    uint32_t tag;
+    uint16_t dim;
+    uint8_t status;                 // HOCS_DESC_DONE / HOCS_DESC_ERROR
+    uint8_t kind;                   // HOCS_JOB_KIND_*
+    uint64_t t_submit;
+    uint64_t t_start;
+    uint64_t t_dma_in;
+    uint64_t t_compute;
+    uint64_t t_dma_out;
+    uint64_t t_irq;
+    uint64_t t_wake;
+} hocs_job_rec_t;
+
+#define HOCS_JOB_KIND_FULL          0
+#define HOCS_JOB_KIND_LOAD_W        1
+#define HOCS_JOB_KIND_RESIDENT      2
+
+typedef struct hocs_telem {
+    hocs_job_rec_t rec[HOCS_TELEM_RECORDS];     // Indexed by tag
+    hocs_hist_t hist[HOCS_PH_COUNT];
+    uint64_t irq_ns;                // IRQ entry of the reap in progress (0: polled)
+    uint64_t jobs;
+    uint64_t partial;               // Completions without engine timestamps
+} hocs_telem_t;
+
+/* Function Prototypes */
+void hocs_telemetry_attach(hocs_device_t *dev, hocs_telem_t *t);
+void hocs_telemetry_reset(hocs_device_t *dev);
+void hocs_telemetry_submit(hocs_device_t *dev, hocs_desc_t *d);
+void hocs_telemetry_irq(hocs_device_t *dev);
+void hocs_telemetry_complete(hocs_device_t *dev, const hocs_desc_t *d);
+void hocs_hist_add(hocs_hist_t *h, uint64_t ns);
+uint64_t hocs_hist_percentile(const hocs_hist_t *h, uint32_t pct);
+uint32_t hocs_telemetry_export(hocs_device_t *dev, hocs_job_rec_t *out, uint32_t max);
+void hocs_telemetry_dump(hocs_device_t *dev, int verbose);
+void hocs_telemetry_trace_summary(hocs_device_t *dev);
+
+#endif /* _PHOTONX_DRIVERS_HOCS_TELEMETRY_H_ */
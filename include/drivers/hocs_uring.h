@@ -0,0 +1,170 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_uring.h
+ * Module:      HOCS Kernel-Bypass Submission for EL0 Tasks
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * hocs_uring_attach() grants a whole HOCS instance to the next EL0 task:
+ * its descriptor ring, a shadow doorbell page and a registered buffer
+ * region (MR) are mapped into the user window. The task then fills
+ * descriptors and publishes them by storing its tail into the doorbell
+ * page; the IP picks the tail up from memory and mirrors its completion
+ * index back into the same page. Submitting and reaping never enter the
+ * kernel. SYS_HOCS_WAIT is the only system call on that path: it sleeps
+ * until the next completion, with the instance IRQ enabled only for the
+ * duration of the wait.
+ *
+ * The same task code runs in HOCS_URING_SYSCALL mode, where every submit
+ * and reap is a system call through hocs_submit()/hocs_poll(); this is the
+ * baseline hocs_uring_benchmark() compares against.
+ *
+ * USER VIEW (offsets from USER_MAP_VA):
+ *   0x000000  descriptor ring (bypass mode only)
+ *   0x010000  doorbell page = hocs_uring_t
+ *   0x100000  registered buffer region, physically contiguous
+ *
+ * TRUST:
+ * The task writes physical addresses into descriptors and nothing checks
+ * them before the IP's DMA engine does: without an SMMU context for the
+ * port this grants access to all of DDR. Attach trusted tasks only.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_HOCS_URING_H_
+#define _PHOTONX_DRIVERS_HOCS_URING_H_
+
+#include <stdint.h>
+#include "drivers/hocs.h"
+#include "kernel/user.h"
+
+#define HOCS_URING_BYPASS           0
+#define HOCS_URING_SYSCALL          1
+
+#define HOCS_URING_RING_VA          (USER_MAP_VA)
+#define HOCS_URING_CTL_VA           (USER_MAP_VA + 0x010000UL)
+#define HOCS_URING_MR_VA            (USER_MAP_VA + 0x100000UL)
+#define HOCS_URING_MR_MAX           (64UL * 1024 * 1024)
+
+#define HOCS_URING_WAIT_TIMEOUT_US  100000
+
+/*
+ * struct hocs_uring_t
+ * The doorbell page. The first two cache lines are the IP's shadow
+ * doorbell (HOCS_DB_SQ_TAIL / HOCS_DB_CQ_TAIL); the rest is task state.
+ */
+typedef struct {
+    volatile uint32_t sq_tail;      // Task -> IP: descriptors published
+    uint32_t rsvd0[15];
+    volatile uint32_t cq_tail;      // IP -> task: descriptors completed
+    uint32_t rsvd1[15];
+
+    /* Set up by hocs_uring_attach() */
+    uint64_t ring;                  // User VA of the descriptor ring
+    uint32_t entries;
+    uint32_t mode;                  // HOCS_URING_BYPASS / HOCS_URING_SYSCALL
+    uint64_t mr_va;                 // Registered region: VA and physical base
+    uint64_t mr_pa;
+    uint64_t mr_size;
+
+    /* Task-owned */
+    uint32_t prod;                  // Next descriptor to fill
+    uint32_t cons;                  // Next completion to reap
+    uint64_t errors;
+} hocs_uring_t;
+
+/*
+ * ======================================================================================
+ * EL0 HELPERS
+ * ======================================================================================
+ * Inlined into USER_TEXT code. No globals, no calls, no switch statements
+ * (jump tables end up outside 'user_text').
+ */
+
+USER_INLINE uint64_t hocs_uring_pa(const hocs_uring_t *u, uint64_t va) {
+    return u->mr_pa + (va - u->mr_va);
+}
+
+/*
+ * hocs_uring_submit
+ * Queues C = A x B with [A | B] at 'src_va' and C at 'dst_va' (both in the
+ * registered region). Not visible to the IP before hocs_uring_commit().
+ * Returns HOCS_ERR_BUSY when the ring is full.
+ */
+USER_INLINE int hocs_uring_submit(hocs_uring_t *u, uint64_t src_va, uint64_t dst_va, uint32_t dim) {
+    hocs_desc_t *d;
+
+    if (u->mode == HOCS_URING_SYSCALL) {
+        int rc = (int)user_syscall(SYS_HOCS_SUBMIT, src_va, dst_va, dim);
+        if (rc == HOCS_OK) u->prod++;
+        return rc;
+    }
+    if (u->prod - u->cons >= u->entries) {
+        return HOCS_ERR_BUSY;
+    }
+
+    d = (hocs_desc_t *)(uintptr_t)u->ring + (u->prod & (u->entries - 1));
+    d->src_addr = hocs_uring_pa(u, src_va);
+    d->dst_addr = hocs_uring_pa(u, dst_va);
+    d->matrix_dim = dim;
+    d->flags = 0;
+    d->status = HOCS_DESC_PENDING;
+    d->tag = u->prod;
+    u->prod++;
+    return HOCS_OK;
+}
+
+/*
+ * hocs_uring_commit
+ * Publishes everything submitted so far: one doorbell store per batch.
+ */
+USER_INLINE void hocs_uring_commit(hocs_uring_t *u) {
+    if (u->mode == HOCS_URING_SYSCALL) {
+        return;
+    }
+    asm volatile("dsb st" ::: "memory");    // Descriptors before the tail
+    u->sq_tail = u->prod;
+}
+
+/*
+ * hocs_uring_reap
+ * Retires completed descriptors. Returns how many.
+ */
+USER_INLINE uint32_t hocs_uring_reap(hocs_uring_t *u) {
+    uint32_t done, n = 0;
+
+    if (u->mode == HOCS_URING_SYSCALL) {
+        n = (uint32_t)user_syscall(SYS_HOCS_REAP, 0, 0, 0);
+        u->cons += n;
+        return n;
+    }
+
+    done = u->cq_tail;
+    asm volatile("dmb ld" ::: "memory");    // Status words after the index
+    while (u->cons != done) {
+        hocs_desc_t *d = (hocs_desc_t *)(uintptr_t)u->ring + (u->cons & (u->entries - 1));
+        if (d->status != HOCS_DESC_DONE) u->errors++;
+        u->cons++;
+        n++;
+    }
+    return n;
+}
+
+/*
+ * hocs_uring_wait
+ * Sleeps in the kernel until a completion past 'cons' is available.
+ */
+USER_INLINE int hocs_uring_wait(hocs_uring_t *u) {
+    return (int)user_syscall(SYS_HOCS_WAIT, u->cons, 0, 0);
+}
+
+/* Kernel Side */
+int hocs_uring_attach(hocs_device_t *dev, uint32_t mode, uint64_t mr_size, uint64_t *task_arg);
+int hocs_uring_detach(void);
+void *hocs_uring_mr(void);
+void hocs_uring_benchmark(void);
+
+#endif /* _PHOTONX_DRIVERS_HOCS_URING_H_ */
@@ -0,0 +1,294 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        sdhci.h
+ * Module:      SD/eMMC Host Controller Driver Interface (SDHCI 3.0, ADMA2)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (SD0 @ 0xFF160000, SD1 @ 0xFF170000)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Block access to an SD card or eMMC device behind one of the two Arasan
+ * SDHCI controllers. Identification runs at 400 kHz, then the bus goes to
+ * 4 bits at 25 MHz, or 50 MHz when card and controller do high speed.
+ * Blocks are 512 bytes; SDSC cards are addressed in bytes internally.
+ *
+ * REQUEST QUEUE:
+ * sdhci_submit() queues a caller-owned sdhci_req_t and returns; the
+ * controller runs one command at a time. When it finishes, the requests
+ * it carried complete (state DONE, callback run) from sdhci_poll() or
+ * from the interrupt handler, and the next command is issued before the
+ * callbacks run. Queued requests that continue each other on the card
+ * (same direction, next LBA) are merged into one CMD18 / CMD25 with
+ * Auto-CMD12: the ADMA2 descriptor chain scatters the data into every
+ * request's own buffer. sdhci_plug() / sdhci_unplug() hold issuing back
+ * while a batch is queued so that it merges.
+ *
+ * ADMA2 is not coherent: the driver cleans write buffers and invalidates
+ * read buffers. Write buffers must be 4-byte aligned, read buffers
+ * cache-line aligned (64 bytes): the invalidate after the DMA drops whole
+ * lines, so nothing else may share them.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_SDHCI_H_
+#define _PHOTONX_DRIVERS_SDHCI_H_
+
+#include <stdint.h>
+#include "platform/zynqmp_hardware.h"
+
+/* Interrupt IDs (SPI + 32) */
+#define SD0_IRQ_ID                  80
+#define SD1_IRQ_ID                  81
+
+/* =========================================================================
+ * REGISTER OFFSETS (32-bit access; 8/16-bit registers share words)
+ * ========================================================================= */
+#define SDHCI_BLOCK_OFFSET          0x0004  // BLKSIZE [15:0] | BLKCNT [31:16]
+#define SDHCI_ARG_OFFSET            0x0008
+#define SDHCI_CMD_OFFSET            0x000C  // XFER_MODE [15:0] | COMMAND [31:16]; writing issues
+#define SDHCI_RESP_OFFSET(n)        (0x0010 + 4 * (n))     // n = 0..3, response bits [127:8]
+#define SDHCI_PRESENT_OFFSET        0x0024
+#define SDHCI_HOST_CTRL_OFFSET      0x0028  // HOST_CTRL1 [7:0] | POWER [15:8]
+#define SDHCI_CLOCK_OFFSET          0x002C  // CLOCK [15:0] | TIMEOUT [23:16] | SOFT_RESET [31:24]
+#define SDHCI_INT_STATUS_OFFSET     0x0030  // Normal [15:0] | error [31:16], write-1-to-clear
+#define SDHCI_INT_ENABLE_OFFSET     0x0034  // Status enable, same layout
+#define SDHCI_SIGNAL_ENABLE_OFFSET  0x0038  // Interrupt line enable, same layout
+#define SDHCI_CAPS_OFFSET           0x0040
+#define SDHCI_CAPS1_OFFSET          0x0044
+#define SDHCI_ADMA_ERROR_OFFSET     0x0054
+#define SDHCI_ADMA_ADDR_L_OFFSET    0x0058
+#define SDHCI_ADMA_ADDR_H_OFFSET    0x005C
+#define SDHCI_VERSION_OFFSET        0x00FC  // Slot status [15:0] | host version [31:16]
+
+/* XFER_MODE */
+#define SDHCI_XFER_DMA              (1U << 0)
+#define SDHCI_XFER_BLKCNT_EN        (1U << 1)
+#define SDHCI_XFER_ACMD12           (1U << 2)
+#define SDHCI_XFER_READ             (1U << 4)
+#define SDHCI_XFER_MULTI            (1U << 5)
+
+/* COMMAND */
+#define SDHCI_CMD_RESP_NONE         0x00
+#define SDHCI_CMD_RESP_136          0x01
+#define SDHCI_CMD_RESP_48           0x02
+#define SDHCI_CMD_RESP_48_BUSY      0x03
+#define SDHCI_CMD_CRC               (1U << 3)
+#define SDHCI_CMD_INDEX             (1U << 4)
+#define SDHCI_CMD_DATA              (1U << 5)
+#define SDHCI_CMD(idx, flags)       ((((uint32_t)(idx) << 8) | (flags)) << 16)
+
+/* Response Types (COMMAND flags) */
+#define SDHCI_RSP_NONE              SDHCI_CMD_RESP_NONE
+#define SDHCI_RSP_R1                (SDHCI_CMD_RESP_48 | SDHCI_CMD_CRC | SDHCI_CMD_INDEX)
+#define SDHCI_RSP_R1B               (SDHCI_CMD_RESP_48_BUSY | SDHCI_CMD_CRC | SDHCI_CMD_INDEX)
+#define SDHCI_RSP_R2                (SDHCI_CMD_RESP_136 | SDHCI_CMD_CRC)
+#define SDHCI_RSP_R3                SDHCI_CMD_RESP_48      // OCR, no CRC
+#define SDHCI_RSP_R6                SDHCI_RSP_R1
+#define SDHCI_RSP_R7                SDHCI_RSP_R1
+
+/* PRESENT_STATE */
+#define SDHCI_PRESENT_CMD_INHIBIT   (1U << 0)
+#define SDHCI_PRESENT_DAT_INHIBIT   (1U << 1)
+#define SDHCI_PRESENT_CARD          (1U << 16)
+
+/* HOST_CTRL1 / POWER */
+#define SDHCI_CTRL_4BIT             (1U << 1)
+#define SDHCI_CTRL_HISPD            (1U << 2)
+#define SDHCI_CTRL_ADMA2_64         (3U << 3)
+#define SDHCI_POWER_330             (((7U << 1) | 1U) << 8)  // 3.3 V, bus power on
+
+/* CLOCK / TIMEOUT / SOFT_RESET */
+#define SDHCI_CLOCK_INT_EN          (1U << 0)
+#define SDHCI_CLOCK_INT_STABLE      (1U << 1)
+#define SDHCI_CLOCK_CARD_EN         (1U << 2)
+#define SDHCI_CLOCK_DIV(n)          ((((n) & 0xFFU) << 8) | ((((n) >> 8) & 0x3U) << 6))  // f = base / 2n
+#define SDHCI_TIMEOUT_MAX           (0xEU << 16)            // TMCLK * 2^27
+#define SDHCI_RESET_ALL             (1U << 24)
+#define SDHCI_RESET_CMD             (1U << 25)
+#define SDHCI_RESET_DATA            (1U << 26)
+
+/* INT_STATUS / INT_ENABLE / SIGNAL_ENABLE */
+#define SDHCI_INT_CMD_DONE          (1U << 0)
+#define SDHCI_INT_XFER_DONE         (1U << 1)
+#define SDHCI_INT_ERROR             (1U << 15)              // Summary, read-only
+#define SDHCI_INT_CMD_TIMEOUT       (1U << 16)
+#define SDHCI_INT_CMD_CRC           (1U << 17)
+#define SDHCI_INT_CMD_END           (1U << 18)
+#define SDHCI_INT_CMD_IDX           (1U << 19)
+#define SDHCI_INT_DATA_TIMEOUT      (1U << 20)
+#define SDHCI_INT_DATA_CRC          (1U << 21)
+#define SDHCI_INT_DATA_END          (1U << 22)
+#define SDHCI_INT_ACMD12            (1U << 24)
+#define SDHCI_INT_ADMA              (1U << 25)
+#define SDHCI_INT_ERR_MASK          0x03FF0000U
+
+/* CAPS */
+#define SDHCI_CAPS_BASE_CLK(c)      (((c) >> 8) & 0xFF)     // MHz
+#define SDHCI_CAPS_HISPD            (1U << 21)
+#define SDHCI_CAPS_ADMA2            (1U << 19)
+#define SDHCI_CAPS_64BIT            (1U << 28)
+
+/* =========================================================================
+ * ADMA2 DESCRIPTORS (64-bit addressing, 96-bit entries)
+ * ========================================================================= */
+#define SDHCI_ADMA_VALID            (1U << 0)
+#define SDHCI_ADMA_END              (1U << 1)
+#define SDHCI_ADMA_INT              (1U << 2)
+#define SDHCI_ADMA_TRAN             (2U << 4)
+#define SDHCI_ADMA_MAX_LEN          0x10000                 // Encoded as 0
+
+typedef struct {
+    uint16_t attr;
+    uint16_t len;
+    uint32_t addr_lo;
+    uint32_t addr_hi;
+} sdhci_adma_desc_t;
+
+/* =========================================================================
+ * CARD COMMANDS
+ * ========================================================================= */
+#define SD_CMD_GO_IDLE              0
+#define MMC_CMD_SEND_OP_COND        1
+#define SD_CMD_ALL_SEND_CID         2
+#define SD_CMD_SEND_RCA             3       // MMC: SET_RELATIVE_ADDR
+#define SD_CMD_SWITCH               6       // SD: SWITCH_FUNC (data), MMC: SWITCH (R1b)
+#define SD_CMD_SELECT               7
+#define SD_CMD_SEND_IF_COND         8       // MMC: SEND_EXT_CSD (data)
+#define SD_CMD_SEND_CSD             9
+#define SD_CMD_SET_BLOCKLEN         16
+#define SD_CMD_READ_SINGLE          17
+#define SD_CMD_READ_MULTI           18
+#define SD_CMD_WRITE_SINGLE         24
+#define SD_CMD_WRITE_MULTI          25
+#define SD_CMD_APP                  55
+#define SD_ACMD_BUS_WIDTH           6
+#define SD_ACMD_SEND_OP_COND        41
+
+#define SD_OCR_BUSY                 (1U << 31)              // Clear while powering up
+#define SD_OCR_CCS                  (1U << 30)              // Block addressed (SDHC/SDXC, MMC > 2 GB)
+
+/* =========================================================================
+ * DRIVER TYPES
+ * ========================================================================= */
+#define SDHCI_OK                    0
+#define SDHCI_ERR_INVALID           (-1)
+#define SDHCI_ERR_BUSY              (-2)    // Request queue full
+#define SDHCI_ERR_HW                (-3)    // Controller missing or unusable
+#define SDHCI_ERR_TIMEOUT           (-4)
+#define SDHCI_ERR_NO_CARD           (-5)
+#define SDHCI_ERR_IO                (-6)    // CRC, end bit or ADMA error on a transfer
+#define SDHCI_ERR_NOMEM             (-7)
+
+#define SDHCI_BLOCK_SIZE            512
+#define SDHCI_QUEUE_DEPTH           256     // Must be a power of 2
+#define SDHCI_ADMA_DESCS            128     // Per command; also the most requests one can carry
+#define SDHCI_MAX_REQ_BLOCKS        8192    // 4 MB per request (64 descriptors)
+#define SDHCI_MAX_XFER_BLOCKS       4096    // Merging stops here, bounds a command's latency
+
+typedef enum {
+    SDHCI_CARD_NONE = 0,
+    SDHCI_CARD_SD,                  // SDSC, byte addressed
+    SDHCI_CARD_SDHC,                // SDHC / SDXC
+    SDHCI_CARD_MMC
+} sdhci_card_t;
+
+#define SDHCI_OP_READ               0
+#define SDHCI_OP_WRITE              1
+
+typedef enum {
+    SDHCI_REQ_IDLE = 0,
+    SDHCI_REQ_QUEUED,
+    SDHCI_REQ_ACTIVE,               // Part of the command in flight
+    SDHCI_REQ_DONE
+} sdhci_req_state_t;
+
+/*
+ * struct sdhci_req_t
+ * One block transfer. Caller-owned; must stay put until it is done. The
+ * callback runs in interrupt context when the device has an IRQ.
+ */
+typedef struct sdhci_req {
+    uint32_t op;                    // SDHCI_OP_READ / _WRITE
+    volatile uint32_t state;        // sdhci_req_state_t
+    int result;                     // SDHCI_OK / SDHCI_ERR_* once done
+    uint32_t count;                 // Blocks
+    uint64_t lba;
+    void *buf;                      // count * SDHCI_BLOCK_SIZE bytes
+    void (*done)(struct sdhci_req *req);
+    void *arg;                      // For the callback
+    uint64_t submit_ticks;
+} sdhci_req_t;
+
+/*
+ * struct sdhci_device_t
+ * One host controller and the card in its slot.
+ */
+typedef struct {
+    const char *name;
+    uintptr_t base;                 // Register block
+    uint32_t irq_num;               // 0 = polled only
+
+    /* Card */
+    uint32_t card;                  // sdhci_card_t
+    uint32_t rca;                   // Relative card address << 16
+    uint32_t ocr;
+    uint32_t cid[4];
+    uint32_t csd[4];
+    uint64_t blocks;                // Capacity in SDHCI_BLOCK_SIZE blocks
+    uint32_t base_clock_hz;
+    uint32_t clock_hz;
+    uint32_t host_ctrl;             // HOST_CTRL1 | POWER shadow
+
+    /* Request Queue */
+    sdhci_req_t *queue[SDHCI_QUEUE_DEPTH];
+    uint32_t head;                  // Next request to issue (free-running)
+    uint32_t tail;                  // Next free slot (free-running)
+    uint32_t plugged;               // > 0: sdhci_submit() only queues
+    sdhci_req_t *active[SDHCI_ADMA_DESCS];
+    uint32_t nactive;               // Requests carried by the command in flight
+    uint32_t active_blocks;
+    uint64_t active_ticks;          // Issue of the command in flight, else last retirement
+    sdhci_adma_desc_t adma[SDHCI_ADMA_DESCS] __attribute__((aligned(64)));
+
+    /* Statistics */
+    uint64_t requests;
+    uint64_t commands;              // Data commands issued
+    uint64_t merged;                // Requests that rode on another's command
+    uint64_t blocks_read;
+    uint64_t blocks_written;
+    uint64_t errors;
+    uint64_t timeouts;
+    uint64_t irqs;
+} sdhci_device_t;
+
+/* Instances (one per controller) */
+extern sdhci_device_t sdhci0;
+extern sdhci_device_t sdhci1;
+
+/* =========================================================================
+ * MMIO ACCESSORS
+ * ========================================================================= */
+static inline uint32_t sdhci_rd(sdhci_device_t *dev, uint32_t offset) {
+    return *(volatile uint32_t *)(dev->base + offset);
+}
+
+static inline void sdhci_wr(sdhci_device_t *dev, uint32_t offset, uint32_t val) {
+    *(volatile uint32_t *)(dev->base + offset) = val;
+}
+
+/* Function Prototypes */
+int sdhci_init(sdhci_device_t *dev, uintptr_t base, uint32_t irq);
+void sdhci_req_init(sdhci_req_t *req, uint32_t op, uint64_t lba, uint32_t count, void *buf,
+                    void (*done)(sdhci_req_t *req), void *arg);
+int sdhci_submit(sdhci_device_t *dev, sdhci_req_t *req);
+uint32_t sdhci_poll(sdhci_device_t *dev);
+int sdhci_wait(sdhci_device_t *dev, sdhci_req_t *req);
+void sdhci_plug(sdhci_device_t *dev);
+void sdhci_unplug(sdhci_device_t *dev);
+int sdhci_read(sdhci_device_t *dev, uint64_t lba, uint32_t count, void *buf);
+int sdhci_write(sdhci_device_t *dev, uint64_t lba, uint32_t count, const void *buf);
+void sdhci_irq_handler(uint32_t irq_id, void *arg);
+void sdhci_benchmark(void);
+
+#endif /* _PHOTONX_DRIVERS_SDHCI_H_ */
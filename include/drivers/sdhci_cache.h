@@ -0,0 +1,109 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        sdhci_cache.h
+ * Module:      SD/eMMC Block Cache (Write-Back LRU with Read-Ahead)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * A fixed pool of 512-byte block slots in front of one sdhci device,
+ * found through a hash on the LBA and recycled least-recently-used first.
+ * Slots are filled and written back by the device's request queue, one
+ * request per slot: a run of neighbouring blocks is queued plugged and
+ * goes out as one multi-block command, scattered by ADMA2 into the slots.
+ *
+ * READS:
+ * Misses of one call are filled together, hits are copied straight out.
+ * A read that starts where the previous one ended continues a stream: the
+ * read-ahead window opens at SDHCI_CACHE_RA_MIN blocks and doubles with
+ * every sequential call up to ra_max. The window is refilled in the
+ * background once the stream has consumed half of it, so a steady reader
+ * finds its blocks already in flight or landed.
+ *
+ * WRITES:
+ * Land in the slot and mark it dirty; nothing goes to the card until the
+ * slot is evicted, more than SDHCI_CACHE_DIRTY_HIGH slots are dirty (the
+ * oldest are written back down to SDHCI_CACHE_DIRTY_LOW), or
+ * sdhci_cache_sync(). Eviction writes back the whole dirty run around the
+ * victim. A failed write-back leaves the block dirty.
+ *
+ * Not reentrant: one caller at a time (completions may come from the IRQ).
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_SDHCI_CACHE_H_
+#define _PHOTONX_DRIVERS_SDHCI_CACHE_H_
+
+#include <stdint.h>
+#include "drivers/sdhci.h"
+
+#define SDHCI_CACHE_SLOTS           1024    // 512 KB of blocks
+#define SDHCI_CACHE_HASH            2048    // Buckets, must be a power of 2
+#define SDHCI_CACHE_CHUNK           (SDHCI_CACHE_SLOTS / 4)     // Blocks pinned per pass of a read
+#define SDHCI_CACHE_RA_MIN          8
+#define SDHCI_CACHE_RA_MAX          (SDHCI_CACHE_SLOTS / 4)
+#define SDHCI_CACHE_DIRTY_HIGH      (SDHCI_CACHE_SLOTS / 2)
+#define SDHCI_CACHE_DIRTY_LOW       (SDHCI_CACHE_SLOTS / 4)
+#define SDHCI_CACHE_RUN_MAX         SDHCI_ADMA_DESCS            // Blocks per write-back run
+
+#define SDHCI_CACHE_NIL             0xFFFF
+
+/* Slot Flags */
+#define SDHCI_CS_VALID              (1 << 0)    // Data matches or supersedes the card
+#define SDHCI_CS_DIRTY              (1 << 1)    // Newer than the card
+#define SDHCI_CS_BUSY               (1 << 2)    // Fill or write-back in flight
+
+/*
+ * struct sdhci_cache_slot_t
+ * One cached block. 'flags' is only changed by the completion while BUSY
+ * and only by the cache's caller otherwise.
+ */
+typedef struct {
+    sdhci_req_t req;                // First: the completion casts back to the slot
+    uint64_t lba;                   // UINT64_MAX = unused
+    uint8_t *data;
+    volatile uint8_t flags;         // SDHCI_CS_*
+    uint8_t ra;                     // Read ahead, not yet asked for
+    uint8_t pinned;                 // Held by the read in progress, not evictable
+    uint16_t hnext;                 // Hash chain
+    uint16_t prev;                  // Towards the MRU end
+    uint16_t next;                  // Towards the LRU end
+} sdhci_cache_slot_t;
+
+typedef struct sdhci_cache {
+    sdhci_device_t *dev;
+    uint8_t *data;                  // SDHCI_CACHE_SLOTS blocks, DMA-able
+    uint32_t ra_max;                // Read-ahead limit in blocks, 0 = off
+
+    /* Lookup and Replacement */
+    uint16_t hash[SDHCI_CACHE_HASH];
+    uint16_t mru;
+    uint16_t lru;
+    volatile uint32_t dirty;
+    sdhci_cache_slot_t slot[SDHCI_CACHE_SLOTS];
+
+    /* Stream Detection */
+    uint64_t seq_next;              // Block after the previous read
+    uint64_t ra_next;               // First block not yet read ahead
+    uint32_t ra_window;
+
+    /* Statistics */
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t ra_blocks;             // Fills started by read-ahead
+    uint64_t ra_hits;               // ... that a read then asked for
+    uint64_t writebacks;
+    uint64_t evictions;
+    volatile uint64_t io_errors;
+} sdhci_cache_t;
+
+/* Function Prototypes */
+int sdhci_cache_init(sdhci_cache_t *c, sdhci_device_t *dev);
+int sdhci_cache_read(sdhci_cache_t *c, uint64_t lba, uint32_t count, void *buf);
+int sdhci_cache_write(sdhci_cache_t *c, uint64_t lba, uint32_t count, const void *buf);
+int sdhci_cache_sync(sdhci_cache_t *c);
+int sdhci_cache_drop(sdhci_cache_t *c);
+
+#endif /* _PHOTONX_DRIVERS_SDHCI_CACHE_H_ */
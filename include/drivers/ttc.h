@@ -0,0 +1,65 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        ttc.h
+ * Module:      Cadence Triple Timer Counter (TTC) Driver Interface
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (LPD)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Minimal periodic-interrupt driver for counter 1 of a TTC block. Used as an
+ * auxiliary tick source so that kernel housekeeping (interrupt moderation
+ * polls) never reprograms the ARM generic timer, which stays dedicated to the
+ * scheduler and the photonic control loop.
+ *
+ * Input clock: LPD_LSBUS, 100 MHz on KV260. Counters are 32-bit.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_DRIVERS_TTC_H_
+#define _PHOTONX_DRIVERS_TTC_H_
+
+#include <stdint.h>
+#include "platform/zynqmp_hardware.h"
+#include "drivers/gic_v2.h"
+
+/* =========================================================================
+ * REGISTER OFFSETS (Counter 1)
+ * ========================================================================= */
+#define TTC_CLK_CTRL_OFFSET         0x0000  /* Clock Control (Prescaler) */
+#define TTC_CNT_CTRL_OFFSET         0x000C  /* Counter Control */
+#define TTC_CNT_VALUE_OFFSET        0x0018  /* Counter Value */
+#define TTC_INTERVAL_OFFSET         0x0024  /* Interval Value */
+#define TTC_ISR_OFFSET              0x0054  /* Interrupt Status (Clear on Read) */
+#define TTC_IER_OFFSET              0x0060  /* Interrupt Enable */
+
+/* Counter Control Bits */
+#define TTC_CNT_CTRL_DIS            (1 << 0)    /* Counter Disable */
+#define TTC_CNT_CTRL_INT            (1 << 1)    /* Interval Mode */
+#define TTC_CNT_CTRL_RST            (1 << 4)    /* Reset Counter */
+
+/* Interrupt Bits */
+#define TTC_IXR_INTERVAL            (1 << 0)
+
+/* Interrupt IDs (Counter 1 of each block) */
+#define TTC0_IRQ_ID                 68
+#define TTC1_IRQ_ID                 71
+
+#define TTC_INPUT_CLK_HZ            100000000UL
+
+typedef struct {
+    uintptr_t base;
+    uint32_t irq_num;
+    uint32_t period_us;
+    irq_handler_t callback;
+    void *arg;
+    uint64_t ticks;
+} ttc_timer_t;
+
+/* Function Prototypes */
+void ttc_init(ttc_timer_t *t, uintptr_t base, uint32_t irq, irq_handler_t callback, void *arg);
+void ttc_start_periodic(ttc_timer_t *t, uint32_t period_us);
+void ttc_stop(ttc_timer_t *t);
+
+#endif /* _PHOTONX_DRIVERS_TTC_H_ */
@@ -100,40 +100,106 @@
 #define UART_SR_RXEMPTY         0x00000002  /* RX FIFO Empty */
 #define UART_SR_RGTRIG          0x00000001  /* RX FIFO Trigger */
 
+/* =========================================================================
+ * BIT DEFINITIONS: INTERRUPT REGISTERS (IER/IDR/IMR/ISR)
+ * =========================================================================
+ */
+#define UART_IXR_TOVR           0x00001000  /* TX FIFO Overflow */
+#define UART_IXR_TNFUL          0x00000800  /* TX FIFO Nearly Full */
+#define UART_IXR_TTRIG          0x00000400  /* TX FIFO Trigger */
+#define UART_IXR_TOUT           0x00000100  /* RX Timeout */
+#define UART_IXR_PARITY         0x00000080  /* Parity Error */
+#define UART_IXR_FRAMING        0x00000040  /* Framing Error */
+#define UART_IXR_RXOVR          0x00000020  /* RX FIFO Overflow */
+#define UART_IXR_TXFULL         0x00000010  /* TX FIFO Full */
+#define UART_IXR_TXEMPTY        0x00000008  /* TX FIFO Empty */
+#define UART_IXR_RXFULL         0x00000004  /* RX FIFO Full */
+#define UART_IXR_RXEMPTY        0x00000002  /* RX FIFO Empty */
+#define UART_IXR_RXTRIG         0x00000001  /* RX FIFO Trigger */
+
+#define UART_FIFO_DEPTH         64
+
+/* Interrupt IDs (SPI + 32) */
+#define UART0_IRQ_ID            53
+#define UART1_IRQ_ID            54
+
 /* =========================================================================
  * DATA STRUCTURES: RING BUFFER
  * =========================================================================
+ * Single-producer / single-consumer. head and tail are free-running
+ * indices; the slot is (index & (size - 1)), so size must be a power of 2.
  */
 #define UART_RING_BUFFER_SIZE   2048        /* 2KB Buffer for Console */
+#define UART_DATA_RING_SIZE     16384       /* 16KB for the binary data link */
 
 typedef struct {
-    uint8_t  buffer[UART_RING_BUFFER_SIZE];
+    uint8_t *buffer;
+    uint32_t size;
     volatile uint32_t head;
     volatile uint32_t tail;
-    volatile uint32_t count;
 } ring_buffer_t;
 
+/* Instance Flags */
+#define UART_F_CRLF             (1 << 0)    /* Translate \n -> \n\r (console) */
+#define UART_F_IRQ              (1 << 1)    /* Interrupt-driven RX/TX rings */
+
 typedef struct {
-    uint32_t base_addr;
+    const char *name;
+    uintptr_t base_addr;
     uint32_t baud_rate;
     uint32_t irq_num;
+    uint32_t flags;
     ring_buffer_t tx_buffer;
     ring_buffer_t rx_buffer;
     uint64_t tx_count;
     uint64_t rx_count;
     uint64_t error_count;
+    uint64_t overrun_count;
+
+    /* Called from IRQ context after new RX bytes land in the ring */
+    void (*rx_notify)(void *arg);
+    void *rx_arg;
 } uart_driver_t;
 
-/* Global Driver Instance */
-extern uart_driver_t console_uart;
+/* Global Driver Instances */
+extern uart_driver_t console_uart;      /* UART1: USB-UART console */
+extern uart_driver_t data_uart;         /* UART0: binary HOCS data link */
+
+/* Instance API */
+void uart_dev_init(uart_driver_t *u);
+void uart_dev_putc(uart_driver_t *u, uint8_t c);
+void uart_dev_write(uart_driver_t *u, const uint8_t *buf, uint32_t len);
+uint8_t uart_dev_getc(uart_driver_t *u);
+int uart_dev_read(uart_driver_t *u, uint8_t *buf, uint32_t len);
+int uart_dev_is_busy(uart_driver_t *u);
+void uart_dev_flush(uart_driver_t *u);
+void uart_dev_irq_handler(uint32_t irq_id, void *arg);
+
+/* Ring Helpers (shared with zero-copy consumers of rx_buffer) */
+static inline uint32_t ring_used(const ring_buffer_t *rb) {
+    return rb->head - rb->tail;
+}
+
+static inline uint8_t ring_peek(const ring_buffer_t *rb, uint32_t index) {
+    return rb->buffer[index & (rb->size - 1)];
+}
+
+static inline uint8_t *ring_slot(ring_buffer_t *rb, uint32_t index) {
+    return &rb->buffer[index & (rb->size - 1)];
+}
+
+/* Hands bytes up to (free-running) index 'tail' back to the producer */
+static inline void ring_release(ring_buffer_t *rb, uint32_t tail) {
+    asm volatile("dmb ish" ::: "memory");
+    rb->tail = tail;
+}
 
-/* Function Prototypes */
+/* Console API (console_uart, polled) */
 void uart_init_controller(void);
 void uart_send_byte(uint8_t c);
 uint8_t uart_recv_byte(void);
 void uart_send_string(const char *s);
 int uart_is_busy(void);
 void uart_flush(void);
-void uart_interrupt_handler(void);
 
 #endif /* _PHOTONX_DRIVERS_UART_PS_H_ */
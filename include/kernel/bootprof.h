@@ -0,0 +1,51 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/bootprof.h
+ * Module:      Boot-Phase Profiler
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Records a timeline of boot phases as raw cntpct_el0 pairs. startup.S
+ * stamps the assembly phases (_start, EL drop, CPU setup, BSS clear) into
+ * boot_stamps_early[] in .data, before C and before BSS is zeroed.
+ * kernel_main brackets each init step with bootprof_begin/end.
+ *
+ * Counter ticks are only converted once the timer is calibrated, at report
+ * time, so recording costs two register reads and a store per phase.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_BOOTPROF_H_
+#define _PHOTONX_KERNEL_BOOTPROF_H_
+
+#include <stdint.h>
+
+#define BOOTPROF_MAX_PHASES         32
+
+/* Early Stamps (indices into boot_stamps_early, written by startup.S) */
+#define BOOT_STAMP_START            0       // _start (core 0)
+#define BOOT_STAMP_EL1              1       // el1_setup entry
+#define BOOT_STAMP_BSS              2       // BSS clear begins
+#define BOOT_STAMP_KERNEL           3       // Branch to kernel_main
+#define BOOT_STAMP_COUNT            4
+
+typedef struct {
+    const char *name;
+    uint64_t start;                 // cntpct_el0
+    uint64_t end;                   // 0 while open
+    uint8_t depth;                  // Nesting level at begin
+} bootprof_phase_t;
+
+extern uint64_t boot_stamps_early[BOOT_STAMP_COUNT];
+
+/* Function Prototypes */
+void bootprof_init(void);
+int bootprof_begin(const char *name);
+void bootprof_end(int id);
+void bootprof_report(void);
+void bootprof_export_chrome(void);
+
+#endif /* _PHOTONX_KERNEL_BOOTPROF_H_ */
@@ -0,0 +1,83 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/cpuidle.h
+ * Module:      CPU Idle Framework & Latency-Aware Governor
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Idle state table and governor interface. The governor predicts how long
+ * the core will stay idle (next timer event corrected by recent history) and
+ * selects the deepest state that:
+ * 1. Pays back its entry/exit energy (target residency <= prediction).
+ * 2. Wakes fast enough for the tightest registered latency constraint.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_CPUIDLE_H_
+#define _PHOTONX_KERNEL_CPUIDLE_H_
+
+#include <stdint.h>
+#include "kernel/psci.h"
+
+/* =========================================================================
+ * CONFIGURATION
+ * ========================================================================= */
+#define CPUIDLE_MAX_STATES          4
+#define CPUIDLE_MAX_LATENCY_REQS    8
+#define CPUIDLE_HISTORY_LEN         8       // Recent idle intervals tracked
+#define CPUIDLE_BUCKETS             6       // Correction factor buckets (by decade)
+#define CPUIDLE_LATENCY_NONE        0xFFFFFFFFU
+
+/* State Flags */
+#define CPUIDLE_FLAG_WFI            (1 << 0)    // Architectural WFI, no firmware
+#define CPUIDLE_FLAG_PSCI           (1 << 1)    // Entered via PSCI CPU_SUSPEND
+#define CPUIDLE_FLAG_DISABLED       (1 << 2)    // Rejected by firmware or by policy
+
+/* =========================================================================
+ * DATA STRUCTURES
+ * ========================================================================= */
+
+/*
+ * struct cpuidle_state_t
+ * One idle state plus its accounting.
+ *   above: woke before target residency (state was too deep)
+ *   below: slept long enough for a deeper allowed state (too shallow)
+ */
+typedef struct {
+    const char *name;
+    uint32_t exit_latency_us;       // Worst-case wake-up latency
+    uint32_t target_residency_us;   // Minimum stay to break even on energy
+    uint32_t psci_state;            // PSCI power_state parameter
+    uint32_t flags;
+
+    /* Statistics */
+    uint64_t usage;                 // Number of entries
+    uint64_t residency_us;          // Total time spent in state
+    uint64_t above;                 // Too-deep misses
+    uint64_t below;                 // Too-shallow misses
+    uint64_t rejected;              // Firmware refused entry
+} cpuidle_state_t;
+
+/*
+ * struct cpuidle_latency_req_t
+ * Handle for a wake-up latency constraint (e.g. photonic control loop).
+ */
+typedef struct {
+    const char *owner;
+    uint32_t max_latency_us;
+    uint8_t  active;
+} cpuidle_latency_req_t;
+
+/* Function Prototypes */
+void cpuidle_init(psci_conduit_t conduit);
+void cpuidle_enter(void);
+int cpuidle_latency_req_add(cpuidle_latency_req_t *req, const char *owner, uint32_t max_latency_us);
+void cpuidle_latency_req_update(cpuidle_latency_req_t *req, uint32_t max_latency_us);
+void cpuidle_latency_req_remove(cpuidle_latency_req_t *req);
+uint32_t cpuidle_latency_limit_us(void);
+void cpuidle_dump_stats(void);
+
+#endif /* _PHOTONX_KERNEL_CPUIDLE_H_ */
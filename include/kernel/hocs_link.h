@@ -0,0 +1,167 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/hocs_link.h
+ * Module:      HOCS Serial Command Channel
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (UART0 data link)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Binary protocol for submitting HOCS jobs from a host over a UART and
+ * streaming the results back.
+ *
+ * WIRE FORMAT:
+ * COBS( type:u8 | seq:u8 | len:u16le | payload[len] | crc16le ) | 0x00
+ *
+ * The CRC (CRC-16/CCITT-FALSE) covers header and payload. Replies echo the
+ * request's seq. A bad CRC or malformed frame is answered with NACK and the
+ * receiver resynchronises on the next 0x00.
+ *
+ * ZERO-COPY RX:
+ * Frames are never copied out of the UART RX ring. The parser COBS-decodes
+ * each frame in place inside the ring and hands out a two-segment view (the
+ * frame may wrap once). When the operand block of a JOB_SUBMIT is contiguous
+ * and aligned, the HOCS DMA reads it straight from the ring; those bytes are
+ * held back from the UART producer until the job completes.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_HOCS_LINK_H_
+#define _PHOTONX_KERNEL_HOCS_LINK_H_
+
+#include <stdint.h>
+#include "drivers/uart_ps.h"
+#include "drivers/hocs.h"
+
+/* =========================================================================
+ * CONFIGURATION
+ * ========================================================================= */
+#define HOCS_LINK_MAX_DIM           32      // 2 x 4KB operands per frame
+#define HOCS_LINK_MAX_INFLIGHT      4       // Jobs outstanding on the HOCS ring
+#define HOCS_LINK_TELEM_MAX         64      // Job records per TELEMETRY_DATA frame
+#define HOCS_LINK_HDR_BYTES         4
+#define HOCS_LINK_CRC_BYTES         2
+#define HOCS_LINK_MAX_PAYLOAD       (8 + (2 * HOCS_LINK_MAX_DIM * HOCS_LINK_MAX_DIM * 4))
+#define HOCS_LINK_MAX_FRAME         (HOCS_LINK_HDR_BYTES + HOCS_LINK_MAX_PAYLOAD + HOCS_LINK_CRC_BYTES)
+
+/* Job flags a host may set: frames are fp32 both ways, so only the result shift */
+#define HOCS_LINK_JOB_FLAGS         HOCS_DESC_F_OUT_SHIFT(0xF)
+
+/* Message Types (host -> target < 0x80, replies have bit 7 set) */
+#define HOCS_MSG_PING               0x01
+#define HOCS_MSG_JOB_SUBMIT         0x10
+#define HOCS_MSG_TELEMETRY          0x20
+#define HOCS_MSG_PONG               0x81
+#define HOCS_MSG_JOB_RESULT         0x90
+#define HOCS_MSG_TELEMETRY_DATA     0xA0
+#define HOCS_MSG_NACK               0xEE
+
+/* NACK Reasons */
+#define HOCS_NACK_CRC               0x01
+#define HOCS_NACK_FORMAT            0x02
+#define HOCS_NACK_DIM               0x03
+#define HOCS_NACK_HW                0x04
+
+/* =========================================================================
+ * MESSAGE LAYOUTS (little-endian, packed)
+ * ========================================================================= */
+typedef struct {
+    uint8_t type;
+    uint8_t seq;
+    uint16_t len;                   // Payload bytes
+} __attribute__((packed)) hocs_link_hdr_t;
+
+/* JOB_SUBMIT: followed by A | B (2 x dim x dim float32) */
+typedef struct {
+    uint32_t job_id;
+    uint16_t dim;
+    uint16_t flags;                 // HOCS_LINK_JOB_FLAGS only, else NACK_FORMAT
+} __attribute__((packed)) hocs_msg_job_t;
+
+/* JOB_RESULT: followed by C (dim x dim float32) unless status != 0 */
+typedef struct {
+    uint32_t job_id;
+    int16_t status;                 // HOCS_OK / HOCS_ERR_*
+    uint16_t dim;
+} __attribute__((packed)) hocs_msg_result_t;
+
+/* TELEMETRY: newest 'max_records' per-job records of the linked instance */
+typedef struct {
+    uint16_t max_records;
+} __attribute__((packed)) hocs_msg_telem_req_t;
+
+/* TELEMETRY_DATA: followed by 'count' hocs_job_rec_t (hocs_telemetry.h), oldest first */
+typedef struct {
+    uint32_t jobs;                  // Completions recorded since attach
+    uint16_t count;
+    uint16_t rec_bytes;
+} __attribute__((packed)) hocs_msg_telem_t;
+
+/* NACK */
+typedef struct {
+    uint8_t reason;
+} __attribute__((packed)) hocs_msg_nack_t;
+
+/*
+ * struct hocs_link_view_t
+ * Decoded frame as it sits in the RX ring (seg[1] is empty unless it wraps).
+ */
+typedef struct {
+    const uint8_t *seg[2];
+    uint32_t seg_len[2];
+    uint32_t len;
+} hocs_link_view_t;
+
+/*
+ * struct hocs_link_slot_t
+ * One in-flight job. Operands are either pinned in the RX ring or bounced.
+ */
+typedef struct {
+    hocs_job_t job;
+    uint32_t job_id;
+    uint8_t seq;
+    uint8_t pinned;                 // 1 = HOCS reads operands from the RX ring
+    uint32_t ring_start;            // Frame start (free-running RX index)
+    float dst[HOCS_LINK_MAX_DIM * HOCS_LINK_MAX_DIM] __attribute__((aligned(64)));
+    float bounce[2 * HOCS_LINK_MAX_DIM * HOCS_LINK_MAX_DIM] __attribute__((aligned(64)));
+} hocs_link_slot_t;
+
+typedef struct {
+    uart_driver_t *uart;
+    hocs_device_t *hocs;
+
+    /* Parser State (free-running RX ring indices) */
+    uint32_t scan;                  // Next byte to inspect
+    uint32_t frame_start;           // First byte of the current frame
+    uint8_t resync;                 // Discarding until the next delimiter
+    volatile uint32_t rx_pending;   // Set from the UART ISR
+
+    /* In-flight Jobs (completed strictly in order) */
+    hocs_link_slot_t slot[HOCS_LINK_MAX_INFLIGHT];
+    uint32_t slot_head;
+    uint32_t slot_tail;
+
+    /* Statistics */
+    uint64_t frames_rx;
+    uint64_t frames_tx;
+    uint64_t crc_errors;
+    uint64_t format_errors;
+    uint64_t oversize;
+    uint64_t zero_copy;
+    uint64_t bounced;
+    uint64_t jobs_done;
+    uint64_t jobs_failed;
+} hocs_link_t;
+
+/* Function Prototypes */
+void hocs_link_init(hocs_link_t *l, uart_driver_t *uart, hocs_device_t *hocs);
+void hocs_link_poll(hocs_link_t *l);
+void hocs_link_send(hocs_link_t *l, uint8_t type, uint8_t seq,
+                    const void *msg, uint32_t msg_len,
+                    const void *body, uint32_t body_len);
+uint32_t hocs_link_view_copy(const hocs_link_view_t *v, uint32_t off, void *dst, uint32_t len);
+void hocs_link_dump_stats(const hocs_link_t *l);
+void hocs_link_benchmark(uint32_t baud);
+
+#endif /* _PHOTONX_KERNEL_HOCS_LINK_H_ */
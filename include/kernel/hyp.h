@@ -0,0 +1,298 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/hyp.h
+ * Module:      EL2 Static Partitioning Hypervisor
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53, GIC-400)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Splits the four cores between PhotonX (the RT partition) and one guest,
+ * e.g. Linux. Nothing is scheduled: every core belongs to exactly one
+ * partition for its whole life, guest vCPU n is always the n-th guest
+ * core, and devices are handed over whole (IPA == PA, so guest DMA needs
+ * no SMMU setup).
+ *
+ * PARTITIONS:
+ * - RT: PhotonX itself at EL1 with an identity stage 2 that leaves out the
+ *   guest's RAM and devices. Interrupts are not trapped: the physical GIC
+ *   CPU interface delivers straight to EL1, so the RT path has no EL2
+ *   entry at all. PhotonX keeps the distributor and CNTP.
+ * - Guest: its own stage 2, physical IRQs routed to EL2 and injected
+ *   through the GICH list registers with the HW bit, so the guest's EOI
+ *   deactivates the physical line without a second exit. The distributor
+ *   is trapped and filtered to the guest's lines; the CPU interface is the
+ *   GICV page mapped where the guest expects GICC. PSCI is trapped (TSC)
+ *   and limited to the guest's cores. Timer: CNTV, CNTP traps. ZynqMP
+ *   EEMI (SiP) calls are filtered: queries pass, node and reset requests
+ *   only for the partition's pm_nodes/pm_resets, clock and pin control
+ *   stay with the RT side (describe passed-through clocks as fixed in
+ *   the guest DT), PM_SYSTEM_SHUTDOWN ends the partition like PSCI
+ *   SYSTEM_OFF, anything else gets SMCCC NOT_SUPPORTED.
+ *
+ * EL2 CODE:
+ * Runs with its own identity map (the EL1 tables mark kernel memory UXN,
+ * which is XN at EL2) and integer registers only, so guest FP/SIMD state
+ * never has to be saved. The RT partition hosts the hypervisor image and
+ * is trusted; stage 2 on its cores protects the guest from stray RT
+ * stores, not the other way round.
+ *
+ * QEMU:
+ *   qemu-system-aarch64 -M xlnx-zcu102,virtualization=on -m 4G \
+ *     -kernel photonx.elf -device loader,file=Image,addr=0x40200000 \
+ *     -device loader,file=guest.dtb,addr=0x40000000 -nographic
+ *   virtualization=on is required: without it there is no EL2 and
+ *   hyp_init() refuses to start. Upstream QEMU has no PMU firmware or
+ *   ATF, so its built-in PSCI answers the SMCs EL2 forwards: PSCI works,
+ *   allowed EEMI calls come back NOT_SUPPORTED, and the EEMI filter can
+ *   only be checked by the guest seeing NOT_SUPPORTED for refused calls
+ *   without an SMC being issued. EEMI passthrough itself needs hardware
+ *   (or a QEMU with the PMU model) running ATF and PMU firmware.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_HYP_H_
+#define _PHOTONX_KERNEL_HYP_H_
+
+#include <stdint.h>
+
+/* =========================================================================
+ * BUILD CONFIGURATION
+ * ========================================================================= */
+#define HYP_PARTITIONED             0           // 1 = kernel_main partitions the cores
+#define HYP_GUEST_CFG               hyp_guest_linux
+#define HYP_GUEST_AUTOSTART         1           // Boot the guest once PhotonX is up
+
+#define HYP_GUEST_RAM_BASE          0x40000000UL
+#define HYP_GUEST_RAM_SIZE          0x20000000UL    // 512MB, 2MB aligned
+#define HYP_GUEST_DTB               (HYP_GUEST_RAM_BASE)
+#define HYP_GUEST_ENTRY             (HYP_GUEST_RAM_BASE + 0x200000)
+
+#define HYP_MAX_CORES               4
+#define HYP_MAX_REGIONS             8
+#define HYP_MAX_IRQS                16
+#define HYP_MAX_PM_IDS              8           // EEMI nodes/resets per guest
+#define HYP_LR_BACKLOG              8           // Injections waiting for a free list register
+#define HYP_STACK_SIZE              0x2000      // Per core, EL2
+#define HYP_IDLE_LATENCY_US         10          // Keep RT cores out of powerdown
+
+/* =========================================================================
+ * SERVICE CALLS (RT partition -> EL2, SMCCC vendor hypervisor range)
+ * ========================================================================= */
+#define HYP_HVC_ENABLE              0xC6000000U // x1 = unused; EL2 MMU on. Clobbers x0-x3
+#define HYP_HVC_CALL                0xC6000001U // x1 = fn, x2 = arg; x0 = fn(arg) at EL2
+
+#define HYP_SGI_STOP                15          // RT -> guest core: power off
+
+/* hyp_handle_fatal() kinds (hyp_entry.S) */
+#define HYP_FATAL_FIQ               1
+#define HYP_FATAL_SERROR            2
+#define HYP_FATAL_AARCH32           3
+#define HYP_FATAL_EL2               4
+
+/* =========================================================================
+ * EL2 SYSTEM REGISTER BITS
+ * ========================================================================= */
+#define HCR_VM                      (1UL << 0)  // Stage 2 on
+#define HCR_SWIO                    (1UL << 1)
+#define HCR_FMO                     (1UL << 3)
+#define HCR_IMO                     (1UL << 4)  // Physical IRQ -> EL2, virtual IRQ -> EL1
+#define HCR_AMO                     (1UL << 5)
+#define HCR_FB                      (1UL << 9)  // Broadcast TLB/IC maintenance
+#define HCR_BSU_IS                  (1UL << 10)
+#define HCR_DC                      (1UL << 12) // Stage 1 off behaves as Normal WB
+#define HCR_TSC                     (1UL << 19) // Trap SMC
+#define HCR_RW                      (1UL << 31) // EL1 is AArch64
+
+#define HCR_RT                      (HCR_RW | HCR_SWIO | HCR_VM)
+#define HCR_GUEST                   (HCR_RW | HCR_TSC | HCR_BSU_IS | HCR_FB | HCR_AMO | \
+                                     HCR_IMO | HCR_FMO | HCR_SWIO | HCR_VM)
+
+#define CNTHCTL_EL1PCTEN            (1UL << 0)  // EL1 may read CNTPCT
+#define CNTHCTL_EL1PCEN             (1UL << 1)  // EL1 may use the physical timer
+
+/* 36-bit IPA from level 1, 4KB granule, WBWA inner-shareable walks, 40-bit PA */
+#define VTCR_VALUE                  ((1UL << 31) | (2UL << 16) | (3UL << 12) | (1UL << 10) | \
+                                     (1UL << 8) | (1UL << 6) | 28UL)
+#define TCR_EL2_VALUE               ((1UL << 31) | (1UL << 23) | (2UL << 16) | (3UL << 12) | \
+                                     (1UL << 10) | (1UL << 8) | 28UL)
+#define SCTLR_EL2_VALUE             0x30C5183DUL    // RES1 | I | SA | C | M
+#define SCTLR_EL1_RESET             0x30D00800UL    // RES1, MMU and caches off
+#define HYP_IPA_SIZE                (1UL << 36)
+
+/* Stage 2 descriptor fields */
+#define S2_MEMATTR_DEVICE           (0x1UL << 2)    // Device-nGnRE
+#define S2_MEMATTR_NORMAL           (0xFUL << 2)    // Normal, inner/outer WB
+#define S2_AP_RO                    (0x1UL << 6)
+#define S2_AP_RW                    (0x3UL << 6)
+#define S2_SH_INNER                 (0x3UL << 8)
+#define S2_AF                       (1UL << 10)
+#define S2_XN                       (1UL << 54)
+
+/* ESR_EL2 exception classes */
+#define ESR_EC_SHIFT                26
+#define ESR_EC_UNKNOWN              0x00
+#define ESR_EC_HVC64                0x16
+#define ESR_EC_SMC64                0x17
+#define ESR_EC_SYS64                0x18
+#define ESR_EC_IABT_LOW             0x20
+#define ESR_EC_DABT_LOW             0x24
+#define ESR_EC_DABT_CUR             0x25
+#define ESR_IL                      (1UL << 25)
+#define ESR_ISV                     (1UL << 24)
+
+/* =========================================================================
+ * PARTITION DESCRIPTION
+ * ========================================================================= */
+#define HYP_MEM_R                   (1 << 0)
+#define HYP_MEM_W                   (1 << 1)
+#define HYP_MEM_X                   (1 << 2)
+#define HYP_MEM_DEVICE              (1 << 3)
+#define HYP_MEM_RAM                 (HYP_MEM_R | HYP_MEM_W | HYP_MEM_X)
+#define HYP_MEM_IO                  (HYP_MEM_R | HYP_MEM_W | HYP_MEM_DEVICE)
+
+#define HYP_PART_MMU_OFF            (1 << 0)    // Guest runs without stage 1 (HCR.DC)
+
+/*
+ * struct hyp_region_t
+ * Identity range handed to the guest. Every region is taken away from the
+ * RT partition's stage 2.
+ */
+typedef struct {
+    uint64_t base;
+    uint64_t size;
+    uint32_t flags;                 // HYP_MEM_*
+} hyp_region_t;
+
+/*
+ * struct hyp_partition_t
+ * Static guest description. vCPU n runs on the n-th set bit of core_mask.
+ */
+typedef struct {
+    const char *name;
+    uint32_t core_mask;
+    uint32_t flags;                 // HYP_PART_*
+    uint64_t entry;                 // vCPU 0 entry (IPA)
+    uint64_t boot_arg;              // vCPU 0 x0 (the DTB for Linux)
+    hyp_region_t regions[HYP_MAX_REGIONS];
+    uint32_t num_regions;
+    uint32_t irqs[HYP_MAX_IRQS];    // SPIs owned by the guest
+    uint32_t num_irqs;
+    uint32_t pm_nodes[HYP_MAX_PM_IDS];  // EEMI node IDs of its devices
+    uint32_t num_pm_nodes;
+    uint32_t pm_resets[HYP_MAX_PM_IDS]; // EEMI reset IDs of its devices
+    uint32_t num_pm_resets;
+} hyp_partition_t;
+
+/*
+ * struct hyp_frame_t
+ * Lower-EL register file saved on the EL2 stack (layout shared with
+ * hyp_entry.S).
+ */
+typedef struct {
+    uint64_t x[31];
+    uint64_t elr;
+    uint64_t spsr;
+    uint64_t pad;
+} hyp_frame_t;
+
+typedef enum {
+    HYP_CPU_OFF = 0,
+    HYP_CPU_RT,
+    HYP_CPU_GUEST
+} hyp_cpu_state_t;
+
+/*
+ * struct hyp_cpu_t
+ * Per physical core. Written at EL2 by the owning core, read by the RT
+ * side for start/stop and statistics.
+ */
+typedef struct {
+    volatile uint32_t state;        // hyp_cpu_state_t
+    volatile uint32_t stop;         // Set by RT before HYP_SGI_STOP
+    uint32_t core;
+    uint32_t vcpu;                  // Index in the guest (guest cores only)
+    uint64_t entry;                 // Where the next power-on enters EL1
+    uint64_t arg;                   // ... and its x0
+    uint32_t backlog[HYP_LR_BACKLOG];   // Ready-made LR values, oldest first
+    uint32_t nr_backlog;
+
+    /* Exit statistics */
+    uint64_t irqs;                  // Physical IRQs injected
+    uint64_t mmio;                  // Emulated distributor accesses
+    uint64_t smc;                   // Trapped SMC/HVC calls
+    uint64_t faults;                // Aborts/undefs reflected to EL1
+    uint64_t dropped;               // Injections lost to a full backlog
+} __attribute__((aligned(64))) hyp_cpu_t;
+
+/*
+ * struct hyp_state_t
+ * Everything EL2 needs, built by hyp_init() at EL1.
+ */
+typedef struct {
+    uint32_t active;
+    uint32_t rt_mask;
+    uint32_t guest_mask;
+    uint32_t nr_vcpus;
+    uint8_t vcpu_core[HYP_MAX_CORES];       // vCPU -> physical core
+    const hyp_partition_t *guest;
+    uint64_t rt_vttbr;
+    uint64_t guest_vttbr;
+    uint64_t guest_hcr;
+    uint32_t guest_spi[32];                 // Bitmap of owned interrupt IDs
+    hyp_cpu_t cpu[HYP_MAX_CORES];
+} hyp_state_t;
+
+/*
+ * struct hyp_el2_regs_t
+ * EL2 translation regime, read with the EL2 MMU off by cores coming up
+ * (layout shared with hyp_entry.S).
+ */
+typedef struct {
+    uint64_t mair;
+    uint64_t tcr;
+    uint64_t ttbr0;
+    uint64_t sctlr;
+    uint64_t ready;
+} __attribute__((aligned(64))) hyp_el2_regs_t;
+
+extern hyp_state_t hyp;
+extern hyp_el2_regs_t hyp_el2_regs;
+extern volatile uint64_t hyp_boot_el2;
+extern const hyp_partition_t hyp_guest_linux;
+extern const hyp_partition_t hyp_guest_noise;
+
+typedef uint64_t (*hyp_fn_t)(uint64_t arg);
+
+/* Function Prototypes (EL1) */
+int hyp_init(const hyp_partition_t *guest);
+int hyp_active(void);
+int hyp_core_is_rt(uint32_t core);
+int hyp_cpu_on(uint32_t core, uint64_t entry, uint64_t arg);
+int hyp_guest_start(void);
+int hyp_guest_stop(void);
+int hyp_guest_running(void);
+uint64_t hyp_call(hyp_fn_t fn, uint64_t arg);
+void hyp_dump_stats(void);
+void hyp_benchmark(void);
+
+/* Function Prototypes (EL2, hyp_el2.c / hyp_vgic.c) */
+uint64_t hyp_el2_rt_join(uint64_t arg);
+uint64_t hyp_el2_cpu_on(uint64_t core);
+void hyp_el2_cpu_off(hyp_cpu_t *cpu);
+void hyp_cpu_boot(uint64_t core, hyp_frame_t *f);
+void hyp_handle_sync(hyp_frame_t *f);
+void hyp_handle_irq(hyp_frame_t *f);
+void hyp_handle_fatal(hyp_frame_t *f, uint64_t kind);
+void hyp_vgic_cpu_init(hyp_cpu_t *cpu);
+void hyp_vgic_cpu_off(hyp_cpu_t *cpu);
+void hyp_vgic_irq(hyp_cpu_t *cpu);
+int hyp_vgicd_access(hyp_cpu_t *cpu, uint32_t offset, uint32_t size, int write, uint64_t *val);
+
+/* Implemented in hyp_entry.S */
+void hyp_vectors_el2(void);
+void hyp_cpu_entry(void);
+void hyp_noise_guest(void);
+
+#endif /* _PHOTONX_KERNEL_HYP_H_ */
@@ -0,0 +1,120 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/irq_moderation.h
+ * Module:      Adaptive Interrupt Moderation
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Sits between the GIC dispatcher and high-rate event sources (HOCS job
+ * completions, GEM RX). Each source runs in one of three modes:
+ *
+ * PER_EVENT   - Classic one-IRQ-per-event. Lowest latency at low rates.
+ * BATCH_POLL  - Device IRQ masked; events reaped from a periodic TTC tick.
+ *               Poll interval sized for a target batch, capped by the
+ *               source's latency budget.
+ * STORM       - Line produced unclaimed IRQs at a runaway rate and was masked.
+ *               Re-armed after an exponential back-off.
+ *
+ * The per-event -> batch threshold is derived from the measured cost of a
+ * single interrupt, so that per-event mode never burns more than
+ * IRQ_MOD_CPU_BUDGET_PCT of a core.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_IRQ_MODERATION_H_
+#define _PHOTONX_KERNEL_IRQ_MODERATION_H_
+
+#include <stdint.h>
+
+/* =========================================================================
+ * CONFIGURATION
+ * ========================================================================= */
+#define IRQ_MOD_WINDOW_US           1000    // Rate measurement window
+#define IRQ_MOD_CPU_BUDGET_PCT      5       // Max CPU share for per-event IRQs
+#define IRQ_MOD_MIN_THRESHOLD_EPS   5000    // Never batch below this rate
+#define IRQ_MOD_TARGET_BATCH        16      // Events per poll in batch mode
+#define IRQ_MOD_MIN_POLL_US         10      // Fastest poll tick
+#define IRQ_MOD_POLL_BUDGET         64      // Max events reaped per poll call
+#define IRQ_MOD_STORM_UNCLAIMED     2000    // Unclaimed IRQs per window => storm
+#define IRQ_MOD_STORM_BACKOFF_MS    10      // First re-arm delay
+#define IRQ_MOD_STORM_BACKOFF_MAX   1000    // Back-off ceiling (ms)
+
+/* Source Flags */
+#define IRQ_MOD_F_NO_BATCH          (1 << 0)    // Always per-event (benchmark baseline)
+
+typedef enum {
+    IRQ_MOD_PER_EVENT = 0,
+    IRQ_MOD_BATCH_POLL,
+    IRQ_MOD_STORM
+} irq_mod_mode_t;
+
+/*
+ * struct irq_mod_t
+ * One moderated interrupt source. 'poll' must acknowledge the device and
+ * reap up to 'budget' events, returning how many it found.
+ */
+typedef struct irq_mod {
+    const char *name;
+    uint32_t irq_num;
+    uint32_t flags;
+    uint32_t max_latency_us;        // Batch-mode completion latency budget
+
+    uint32_t (*poll)(void *arg, uint32_t budget);
+    void (*mask)(void *arg);        // Device-level IRQ mask
+    void (*unmask)(void *arg);
+    void *arg;
+
+    /* Adaptive State */
+    irq_mod_mode_t mode;
+    uint64_t window_start_ns;
+    uint32_t window_events;
+    uint32_t window_irqs;
+    uint32_t window_unclaimed;
+    uint32_t rate_eps;              // Smoothed events/s
+    uint32_t high_eps;              // Per-event -> batch threshold
+    uint32_t low_eps;               // Batch -> per-event threshold (hysteresis)
+    uint32_t poll_interval_us;
+    uint64_t next_poll_ns;
+    uint32_t irq_cost_ns;           // Smoothed cost of one IRQ
+    uint32_t storm_backoff_ms;
+    uint64_t storm_rearm_ns;
+
+    /* Statistics */
+    uint64_t irqs;
+    uint64_t polls;
+    uint64_t empty_polls;
+    uint64_t events;
+    uint64_t mode_switches;
+    uint64_t storms;
+    uint64_t cpu_ns;                // Time spent in IRQ + poll paths
+
+    struct irq_mod *next;
+} irq_mod_t;
+
+/*
+ * struct irq_mod_env_t
+ * Clock and tick source. Defaults to the generic timer + TTC0; the
+ * benchmark substitutes a virtual clock. now_ns only drives windows and
+ * poll deadlines; handler cost is always timed with the generic timer.
+ */
+typedef struct {
+    uint64_t (*now_ns)(void);
+    void (*tick_start)(uint32_t period_us);
+    void (*tick_stop)(void);
+    uint32_t irq_entry_ns;          // Fixed exception entry/exit + GIC ack/EOI cost
+    uint8_t  attach_gic;            // 1 = register lines with the GIC dispatcher
+} irq_mod_env_t;
+
+/* Function Prototypes */
+void irq_mod_init(const irq_mod_env_t *env);
+int irq_mod_register(irq_mod_t *mod);
+void irq_mod_unregister(irq_mod_t *mod);
+void irq_mod_isr(uint32_t irq_id, void *arg);
+void irq_mod_tick(uint32_t irq_id, void *arg);
+void irq_mod_dump_stats(void);
+void irq_mod_benchmark(void);
+
+#endif /* _PHOTONX_KERNEL_IRQ_MODERATION_H_ */
@@ -0,0 +1,70 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/irq_prio.h
+ * Module:      Priority-Mask Critical Sections
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Critical sections that mask interrupts by priority instead of globally.
+ * irq_prio_save_and_raise(level) lowers GICC_PMR so that every line with
+ * a priority value >= 'level' stays pending until irq_prio_restore();
+ * lines configured more urgent than 'level' (the system timer at 0x00)
+ * are still taken inside the section.
+ *
+ * RULES:
+ * - Data guarded at a ceiling must never be touched by a handler running
+ *   above it (priority value < ceiling).
+ * - Sections nest: the mask only ever rises, restore puts back what the
+ *   matching save found.
+ * - Per core, like DAIF.I: no exclusion against other cores.
+ *
+ * An IRQ already signalled to the core when the mask is raised may still
+ * be taken; the GIC then acknowledges it as spurious (1023), which
+ * gic_handle_irq_c_handler() ignores.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_IRQ_PRIO_H_
+#define _PHOTONX_KERNEL_IRQ_PRIO_H_
+
+#include <stdint.h>
+#include "drivers/gic_v2.h"
+
+/* =========================================================================
+ * CEILINGS
+ * ========================================================================= */
+#define IRQ_PRIO_CEIL_KERNEL        GIC_PRIO_HIGH   // Allocators, UART rings
+#define IRQ_PRIO_CEIL_ALL           0x00            // Every GIC line (still not FIQ/SError); scheduler queues
+
+/*
+ * irq_prio_save_and_raise
+ * Masks lines at priority 'level' and below; returns the previous mask.
+ */
+static inline uint32_t irq_prio_save_and_raise(uint32_t level) {
+    volatile uint32_t *pmr = (volatile uint32_t *)GICC_PMR;
+    uint32_t saved = *pmr;
+
+    if (level < saved) {
+        *pmr = level;
+        (void)*pmr;                                 // Read back: the write has reached the GIC
+    }
+    asm volatile("" ::: "memory");
+    return saved;
+}
+
+/*
+ * irq_prio_restore
+ * Ends the section opened by the matching irq_prio_save_and_raise().
+ */
+static inline void irq_prio_restore(uint32_t saved) {
+    asm volatile("" ::: "memory");
+    *(volatile uint32_t *)GICC_PMR = saved;
+}
+
+/* Function Prototypes */
+void irq_prio_benchmark(void);
+
+#endif /* _PHOTONX_KERNEL_IRQ_PRIO_H_ */
@@ -0,0 +1,71 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/memguard.h
+ * Module:      Per-Core Memory Bandwidth Regulator (MemGuard)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53 PMU)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Core 0 (photonic control loop) is never regulated. Each other core gets a
+ * budget of DDR-bound events per period, counted by its own PMU event
+ * counter 0 (L2 refills by default). The counter is preloaded so that it
+ * overflows when the budget is spent; the overflow interrupt throttles the
+ * core (it spins in WFE inside the handler) until the next period.
+ *
+ * PERIOD (TTC1 tick on core 0 -> SGI to the regulated cores):
+ * 1. The reclaim pool is emptied.
+ * 2. Each core predicts its need from last period's usage and donates the
+ *    rest of its budget to the pool.
+ * 3. A core that overflows first tries to take a chunk from the pool, and
+ *    is only throttled when the pool is dry.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_MEMGUARD_H_
+#define _PHOTONX_KERNEL_MEMGUARD_H_
+
+#include <stdint.h>
+#include "kernel/smp.h"
+
+/* =========================================================================
+ * CONFIGURATION
+ * ========================================================================= */
+#define MEMGUARD_PERIOD_US          1000
+#define MEMGUARD_DEFAULT_BUDGET     2000    // Events per period (~128MB/s of 64B lines)
+#define MEMGUARD_MIN_PREDICT        100     // Never predict below this
+#define MEMGUARD_RECLAIM_CHUNK      200     // Events taken from the pool per overflow
+
+/* A53 PMU Events */
+#define PMU_EV_L2D_CACHE_REFILL     0x17
+#define PMU_EV_BUS_ACCESS           0x19
+
+/* APU PMU Interrupts (one SPI per core) */
+#define APU_PMU0_IRQ_ID             175
+
+/* SGI used for the period start */
+#define MEMGUARD_SGI_PERIOD         1
+
+typedef struct {
+    uint32_t budget;                // Configured events per period (0: unregulated)
+    uint32_t assigned;              // Counter target this period (prediction + reclaimed)
+    uint32_t last_used;             // Events counted last period
+    volatile uint32_t throttled;    // Inside the overflow handler waiting
+
+    /* Statistics */
+    uint64_t periods;
+    uint64_t throttle_count;
+    uint64_t throttle_ns;
+    uint64_t reclaimed;             // Events taken from the pool
+    uint64_t donated;               // Events given to the pool
+} memguard_core_t;
+
+/* Function Prototypes */
+void memguard_init(uint32_t event, uint32_t budget);
+void memguard_set_budget(uint32_t core, uint32_t budget);
+void memguard_stop(void);
+void memguard_dump_stats(void);
+void memguard_benchmark(void);
+
+#endif /* _PHOTONX_KERNEL_MEMGUARD_H_ */
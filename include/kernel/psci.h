@@ -0,0 +1,79 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/psci.h
+ * Module:      PSCI (Power State Coordination Interface) Client
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (ARM Trusted Firmware / QEMU)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Function IDs and power_state encodings for PSCI v1.x. On the KV260 the
+ * calls are serviced by ATF at EL3 through SMC. QEMU's built-in PSCI
+ * emulation answers the same calls, so the conduit is selectable.
+ *
+ * REFERENCE:
+ * ARM DEN 0022D: Power State Coordination Interface
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_PSCI_H_
+#define _PHOTONX_KERNEL_PSCI_H_
+
+#include <stdint.h>
+
+/* =========================================================================
+ * FUNCTION IDENTIFIERS (SMC64 Calling Convention)
+ * ========================================================================= */
+#define PSCI_FN_VERSION             0x84000000U
+#define PSCI_FN_CPU_SUSPEND         0xC4000001U
+#define PSCI_FN_CPU_OFF             0x84000002U
+#define PSCI_FN_CPU_ON              0xC4000003U
+#define PSCI_FN_AFFINITY_INFO       0xC4000004U
+#define PSCI_FN_SYSTEM_OFF          0x84000008U
+#define PSCI_FN_SYSTEM_RESET        0x84000009U
+#define PSCI_FN_FEATURES            0x8400000AU
+
+/* =========================================================================
+ * RETURN CODES
+ * ========================================================================= */
+#define PSCI_RET_SUCCESS            0
+#define PSCI_RET_NOT_SUPPORTED      (-1)
+#define PSCI_RET_INVALID_PARAMS     (-2)
+#define PSCI_RET_DENIED             (-3)
+#define PSCI_RET_ALREADY_ON         (-4)
+
+/* =========================================================================
+ * POWER_STATE PARAMETER (Original Format)
+ * [15:0]  StateID   (Platform specific)
+ * [16]    StateType (0 = Standby/Retention, 1 = Powerdown)
+ * [25:24] PowerLevel (0 = Core, 1 = Cluster)
+ * ========================================================================= */
+#define PSCI_STATE_TYPE_STANDBY     (0U << 16)
+#define PSCI_STATE_TYPE_POWERDOWN   (1U << 16)
+#define PSCI_STATE_LEVEL_CORE       (0U << 24)
+#define PSCI_STATE_LEVEL_CLUSTER    (1U << 24)
+
+#define PSCI_STATE_CORE_RETENTION   (PSCI_STATE_LEVEL_CORE | PSCI_STATE_TYPE_STANDBY | 0x1)
+#define PSCI_STATE_CORE_OFF         (PSCI_STATE_LEVEL_CORE | PSCI_STATE_TYPE_POWERDOWN | 0x2)
+#define PSCI_STATE_CLUSTER_OFF      (PSCI_STATE_LEVEL_CLUSTER | PSCI_STATE_TYPE_POWERDOWN | 0x2)
+
+/* Conduit Selection */
+typedef enum {
+    PSCI_CONDUIT_NONE = 0,
+    PSCI_CONDUIT_SMC,           // EL3 firmware (ATF on hardware, QEMU xlnx-zcu102)
+    PSCI_CONDUIT_HVC            // EL2 firmware (QEMU virt with virtualization=on)
+} psci_conduit_t;
+
+/* Function Prototypes */
+int psci_init(psci_conduit_t conduit);
+int64_t psci_call(uint32_t fn, uint64_t a1, uint64_t a2, uint64_t a3);
+uint32_t psci_get_version(void);
+int psci_cpu_suspend(uint32_t power_state);
+int psci_cpu_on(uint64_t mpidr, uint64_t entry, uint64_t context_id);
+
+/* Implemented in cpu_suspend.S */
+int cpu_suspend_enter(uint32_t power_state);
+void cpu_resume(void);
+
+#endif /* _PHOTONX_KERNEL_PSCI_H_ */
@@ -0,0 +1,100 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/pstore.h
+ * Module:      Crash-Persistent Log & Trace Store
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (DDR, top of low 2GB)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * A reserved DDR block (ZYNQMP_PSTORE_BASE) outside BSS and the heap holds
+ * the kprintf ring and the per-core binary trace rings. DDR keeps its
+ * contents across a warm reset (SRST, watchdog, JTAG APU reset), so the
+ * next boot can print what the previous run was doing when it died.
+ *
+ * The block is split into two banks. Each boot writes into the bank the
+ * previous boot did not use, so the previous run's log stays intact for
+ * inspection for the whole lifetime of the new one.
+ *
+ * ZERO-OVERHEAD LOGGING:
+ * The persistent rings ARE the log buffers. kprintf stores each character
+ * straight into the live bank and trace_emit() writes records in place;
+ * there is no staging copy, no checksum and no flush on the logging path.
+ * The log ring is shared by every core, so each character is stored under
+ * a short spinlock; the trace rings are per core and need none.
+ * Only the header (written once at boot) is checksummed. The block is
+ * mapped Write-Through so nothing is stranded in the D-cache by a hang.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_PSTORE_H_
+#define _PHOTONX_KERNEL_PSTORE_H_
+
+#include <stdint.h>
+#include "platform/zynqmp_hardware.h"
+#include "kernel/trace.h"
+
+/* =========================================================================
+ * CONFIGURATION
+ * ========================================================================= */
+#define PSTORE_MAGIC                0x53505850  // "PXPS"
+#define PSTORE_VERSION              1
+#define PSTORE_BANKS                2
+#define PSTORE_BANK_SIZE            (ZYNQMP_PSTORE_SIZE / PSTORE_BANKS)
+#define PSTORE_LOG_SIZE             65536       // Must be a power of 2
+#define PSTORE_PANIC_MSG_LEN        96
+
+#define PSTORE_DUMP_LOG_TAIL        2048        // Bytes of old log shown at boot
+#define PSTORE_DUMP_TRACE_TAIL      16          // Records per core shown at boot
+
+/* Run State (as last recorded by the run owning the bank) */
+#define PSTORE_STATE_RUNNING        0x52554E21  // Died without saying why (hang/WDT/reset)
+#define PSTORE_STATE_PANIC          0x50414E21
+
+/* =========================================================================
+ * LAYOUT
+ * ========================================================================= */
+
+/*
+ * struct pstore_hdr_t
+ * 'layout_csum' covers version through timer_hz ('magic' is compared on
+ * its own). The volatile fields after it change at run time and are
+ * validated by range instead.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t boot_seq;
+    uint32_t reset_reason;          // CRL_APB RESET_REASON seen by this boot
+    uint32_t bank_size;
+    uint32_t log_size;
+    uint32_t trace_cpus;
+    uint32_t trace_entries;
+    uint64_t boot_ts;               // cntpct_el0 at pstore_init
+    uint64_t timer_hz;
+    uint32_t layout_csum;
+    volatile uint32_t state;
+    volatile uint64_t log_head;     // Free-running byte count
+    char panic_msg[PSTORE_PANIC_MSG_LEN];
+} __attribute__((aligned(64))) pstore_hdr_t;
+
+typedef struct {
+    pstore_hdr_t hdr;
+    char log[PSTORE_LOG_SIZE];
+    trace_ring_t trace[TRACE_MAX_CPUS];
+} __attribute__((aligned(64))) pstore_bank_t;
+
+_Static_assert(sizeof(pstore_bank_t) <= PSTORE_BANK_SIZE, "pstore bank exceeds reserved block");
+
+/* Live bank of this boot (NULL until pstore_init) */
+extern pstore_bank_t *pstore_live;
+
+/* Function Prototypes */
+void pstore_init(void);
+void pstore_log_putc(char c);
+int pstore_has_previous(void);
+void pstore_dump_previous(void);
+void pstore_panic(const char *reason);
+
+#endif /* _PHOTONX_KERNEL_PSTORE_H_ */
@@ -0,0 +1,68 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/smp.h
+ * Module:      Secondary Core Bring-Up & Work Dispatch
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (4x Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Core 0 runs the kernel and the photonic control loop. Cores 1..3 are
+ * started through PSCI CPU_ON, join core 0's translation regime and then
+ * wait (WFE) for one function at a time to run: best-effort work such as
+ * rendering, bulk copies or benchmark co-runners. They take interrupts
+ * (SGIs, their own PMU overflow) but no device IRQs, which stay on core 0.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_SMP_H_
+#define _PHOTONX_KERNEL_SMP_H_
+
+#include <stdint.h>
+
+#define SMP_MAX_CORES               4
+#define SMP_BOOT_TIMEOUT_US         100000
+
+typedef void (*smp_fn_t)(void *arg);
+
+/*
+ * struct smp_core_t
+ * Per-core mailbox. 'fn' is the doorbell: set last by the owner (core 0),
+ * cleared by the core when the call returns.
+ */
+typedef struct {
+    volatile smp_fn_t fn;
+    void *arg;
+    volatile uint32_t online;
+    uint64_t runs;
+} __attribute__((aligned(64))) smp_core_t;
+
+/* Translation regime handed to secondaries (read with the MMU off) */
+typedef struct {
+    uint64_t mair;
+    uint64_t tcr;
+    uint64_t ttbr0;
+    uint64_t sctlr;
+} __attribute__((aligned(64))) smp_boot_regs_t;
+
+extern smp_boot_regs_t smp_boot_regs;
+
+static inline uint32_t smp_core_id(void) {
+    uint64_t mpidr;
+    asm volatile("mrs %0, mpidr_el1" : "=r" (mpidr));
+    return (uint32_t)(mpidr & 0xFF);
+}
+
+/* Function Prototypes */
+uint32_t smp_init(void);
+int smp_core_online(uint32_t core);
+int smp_run_on(uint32_t core, smp_fn_t fn, void *arg);
+int smp_core_busy(uint32_t core);
+void smp_wait(uint32_t core);
+void secondary_main(uint64_t core);
+
+/* Implemented in startup.S */
+void secondary_entry(void);
+
+#endif /* _PHOTONX_KERNEL_SMP_H_ */
@@ -129,4 +129,10 @@ uint64_t timer_get_timestamp_ns(void);
 void udelay(uint64_t usecs);
 void mdelay(uint64_t msecs);
 
+/* Raw Counter Access & Conversion */
+uint64_t timer_get_ticks(void);
+uint64_t timer_ticks_to_ns(uint64_t ticks);
+uint64_t timer_ticks_to_us(uint64_t ticks);
+uint64_t timer_get_next_event_ns(void);
+
 #endif /* _PHOTONX_KERNEL_TIMER_HEAVY_H_ */
@@ -0,0 +1,97 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/trace.h
+ * Module:      Binary Event Trace
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Fixed-size 32-byte records in one overwrite ring per core. Records are
+ * written in place with a cntpct_el0 timestamp; nothing is formatted or
+ * copied on the hot path. The rings live in the crash-persistent store, so
+ * the last few thousand events before a crash survive a warm reset.
+ *
+ * No locks and no atomics: each core only writes its own ring. A nested IRQ
+ * that traces between the slot fetch and the head update may overwrite one
+ * record; this is accepted to keep trace_emit() at a handful of stores.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_TRACE_H_
+#define _PHOTONX_KERNEL_TRACE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Build Switch: 0 compiles every trace point away */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE                1
+#endif
+
+#define TRACE_MAX_CPUS              4       // Quad Cortex-A53
+#define TRACE_RING_ENTRIES          2048    // Per core, must be a power of 2
+
+/* Event IDs */
+#define TRACE_EV_BOOT               0x0001  // arg0 = boot_seq
+#define TRACE_EV_PANIC              0x0002
+#define TRACE_EV_SYNC_ABORT         0x0003  // arg0 = ESR, arg1 = ELR, arg2 = FAR
+#define TRACE_EV_HOCS_SUBMIT        0x0100  // arg0 = tag, arg1 = dim
+#define TRACE_EV_HOCS_DONE          0x0101  // arg0 = tag, arg1 = desc status
+#define TRACE_EV_HOCS_PHASES        0x0102  // arg0 = tag, arg1 = queue:dma_in, arg2 = compute:dma_out (ns, 32:32)
+#define TRACE_EV_HOCS_DELIVER       0x0103  // arg0 = tag, arg1 = written->IRQ ns, arg2 = IRQ->wake ns
+#define TRACE_EV_HOCS_STATS         0x0104  // arg0 = irq << 8 | phase, arg1 = count, arg2 = mean:p99
+
+typedef struct {
+    uint64_t ts;                    // cntpct_el0
+    uint16_t id;
+    uint8_t cpu;
+    uint8_t flags;
+    uint32_t arg0;
+    uint64_t arg1;
+    uint64_t arg2;
+} trace_rec_t;
+
+typedef struct {
+    volatile uint64_t head;         // Free-running record count
+    uint64_t reserved;
+    trace_rec_t rec[TRACE_RING_ENTRIES];
+} trace_ring_t;
+
+/* Per-core ring, NULL until attached (trace points are then no-ops) */
+extern trace_ring_t *trace_rings[TRACE_MAX_CPUS];
+
+static inline void trace_emit(uint16_t id, uint32_t arg0, uint64_t arg1, uint64_t arg2) {
+#if TRACE_ENABLE
+    uint64_t mpidr, ts;
+    trace_ring_t *r;
+    trace_rec_t *e;
+
+    asm volatile("mrs %0, mpidr_el1" : "=r" (mpidr));
+    r = trace_rings[mpidr & (TRACE_MAX_CPUS - 1)];
+    if (r == NULL) {
+        return;
+    }
+
+    asm volatile("mrs %0, cntpct_el0" : "=r" (ts));
+    e = &r->rec[r->head & (TRACE_RING_ENTRIES - 1)];
+    e->ts = ts;
+    e->id = id;
+    e->cpu = (uint8_t)mpidr;
+    e->flags = 0;
+    e->arg0 = arg0;
+    e->arg1 = arg1;
+    e->arg2 = arg2;
+    r->head++;
+#else
+    (void)id; (void)arg0; (void)arg1; (void)arg2;
+#endif
+}
+
+/* Function Prototypes */
+void trace_attach(uint32_t cpu, trace_ring_t *ring);
+const char *trace_event_name(uint16_t id);
+void trace_dump_ring(const trace_ring_t *ring, uint32_t last_n, uint64_t ts_base, uint64_t timer_hz);
+
+#endif /* _PHOTONX_KERNEL_TRACE_H_ */
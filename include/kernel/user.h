@@ -0,0 +1,108 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/user.h
+ * Module:      EL0 Tasks & System Calls
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Runs one function at a time unprivileged (EL0) on the calling core's
+ * kernel stack, until it calls SYS_EXIT or faults.
+ *
+ * ADDRESS SPACE:
+ * The kernel identity map is EL1-only, so a task sees nothing but the
+ * user window (L1 entry 4, VA 0x1_0000_0000):
+ *   USER_TEXT_VA   read-only alias of the 'user_text' section (USER_TEXT)
+ *   USER_MAP_VA    pages granted by drivers (rings, doorbells, buffers)
+ *   USER_STACK_TOP downwards, USER_STACK_SIZE
+ * Task code may use its argument, its stack and the granted pages only:
+ * no kernel globals and no calls outside 'user_text' (helpers meant for
+ * EL0 are USER_INLINE).
+ *
+ * SYSTEM CALLS:
+ * SVC #0 with the number in X8 and arguments in X0..X2; the result comes
+ * back in X0. Drivers add their calls with user_syscall_register().
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_USER_H_
+#define _PHOTONX_KERNEL_USER_H_
+
+#include <stdint.h>
+
+/* =========================================================================
+ * USER WINDOW
+ * ========================================================================= */
+#define USER_WINDOW_BASE            0x100000000UL
+#define USER_TEXT_VA                (USER_WINDOW_BASE)
+#define USER_MAP_VA                 (USER_WINDOW_BASE + 0x01000000UL)
+#define USER_MAP_SIZE               0x3E000000UL
+#define USER_STACK_TOP              (USER_WINDOW_BASE + 0x40000000UL)
+#define USER_STACK_SIZE             (64 * 1024)
+
+/* =========================================================================
+ * SYSTEM CALL NUMBERS
+ * ========================================================================= */
+#define SYS_EXIT                    0       // (code)
+#define SYS_HOCS_SUBMIT             1       // (src_va, dst_va, dim), see hocs_uring.h
+#define SYS_HOCS_REAP               2       // ()
+#define SYS_HOCS_WAIT               3       // (cq_target)
+#define SYS_WASM_HOST               4       // (vmctx, index, args), see kernel/wasm.h
+#define USER_MAX_SYSCALLS           16
+
+#define USER_ERR_NOSYS              (-38)
+
+/* Task code and EL0 helpers */
+#define USER_TEXT                   __attribute__((section("user_text"), noinline))
+#define USER_INLINE                 static inline __attribute__((always_inline))
+
+typedef void (*user_fn_t)(uint64_t arg);
+typedef int64_t (*syscall_fn_t)(uint64_t a0, uint64_t a1, uint64_t a2);
+
+/*
+ * struct user_kctx_t
+ * Kernel state saved by user_enter() (layout fixed by startup.S).
+ */
+typedef struct {
+    uint64_t x19_x30[12];
+    uint64_t sp;
+    uint64_t daif;
+} user_kctx_t;
+
+/*
+ * user_syscall
+ * EL0 side of a system call.
+ */
+USER_INLINE int64_t user_syscall(uint64_t nr, uint64_t a0, uint64_t a1, uint64_t a2) {
+    register uint64_t x8 asm("x8") = nr;
+    register uint64_t x0 asm("x0") = a0;
+    register uint64_t x1 asm("x1") = a1;
+    register uint64_t x2 asm("x2") = a2;
+
+    asm volatile("svc #0" : "+r" (x0) : "r" (x8), "r" (x1), "r" (x2) : "memory");
+    return (int64_t)x0;
+}
+
+USER_INLINE void user_exit(int64_t code) {
+    user_syscall(SYS_EXIT, (uint64_t)code, 0, 0);
+    for (;;) { }
+}
+
+/* Assembly (startup.S) */
+extern int64_t user_enter(uint64_t entry, uint64_t arg, uint64_t sp, user_kctx_t *kctx);
+extern void user_leave(user_kctx_t *kctx, int64_t code) __attribute__((noreturn));
+
+/* Function Prototypes */
+int user_init(void);
+int user_syscall_register(uint32_t nr, syscall_fn_t fn);
+int64_t user_run(user_fn_t fn, uint64_t arg);
+int64_t user_run_stack(user_fn_t fn, uint64_t arg, uint64_t sp);
+uint64_t user_text_va(const void *fn);
+int user_map(uint64_t va, uint64_t pa, uint64_t size, int writable);
+void user_unmap(uint64_t va, uint64_t size);
+uint64_t user_syscalls(void);
+void el0_sync_c_handler(uint64_t *frame);
+
+#endif /* _PHOTONX_KERNEL_USER_H_ */
@@ -0,0 +1,482 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/kernel/wasm.h
+ * Module:      WebAssembly Runtime (Web-Container Engine)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Runs WebAssembly 1.0 modules (plus sign extension, saturating float to
+ * int conversion and memory.copy/fill) as isolated containers, two ways:
+ *
+ *   INTERPRETER  Validation lowers every function into a fixed-width IR
+ *                (branch targets and stack heights resolved, dead code
+ *                dropped) in one pass; a threaded-dispatch loop runs it.
+ *                No compile step, so this is the cold-start path.
+ *   AOT          A single-pass compiler from the same IR to AArch64:
+ *                hot locals in callee-saved registers, a register-cached
+ *                operand stack, compare+branch fusion. Linear memory
+ *                accesses carry no bounds checks: each instance reserves
+ *                WASM_MEM_RESERVE of address space (every 32-bit index
+ *                plus 32-bit offset lands inside it) and only the
+ *                committed pages are mapped, so an out-of-bounds access
+ *                faults.
+ *
+ * On PhotonX the AOT code runs at EL0 in the instance's slot of the WASM
+ * window (below): its own vmctx, stack, code and linear memory, nothing
+ * else. Host calls and traps leave through SVC stubs in 'user_text'. The
+ * interpreter runs in the kernel and checks every access instead.
+ *
+ * Host functions are resolved by (module, name) against the tables
+ * registered with wasm_host_register(); "photonx" (wasm_host.c) offers
+ * HOCS job submission, message channels between instances, a clock and
+ * console output.
+ *
+ * HOSTED BUILD:
+ * wasm_sys.c is the PhotonX platform layer; wasm_sys_linux.c replaces it
+ * on Linux (mmap reservations, SIGSEGV for guard faults, a main() running
+ * wasm_benchmark()). On x86 hosts the interpreter runs and the compiler
+ * still produces code; AOT code runs on aarch64 (natively or under QEMU
+ * user mode):
+ *   gcc -O2 -Iinclude -DWASM_HOST_HOCS=0 src/kernel/wasm/wasm_{load,interp,
+ *       runtime,aot,host,bench,sys_linux}.c -lm
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_KERNEL_WASM_H_
+#define _PHOTONX_KERNEL_WASM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Console output: the kernel's, or wasm_sys_linux.c's stdio shim in hosted builds */
+#if defined(__linux__)
+void kprintf(const char *fmt, ...);
+#else
+#include "lib/kprintf.h"
+#endif
+
+/* Build Switch: 0 leaves the HOCS host functions out (hosted builds) */
+#ifndef WASM_HOST_HOCS
+#define WASM_HOST_HOCS              1
+#endif
+
+/* =========================================================================
+ * LIMITS
+ * ========================================================================= */
+#define WASM_PAGE_SIZE              65536
+#define WASM_MAX_PAGES              65536       // 4 GB
+#define WASM_MEM_RESERVE            ((8ULL << 30) + WASM_PAGE_SIZE)
+#define WASM_MAX_TYPES              512
+#define WASM_MAX_FUNCS              8192
+#define WASM_MAX_IMPORTS            64
+#define WASM_MAX_GLOBALS            128
+#define WASM_MAX_TABLE              4096
+#define WASM_MAX_PARAMS             16
+#define WASM_MAX_LOCALS             4096
+#define WASM_MAX_HEIGHT             4096        // Operand stack per function
+#define WASM_MAX_NESTING            512
+#define WASM_MAX_HOST_TABLES        8
+#define WASM_MAX_CHANNELS           8
+
+#define WASM_INTERP_SLOTS           (256 * 1024)    // Interpreter value stack (2 MB)
+#define WASM_INTERP_FRAMES          4096
+#define WASM_STACK_SIZE             (1024 * 1024)   // AOT native stack
+#define WASM_STACK_RESERVE          (32 * 1024)     // Kept free below the stack limit
+
+/* =========================================================================
+ * WASM WINDOW (PhotonX): L0 entry 1, one 16 GB slot per instance
+ * ========================================================================= */
+#define WASM_WINDOW_BASE            0x8000000000UL
+#define WASM_SLOT_SIZE              (16ULL << 30)
+#define WASM_MAX_INSTANCES          32
+#define WASM_SLOT_VMCTX             0x00000000UL    // wasm_vmctx_t
+#define WASM_SLOT_STACK_TOP         0x00200000UL    // Stack below, guard page under it
+#define WASM_SLOT_CODE              0x01000000UL    // Module code, read-only + executable
+#define WASM_SLOT_CODE_MAX          (240UL << 20)
+#define WASM_SLOT_MEM               0x100000000UL   // Linear memory reservation
+
+/* =========================================================================
+ * VALUE TYPES / RESULT CODES
+ * ========================================================================= */
+#define WASM_I32                    0x7F
+#define WASM_I64                    0x7E
+#define WASM_F32                    0x7D
+#define WASM_F64                    0x7C
+#define WASM_VOID                   0x40
+
+#define WASM_OK                     0
+#define WASM_ERR_MALFORMED          (-1)    // Not a well-formed binary
+#define WASM_ERR_INVALID            (-2)    // Fails validation
+#define WASM_ERR_UNSUPPORTED        (-3)    // Valid, but beyond this runtime
+#define WASM_ERR_NOMEM              (-4)
+#define WASM_ERR_LINK               (-5)    // Unresolved or mistyped import
+#define WASM_ERR_TRAP               (-6)    // See wasm_instance_t.trap
+#define WASM_ERR_NOAOT              (-7)    // No native code on this host
+#define WASM_ERR_NOTFOUND           (-8)
+
+/* Trap Codes */
+#define WASM_TRAP_NONE              0
+#define WASM_TRAP_UNREACHABLE       1
+#define WASM_TRAP_MEMORY            2       // Out-of-bounds linear memory access
+#define WASM_TRAP_DIV_ZERO          3
+#define WASM_TRAP_OVERFLOW          4       // Integer overflow (div, float to int)
+#define WASM_TRAP_CONVERSION        5       // NaN to integer
+#define WASM_TRAP_TABLE             6       // Undefined table element
+#define WASM_TRAP_SIGNATURE         7       // call_indirect type mismatch
+#define WASM_TRAP_STACK             8       // Call stack exhausted
+#define WASM_TRAP_HOST              9       // Raised by a host function
+
+/* Execution Modes */
+#define WASM_MODE_INTERP            0
+#define WASM_MODE_AOT               1
+
+/* =========================================================================
+ * MODULE
+ * ========================================================================= */
+
+typedef struct {
+    uint8_t nparams;
+    uint8_t nresults;               // 0 or 1
+    uint8_t result;
+    uint8_t params[WASM_MAX_PARAMS];
+} wasm_type_t;
+
+/* IR opcodes beyond the wasm ones */
+#define WASM_OP_FC                  0x100   // 0xFC xx -> WASM_OP_FC + xx
+#define WASM_OP_CALL_HOST           0x120   // call of an imported function
+#define WASM_OP_COUNT               0x128
+
+/*
+ * struct wasm_ins_t
+ * One IR instruction. 'op' is the wasm opcode (0x1C select is folded
+ * into 0x1B). Operands, by opcode:
+ *   br, br_if, else   a = target IR index, b = frame slot the carried
+ *                     values land in (locals + target height)
+ *   if                a = else/end IR index, b = frame slot of the height
+ *   br_table          a = first wasm_brtab_t, b = entries (default last)
+ *   call(_host)       a = function / import index
+ *   call_indirect     a = canonical type
+ *   local.*, global.* a = index
+ *   loads, stores     a = offset
+ *   consts            b = value bits
+ * 'arity' is the number of values a branch carries or a return returns.
+ */
+typedef struct {
+    uint16_t op;
+    uint8_t type;                   // Value type where the op needs one
+    uint8_t arity;
+    uint32_t a;
+    uint64_t b;
+} wasm_ins_t;
+
+typedef struct {
+    uint32_t pc;
+    uint32_t slot;
+} wasm_brtab_t;
+
+typedef struct {
+    uint32_t type;                  // Canonical type index
+    uint32_t nlocals;               // Parameters included
+    const uint8_t *local_types;
+    uint32_t max_height;
+    uint32_t ir;                    // First IR instruction
+    uint32_t ir_len;
+    uint32_t aot;                   // Code offset of the compiled body
+} wasm_func_t;
+
+typedef struct {
+    const char *module;
+    uint32_t module_len;
+    const char *name;
+    uint32_t name_len;
+    uint32_t type;
+} wasm_import_t;
+
+typedef struct {
+    const char *name;
+    uint32_t name_len;
+    uint8_t kind;                   // 0 func, 1 table, 2 memory, 3 global
+    uint32_t index;
+} wasm_export_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t mut;
+    uint64_t init;
+} wasm_global_t;
+
+typedef struct {
+    uint32_t offset;
+    uint32_t count;
+    const uint32_t *funcs;
+} wasm_elem_t;
+
+typedef struct {
+    uint32_t offset;
+    uint32_t len;
+    const uint8_t *bytes;           // Points into the binary
+} wasm_data_t;
+
+struct wasm_chunk;
+
+/*
+ * struct wasm_module_t
+ * A validated module. Names and data segments point into the binary,
+ * which must outlive the module.
+ */
+typedef struct wasm_module {
+    uint32_t ntypes;
+    wasm_type_t *types;
+    uint32_t *canon;                // Type index -> first structurally equal type
+
+    uint32_t nimports;              // Function imports: indices 0 .. nimports-1
+    wasm_import_t *imports;
+    uint32_t nfuncs;                // Imports included
+    wasm_func_t *funcs;             // [nimports..] defined functions
+
+    uint8_t has_table;
+    uint8_t has_mem;
+    uint32_t table_min;
+    uint32_t table_max;
+    uint32_t mem_min;               // Pages
+    uint32_t mem_max;
+
+    uint32_t nglobals;
+    wasm_global_t *globals;
+    uint32_t nexports;
+    wasm_export_t *exports;
+    int32_t start;                  // -1: none
+    uint32_t nelems;
+    wasm_elem_t *elems;
+    uint32_t ndata;
+    wasm_data_t *data;
+
+    /* Interpreter IR */
+    wasm_ins_t *ir;
+    uint32_t nir;
+    wasm_brtab_t *brtab;
+    uint32_t nbrtab;
+
+    /* AOT code (wasm_aot_compile) */
+    uint32_t *code;
+    size_t code_size;               // Bytes
+    size_t code_alloc;
+    uint32_t *thunk;                // Per canonical type: entry thunk offset
+
+    /* Loader allocations */
+    struct wasm_chunk *chunks;
+    uint64_t load_ns;
+    uint64_t aot_ns;
+} wasm_module_t;
+
+/* =========================================================================
+ * INSTANCE
+ * ========================================================================= */
+
+/* Table element as compiled code sees it */
+typedef struct {
+    uint64_t code;                  // Entry address (AOT)
+    uint32_t type;                  // Canonical type, 0xFFFFFFFF = null
+    uint32_t func;
+} wasm_elem_slot_t;
+
+/* EL0 entry request (wasm_el0_entry) */
+typedef struct {
+    uint64_t thunk;
+    uint64_t fn;
+    uint64_t vmctx;
+    uint64_t args[WASM_MAX_PARAMS];
+} wasm_call_t;
+
+/*
+ * struct wasm_vmctx_t
+ * Per-instance state the AOT code reaches through X28. Mapped at EL0 on
+ * PhotonX: it holds no kernel pointers except 'inst', which the code
+ * never reads.
+ */
+typedef struct {
+    uint64_t mem_base;              // 0x00
+    uint64_t mem_size;              // 0x08  Bytes
+    uint64_t host_call;             // 0x10  fn(vmctx, index, args) -> raw result
+    uint64_t trap_fn;               // 0x18  fn(vmctx, code), does not return
+    uint64_t stack_limit;           // 0x20
+    uint32_t trap;                  // 0x28  Raised by a host call
+    uint32_t table_size;            // 0x2C
+    uint64_t inst;                  // 0x30
+    uint64_t rsvd;
+    wasm_call_t call;               // 0x40
+    uint64_t globals[WASM_MAX_GLOBALS];
+    wasm_elem_slot_t table[WASM_MAX_TABLE];
+} wasm_vmctx_t;
+
+#define WASM_VM_MEM_BASE            0x00
+#define WASM_VM_MEM_SIZE            0x08
+#define WASM_VM_HOST_CALL           0x10
+#define WASM_VM_TRAP_FN             0x18
+#define WASM_VM_STACK_LIMIT         0x20
+#define WASM_VM_TRAP                0x28
+#define WASM_VM_TABLE_SIZE          0x2C
+#define WASM_VM_GLOBALS             (0x40 + sizeof(wasm_call_t))
+#define WASM_VM_TABLE               (WASM_VM_GLOBALS + 8 * WASM_MAX_GLOBALS)
+#define WASM_VMCTX_SIZE             ((sizeof(wasm_vmctx_t) + 0xFFFF) & ~0xFFFFUL)
+
+/* Runtime helpers behind host_call (negative import indices) */
+#define WASM_BUILTIN_GROW           0xFFFFFFF0U     // (delta) -> old pages / -1
+#define WASM_BUILTIN_COPY           0xFFFFFFF1U     // (dst, src, n)
+#define WASM_BUILTIN_FILL           0xFFFFFFF2U     // (dst, val, n)
+
+struct wasm_instance;
+struct wasm_hocs_ctx;
+struct wasm_chan;
+
+/*
+ * Host function: i32/f32 arguments in the low 32 bits of their slot.
+ * Returns the raw result bits; wasm_trap() aborts the caller.
+ */
+typedef uint64_t (*wasm_host_fn_t)(struct wasm_instance *inst, const uint64_t *args);
+
+typedef struct {
+    const char *module;
+    const char *name;
+    const char *sig;                // "params:result", e.g. "iiI:i" (i i32, I i64, f f32, F f64)
+    wasm_host_fn_t fn;
+} wasm_host_t;
+
+/* Physically contiguous piece of committed linear memory */
+typedef struct {
+    uint32_t off;                   // Linear address
+    uint32_t size;
+    uint64_t pa;
+} wasm_mem_chunk_t;
+
+#define WASM_MAX_MEM_CHUNKS         32
+
+typedef struct wasm_instance {
+    const wasm_module_t *mod;
+    wasm_vmctx_t *vm;
+    uint32_t slot;
+    uint32_t mode;                  // WASM_MODE_*
+    uint32_t trap;                  // Last trap (WASM_ERR_TRAP)
+    uint32_t pages;
+    uint32_t max_pages;
+    const wasm_host_t *host[WASM_MAX_IMPORTS];
+
+    /* Interpreter */
+    uint64_t *stack;
+    uint32_t running;
+
+    /* AOT */
+    uint64_t code_va;
+    uint64_t stack_top;
+
+    /* Linear memory backing */
+    wasm_mem_chunk_t chunk[WASM_MAX_MEM_CHUNKS];
+    uint32_t nchunks;
+
+    /* Host state */
+    struct wasm_hocs_ctx *hocs;
+    struct wasm_chan *chan[WASM_MAX_CHANNELS];
+    uint64_t host_calls;
+} wasm_instance_t;
+
+/* =========================================================================
+ * MESSAGE CHANNELS
+ * ========================================================================= */
+#define WASM_CHAN_BYTES             (64 * 1024)     // Ring, power of 2
+#define WASM_CHAN_MSG_MAX           4096
+
+/*
+ * struct wasm_chan_t
+ * Single-producer/single-consumer ring of length-prefixed messages
+ * between two instances (or an instance and the kernel).
+ */
+typedef struct wasm_chan {
+    volatile uint32_t head;         // Producer: bytes written
+    uint32_t rsvd0[15];
+    volatile uint32_t tail;         // Consumer: bytes read
+    uint32_t rsvd1[15];
+    uint64_t sent;
+    uint64_t dropped;               // Ring full
+    uint8_t ring[WASM_CHAN_BYTES];
+} wasm_chan_t;
+
+#if WASM_HOST_HOCS
+#include "drivers/hocs.h"
+
+#define WASM_HOCS_JOBS              16      // Jobs in flight per instance
+
+/*
+ * struct wasm_hocs_ctx_t
+ * An instance's HOCS jobs (host functions hocs_submit/hocs_wait).
+ */
+typedef struct wasm_hocs_ctx {
+    hocs_device_t *dev;
+    uint32_t busy;                  // Slot bitmap
+    uint64_t submitted;
+    hocs_job_t job[WASM_HOCS_JOBS];
+    void *src_bounce[WASM_HOCS_JOBS];       // Staging copies (non-contiguous operands)
+    void *dst_bounce[WASM_HOCS_JOBS];
+    uint32_t src_bytes[WASM_HOCS_JOBS];
+    uint32_t dst_bytes[WASM_HOCS_JOBS];
+    uint32_t dst_off[WASM_HOCS_JOBS];
+} wasm_hocs_ctx_t;
+
+int wasm_hocs_attach(wasm_instance_t *inst, wasm_hocs_ctx_t *h, hocs_device_t *dev);
+#endif
+
+/* =========================================================================
+ * API
+ * ========================================================================= */
+
+/* Loader (wasm_load.c) */
+int wasm_load(wasm_module_t *m, const uint8_t *bin, size_t len);
+void wasm_unload(wasm_module_t *m);
+void *wasm_mod_alloc(wasm_module_t *m, size_t size);
+int wasm_parse_sig(const char *sig, wasm_type_t *t);
+
+/* Runtime (wasm_runtime.c) */
+int wasm_host_register(const wasm_host_t *fns, uint32_t count);
+int wasm_instantiate(wasm_instance_t *inst, const wasm_module_t *m, uint32_t mode);
+void wasm_instance_free(wasm_instance_t *inst);
+int wasm_find_export(const wasm_module_t *m, const char *name, uint32_t *func);
+int wasm_call(wasm_instance_t *inst, uint32_t func, uint64_t *args);
+int wasm_call_export(wasm_instance_t *inst, const char *name, uint64_t *args);
+void wasm_trap(wasm_instance_t *inst, uint32_t code);
+int32_t wasm_mem_grow(wasm_instance_t *inst, uint32_t delta);
+void *wasm_mem_ptr(wasm_instance_t *inst, uint32_t off, uint32_t len);
+uint64_t wasm_host_dispatch(uint64_t vmctx, uint64_t index, uint64_t *args);
+const char *wasm_trap_name(uint32_t code);
+
+/* Interpreter (wasm_interp.c) */
+int wasm_interp_call(wasm_instance_t *inst, uint32_t func, uint64_t *args);
+
+/* AOT compiler (wasm_aot.c) */
+int wasm_aot_compile(wasm_module_t *m);
+
+/* Host module "photonx" (wasm_host.c) */
+void wasm_host_init(void);
+void wasm_chan_init(wasm_chan_t *c);
+int wasm_chan_bind(wasm_instance_t *inst, uint32_t index, wasm_chan_t *c);
+int wasm_chan_send(wasm_chan_t *c, const void *msg, uint32_t len);
+int wasm_chan_recv(wasm_chan_t *c, void *buf, uint32_t cap);
+
+/* Benchmark (wasm_bench.c) */
+void wasm_benchmark(void);
+
+/* Platform layer (wasm_sys.c / wasm_sys_linux.c) */
+void *wasm_sys_alloc(size_t size);
+void wasm_sys_free(void *p, size_t size);
+int wasm_sys_instance_init(wasm_instance_t *inst);
+void wasm_sys_instance_free(wasm_instance_t *inst);
+int wasm_sys_mem_commit(wasm_instance_t *inst, uint32_t pages);
+uint64_t wasm_sys_mem_phys(wasm_instance_t *inst, uint32_t off, uint32_t len);
+void *wasm_sys_code_alloc(size_t size);
+void wasm_sys_code_free(void *code, size_t size);
+int wasm_sys_code_map(wasm_instance_t *inst);
+int wasm_sys_aot_call(wasm_instance_t *inst, uint64_t thunk, uint64_t fn, uint64_t *args);
+uint64_t wasm_sys_now_ns(void);
+
+#endif /* _PHOTONX_KERNEL_WASM_H_ */
@@ -0,0 +1,47 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/lib/aes_gcm.h
+ * Module:      AES-256-GCM (Software)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * AES-256-GCM with a 96-bit IV and no AAD, the mode the CSU AES engine
+ * implements. Two paths, picked per context at aes_gcm_init():
+ * - ARMv8 Crypto Extensions (AESE/AESMC for the cipher, PMULL for GHASH)
+ *   when ID_AA64ISAR0_EL1 reports them; four blocks in flight.
+ * - Portable: one T-table (1KB) AES and a 4-bit table GHASH.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_LIB_AES_GCM_H_
+#define _PHOTONX_LIB_AES_GCM_H_
+
+#include <stdint.h>
+
+#define AES_GCM_KEY_SIZE            32
+#define AES_GCM_IV_SIZE             12
+#define AES_GCM_TAG_SIZE            16
+#define AES_256_ROUNDS              14
+
+#define AES_GCM_F_SCALAR            (1 << 0)    // Never use the crypto extensions
+
+typedef struct {
+    uint32_t rk[4 * (AES_256_ROUNDS + 1)];     // Round keys, big-endian words
+    uint8_t  rk8[16 * (AES_256_ROUNDS + 1)];   // Same, as bytes (AESE operand)
+    uint64_t hl[16];                // GHASH table (portable path)
+    uint64_t hh[16];
+    uint8_t  h[16];                 // Hash key E(K, 0)
+    uint8_t  use_ce;
+} aes_gcm_ctx_t;
+
+/* Function Prototypes */
+int aes_gcm_have_ce(void);
+void aes_gcm_init(aes_gcm_ctx_t *ctx, const uint8_t key[AES_GCM_KEY_SIZE], uint32_t flags);
+void aes_gcm_encrypt(const aes_gcm_ctx_t *ctx, const uint8_t iv[AES_GCM_IV_SIZE],
+                     const void *in, void *out, uint64_t len, uint8_t tag[AES_GCM_TAG_SIZE]);
+int aes_gcm_decrypt(const aes_gcm_ctx_t *ctx, const uint8_t iv[AES_GCM_IV_SIZE],
+                    const void *in, void *out, uint64_t len, const uint8_t tag[AES_GCM_TAG_SIZE]);
+
+#endif /* _PHOTONX_LIB_AES_GCM_H_ */
@@ -0,0 +1,47 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/lib/cobs.h
+ * Module:      Consistent Overhead Byte Stuffing
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * COBS removes every 0x00 from a payload at a cost of at most one byte per
+ * 254, so 0x00 can serve as an unambiguous frame delimiter on a byte stream.
+ * A receiver that loses sync simply waits for the next 0x00.
+ *
+ * Decoding never grows the data, so it can run in place (the output index
+ * never passes the input index).
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_LIB_COBS_H_
+#define _PHOTONX_LIB_COBS_H_
+
+#include <stdint.h>
+
+/* Worst-case encoded size (without the trailing delimiter) */
+#define COBS_MAX_ENCODED(n)     ((n) + ((n) / 254) + 1)
+
+/*
+ * struct cobs_enc_t
+ * Streaming encoder. Buffers at most one 254-byte block, so a large
+ * payload can be fed straight from where it lives without a staging copy.
+ */
+typedef struct {
+    uint8_t block[255];             // block[0] is the code byte
+    uint32_t len;                   // Bytes in the current block (incl. code)
+    void (*emit)(const uint8_t *data, uint32_t len, void *arg);
+    void *arg;
+} cobs_enc_t;
+
+/* Function Prototypes */
+uint32_t cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst);
+int cobs_decode(const uint8_t *src, uint32_t len, uint8_t *dst);
+
+void cobs_enc_begin(cobs_enc_t *e, void (*emit)(const uint8_t *, uint32_t, void *), void *arg);
+void cobs_enc_feed(cobs_enc_t *e, const void *data, uint32_t len);
+void cobs_enc_end(cobs_enc_t *e);
+
+#endif /* _PHOTONX_LIB_COBS_H_ */
@@ -0,0 +1,30 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/lib/crc16.h
+ * Module:      CRC-16/CCITT-FALSE
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Poly 0x1021, init 0xFFFF, no reflection, no final XOR. Table driven
+ * (512 bytes). Detects all burst errors up to 16 bits, which covers the
+ * typical UART framing glitch.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_LIB_CRC16_H_
+#define _PHOTONX_LIB_CRC16_H_
+
+#include <stdint.h>
+
+#define CRC16_INIT              0xFFFF
+
+/* Function Prototypes */
+uint16_t crc16_update(uint16_t crc, const void *data, uint32_t len);
+
+static inline uint16_t crc16_ccitt(const void *data, uint32_t len) {
+    return crc16_update(CRC16_INIT, data, len);
+}
+
+#endif /* _PHOTONX_LIB_CRC16_H_ */
@@ -0,0 +1,59 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/lib/crc32c.h
+ * Module:      CRC-32C (Castagnoli) Checksum
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * CRC-32C (poly 0x1EDC6F41, reflected, init/xorout 0xFFFFFFFF), the
+ * checksum the HOCS IP computes over its DMA streams. crc32c(0, ...) starts
+ * a checksum; passing a previous result continues it.
+ *
+ * With the ARMv8 CRC32 instructions (__ARM_FEATURE_CRC32) buffers are
+ * split into three CRC32C_LANE streams per chunk so three CRC32CX chains
+ * are in flight at once, then folded with precomputed shift tables.
+ * Without them the same code runs on slicing-by-8 tables.
+ *
+ * crc32c_u64() is the raw 8-byte step (register not inverted) for passes
+ * that checksum data while they produce it: start from ~crc, fold each
+ * 64-bit word as it is stored, return ~r.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_LIB_CRC32C_H_
+#define _PHOTONX_LIB_CRC32C_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+#define CRC32C_LANE                 1024    // Bytes per stream in a 3-way chunk
+
+/* Function Prototypes */
+uint32_t crc32c(uint32_t crc, const void *data, size_t len);
+uint32_t crc32c_copy(uint32_t crc, void *dst, const void *src, size_t len);
+uint32_t crc32c_sw(uint32_t crc, const void *data, size_t len);
+uint32_t crc32c_sw_u64(uint32_t r, uint64_t v);
+
+static inline uint32_t crc32c_u64(uint32_t r, uint64_t v) {
+#if defined(__ARM_FEATURE_CRC32)
+    return __crc32cd(r, v);
+#else
+    return crc32c_sw_u64(r, v);
+#endif
+}
+
+static inline uint32_t crc32c_u8(uint32_t r, uint8_t v) {
+#if defined(__ARM_FEATURE_CRC32)
+    return __crc32cb(r, v);
+#else
+    return crc32c_sw(~r, &v, 1) ^ 0xFFFFFFFFU;
+#endif
+}
+
+#endif /* _PHOTONX_LIB_CRC32C_H_ */
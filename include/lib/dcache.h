@@ -0,0 +1,58 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/lib/dcache.h
+ * Module:      Data Cache Maintenance for Non-Coherent DMA
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * By virtual address to the point of coherency, each followed by DSB SY so
+ * the maintenance is complete before the DMA is started or its data read.
+ * - dcache_clean: before a device reads memory (writes dirty lines back).
+ * - dcache_flush: before a device writes memory (clean + invalidate, so
+ *   nothing dirty is evicted over the incoming data later).
+ * - dcache_inval: after a device wrote memory (drops stale lines).
+ *
+ * clean and flush round the range out to whole lines. inval discards
+ * whole lines without writing them back: 'p' must be line aligned and the
+ * caller must own every line up to p + len rounded up, or CPU stores that
+ * share those lines are lost.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_LIB_DCACHE_H_
+#define _PHOTONX_LIB_DCACHE_H_
+
+#include <stdint.h>
+
+#define DCACHE_LINE             64      // Cortex-A53 L1D/L2
+
+static inline void dcache_clean(const void *p, uint64_t len) {
+    uintptr_t a = (uintptr_t)p & ~(uintptr_t)(DCACHE_LINE - 1);
+
+    for (; a < (uintptr_t)p + len; a += DCACHE_LINE) {
+        asm volatile("dc cvac, %0" :: "r" (a) : "memory");
+    }
+    asm volatile("dsb sy" ::: "memory");
+}
+
+static inline void dcache_flush(void *p, uint64_t len) {
+    uintptr_t a = (uintptr_t)p & ~(uintptr_t)(DCACHE_LINE - 1);
+
+    for (; a < (uintptr_t)p + len; a += DCACHE_LINE) {
+        asm volatile("dc civac, %0" :: "r" (a) : "memory");
+    }
+    asm volatile("dsb sy" ::: "memory");
+}
+
+static inline void dcache_inval(void *p, uint64_t len) {
+    uintptr_t a = (uintptr_t)p;
+
+    for (; a < (uintptr_t)p + len; a += DCACHE_LINE) {
+        asm volatile("dc ivac, %0" :: "r" (a) : "memory");
+    }
+    asm volatile("dsb sy" ::: "memory");
+}
+
+#endif /* _PHOTONX_LIB_DCACHE_H_ */
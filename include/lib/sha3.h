@@ -0,0 +1,38 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/lib/sha3.h
+ * Module:      SHA3-384 (Software)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * FIPS 202 SHA3-384 on the A53 integer pipeline: 64-bit lanes map onto
+ * the AArch64 registers one to one, and the A53 has no SHA3 instructions
+ * (ARMv8.2), so there is no NEON variant. Used where the CSU engine is
+ * not available and as the reference for its model.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_LIB_SHA3_H_
+#define _PHOTONX_LIB_SHA3_H_
+
+#include <stdint.h>
+
+#define SHA3_384_DIGEST_SIZE        48
+#define SHA3_384_BLOCK_SIZE         104     // Rate: 1600 - 2 * 384 bits
+
+typedef struct {
+    uint64_t s[25];
+    uint8_t  buf[SHA3_384_BLOCK_SIZE];
+    uint32_t fill;                  // Bytes waiting in 'buf'
+} sha3_ctx_t;
+
+/* Function Prototypes */
+void sha3_384_init(sha3_ctx_t *ctx);
+void sha3_384_update(sha3_ctx_t *ctx, const void *data, uint64_t len);
+void sha3_384_final(sha3_ctx_t *ctx, uint8_t digest[SHA3_384_DIGEST_SIZE]);
+void sha3_384(const void *data, uint64_t len, uint8_t digest[SHA3_384_DIGEST_SIZE]);
+void keccak_f1600(uint64_t s[25]);
+
+#endif /* _PHOTONX_LIB_SHA3_H_ */
@@ -0,0 +1,68 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/mm/arena.h
+ * Module:      Per-Job Scratch Arenas
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Bump-pointer allocator for temporaries that share one lifetime: the
+ * tiling, quantization and post-processing buffers of a HOCS job or batch.
+ *
+ * Memory comes in 2MB chunks from the page allocator (high window when
+ * installed), so each chunk is one L2 block / one TLB entry. Allocations
+ * are cache-line aligned so neither the CPU nor the coherent AXI port
+ * sees false sharing between buffers. There is no free(): arena_reset()
+ * rewinds to the first chunk in O(1) and keeps the chunks for the next job.
+ *
+ * LIFETIME:
+ * Each job that references the arena holds a reference (taken by
+ * hocs_submit(), dropped after its completion callback). The submitter holds
+ * one too while it is still filling the batch. The arena resets itself when
+ * the last reference goes.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_MM_ARENA_H_
+#define _PHOTONX_MM_ARENA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "mm/pmm.h"
+
+/* =========================================================================
+ * CONFIGURATION
+ * ========================================================================= */
+#define ARENA_CHUNK_SIZE            PMM_HUGE_SIZE
+#define ARENA_MAX_CHUNKS            8       // 16MB per arena
+#define ARENA_ALIGN                 64      // Cache line
+
+typedef struct arena {
+    const char *name;
+    uint64_t chunk[ARENA_MAX_CHUNKS];       // Physical (= virtual) base of each chunk
+    uint32_t nchunks;                       // Chunks owned
+    uint32_t cur;                           // Chunk being bumped
+    uint64_t off;                           // Bump offset within 'cur'
+    volatile uint32_t refs;
+
+    /* Statistics */
+    uint64_t used;                          // Bytes handed out since the last reset
+    uint64_t high_water;
+    uint64_t allocs;
+    uint64_t resets;
+    uint64_t failures;
+} arena_t;
+
+/* Function Prototypes */
+int arena_init(arena_t *a, const char *name, uint32_t prealloc_chunks);
+void *arena_alloc(arena_t *a, size_t size);
+void *arena_alloc_aligned(arena_t *a, size_t size, size_t align);
+void arena_reset(arena_t *a);
+void arena_destroy(arena_t *a);
+void arena_get(arena_t *a);
+void arena_put(arena_t *a);
+void arena_benchmark(void);
+
+#endif /* _PHOTONX_MM_ARENA_H_ */
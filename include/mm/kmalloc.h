@@ -0,0 +1,51 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/mm/kmalloc.h
+ * Module:      General-Purpose Kernel Heap
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * First-fit heap over one contiguous low-DDR range taken from the page
+ * allocator at boot. Blocks carry a size header and a footer (boundary
+ * tags) so kfree() coalesces with both neighbours in O(1). Payloads are
+ * 16-byte aligned.
+ *
+ * For allocations that all die together (per-job scratch) use an arena
+ * (mm/arena.h) instead: no per-block header, no free-list walk, and no
+ * fragmentation left behind.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_MM_KMALLOC_H_
+#define _PHOTONX_MM_KMALLOC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* =========================================================================
+ * CONFIGURATION
+ * ========================================================================= */
+#define KHEAP_DEFAULT_SIZE          (4 * 1024 * 1024)
+#define KHEAP_ALIGN                 16
+
+typedef struct {
+    uint64_t size;                  // Heap bytes (headers included)
+    uint64_t used;                  // Bytes in allocated blocks
+    uint64_t free;
+    uint64_t largest_free;          // Biggest single allocation possible
+    uint32_t free_blocks;
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t failures;
+} kheap_stats_t;
+
+/* Function Prototypes */
+int kheap_init(size_t size);
+void *kmalloc(size_t size);
+void kfree(void *ptr);
+void kheap_get_stats(kheap_stats_t *out);
+
+#endif /* _PHOTONX_MM_KMALLOC_H_ */
@@ -0,0 +1,45 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/mm/mem_detect.h
+ * Module:      DDR Discovery
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Finds the installed DDR and hands it to the page allocator. Sources, in
+ * order of preference:
+ * 1. The flattened device tree passed by the boot loader in x0 (/memory
+ *    node 'reg' property).
+ * 2. The DDR controller's address map (ZYNQMP_DDRC_BASE), if the FSBL has
+ *    programmed it.
+ * 3. The compile-time low window (ZYNQMP_DDR_LOW_SIZE).
+ *
+ * Controller-derived sizes are split across the ZynqMP windows: the first
+ * 2GB at 0x0, the remainder at ZYNQMP_DDR_HIGH_BASE.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_MM_MEM_DETECT_H_
+#define _PHOTONX_MM_MEM_DETECT_H_
+
+#include <stdint.h>
+
+/* FDT Header Magic (big-endian in the blob) */
+#define FDT_MAGIC                   0xD00DFEED
+
+typedef enum {
+    MEM_SRC_DEFAULT = 0,
+    MEM_SRC_DTB,
+    MEM_SRC_DDRC
+} mem_source_t;
+
+/* Boot loader DTB pointer (x0 at _start), saved by startup.S */
+extern uint64_t boot_dtb_addr;
+
+/* Function Prototypes */
+mem_source_t mem_detect(const void *dtb);
+const char *mem_source_name(mem_source_t src);
+
+#endif /* _PHOTONX_MM_MEM_DETECT_H_ */
@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2026 PhotonX Technologies.
+ * File: mmu.h
+ * Description:
+ * C interface of the AArch64 MMU module (mmu_aarch64.c).
+ */
+
+#ifndef _PHOTONX_MM_MMU_H_
+#define _PHOTONX_MM_MMU_H_
+
+#include <stdint.h>
+#include "mm/mmu_defs.h"
+
+/* vmm_map_page() attributes for EL0 mappings (Normal WB memory, Attr Index 1) */
+#define VMM_USER_RW     (PT_ACCESS_FULL | PT_SH_INNER | PT_UXN | PT_PXN | (1 << 2))
+#define VMM_USER_RO     (PT_ACCESS_RO | PT_SH_INNER | PT_UXN | PT_PXN | (1 << 2))
+#define VMM_USER_RX     (PT_ACCESS_RO | PT_SH_INNER | PT_PXN | (1 << 2))
+
+/* Function Prototypes */
+void mmu_init_mair(void);
+void mmu_init_tcr(void);
+void mmu_create_identity_map(void);
+void mmu_map_high_memory(void);
+void mmu_enable(void);
+int vmm_map_page(uint64_t va, uint64_t pa, uint64_t flags);
+void vmm_unmap_page(uint64_t va);
+
+#endif /* _PHOTONX_MM_MMU_H_ */
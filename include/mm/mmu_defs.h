@@ -26,6 +26,10 @@
 #define PT_SH_OUTER             (0x2 << 8)
 #define PT_SH_INNER             (0x3 << 8)
 
+/* Access Flag (must be set, or the first access takes an Access Flag fault) */
+#define PT_AF                   (1 << 10)
+#define PT_ADDR_MASK            0x0000FFFFFFFFF000UL
+
 /* Execute Never (XN Bits) */
 #define PT_UXN                  (1UL << 54) // User Execute Never
 #define PT_PXN                  (1UL << 53) // Privileged Execute Never
@@ -34,6 +38,7 @@
 #define MAIR_ATTR_DEVICE_nGnRnE 0x00
 #define MAIR_ATTR_NORMAL_WB     0xFF
 #define MAIR_ATTR_DEVICE_nGnRE  0x04
+#define MAIR_ATTR_NORMAL_WT     0xBB    // Write-Through, R/W Allocate
 
 /* TCR (Translation Control Register) Flags */
 #define TCR_T0SZ_SHIFT          0
@@ -46,7 +51,7 @@
 
 #define TCR_TG0_4KB             0x0
 #define TCR_TG1_4KB             0x2
-#define TCR_IPS_48BIT           0x5
+#define TCR_IPS_48BIT           0x5UL
 #define TCR_SH_INNER            0x3
 
 /* SCTLR (System Control Register) Flags */
@@ -54,4 +59,11 @@
 #define SCTLR_C_BIT             (1 << 2)  // Data Cache Enable
 #define SCTLR_I_BIT             (1 << 12) // Instruction Cache Enable
 
+/* TCR Table Walk Cacheability (Inner/Outer Write-Back, Write-Allocate) */
+#define TCR_IRGN0_SHIFT         8
+#define TCR_ORGN0_SHIFT         10
+#define TCR_IRGN1_SHIFT         24
+#define TCR_ORGN1_SHIFT         26
+#define TCR_RGN_WBWA            0x1
+
 #endif /* _PHOTONX_MMU_DEFS_H_ */
@@ -0,0 +1,114 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        include/mm/pmm.h
+ * Module:      Physical Memory Manager (Zoned Page Allocator)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * The ZynqMP DDR controller exposes up to 2GB at 0x0 (low window) and the
+ * rest at 0x8_0000_0000 (high window, 32GB+). The allocator keeps one zone
+ * per window:
+ *
+ * PMM_ZONE_LOW:  4KB granules. Kernel, page tables, and buffers for masters
+ *                that can only address 32 bits.
+ * PMM_ZONE_HIGH: 2MB granules. Bulk buffers (HOCS operands/results,
+ *                framebuffers). Only whole gigabytes are registered, and
+ *                each one is identity-mapped with a single 1GB L1 block.
+ *
+ * PAGE COLORING:
+ * The A53 cluster shares a 1MB, 16-way L2 (64B lines, 1024 sets). Physical
+ * address bits [15:12] are both L2 set-index bits and page-frame bits, so
+ * a 4KB page can only ever occupy 1/16 of the L2 sets: its color. Two
+ * allocations with disjoint color sets cannot evict each other from L2.
+ * pmm_alloc_colored() returns contiguous low-zone memory whose pages all
+ * carry allowed colors (a run of n pages starting at color c covers colors
+ * c .. c+n-1 mod 16). pmm_color_claim() hands out disjoint color sets to
+ * tasks; plain pmm_alloc() ignores colors.
+ *
+ * Each zone is a bitmap over its whole window (bit set = not allocatable),
+ * so there is no per-page metadata and memory that is absent, reserved or
+ * in use looks the same. mem_detect() discovers the installed DDR, and
+ * pmm_add_region() / pmm_reserve() register and carve it.
+ * ======================================================================================
+ */
+
+#ifndef _PHOTONX_MM_PMM_H_
+#define _PHOTONX_MM_PMM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* =========================================================================
+ * CONFIGURATION
+ * ========================================================================= */
+#define PMM_PAGE_SHIFT              12
+#define PMM_PAGE_SIZE               (1UL << PMM_PAGE_SHIFT)
+#define PMM_HUGE_SHIFT              21      // 2MB (L2 block)
+#define PMM_HUGE_SIZE               (1UL << PMM_HUGE_SHIFT)
+#define PMM_GIGA_SHIFT              30      // 1GB (L1 block)
+#define PMM_GIGA_SIZE               (1UL << PMM_GIGA_SHIFT)
+
+#define PMM_MAX_REGIONS             8       // Discovered DDR ranges
+
+/* L2 Page Coloring (Cortex-A53 L2: 1MB, 16 ways) */
+#define PMM_L2_SIZE                 (1024 * 1024)
+#define PMM_L2_WAYS                 16
+#define PMM_COLORS                  ((PMM_L2_SIZE / PMM_L2_WAYS) / PMM_PAGE_SIZE)
+#define PMM_COLOR_ALL               0xFFFF
+#define PMM_COLOR_OF(pa)            ((uint32_t)((pa) >> PMM_PAGE_SHIFT) & (PMM_COLORS - 1))
+
+/* Allocation Flags */
+#define PMM_F_LOW                   (1 << 0)    // Must be in the low window (32-bit DMA)
+#define PMM_F_HIGH                  (1 << 1)    // Prefer the high window
+#define PMM_F_ZERO                  (1 << 2)    // Clear before returning
+#define PMM_F_STRICT                (1 << 3)    // With PMM_F_HIGH: no low fallback
+
+typedef enum {
+    PMM_ZONE_LOW = 0,
+    PMM_ZONE_HIGH,
+    PMM_ZONES
+} pmm_zone_id_t;
+
+/*
+ * struct pmm_zone_t
+ * One DDR window. Bit i of 'map' covers [base + i*granule, +granule).
+ */
+typedef struct {
+    const char *name;
+    uint64_t base;                  // Window base (physical)
+    uint64_t span;                  // Window size
+    uint32_t granule_shift;
+    uint64_t *map;
+    uint32_t map_bits;
+
+    uint64_t present;               // Bytes of installed DDR registered
+    uint64_t reserved;              // Bytes carved out at boot
+    uint64_t free;                  // Bytes currently allocatable
+    uint32_t hint;                  // Next-fit start (granule index)
+} pmm_zone_t;
+
+typedef struct {
+    uint64_t base;
+    uint64_t size;
+} pmm_region_t;
+
+/* Function Prototypes */
+void pmm_init(void);
+int pmm_add_region(uint64_t base, uint64_t size);
+void pmm_reserve(uint64_t base, uint64_t size);
+uint64_t pmm_alloc(size_t size, uint32_t flags);
+void pmm_free(uint64_t pa, size_t size);
+uint64_t pmm_alloc_colored(size_t size, uint16_t colors, uint32_t flags);
+int pmm_color_claim(uint16_t colors);
+void pmm_color_release(uint16_t colors);
+uint16_t pmm_colors_free(void);
+pmm_zone_t *pmm_zone(pmm_zone_id_t id);
+uint32_t pmm_regions(const pmm_region_t **out);
+uint64_t pmm_total_present(void);
+void pmm_dump(void);
+void pmm_color_benchmark(void);
+
+#endif /* _PHOTONX_MM_PMM_H_ */
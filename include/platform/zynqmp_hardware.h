@@ -34,6 +34,14 @@
 #define ZYNQMP_DDR_HIGH_BASE       0x800000000UL // High Memory (starts at 32GB)
 #define ZYNQMP_DDR_HIGH_SIZE       0x800000000UL // Up to 32GB Expansion
 
+/* Persistent Block: top 2MB of low DDR. Never cleared, never allocated. */
+#define ZYNQMP_PERSIST_BASE        0x7FE00000UL
+#define ZYNQMP_PERSIST_SIZE        0x00200000UL  // One 2MB block (own MMU attribute)
+#define ZYNQMP_PSTORE_BASE         ZYNQMP_PERSIST_BASE
+#define ZYNQMP_PSTORE_SIZE         0x001F0000UL  // Crash log & trace banks
+#define ZYNQMP_CALSTORE_BASE       0x7FFF0000UL  // Laser calibration record
+#define ZYNQMP_CALSTORE_SIZE       0x00010000UL
+
 /* On-Chip Memory (OCM) - 256KB High-Speed SRAM */
 #define ZYNQMP_OCM_BASE            0xFFFC0000UL
 #define ZYNQMP_OCM_SIZE            0x00040000UL
@@ -74,6 +82,8 @@
 #define ZYNQMP_TTC1_BASE           0xFF120000UL  // Triple Timer Counter 1
 #define ZYNQMP_TTC2_BASE           0xFF130000UL  // Triple Timer Counter 2
 #define ZYNQMP_TTC3_BASE           0xFF140000UL  // Triple Timer Counter 3
+#define ZYNQMP_SD0_BASE            0xFF160000UL  // SD/eMMC Host Controller 0
+#define ZYNQMP_SD1_BASE            0xFF170000UL  // SD/eMMC Host Controller 1
 
 /* System Control Bases */
 #define ZYNQMP_CRL_APB_BASE        0xFF5E0000UL  // Clock Reset LPD
@@ -134,6 +144,16 @@
 #define CRL_APB_RST_LPD_TOP        (ZYNQMP_CRL_APB_BASE + 0x23C)
 #define CRL_APB_RST_LPD_DBG        (ZYNQMP_CRL_APB_BASE + 0x240)
 
+/* Reset Reason (sticky, write-1-to-clear) */
+#define CRL_APB_RESET_REASON       (ZYNQMP_CRL_APB_BASE + 0x220)
+#define RESET_REASON_EXT_POR       (1 << 0)
+#define RESET_REASON_INT_POR       (1 << 1)
+#define RESET_REASON_PMU_SYS       (1 << 2)
+#define RESET_REASON_PSONLY        (1 << 3)
+#define RESET_REASON_SRST          (1 << 4)
+#define RESET_REASON_SOFT          (1 << 5)
+#define RESET_REASON_DEBUG_SYS     (1 << 6)
+
 /* =========================================================================
  * SECTION 4: FULL POWER DOMAIN (FPD) & HIGH SPEED
  * ========================================================================= */
@@ -185,8 +205,8 @@
 /* Optical Matrix Configuration */
 #define HOCS_REG_MATRIX_DIM        (HOCS_AXI_BASE + 0x0010) // Dimension N (NxN)
 #define HOCS_REG_WAVELENGTH        (HOCS_AXI_BASE + 0x0014) // Laser Wavelength (nm)
-#define HOCS_REG_PHASE_SHIFT       (HOCS_AXI_BASE + 0x0018) // Phase Modulator
-#define HOCS_REG_LASER_POWER       (HOCS_AXI_BASE + 0x001C) // Global Laser Power
+#define HOCS_REG_PHASE_SHIFT       (HOCS_AXI_BASE + 0x0018) // Phase Modulator (channel CHAN_SEL)
+#define HOCS_REG_LASER_POWER       (HOCS_AXI_BASE + 0x001C) // Laser Power DAC (channel CHAN_SEL)
 
 /* DMA Pointers (Direct Memory Access) */
 #define HOCS_REG_SRC_ADDR_L        (HOCS_AXI_BASE + 0x0020) // Source Ptr Low
@@ -199,11 +219,32 @@
 #define HOCS_REG_TEMP_SENSOR_2     (HOCS_AXI_BASE + 0x0044) // Zone 2 Temp
 #define HOCS_REG_TEC_CONTROL       (HOCS_AXI_BASE + 0x0048) // Peltier Control
 
+/* Job Descriptor Ring (IP rev 2+) */
+#define HOCS_REG_RING_BASE_L       (HOCS_AXI_BASE + 0x0050) // Descriptor Ring Ptr Low
+#define HOCS_REG_RING_BASE_H       (HOCS_AXI_BASE + 0x0054) // Descriptor Ring Ptr High
+#define HOCS_REG_RING_SIZE         (HOCS_AXI_BASE + 0x0058) // Entries (power of 2)
+#define HOCS_REG_RING_DOORBELL     (HOCS_AXI_BASE + 0x005C) // SW Producer Index
+#define HOCS_REG_RING_COMPLETED    (HOCS_AXI_BASE + 0x0060) // HW Completion Index
+
+/* Per-Channel Calibration Access */
+#define HOCS_REG_CHAN_SEL          (HOCS_AXI_BASE + 0x0064) // VCSEL Channel Select (0-143)
+#define HOCS_REG_CHAN_MONITOR      (HOCS_AXI_BASE + 0x0068) // Monitor Photodiode (uW, RO)
+
+/* Shadow Doorbell (CONTROL.DB_SHADOW) */
+#define HOCS_REG_DB_ADDR_L         (HOCS_AXI_BASE + 0x0070) // Doorbell Page Address (Low)
+#define HOCS_REG_DB_ADDR_H         (HOCS_AXI_BASE + 0x0074) // Doorbell Page Address (High)
+
+/* Payload Checksums (CONTROL.CRC_EN) */
+#define HOCS_REG_CRC_BASE_L        (HOCS_AXI_BASE + 0x0078) // Checksum Table Address (Low)
+#define HOCS_REG_CRC_BASE_H        (HOCS_AXI_BASE + 0x007C) // Checksum Table Address (High)
+
 /* Control Bitmasks */
 #define HOCS_CTRL_START            (1 << 0)  // Start Computation
 #define HOCS_CTRL_RESET            (1 << 1)  // Soft Reset IP
 #define HOCS_CTRL_DMA_EN           (1 << 2)  // Enable DMA Engine
 #define HOCS_CTRL_LASER_EN         (1 << 3)  // Activate Lasers
+#define HOCS_CTRL_DB_SHADOW        (1 << 4)  // Producer index from DB_ADDR memory, not RING_DOORBELL
+#define HOCS_CTRL_CRC_EN           (1 << 5)  // Write payload CRC-32C to CRC_BASE
 
 /* Status Bitmasks */
 #define HOCS_STATUS_IDLE           (1 << 0)
@@ -212,6 +253,18 @@
 #define HOCS_STATUS_ERROR          (1 << 3)
 #define HOCS_STATUS_OVERHEAT       (1 << 4)
 
+/* Interrupt Bitmasks (IRQ_ENABLE / IRQ_STATUS, W1C) */
+#define HOCS_IRQ_DONE              (1 << 0)  // Descriptor(s) completed
+#define HOCS_IRQ_ERROR             (1 << 1)  // Descriptor failed
+#define HOCS_IRQ_THERMAL           (1 << 2)  // Over-temperature
+
+/* PL-to-PS Interrupt Line */
+#define HOCS_IRQ_ID                120
+
+/* Second DMA Port Instance (same register map, masters DDR through HPC1) */
+#define HOCS1_AXI_BASE             ZYNQMP_PL_HPC1_BASE
+#define HOCS1_IRQ_ID               121
+
 /* * struct hocs_device
  * C-Structure for easy driver access
  */
@@ -230,6 +283,13 @@ typedef struct {
     volatile uint32_t dst_addr_h;     // 0x2C
     volatile uint32_t reserved[4];    // 0x30-0x3C (Padding)
     volatile uint32_t temp_sensor[4]; // 0x40-0x4C
+    volatile uint32_t ring_base_l;    // 0x50
+    volatile uint32_t ring_base_h;    // 0x54
+    volatile uint32_t ring_size;      // 0x58
+    volatile uint32_t ring_doorbell;  // 0x5C
+    volatile uint32_t ring_completed; // 0x60
+    volatile uint32_t chan_sel;       // 0x64
+    volatile uint32_t chan_monitor;   // 0x68
 } hocs_hw_t;
 
 #endif /* _PHOTONX_ZYNQMP_HARDWARE_H_ */
@@ -0,0 +1,337 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        csu_model.c
+ * Module:      CSU Crypto Behavioral Model Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Register semantics mirror the CSU:
+ * - Writing a channel's SIZE starts the transfer; bit 0 of the source
+ *   size (LAST_WORD) ends the message. I_STS is write-1-to-clear.
+ * - SSS_CFG picks the engine: SHA3 when its source nibble is DMA,
+ *   otherwise AES when the AES source is DMA.
+ * - SHA3 absorbs whole 104-byte blocks, padding included; DONE and the
+ *   digest registers are valid after the LAST_WORD transfer.
+ * - AES-GCM runs on the whole message at LAST_WORD: encryption writes
+ *   data plus tag, decryption takes the tag from the end of the source
+ *   and reports TAG_PASS.
+ * - KUP, key and IV registers read as zero.
+ * ======================================================================================
+ */
+
+#include "drivers/csu_model.h"
+
+#define AES_REG(m, off)         ((m)->aes_regs[((off) - CSU_AES_STATUS_OFFSET) >> 2])
+#define SHA_REG(m, off)         ((m)->sha_regs[((off) - CSU_SHA_START_OFFSET) >> 2])
+#define DMA_REG(m, ch, off)     ((m)->dma_regs[ch][(off) >> 2])
+
+#define CH_SRC                  0
+#define CH_DST                  1
+
+/*
+ * csu_model_init
+ * Powers the model up idle with keys zeroed and default timing.
+ */
+void csu_model_init(csu_model_t *m, uint64_t (*clock_ns)(void)) {
+    m->sss_cfg = 0;
+    for (int i = 0; i < CSU_MODEL_AES_REG_WORDS; i++) {
+        m->aes_regs[i] = 0;
+    }
+    for (int i = 0; i < CSU_MODEL_SHA_REG_WORDS; i++) {
+        m->sha_regs[i] = 0;
+    }
+    for (int ch = 0; ch < 2; ch++) {
+        for (int i = 0; i < CSU_MODEL_DMA_REG_WORDS; i++) {
+            m->dma_regs[ch][i] = 0;
+        }
+    }
+    AES_REG(m, CSU_AES_STATUS_OFFSET) = CSU_AES_STS_KEY_ZEROED | CSU_AES_STS_KUP_ZEROED;
+
+    m->setup_ns = CSU_MODEL_SETUP_NS;
+    m->sha_bytes_per_us = CSU_MODEL_SHA_BYTES_PER_US;
+    m->aes_bytes_per_us = CSU_MODEL_AES_BYTES_PER_US;
+    m->functional = 1;
+
+    m->busy = 0;
+    m->key_loaded = 0;
+    m->busy_until_ns = 0;
+    sha3_384_init(&m->sha);
+    m->clock_ns = clock_ns;
+
+    m->xfers = 0;
+    m->busy_ns = 0;
+    m->sha_bytes = 0;
+    m->aes_bytes = 0;
+}
+
+/*
+ * ======================================================================================
+ * ENGINES
+ * ======================================================================================
+ */
+
+static inline int model_route_sha(const csu_model_t *m) {
+    return ((m->sss_cfg >> CSU_SSS_SHA_SHIFT) & 0xF) == CSU_SSS_SRC_DMA;
+}
+
+static inline int model_route_aes(const csu_model_t *m) {
+    return ((m->sss_cfg >> CSU_SSS_AES_SHIFT) & 0xF) == CSU_SSS_SRC_DMA;
+}
+
+static uint64_t model_dma_addr(const csu_model_t *m, int ch) {
+    return ((uint64_t)DMA_REG(m, ch, CSU_DMA_ADDR_MSB_OFFSET) << 32) |
+           DMA_REG(m, ch, CSU_DMA_ADDR_OFFSET);
+}
+
+static void model_load_key(csu_model_t *m) {
+    uint8_t key[AES_GCM_KEY_SIZE];
+
+    for (uint32_t i = 0; i < 8; i++) {
+        uint32_t w = AES_REG(m, CSU_AES_KUP_OFFSET(i));
+        key[4 * i] = (uint8_t)(w >> 24);
+        key[4 * i + 1] = (uint8_t)(w >> 16);
+        key[4 * i + 2] = (uint8_t)(w >> 8);
+        key[4 * i + 3] = (uint8_t)w;
+    }
+    if (m->functional) {
+        aes_gcm_init(&m->aes, key, 0);
+    }
+    for (uint32_t i = 0; i < AES_GCM_KEY_SIZE; i++) {
+        key[i] = 0;
+    }
+    m->key_loaded = 1;
+}
+
+static void model_clear_key(csu_model_t *m) {
+    volatile uint8_t *p = (volatile uint8_t *)&m->aes;
+
+    for (uint32_t i = 0; i < 8; i++) {
+        AES_REG(m, CSU_AES_KUP_OFFSET(i)) = 0;
+    }
+    for (uint32_t i = 0; i < sizeof(m->aes); i++) {
+        p[i] = 0;
+    }
+    m->key_loaded = 0;
+    AES_REG(m, CSU_AES_STATUS_OFFSET) &= ~CSU_AES_STS_KEY_INIT_DONE;
+    AES_REG(m, CSU_AES_STATUS_OFFSET) |= CSU_AES_STS_KEY_ZEROED | CSU_AES_STS_KUP_ZEROED;
+}
+
+static void model_sha_done(csu_model_t *m) {
+    for (uint32_t k = 0; k < 12; k++) {
+        uint32_t w = 0;
+
+        if (m->functional) {
+            for (uint32_t b = 0; b < 4; b++) {
+                uint32_t i = 4 * k + b;
+                w = (w << 8) | (uint8_t)(m->sha.s[i / 8] >> (8 * (i % 8)));
+            }
+        }
+        SHA_REG(m, CSU_SHA_DIGEST_OFFSET(11 - k)) = w;
+    }
+    SHA_REG(m, CSU_SHA_DONE_OFFSET) = 1;
+}
+
+static void model_aes_run(csu_model_t *m, const uint8_t *src, uint64_t size) {
+    uint8_t *dst = (uint8_t *)(uintptr_t)model_dma_addr(m, CH_DST);
+    int encrypt = AES_REG(m, CSU_AES_CFG_OFFSET) & CSU_AES_CFG_ENCRYPT;
+    uint32_t sts = CSU_AES_STS_DONE | CSU_AES_STS_READY;
+    uint8_t iv[AES_GCM_IV_SIZE];
+
+    for (uint32_t i = 0; i < 3; i++) {
+        uint32_t w = AES_REG(m, CSU_AES_IV_OFFSET(i));
+        iv[4 * i] = (uint8_t)(w >> 24);
+        iv[4 * i + 1] = (uint8_t)(w >> 16);
+        iv[4 * i + 2] = (uint8_t)(w >> 8);
+        iv[4 * i + 3] = (uint8_t)w;
+    }
+
+    if (!m->key_loaded) {
+        sts = CSU_AES_STS_DONE;                 // No key: nothing passes
+    } else if (encrypt) {
+        if (m->functional) {
+            aes_gcm_encrypt(&m->aes, iv, src, dst, size, dst + size);
+        }
+    } else if (size >= CSU_AES_TAG_SIZE) {
+        size -= CSU_AES_TAG_SIZE;
+        if (!m->functional || aes_gcm_decrypt(&m->aes, iv, src, dst, size, src + size) == 0) {
+            sts |= CSU_AES_STS_TAG_PASS;
+        }
+    }
+
+    AES_REG(m, CSU_AES_STATUS_OFFSET) = (AES_REG(m, CSU_AES_STATUS_OFFSET) &
+                                         (CSU_AES_STS_KEY_INIT_DONE | CSU_AES_STS_KEY_ZEROED |
+                                          CSU_AES_STS_KUP_ZEROED)) | sts;
+    DMA_REG(m, CH_DST, CSU_DMA_I_STS_OFFSET) |= CSU_DMA_I_DONE;
+    DMA_REG(m, CH_DST, CSU_DMA_SIZE_OFFSET) = 0;
+}
+
+static void model_complete(csu_model_t *m) {
+    uint32_t size_reg = DMA_REG(m, CH_SRC, CSU_DMA_SIZE_OFFSET);
+    uint64_t size = size_reg & ~3U;
+    int last = size_reg & CSU_DMA_SIZE_LAST_WORD;
+    const uint8_t *src = (const uint8_t *)(uintptr_t)model_dma_addr(m, CH_SRC);
+
+    if (model_route_sha(m)) {
+        if (m->functional) {
+            sha3_384_update(&m->sha, src, size);
+        }
+        m->sha_bytes += size;
+        if (last) {
+            model_sha_done(m);
+        }
+    } else if (model_route_aes(m)) {
+        m->aes_bytes += size;
+        if (last) {
+            model_aes_run(m, src, size);
+        }
+    }
+
+    m->xfers++;
+    DMA_REG(m, CH_SRC, CSU_DMA_I_STS_OFFSET) |= CSU_DMA_I_DONE;
+}
+
+/*
+ * csu_model_advance
+ * Completes the source transfer once the clock has passed its end.
+ */
+void csu_model_advance(csu_model_t *m) {
+    if (m->busy && m->clock_ns() >= m->busy_until_ns) {
+        m->busy = 0;
+        model_complete(m);
+    }
+}
+
+static void model_start_src(csu_model_t *m, uint32_t size_reg) {
+    uint64_t now = m->clock_ns();
+    uint64_t bytes = size_reg & ~3U;
+    uint32_t rate = model_route_sha(m) ? m->sha_bytes_per_us : m->aes_bytes_per_us;
+    uint64_t xfer_ns = m->setup_ns + (bytes * 1000) / rate;
+
+    DMA_REG(m, CH_SRC, CSU_DMA_SIZE_OFFSET) = size_reg;
+    m->busy = 1;
+    m->busy_until_ns = ((m->busy_until_ns > now) ? m->busy_until_ns : now) + xfer_ns;
+    m->busy_ns += xfer_ns;
+}
+
+/*
+ * ======================================================================================
+ * MMIO INTERFACE
+ * ======================================================================================
+ */
+
+uint32_t csu_model_read(csu_model_t *m, uint32_t offset) {
+    csu_model_advance(m);
+
+    if (offset == CSU_SSS_CFG_OFFSET) {
+        return m->sss_cfg;
+    }
+    if (offset == CSU_AES_STATUS_OFFSET) {
+        uint32_t sts = AES_REG(m, offset);
+        if (m->busy && model_route_aes(m)) sts |= CSU_AES_STS_BUSY;
+        return sts;
+    }
+    if (offset == CSU_AES_CFG_OFFSET || offset == CSU_AES_KEY_SRC_OFFSET) {
+        return AES_REG(m, offset);
+    }
+    if (offset >= CSU_SHA_DONE_OFFSET && offset <= CSU_SHA_DIGEST_OFFSET(11)) {
+        return SHA_REG(m, offset);
+    }
+    return 0;
+}
+
+void csu_model_write(csu_model_t *m, uint32_t offset, uint32_t val) {
+    csu_model_advance(m);
+
+    if (offset == CSU_SSS_CFG_OFFSET) {
+        m->sss_cfg = val;
+        return;
+    }
+
+    switch (offset) {
+        case CSU_AES_RESET_OFFSET:
+            if (val & 1) {
+                AES_REG(m, CSU_AES_STATUS_OFFSET) &= CSU_AES_STS_KEY_INIT_DONE |
+                                                     CSU_AES_STS_KEY_ZEROED | CSU_AES_STS_KUP_ZEROED;
+            }
+            break;
+        case CSU_AES_KEY_LOAD_OFFSET:
+            if (val & 1) {
+                model_load_key(m);
+                AES_REG(m, CSU_AES_STATUS_OFFSET) |= CSU_AES_STS_KEY_INIT_DONE;
+                AES_REG(m, CSU_AES_STATUS_OFFSET) &= ~(CSU_AES_STS_KEY_ZEROED | CSU_AES_STS_KUP_ZEROED);
+            }
+            break;
+        case CSU_AES_KEY_CLEAR_OFFSET:
+            if (val) {
+                model_clear_key(m);
+            }
+            break;
+        case CSU_AES_START_MSG_OFFSET:
+            if (val & 1) {
+                AES_REG(m, CSU_AES_STATUS_OFFSET) &= ~(CSU_AES_STS_DONE | CSU_AES_STS_TAG_PASS);
+                AES_REG(m, CSU_AES_STATUS_OFFSET) |= CSU_AES_STS_READY;
+            }
+            break;
+        case CSU_SHA_RESET_OFFSET:
+        case CSU_SHA_START_OFFSET:
+            if (val & 1) {
+                sha3_384_init(&m->sha);
+                SHA_REG(m, CSU_SHA_DONE_OFFSET) = 0;
+            }
+            break;
+        default:
+            if (offset >= CSU_AES_KEY_SRC_OFFSET && offset <= CSU_AES_IV_OFFSET(3)) {
+                AES_REG(m, offset) = val;
+            }
+            break;
+    }
+}
+
+uint32_t csu_model_dma_read(csu_model_t *m, uint32_t offset) {
+    int ch = (offset & CSU_DMA_DST) ? CH_DST : CH_SRC;
+    uint32_t reg = offset & (CSU_DMA_DST - 1);
+
+    csu_model_advance(m);
+
+    if (reg >= CSU_MODEL_DMA_REG_WORDS * 4) {
+        return 0;
+    }
+    if (reg == CSU_DMA_STS_OFFSET) {
+        int busy = (ch == CH_SRC) ? m->busy : (DMA_REG(m, CH_DST, CSU_DMA_SIZE_OFFSET) != 0);
+        return busy ? CSU_DMA_STS_BUSY : 0;
+    }
+    return DMA_REG(m, ch, reg);
+}
+
+void csu_model_dma_write(csu_model_t *m, uint32_t offset, uint32_t val) {
+    int ch = (offset & CSU_DMA_DST) ? CH_DST : CH_SRC;
+    uint32_t reg = offset & (CSU_DMA_DST - 1);
+
+    csu_model_advance(m);
+
+    if (reg >= CSU_MODEL_DMA_REG_WORDS * 4) {
+        return;
+    }
+
+    switch (reg) {
+        case CSU_DMA_I_STS_OFFSET:
+            DMA_REG(m, ch, reg) &= ~val;
+            break;
+        case CSU_DMA_SIZE_OFFSET:
+            if (ch == CH_SRC) {
+                if (!m->busy) {
+                    model_start_src(m, val);    // One transfer at a time per channel
+                }
+            } else {
+                DMA_REG(m, ch, reg) = val & ~3U;
+            }
+            break;
+        case CSU_DMA_STS_OFFSET:
+            break;
+        default:
+            DMA_REG(m, ch, reg) = val;
+            break;
+    }
+}
@@ -0,0 +1,767 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs.c
+ * Module:      HOCS Optical Accelerator Driver Implementation
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Descriptor-ring driver for the HOCS IP. Submission is lock-free for a
+ * single producer; completion reaping can run from the IRQ handler, from a
+ * moderation poll tick or from hocs_wait() with interrupts disabled.
+ *
+ * AXI HPC0/HPC1 are cache-coherent ports, so descriptor handoff only needs
+ * store ordering (DSB) before the doorbell write, no cache maintenance.
+ * ======================================================================================
+ */
+
+#include "drivers/hocs.h"
+#include "drivers/hocs_model.h"
+#include "drivers/hocs_telemetry.h"
+#include "drivers/hocs_lincal.h"
+#include "drivers/hocs_record.h"
+#include "kernel/timer_heavy.h"
+#include "kernel/trace.h"
+#include "mm/pmm.h"
+#include "mm/arena.h"
+#include "lib/crc32c.h"
+#include "lib/kprintf.h"
+
+#define HOCS_MAX_INSTANCES      2
+
+/*
+ * Instances
+ * Both ports reach the same DDR controller through the CCI. Homing their
+ * buffers in different DDR windows keeps the two streams off each other's
+ * DDR pages; on boards without high memory both fall back to low DDR.
+ */
+hocs_device_t hocs0 = {
+    .name      = "hocs0",
+    .base      = HOCS_AXI_BASE,
+    .irq_num   = HOCS_IRQ_ID,
+    .buf_flags = PMM_F_HIGH
+};
+
+hocs_device_t hocs1 = {
+    .name      = "hocs1",
+    .base      = HOCS1_AXI_BASE,
+    .irq_num   = HOCS1_IRQ_ID,
+    .buf_flags = PMM_F_LOW
+};
+
+/* Descriptor Ring Storage (one ring per instance, 4KB aligned) */
+static hocs_desc_t ring_pool[HOCS_MAX_INSTANCES][HOCS_RING_ENTRIES] __attribute__((aligned(4096)));
+static uint32_t ring_pool_used = 0;
+
+/*
+ * ======================================================================================
+ * INITIALIZATION
+ * ======================================================================================
+ */
+
+/*
+ * hocs_init
+ * Resets the IP, programs the descriptor ring and enables completion IRQs.
+ * 'model' selects the behavioral model instead of the PL register block.
+ * The caller is responsible for hooking irq_num into the GIC dispatcher.
+ */
+int hocs_init(hocs_device_t *dev, uintptr_t base, uint32_t irq, hocs_model_t *model) {
+    if (dev->ring == NULL) {
+        if (ring_pool_used >= HOCS_MAX_INSTANCES) {
+            return HOCS_ERR_INVALID;
+        }
+        dev->ring = ring_pool[ring_pool_used++];
+    }
+
+    dev->base = base;
+    dev->irq_num = irq;
+    dev->model = model;
+    dev->prod = 0;
+    dev->cons = 0;
+
+    for (uint32_t i = 0; i < HOCS_RING_ENTRIES; i++) {
+        dev->ring[i].status = HOCS_DESC_PENDING;
+        dev->shadow[i] = NULL;
+    }
+
+    /* The reset below empties the URAM weight slots */
+    for (uint32_t i = 0; i < HOCS_WEIGHT_SLOTS; i++) {
+        dev->wslot[i].valid = 0;
+        dev->wslot[i].inflight = 0;
+    }
+
+    /* 1. Soft reset the IP */
+    hocs_wr(dev, HOCS_CONTROL_OFFSET, HOCS_CTRL_RESET);
+    hocs_wr(dev, HOCS_CONTROL_OFFSET, 0);
+
+    /* 2. Program descriptor ring */
+    uint64_t ring_pa = (uint64_t)(uintptr_t)dev->ring;
+    hocs_wr(dev, HOCS_RING_BASE_L_OFFSET, (uint32_t)ring_pa);
+    hocs_wr(dev, HOCS_RING_BASE_H_OFFSET, (uint32_t)(ring_pa >> 32));
+    hocs_wr(dev, HOCS_RING_SIZE_OFFSET, HOCS_RING_ENTRIES);
+    hocs_wr(dev, HOCS_RING_DOORBELL_OFFSET, 0);
+    hocs_wr(dev, HOCS_CRC_BASE_L_OFFSET, (uint32_t)(uintptr_t)dev->crc);
+    hocs_wr(dev, HOCS_CRC_BASE_H_OFFSET, (uint32_t)((uint64_t)(uintptr_t)dev->crc >> 32));
+
+    /* 3. Clear stale interrupts, enable completion/error */
+    hocs_wr(dev, HOCS_IRQ_STATUS_OFFSET, 0xFFFFFFFF);
+    hocs_wr(dev, HOCS_IRQ_ENABLE_OFFSET, HOCS_IRQ_DONE | HOCS_IRQ_ERROR);
+
+    /* 4. Start DMA engine and lasers (payload checksums survive a re-init) */
+    hocs_wr(dev, HOCS_CONTROL_OFFSET, HOCS_CTRL_DMA_EN | HOCS_CTRL_LASER_EN |
+                                      (dev->verify ? HOCS_CTRL_CRC_EN : 0));
+
+    return HOCS_OK;
+}
+
+/*
+ * ======================================================================================
+ * SUBMISSION & COMPLETION
+ * ======================================================================================
+ */
+
+/*
+ * weights_slot
+ * Slot behind a handle, or NULL if it has been reloaded since.
+ */
+static hocs_weight_slot_t *weights_slot(hocs_device_t *dev, uint32_t handle) {
+    uint32_t idx = (handle & 0xFF) - 1;
+
+    if (handle == 0 || idx >= HOCS_WEIGHT_SLOTS) {
+        return NULL;
+    }
+    if (!dev->wslot[idx].valid || dev->wslot[idx].gen != (handle >> 8)) {
+        return NULL;
+    }
+    return &dev->wslot[idx];
+}
+
+/*
+ * hocs_queue
+ * Fills the next descriptor with 'flags' and rings the doorbell.
+ */
+static int hocs_queue(hocs_device_t *dev, hocs_job_t *job, uint32_t flags) {
+    if (dev->user || (dev->prod - dev->cons) >= HOCS_RING_ENTRIES) {
+        return HOCS_ERR_BUSY;
+    }
+
+    uint32_t slot = dev->prod & (HOCS_RING_ENTRIES - 1);
+    hocs_desc_t *d = &dev->ring[slot];
+
+    /* 1. Source checksum, unless the pass that produced it already has one */
+    job->verified = HOCS_VERIFY_OFF;
+    if (dev->verify && !(job->flags & HOCS_JOB_F_SRC_CRC)) {
+        uint64_t in_bytes, out_bytes;
+        hocs_desc_bytes(flags, job->matrix_dim, &in_bytes, &out_bytes);
+        job->src_crc = crc32c(0, (const void *)(uintptr_t)job->src_addr, in_bytes);
+    }
+
+    /* 2. Fill descriptor */
+    d->src_addr = job->src_addr;
+    d->dst_addr = job->dst_addr;
+    d->matrix_dim = job->matrix_dim;
+    d->flags = flags;
+    d->status = HOCS_DESC_PENDING;
+    d->tag = dev->prod;
+    if (dev->telem) {
+        hocs_telemetry_submit(dev, d);
+    }
+
+    job->tag = dev->prod;
+    job->state = HOCS_JOB_QUEUED;
+    if (job->scratch) {
+        arena_get(job->scratch);
+    }
+    if (job->weights) {
+        __atomic_fetch_add(&dev->wslot[(job->weights & 0xFF) - 1].inflight, 1, __ATOMIC_RELAXED);
+    }
+    trace_emit(TRACE_EV_HOCS_SUBMIT, dev->prod, job->matrix_dim, 0);
+    dev->shadow[slot] = job;
+    dev->prod++;
+    dev->submitted++;
+
+    /* 3. Descriptor must be visible before the IP sees the new index */
+    asm volatile("dsb st" ::: "memory");
+    hocs_wr(dev, HOCS_RING_DOORBELL_OFFSET, dev->prod);
+
+    return HOCS_OK;
+}
+
+/*
+ * hocs_submit
+ * Queues a job on the descriptor ring and rings the doorbell.
+ * Returns HOCS_ERR_BUSY if the ring is full (caller should reap and retry)
+ * or granted to a task,
+ * HOCS_ERR_EVICTED if job->weights has been pushed out of the cache
+ * (register the matrix again).
+ */
+int hocs_submit(hocs_device_t *dev, hocs_job_t *job) {
+    uint32_t flags;
+    int rc;
+
+    if (job == NULL || (job->flags & HOCS_DESC_F_DRIVER_MASK) ||
+        HOCS_DESC_IN_FMT(job->flags) > HOCS_FMT_INT8) {
+        return HOCS_ERR_INVALID;
+    }
+    flags = job->flags & ~HOCS_JOB_F_SW_MASK;
+
+    if (job->weights) {
+        hocs_weight_slot_t *w = weights_slot(dev, job->weights);
+        if (w == NULL) {
+            return HOCS_ERR_EVICTED;
+        }
+        if (job->rows > w->dim) {
+            return HOCS_ERR_INVALID;
+        }
+        job->matrix_dim = w->dim;
+        w->last_use = ++dev->wclock;
+        flags |= HOCS_DESC_F_RESIDENT | HOCS_DESC_F_SLOT(w - dev->wslot) |
+                 HOCS_DESC_F_ROWS(job->rows);
+    }
+
+    if (job->matrix_dim == 0 || job->matrix_dim > HOCS_MAX_DIM) {
+        return HOCS_ERR_INVALID;
+    }
+
+    rc = hocs_queue(dev, job, flags);
+    if (rc == HOCS_OK && dev->rec) {
+        hocs_record_submit(dev, job, flags);
+    }
+    return rc;
+}
+
+/*
+ * hocs_verify
+ * Checks a completed descriptor's payload checksums against the job.
+ * Returns the status to complete it with.
+ */
+static uint32_t hocs_verify(hocs_device_t *dev, hocs_job_t *job, uint32_t slot) {
+    const hocs_crc_t *crc = &dev->crc[slot];
+    uint64_t in_bytes, out_bytes;
+
+    if (crc->src != job->src_crc) {
+        kprintf("[HOCS] ERR: %s job %u input checksum %x, expected %x\n",
+                dev->name, job->tag, crc->src, job->src_crc);
+        dev->crc_errors++;
+        return HOCS_DESC_ERROR;
+    }
+    job->verified = HOCS_VERIFY_INPUT;
+    if (dev->verify < HOCS_VERIFY_FULL) {
+        return HOCS_DESC_DONE;
+    }
+
+    job->dst_crc = crc->dst;
+    hocs_desc_bytes(dev->ring[slot].flags, dev->ring[slot].matrix_dim, &in_bytes, &out_bytes);
+    if (out_bytes && (job->flags & HOCS_JOB_F_DST_DEFER) && dev->lincal == NULL) {
+        job->verified = HOCS_VERIFY_PENDING;
+        return HOCS_DESC_DONE;
+    }
+    if (out_bytes && crc32c(0, (const void *)(uintptr_t)job->dst_addr, out_bytes) != crc->dst) {
+        kprintf("[HOCS] ERR: %s job %u result checksum mismatch\n", dev->name, job->tag);
+        dev->crc_errors++;
+        return HOCS_DESC_ERROR;
+    }
+    job->verified = HOCS_VERIFY_FULL;
+    return HOCS_DESC_DONE;
+}
+
+/*
+ * hocs_poll
+ * Reaps up to 'budget' completed descriptors. Returns the number reaped.
+ */
+uint32_t hocs_poll(hocs_device_t *dev, uint32_t budget) {
+    uint32_t hw_done, n = 0;
+
+    if (dev->user) {
+        return 0;                   // The task reaps its own ring
+    }
+    hw_done = hocs_rd(dev, HOCS_RING_COMPLETED_OFFSET);
+
+    while (dev->cons != hw_done && n < budget) {
+        uint32_t slot = dev->cons & (HOCS_RING_ENTRIES - 1);
+        hocs_job_t *job = dev->shadow[slot];
+        uint32_t status = dev->ring[slot].status;
+        struct arena *scratch;
+        uint32_t weights;
+
+        trace_emit(TRACE_EV_HOCS_DONE, dev->cons, status, 0);
+        dev->shadow[slot] = NULL;
+        dev->cons++;
+        dev->completed++;
+        n++;
+
+        if (job == NULL) {
+            continue;
+        }
+
+        /* Before anything touches the result */
+        if (dev->verify && status == HOCS_DESC_DONE) {
+            status = hocs_verify(dev, job, slot);
+        }
+        if (dev->telem) {
+            hocs_telemetry_complete(dev, &dev->ring[slot]);
+        }
+        if (dev->lincal) {
+            hocs_lincal_complete(dev, &dev->ring[slot]);
+        }
+        if (status == HOCS_DESC_DONE) {
+            job->state = HOCS_JOB_DONE;
+        } else {
+            job->state = HOCS_JOB_ERROR;
+            dev->errors++;
+        }
+
+        /* A failed load leaves the slot undefined */
+        weights = job->weights;
+        if (weights && status != HOCS_DESC_DONE &&
+            (dev->ring[slot].flags & HOCS_DESC_F_LOAD_W)) {
+            dev->wslot[(weights & 0xFF) - 1].valid = 0;
+        }
+
+        /* The callback may reuse 'job'; its references are dropped afterwards */
+        scratch = job->scratch;
+        if (job->done) {
+            job->done(job, job->ctx);
+        }
+        if (scratch) {
+            arena_put(scratch);
+        }
+        if (weights) {
+            __atomic_fetch_sub(&dev->wslot[(weights & 0xFF) - 1].inflight, 1, __ATOMIC_RELEASE);
+        }
+    }
+
+    return n;
+}
+
+/*
+ * hocs_wait
+ * Spins until 'job' completes, reaping completions along the way.
+ * Usable with interrupts masked (early boot, calibration).
+ */
+int hocs_wait(hocs_device_t *dev, hocs_job_t *job, uint64_t timeout_us) {
+    uint64_t start = timer_get_ticks();
+
+    while (job->state == HOCS_JOB_QUEUED) {
+        hocs_poll(dev, HOCS_RING_ENTRIES);
+
+        if (timeout_us && timer_ticks_to_us(timer_get_ticks() - start) > timeout_us) {
+            return HOCS_ERR_TIMEOUT;
+        }
+    }
+
+    return (job->state == HOCS_JOB_DONE) ? HOCS_OK : HOCS_ERR_HW;
+}
+
+/*
+ * ======================================================================================
+ * INTERRUPT HANDLING
+ * ======================================================================================
+ * The device-level IRQ_ENABLE register is used for masking so the GIC line
+ * stays configured; this is what the moderation layer toggles.
+ */
+
+void hocs_irq_mask(void *arg) {
+    hocs_device_t *dev = (hocs_device_t *)arg;
+    hocs_wr(dev, HOCS_IRQ_ENABLE_OFFSET, 0);
+}
+
+void hocs_irq_unmask(void *arg) {
+    hocs_device_t *dev = (hocs_device_t *)arg;
+    if (dev->user) {
+        return;                     // Only SYS_HOCS_WAIT enables a granted ring's IRQ
+    }
+    hocs_wr(dev, HOCS_IRQ_ENABLE_OFFSET, HOCS_IRQ_DONE | HOCS_IRQ_ERROR);
+}
+
+/*
+ * hocs_irq_poll
+ * Acknowledge + reap. Ack happens first so a completion landing during the
+ * reap re-asserts the line instead of being lost. A ring granted to a task
+ * is only acknowledged and masked: the interrupt just woke its consumer.
+ */
+uint32_t hocs_irq_poll(void *arg, uint32_t budget) {
+    hocs_device_t *dev = (hocs_device_t *)arg;
+    uint32_t pending = hocs_rd(dev, HOCS_IRQ_STATUS_OFFSET);
+    uint32_t n;
+
+    if (pending) {
+        hocs_wr(dev, HOCS_IRQ_STATUS_OFFSET, pending);
+    }
+    if (dev->user) {
+        hocs_wr(dev, HOCS_IRQ_ENABLE_OFFSET, 0);
+        return 0;
+    }
+
+    if (dev->telem) {
+        hocs_telemetry_irq(dev);
+    }
+    n = hocs_poll(dev, budget);
+    if (dev->telem) {
+        dev->telem->irq_ns = 0;
+    }
+    return n;
+}
+
+/*
+ * hocs_irq_handler
+ * Plain per-event handler for use without the moderation layer.
+ */
+void hocs_irq_handler(uint32_t irq_id, void *arg) {
+    hocs_device_t *dev = (hocs_device_t *)arg;
+    (void)irq_id;
+
+    dev->irqs++;
+    hocs_irq_poll(dev, HOCS_RING_ENTRIES);
+}
+
+/*
+ * ======================================================================================
+ * BUFFERS
+ * ======================================================================================
+ */
+
+/*
+ * hocs_buf_alloc
+ * Operand/result memory for the IP. Comes from the high DDR window (1GB
+ * mapped, 64-bit AXI addresses) so bulk matrices stay out of the low 2GB
+ * the kernel and 32-bit DMA masters need; falls back to low DDR on boards
+ * without high memory.
+ */
+void *hocs_buf_alloc(size_t size) {
+    return (void *)(uintptr_t)pmm_alloc(size, PMM_F_HIGH);
+}
+
+/*
+ * hocs_buf_alloc_on
+ * Buffer homed on 'dev''s port (see hocs_stripe_submit()).
+ */
+void *hocs_buf_alloc_on(hocs_device_t *dev, size_t size) {
+    return (void *)(uintptr_t)pmm_alloc(size, dev->buf_flags ? dev->buf_flags : PMM_F_HIGH);
+}
+
+void hocs_buf_free(void *buf, size_t size) {
+    if (buf) {
+        pmm_free((uint64_t)(uintptr_t)buf, size);
+    }
+}
+
+/*
+ * hocs_job_scratch
+ * Cache-line aligned temporary for 'job' from its arena. Valid until the
+ * job's completion callback returns (or the batch's last one, when the
+ * arena is shared). NULL without an arena or when it is exhausted.
+ */
+void *hocs_job_scratch(hocs_job_t *job, size_t size) {
+    if (job->scratch == NULL) {
+        return NULL;
+    }
+    return arena_alloc(job->scratch, size);
+}
+
+/*
+ * ======================================================================================
+ * PAYLOAD VERIFICATION
+ * ======================================================================================
+ */
+
+/*
+ * hocs_desc_bytes
+ * DMA traffic of a descriptor with 'flags' in each direction: what the
+ * IP's input and output checksums cover.
+ */
+void hocs_desc_bytes(uint32_t flags, uint32_t dim, uint64_t *in_bytes, uint64_t *out_bytes) {
+    uint64_t n = dim;
+    uint64_t rows = HOCS_DESC_ROWS(flags) ? HOCS_DESC_ROWS(flags) : n;
+    uint32_t fmt = HOCS_DESC_IN_FMT(flags);
+    uint64_t in_elem = (fmt == HOCS_FMT_INT8) ? 1 : (fmt == HOCS_FMT_FP16) ? 2 : 4;
+    uint64_t out_elem = (flags & HOCS_DESC_F_OUT_FP16) ? 2 : 4;
+
+    if (flags & HOCS_DESC_F_LOAD_W) {
+        *in_bytes = n * n * sizeof(float);
+        *out_bytes = 0;
+    } else if (flags & HOCS_DESC_F_RESIDENT) {
+        *in_bytes = rows * n * in_elem;
+        *out_bytes = rows * n * out_elem;
+    } else {
+        *in_bytes = 2 * n * n * in_elem;
+        *out_bytes = n * n * out_elem;
+    }
+}
+
+/*
+ * hocs_set_verify
+ * Selects the payload check (HOCS_VERIFY_*) applied to jobs completed
+ * from now on. Only while the ring is empty, so every queued job has its
+ * source checksum. Returns HOCS_ERR_BUSY otherwise.
+ */
+int hocs_set_verify(hocs_device_t *dev, uint32_t mode) {
+    uint32_t ctrl;
+
+    if (mode > HOCS_VERIFY_FULL) {
+        return HOCS_ERR_INVALID;
+    }
+    if (dev->user || dev->prod != dev->cons) {
+        return HOCS_ERR_BUSY;
+    }
+
+    ctrl = hocs_rd(dev, HOCS_CONTROL_OFFSET);
+    hocs_wr(dev, HOCS_CONTROL_OFFSET, mode ? (ctrl | HOCS_CTRL_CRC_EN) : (ctrl & ~HOCS_CTRL_CRC_EN));
+    dev->verify = mode;
+    return HOCS_OK;
+}
+
+/*
+ * ======================================================================================
+ * RESIDENT WEIGHTS
+ * ======================================================================================
+ */
+
+/*
+ * weights_hash
+ * 64-bit multiply-rotate hash over the matrix, seeded with its dimension.
+ */
+static uint64_t weights_hash(const float *b, uint32_t dim) {
+    const uint32_t *w = (const uint32_t *)b;
+    uint32_t words = dim * dim;
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ dim;
+
+    for (uint32_t i = 0; i + 1 < words; i += 2) {
+        uint64_t v = ((uint64_t)w[i + 1] << 32) | w[i];
+        h ^= v * 0x87C37B91114253D5ULL;
+        h = ((h << 31) | (h >> 33)) * 0x4CF5AD432745937FULL;
+    }
+    if (words & 1) {
+        h ^= w[words - 1] * 0x87C37B91114253D5ULL;
+    }
+
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/*
+ * hocs_weights_register
+ * Makes 'b' (dim x dim float32) resident and returns its handle. A matrix
+ * with the same contents already in a slot is a hit and costs no upload.
+ * On a miss the least recently used idle slot is reloaded: the matrix is
+ * copied to the slot's staging buffer (so 'b' may be reused as soon as this
+ * returns) and a LOAD_W descriptor is queued ahead of any job that uses it.
+ * Returns HOCS_ERR_BUSY if every slot has queued jobs or the ring is full.
+ */
+int hocs_weights_register(hocs_device_t *dev, const float *b, uint32_t dim, uint32_t *handle) {
+    hocs_weight_slot_t *victim = NULL;
+    uint64_t hash;
+    uint32_t idx;
+
+    if (b == NULL || handle == NULL || dim == 0 || dim > HOCS_MAX_DIM) {
+        return HOCS_ERR_INVALID;
+    }
+
+    /* 1. Cache lookup */
+    hash = weights_hash(b, dim);
+    for (idx = 0; idx < HOCS_WEIGHT_SLOTS; idx++) {
+        hocs_weight_slot_t *w = &dev->wslot[idx];
+        if (w->valid && w->hash == hash && w->dim == dim) {
+            w->last_use = ++dev->wclock;
+            dev->weight_hits++;
+            *handle = (w->gen << 8) | (idx + 1);
+            return HOCS_OK;
+        }
+    }
+
+    /* 2. Victim: an empty slot, else the least recently used idle one */
+    for (idx = 0; idx < HOCS_WEIGHT_SLOTS; idx++) {
+        hocs_weight_slot_t *w = &dev->wslot[idx];
+        if (__atomic_load_n(&w->inflight, __ATOMIC_ACQUIRE) != 0) {
+            continue;
+        }
+        if (!w->valid) {
+            victim = w;
+            break;
+        }
+        if (victim == NULL || w->last_use < victim->last_use) {
+            victim = w;
+        }
+    }
+    if (victim == NULL) {
+        return HOCS_ERR_BUSY;
+    }
+    idx = (uint32_t)(victim - dev->wslot);
+
+    if (dev->wstage == NULL) {
+        dev->wstage = (float *)hocs_buf_alloc(HOCS_WEIGHT_SLOTS * HOCS_WEIGHT_SLOT_BYTES);
+        if (dev->wstage == NULL) {
+            return HOCS_ERR_INVALID;
+        }
+    }
+
+    /* 3. Stage the matrix (nothing reads this slot's copy any more) */
+    float *stage = dev->wstage + (size_t)idx * (HOCS_WEIGHT_SLOT_BYTES / sizeof(float));
+    victim->load_job.flags = 0;
+    if (dev->verify) {
+        victim->load_job.src_crc = crc32c_copy(0, stage, b, (size_t)dim * dim * sizeof(float));
+        victim->load_job.flags = HOCS_JOB_F_SRC_CRC;
+    } else {
+        for (uint32_t i = 0; i < dim * dim; i++) {
+            stage[i] = b[i];
+        }
+    }
+
+    if (victim->valid) {
+        dev->weight_evictions++;
+    }
+    victim->valid = 1;
+    victim->hash = hash;
+    victim->dim = dim;
+    victim->gen = (victim->gen + 1) & 0xFFFFFF;
+    victim->last_use = ++dev->wclock;
+    *handle = (victim->gen << 8) | (idx + 1);
+
+    /* 4. Upload into URAM, ordered ahead of later jobs by the ring */
+    victim->load_job.src_addr = (uint64_t)(uintptr_t)stage;
+    victim->load_job.dst_addr = 0;
+    victim->load_job.matrix_dim = dim;
+    victim->load_job.done = NULL;
+    victim->load_job.scratch = NULL;
+    victim->load_job.weights = *handle;
+    victim->load_job.rows = 0;
+
+    if (hocs_queue(dev, &victim->load_job, HOCS_DESC_F_LOAD_W | HOCS_DESC_F_SLOT(idx)) != HOCS_OK) {
+        victim->valid = 0;
+        return HOCS_ERR_BUSY;
+    }
+    dev->weight_loads++;
+    return HOCS_OK;
+}
+
+/*
+ * hocs_weights_resident
+ * 1 while 'handle' can still be used for submission.
+ */
+int hocs_weights_resident(hocs_device_t *dev, uint32_t handle) {
+    return weights_slot(dev, handle) != NULL;
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK: WEIGHT-STATIONARY vs. FULL UPLOAD (HOCS MODEL, VIRTUAL TIME)
+ * ======================================================================================
+ * An inference-style stream: each request pushes BENCH_ROWS activation
+ * vectors through one of BENCH_LAYERS weight matrices in turn. Without
+ * residency every job uploads A (padded to N x N) and B; with it, jobs
+ * stream rows only. BENCH_REREGISTER looks every matrix up by content per
+ * job instead of keeping handles; the 6-layer run cycles through more
+ * layers than there are slots, the worst case for LRU.
+ */
+
+#define BENCH_DIM               128
+#define BENCH_ROWS              8
+#define BENCH_JOBS              512
+#define BENCH_MAX_LAYERS        6
+
+#define BENCH_FULL_UPLOAD       0
+#define BENCH_KEEP_HANDLES      1
+#define BENCH_REREGISTER        2
+
+static hocs_job_t bench_jobs[HOCS_RING_ENTRIES];
+
+/* Lets the engine finish its current descriptor, then reaps */
+static void bench_step(hocs_device_t *dev) {
+    if (dev->model->busy) {
+        hocs_bench.now = dev->model->busy_until_ns;
+    }
+    hocs_poll(dev, HOCS_RING_ENTRIES);
+}
+
+static void bench_run(const char *label, float *buf, uint32_t layers, int mode) {
+    uint32_t handle[BENCH_MAX_LAYERS] = {0};
+    uint64_t bytes0, hits0 = 0, loads0 = 0;
+    const uint32_t nn = BENCH_DIM * BENCH_DIM;
+    float *act = buf;                               // N x N (padded A)
+    float *out = buf + nn;                          // N x N
+    float *w = buf + 2 * nn;                        // 'layers' x N x N
+
+    hocs_device_t *dev = hocs_bench_init(0, "hocs-ws-bench", hocs_bench_virtual_ns, 0);
+    bytes0 = dev->model->dma_bytes;
+    hits0 = dev->weight_hits;
+    loads0 = dev->weight_loads;
+
+    for (uint32_t j = 0; j < BENCH_JOBS; j++) {
+        hocs_job_t *job = &bench_jobs[j & (HOCS_RING_ENTRIES - 1)];
+        uint32_t l = j % layers;
+        int rc;
+
+        while (job->state == HOCS_JOB_QUEUED) {
+            bench_step(dev);
+        }
+
+        job->dst_addr = (uint64_t)(uintptr_t)out;
+        job->flags = 0;
+        job->done = NULL;
+        job->scratch = NULL;
+
+        if (mode != BENCH_FULL_UPLOAD) {
+            if (mode == BENCH_REREGISTER) handle[l] = 0;
+            while (!hocs_weights_resident(dev, handle[l]) &&
+                   hocs_weights_register(dev, w + l * nn, BENCH_DIM, &handle[l]) == HOCS_ERR_BUSY) {
+                bench_step(dev);
+            }
+            job->src_addr = (uint64_t)(uintptr_t)act;
+            job->weights = handle[l];
+            job->rows = BENCH_ROWS;
+        } else {
+            /* Full upload: [A | B] with B = layer l (model is non-functional) */
+            job->src_addr = (uint64_t)(uintptr_t)(w + l * nn - nn);
+            job->matrix_dim = BENCH_DIM;
+            job->weights = 0;
+            job->rows = 0;
+        }
+
+        while ((rc = hocs_submit(dev, job)) == HOCS_ERR_BUSY) {
+            bench_step(dev);
+        }
+        if (rc != HOCS_OK) {
+            kprintf("  %s submit failed (%d)\n", label, rc);
+            return;
+        }
+    }
+
+    while (dev->cons != dev->prod) {
+        bench_step(dev);
+    }
+
+    uint64_t mb = (dev->model->dma_bytes - bytes0) >> 20;
+    kprintf("  %s %lu jobs/s, %lu MB DMA, %lu loads, %lu hits\n", label,
+            (uint64_t)BENCH_JOBS * NS_PER_SEC / (hocs_bench.now ? hocs_bench.now : 1), mb,
+            dev->weight_loads - loads0, dev->weight_hits - hits0);
+}
+
+/*
+ * hocs_weights_benchmark
+ * Throughput of the three modes on the behavioral model.
+ */
+void hocs_weights_benchmark(void) {
+    size_t bytes = (2 + BENCH_MAX_LAYERS) * BENCH_DIM * BENCH_DIM * sizeof(float);
+    float *buf = (float *)hocs_buf_alloc(bytes);
+
+    if (buf == NULL) {
+        kprintf("[HOCS] weight benchmark: out of memory\n");
+        return;
+    }
+    for (uint32_t i = 0; i < bytes / sizeof(float); i++) {
+        buf[i] = (float)(i % 251) * 0.01f;      // Distinct layers, distinct hashes
+    }
+
+    kprintf("[HOCS] Weight-stationary benchmark: %ux%u weights, %u rows per job, %u jobs\n",
+            BENCH_DIM, BENCH_DIM, BENCH_ROWS, BENCH_JOBS);
+    bench_run("full upload,     3 layers:", buf, 3, BENCH_FULL_UPLOAD);
+    bench_run("kept handles,    3 layers:", buf, 3, BENCH_KEEP_HANDLES);
+    bench_run("lookup per job,  3 layers:", buf, 3, BENCH_REREGISTER);
+    bench_run("kept handles,    6 layers:", buf, BENCH_MAX_LAYERS, BENCH_KEEP_HANDLES);
+
+    hocs_buf_free(buf, bytes);
+}
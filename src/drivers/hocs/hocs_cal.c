@@ -0,0 +1,312 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_cal.c
+ * Module:      HOCS Laser Calibration Implementation
+ * Author:      PhotonX R&D Team
+ * ======================================================================================
+ */
+
+#include "drivers/hocs_cal.h"
+#include "kernel/timer_heavy.h"
+#include "lib/crc16.h"
+#include "lib/kprintf.h"
+
+#define CAL_CHANNELS_PER_GROUP  (HOCS_NUM_CHANNELS / HOCS_CHANNEL_GROUPS)
+#define CAL_PHASE_COARSE_STEP   128
+#define CAL_PHASE_FINE_STEP     8
+
+/* Record lives in the persistent DDR block */
+#define cal_store               ((hocs_cal_record_t *)ZYNQMP_CALSTORE_BASE)
+
+_Static_assert(sizeof(hocs_cal_record_t) <= ZYNQMP_CALSTORE_SIZE, "calibration record too large");
+
+/*
+ * ======================================================================================
+ * HELPERS
+ * ======================================================================================
+ */
+
+static int32_t cal_temp_mc(hocs_device_t *dev, uint32_t zone) {
+    return (int32_t)hocs_rd(dev, zone ? HOCS_TEMP_SENSOR_2_OFFSET : HOCS_TEMP_SENSOR_1_OFFSET);
+}
+
+static int32_t cal_abs(int32_t v) {
+    return (v < 0) ? -v : v;
+}
+
+static uint32_t cal_monitor(hocs_device_t *dev, uint32_t ch, uint32_t power, uint32_t phase) {
+    hocs_wr(dev, HOCS_CHAN_SEL_OFFSET, ch);
+    hocs_wr(dev, HOCS_LASER_POWER_OFFSET, power);
+    hocs_wr(dev, HOCS_PHASE_SHIFT_OFFSET, phase & (HOCS_PHASE_STEPS - 1));
+    return hocs_rd(dev, HOCS_CHAN_MONITOR_OFFSET);
+}
+
+static uint32_t cal_record_crc(const hocs_cal_record_t *r) {
+    const uint8_t *start = (const uint8_t *)&r->version;
+    const uint8_t *end = (const uint8_t *)&r->crc;
+
+    return crc16_ccitt(start, (uint32_t)(end - start));
+}
+
+static const char *cal_record_check(const hocs_cal_record_t *r) {
+    if (r->magic != HOCS_CAL_MAGIC) return "no stored calibration";
+    if (r->version != HOCS_CAL_VERSION || r->size != sizeof(*r) ||
+        r->channels != HOCS_NUM_CHANNELS) return "stored calibration has old layout";
+    if (r->crc != cal_record_crc(r)) return "stored calibration corrupt (CRC)";
+    return NULL;
+}
+
+/*
+ * cal_wait_tec
+ * Programs both TEC loops and waits until the sensors are inside the band.
+ */
+static int cal_wait_tec(hocs_device_t *dev, const uint16_t *setpoint_cc) {
+    uint64_t start = timer_get_ticks();
+
+    hocs_wr(dev, HOCS_TEC_CONTROL_OFFSET, HOCS_TEC_PACK(setpoint_cc[0], setpoint_cc[1]));
+
+    for (;;) {
+        int settled = 1;
+        for (uint32_t z = 0; z < HOCS_THERMAL_ZONES; z++) {
+            int32_t err = cal_temp_mc(dev, z) - (int32_t)setpoint_cc[z] * 10;
+            if (cal_abs(err) > HOCS_CAL_TEC_SETTLE_TOL_MC) settled = 0;
+        }
+        if (settled) {
+            return HOCS_OK;
+        }
+
+        if (timer_ticks_to_us(timer_get_ticks() - start) > HOCS_CAL_TEC_TIMEOUT_MS * 1000ULL) {
+            return HOCS_ERR_TIMEOUT;
+        }
+        mdelay(10);
+    }
+}
+
+/*
+ * cal_channel
+ * 1. Phase: coarse sweep over 2*pi, then fine sweep around the peak.
+ * 2. Power: binary search on the DAC for the target monitor reading.
+ */
+static void cal_channel(hocs_device_t *dev, uint32_t ch, hocs_cal_record_t *rec) {
+    uint32_t probe = HOCS_DAC_MAX / 2;
+    uint32_t best_phase = 0, best_uw = 0;
+    uint32_t lo = 0, hi = HOCS_DAC_MAX;
+
+    for (uint32_t ph = 0; ph < HOCS_PHASE_STEPS; ph += CAL_PHASE_COARSE_STEP) {
+        uint32_t uw = cal_monitor(dev, ch, probe, ph);
+        if (uw > best_uw) {
+            best_uw = uw;
+            best_phase = ph;
+        }
+    }
+
+    uint32_t center = best_phase;
+    for (int32_t d = -CAL_PHASE_COARSE_STEP; d <= CAL_PHASE_COARSE_STEP; d += CAL_PHASE_FINE_STEP) {
+        uint32_t ph = (center + (uint32_t)d) & (HOCS_PHASE_STEPS - 1);
+        uint32_t uw = cal_monitor(dev, ch, probe, ph);
+        if (uw > best_uw) {
+            best_uw = uw;
+            best_phase = ph;
+        }
+    }
+
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (cal_monitor(dev, ch, mid, best_phase) < rec->target_uw) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    rec->phase[ch] = (uint16_t)best_phase;
+    rec->power[ch] = (uint16_t)lo;
+    cal_monitor(dev, ch, lo, best_phase);
+}
+
+/*
+ * ======================================================================================
+ * PUBLIC API
+ * ======================================================================================
+ */
+
+/*
+ * hocs_cal_full
+ * Complete calibration from cold. Fills 'rec' (not yet persisted).
+ */
+int hocs_cal_full(hocs_device_t *dev, hocs_cal_record_t *rec) {
+    int rc;
+
+    kprintf("[HOCS] Starting Laser Calibration Sequence...\n");
+
+    rec->channels = HOCS_NUM_CHANNELS;
+    rec->target_uw = HOCS_CAL_TARGET_UW;
+    for (uint32_t z = 0; z < HOCS_THERMAL_ZONES; z++) {
+        rec->tec_setpoint[z] = HOCS_CAL_TEC_SETPOINT_CC;
+    }
+
+    /* 1. Thermal loops */
+    rc = cal_wait_tec(dev, rec->tec_setpoint);
+    if (rc != HOCS_OK) {
+        kprintf("[HOCS] WARN: TEC did not settle within %d ms\n", HOCS_CAL_TEC_TIMEOUT_MS);
+    }
+
+    /* 2. Per group: warm-up, then per-channel phase + power */
+    hocs_wr(dev, HOCS_CONTROL_OFFSET, hocs_rd(dev, HOCS_CONTROL_OFFSET) | HOCS_CTRL_LASER_EN);
+
+    for (uint32_t g = 0; g < HOCS_CHANNEL_GROUPS; g++) {
+        kprintf("  > Channel Group %d: Warming Up (%d C)...\r", (int)g,
+                (int)(cal_temp_mc(dev, 0) / 1000));
+        mdelay(HOCS_CAL_WARMUP_MS);
+
+        for (uint32_t c = 0; c < CAL_CHANNELS_PER_GROUP; c++) {
+            cal_channel(dev, g * CAL_CHANNELS_PER_GROUP + c, rec);
+        }
+
+        kprintf("  > Channel Group %d: STABLE (%d C)     \n", (int)g,
+                (int)(cal_temp_mc(dev, 0) / 1000));
+    }
+
+    /* 3. Temperature stamp */
+    for (uint32_t z = 0; z < HOCS_THERMAL_ZONES; z++) {
+        rec->temp_mc[z] = cal_temp_mc(dev, z);
+    }
+
+    kprintf("[HOCS] All %d VCSEL Channels Ready.\n", HOCS_NUM_CHANNELS);
+    return rc;
+}
+
+/*
+ * hocs_cal_apply
+ * Writes a stored calibration back to the IP.
+ */
+int hocs_cal_apply(hocs_device_t *dev, const hocs_cal_record_t *rec) {
+    hocs_wr(dev, HOCS_TEC_CONTROL_OFFSET, HOCS_TEC_PACK(rec->tec_setpoint[0], rec->tec_setpoint[1]));
+
+    for (uint32_t ch = 0; ch < HOCS_NUM_CHANNELS; ch++) {
+        hocs_wr(dev, HOCS_CHAN_SEL_OFFSET, ch);
+        hocs_wr(dev, HOCS_PHASE_SHIFT_OFFSET, rec->phase[ch]);
+        hocs_wr(dev, HOCS_LASER_POWER_OFFSET, rec->power[ch]);
+    }
+
+    hocs_wr(dev, HOCS_CONTROL_OFFSET, hocs_rd(dev, HOCS_CONTROL_OFFSET) | HOCS_CTRL_LASER_EN);
+    return HOCS_OK;
+}
+
+void hocs_cal_invalidate(void) {
+    cal_store->magic = 0;
+    asm volatile("dsb sy" ::: "memory");
+}
+
+/*
+ * cal_warm_check
+ * Returns NULL if the stored calibration may be reused as-is.
+ */
+static const char *cal_warm_check(hocs_device_t *dev, const hocs_cal_record_t *rec) {
+    const char *why = cal_record_check(rec);
+    int32_t first[HOCS_THERMAL_ZONES];
+
+    if (why) {
+        return why;
+    }
+
+    /* 1. Same thermal operating point as when calibrated */
+    for (uint32_t z = 0; z < HOCS_THERMAL_ZONES; z++) {
+        first[z] = cal_temp_mc(dev, z);
+        if (cal_abs(first[z] - rec->temp_mc[z]) > HOCS_CAL_TEMP_TOL_MC) {
+            return "sensor temperature differs from calibration stamp";
+        }
+    }
+
+    /* 2. And not drifting */
+    mdelay(HOCS_CAL_STABLE_WINDOW_MS);
+    for (uint32_t z = 0; z < HOCS_THERMAL_ZONES; z++) {
+        if (cal_abs(cal_temp_mc(dev, z) - first[z]) > HOCS_CAL_STABLE_TOL_MC) {
+            return "sensor temperature not stable";
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * cal_spot_check
+ * Re-measures a spread of channels after a restore.
+ */
+static const char *cal_spot_check(hocs_device_t *dev, const hocs_cal_record_t *rec) {
+    uint32_t tol = rec->target_uw * HOCS_CAL_SPOT_TOL_PCT / 100;
+
+    for (uint32_t i = 0; i < HOCS_CAL_SPOT_CHECKS; i++) {
+        uint32_t ch = ((2 * i + 1) * HOCS_NUM_CHANNELS) / (2 * HOCS_CAL_SPOT_CHECKS);
+        uint32_t uw;
+
+        hocs_wr(dev, HOCS_CHAN_SEL_OFFSET, ch);
+        uw = hocs_rd(dev, HOCS_CHAN_MONITOR_OFFSET);
+
+        if (cal_abs((int32_t)uw - (int32_t)rec->target_uw) > (int32_t)tol) {
+            return "spot check outside tolerance";
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * hocs_cal_boot
+ * Boot entry point: warm restore when possible, full calibration otherwise.
+ */
+int hocs_cal_boot(hocs_device_t *dev, hocs_cal_result_t *res) {
+    hocs_cal_record_t *rec = cal_store;
+    uint64_t start = timer_get_ticks();
+    const char *why;
+    int rc;
+
+    /* 1. Warm path */
+    why = cal_warm_check(dev, rec);
+    if (why == NULL) {
+        hocs_cal_apply(dev, rec);
+        why = cal_spot_check(dev, rec);
+    }
+
+    if (why == NULL) {
+        res->path = HOCS_CAL_PATH_WARM;
+        res->reason = "sensors match calibration stamp";
+        res->elapsed_us = (uint32_t)timer_ticks_to_us(timer_get_ticks() - start);
+        res->saved_us = (rec->full_cal_us > res->elapsed_us) ? rec->full_cal_us - res->elapsed_us : 0;
+
+        kprintf("[HOCS] Warm boot: calibration #%u restored in %u us (full run %u ms, saved %u ms)\n",
+                rec->cal_count, res->elapsed_us, rec->full_cal_us / 1000, res->saved_us / 1000);
+        return HOCS_OK;
+    }
+
+    /* 2. Full path, then persist */
+    kprintf("[HOCS] Full calibration: %s\n", why);
+
+    uint32_t count = (cal_record_check(rec) == NULL) ? rec->cal_count : 0;
+    rec->magic = 0;
+    asm volatile("dmb ish" ::: "memory");
+
+    rc = hocs_cal_full(dev, rec);
+
+    res->path = HOCS_CAL_PATH_FULL;
+    res->reason = why;
+    res->elapsed_us = (uint32_t)timer_ticks_to_us(timer_get_ticks() - start);
+    res->saved_us = 0;
+
+    if (rc == HOCS_OK) {
+        rec->version = HOCS_CAL_VERSION;
+        rec->size = sizeof(*rec);
+        rec->cal_count = count + 1;
+        rec->full_cal_us = res->elapsed_us;
+        rec->crc = cal_record_crc(rec);
+        asm volatile("dmb ish" ::: "memory");
+        rec->magic = HOCS_CAL_MAGIC;
+        asm volatile("dsb sy" ::: "memory");
+    }
+
+    kprintf("[HOCS] Calibration took %u ms%s\n", res->elapsed_us / 1000,
+            (rc == HOCS_OK) ? " (stored for warm boot)" : " (not stored)");
+    return rc;
+}
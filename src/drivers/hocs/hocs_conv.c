@@ -0,0 +1,924 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_conv.c
+ * Module:      HOCS Convolution Front End Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Both lowerings use resident-weight jobs only: im2col tiles of W, or the
+ * two DFT matrices, are the stationary operand and activations stream
+ * through as rows. Everything the run needs is allocated by the plan.
+ * ======================================================================================
+ */
+
+#include "drivers/hocs_conv.h"
+#include "drivers/hocs_model.h"
+#include "kernel/timer_heavy.h"
+#include "lib/kprintf.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+static void *conv_alloc(hocs_conv_t *c, size_t bytes) {
+    void *p;
+
+    if (c->nmem >= sizeof(c->mem) / sizeof(c->mem[0])) {
+        return NULL;
+    }
+    p = hocs_buf_alloc_on(c->dev, bytes);
+    if (p) {
+        c->mem[c->nmem] = p;
+        c->mem_size[c->nmem++] = bytes;
+        c->bytes += bytes;
+    }
+    return p;
+}
+
+void hocs_conv_free(hocs_conv_t *c) {
+    for (uint32_t i = 0; i < c->nmem; i++) {
+        hocs_buf_free(c->mem[i], c->mem_size[i]);
+    }
+    c->nmem = 0;
+    c->bytes = 0;
+}
+
+static inline void conv_copy(float *d, const float *s, uint32_t n) {
+    uint32_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(d + i, vld1q_f32(s + i));
+    }
+#endif
+    for (; i < n; i++) d[i] = s[i];
+}
+
+static inline void conv_zero(float *d, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) d[i] = 0.0f;
+}
+
+/* Queue a resident-weight job, reaping while the ring is full */
+static int conv_submit(hocs_conv_t *c, hocs_job_t *job, const float *src, float *dst,
+                       uint32_t handle, uint32_t n, uint32_t rows) {
+    int rc;
+
+    job->src_addr = (uint64_t)(uintptr_t)src;
+    job->dst_addr = (uint64_t)(uintptr_t)dst;
+    job->matrix_dim = n;
+    job->flags = 0;
+    job->done = NULL;
+    job->ctx = NULL;
+    job->scratch = NULL;
+    job->weights = handle;
+    job->rows = rows;
+
+    while ((rc = hocs_submit(c->dev, job)) == HOCS_ERR_BUSY) {
+        hocs_poll(c->dev, HOCS_RING_ENTRIES);
+    }
+    if (rc == HOCS_OK) {
+        c->jobs++;
+    }
+    return rc;
+}
+
+/* Handle of resident matrix 'w', registering it again if it was evicted */
+static int conv_weights(hocs_conv_t *c, const float *w, uint32_t n, uint32_t *handle) {
+    int rc;
+
+    if (*handle && hocs_weights_resident(c->dev, *handle)) {
+        return HOCS_OK;
+    }
+    while ((rc = hocs_weights_register(c->dev, w, n, handle)) == HOCS_ERR_BUSY) {
+        hocs_poll(c->dev, HOCS_RING_ENTRIES);
+    }
+    return rc;
+}
+
+/* Nominal IP time of one resident job (rows x n in and out) */
+static uint64_t conv_job_ns(uint32_t rows, uint32_t n) {
+    uint64_t bytes = 2ULL * rows * n * sizeof(float);
+    return HOCS_MODEL_SETUP_NS + HOCS_MODEL_COMPUTE_NS + bytes * 1000 / HOCS_MODEL_DMA_BYTES_PER_US;
+}
+
+static inline uint64_t conv_cpu_ns(uint64_t flops) {
+    return flops * 1000 / HOCS_CONV_CPU_MFLOPS;
+}
+
+static inline uint32_t conv_div_up(uint32_t a, uint32_t b) {
+    return (a + b - 1) / b;
+}
+
+/*
+ * ======================================================================================
+ * IM2COL LOWERING
+ * ======================================================================================
+ */
+
+static void im2col_geometry(hocs_conv_t *c) {
+    const uint32_t kk = c->s.in_c * c->s.k * c->s.k;
+
+    /* K tiles hold whole kx runs so no run straddles two tiles */
+    c->kt_size = (kk <= HOCS_MAX_DIM) ? kk : (HOCS_MAX_DIM / c->s.k) * c->s.k;
+    c->ot_size = (c->s.out_c <= HOCS_MAX_DIM) ? c->s.out_c : HOCS_MAX_DIM;
+    c->n = (c->kt_size > c->ot_size) ? c->kt_size : c->ot_size;
+    c->n = (c->n + 3) & ~3U;
+    if (c->n > HOCS_MAX_DIM) {
+        c->n = HOCS_MAX_DIM;
+    }
+    c->ktiles = conv_div_up(kk, c->kt_size);
+    c->otiles = conv_div_up(c->s.out_c, c->ot_size);
+}
+
+static uint64_t im2col_estimate(hocs_conv_t *c) {
+    const uint64_t npix = (uint64_t)c->out_h * c->out_w;
+    const uint64_t kk = (uint64_t)c->s.in_c * c->s.k * c->s.k;
+    uint64_t tiles = (uint64_t)c->otiles * c->ktiles;
+    uint64_t hocs_ns, cpu_ns;
+
+    hocs_ns = tiles * conv_div_up((uint32_t)npix, c->n) * conv_job_ns(c->n, c->n) +
+              tiles * ((uint64_t)c->n * c->n * sizeof(float) * 1000 / HOCS_MODEL_DMA_BYTES_PER_US);
+    cpu_ns = conv_cpu_ns(npix * kk * c->otiles + npix * c->s.out_c * c->ktiles);
+
+    /* Extraction and accumulation overlap the jobs */
+    return (hocs_ns > cpu_ns) ? hocs_ns : cpu_ns;
+}
+
+static int im2col_plan(hocs_conv_t *c, const float *w) {
+    const uint32_t kk = c->s.in_c * c->s.k * c->s.k;
+    const uint32_t nn = c->n * c->n;
+
+    c->wtile = (float *)conv_alloc(c, (size_t)c->otiles * c->ktiles * nn * sizeof(float));
+    c->handle = (uint32_t *)conv_alloc(c, (size_t)c->otiles * c->ktiles * sizeof(uint32_t));
+    c->runs = (hocs_conv_run_t *)conv_alloc(c, (size_t)c->s.in_c * c->s.k * sizeof(hocs_conv_run_t));
+    if (c->wtile == NULL || c->handle == NULL || c->runs == NULL) {
+        return HOCS_ERR_INVALID;
+    }
+
+    /* 1. W tiles: row r = patch column, column = output channel */
+    for (uint32_t ot = 0; ot < c->otiles; ot++) {
+        for (uint32_t kt = 0; kt < c->ktiles; kt++) {
+            float *b = c->wtile + ((size_t)ot * c->ktiles + kt) * nn;
+            for (uint32_t r = 0; r < c->n; r++) {
+                for (uint32_t col = 0; col < c->n; col++) {
+                    uint32_t j = kt * c->kt_size + r;
+                    uint32_t oc = ot * c->ot_size + col;
+                    int in = r < c->kt_size && j < kk && col < c->ot_size && oc < c->s.out_c;
+                    b[r * c->n + col] = in ? w[(size_t)oc * kk + j] : 0.0f;
+                }
+            }
+            c->handle[ot * c->ktiles + kt] = 0;
+        }
+    }
+
+    /* 2. One kx run per (ic, ky) */
+    for (uint32_t ic = 0; ic < c->s.in_c; ic++) {
+        for (uint32_t ky = 0; ky < c->s.k; ky++) {
+            hocs_conv_run_t *r = &c->runs[ic * c->s.k + ky];
+            r->col = (ic * c->s.k + ky) * c->s.k;
+            r->ic = ic;
+            r->ky = ky;
+        }
+    }
+
+    /* 3. Staging ring */
+    for (uint32_t i = 0; i < HOCS_CONV_DEPTH; i++) {
+        c->slot[i].stage = (float *)conv_alloc(c, (size_t)2 * nn * sizeof(float));
+        if (c->slot[i].stage == NULL) {
+            return HOCS_ERR_INVALID;
+        }
+        c->slot[i].part = c->slot[i].stage + nn;
+        c->slot[i].job.state = HOCS_JOB_IDLE;
+    }
+    return HOCS_OK;
+}
+
+/*
+ * im2col_extract
+ * Patch rows of output pixels [pix, pix + rows) for K tile 'kt'.
+ */
+static void im2col_extract(const hocs_conv_t *c, const float *in, float *stage,
+                           uint32_t pix, uint32_t rows, uint32_t kt) {
+    const hocs_conv_shape_t *s = &c->s;
+    const uint32_t kk = s->in_c * s->k * s->k;
+    const uint32_t col0 = kt * c->kt_size;
+    const uint32_t used = (kk - col0 < c->kt_size) ? kk - col0 : c->kt_size;
+    const uint32_t run0 = col0 / s->k, nruns = used / s->k;
+
+    for (uint32_t r = 0; r < rows; r++) {
+        uint32_t oy = (pix + r) / c->out_w, ox = (pix + r) % c->out_w;
+        int32_t iy0 = (int32_t)(oy * s->stride) - (int32_t)s->pad;
+        int32_t ix0 = (int32_t)(ox * s->stride) - (int32_t)s->pad;
+        int inside_x = ix0 >= 0 && ix0 + (int32_t)s->k <= (int32_t)s->in_w;
+        float *row = stage + (size_t)r * c->n;
+
+        for (uint32_t q = 0; q < nruns; q++) {
+            const hocs_conv_run_t *run = &c->runs[run0 + q];
+            int32_t iy = iy0 + (int32_t)run->ky;
+            float *d = row + run->col - col0;
+            const float *src;
+
+            if (iy < 0 || iy >= (int32_t)s->in_h) {
+                conv_zero(d, s->k);
+                continue;
+            }
+            src = in + ((size_t)run->ic * s->in_h + (uint32_t)iy) * s->in_w;
+            if (inside_x) {
+                conv_copy(d, src + ix0, s->k);
+                continue;
+            }
+            for (uint32_t kx = 0; kx < s->k; kx++) {
+                int32_t ix = ix0 + (int32_t)kx;
+                d[kx] = (ix >= 0 && ix < (int32_t)s->in_w) ? src[ix] : 0.0f;
+            }
+        }
+        conv_zero(row + used, c->n - used);
+    }
+}
+
+/* Waits for a slot's job and folds its partial product into 'out' (CHW) */
+static int im2col_retire(hocs_conv_t *c, hocs_conv_slot_t *sl, float *out) {
+    const uint32_t npix = c->out_h * c->out_w;
+    uint32_t oc0, ocs;
+    int rc;
+
+    if (sl->job.state == HOCS_JOB_IDLE) {
+        return HOCS_OK;
+    }
+    rc = hocs_wait(c->dev, &sl->job, HOCS_CONV_TIMEOUT_US);
+    sl->job.state = HOCS_JOB_IDLE;
+    if (rc != HOCS_OK) {
+        return rc;
+    }
+
+    oc0 = sl->ot * c->ot_size;
+    ocs = (c->s.out_c - oc0 < c->ot_size) ? c->s.out_c - oc0 : c->ot_size;
+    for (uint32_t oc = 0; oc < ocs; oc++) {
+        float *o = out + (size_t)(oc0 + oc) * npix + sl->pix;
+        const float *p = sl->part + oc;
+        if (sl->first) {
+            for (uint32_t r = 0; r < sl->rows; r++) o[r] = p[(size_t)r * c->n];
+        } else {
+            for (uint32_t r = 0; r < sl->rows; r++) o[r] += p[(size_t)r * c->n];
+        }
+    }
+    return HOCS_OK;
+}
+
+/*
+ * im2col_run
+ * Weight tile outermost: each (output tile, K tile) of W is made resident
+ * once per run and every pixel tile streams through it. The next patch
+ * tile is extracted while up to HOCS_CONV_DEPTH - 1 earlier ones run.
+ */
+static int im2col_run(hocs_conv_t *c, const float *in, float *out) {
+    const uint32_t npix = c->out_h * c->out_w;
+    const uint32_t nn = c->n * c->n;
+    uint32_t q = 0;
+    int rc = HOCS_OK;
+
+    for (uint32_t ot = 0; ot < c->otiles && rc == HOCS_OK; ot++) {
+        for (uint32_t kt = 0; kt < c->ktiles && rc == HOCS_OK; kt++) {
+            uint32_t t = ot * c->ktiles + kt;
+
+            rc = conv_weights(c, c->wtile + (size_t)t * nn, c->n, &c->handle[t]);
+
+            for (uint32_t pix = 0; pix < npix && rc == HOCS_OK; pix += c->n, q++) {
+                hocs_conv_slot_t *sl = &c->slot[q % HOCS_CONV_DEPTH];
+
+                /* 1. Free the slot: oldest job in flight */
+                rc = im2col_retire(c, sl, out);
+                if (rc != HOCS_OK) {
+                    break;
+                }
+
+                /* 2. Extract this tile while the others run, queue it */
+                sl->pix = pix;
+                sl->rows = (npix - pix < c->n) ? npix - pix : c->n;
+                sl->ot = ot;
+                sl->first = (kt == 0);
+                im2col_extract(c, in, sl->stage, pix, sl->rows, kt);
+                rc = conv_submit(c, &sl->job, sl->stage, sl->part, c->handle[t], c->n, sl->rows);
+            }
+        }
+    }
+
+    /* 3. Drain (oldest first: later partials of a pixel tile add to earlier ones) */
+    for (uint32_t i = 0; i < HOCS_CONV_DEPTH; i++) {
+        int err = im2col_retire(c, &c->slot[(q + i) % HOCS_CONV_DEPTH], out);
+        if (rc == HOCS_OK) {
+            rc = err;
+        }
+    }
+    return rc;
+}
+
+/*
+ * ======================================================================================
+ * FFT LOWERING
+ * ======================================================================================
+ * Spectra are kept transposed (S = Y^T); the per-bin product does not care
+ * and it saves a transpose each way:
+ *   forward: Z = X F,   S = Z^T F          (2 + 4 real jobs)
+ *   inverse: U = S F*,  n^2 x = U^T F*     (4 + 2 real jobs)
+ */
+
+/* sin/cos without libm: reduce to [-pi, pi], then Taylor */
+static void conv_sincos(double x, double *s, double *co) {
+    const double pi = 3.14159265358979323846;
+    double term, sum_s, sum_c, x2;
+
+    while (x > pi) x -= 2.0 * pi;
+    while (x < -pi) x += 2.0 * pi;
+
+    x2 = x * x;
+    term = x;
+    sum_s = x;
+    for (uint32_t i = 1; i < 16; i++) {
+        term *= -x2 / (double)((2 * i) * (2 * i + 1));
+        sum_s += term;
+    }
+    term = 1.0;
+    sum_c = 1.0;
+    for (uint32_t i = 1; i < 16; i++) {
+        term *= -x2 / (double)((2 * i - 1) * (2 * i));
+        sum_c += term;
+    }
+    *s = sum_s;
+    *co = sum_c;
+}
+
+static void fft_transpose(const float *a, float *t, uint32_t n) {
+    for (uint32_t r = 0; r < n; r++) {
+        for (uint32_t col = 0; col < n; col++) {
+            t[(size_t)col * n + r] = a[(size_t)r * n + col];
+        }
+    }
+}
+
+/* d = a + sign * b, elementwise */
+static void fft_combine(float *d, const float *a, const float *b, float sign, float scale, uint32_t len) {
+    uint32_t i = 0;
+#if defined(__ARM_NEON)
+    float32x4_t vs = vdupq_n_f32(sign), vk = vdupq_n_f32(scale);
+    for (; i + 4 <= len; i += 4) {
+        vst1q_f32(d + i, vmulq_f32(vmlaq_f32(vld1q_f32(a + i), vld1q_f32(b + i), vs), vk));
+    }
+#endif
+    for (; i < len; i++) d[i] = (a[i] + sign * b[i]) * scale;
+}
+
+/*
+ * fft_forward
+ * Spectra of 'count' real n x n tiles: tiles[i] -> spec[i] (re, im).
+ * Each item is moved to its second stage as soon as its first is done,
+ * so transposes overlap the other items' jobs.
+ */
+static int fft_forward(hocs_conv_t *c, const float *tiles, float *spec, uint32_t count) {
+    const uint32_t n = c->fn, nn = n * n;
+    int rc = HOCS_OK;
+
+    for (uint32_t b0 = 0; b0 < count && rc == HOCS_OK; b0 += HOCS_CONV_FFT_BATCH) {
+        uint32_t nb = (count - b0 < HOCS_CONV_FFT_BATCH) ? count - b0 : HOCS_CONV_FFT_BATCH;
+
+        rc = conv_weights(c, c->dft_r, n, &c->h_dft_r);
+        if (rc == HOCS_OK) rc = conv_weights(c, c->dft_i, n, &c->h_dft_i);
+
+        /* 1. Z = X F */
+        for (uint32_t i = 0; i < nb && rc == HOCS_OK; i++) {
+            float *wk = c->work + (size_t)i * 9 * nn;
+            const float *x = tiles + (size_t)(b0 + i) * nn;
+            rc = conv_submit(c, &c->fjob[4 * i], x, wk, c->h_dft_r, n, n);
+            if (rc == HOCS_OK) rc = conv_submit(c, &c->fjob[4 * i + 1], x, wk + nn, c->h_dft_i, n, n);
+        }
+
+        /* 2. S = Z^T F, per item as soon as its Z is back */
+        for (uint32_t i = 0; i < nb && rc == HOCS_OK; i++) {
+            float *wk = c->work + (size_t)i * 9 * nn;
+            float *zr_t = wk + 2 * nn, *zi_t = wk + 3 * nn, *o = wk + 4 * nn;
+
+            rc = hocs_wait(c->dev, &c->fjob[4 * i], HOCS_CONV_TIMEOUT_US);
+            if (rc == HOCS_OK) rc = hocs_wait(c->dev, &c->fjob[4 * i + 1], HOCS_CONV_TIMEOUT_US);
+            if (rc != HOCS_OK) break;
+
+            fft_transpose(wk, zr_t, n);
+            fft_transpose(wk + nn, zi_t, n);
+            rc = conv_submit(c, &c->fjob[4 * i], zr_t, o, c->h_dft_r, n, n);
+            if (rc == HOCS_OK) rc = conv_submit(c, &c->fjob[4 * i + 1], zi_t, o + nn, c->h_dft_i, n, n);
+            if (rc == HOCS_OK) rc = conv_submit(c, &c->fjob[4 * i + 2], zr_t, o + 2 * nn, c->h_dft_i, n, n);
+            if (rc == HOCS_OK) rc = conv_submit(c, &c->fjob[4 * i + 3], zi_t, o + 3 * nn, c->h_dft_r, n, n);
+        }
+
+        /* 3. Sr = Zr^T Fr - Zi^T Fi, Si = Zr^T Fi + Zi^T Fr */
+        for (uint32_t i = 0; i < nb && rc == HOCS_OK; i++) {
+            float *o = c->work + (size_t)i * 9 * nn + 4 * nn;
+            float *sp = spec + (size_t)(b0 + i) * 2 * nn;
+
+            for (uint32_t j = 0; j < 4 && rc == HOCS_OK; j++) {
+                rc = hocs_wait(c->dev, &c->fjob[4 * i + j], HOCS_CONV_TIMEOUT_US);
+            }
+            if (rc != HOCS_OK) break;
+            fft_combine(sp, o, o + nn, -1.0f, 1.0f, nn);
+            fft_combine(sp + nn, o + 2 * nn, o + 3 * nn, 1.0f, 1.0f, nn);
+        }
+    }
+
+    /* Nothing of ours may stay queued past an error */
+    for (uint32_t i = 0; i < 4 * HOCS_CONV_FFT_BATCH; i++) {
+        if (c->fjob[i].state == HOCS_JOB_QUEUED) {
+            hocs_wait(c->dev, &c->fjob[i], HOCS_CONV_TIMEOUT_US);
+        }
+    }
+    return rc;
+}
+
+/*
+ * fft_inverse
+ * Real n x n tiles of 'count' transposed spectra, scaled by 1/n^2.
+ */
+static int fft_inverse(hocs_conv_t *c, const float *spec, float *tiles, uint32_t count) {
+    const uint32_t n = c->fn, nn = n * n;
+    const float scale = 1.0f / (float)nn;
+    int rc = HOCS_OK;
+
+    for (uint32_t b0 = 0; b0 < count && rc == HOCS_OK; b0 += HOCS_CONV_FFT_BATCH) {
+        uint32_t nb = (count - b0 < HOCS_CONV_FFT_BATCH) ? count - b0 : HOCS_CONV_FFT_BATCH;
+
+        rc = conv_weights(c, c->dft_r, n, &c->h_dft_r);
+        if (rc == HOCS_OK) rc = conv_weights(c, c->dft_i, n, &c->h_dft_i);
+
+        /* 1. U = S F*: Ur = Sr Fr + Si Fi, Ui = Si Fr - Sr Fi */
+        for (uint32_t i = 0; i < nb && rc == HOCS_OK; i++) {
+            float *o = c->work + (size_t)i * 9 * nn;
+            const float *sr = spec + (size_t)(b0 + i) * 2 * nn, *si = sr + nn;
+            rc = conv_submit(c, &c->fjob[4 * i], sr, o, c->h_dft_r, n, n);
+            if (rc == HOCS_OK) rc = conv_submit(c, &c->fjob[4 * i + 1], si, o + nn, c->h_dft_i, n, n);
+            if (rc == HOCS_OK) rc = conv_submit(c, &c->fjob[4 * i + 2], si, o + 2 * nn, c->h_dft_r, n, n);
+            if (rc == HOCS_OK) rc = conv_submit(c, &c->fjob[4 * i + 3], sr, o + 3 * nn, c->h_dft_i, n, n);
+        }
+
+        /* 2. n^2 x = Ur^T Fr + Ui^T Fi */
+        for (uint32_t i = 0; i < nb && rc == HOCS_OK; i++) {
+            float *o = c->work + (size_t)i * 9 * nn;
+            float *u = o + 4 * nn, *ur_t = o + 6 * nn, *ui_t = o + 7 * nn;
+
+            for (uint32_t j = 0; j < 4 && rc == HOCS_OK; j++) {
+                rc = hocs_wait(c->dev, &c->fjob[4 * i + j], HOCS_CONV_TIMEOUT_US);
+            }
+            if (rc != HOCS_OK) break;
+
+            fft_combine(u, o, o + nn, 1.0f, 1.0f, nn);
+            fft_combine(u + nn, o + 2 * nn, o + 3 * nn, -1.0f, 1.0f, nn);
+            fft_transpose(u, ur_t, n);
+            fft_transpose(u + nn, ui_t, n);
+            rc = conv_submit(c, &c->fjob[4 * i], ur_t, o, c->h_dft_r, n, n);
+            if (rc == HOCS_OK) rc = conv_submit(c, &c->fjob[4 * i + 1], ui_t, o + nn, c->h_dft_i, n, n);
+        }
+
+        for (uint32_t i = 0; i < nb && rc == HOCS_OK; i++) {
+            float *o = c->work + (size_t)i * 9 * nn;
+            rc = hocs_wait(c->dev, &c->fjob[4 * i], HOCS_CONV_TIMEOUT_US);
+            if (rc == HOCS_OK) rc = hocs_wait(c->dev, &c->fjob[4 * i + 1], HOCS_CONV_TIMEOUT_US);
+            if (rc == HOCS_OK) {
+                fft_combine(tiles + (size_t)(b0 + i) * nn, o, o + nn, 1.0f, scale, nn);
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < 4 * HOCS_CONV_FFT_BATCH; i++) {
+        if (c->fjob[i].state == HOCS_JOB_QUEUED) {
+            hocs_wait(c->dev, &c->fjob[i], HOCS_CONV_TIMEOUT_US);
+        }
+    }
+    return rc;
+}
+
+/*
+ * fft_mac
+ * p = sum over ic of x_ic * conj(w_ic), per bin (correlation, not convolution).
+ */
+static void fft_mac(const hocs_conv_t *c, const float *wspec_oc, float *p) {
+    const uint32_t nn = c->fn * c->fn;
+    float *pr = p, *pi = p + nn;
+
+    conv_zero(p, 2 * nn);
+    for (uint32_t ic = 0; ic < c->s.in_c; ic++) {
+        const float *xr = c->xspec + (size_t)ic * 2 * nn, *xi = xr + nn;
+        const float *wr = wspec_oc + (size_t)ic * 2 * nn, *wi = wr + nn;
+        uint32_t i = 0;
+#if defined(__ARM_NEON)
+        for (; i + 4 <= nn; i += 4) {
+            float32x4_t a = vld1q_f32(xr + i), b = vld1q_f32(xi + i);
+            float32x4_t cr = vld1q_f32(wr + i), ci = vld1q_f32(wi + i);
+            float32x4_t r = vld1q_f32(pr + i), m = vld1q_f32(pi + i);
+            r = vmlaq_f32(vmlaq_f32(r, a, cr), b, ci);
+            m = vmlsq_f32(vmlaq_f32(m, b, cr), a, ci);
+            vst1q_f32(pr + i, r);
+            vst1q_f32(pi + i, m);
+        }
+#endif
+        for (; i < nn; i++) {
+            pr[i] += xr[i] * wr[i] + xi[i] * wi[i];
+            pi[i] += xi[i] * wr[i] - xr[i] * wi[i];
+        }
+    }
+}
+
+static uint64_t fft_estimate(const hocs_conv_t *c, uint32_t fn) {
+    const uint32_t step = fn - c->s.k + 1;
+    const uint64_t tiles = (uint64_t)conv_div_up(c->out_h, step) * conv_div_up(c->out_w, step);
+    const uint64_t nn = (uint64_t)fn * fn;
+    uint64_t hocs_ns, cpu_ns;
+
+    hocs_ns = tiles * (6ULL * c->s.in_c + 6ULL * c->s.out_c) * conv_job_ns(fn, fn);
+    cpu_ns = conv_cpu_ns(tiles * (8ULL * c->s.in_c * c->s.out_c * nn +
+                                  8ULL * (c->s.in_c + c->s.out_c) * nn));
+
+    /* Transforms and the per-bin product alternate */
+    return hocs_ns + cpu_ns;
+}
+
+/* Smallest-estimate DFT size; 0 if the kernel fits none */
+static uint32_t fft_size(const hocs_conv_t *c, uint64_t *est) {
+    uint32_t best = 0;
+
+    *est = 0;
+    if (c->s.stride != 1) {
+        return 0;
+    }
+    for (uint32_t fn = HOCS_CONV_FFT_MIN; fn <= HOCS_CONV_FFT_MAX; fn <<= 1) {
+        uint64_t e;
+        if (fn < 2 * c->s.k) {
+            continue;
+        }
+        e = fft_estimate(c, fn);
+        if (best == 0 || e < *est) {
+            best = fn;
+            *est = e;
+        }
+    }
+    return best;
+}
+
+static int fft_plan(hocs_conv_t *c, const float *w) {
+    const uint32_t n = c->fn, nn = n * n, k = c->s.k;
+    const uint32_t pairs = c->s.out_c * c->s.in_c;
+    const double pi = 3.14159265358979323846;
+    float *tiles;
+    int rc;
+
+    c->step = n - k + 1;
+    c->dft_r = (float *)conv_alloc(c, (size_t)2 * nn * sizeof(float));
+    c->wspec = (float *)conv_alloc(c, (size_t)pairs * 2 * nn * sizeof(float));
+    c->xspec = (float *)conv_alloc(c, (size_t)c->s.in_c * 2 * nn * sizeof(float));
+    c->pspec = (float *)conv_alloc(c, (size_t)c->s.out_c * 2 * nn * sizeof(float));
+    c->work = (float *)conv_alloc(c, (size_t)HOCS_CONV_FFT_BATCH * 10 * nn * sizeof(float));
+    if (!c->dft_r || !c->wspec || !c->xspec || !c->pspec || !c->work) {
+        return HOCS_ERR_INVALID;
+    }
+    tiles = c->work + (size_t)HOCS_CONV_FFT_BATCH * 9 * nn;
+    c->dft_i = c->dft_r + nn;
+    c->h_dft_r = 0;
+    c->h_dft_i = 0;
+
+    /* 1. DFT matrices: F[a][b] = exp(-2 pi i ab / n) */
+    for (uint32_t a = 0; a < n; a++) {
+        for (uint32_t b = 0; b < n; b++) {
+            double s, co;
+            conv_sincos(2.0 * pi * (double)((a * b) % n) / (double)n, &s, &co);
+            c->dft_r[a * n + b] = (float)co;
+            c->dft_i[a * n + b] = (float)-s;
+        }
+    }
+
+    /* 2. Kernel spectra, zero-padded to n x n at the origin */
+    for (uint32_t p0 = 0; p0 < pairs; p0 += HOCS_CONV_FFT_BATCH) {
+        uint32_t nb = (pairs - p0 < HOCS_CONV_FFT_BATCH) ? pairs - p0 : HOCS_CONV_FFT_BATCH;
+        conv_zero(tiles, nb * nn);
+        for (uint32_t i = 0; i < nb; i++) {
+            const float *wk = w + (size_t)(p0 + i) * k * k;     // OIHW: pair = oc * IC + ic
+            for (uint32_t ky = 0; ky < k; ky++) {
+                conv_copy(tiles + (size_t)i * nn + ky * n, wk + ky * k, k);
+            }
+        }
+        rc = fft_forward(c, tiles, c->wspec + (size_t)p0 * 2 * nn, nb);
+        if (rc != HOCS_OK) {
+            return rc;
+        }
+    }
+    return HOCS_OK;
+}
+
+/*
+ * fft_run
+ * Per output tile: transform the IC input tiles, multiply-accumulate into
+ * OC spectra, transform back, keep the valid step x step corner.
+ */
+static int fft_run(hocs_conv_t *c, const float *in, float *out) {
+    const hocs_conv_shape_t *s = &c->s;
+    const uint32_t n = c->fn, nn = n * n;
+    float *tiles = c->work + (size_t)HOCS_CONV_FFT_BATCH * 9 * nn;
+    int rc = HOCS_OK;
+
+    for (uint32_t oy0 = 0; oy0 < c->out_h && rc == HOCS_OK; oy0 += c->step) {
+        for (uint32_t ox0 = 0; ox0 < c->out_w && rc == HOCS_OK; ox0 += c->step) {
+
+            /* 1. Input spectra */
+            for (uint32_t ic0 = 0; ic0 < s->in_c && rc == HOCS_OK; ic0 += HOCS_CONV_FFT_BATCH) {
+                uint32_t nb = (s->in_c - ic0 < HOCS_CONV_FFT_BATCH) ? s->in_c - ic0 : HOCS_CONV_FFT_BATCH;
+                for (uint32_t i = 0; i < nb; i++) {
+                    const float *plane = in + (size_t)(ic0 + i) * s->in_h * s->in_w;
+                    for (uint32_t r = 0; r < n; r++) {
+                        int32_t iy = (int32_t)(oy0 + r) - (int32_t)s->pad;
+                        float *d = tiles + (size_t)i * nn + r * n;
+                        for (uint32_t col = 0; col < n; col++) {
+                            int32_t ix = (int32_t)(ox0 + col) - (int32_t)s->pad;
+                            d[col] = (iy >= 0 && iy < (int32_t)s->in_h && ix >= 0 && ix < (int32_t)s->in_w) ?
+                                     plane[(uint32_t)iy * s->in_w + (uint32_t)ix] : 0.0f;
+                        }
+                    }
+                }
+                rc = fft_forward(c, tiles, c->xspec + (size_t)ic0 * 2 * nn, nb);
+            }
+
+            /* 2. Per-bin products, 3. back, crop */
+            for (uint32_t oc0 = 0; oc0 < s->out_c && rc == HOCS_OK; oc0 += HOCS_CONV_FFT_BATCH) {
+                uint32_t nb = (s->out_c - oc0 < HOCS_CONV_FFT_BATCH) ? s->out_c - oc0 : HOCS_CONV_FFT_BATCH;
+                for (uint32_t i = 0; i < nb; i++) {
+                    fft_mac(c, c->wspec + (size_t)(oc0 + i) * s->in_c * 2 * nn,
+                            c->pspec + (size_t)(oc0 + i) * 2 * nn);
+                }
+                rc = fft_inverse(c, c->pspec + (size_t)oc0 * 2 * nn, tiles, nb);
+                for (uint32_t i = 0; i < nb && rc == HOCS_OK; i++) {
+                    float *plane = out + (size_t)(oc0 + i) * c->out_h * c->out_w;
+                    for (uint32_t r = 0; r < c->step && oy0 + r < c->out_h; r++) {
+                        uint32_t w = (c->out_w - ox0 < c->step) ? c->out_w - ox0 : c->step;
+                        conv_copy(plane + (size_t)(oy0 + r) * c->out_w + ox0, tiles + (size_t)i * nn + r * n, w);
+                    }
+                }
+            }
+        }
+    }
+    return rc;
+}
+
+/*
+ * ======================================================================================
+ * PUBLIC INTERFACE
+ * ======================================================================================
+ */
+
+/*
+ * hocs_conv_plan
+ * Chooses the lowering (HOCS_CONV_AUTO) or takes the one given, and
+ * prepares it: W tiles or kernel spectra, staging memory, DFT matrices.
+ * 'w' (OIHW) is not referenced after this returns.
+ */
+int hocs_conv_plan(hocs_conv_t *c, hocs_device_t *dev, const hocs_conv_shape_t *s,
+                   const float *w, uint32_t method) {
+    uint8_t *p = (uint8_t *)c;
+    int auto_pick = 0;
+    int rc;
+
+    /* A K tile holds whole kx runs, so one run must fit the array */
+    if (s->in_c == 0 || s->out_c == 0 || s->k == 0 || s->k > HOCS_MAX_DIM || s->stride == 0 ||
+        s->in_h + 2 * s->pad < s->k || s->in_w + 2 * s->pad < s->k || w == NULL) {
+        return HOCS_ERR_INVALID;
+    }
+
+    for (uint64_t i = 0; i < sizeof(*c); i++) {
+        p[i] = 0;
+    }
+    c->s = *s;
+    c->dev = dev;
+    c->out_h = (s->in_h + 2 * s->pad - s->k) / s->stride + 1;
+    c->out_w = (s->in_w + 2 * s->pad - s->k) / s->stride + 1;
+
+    /* 1. Cost of each lowering */
+    im2col_geometry(c);
+    c->est_ns[HOCS_CONV_IM2COL] = im2col_estimate(c);
+    c->fn = fft_size(c, &c->est_ns[HOCS_CONV_FFT]);
+
+    if (method == HOCS_CONV_AUTO) {
+        auto_pick = 1;
+        method = (c->fn && c->est_ns[HOCS_CONV_FFT] < c->est_ns[HOCS_CONV_IM2COL]) ?
+                 HOCS_CONV_FFT : HOCS_CONV_IM2COL;
+    }
+    if (method == HOCS_CONV_FFT && c->fn == 0) {
+        return HOCS_ERR_INVALID;
+    }
+    c->method = method;
+
+    /* 2. Prepare it (an automatic FFT pick that cannot be set up falls back to im2col) */
+    rc = (method == HOCS_CONV_FFT) ? fft_plan(c, w) : im2col_plan(c, w);
+    if (rc != HOCS_OK && auto_pick && method == HOCS_CONV_FFT) {
+        hocs_conv_free(c);
+        c->method = HOCS_CONV_IM2COL;
+        rc = im2col_plan(c, w);
+    }
+    if (rc != HOCS_OK) {
+        hocs_conv_free(c);
+    }
+    return rc;
+}
+
+/*
+ * hocs_conv_run
+ * out (OC x out_h x out_w) = conv2d(in (IC x in_h x in_w)). Synchronous.
+ */
+int hocs_conv_run(hocs_conv_t *c, const float *in, float *out) {
+    if (c->nmem == 0 || in == NULL || out == NULL) {
+        return HOCS_ERR_INVALID;
+    }
+    return (c->method == HOCS_CONV_FFT) ? fft_run(c, in, out) : im2col_run(c, in, out);
+}
+
+/*
+ * hocs_conv_reference
+ * Direct convolution on the CPU, for checking.
+ */
+void hocs_conv_reference(const hocs_conv_shape_t *s, const float *in, const float *w, float *out) {
+    const uint32_t oh = (s->in_h + 2 * s->pad - s->k) / s->stride + 1;
+    const uint32_t ow = (s->in_w + 2 * s->pad - s->k) / s->stride + 1;
+
+    for (uint32_t oc = 0; oc < s->out_c; oc++) {
+        for (uint32_t oy = 0; oy < oh; oy++) {
+            for (uint32_t ox = 0; ox < ow; ox++) {
+                float acc = 0.0f;
+                for (uint32_t ic = 0; ic < s->in_c; ic++) {
+                    for (uint32_t ky = 0; ky < s->k; ky++) {
+                        int32_t iy = (int32_t)(oy * s->stride + ky) - (int32_t)s->pad;
+                        if (iy < 0 || iy >= (int32_t)s->in_h) continue;
+                        for (uint32_t kx = 0; kx < s->k; kx++) {
+                            int32_t ix = (int32_t)(ox * s->stride + kx) - (int32_t)s->pad;
+                            if (ix < 0 || ix >= (int32_t)s->in_w) continue;
+                            acc += in[((size_t)ic * s->in_h + (uint32_t)iy) * s->in_w + (uint32_t)ix] *
+                                   w[(((size_t)oc * s->in_c + ic) * s->k + ky) * s->k + kx];
+                        }
+                    }
+                }
+                out[((size_t)oc * oh + oy) * ow + ox] = acc;
+            }
+        }
+    }
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK: CONV2D LAYERS ON THE HOCS MODEL
+ * ======================================================================================
+ * 1. Check: small layers through both lowerings on a functional model
+ *    (virtual time), against hocs_conv_reference().
+ * 2. Speed: standard layer shapes on a timing-only model running on the
+ *    system counter, so CPU work (extraction, accumulation, per-bin
+ *    products) and modelled IP time add up as they would on the board.
+ *    GOPS counts 2 * OC * OH * OW * IC * k * k operations per layer.
+ */
+
+typedef struct {
+    const char *name;
+    hocs_conv_shape_t s;
+} bench_layer_t;
+
+static const bench_layer_t bench_check[] = {
+    { "3x3 3->8",          { 3, 16, 16, 8, 3, 1, 1 } },
+    { "3x3 40->300",       { 40, 10, 10, 300, 3, 1, 1 } },    // 2 K tiles, 2 OC tiles
+    { "7x7 4->6",          { 4, 20, 20, 6, 7, 1, 3 } },
+    { "3x3/2 8->16",       { 8, 15, 15, 16, 3, 2, 1 } },
+};
+
+static const bench_layer_t bench_speed[] = {
+    { "conv1 7x7/2 3->64 @224", { 3, 224, 224, 64, 7, 2, 3 } },
+    { "3x3 64->64 @56",         { 64, 56, 56, 64, 3, 1, 1 } },
+    { "3x3 128->128 @28",       { 128, 28, 28, 128, 3, 1, 1 } },
+    { "3x3 256->256 @14",       { 256, 14, 14, 256, 3, 1, 1 } },
+    { "1x1 256->64 @56",        { 256, 56, 56, 64, 1, 1, 0 } },
+    { "11x11 16->16 @64",       { 16, 64, 64, 16, 11, 1, 5 } },
+};
+
+#define BENCH_COUNT(a)          (sizeof(a) / sizeof((a)[0]))
+
+static hocs_conv_t bench_conv;
+
+static size_t bench_floats(const hocs_conv_shape_t *s, size_t *in_n, size_t *w_n, size_t *out_n) {
+    uint32_t oh = (s->in_h + 2 * s->pad - s->k) / s->stride + 1;
+    uint32_t ow = (s->in_w + 2 * s->pad - s->k) / s->stride + 1;
+
+    *in_n = (size_t)s->in_c * s->in_h * s->in_w;
+    *w_n = (size_t)s->out_c * s->in_c * s->k * s->k;
+    *out_n = (size_t)s->out_c * oh * ow;
+    return *in_n + *w_n + 2 * *out_n;
+}
+
+/* Relative error in 1/1000000 of the largest reference magnitude */
+static uint64_t bench_error_ppm(const float *a, const float *ref, size_t n) {
+    float max_ref = 1e-6f, max_err = 0.0f;
+
+    for (size_t i = 0; i < n; i++) {
+        float r = (ref[i] < 0.0f) ? -ref[i] : ref[i];
+        float e = a[i] - ref[i];
+        e = (e < 0.0f) ? -e : e;
+        if (r > max_ref) max_ref = r;
+        if (e > max_err) max_err = e;
+    }
+    return (uint64_t)(max_err / max_ref * 1e6f);
+}
+
+static void bench_fill(float *p, size_t n, uint32_t seed) {
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245U + 12345U;
+        p[i] = (float)((int32_t)(seed >> 16) % 201 - 100) / 100.0f;
+    }
+}
+
+/*
+ * hocs_conv_benchmark
+ * Reference check, then throughput per layer shape.
+ */
+void hocs_conv_benchmark(void) {
+    size_t most = 0, in_n, w_n, out_n, bytes;
+    hocs_device_t *dev;
+    float *mem;
+
+    for (uint32_t i = 0; i < BENCH_COUNT(bench_speed); i++) {
+        size_t f = bench_floats(&bench_speed[i].s, &in_n, &w_n, &out_n);
+        most = (f > most) ? f : most;
+    }
+    for (uint32_t i = 0; i < BENCH_COUNT(bench_check); i++) {
+        size_t f = bench_floats(&bench_check[i].s, &in_n, &w_n, &out_n);
+        most = (f > most) ? f : most;
+    }
+    bytes = most * sizeof(float);
+    mem = (float *)hocs_buf_alloc(bytes);
+    if (mem == NULL) {
+        kprintf("[HOCS] conv benchmark: out of memory\n");
+        return;
+    }
+
+    /* 1. Reference check */
+    kprintf("[HOCS] conv2d lowering check (functional model):\n");
+    for (uint32_t i = 0; i < BENCH_COUNT(bench_check); i++) {
+        const hocs_conv_shape_t *s = &bench_check[i].s;
+        float *in, *w, *out, *ref;
+
+        bench_floats(s, &in_n, &w_n, &out_n);
+        in = mem;
+        w = in + in_n;
+        out = w + w_n;
+        ref = out + out_n;
+        bench_fill(in, in_n, 1 + i);
+        bench_fill(w, w_n, 100 + i);
+        hocs_conv_reference(s, in, w, ref);
+
+        for (uint32_t m = HOCS_CONV_IM2COL; m <= HOCS_CONV_FFT; m++) {
+            int rc;
+            dev = hocs_bench_init(0, "hocs-bench", hocs_bench_stepped_ns, 1);
+            rc = hocs_conv_plan(&bench_conv, dev, s, w, m);
+            if (rc != HOCS_OK) {
+                continue;           // FFT: stride > 1
+            }
+            rc = hocs_conv_run(&bench_conv, in, out);
+            kprintf("  %s %s: %s, max error %lu ppm\n", bench_check[i].name,
+                    (m == HOCS_CONV_FFT) ? "fft   " : "im2col",
+                    (rc == HOCS_OK) ? "ok" : "FAILED", bench_error_ppm(out, ref, out_n));
+            hocs_conv_free(&bench_conv);
+        }
+    }
+
+    /* 2. Throughput */
+    kprintf("[HOCS] conv2d throughput (timing model, KV260 nominal):\n");
+    for (uint32_t i = 0; i < BENCH_COUNT(bench_speed); i++) {
+        const hocs_conv_shape_t *s = &bench_speed[i].s;
+        uint64_t t0, ns, ops, gops10;
+        float *in, *w, *out;
+
+        bench_floats(s, &in_n, &w_n, &out_n);
+        in = mem;
+        w = in + in_n;
+        out = w + w_n;
+        bench_fill(in, in_n, 7);
+        bench_fill(w, w_n, 9);
+
+        dev = hocs_bench_init(0, "hocs-bench", hocs_bench_real_ns, 0);
+        if (hocs_conv_plan(&bench_conv, dev, s, w, HOCS_CONV_AUTO) != HOCS_OK) {
+            kprintf("  %s: plan failed\n", bench_speed[i].name);
+            continue;
+        }
+        hocs_conv_run(&bench_conv, in, out);        // Weights resident, pages warm
+
+        t0 = timer_get_ticks();
+        hocs_conv_run(&bench_conv, in, out);
+        ns = timer_ticks_to_ns(timer_get_ticks() - t0);
+
+        ops = 2ULL * s->out_c * bench_conv.out_h * bench_conv.out_w * s->in_c * s->k * s->k;
+        gops10 = ops * 10 / (ns ? ns : 1);
+        kprintf("  %s: %s, %lu us (est. im2col %lu us, fft %lu us), %lu.%lu GOPS\n",
+                bench_speed[i].name, (bench_conv.method == HOCS_CONV_FFT) ? "fft" : "im2col",
+                ns / 1000, bench_conv.est_ns[HOCS_CONV_IM2COL] / 1000,
+                bench_conv.est_ns[HOCS_CONV_FFT] / 1000, gops10 / 10, gops10 % 10);
+        hocs_conv_free(&bench_conv);
+    }
+
+    hocs_buf_free(mem, bytes);
+}
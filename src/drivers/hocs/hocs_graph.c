@@ -0,0 +1,783 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_graph.c
+ * Module:      HOCS Job Graph Executor Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Everything that can be decided up front is decided by the compiler:
+ * groups, dependencies, ports, buffers and weight handles. A run is then a
+ * loop of "dispatch what is ready, reap what finished" over at most
+ * HOCS_GRAPH_MAX_NODES heads, on the calling core. Fused epilogues run in
+ * that reap loop; only unfused CPU groups leave core 0.
+ * ======================================================================================
+ */
+
+#include "drivers/hocs_graph.h"
+#include "drivers/hocs_model.h"
+#include "kernel/smp.h"
+#include "kernel/timer_heavy.h"
+#include "lib/kprintf.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+int hocs_graph_init(hocs_graph_t *g, hocs_device_t *const *ports, uint32_t nports) {
+    uint8_t *p = (uint8_t *)g;
+
+    if (nports == 0 || nports > HOCS_GRAPH_MAX_PORTS) {
+        return HOCS_ERR_INVALID;
+    }
+
+    for (uint64_t i = 0; i < sizeof(*g); i++) {
+        p[i] = 0;
+    }
+    for (uint32_t i = 0; i < nports; i++) {
+        g->port[i] = ports[i];
+    }
+    g->nports = nports;
+    return HOCS_OK;
+}
+
+/*
+ * ======================================================================================
+ * GRAPH CONSTRUCTION
+ * ======================================================================================
+ */
+
+static inline int graph_valid(const hocs_graph_t *g, int a) {
+    return a >= 0 && (uint32_t)a < g->nnodes;
+}
+
+static int graph_node(hocs_graph_t *g, uint8_t op, int a, int b) {
+    hocs_graph_node_t *n;
+
+    if (g->compiled || g->nnodes >= HOCS_GRAPH_MAX_NODES) {
+        return HOCS_ERR_INVALID;
+    }
+
+    n = &g->node[g->nnodes];
+    n->op = op;
+    n->kind = HOCS_GROUP_NONE;
+    n->in[0] = a;
+    n->in[1] = b;
+    n->slot = -1;
+    if (a >= 0) {
+        g->node[a].refs++;
+        n->rows = g->node[a].rows;
+        n->cols = g->node[a].cols;
+    }
+    if (b >= 0) {
+        g->node[b].refs++;
+    }
+    return (int)g->nnodes++;
+}
+
+int hocs_graph_input(hocs_graph_t *g, const float *x, uint32_t rows, uint32_t cols) {
+    int id;
+
+    if (x == NULL || rows == 0 || cols == 0) {
+        return HOCS_ERR_INVALID;
+    }
+    id = graph_node(g, HOCS_GOP_INPUT, -1, -1);
+    if (id >= 0) {
+        g->node[id].arg = x;
+        g->node[id].rows = rows;
+        g->node[id].cols = cols;
+    }
+    return id;
+}
+
+/*
+ * hocs_graph_matmul
+ * a (rows x n, rows <= n) times the resident n x n matrix 'w'. 'w' must stay
+ * valid while the graph exists: it is re-registered if evicted.
+ */
+int hocs_graph_matmul(hocs_graph_t *g, int a, const float *w, uint32_t n) {
+    int id;
+
+    if (!graph_valid(g, a) || w == NULL || n == 0 || n > HOCS_MAX_DIM ||
+        g->node[a].cols != n || g->node[a].rows > n) {
+        return HOCS_ERR_INVALID;
+    }
+    id = graph_node(g, HOCS_GOP_MATMUL, a, -1);
+    if (id >= 0) {
+        g->node[id].arg = w;
+    }
+    return id;
+}
+
+int hocs_graph_bias(hocs_graph_t *g, int a, const float *b) {
+    int id;
+
+    if (!graph_valid(g, a) || b == NULL) {
+        return HOCS_ERR_INVALID;
+    }
+    id = graph_node(g, HOCS_GOP_BIAS, a, -1);
+    if (id >= 0) {
+        g->node[id].arg = b;
+    }
+    return id;
+}
+
+int hocs_graph_relu(hocs_graph_t *g, int a) {
+    if (!graph_valid(g, a)) {
+        return HOCS_ERR_INVALID;
+    }
+    return graph_node(g, HOCS_GOP_RELU, a, -1);
+}
+
+int hocs_graph_add(hocs_graph_t *g, int a, int b) {
+    if (!graph_valid(g, a) || !graph_valid(g, b) ||
+        g->node[a].rows != g->node[b].rows || g->node[a].cols != g->node[b].cols) {
+        return HOCS_ERR_INVALID;
+    }
+    return graph_node(g, HOCS_GOP_ADD, a, b);
+}
+
+/*
+ * hocs_graph_output
+ * Has the run leave node 'a' in 'dst' (rows x cols floats). The group
+ * computing it writes there directly, so nothing is copied.
+ */
+int hocs_graph_output(hocs_graph_t *g, int a, float *dst) {
+    if (g->compiled || !graph_valid(g, a) || dst == NULL ||
+        g->node[a].op == HOCS_GOP_INPUT || g->node[a].out != NULL) {
+        return HOCS_ERR_INVALID;
+    }
+    g->node[a].out = dst;
+    g->node[a].refs++;              // Keeps later ops from overwriting it in place
+    return a;
+}
+
+/*
+ * ======================================================================================
+ * COMPILATION
+ * ======================================================================================
+ */
+
+static int graph_dep(hocs_graph_node_t *h, const hocs_graph_t *g, int32_t on) {
+    on = g->node[on].group;
+    if (g->node[on].kind == HOCS_GROUP_INPUT) {
+        return HOCS_OK;
+    }
+    for (uint32_t i = 0; i < h->ndeps; i++) {
+        if (h->dep[i] == on) return HOCS_OK;
+    }
+    if (h->ndeps >= HOCS_GRAPH_MAX_DEPS) {
+        return HOCS_ERR_INVALID;
+    }
+    h->dep[h->ndeps++] = on;
+    return HOCS_OK;
+}
+
+/*
+ * graph_fuse
+ * Appends elementwise node 'id' to the group producing its first (or, for
+ * ADD, either) operand, if that group is its operand's only consumer.
+ */
+static int graph_fuse(hocs_graph_t *g, int id) {
+    hocs_graph_node_t *n = &g->node[id];
+    uint32_t ncand = (n->op == HOCS_GOP_ADD) ? 2 : 1;
+
+    for (uint32_t k = 0; k < ncand; k++) {
+        int32_t s = n->in[k], other = n->in[k ^ 1];
+        hocs_graph_node_t *h = &g->node[g->node[s].group];
+
+        if (h->kind == HOCS_GROUP_INPUT || g->node[s].refs != 1 || h->tail != s ||
+            h->nepi >= HOCS_GRAPH_MAX_EPI) {
+            continue;
+        }
+        if (n->op == HOCS_GOP_ADD) {
+            if (g->node[other].group == g->node[s].group || graph_dep(h, g, other) != HOCS_OK) {
+                continue;
+            }
+        }
+
+        h->epi[h->nepi].op = n->op;
+        h->epi[h->nepi].vec = n->arg;
+        h->epi[h->nepi].other = (n->op == HOCS_GOP_ADD) ? other : -1;
+        h->nepi++;
+        h->tail = id;
+        n->group = g->node[s].group;
+        g->fused++;
+        return 1;
+    }
+    return 0;
+}
+
+/* Makes 'id' the head of a new group */
+static int graph_head(hocs_graph_t *g, int id, uint8_t kind) {
+    hocs_graph_node_t *n = &g->node[id];
+
+    n->kind = kind;
+    n->group = id;
+    n->tail = id;
+    g->groups++;
+
+    if (kind == HOCS_GROUP_CPU) {
+        /* The op itself is the first epilogue step, reading its input */
+        n->epi[0].op = n->op;
+        n->epi[0].vec = n->arg;
+        n->epi[0].other = (n->op == HOCS_GOP_ADD) ? n->in[1] : -1;
+        n->nepi = 1;
+    }
+    if (n->in[0] >= 0 && graph_dep(n, g, n->in[0]) != HOCS_OK) {
+        return HOCS_ERR_INVALID;
+    }
+    if (n->in[1] >= 0 && graph_dep(n, g, n->in[1]) != HOCS_OK) {
+        return HOCS_ERR_INVALID;
+    }
+    return HOCS_OK;
+}
+
+static int graph_depends(const hocs_graph_node_t *h, int32_t on) {
+    for (uint32_t i = 0; i < h->ndeps; i++) {
+        if (h->dep[i] == on) return 1;
+    }
+    return 0;
+}
+
+/*
+ * graph_buffers
+ * Gives every group without a user buffer a pool slot. A slot is reused
+ * by the same port once every reader of its previous value comes earlier
+ * in topological order; the new writer then waits for those readers (and
+ * the previous writer), so reuse holds under any dispatch order. Slots are
+ * never shared between ports, which would serialize independent chains.
+ */
+static int graph_buffers(hocs_graph_t *g) {
+    int32_t occupant[HOCS_GRAPH_MAX_BUFS];
+    int32_t last_reader[HOCS_GRAPH_MAX_NODES];
+
+    /* 1. Liveness: last group (in order) reading each group's value */
+    for (uint32_t i = 0; i < g->nnodes; i++) {
+        last_reader[i] = -1;
+        for (uint32_t k = 0; k < g->node[i].ndeps; k++) {
+            last_reader[g->node[i].dep[k]] = (int32_t)i;
+        }
+    }
+
+    /* 2. Slot assignment */
+    for (uint32_t i = 0; i < g->nnodes; i++) {
+        hocs_graph_node_t *h = &g->node[i];
+        size_t bytes = ((size_t)h->rows * h->cols * sizeof(float) + 63) & ~(size_t)63;
+        int32_t s = -1;
+
+        if (h->kind != HOCS_GROUP_HOCS && h->kind != HOCS_GROUP_CPU) {
+            continue;
+        }
+        if (g->node[h->tail].out != NULL) {
+            h->buf = g->node[h->tail].out;
+            continue;
+        }
+
+        for (uint32_t k = 0; k < g->npool && s < 0; k++) {
+            if (g->node[occupant[k]].port == h->port && last_reader[occupant[k]] < (int32_t)i) {
+                s = (int32_t)k;
+            }
+        }
+        if (s < 0) {
+            if (g->npool >= HOCS_GRAPH_MAX_BUFS) {
+                return HOCS_ERR_INVALID;
+            }
+            s = (int32_t)g->npool++;
+        } else {
+            /* WAR/WAW: wait for the previous value's readers and writer */
+            for (uint32_t r = 0; r < i; r++) {
+                if (graph_depends(&g->node[r], occupant[s]) &&
+                    graph_dep(h, g, (int32_t)r) != HOCS_OK) {
+                    return HOCS_ERR_INVALID;
+                }
+            }
+            if (graph_dep(h, g, occupant[s]) != HOCS_OK) {
+                return HOCS_ERR_INVALID;
+            }
+        }
+
+        occupant[s] = (int32_t)i;
+        h->slot = s;
+        if (bytes > g->pool[s].size) {
+            g->pool[s].size = bytes;
+        }
+    }
+
+    /* 3. Memory, homed on the slot's port */
+    for (uint32_t k = 0; k < g->npool; k++) {
+        for (uint32_t i = 0; i < g->nnodes && g->pool[k].mem == NULL; i++) {
+            if (g->node[i].slot == (int32_t)k) {
+                g->pool[k].mem = (float *)hocs_buf_alloc_on(g->port[g->node[i].port], g->pool[k].size);
+                if (g->pool[k].mem == NULL) {
+                    return HOCS_ERR_INVALID;
+                }
+            }
+        }
+    }
+    for (uint32_t i = 0; i < g->nnodes; i++) {
+        if (g->node[i].slot >= 0) {
+            g->node[i].buf = g->pool[g->node[i].slot].mem;
+        }
+    }
+    return HOCS_OK;
+}
+
+/*
+ * hocs_graph_compile
+ * Fuses, schedules and allocates. The graph is frozen afterwards. A graph
+ * that fails to compile is released and must be built again.
+ */
+int hocs_graph_compile(hocs_graph_t *g) {
+    uint32_t rr = 0;
+    int rc = HOCS_OK;
+
+    if (g->compiled || g->nnodes == 0) {
+        return HOCS_ERR_INVALID;
+    }
+
+    /* 1. Groups (insertion order is topological) */
+    for (uint32_t i = 0; i < g->nnodes && rc == HOCS_OK; i++) {
+        switch (g->node[i].op) {
+            case HOCS_GOP_INPUT:
+                rc = graph_head(g, (int)i, HOCS_GROUP_INPUT);
+                break;
+            case HOCS_GOP_MATMUL:
+                rc = graph_head(g, (int)i, HOCS_GROUP_HOCS);
+                break;
+            default:
+                if (!graph_fuse(g, (int)i)) {
+                    rc = graph_head(g, (int)i, HOCS_GROUP_CPU);
+                }
+                break;
+        }
+    }
+    if (rc != HOCS_OK) {
+        hocs_graph_destroy(g);
+        return rc;
+    }
+
+    /* 2. Ports: every input starts a chain on the next port, successors follow */
+    for (uint32_t i = 0; i < g->nnodes; i++) {
+        hocs_graph_node_t *h = &g->node[i];
+        if (h->kind == HOCS_GROUP_INPUT) {
+            h->port = rr++ % g->nports;
+            h->buf = (float *)(uintptr_t)h->arg;
+        } else if (h->kind != HOCS_GROUP_NONE) {
+            h->port = g->node[g->node[h->in[0]].group].port;
+        }
+    }
+
+    /* 3. Buffers */
+    rc = graph_buffers(g);
+    if (rc != HOCS_OK) {
+        hocs_graph_destroy(g);
+        return rc;
+    }
+
+    /* 4. Operand pointers, now that every group has its buffer */
+    for (uint32_t i = 0; i < g->nnodes; i++) {
+        hocs_graph_node_t *h = &g->node[i];
+        if (h->kind != HOCS_GROUP_HOCS && h->kind != HOCS_GROUP_CPU) {
+            continue;
+        }
+        h->src = (h->kind == HOCS_GROUP_HOCS) ? h->buf : g->node[g->node[h->in[0]].group].buf;
+        for (uint32_t k = 0; k < h->nepi; k++) {
+            if (h->epi[k].op == HOCS_GOP_ADD) {
+                h->epi[k].vec = g->node[g->node[h->epi[k].other].group].buf;
+            }
+        }
+    }
+
+    /* 5. Weights */
+    for (uint32_t i = 0; i < g->nnodes && rc == HOCS_OK; i++) {
+        hocs_graph_node_t *h = &g->node[i];
+        if (h->kind == HOCS_GROUP_HOCS) {
+            rc = hocs_weights_register(g->port[h->port], h->arg, h->cols, &h->handle);
+        }
+    }
+    if (rc != HOCS_OK) {
+        hocs_graph_destroy(g);
+        return rc;
+    }
+
+    g->compiled = 1;
+    return HOCS_OK;
+}
+
+/*
+ * hocs_graph_destroy
+ * Releases the buffer pool. The graph must not be running.
+ */
+void hocs_graph_destroy(hocs_graph_t *g) {
+    for (uint32_t k = 0; k < g->npool; k++) {
+        hocs_buf_free(g->pool[k].mem, g->pool[k].size);
+        g->pool[k].mem = NULL;
+        g->pool[k].size = 0;
+    }
+    g->npool = 0;
+    g->nnodes = 0;
+    g->compiled = 0;
+}
+
+/*
+ * ======================================================================================
+ * EXECUTION
+ * ======================================================================================
+ */
+
+/* One op over one row: d = s + v (BIAS, ADD) or d = max(s, 0) (RELU) */
+static inline void graph_row(uint8_t op, const float *s, const float *v, float *d, uint32_t n) {
+    uint32_t c = 0;
+
+#if defined(__ARM_NEON)
+    if (op == HOCS_GOP_RELU) {
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        for (; c + 4 <= n; c += 4) {
+            vst1q_f32(d + c, vmaxq_f32(vld1q_f32(s + c), zero));
+        }
+    } else {
+        for (; c + 4 <= n; c += 4) {
+            vst1q_f32(d + c, vaddq_f32(vld1q_f32(s + c), vld1q_f32(v + c)));
+        }
+    }
+#endif
+    if (op == HOCS_GOP_RELU) {
+        for (; c < n; c++) d[c] = (s[c] > 0.0f) ? s[c] : 0.0f;
+    } else {
+        for (; c < n; c++) d[c] = s[c] + v[c];
+    }
+}
+
+/*
+ * graph_apply
+ * dst = epi[n-1](...epi[0](src)), a row at a time: the first op reads the
+ * row from src, the rest rework it in L1, so the value crosses DDR once
+ * each way whatever the number of fused ops. For HOCS groups src == dst.
+ */
+static void graph_apply(const hocs_graph_node_t *h) {
+    const uint32_t cols = h->cols;
+
+    for (uint32_t r = 0; r < h->rows; r++) {
+        const float *s = h->src + (size_t)r * cols;
+        float *d = h->buf + (size_t)r * cols;
+
+        for (uint32_t k = 0; k < h->nepi; k++) {
+            const hocs_graph_epi_t *e = &h->epi[k];
+            const float *v = (e->op == HOCS_GOP_ADD) ? e->vec + (size_t)r * cols : e->vec;
+            graph_row(e->op, s, v, d, cols);
+            s = d;
+        }
+    }
+}
+
+static void graph_cpu_entry(void *arg) {
+    graph_apply((const hocs_graph_node_t *)arg);
+}
+
+static int graph_ready(const hocs_graph_t *g, const hocs_graph_node_t *h) {
+    for (uint32_t i = 0; i < h->ndeps; i++) {
+        if (g->node[h->dep[i]].state != HOCS_GROUP_DONE) return 0;
+    }
+    return 1;
+}
+
+/*
+ * graph_start
+ * Dispatches a ready group. HOCS_ERR_BUSY: try again after the next reap.
+ */
+static int graph_start(hocs_graph_t *g, hocs_graph_node_t *h) {
+    hocs_device_t *dev = g->port[h->port];
+    int rc;
+
+    if (h->kind == HOCS_GROUP_CPU) {
+        for (uint32_t core = 1; core < SMP_MAX_CORES; core++) {
+            if (smp_run_on(core, graph_cpu_entry, h) == 0) {
+                h->core = core;
+                h->state = HOCS_GROUP_RUNNING;
+                g->cpu_offloads++;
+                return HOCS_OK;
+            }
+        }
+        graph_apply(h);
+        h->state = HOCS_GROUP_DONE;
+        return HOCS_OK;
+    }
+
+    /* 1. Weights still resident on the port? */
+    if (!hocs_weights_resident(dev, h->handle)) {
+        rc = hocs_weights_register(dev, h->arg, h->cols, &h->handle);
+        if (rc != HOCS_OK) {
+            return rc;
+        }
+        g->weight_reloads++;
+    }
+
+    /* 2. Rows of the input against them */
+    h->job.src_addr = (uint64_t)(uintptr_t)g->node[g->node[h->in[0]].group].buf;
+    h->job.dst_addr = (uint64_t)(uintptr_t)h->buf;
+    h->job.matrix_dim = h->cols;
+    h->job.flags = 0;
+    h->job.done = NULL;
+    h->job.ctx = NULL;
+    h->job.scratch = NULL;
+    h->job.weights = h->handle;
+    h->job.rows = h->rows;
+
+    rc = hocs_submit(dev, &h->job);
+    if (rc == HOCS_OK) {
+        h->state = HOCS_GROUP_RUNNING;
+        g->hocs_jobs++;
+    }
+    return rc;
+}
+
+/*
+ * graph_reap
+ * Retires finished groups; runs the fused epilogue of each completed job.
+ */
+static int graph_reap(hocs_graph_node_t *h) {
+    if (h->kind == HOCS_GROUP_CPU) {
+        if (smp_core_busy(h->core)) {
+            return HOCS_OK;
+        }
+        asm volatile("dmb ish" ::: "memory");   // Its stores before our loads
+        h->state = HOCS_GROUP_DONE;
+        return HOCS_OK;
+    }
+
+    if (h->job.state == HOCS_JOB_QUEUED) {
+        return HOCS_OK;
+    }
+    h->state = HOCS_GROUP_DONE;
+    if (h->job.state != HOCS_JOB_DONE) {
+        return HOCS_ERR_HW;
+    }
+    if (h->nepi) {
+        graph_apply(h);
+    }
+    return HOCS_OK;
+}
+
+/*
+ * hocs_graph_run
+ * Runs a compiled graph to completion. On an error nothing new is
+ * dispatched and the call returns once the groups in flight are done.
+ * On HOCS_ERR_TIMEOUT jobs may still be in flight: the graph must not be
+ * run again or destroyed until the ports are idle.
+ */
+int hocs_graph_run(hocs_graph_t *g, uint64_t timeout_us) {
+    uint64_t start = timer_get_ticks();
+    uint32_t pending, running;
+    int rc = HOCS_OK;
+
+    if (!g->compiled) {
+        return HOCS_ERR_INVALID;
+    }
+
+    for (uint32_t i = 0; i < g->nnodes; i++) {
+        g->node[i].state = (g->node[i].kind == HOCS_GROUP_INPUT) ? HOCS_GROUP_DONE : HOCS_GROUP_IDLE;
+        g->node[i].core = 0;
+    }
+
+    for (;;) {
+        pending = 0;
+        running = 0;
+
+        /* 1. Dispatch everything whose inputs are ready */
+        for (uint32_t i = 0; i < g->nnodes; i++) {
+            hocs_graph_node_t *h = &g->node[i];
+            int err;
+
+            if (h->kind == HOCS_GROUP_NONE || h->kind == HOCS_GROUP_INPUT) {
+                continue;
+            }
+            if (h->state == HOCS_GROUP_IDLE && rc == HOCS_OK && graph_ready(g, h)) {
+                err = graph_start(g, h);
+                if (err != HOCS_OK && err != HOCS_ERR_BUSY) {
+                    rc = err;
+                }
+            }
+            if (h->state != HOCS_GROUP_DONE) pending++;
+            if (h->state == HOCS_GROUP_RUNNING) running++;
+        }
+        if (pending == 0 || (rc != HOCS_OK && running == 0)) {
+            break;
+        }
+
+        /* 2. Reap */
+        for (uint32_t p = 0; p < g->nports; p++) {
+            hocs_poll(g->port[p], HOCS_RING_ENTRIES);
+        }
+        for (uint32_t i = 0; i < g->nnodes; i++) {
+            hocs_graph_node_t *h = &g->node[i];
+            if (h->state == HOCS_GROUP_RUNNING && (h->kind == HOCS_GROUP_HOCS || h->core)) {
+                int err = graph_reap(h);
+                if (err != HOCS_OK && rc == HOCS_OK) {
+                    rc = err;
+                }
+            }
+        }
+
+        if (timeout_us && timer_ticks_to_us(timer_get_ticks() - start) > timeout_us) {
+            return HOCS_ERR_TIMEOUT;
+        }
+    }
+
+    g->runs++;
+    return rc;
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK: MLP, FUSED GRAPH vs. SEQUENTIAL SUBMISSION (HOCS MODEL, REAL TIME)
+ * ======================================================================================
+ * BENCH_LAYERS x (matmul -> bias -> relu) on BENCH_ROWS activation rows.
+ * The models run on the system counter, so CPU passes and HOCS jobs
+ * overlap exactly as much as the executor lets them. The models are not
+ * functional: the time a real IP spends is modelled, the CPU work is real.
+ *
+ * sequential: one job per matmul, waited for; bias and relu as separate
+ *             passes into fresh buffers (every stage a round trip)
+ * graph:      bias + relu fused into one in-place pass per layer, pooled
+ *             intermediates; the batch as one chain, then as two
+ *             independent half-batches on the two ports
+ */
+
+#define BENCH_DIM               HOCS_MAX_DIM
+#define BENCH_ROWS              128
+#define BENCH_LAYERS            3
+#define BENCH_RUNS              64
+
+static hocs_device_t *bench_ports[HOCS_GRAPH_MAX_PORTS];
+static hocs_graph_t bench_graph;
+static hocs_job_t bench_job;
+
+static void bench_reset(void) {
+    static const char *const names[HOCS_GRAPH_MAX_PORTS] = { "hocs-bench0", "hocs-bench1" };
+
+    for (uint32_t i = 0; i < HOCS_GRAPH_MAX_PORTS; i++) {
+        bench_ports[i] = hocs_bench_init(i, names[i], hocs_bench_real_ns, 0);
+    }
+}
+
+static void bench_pass(const float *src, float *dst, const float *bias, uint32_t rows) {
+    for (uint32_t i = 0; i < rows * BENCH_DIM; i++) {
+        dst[i] = bias ? src[i] + bias[i % BENCH_DIM] : ((src[i] > 0.0f) ? src[i] : 0.0f);
+    }
+}
+
+static uint64_t bench_sequential(const float *x, float *const *w, const float *const *b, float *tmp) {
+    const uint32_t nn = BENCH_ROWS * BENCH_DIM;
+    uint32_t handle[BENCH_LAYERS];
+    uint64_t t0;
+
+    bench_reset();
+    for (uint32_t l = 0; l < BENCH_LAYERS; l++) {
+        hocs_weights_register(bench_ports[0], w[l], BENCH_DIM, &handle[l]);
+    }
+
+    t0 = timer_get_ticks();
+    for (uint32_t r = 0; r < BENCH_RUNS; r++) {
+        const float *in = x;
+        for (uint32_t l = 0; l < BENCH_LAYERS; l++) {
+            float *mm = tmp + (3 * l) * nn, *biased = mm + nn, *act = biased + nn;
+
+            bench_job.src_addr = (uint64_t)(uintptr_t)in;
+            bench_job.dst_addr = (uint64_t)(uintptr_t)mm;
+            bench_job.matrix_dim = BENCH_DIM;
+            bench_job.flags = 0;
+            bench_job.done = NULL;
+            bench_job.scratch = NULL;
+            bench_job.weights = handle[l];
+            bench_job.rows = BENCH_ROWS;
+            hocs_submit(bench_ports[0], &bench_job);
+            hocs_wait(bench_ports[0], &bench_job, 0);
+
+            bench_pass(mm, biased, b[l], BENCH_ROWS);
+            bench_pass(biased, act, NULL, BENCH_ROWS);
+            in = act;
+        }
+    }
+    return timer_ticks_to_us(timer_get_ticks() - t0);
+}
+
+static uint64_t bench_graph_run(uint32_t branches, const float *x, float *const *w,
+                                const float *const *b, float *y) {
+    const uint32_t rows = BENCH_ROWS / branches;
+    uint64_t t0, us;
+
+    bench_reset();
+    hocs_graph_init(&bench_graph, bench_ports, HOCS_GRAPH_MAX_PORTS);
+    for (uint32_t k = 0; k < branches; k++) {
+        int v = hocs_graph_input(&bench_graph, x + k * rows * BENCH_DIM, rows, BENCH_DIM);
+        for (uint32_t l = 0; l < BENCH_LAYERS; l++) {
+            v = hocs_graph_matmul(&bench_graph, v, w[l], BENCH_DIM);
+            v = hocs_graph_bias(&bench_graph, v, b[l]);
+            v = hocs_graph_relu(&bench_graph, v);
+        }
+        hocs_graph_output(&bench_graph, v, y + k * rows * BENCH_DIM);
+    }
+    if (hocs_graph_compile(&bench_graph) != HOCS_OK) {
+        kprintf("[HOCS] graph benchmark: compile failed\n");
+        return 0;
+    }
+
+    t0 = timer_get_ticks();
+    for (uint32_t r = 0; r < BENCH_RUNS; r++) {
+        hocs_graph_run(&bench_graph, 0);
+    }
+    us = timer_ticks_to_us(timer_get_ticks() - t0);
+
+    kprintf("  graph, %u branch(es): %lu us/batch (%u groups, %u ops fused, %u buffers)\n",
+            branches, us / BENCH_RUNS, bench_graph.groups, bench_graph.fused, bench_graph.npool);
+    hocs_graph_destroy(&bench_graph);
+    return us;
+}
+
+/*
+ * hocs_graph_benchmark
+ * BENCH_RUNS batches through a BENCH_LAYERS-layer MLP.
+ */
+void hocs_graph_benchmark(void) {
+    const uint32_t nn = BENCH_ROWS * BENCH_DIM;
+    size_t bytes = (size_t)(3 * BENCH_LAYERS + 2) * nn * sizeof(float) +
+                   (size_t)BENCH_LAYERS * (BENCH_DIM * BENCH_DIM + BENCH_DIM) * sizeof(float);
+    float *mem = (float *)hocs_buf_alloc(bytes);
+    float *w[BENCH_LAYERS];
+    const float *b[BENCH_LAYERS];
+    float *x, *y, *tmp, *p;
+    uint64_t seq, one, two;
+
+    if (mem == NULL) {
+        kprintf("[HOCS] graph benchmark: out of memory\n");
+        return;
+    }
+    for (uint32_t i = 0; i < bytes / sizeof(float); i++) {
+        mem[i] = (float)((int32_t)(i % 17) - 8) * 0.125f;
+    }
+
+    x = mem;
+    y = x + nn;
+    tmp = y + nn;
+    p = tmp + 3 * BENCH_LAYERS * nn;
+    for (uint32_t l = 0; l < BENCH_LAYERS; l++) {
+        w[l] = p;
+        b[l] = p + BENCH_DIM * BENCH_DIM;
+        p += BENCH_DIM * BENCH_DIM + BENCH_DIM;
+    }
+
+    kprintf("[HOCS] Graph benchmark: %u-layer MLP, %u x %u, %u batches\n",
+            BENCH_LAYERS, BENCH_ROWS, BENCH_DIM, BENCH_RUNS);
+    seq = bench_sequential(x, w, b, tmp);
+    kprintf("  sequential:           %lu us/batch\n", seq / BENCH_RUNS);
+    one = bench_graph_run(1, x, w, b, y);
+    two = bench_graph_run(2, x, w, b, y);
+    if (one && two) {
+        kprintf("  speedup: %lu%% fused, %lu%% fused + 2 branches\n",
+                seq * 100 / one, seq * 100 / two);
+    }
+
+    hocs_buf_free(mem, bytes);
+}
@@ -0,0 +1,579 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_lincal.c
+ * Module:      HOCS Result Linearity Calibration Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Correction of one value y in column j:
+ *   t    = (y - lo[j]) * inv_step[j]
+ *   seg  = clamp(trunc(t), 0, SEGS - 1)
+ *   x    = lut[base[j] + seg].start + lut[...].rise * (t - seg)
+ * Values outside the calibrated range extrapolate along the end segments.
+ * The NEON path does four columns at a time; the table entries are
+ * gathered with one 64-bit load per lane. The whole table is 18 KB, so it
+ * stays in L1 while results stream through.
+ * ======================================================================================
+ */
+
+#include "drivers/hocs_lincal.h"
+#include "drivers/hocs_model.h"
+#include "drivers/hocs_quant.h"
+#include "kernel/irq_prio.h"
+#include "kernel/timer_heavy.h"
+#include "lib/kprintf.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define LC_CHANNELS             HOCS_NUM_CHANNELS
+#define LC_LEVELS               HOCS_LINCAL_LEVELS
+
+static inline float lc_abs(float v) {
+    return (v < 0.0f) ? -v : v;
+}
+
+static inline int32_t lc_temp_mc(hocs_device_t *dev, uint32_t zone) {
+    return (int32_t)hocs_rd(dev, zone ? HOCS_TEMP_SENSOR_2_OFFSET : HOCS_TEMP_SENSOR_1_OFFSET);
+}
+
+/* Reference level i: evenly spaced over +-full scale */
+static inline float lc_level(uint32_t i) {
+    return HOCS_LINCAL_FULL_SCALE * (2.0f * (float)i / (float)(LC_LEVELS - 1) - 1.0f);
+}
+
+static inline float lc_correct(const hocs_lincal_t *lc, uint32_t col, float y) {
+    float t = (y - lc->lo[col]) * lc->inv_step[col];
+    float c = (t < 0.0f) ? 0.0f : (t > HOCS_LINCAL_SEGS - 1) ? HOCS_LINCAL_SEGS - 1 : t;
+    uint32_t seg = (uint32_t)c;
+    const float *e = lc->lut[lc->base[col] + seg];
+
+    return e[0] + e[1] * (t - (float)seg);
+}
+
+/*
+ * lc_reap
+ * Thread-side reap. The HOCS IRQ and the moderation poll tick reap the
+ * same ring and hocs_poll() is not reentrant, so every line stays masked
+ * for the duration of one pass (not for a whole wait).
+ */
+static void lc_reap(hocs_device_t *dev) {
+    uint32_t irq = irq_prio_save_and_raise(IRQ_PRIO_CEIL_ALL);
+
+    hocs_poll(dev, HOCS_RING_ENTRIES);
+    irq_prio_restore(irq);
+}
+
+/* hocs_wait() with lc_reap(): whichever side reaps 'job', this sees it */
+static int lc_wait(hocs_device_t *dev, hocs_job_t *job) {
+    uint64_t start = timer_get_ticks();
+
+    while (job->state == HOCS_JOB_QUEUED) {
+        lc_reap(dev);
+        if (timer_ticks_to_us(timer_get_ticks() - start) > HOCS_LINCAL_TIMEOUT_US) {
+            return HOCS_ERR_TIMEOUT;
+        }
+    }
+    return (job->state == HOCS_JOB_DONE) ? HOCS_OK : HOCS_ERR_HW;
+}
+
+/*
+ * lc_fit_channel
+ * Inverts one channel's measured response y[i] (for level i) into its
+ * LUT, uniform in y. Also fits the linear gain/offset for reporting.
+ */
+static void lc_fit_channel(hocs_lincal_t *lc, uint32_t ch, const float *y) {
+    float *e = lc->lut[ch * HOCS_LINCAL_SEGS];
+    float lo = y[0], hi = y[LC_LEVELS - 1];
+    float step = (hi - lo) / HOCS_LINCAL_SEGS;
+    float sx = 0.0f, sy = 0.0f, sxx = 0.0f, sxy = 0.0f;
+    float prev = 0.0f;
+    uint32_t p = 0;
+
+    /* 1. Knot k at y = lo + k * step; x by interpolating the measured levels */
+    for (uint32_t k = 0; k <= HOCS_LINCAL_SEGS; k++) {
+        float yk = lo + step * (float)k;
+        float x;
+
+        while (p + 2 < LC_LEVELS && y[p + 1] < yk) {
+            p++;
+        }
+        x = (y[p + 1] > y[p]) ?
+            lc_level(p) + (lc_level(p + 1) - lc_level(p)) * (yk - y[p]) / (y[p + 1] - y[p]) :
+            lc_level(p);
+        if (k > 0) {
+            e[2 * (k - 1)] = prev;
+            e[2 * (k - 1) + 1] = x - prev;
+        }
+        prev = x;
+    }
+
+    /* 2. Least-squares y = gain * x + offset */
+    for (uint32_t i = 0; i < LC_LEVELS; i++) {
+        float x = lc_level(i);
+        sx += x;
+        sy += y[i];
+        sxx += x * x;
+        sxy += x * y[i];
+    }
+    lc->gain[ch] = (LC_LEVELS * sxy - sx * sy) / (LC_LEVELS * sxx - sx * sx);
+    lc->offset[ch] = (sy - lc->gain[ch] * sx) / LC_LEVELS;
+
+    /* 3. Column parameters of every column on this channel */
+    for (uint32_t j = ch; j < HOCS_MAX_DIM; j += LC_CHANNELS) {
+        lc->lo[j] = lo;
+        lc->inv_step[j] = (step > 0.0f) ? 1.0f / step : 0.0f;
+        lc->base[j] = ch * HOCS_LINCAL_SEGS;
+    }
+}
+
+/*
+ * ======================================================================================
+ * PUBLIC API
+ * ======================================================================================
+ */
+
+/*
+ * hocs_lincal_attach
+ * Starts correcting results on 'dev' once 'lc' has been calibrated; the
+ * first calibration is left to hocs_lincal_service(). NULL detaches.
+ */
+void hocs_lincal_attach(hocs_device_t *dev, hocs_lincal_t *lc) {
+    dev->lincal = NULL;
+    if (lc == NULL) {
+        return;
+    }
+
+    lc->dev = dev;
+    lc->valid = 0;
+    lc->pending = 1;
+    lc->last_check = 0;
+    lc->calibrations = 0;
+    lc->drift_recals = 0;
+    lc->corrected_bytes = 0;
+    asm volatile("" ::: "memory");
+    dev->lincal = lc;
+}
+
+/*
+ * hocs_lincal_calibrate
+ * Measures every channel at HOCS_LINCAL_LEVELS reference levels and
+ * rebuilds the tables. Thread context, IRQs on (reaps through lc_reap());
+ * results reaped meanwhile are not corrected, so run it with the ring
+ * otherwise idle.
+ */
+int hocs_lincal_calibrate(hocs_lincal_t *lc) {
+    hocs_device_t *dev = lc->dev;
+    const uint32_t n = LC_CHANNELS;
+    size_t bytes = ((size_t)n * n + 2 * (size_t)LC_LEVELS * n) * sizeof(float);
+    float *ident, *ref, *raw;
+    float raw_err = 0.0f, res_err = 0.0f;
+    uint32_t handle = 0;
+    hocs_job_t job;
+    int rc;
+
+    ident = (float *)hocs_buf_alloc_on(dev, bytes);
+    if (ident == NULL) {
+        return HOCS_ERR_INVALID;
+    }
+    ref = ident + n * n;
+    raw = ref + LC_LEVELS * n;
+
+    /* 1. Reference job: the level ladder through an identity matrix */
+    lc->valid = 0;
+    asm volatile("dmb ish" ::: "memory");
+
+    for (uint32_t i = 0; i < n * n; i++) ident[i] = 0.0f;
+    for (uint32_t i = 0; i < n; i++) ident[i * n + i] = 1.0f;
+    for (uint32_t i = 0; i < LC_LEVELS; i++) {
+        for (uint32_t j = 0; j < n; j++) ref[i * n + j] = lc_level(i);
+    }
+
+    while ((rc = hocs_weights_register(dev, ident, n, &handle)) == HOCS_ERR_BUSY) {
+        lc_reap(dev);
+    }
+    if (rc == HOCS_OK) {
+        job.src_addr = (uint64_t)(uintptr_t)ref;
+        job.dst_addr = (uint64_t)(uintptr_t)raw;
+        job.flags = 0;
+        job.done = NULL;
+        job.ctx = NULL;
+        job.scratch = NULL;
+        job.weights = handle;
+        job.rows = LC_LEVELS;
+        while ((rc = hocs_submit(dev, &job)) == HOCS_ERR_BUSY) {
+            lc_reap(dev);
+        }
+    }
+    if (rc == HOCS_OK) {
+        rc = lc_wait(dev, &job);
+    }
+    if (rc != HOCS_OK) {
+        hocs_buf_free(ident, bytes);
+        return rc;
+    }
+
+    /* 2. Per channel: measured response -> inverse LUT */
+    for (uint32_t ch = 0; ch < n; ch++) {
+        float y[LC_LEVELS];
+
+        for (uint32_t i = 0; i < LC_LEVELS; i++) {
+            y[i] = raw[i * n + ch];
+            if (i > 0 && y[i] <= y[i - 1]) {
+                y[i] = y[i - 1] + 1e-6f * HOCS_LINCAL_FULL_SCALE;     // Flat (clipped) top
+            }
+        }
+        lc_fit_channel(lc, ch, y);
+    }
+
+    /* 3. How far off raw results were, and what is left after correction */
+    for (uint32_t i = 0; i < LC_LEVELS; i++) {
+        for (uint32_t j = 0; j < n; j++) {
+            float r = lc_abs(raw[i * n + j] - lc_level(i));
+            float c = lc_abs(lc_correct(lc, j, raw[i * n + j]) - lc_level(i));
+            raw_err = (r > raw_err) ? r : raw_err;
+            res_err = (c > res_err) ? c : res_err;
+        }
+    }
+    lc->raw_err_ppm = (uint32_t)(raw_err / HOCS_LINCAL_FULL_SCALE * 1e6f);
+    lc->residual_ppm = (uint32_t)(res_err / HOCS_LINCAL_FULL_SCALE * 1e6f);
+
+    /* 4. Operating point stamp, then publish */
+    for (uint32_t z = 0; z < HOCS_THERMAL_ZONES; z++) {
+        lc->temp_mc[z] = lc_temp_mc(dev, z);
+    }
+    lc->calibrations++;
+    asm volatile("dmb ish" ::: "memory");
+    lc->valid = 1;
+
+    hocs_buf_free(ident, bytes);
+    return HOCS_OK;
+}
+
+/*
+ * lc_apply_rows
+ * Corrects a rows x n buffer whose values are 'k' calibrated units each.
+ */
+static void lc_apply_rows(const hocs_lincal_t *lc, float *buf, uint32_t rows, uint32_t n, float k) {
+    const float inv_k = 1.0f / k;
+
+    for (uint32_t r = 0; r < rows; r++) {
+        float *row = buf + (size_t)r * n;
+        uint32_t j = 0;
+#if defined(__ARM_NEON)
+        const float *lut = lc->lut[0];
+        const float32x4_t vmax = vdupq_n_f32(HOCS_LINCAL_SEGS - 1);
+        const float32x4_t vmin = vdupq_n_f32(0.0f);
+        const float32x4_t vk = vdupq_n_f32(k);
+        const float32x4_t vinv = vdupq_n_f32(inv_k);
+
+        for (; j + 4 <= n; j += 4) {
+            float32x4_t y = vmulq_f32(vld1q_f32(row + j), vk);
+            float32x4_t t = vmulq_f32(vsubq_f32(y, vld1q_f32(lc->lo + j)), vld1q_f32(lc->inv_step + j));
+            uint32x4_t seg = vcvtq_u32_f32(vminq_f32(vmaxq_f32(t, vmin), vmax));
+            uint32x4_t idx = vshlq_n_u32(vaddq_u32(seg, vld1q_u32(lc->base + j)), 1);
+            float32x4_t e01 = vcombine_f32(vld1_f32(lut + vgetq_lane_u32(idx, 0)),
+                                           vld1_f32(lut + vgetq_lane_u32(idx, 1)));
+            float32x4_t e23 = vcombine_f32(vld1_f32(lut + vgetq_lane_u32(idx, 2)),
+                                           vld1_f32(lut + vgetq_lane_u32(idx, 3)));
+            float32x4x2_t e = vuzpq_f32(e01, e23);      // val[0]: starts, val[1]: rises
+
+            vst1q_f32(row + j, vmulq_f32(vmlaq_f32(e.val[0], e.val[1], vsubq_f32(t, vcvtq_f32_u32(seg))),
+                                         vinv));
+        }
+#endif
+        for (; j < n; j++) {
+            row[j] = lc_correct(lc, j, row[j] * k) * inv_k;
+        }
+    }
+}
+
+/*
+ * hocs_lincal_apply
+ * Corrects a rows x n result buffer in place (fp32 units).
+ */
+void hocs_lincal_apply(const hocs_lincal_t *lc, float *buf, uint32_t rows, uint32_t n) {
+    lc_apply_rows(lc, buf, rows, n, 1.0f);
+}
+
+/*
+ * hocs_lincal_complete
+ * Reaper hook: corrects a finished job's result before it is handed back,
+ * in the job's readout units (hocs_desc_readout_scale). fp16 results go
+ * through a row of fp32 and back.
+ */
+void hocs_lincal_complete(hocs_device_t *dev, const hocs_desc_t *d) {
+    hocs_lincal_t *lc = dev->lincal;
+    uint32_t rows = d->matrix_dim, n = d->matrix_dim;
+    float k = hocs_desc_readout_scale(d->flags);
+
+    if (!lc->valid || d->status != HOCS_DESC_DONE || (d->flags & HOCS_DESC_F_LOAD_W)) {
+        return;
+    }
+    if ((d->flags & HOCS_DESC_F_RESIDENT) && HOCS_DESC_ROWS(d->flags)) {
+        rows = HOCS_DESC_ROWS(d->flags);
+    }
+
+    if (d->flags & HOCS_DESC_F_OUT_FP16) {
+        uint16_t *h = (uint16_t *)(uintptr_t)d->dst_addr;
+        float row[HOCS_MAX_DIM];
+
+        for (uint32_t r = 0; r < rows; r++, h += n) {
+            for (uint32_t j = 0; j < n; j++) row[j] = hocs_f16_to_f32(h[j]);
+            lc_apply_rows(lc, row, 1, n, k);
+            for (uint32_t j = 0; j < n; j++) h[j] = hocs_f32_to_f16(row[j]);
+        }
+        lc->corrected_bytes += (uint64_t)rows * n * sizeof(uint16_t);
+        return;
+    }
+    lc_apply_rows(lc, (float *)(uintptr_t)d->dst_addr, rows, n, k);
+    lc->corrected_bytes += (uint64_t)rows * n * sizeof(float);
+}
+
+/*
+ * hocs_lincal_service
+ * Main-loop hook: polls the sensors every HOCS_LINCAL_CHECK_MS and
+ * recalibrates after HOCS_LINCAL_DRIFT_MC of drift (or for the first time)
+ * once nothing is queued, since queued jobs belong to the old operating
+ * point.
+ */
+int hocs_lincal_service(hocs_lincal_t *lc) {
+    hocs_device_t *dev = lc->dev;
+    uint64_t now = timer_get_ticks();
+    int32_t drift = 0;
+    int rc;
+
+    if (dev == NULL) {
+        return HOCS_OK;
+    }
+
+    /* 1. Drift check */
+    if (!lc->pending) {
+        if (timer_ticks_to_us(now - lc->last_check) < HOCS_LINCAL_CHECK_MS * 1000ULL) {
+            return HOCS_OK;
+        }
+        lc->last_check = now;
+
+        for (uint32_t z = 0; z < HOCS_THERMAL_ZONES; z++) {
+            int32_t d = lc_temp_mc(dev, z) - lc->temp_mc[z];
+            d = (d < 0) ? -d : d;
+            drift = (d > drift) ? d : drift;
+        }
+        if (drift < HOCS_LINCAL_DRIFT_MC) {
+            return HOCS_OK;
+        }
+        lc->pending = 1;
+    }
+
+    /* 2. Recalibrate on an idle ring */
+    if (dev->user || dev->prod != dev->cons) {
+        return HOCS_OK;
+    }
+
+    rc = hocs_lincal_calibrate(lc);
+    if (rc != HOCS_OK) {
+        kprintf("[HOCS] %s: linearity calibration failed (%d)\n", dev->name, rc);
+        return rc;
+    }
+    lc->pending = 0;
+    lc->last_check = now;
+    if (lc->calibrations > 1) {
+        lc->drift_recals++;
+    }
+
+    kprintf("[HOCS] %s: linearity calibrated at %d mC (raw error %u ppm FS, corrected %u ppm)\n",
+            dev->name, lc->temp_mc[0], lc->raw_err_ppm, lc->residual_ppm);
+    return HOCS_OK;
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK: CORRECTION ACCURACY AND THROUGHPUT
+ * ======================================================================================
+ * 1. Accuracy: a 144x144 product through the model's analog readout,
+ *    uncorrected and corrected, before and after an 8 C temperature step
+ *    (stale table, then the drift-triggered recalibration).
+ * 2. The same product as a checksummed fp32 quantized job (cfg.crc) under
+ *    HOCS_VERIFY_FULL: the driver must check the result before the
+ *    correction rewrites it, not leave it to hocs_quant_result().
+ * 3. Throughput: hocs_lincal_apply() over a buffer well beyond L2, against
+ *    a plain in-place streaming pass over the same buffer (read + write,
+ *    no lookup) as the memory bandwidth reference. GB/s counts result
+ *    bytes corrected.
+ */
+
+#define BENCH_N                 LC_CHANNELS
+#define BENCH_SCALE             12.0f       // Keeps products well inside full scale
+#define BENCH_STREAM_BYTES      (4U * 1024 * 1024)
+#define BENCH_STREAM_COLS       256
+#define BENCH_PASSES            8
+
+static hocs_lincal_t bench_lc;
+static hocs_qjob_t bench_qj;
+static volatile float bench_unity = 1.0f;      // Keeps the streaming pass from folding away
+
+/* Worst error of one product against the exact result, ppm of full scale */
+static uint32_t bench_product(const float *a, const float *b, const float *ref, float *c, int correct) {
+    hocs_job_t job;
+    uint32_t handle = 0;
+    float err = 0.0f;
+
+    hocs_bench.dev[0].lincal = correct ? &bench_lc : NULL;
+    if (hocs_weights_register(&hocs_bench.dev[0], b, BENCH_N, &handle) != HOCS_OK) {
+        return 0xFFFFFFFFU;
+    }
+    job.src_addr = (uint64_t)(uintptr_t)a;
+    job.dst_addr = (uint64_t)(uintptr_t)c;
+    job.flags = 0;
+    job.done = NULL;
+    job.ctx = NULL;
+    job.scratch = NULL;
+    job.weights = handle;
+    job.rows = BENCH_N;
+    if (hocs_submit(&hocs_bench.dev[0], &job) != HOCS_OK ||
+        hocs_wait(&hocs_bench.dev[0], &job, HOCS_LINCAL_TIMEOUT_US) != HOCS_OK) {
+        return 0xFFFFFFFFU;
+    }
+    hocs_bench.dev[0].lincal = &bench_lc;
+
+    for (uint32_t i = 0; i < BENCH_N * BENCH_N; i++) {
+        float e = lc_abs(c[i] - ref[i]);
+        err = (e > err) ? e : err;
+    }
+    return (uint32_t)(err / HOCS_LINCAL_FULL_SCALE * 1e6f);
+}
+
+static void bench_stream(float *buf, uint32_t count) {
+    const float k = bench_unity;
+    uint32_t i = 0;
+#if defined(__ARM_NEON)
+    const float32x4_t vk = vdupq_n_f32(k);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(buf + i, vmulq_f32(vld1q_f32(buf + i), vk));
+    }
+#endif
+    for (; i < count; i++) {
+        buf[i] *= k;
+    }
+}
+
+/* Checksummed fp32 job through hocs_quant_job/result with the correction attached */
+static void bench_checked(const float *a, const float *b, const float *ref, float *c, void *work) {
+    const hocs_qcfg_t cfg = { HOCS_FMT_FP32, HOCS_FMT_FP32, HOCS_Q_TENSOR, HOCS_Q_TENSOR, 0.0f, 1 };
+    void *dst = (uint8_t *)work + hocs_quant_bytes(HOCS_FMT_FP32, 2 * BENCH_N, BENCH_N);
+    hocs_job_t job;
+    float err = 0.0f;
+    int rc;
+
+    hocs_set_verify(&hocs_bench.dev[0], HOCS_VERIFY_FULL);
+    rc = hocs_quant_job(&bench_qj, &job, &cfg, a, b, BENCH_N, BENCH_N, work, dst);
+    job.done = NULL;
+    job.ctx = NULL;
+    job.scratch = NULL;
+    if (rc == HOCS_OK) rc = hocs_submit(&hocs_bench.dev[0], &job);
+    if (rc == HOCS_OK) rc = hocs_wait(&hocs_bench.dev[0], &job, HOCS_LINCAL_TIMEOUT_US);
+    if (rc == HOCS_OK) rc = hocs_quant_result(&bench_qj, c);
+    hocs_set_verify(&hocs_bench.dev[0], HOCS_VERIFY_OFF);
+
+    for (uint32_t i = 0; i < BENCH_N * BENCH_N; i++) {
+        float e = lc_abs(c[i] - ref[i]);
+        err = (e > err) ? e : err;
+    }
+    kprintf("  fp32 + crc, HOCS_VERIFY_FULL: %s (verified %u, %lu CRC errors), corrected %u ppm FS\n",
+            (rc == HOCS_OK) ? "ok" : "FAILED", job.verified, hocs_bench.dev[0].crc_errors,
+            (uint32_t)(err / HOCS_LINCAL_FULL_SCALE * 1e6f));
+}
+
+/* Result bytes per second as GB/s with one decimal */
+static void bench_rate(const char *what, uint64_t bytes, uint64_t ns) {
+    uint64_t mb_s = bytes * 1000 / (ns ? ns : 1);
+
+    kprintf("  %s: %lu.%lu GB/s\n", what, mb_s / 1000, (mb_s % 1000) / 100);
+}
+
+void hocs_lincal_benchmark(void) {
+    const size_t mat = (size_t)BENCH_N * BENCH_N;
+    size_t bytes = 4 * mat * sizeof(float);
+    uint32_t seed = 12345;
+    float *a, *b, *ref, *c, *buf;
+    uint64_t t0, ns_apply, ns_stream;
+
+    kprintf("[HOCS] Linearity correction (analog readout model):\n");
+
+    a = (float *)hocs_buf_alloc(bytes);
+    buf = (float *)hocs_buf_alloc(BENCH_STREAM_BYTES);
+    if (a == NULL || buf == NULL) {
+        kprintf("  out of memory\n");
+        if (a) hocs_buf_free(a, bytes);
+        if (buf) hocs_buf_free(buf, BENCH_STREAM_BYTES);
+        return;
+    }
+    b = a + mat;
+    ref = b + mat;
+    c = ref + mat;
+
+    /* 1. Operands and the exact product */
+    for (size_t i = 0; i < 2 * mat; i++) {
+        seed = seed * 1103515245U + 12345U;
+        a[i] = (float)((int32_t)(seed >> 16) % 2001 - 1000) / 1000.0f;
+    }
+    for (size_t i = 0; i < mat; i++) b[i] *= BENCH_SCALE;
+    for (uint32_t i = 0; i < BENCH_N; i++) {
+        for (uint32_t j = 0; j < BENCH_N; j++) {
+            float acc = 0.0f;
+            for (uint32_t k = 0; k < BENCH_N; k++) acc += a[i * BENCH_N + k] * b[k * BENCH_N + j];
+            ref[i * BENCH_N + j] = acc;
+        }
+    }
+
+    hocs_bench_init(0, "hocs-bench", hocs_bench_real_ns, 1);
+    hocs_bench.model[0].analog = 1;
+    hocs_lincal_attach(&hocs_bench.dev[0], &bench_lc);
+
+    /* 2. Calibrated at the idle temperature */
+    hocs_lincal_service(&bench_lc);
+    kprintf("  %d mC: raw %u ppm FS, corrected %u ppm FS\n", bench_lc.temp_mc[0],
+            bench_product(a, b, ref, c, 0), bench_product(a, b, ref, c, 1));
+
+    /* 3. Temperature step: stale table, then the drift check catches it */
+    hocs_model_set_temp(&hocs_bench.model[0], HOCS_MODEL_TEMP_MC + 8000);
+    kprintf("  %d mC, stale table: corrected %u ppm FS\n", HOCS_MODEL_TEMP_MC + 8000,
+            bench_product(a, b, ref, c, 1));
+    bench_lc.last_check = 0;        // Don't wait for the poll period
+    hocs_lincal_service(&bench_lc);
+    kprintf("  %d mC, recalibrated: raw %u ppm FS, corrected %u ppm FS (%u drift recals)\n",
+            bench_lc.temp_mc[0], bench_product(a, b, ref, c, 0), bench_product(a, b, ref, c, 1),
+            bench_lc.drift_recals);
+
+    /* 4. Checksummed job with the correction attached */
+    bench_checked(a, b, ref, c, buf);
+
+    /* 5. Throughput */
+    for (uint32_t i = 0; i < BENCH_STREAM_BYTES / sizeof(float); i++) {
+        buf[i] = (float)((int32_t)(i % 511) - 255);
+    }
+    t0 = timer_get_ticks();
+    for (uint32_t p = 0; p < BENCH_PASSES; p++) {
+        bench_stream(buf, BENCH_STREAM_BYTES / sizeof(float));
+    }
+    ns_stream = timer_ticks_to_ns(timer_get_ticks() - t0);
+
+    t0 = timer_get_ticks();
+    for (uint32_t p = 0; p < BENCH_PASSES; p++) {
+        hocs_lincal_apply(&bench_lc, buf, BENCH_STREAM_BYTES / sizeof(float) / BENCH_STREAM_COLS,
+                          BENCH_STREAM_COLS);
+    }
+    ns_apply = timer_ticks_to_ns(timer_get_ticks() - t0);
+
+    kprintf("[HOCS] Correction throughput (%u KB buffer, %u columns):\n",
+            BENCH_STREAM_BYTES / 1024, BENCH_STREAM_COLS);
+    bench_rate("streaming pass (bandwidth)", (uint64_t)BENCH_PASSES * BENCH_STREAM_BYTES, ns_stream);
+    bench_rate("LUT correction            ", (uint64_t)BENCH_PASSES * BENCH_STREAM_BYTES, ns_apply);
+
+    hocs_lincal_attach(&hocs_bench.dev[0], NULL);
+    hocs_buf_free(buf, BENCH_STREAM_BYTES);
+    hocs_buf_free(a, bytes);
+}
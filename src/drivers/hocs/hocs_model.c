@@ -0,0 +1,508 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_model.c
+ * Module:      HOCS Behavioral Model Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Register semantics mirror the PL IP:
+ * - CONTROL.RESET is self-clearing and returns the engine to idle.
+ * - IRQ_STATUS is write-1-to-clear.
+ * - RING_DOORBELL kicks the engine; RING_COMPLETED is read-only.
+ * - With CONTROL.DB_SHADOW the producer index is read from the doorbell
+ *   page on every advance and RING_COMPLETED is mirrored back to it.
+ * - STATUS reflects engine state at the moment of the read.
+ * - LASER_POWER / PHASE_SHIFT are banked per channel by CHAN_SEL.
+ * - Weight slots are cleared by CONTROL.RESET.
+ * - With CONTROL.CRC_EN each completion writes the CRC-32C of the bytes
+ *   read and written to the CRC_BASE table, before the status word.
+ * - CHAN_MONITOR models the selected channel's monitor photodiode: output
+ *   scales with DAC code and channel efficiency and peaks when the phase
+ *   matches the channel's (unknown to software) optimum.
+ * ======================================================================================
+ */
+
+#include "drivers/hocs_model.h"
+#include "drivers/hocs_quant.h"
+#include "drivers/gic_v2.h"
+#include "kernel/timer_heavy.h"
+#include "lib/crc32c.h"
+
+#define REG(m, off)             ((m)->regs[(off) >> 2])
+
+/* Helper Macros for Memory Mapped I/O */
+#define MMIO_WRITE32(addr, val) (*(volatile uint32_t *)(addr) = (val))
+
+/*
+ * hocs_model_init
+ * Powers the model up in reset state with default timing.
+ */
+void hocs_model_init(hocs_model_t *m, uint64_t (*clock_ns)(void)) {
+    for (int i = 0; i < HOCS_MODEL_REG_WORDS; i++) {
+        m->regs[i] = 0;
+    }
+
+    m->setup_ns = HOCS_MODEL_SETUP_NS;
+    m->compute_ns = HOCS_MODEL_COMPUTE_NS;
+    m->dma_bytes_per_us = HOCS_MODEL_DMA_BYTES_PER_US;
+    m->functional = 1;
+    m->analog = 0;
+    m->corrupt_every = 0;
+
+    m->hw_idx = 0;
+    m->busy = 0;
+    m->busy_until_ns = 0;
+    for (int i = 0; i < HOCS_WEIGHT_SLOTS; i++) {
+        m->wslot_addr[i] = 0;
+        m->wslot_dim[i] = 0;
+    }
+    m->clock_ns = clock_ns;
+    m->raise_irq = NULL;
+    m->irq_arg = NULL;
+
+    m->jobs = 0;
+    m->busy_ns = 0;
+    m->dma_bytes = 0;
+    m->corrupted = 0;
+
+    REG(m, HOCS_TEMP_SENSOR_1_OFFSET) = HOCS_MODEL_TEMP_MC;
+    REG(m, HOCS_TEMP_SENSOR_2_OFFSET) = HOCS_MODEL_TEMP_MC;
+
+    for (int i = 0; i < HOCS_NUM_CHANNELS; i++) {
+        m->chan_power[i] = 0;
+        m->chan_phase[i] = 0;
+    }
+}
+
+/*
+ * model_monitor_uw
+ * Per-channel efficiency 85-105% and phase optimum are fixed pseudo-random
+ * functions of the channel index. Response falls off quadratically with
+ * phase error (1 - (d/pi)^2).
+ */
+static uint32_t model_monitor_uw(const hocs_model_t *m, uint32_t ch) {
+    uint32_t eff_permille = 850 + ((ch * 37) % 200);
+    uint32_t optimum = (ch * 1237 + 311) % HOCS_PHASE_STEPS;
+    uint32_t d = (m->chan_phase[ch] - optimum) & (HOCS_PHASE_STEPS - 1);
+    uint64_t peak;
+
+    if (d > HOCS_PHASE_STEPS / 2) {
+        d = HOCS_PHASE_STEPS - d;
+    }
+
+    peak = (uint64_t)m->chan_power[ch] * HOCS_MODEL_MONITOR_FULL_UW * eff_permille / (HOCS_DAC_MAX * 1000ULL);
+    return (uint32_t)(peak * (4194304ULL - (uint64_t)d * d) / 4194304ULL);    // (N/2)^2 = 2^22
+}
+
+/*
+ * hocs_model_job_ns
+ * Modelled execution time of one NxN job.
+ */
+uint64_t hocs_model_job_ns(const hocs_model_t *m, uint32_t dim) {
+    uint64_t bytes_in = 2ULL * dim * dim * sizeof(float);
+    uint64_t bytes_out = (uint64_t)dim * dim * sizeof(float);
+    uint64_t dma_ns = ((bytes_in + bytes_out) * 1000) / m->dma_bytes_per_us;
+
+    return m->setup_ns + dma_ns + m->compute_ns;
+}
+
+/* Bytes per streamed operand element */
+static uint64_t model_elem_bytes(uint32_t fmt) {
+    return (fmt == HOCS_FMT_INT8) ? 1 : (fmt == HOCS_FMT_FP16) ? 2 : 4;
+}
+
+static void model_desc_bytes(const hocs_desc_t *d, uint64_t *in_bytes, uint64_t *out_bytes) {
+    hocs_desc_bytes(d->flags, d->matrix_dim, in_bytes, out_bytes);
+}
+
+/*
+ * model_desc_phases
+ * Execution time of a descriptor of any kind, split into input (setup +
+ * DMA in), compute and output DMA. Returns the total.
+ */
+static uint64_t model_desc_phases(const hocs_model_t *m, const hocs_desc_t *d,
+                                  uint64_t *in_ns, uint64_t *compute_ns, uint64_t *out_ns) {
+    uint64_t in_bytes, out_bytes;
+
+    model_desc_bytes(d, &in_bytes, &out_bytes);
+    *compute_ns = (d->flags & HOCS_DESC_F_LOAD_W) ? 0 : m->compute_ns;
+    *in_ns = m->setup_ns + (in_bytes * 1000) / m->dma_bytes_per_us;
+    *out_ns = (out_bytes * 1000) / m->dma_bytes_per_us;
+    return *in_ns + *compute_ns + *out_ns;
+}
+
+/*
+ * hocs_model_raise_gic
+ * Default IRQ sink: pends the HOCS SPI in the GIC distributor.
+ * 'arg' carries the interrupt ID.
+ */
+void hocs_model_raise_gic(void *arg) {
+    uint32_t irq = (uint32_t)(uintptr_t)arg;
+    MMIO_WRITE32(GICD_ISPENDR(irq / 32), 1U << (irq % 32));
+}
+
+/*
+ * hocs_model_set_temp
+ * Environment: both sensor zones now read 'mc' (milli-C).
+ */
+void hocs_model_set_temp(hocs_model_t *m, int32_t mc) {
+    REG(m, HOCS_TEMP_SENSOR_1_OFFSET) = (uint32_t)mc;
+    REG(m, HOCS_TEMP_SENSOR_2_OFFSET) = (uint32_t)mc;
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK FIXTURE
+ * ======================================================================================
+ */
+
+hocs_bench_t hocs_bench;
+
+/*
+ * hocs_bench_init
+ * Brings bench port 'port' up on a freshly reset model driven by
+ * 'clock_ns', with nothing attached, and restarts the virtual clock.
+ * The weight staging buffer is kept across benchmarks.
+ */
+hocs_device_t *hocs_bench_init(uint32_t port, const char *name, uint64_t (*clock_ns)(void),
+                               uint8_t functional) {
+    hocs_model_t *m = &hocs_bench.model[port];
+    hocs_device_t *dev = &hocs_bench.dev[port];
+    float *wstage = dev->wstage;
+
+    *dev = (hocs_device_t){ .name = name, .ring = hocs_bench.ring[port], .wstage = wstage };
+    hocs_bench.now = 0;
+
+    hocs_model_init(m, clock_ns);
+    m->functional = functional;
+    hocs_init(dev, 0, HOCS_IRQ_ID, m);     // No IRQ sink: the benchmark drives completions
+    return dev;
+}
+
+/* Virtual time, advanced by the benchmark */
+uint64_t hocs_bench_virtual_ns(void) {
+    return hocs_bench.now;
+}
+
+/* Virtual time that moves 100 ns on every read, so waits always finish */
+uint64_t hocs_bench_stepped_ns(void) {
+    return hocs_bench.now += 100;
+}
+
+uint64_t hocs_bench_real_ns(void) {
+    return timer_ticks_to_ns(timer_get_ticks());
+}
+
+/*
+ * ======================================================================================
+ * ENGINE
+ * ======================================================================================
+ */
+
+static hocs_desc_t *model_desc(hocs_model_t *m, uint32_t idx) {
+    uint64_t base = ((uint64_t)REG(m, HOCS_RING_BASE_H_OFFSET) << 32) |
+                    REG(m, HOCS_RING_BASE_L_OFFSET);
+    uint32_t size = REG(m, HOCS_RING_SIZE_OFFSET);
+
+    return (hocs_desc_t *)(uintptr_t)base + (idx & (size - 1));
+}
+
+static hocs_crc_t *model_crc(hocs_model_t *m, uint32_t idx) {
+    uint64_t base = ((uint64_t)REG(m, HOCS_CRC_BASE_H_OFFSET) << 32) |
+                    REG(m, HOCS_CRC_BASE_L_OFFSET);
+    uint32_t size = REG(m, HOCS_RING_SIZE_OFFSET);
+
+    return (hocs_crc_t *)(uintptr_t)base + (idx & (size - 1));
+}
+
+/*
+ * model_checksum
+ * CRC_EN: checksums of the payload as it crossed the DMA. Fault injection
+ * flips a result bit after the output checksum was taken, i.e. on the
+ * way to DDR.
+ */
+static void model_checksum(hocs_model_t *m, const hocs_desc_t *d) {
+    hocs_crc_t *crc = model_crc(m, m->hw_idx);
+    uint64_t in_bytes, out_bytes;
+
+    model_desc_bytes(d, &in_bytes, &out_bytes);
+    crc->src = crc32c(0, (const void *)(uintptr_t)d->src_addr, in_bytes);
+    crc->dst = out_bytes ? crc32c(0, (const void *)(uintptr_t)d->dst_addr, out_bytes) : 0;
+
+    if (out_bytes && m->corrupt_every && (m->jobs + 1) % m->corrupt_every == 0) {
+        uint8_t *p = (uint8_t *)(uintptr_t)d->dst_addr;
+        p[(m->jobs * 2654435761U) % out_bytes] ^= 0x10;
+        m->corrupted++;
+    }
+}
+
+static uint64_t model_db_page(hocs_model_t *m) {
+    return ((uint64_t)REG(m, HOCS_DB_ADDR_H_OFFSET) << 32) | REG(m, HOCS_DB_ADDR_L_OFFSET);
+}
+
+/* Producer index: register or shadow doorbell */
+static uint32_t model_doorbell(hocs_model_t *m) {
+    if (REG(m, HOCS_CONTROL_OFFSET) & HOCS_CTRL_DB_SHADOW) {
+        return __atomic_load_n((uint32_t *)(uintptr_t)(model_db_page(m) + HOCS_DB_SQ_TAIL),
+                               __ATOMIC_ACQUIRE);
+    }
+    return REG(m, HOCS_RING_DOORBELL_OFFSET);
+}
+
+static void model_update_irq(hocs_model_t *m) {
+    if ((REG(m, HOCS_IRQ_STATUS_OFFSET) & REG(m, HOCS_IRQ_ENABLE_OFFSET)) && m->raise_irq) {
+        m->raise_irq(m->irq_arg);
+    }
+}
+
+static inline float model_elem(const void *p, uint32_t fmt, uint32_t idx) {
+    if (fmt == HOCS_FMT_INT8) return (float)((const int8_t *)p)[idx];
+    if (fmt == HOCS_FMT_FP16) return hocs_f16_to_f32(((const uint16_t *)p)[idx]);
+    return ((const float *)p)[idx];
+}
+
+/*
+ * model_readout
+ * Per-channel gain 0.92-1.08 and offset up to 0.2% of full scale, both
+ * fixed pseudo-random functions of the channel index, drifting by
+ * -0.4%/C and +0.05% FS/C away from HOCS_MODEL_TEMP_MC. 'c' is one result
+ * row in output units, 'k' the readout scale of the job.
+ */
+static void model_readout(const hocs_model_t *m, float *c, uint32_t n, float k) {
+    const float fs = HOCS_MODEL_ADC_FULL_SCALE;
+    float dt = (float)((int32_t)REG(m, HOCS_TEMP_SENSOR_1_OFFSET) - HOCS_MODEL_TEMP_MC) / 1000.0f;
+
+    for (uint32_t j = 0; j < n; j++) {
+        uint32_t ch = j % HOCS_NUM_CHANNELS;
+        float gain = (0.92f + 0.0008f * (float)((ch * 37) % 200)) * (1.0f - 0.004f * dt);
+        float offset = fs * (0.0001f * (float)((int32_t)((ch * 53) % 41) - 20) + 0.0005f * dt);
+        float v = c[j] * k / fs;
+
+        v = (v > 1.0f) ? 1.0f : (v < -1.0f) ? -1.0f : v;
+        c[j] = (fs * gain * (v - v * v * v / 12.0f) + offset) / k;
+    }
+}
+
+/*
+ * model_execute
+ * C = A x B. A (and B of a full job) in the descriptor's input format; the
+ * result is scaled by 2^-shift, read out (analog) and stored as fp32 or
+ * fp16.
+ */
+static void model_execute(const hocs_model_t *m, const void *a, const void *b, void *c,
+                          uint32_t flags, uint32_t n, uint32_t rows) {
+    uint32_t fmt = HOCS_DESC_IN_FMT(flags);
+    uint32_t b_fmt = (flags & HOCS_DESC_F_RESIDENT) ? HOCS_FMT_FP32 : fmt;
+    float scale = 1.0f / (float)(1U << HOCS_DESC_OUT_SHIFT(flags));
+    float unit = hocs_desc_readout_scale(flags);
+    float arow[HOCS_MAX_DIM];
+    float crow[HOCS_MAX_DIM];
+
+    for (uint32_t i = 0; i < rows; i++) {
+        for (uint32_t k = 0; k < n; k++) {
+            arow[k] = model_elem(a, fmt, i * n + k);
+        }
+        for (uint32_t j = 0; j < n; j++) {
+            float acc = 0.0f;
+            for (uint32_t k = 0; k < n; k++) {
+                acc += arow[k] * model_elem(b, b_fmt, k * n + j);
+            }
+            crow[j] = acc * scale;
+        }
+        if (m->analog) {
+            model_readout(m, crow, n, unit);
+        }
+        for (uint32_t j = 0; j < n; j++) {
+            if (flags & HOCS_DESC_F_OUT_FP16) {
+                ((uint16_t *)c)[i * n + j] = hocs_f32_to_f16(crow[j]);
+            } else {
+                ((float *)c)[i * n + j] = crow[j];
+            }
+        }
+    }
+}
+
+static void model_complete(hocs_model_t *m) {
+    hocs_desc_t *d = model_desc(m, m->hw_idx);
+    uint32_t dim = d->matrix_dim;
+    uint32_t slot = HOCS_DESC_SLOT(d->flags);
+    uint32_t rows = dim;
+    int ok = dim != 0 && dim <= HOCS_MAX_DIM && d->src_addr != 0;
+    uint64_t in_ns, compute_ns, out_ns;
+
+    /* 0. Phase timestamps (model clock), written back ahead of the status */
+    model_desc_phases(m, d, &in_ns, &compute_ns, &out_ns);
+    d->ts_dma_out = m->busy_until_ns;
+    d->ts_compute = m->busy_until_ns - out_ns;
+    d->ts_dma_in = d->ts_compute - compute_ns;
+
+    /* 1. Validate against the descriptor kind */
+    if (d->flags & HOCS_DESC_F_LOAD_W) {
+        ok = ok && slot < HOCS_WEIGHT_SLOTS;
+    } else {
+        ok = ok && d->dst_addr != 0;
+        if (d->flags & HOCS_DESC_F_RESIDENT) {
+            if (HOCS_DESC_ROWS(d->flags)) rows = HOCS_DESC_ROWS(d->flags);
+            ok = ok && slot < HOCS_WEIGHT_SLOTS && m->wslot_dim[slot] == dim && rows <= dim;
+        }
+    }
+
+    /* 2. Execute */
+    if (!ok) {
+        d->status = HOCS_DESC_ERROR;
+        REG(m, HOCS_IRQ_STATUS_OFFSET) |= HOCS_IRQ_ERROR;
+    } else if (d->flags & HOCS_DESC_F_LOAD_W) {
+        m->wslot_addr[slot] = d->src_addr;
+        m->wslot_dim[slot] = dim;
+        if (REG(m, HOCS_CONTROL_OFFSET) & HOCS_CTRL_CRC_EN) {
+            model_checksum(m, d);
+        }
+        d->status = HOCS_DESC_DONE;
+        m->dma_bytes += (uint64_t)dim * dim * sizeof(float);
+    } else {
+        const uint8_t *a = (const uint8_t *)(uintptr_t)d->src_addr;
+        const void *b = (d->flags & HOCS_DESC_F_RESIDENT) ? (const void *)(uintptr_t)m->wslot_addr[slot] :
+                        a + (size_t)dim * dim * model_elem_bytes(HOCS_DESC_IN_FMT(d->flags));
+        uint64_t in_bytes, out_bytes;
+
+        if (m->functional) {
+            model_execute(m, a, b, (void *)(uintptr_t)d->dst_addr, d->flags, dim, rows);
+        }
+        if (REG(m, HOCS_CONTROL_OFFSET) & HOCS_CTRL_CRC_EN) {
+            model_checksum(m, d);
+        }
+        d->status = HOCS_DESC_DONE;
+        model_desc_bytes(d, &in_bytes, &out_bytes);
+        m->dma_bytes += in_bytes + out_bytes;
+    }
+
+    m->hw_idx++;
+    m->jobs++;
+    REG(m, HOCS_RING_COMPLETED_OFFSET) = m->hw_idx;
+    if (REG(m, HOCS_CONTROL_OFFSET) & HOCS_CTRL_DB_SHADOW) {
+        __atomic_store_n((uint32_t *)(uintptr_t)(model_db_page(m) + HOCS_DB_CQ_TAIL),
+                         m->hw_idx, __ATOMIC_RELEASE);    // After the status word
+    }
+    REG(m, HOCS_IRQ_STATUS_OFFSET) |= HOCS_IRQ_DONE;
+    model_update_irq(m);
+}
+
+/*
+ * hocs_model_advance
+ * Runs the engine up to the current clock. Back-to-back descriptors start
+ * at the previous completion time, not at the time of the call.
+ */
+void hocs_model_advance(hocs_model_t *m) {
+    uint64_t now = m->clock_ns();
+    uint64_t t = now;
+
+    for (;;) {
+        if (m->busy) {
+            if (now < m->busy_until_ns) break;
+            model_complete(m);
+            m->busy = 0;
+            t = m->busy_until_ns;
+        }
+
+        if (!(REG(m, HOCS_CONTROL_OFFSET) & HOCS_CTRL_DMA_EN)) break;
+        if (m->hw_idx == model_doorbell(m)) break;
+
+        hocs_desc_t *d = model_desc(m, m->hw_idx);
+        uint64_t in_ns, compute_ns, out_ns;
+        uint64_t job_ns = model_desc_phases(m, d, &in_ns, &compute_ns, &out_ns);
+
+        d->ts_start = t;
+        m->busy = 1;
+        m->busy_until_ns = t + job_ns;
+        m->busy_ns += job_ns;
+    }
+}
+
+/*
+ * ======================================================================================
+ * MMIO INTERFACE
+ * ======================================================================================
+ */
+
+uint32_t hocs_model_read(hocs_model_t *m, uint32_t offset) {
+    if (offset >= HOCS_MODEL_REG_WORDS * 4) {
+        return 0;
+    }
+
+    hocs_model_advance(m);
+
+    if (offset == HOCS_LASER_POWER_OFFSET || offset == HOCS_PHASE_SHIFT_OFFSET ||
+        offset == HOCS_CHAN_MONITOR_OFFSET) {
+        uint32_t ch = REG(m, HOCS_CHAN_SEL_OFFSET);
+        if (ch >= HOCS_NUM_CHANNELS) return 0;
+        if (offset == HOCS_LASER_POWER_OFFSET) return m->chan_power[ch];
+        if (offset == HOCS_PHASE_SHIFT_OFFSET) return m->chan_phase[ch];
+        return model_monitor_uw(m, ch);
+    }
+
+    if (offset == HOCS_STATUS_OFFSET) {
+        uint32_t st = m->busy ? HOCS_STATUS_BUSY : HOCS_STATUS_IDLE;
+        if (REG(m, HOCS_IRQ_STATUS_OFFSET) & HOCS_IRQ_DONE) st |= HOCS_STATUS_DONE;
+        if (REG(m, HOCS_IRQ_STATUS_OFFSET) & HOCS_IRQ_ERROR) st |= HOCS_STATUS_ERROR;
+        return st;
+    }
+
+    return REG(m, offset);
+}
+
+void hocs_model_write(hocs_model_t *m, uint32_t offset, uint32_t val) {
+    if (offset >= HOCS_MODEL_REG_WORDS * 4) {
+        return;
+    }
+
+    hocs_model_advance(m);
+
+    switch (offset) {
+        case HOCS_CONTROL_OFFSET:
+            if (val & HOCS_CTRL_RESET) {
+                m->busy = 0;
+                m->hw_idx = 0;
+                for (int i = 0; i < HOCS_WEIGHT_SLOTS; i++) {
+                    m->wslot_dim[i] = 0;    // URAM contents are lost
+                }
+                REG(m, HOCS_RING_DOORBELL_OFFSET) = 0;
+                REG(m, HOCS_RING_COMPLETED_OFFSET) = 0;
+                REG(m, HOCS_IRQ_STATUS_OFFSET) = 0;
+                val &= ~HOCS_CTRL_RESET;
+            }
+            REG(m, offset) = val;
+            break;
+
+        case HOCS_IRQ_STATUS_OFFSET:
+            REG(m, offset) &= ~val; // W1C
+            break;
+
+        case HOCS_IRQ_ENABLE_OFFSET:
+            REG(m, offset) = val;
+            model_update_irq(m);    // Level-sensitive: re-assert if pending
+            break;
+
+        case HOCS_LASER_POWER_OFFSET:
+        case HOCS_PHASE_SHIFT_OFFSET: {
+            uint32_t ch = REG(m, HOCS_CHAN_SEL_OFFSET);
+            if (ch < HOCS_NUM_CHANNELS) {
+                if (offset == HOCS_LASER_POWER_OFFSET) m->chan_power[ch] = (uint16_t)(val & HOCS_DAC_MAX);
+                else m->chan_phase[ch] = (uint16_t)(val & (HOCS_PHASE_STEPS - 1));
+            }
+            break;
+        }
+
+        case HOCS_RING_COMPLETED_OFFSET:
+        case HOCS_STATUS_OFFSET:
+        case HOCS_CHAN_MONITOR_OFFSET:
+            break;                  // Read-only
+
+        default:
+            REG(m, offset) = val;
+            break;
+    }
+
+    hocs_model_advance(m);
+}
@@ -0,0 +1,696 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_quant.c
+ * Module:      HOCS Operand Quantization Implementation
+ * Author:      PhotonX R&D Team
+ * ======================================================================================
+ */
+
+#include "drivers/hocs_quant.h"
+#include "drivers/hocs_model.h"
+#include "drivers/hocs_lincal.h"
+#include "kernel/timer_heavy.h"
+#include "lib/crc32c.h"
+#include "lib/kprintf.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+static inline float q_abs(float v) {
+    return (v < 0.0f) ? -v : v;
+}
+
+static inline int8_t q_round_i8(float v) {
+    int32_t r = (int32_t)(v + ((v >= 0.0f) ? 0.5f : -0.5f));
+    return (int8_t)((r > 127) ? 127 : (r < -127) ? -127 : r);
+}
+
+/* Largest |x| over 'count' floats */
+static float q_absmax(const float *x, uint32_t count) {
+    float m = 0.0f;
+    uint32_t i = 0;
+#if defined(__ARM_NEON)
+    float32x4_t vm = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        vm = vmaxq_f32(vm, vabsq_f32(vld1q_f32(x + i)));
+    }
+    m = vmaxvq_f32(vm);
+#endif
+    for (; i < count; i++) {
+        float a = q_abs(x[i]);
+        m = (a > m) ? a : m;
+    }
+    return m;
+}
+
+/*
+ * Row packers. 'r' (may be NULL) is a running CRC-32C register: every
+ * 8 bytes are folded in straight from the vector just stored, the scalar
+ * tail from memory while it is still in L1.
+ */
+
+/* q[j] = round(x[j] * inv[j]) (per column) or round(x[j] * k) */
+static void q_row_i8(const float *x, int8_t *q, uint32_t cols, const float *inv, float k,
+                     uint32_t *r) {
+    uint32_t j = 0, j0;
+#if defined(__ARM_NEON)
+    const float32x4_t vk = vdupq_n_f32(k);
+    for (; j + 8 <= cols; j += 8) {
+        float32x4_t k0 = inv ? vld1q_f32(inv + j) : vk;
+        float32x4_t k1 = inv ? vld1q_f32(inv + j + 4) : vk;
+        int32x4_t i0 = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(x + j), k0));
+        int32x4_t i1 = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(x + j + 4), k1));
+        int8x8_t v = vqmovn_s16(vcombine_s16(vqmovn_s32(i0), vqmovn_s32(i1)));
+        vst1_s8(q + j, v);
+        if (r) *r = crc32c_u64(*r, vget_lane_u64(vreinterpret_u64_s8(v), 0));
+    }
+#endif
+    for (j0 = j; j < cols; j++) {
+        q[j] = q_round_i8(x[j] * (inv ? inv[j] : k));
+    }
+    if (r && j0 < cols) {
+        *r = ~crc32c(~*r, q + j0, cols - j0);
+    }
+}
+
+static void q_row_f16(const float *x, uint16_t *q, uint32_t cols, uint32_t *r) {
+    uint32_t j = 0, j0;
+#if defined(__ARM_NEON)
+    for (; j + 4 <= cols; j += 4) {
+        uint16x4_t v = vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(x + j)));
+        vst1_u16(q + j, v);
+        if (r) *r = crc32c_u64(*r, vget_lane_u64(vreinterpret_u64_u16(v), 0));
+    }
+#endif
+    for (j0 = j; j < cols; j++) {
+        q[j] = hocs_f32_to_f16(x[j]);
+    }
+    if (r && j0 < cols) {
+        *r = ~crc32c(~*r, q + j0, (cols - j0) * sizeof(uint16_t));
+    }
+}
+
+size_t hocs_quant_bytes(uint32_t fmt, uint32_t rows, uint32_t cols) {
+    size_t elem = (fmt == HOCS_FMT_INT8) ? 1 : (fmt == HOCS_FMT_FP16) ? 2 : 4;
+    return elem * rows * cols;
+}
+
+/*
+ * hocs_quantize
+ * Packs a rows x cols fp32 matrix into 'fmt'. int8 scales go to 'scale'
+ * ([1], [rows] or [cols] by 'gran'); fp16/fp32 get scale 1. Returns the
+ * largest magnitude in the packed domain (for result range checks).
+ */
+float hocs_quantize(const float *x, uint32_t rows, uint32_t cols, uint32_t fmt, uint32_t gran,
+                    void *q, float *scale) {
+    return hocs_quantize_crc(x, rows, cols, fmt, gran, q, scale, NULL);
+}
+
+/*
+ * hocs_quantize_crc
+ * hocs_quantize() that also continues the CRC-32C in '*crc' over the
+ * packed bytes (start from 0), in the same pass.
+ */
+float hocs_quantize_crc(const float *x, uint32_t rows, uint32_t cols, uint32_t fmt, uint32_t gran,
+                        void *q, float *scale, uint32_t *crc) {
+    uint32_t nscale = (gran == HOCS_Q_ROW) ? rows : (gran == HOCS_Q_COL) ? cols : 1;
+    uint32_t reg = crc ? ~*crc : 0;
+    uint32_t *rp = crc ? &reg : NULL;
+    float inv[HOCS_MAX_DIM];
+    float amax = 0.0f;
+
+    /* 1. Plain formats */
+    if (fmt != HOCS_FMT_INT8) {
+        for (uint32_t i = 0; i < nscale; i++) scale[i] = 1.0f;
+        for (uint32_t r = 0; r < rows; r++) {
+            const float *row = x + (size_t)r * cols;
+            float m = q_absmax(row, cols);
+            amax = (m > amax) ? m : amax;
+            if (fmt == HOCS_FMT_FP16) {
+                q_row_f16(row, (uint16_t *)q + (size_t)r * cols, cols, rp);
+            } else if (rp) {
+                reg = ~crc32c_copy(~reg, (float *)q + (size_t)r * cols, row, cols * sizeof(float));
+            } else {
+                float *d = (float *)q + (size_t)r * cols;
+                for (uint32_t j = 0; j < cols; j++) d[j] = row[j];
+            }
+        }
+        if (crc) *crc = ~reg;
+        return amax;
+    }
+
+    /* 2. int8 scales: absmax / 127 (zero rows/columns get 1) */
+    if (gran == HOCS_Q_ROW) {
+        for (uint32_t r = 0; r < rows; r++) scale[r] = q_absmax(x + (size_t)r * cols, cols);
+    } else if (gran == HOCS_Q_COL && cols <= HOCS_MAX_DIM) {
+        for (uint32_t j = 0; j < cols; j++) scale[j] = 0.0f;
+        for (uint32_t r = 0; r < rows; r++) {
+            const float *row = x + (size_t)r * cols;
+            for (uint32_t j = 0; j < cols; j++) {
+                float a = q_abs(row[j]);
+                scale[j] = (a > scale[j]) ? a : scale[j];
+            }
+        }
+    } else {
+        nscale = 1;
+        scale[0] = q_absmax(x, rows * cols);
+    }
+    for (uint32_t i = 0; i < nscale; i++) {
+        scale[i] = (scale[i] > 0.0f) ? scale[i] / 127.0f : 1.0f;
+        if (nscale == cols && gran == HOCS_Q_COL) inv[i] = 1.0f / scale[i];
+    }
+
+    /* 3. Pack */
+    for (uint32_t r = 0; r < rows; r++) {
+        const float *row = x + (size_t)r * cols;
+        int8_t *d = (int8_t *)q + (size_t)r * cols;
+
+        if (gran == HOCS_Q_COL && nscale == cols) {
+            q_row_i8(row, d, cols, inv, 0.0f, rp);
+        } else {
+            q_row_i8(row, d, cols, NULL, 1.0f / scale[(gran == HOCS_Q_ROW) ? r : 0], rp);
+        }
+    }
+    if (crc) *crc = ~reg;
+    return 127.0f;
+}
+
+/*
+ * hocs_dequantize
+ * out[i][j] = q[i][j] * k * row_scale[i] * col_scale[j]; either scale
+ * array may be NULL (1).
+ */
+void hocs_dequantize(const void *q, uint32_t fmt, uint32_t rows, uint32_t cols,
+                     const float *row_scale, const float *col_scale, float k, float *out) {
+    hocs_dequantize_crc(q, fmt, rows, cols, row_scale, col_scale, k, out, NULL);
+}
+
+/*
+ * hocs_dequantize_crc
+ * hocs_dequantize() that also continues the CRC-32C in '*crc' over the
+ * bytes of 'q' as they are loaded.
+ */
+void hocs_dequantize_crc(const void *q, uint32_t fmt, uint32_t rows, uint32_t cols,
+                         const float *row_scale, const float *col_scale, float k, float *out,
+                         uint32_t *crc) {
+    size_t elem = hocs_quant_bytes(fmt, 1, 1);
+    uint32_t reg = crc ? ~*crc : 0;
+
+    for (uint32_t r = 0; r < rows; r++) {
+        float rk = row_scale ? k * row_scale[r] : k;
+        float *o = out + (size_t)r * cols;
+        size_t base = (size_t)r * cols;
+        uint32_t j = 0;
+#if defined(__ARM_NEON)
+        const float32x4_t vk = vdupq_n_f32(rk);
+        for (; j + 8 <= cols; j += 8) {
+            float32x4_t v0, v1;
+            if (fmt == HOCS_FMT_INT8) {
+                int8x8_t b = vld1_s8((const int8_t *)q + base + j);
+                int16x8_t h = vmovl_s8(b);
+                if (crc) reg = crc32c_u64(reg, vget_lane_u64(vreinterpret_u64_s8(b), 0));
+                v0 = vcvtq_f32_s32(vmovl_s16(vget_low_s16(h)));
+                v1 = vcvtq_f32_s32(vmovl_s16(vget_high_s16(h)));
+            } else if (fmt == HOCS_FMT_FP16) {
+                const uint16_t *p = (const uint16_t *)q + base + j;
+                uint16x4_t h0 = vld1_u16(p), h1 = vld1_u16(p + 4);
+                if (crc) {
+                    reg = crc32c_u64(reg, vget_lane_u64(vreinterpret_u64_u16(h0), 0));
+                    reg = crc32c_u64(reg, vget_lane_u64(vreinterpret_u64_u16(h1), 0));
+                }
+                v0 = vcvt_f32_f16(vreinterpret_f16_u16(h0));
+                v1 = vcvt_f32_f16(vreinterpret_f16_u16(h1));
+            } else {
+                v0 = vld1q_f32((const float *)q + base + j);
+                v1 = vld1q_f32((const float *)q + base + j + 4);
+                if (crc) {
+                    reg = crc32c_u64(reg, vgetq_lane_u64(vreinterpretq_u64_f32(v0), 0));
+                    reg = crc32c_u64(reg, vgetq_lane_u64(vreinterpretq_u64_f32(v0), 1));
+                    reg = crc32c_u64(reg, vgetq_lane_u64(vreinterpretq_u64_f32(v1), 0));
+                    reg = crc32c_u64(reg, vgetq_lane_u64(vreinterpretq_u64_f32(v1), 1));
+                }
+            }
+            v0 = vmulq_f32(v0, vk);
+            v1 = vmulq_f32(v1, vk);
+            if (col_scale) {
+                v0 = vmulq_f32(v0, vld1q_f32(col_scale + j));
+                v1 = vmulq_f32(v1, vld1q_f32(col_scale + j + 4));
+            }
+            vst1q_f32(o + j, v0);
+            vst1q_f32(o + j + 4, v1);
+        }
+#endif
+        if (crc && j < cols) {
+            reg = ~crc32c(~reg, (const uint8_t *)q + (base + j) * elem, (cols - j) * elem);
+        }
+        for (; j < cols; j++) {
+            float v = (fmt == HOCS_FMT_INT8) ? (float)((const int8_t *)q)[base + j] :
+                      (fmt == HOCS_FMT_FP16) ? hocs_f16_to_f32(((const uint16_t *)q)[base + j]) :
+                      ((const float *)q)[base + j];
+            o[j] = v * rk * (col_scale ? col_scale[j] : 1.0f);
+        }
+    }
+    if (crc) *crc = ~reg;
+}
+
+/*
+ * hocs_quant_job
+ * Quantizes the operands into 'src' and fills 'job' to compute
+ * rows x n result C into 'dst'. b != NULL: full job (A and B packed back
+ * to back; rows must be n). b == NULL: resident job against job->weights,
+ * which the caller sets. With cfg->crc the packing pass checksums what it
+ * writes, so the driver does not read 'src' again to verify the input,
+ * and the result checksum is left to hocs_quant_result().
+ */
+int hocs_quant_job(hocs_qjob_t *qj, hocs_job_t *job, const hocs_qcfg_t *cfg,
+                   const float *a, const float *b, uint32_t rows, uint32_t n, void *src, void *dst) {
+    float amax, bmax, bound;
+    uint32_t crc;
+
+    if (cfg->in_fmt > HOCS_FMT_INT8 || (cfg->out_fmt != HOCS_FMT_FP32 && cfg->out_fmt != HOCS_FMT_FP16) ||
+        n == 0 || n > HOCS_MAX_DIM || rows == 0 || rows > n || (b && rows != n) ||
+        cfg->a_gran == HOCS_Q_COL || cfg->b_gran == HOCS_Q_ROW) {
+        return HOCS_ERR_INVALID;
+    }
+
+    qj->cfg = *cfg;
+    qj->rows = rows;
+    qj->n = n;
+    qj->dst = dst;
+    qj->job = cfg->crc ? job : NULL;
+    crc = 0;
+
+    /* 1. Pack (A then B: one checksum over the input DMA) */
+    amax = hocs_quantize_crc(a, rows, n, cfg->in_fmt, cfg->a_gran, src, qj->a_scale,
+                             cfg->crc ? &crc : NULL);
+    if (b) {
+        bmax = hocs_quantize_crc(b, n, n, cfg->in_fmt, cfg->b_gran,
+                                 (uint8_t *)src + hocs_quant_bytes(cfg->in_fmt, n, n), qj->b_scale,
+                                 cfg->crc ? &crc : NULL);
+    } else {
+        qj->cfg.b_gran = HOCS_Q_TENSOR;
+        qj->b_scale[0] = 1.0f;
+        bmax = cfg->w_absmax;
+    }
+
+    /* 2. fp16 results: shift the worst case product sum into range */
+    qj->shift = 0;
+    if (cfg->out_fmt == HOCS_FMT_FP16) {
+        bound = amax * bmax * (float)n;
+        while (bound > HOCS_QUANT_FP16_LIMIT && qj->shift < 15) {
+            bound *= 0.5f;
+            qj->shift++;
+        }
+    }
+
+    /* 3. Descriptor */
+    job->src_addr = (uint64_t)(uintptr_t)src;
+    job->dst_addr = (uint64_t)(uintptr_t)dst;
+    job->matrix_dim = n;
+    job->flags = HOCS_DESC_F_IN_FMT(cfg->in_fmt) | HOCS_DESC_F_OUT_SHIFT(qj->shift) |
+                 ((cfg->out_fmt == HOCS_FMT_FP16) ? HOCS_DESC_F_OUT_FP16 : 0);
+    if (cfg->crc) {
+        job->src_crc = crc;
+        job->flags |= HOCS_JOB_F_SRC_CRC | HOCS_JOB_F_DST_DEFER;
+    }
+    if (b) {
+        job->weights = 0;
+        job->rows = 0;
+    } else {
+        job->rows = rows;
+    }
+    return HOCS_OK;
+}
+
+/*
+ * hocs_quant_result
+ * fp32 result of a completed quantized job. If the driver left the result
+ * check to us (HOCS_VERIFY_PENDING), the result is checked against the
+ * IP's output checksum in the same pass: HOCS_ERR_CRC on a mismatch ('c'
+ * is then filled from the corrupt result).
+ */
+int hocs_quant_result(const hocs_qjob_t *qj, float *c) {
+    hocs_job_t *job = qj->job;
+    int check = job && job->verified == HOCS_VERIFY_PENDING;
+    float k = (float)(1U << qj->shift);
+    uint32_t crc = 0;
+
+    if (qj->cfg.a_gran == HOCS_Q_TENSOR) k *= qj->a_scale[0];
+    if (qj->cfg.b_gran == HOCS_Q_TENSOR) k *= qj->b_scale[0];
+
+    hocs_dequantize_crc(qj->dst, qj->cfg.out_fmt, qj->rows, qj->n,
+                        (qj->cfg.a_gran == HOCS_Q_ROW) ? qj->a_scale : NULL,
+                        (qj->cfg.b_gran == HOCS_Q_COL) ? qj->b_scale : NULL, k, c,
+                        check ? &crc : NULL);
+    if (check && crc != job->dst_crc) {
+        kprintf("[HOCS] ERR: Job %u result checksum %x, IP wrote %x\n", job->tag, crc, job->dst_crc);
+        job->verified = HOCS_VERIFY_INPUT;
+        return HOCS_ERR_CRC;
+    }
+    if (check) {
+        job->verified = HOCS_VERIFY_FULL;
+    }
+    return HOCS_OK;
+}
+
+/*
+ * hocs_quant_error
+ * Error statistics of x against ref, overall and per block x block tile.
+ */
+void hocs_quant_error(const float *ref, const float *x, uint32_t rows, uint32_t cols,
+                      uint32_t block, hocs_qerr_t *e) {
+    float sig = 0.0f, err = 0.0f, max_ref = 0.0f, max_err = 0.0f, worst = 0.0f;
+
+    e->blocks = 0;
+    e->worst_row = 0;
+    e->worst_col = 0;
+
+    for (uint32_t r0 = 0; r0 < rows; r0 += block) {
+        for (uint32_t c0 = 0; c0 < cols; c0 += block) {
+            float bs = 0.0f, be = 0.0f;
+
+            for (uint32_t r = r0; r < r0 + block && r < rows; r++) {
+                for (uint32_t c = c0; c < c0 + block && c < cols; c++) {
+                    float v = ref[(size_t)r * cols + c];
+                    float d = x[(size_t)r * cols + c] - v;
+                    bs += v * v;
+                    be += d * d;
+                    max_ref = (q_abs(v) > max_ref) ? q_abs(v) : max_ref;
+                    max_err = (q_abs(d) > max_err) ? q_abs(d) : max_err;
+                }
+            }
+            sig += bs;
+            err += be;
+            e->blocks++;
+
+            /* Compare squared ratios, take the root once at the end */
+            if (bs > 0.0f && be / bs > worst) {
+                worst = be / bs;
+                e->worst_row = r0;
+                e->worst_col = c0;
+            }
+        }
+    }
+
+    e->max_ppm = (max_ref > 0.0f) ? (uint32_t)(max_err / max_ref * 1e6f) : 0;
+    e->rms_ppm = 0;
+    e->worst_block_ppm = 0;
+
+    /* sqrt by Newton, no libm */
+    for (uint32_t pass = 0; pass < 2; pass++) {
+        float v = pass ? worst : ((sig > 0.0f) ? err / sig : 0.0f);
+        float s = (v > 1.0f) ? v : 1.0f;
+        if (v <= 0.0f) continue;
+        for (uint32_t i = 0; i < 40; i++) s = 0.5f * (s + v / s);
+        if (pass) e->worst_block_ppm = (uint32_t)(s * 1e6f);
+        else e->rms_ppm = (uint32_t)(s * 1e6f);
+    }
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK: ACCURACY, DMA BYTES, PACK/UNPACK THROUGHPUT
+ * ======================================================================================
+ * 1. Accuracy: 256x256 full jobs on the functional model, operands with
+ *    rows and columns spanning 8 octaves of magnitude (where per-channel
+ *    scales matter), against the fp32 product. 32x32 error blocks.
+ * 2. The same jobs through the model's analog readout, raw and with the
+ *    linearity correction, so the formats' own error can be told from the
+ *    readout's.
+ * 3. IP time per 256-row resident job on the timing model, by format.
+ * 4. CPU pack/unpack rates over a buffer beyond L2, in fp32 bytes.
+ * 5. CRC-32C over the same buffer: the 3-way CRC32CX loop against the
+ *    byte-wise table, then each pass of 4. with and without the checksum
+ *    folded in (time added, in fp32 bytes).
+ */
+
+#define BENCH_N                 256
+#define BENCH_BLOCK             32
+#define BENCH_JOBS              32
+#define BENCH_STREAM_ROWS       4096        // x BENCH_N fp32 = 4 MB
+#define BENCH_PASSES            4
+#define BENCH_STREAM_BYTES      ((uint64_t)BENCH_STREAM_ROWS * BENCH_N * sizeof(float))
+
+/* Fused pass kinds (section 5) */
+#define BENCH_PACK_INT8         0
+#define BENCH_PACK_FP16         1
+#define BENCH_UNPACK_FP16       2
+
+typedef struct {
+    const char *name;
+    hocs_qcfg_t cfg;
+} bench_cfg_t;
+
+static const bench_cfg_t bench_cfgs[] = {
+    { "fp32 -> fp32        ", { HOCS_FMT_FP32, HOCS_FMT_FP32, HOCS_Q_TENSOR, HOCS_Q_TENSOR, 0.0f, 0 } },
+    { "fp16 -> fp32        ", { HOCS_FMT_FP16, HOCS_FMT_FP32, HOCS_Q_TENSOR, HOCS_Q_TENSOR, 0.0f, 0 } },
+    { "fp16 -> fp16        ", { HOCS_FMT_FP16, HOCS_FMT_FP16, HOCS_Q_TENSOR, HOCS_Q_TENSOR, 0.0f, 0 } },
+    { "int8 tensor -> fp32 ", { HOCS_FMT_INT8, HOCS_FMT_FP32, HOCS_Q_TENSOR, HOCS_Q_TENSOR, 0.0f, 0 } },
+    { "int8 channel -> fp32", { HOCS_FMT_INT8, HOCS_FMT_FP32, HOCS_Q_ROW, HOCS_Q_COL, 0.0f, 0 } },
+    { "int8 channel -> fp16", { HOCS_FMT_INT8, HOCS_FMT_FP16, HOCS_Q_ROW, HOCS_Q_COL, 0.0f, 0 } },
+};
+
+#define BENCH_CFGS              (sizeof(bench_cfgs) / sizeof(bench_cfgs[0]))
+
+static hocs_qjob_t bench_qj;
+static hocs_lincal_t bench_lc;
+
+/* One full quantized job, its result dequantized into 'c' */
+static int bench_full(const hocs_qcfg_t *cfg, const float *a, const float *b, uint8_t *src,
+                      float *dst, float *c) {
+    hocs_job_t job;
+    int rc;
+
+    rc = hocs_quant_job(&bench_qj, &job, cfg, a, b, BENCH_N, BENCH_N, src, (void *)dst);
+    job.done = NULL;
+    job.ctx = NULL;
+    job.scratch = NULL;
+    if (rc == HOCS_OK) rc = hocs_submit(&hocs_bench.dev[0], &job);
+    if (rc == HOCS_OK) rc = hocs_wait(&hocs_bench.dev[0], &job, 0);
+    if (rc == HOCS_OK) rc = hocs_quant_result(&bench_qj, c);
+    return rc;
+}
+
+/* fp32 bytes per second, GB/s with one decimal */
+static void bench_rate(const char *what, uint64_t bytes, uint64_t ns) {
+    uint64_t mb_s = bytes * 1000 / (ns ? ns : 1);
+    kprintf("  %s %lu.%lu GB/s\n", what, mb_s / 1000, (mb_s % 1000) / 100);
+}
+
+/* BENCH_PASSES of one pack or unpack pass over the stream */
+static uint64_t bench_pass(uint32_t kind, float *stream, uint8_t *src, uint32_t *crc) {
+    uint64_t t0 = timer_get_ticks();
+
+    for (uint32_t p = 0; p < BENCH_PASSES; p++) {
+        for (uint32_t r = 0; r < BENCH_STREAM_ROWS; r += BENCH_N) {
+            float *x = stream + (size_t)r * BENCH_N;
+            if (kind == BENCH_PACK_INT8) {
+                hocs_quantize_crc(x, BENCH_N, BENCH_N, HOCS_FMT_INT8, HOCS_Q_ROW, src,
+                                  bench_qj.a_scale, crc);
+            } else if (kind == BENCH_PACK_FP16) {
+                hocs_quantize_crc(x, BENCH_N, BENCH_N, HOCS_FMT_FP16, HOCS_Q_TENSOR, src,
+                                  bench_qj.a_scale, crc);
+            } else {
+                hocs_dequantize_crc(src, HOCS_FMT_FP16, BENCH_N, BENCH_N, bench_qj.a_scale,
+                                    bench_qj.b_scale, 2.0f, x, crc);
+            }
+        }
+    }
+    return timer_ticks_to_ns(timer_get_ticks() - t0);
+}
+
+static void bench_fused(const char *what, uint32_t kind, float *stream, uint8_t *src) {
+    uint64_t bytes = BENCH_PASSES * BENCH_STREAM_BYTES;
+    uint64_t plain = bench_pass(kind, stream, src, NULL);
+    uint32_t crc = 0;
+    uint64_t fused = bench_pass(kind, stream, src, &crc);
+    uint64_t plain_mb = bytes * 1000 / (plain ? plain : 1);
+    uint64_t fused_mb = bytes * 1000 / (fused ? fused : 1);
+
+    kprintf("  %s %lu.%lu -> %lu.%lu GB/s (+%lu%% time)\n", what,
+            plain_mb / 1000, (plain_mb % 1000) / 100, fused_mb / 1000, (fused_mb % 1000) / 100,
+            (fused > plain) ? (fused - plain) * 100 / (plain ? plain : 1) : 0);
+}
+
+void hocs_quant_benchmark(void) {
+    const size_t mat = (size_t)BENCH_N * BENCH_N;
+    size_t bytes = (6 * mat + (size_t)BENCH_STREAM_ROWS * BENCH_N) * sizeof(float);
+    float *a, *b, *ref, *c, *stream;
+    uint8_t *src;
+    uint32_t seed = 777, handle = 0;
+    uint64_t fp32_dma = 0, busy0, t0, ns;
+    hocs_job_t job;
+    hocs_qerr_t e;
+
+    a = (float *)hocs_buf_alloc(bytes);
+    if (a == NULL) {
+        kprintf("[HOCS] quant benchmark: out of memory\n");
+        return;
+    }
+    b = a + mat;
+    ref = b + mat;
+    c = ref + mat;
+    src = (uint8_t *)(c + mat);                 // 2 fp32 matrices' worth
+    stream = c + 3 * mat;
+
+    /* 1. Operands: row i of A and column j of B scaled by 2^-(i % 8), 2^-(j % 8) */
+    for (size_t i = 0; i < 2 * mat; i++) {
+        seed = seed * 1103515245U + 12345U;
+        a[i] = (float)((int32_t)(seed >> 16) % 2001 - 1000) / 1000.0f;
+    }
+    for (uint32_t i = 0; i < BENCH_N; i++) {
+        for (uint32_t j = 0; j < BENCH_N; j++) {
+            a[i * BENCH_N + j] /= (float)(1U << (i % 8));
+            b[i * BENCH_N + j] /= (float)(1U << (j % 8));
+        }
+    }
+    for (uint32_t i = 0; i < BENCH_N; i++) {
+        for (uint32_t j = 0; j < BENCH_N; j++) {
+            float acc = 0.0f;
+            for (uint32_t k = 0; k < BENCH_N; k++) acc += a[i * BENCH_N + k] * b[k * BENCH_N + j];
+            ref[i * BENCH_N + j] = acc;
+        }
+    }
+
+    kprintf("[HOCS] Quantized jobs, %ux%u (functional model, %ux%u error blocks):\n",
+            BENCH_N, BENCH_N, BENCH_BLOCK, BENCH_BLOCK);
+    for (uint32_t i = 0; i < BENCH_CFGS; i++) {
+        uint64_t dma;
+        int rc;
+
+        hocs_bench_init(0, "hocs-bench", hocs_bench_stepped_ns, 1);
+        rc = bench_full(&bench_cfgs[i].cfg, a, b, src, stream, c);
+        if (rc != HOCS_OK) {
+            kprintf("  %s: failed (%d)\n", bench_cfgs[i].name, rc);
+            continue;
+        }
+        hocs_quant_error(ref, c, BENCH_N, BENCH_N, BENCH_BLOCK, &e);
+
+        dma = hocs_bench.model[0].dma_bytes;
+        fp32_dma = fp32_dma ? fp32_dma : dma;
+        kprintf("  %s: DMA %lu KB (1/%lu.%lu), rms %u ppm, max %u ppm, worst block %u ppm @ (%u,%u)\n",
+                bench_cfgs[i].name, dma / 1024, fp32_dma / dma, (fp32_dma * 10 / dma) % 10,
+                e.rms_ppm, e.max_ppm, e.worst_block_ppm, e.worst_row, e.worst_col);
+    }
+
+    /* 2. Analog readout: raw, then corrected */
+    kprintf("[HOCS] Quantized jobs through the analog readout (raw / corrected):\n");
+    hocs_bench_init(0, "hocs-bench", hocs_bench_stepped_ns, 1);
+    hocs_bench.model[0].analog = 1;
+    hocs_lincal_attach(&hocs_bench.dev[0], &bench_lc);
+    if (hocs_lincal_calibrate(&bench_lc) != HOCS_OK) {
+        kprintf("  calibration failed\n");
+    }
+    for (uint32_t i = 0; i < BENCH_CFGS && bench_lc.valid; i++) {
+        hocs_qerr_t raw;
+
+        hocs_bench.dev[0].lincal = NULL;
+        if (bench_full(&bench_cfgs[i].cfg, a, b, src, stream, c) != HOCS_OK) {
+            kprintf("  %s: failed\n", bench_cfgs[i].name);
+            continue;
+        }
+        hocs_quant_error(ref, c, BENCH_N, BENCH_N, BENCH_BLOCK, &raw);
+        hocs_bench.dev[0].lincal = &bench_lc;
+        if (bench_full(&bench_cfgs[i].cfg, a, b, src, stream, c) != HOCS_OK) {
+            kprintf("  %s: failed\n", bench_cfgs[i].name);
+            continue;
+        }
+        hocs_quant_error(ref, c, BENCH_N, BENCH_N, BENCH_BLOCK, &e);
+        kprintf("  %s: rms %u / %u ppm, max %u / %u ppm, worst block %u / %u ppm\n",
+                bench_cfgs[i].name, raw.rms_ppm, e.rms_ppm, raw.max_ppm, e.max_ppm,
+                raw.worst_block_ppm, e.worst_block_ppm);
+    }
+    hocs_lincal_attach(&hocs_bench.dev[0], NULL);
+
+    /* 3. Modelled IP time of resident jobs */
+    kprintf("[HOCS] IP time per %u-row resident job (timing model):\n", BENCH_N);
+    for (uint32_t i = 0; i < BENCH_CFGS; i++) {
+        hocs_qcfg_t cfg = bench_cfgs[i].cfg;
+
+        if (cfg.a_gran != HOCS_Q_TENSOR && i != BENCH_CFGS - 1) {
+            continue;               // Granularity does not change the traffic
+        }
+        hocs_bench_init(0, "hocs-bench", hocs_bench_stepped_ns, 0);
+        cfg.w_absmax = 1.0f;
+        if (hocs_weights_register(&hocs_bench.dev[0], b, BENCH_N, &handle) != HOCS_OK) {
+            break;
+        }
+        busy0 = hocs_bench.model[0].busy_ns;     // Weight load included
+        for (uint32_t j = 0; j < BENCH_JOBS; j++) {
+            job.weights = handle;
+            job.done = NULL;
+            job.ctx = NULL;
+            job.scratch = NULL;
+            hocs_quant_job(&bench_qj, &job, &cfg, a, NULL, BENCH_N, BENCH_N, src, (void *)stream);
+            if (hocs_submit(&hocs_bench.dev[0], &job) != HOCS_OK ||
+                hocs_wait(&hocs_bench.dev[0], &job, 0) != HOCS_OK) {
+                break;
+            }
+        }
+        kprintf("  %s: %lu ns\n", bench_cfgs[i].name, (hocs_bench.model[0].busy_ns - busy0) / BENCH_JOBS);
+    }
+
+    /* 4. CPU pack / unpack */
+    for (size_t i = 0; i < (size_t)BENCH_STREAM_ROWS * BENCH_N; i++) {
+        stream[i] = a[i % (2 * mat)];
+    }
+    kprintf("[HOCS] Pack/unpack throughput (%u KB fp32):\n", BENCH_STREAM_ROWS * BENCH_N * 4 / 1024);
+
+    t0 = timer_get_ticks();
+    for (uint32_t p = 0; p < BENCH_PASSES; p++) {
+        for (uint32_t r = 0; r < BENCH_STREAM_ROWS; r += BENCH_N) {
+            hocs_quantize(stream + (size_t)r * BENCH_N, BENCH_N, BENCH_N, HOCS_FMT_INT8, HOCS_Q_ROW,
+                          src, bench_qj.a_scale);
+        }
+    }
+    ns = timer_ticks_to_ns(timer_get_ticks() - t0);
+    bench_rate("quantize int8 (per row):", (uint64_t)BENCH_PASSES * BENCH_STREAM_ROWS * BENCH_N * 4, ns);
+
+    t0 = timer_get_ticks();
+    for (uint32_t p = 0; p < BENCH_PASSES; p++) {
+        for (uint32_t r = 0; r < BENCH_STREAM_ROWS; r += BENCH_N) {
+            hocs_quantize(stream + (size_t)r * BENCH_N, BENCH_N, BENCH_N, HOCS_FMT_FP16, HOCS_Q_TENSOR,
+                          src, bench_qj.a_scale);
+        }
+    }
+    ns = timer_ticks_to_ns(timer_get_ticks() - t0);
+    bench_rate("convert fp16:           ", (uint64_t)BENCH_PASSES * BENCH_STREAM_ROWS * BENCH_N * 4, ns);
+
+    t0 = timer_get_ticks();
+    for (uint32_t p = 0; p < BENCH_PASSES; p++) {
+        for (uint32_t r = 0; r < BENCH_STREAM_ROWS; r += BENCH_N) {
+            hocs_dequantize(src, HOCS_FMT_FP16, BENCH_N, BENCH_N, bench_qj.a_scale, bench_qj.b_scale,
+                            2.0f, stream + (size_t)r * BENCH_N);
+        }
+    }
+    ns = timer_ticks_to_ns(timer_get_ticks() - t0);
+    bench_rate("dequantize fp16 result: ", (uint64_t)BENCH_PASSES * BENCH_STREAM_ROWS * BENCH_N * 4, ns);
+
+    /* 5. CRC-32C, standalone and fused */
+    kprintf("[HOCS] CRC-32C (%u KB, %s):\n", (uint32_t)(BENCH_STREAM_BYTES / 1024),
+#if defined(__ARM_FEATURE_CRC32)
+            "CRC32CX, 3 lanes");
+#else
+            "slicing-by-8");
+#endif
+    t0 = timer_get_ticks();
+    for (uint32_t p = 0; p < BENCH_PASSES; p++) {
+        seed = crc32c(seed, stream, BENCH_STREAM_BYTES);
+    }
+    ns = timer_ticks_to_ns(timer_get_ticks() - t0);
+    bench_rate("crc32c:                 ", BENCH_PASSES * BENCH_STREAM_BYTES, ns);
+
+    t0 = timer_get_ticks();
+    seed = crc32c_sw(seed, stream, BENCH_STREAM_BYTES);
+    ns = timer_ticks_to_ns(timer_get_ticks() - t0);
+    bench_rate("crc32c_sw (byte table): ", BENCH_STREAM_BYTES, ns);
+
+    bench_fused("quantize int8 (per row):", BENCH_PACK_INT8, stream, src);
+    bench_fused("convert fp16:           ", BENCH_PACK_FP16, stream, src);
+    bench_fused("dequantize fp16 result: ", BENCH_UNPACK_FP16, stream, src);
+
+    hocs_buf_free(a, bytes);
+}
@@ -0,0 +1,676 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_record.c
+ * Module:      HOCS Job-Stream Record and Replay Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * The capture hook runs in the submitter's context after the descriptor
+ * has been queued, so what is recorded is exactly what the driver
+ * accepted. Records are fixed size and written in place; the payload area
+ * starts after the last possible record while capturing and is moved down
+ * behind the last actual one by hocs_record_finish().
+ *
+ * Replay paces submissions on the device's clock (the model's, if one is
+ * attached), so a model on a virtual clock can only replay at speed 0.
+ * ======================================================================================
+ */
+
+#include "drivers/hocs_record.h"
+#include "drivers/hocs_model.h"
+#include "kernel/timer_heavy.h"
+#include "lib/crc16.h"
+#include "lib/kprintf.h"
+
+#define REC_ALIGN_UP(x)         (((x) + HOCS_REC_ALIGN - 1) & ~(uint64_t)(HOCS_REC_ALIGN - 1))
+
+/* Driver-side clock: the model's when one is attached */
+static inline uint64_t rec_now(hocs_device_t *dev) {
+    if (dev->model) {
+        return dev->model->clock_ns();
+    }
+    return timer_ticks_to_ns(timer_get_ticks());
+}
+
+/* Offset of the payload behind 'recs' records */
+static inline uint64_t rec_payload_off(uint32_t recs) {
+    return REC_ALIGN_UP(sizeof(hocs_rec_hdr_t) + (uint64_t)recs * sizeof(hocs_rec_t));
+}
+
+/* Streamed operand bytes of a job, as the IP reads them */
+static uint64_t rec_src_bytes(uint32_t flags, uint32_t dim, uint32_t rows) {
+    static const uint8_t elem[4] = { 4, 2, 1, 0 };
+    uint64_t eb = elem[HOCS_DESC_IN_FMT(flags)];
+
+    if (flags & HOCS_DESC_F_RESIDENT) {
+        return (uint64_t)(rows ? rows : dim) * dim * eb;
+    }
+    return 2ULL * dim * dim * eb;
+}
+
+/*
+ * rec_hash
+ * Multiply-rotate hash (as the weight cache's) over any byte length.
+ */
+static uint64_t rec_hash(const void *p, uint64_t bytes) {
+    const uint64_t *w = (const uint64_t *)p;
+    const uint8_t *t = (const uint8_t *)p;
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ bytes, v = 0;
+
+    for (uint64_t i = 0; i < bytes / 8; i++) {
+        h ^= w[i] * 0x87C37B91114253D5ULL;
+        h = ((h << 31) | (h >> 33)) * 0x4CF5AD432745937FULL;
+    }
+    for (uint64_t i = bytes & ~7ULL; i < bytes; i++) {
+        v = (v << 8) | t[i];
+    }
+    h ^= v * 0x87C37B91114253D5ULL;
+
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static void rec_copy(void *dst, const void *src, uint64_t bytes) {
+    uint64_t *d = (uint64_t *)dst;
+    const uint64_t *s = (const uint64_t *)src;
+    uint64_t i;
+
+    for (i = 0; i < bytes / 8; i++) {
+        d[i] = s[i];
+    }
+    for (i *= 8; i < bytes; i++) {
+        ((uint8_t *)dst)[i] = ((const uint8_t *)src)[i];
+    }
+}
+
+/*
+ * rec_store
+ * Appends 'bytes' to the payload. Returns its offset in HOCS_REC_ALIGN
+ * units, or HOCS_REC_NO_DATA when the log is full.
+ */
+static uint32_t rec_store(hocs_recorder_t *r, const void *p, uint64_t bytes) {
+    uint64_t off = r->hdr->payload_bytes;
+
+    if (off + REC_ALIGN_UP(bytes) > r->max_payload) {
+        return HOCS_REC_NO_DATA;
+    }
+    rec_copy(r->payload + off, p, bytes);
+    r->hdr->payload_bytes = off + REC_ALIGN_UP(bytes);
+    return (uint32_t)(off / HOCS_REC_ALIGN);
+}
+
+/*
+ * ======================================================================================
+ * CAPTURE
+ * ======================================================================================
+ */
+
+/*
+ * hocs_record_attach
+ * Starts capturing the next 'max_jobs' submissions to 'dev' into 'log'
+ * (64-byte aligned; in HOCS_REC_DATA mode whatever is left after the
+ * records holds the payload). NULL detaches.
+ */
+int hocs_record_attach(hocs_device_t *dev, hocs_recorder_t *r, void *log, size_t size,
+                       uint32_t max_jobs, uint32_t mode) {
+    uint64_t off = rec_payload_off(max_jobs);
+
+    dev->rec = NULL;
+    if (r == NULL) {
+        return HOCS_OK;
+    }
+    if (log == NULL || ((uintptr_t)log & (HOCS_REC_ALIGN - 1)) || max_jobs == 0 ||
+        mode > HOCS_REC_DATA || size < off) {
+        return HOCS_ERR_INVALID;
+    }
+
+    r->dev = dev;
+    r->mode = mode;
+    r->hdr = (hocs_rec_hdr_t *)log;
+    r->rec = (hocs_rec_t *)(r->hdr + 1);
+    r->payload = (uint8_t *)log + off;
+    r->max_recs = max_jobs;
+    r->max_payload = (mode == HOCS_REC_DATA) ? size - off : 0;
+    r->t_first = 0;
+    r->t_last = 0;
+    r->wnext = 0;
+    for (uint32_t i = 0; i < HOCS_REC_WEIGHTS; i++) {
+        r->wdata[i] = HOCS_REC_NO_DATA;
+    }
+
+    r->hdr->magic = HOCS_REC_MAGIC;
+    r->hdr->version = HOCS_REC_VERSION;
+    r->hdr->mode = (uint16_t)mode;
+    r->hdr->count = 0;
+    r->hdr->dropped = 0;
+    r->hdr->payload_bytes = 0;
+    r->hdr->span_ns = 0;
+    r->hdr->crc = 0;
+    r->hdr->rec_bytes = sizeof(hocs_rec_t);
+    r->hdr->reserved = 0;
+
+    asm volatile("" ::: "memory");
+    dev->rec = r;
+    return HOCS_OK;
+}
+
+/*
+ * rec_weights
+ * Payload offset of the resident matrix behind 'whash', stored on first use.
+ */
+static uint32_t rec_weights(hocs_recorder_t *r, uint64_t whash, const float *b, uint32_t dim) {
+    uint32_t i, off;
+
+    for (i = 0; i < HOCS_REC_WEIGHTS; i++) {
+        if (r->wdata[i] != HOCS_REC_NO_DATA && r->whash[i] == whash) {
+            return r->wdata[i];
+        }
+    }
+    off = rec_store(r, b, (uint64_t)dim * dim * sizeof(float));
+    if (off != HOCS_REC_NO_DATA) {
+        i = r->wnext++ % HOCS_REC_WEIGHTS;
+        r->whash[i] = whash;
+        r->wdata[i] = off;
+    }
+    return off;
+}
+
+/*
+ * hocs_record_submit
+ * 'job' has just been queued with descriptor flags 'flags'.
+ */
+void hocs_record_submit(hocs_device_t *dev, const hocs_job_t *job, uint32_t flags) {
+    hocs_recorder_t *r = dev->rec;
+    hocs_rec_hdr_t *hdr = r->hdr;
+    const void *src = (const void *)(uintptr_t)job->src_addr;
+    uint64_t now = rec_now(dev), bytes, dt;
+    hocs_rec_t *e;
+
+    if (hdr->count >= r->max_recs || hdr->dropped) {
+        hdr->dropped++;         // The log ends at the first job that did not fit
+        return;
+    }
+    e = &r->rec[hdr->count];
+
+    /* 1. Shape */
+    e->flags = (job->flags & ~HOCS_JOB_F_SW_MASK) | (flags & HOCS_DESC_F_RESIDENT);
+    e->dim = (uint16_t)job->matrix_dim;
+    e->rows = (uint16_t)((flags & HOCS_DESC_F_RESIDENT) ? job->rows : 0);
+    e->data = HOCS_REC_NO_DATA;
+    e->wdata = HOCS_REC_NO_DATA;
+    e->reserved = 0;
+    e->hash = 0;
+    e->whash = 0;
+    bytes = rec_src_bytes(e->flags, e->dim, e->rows);
+
+    /* 2. Contents */
+    if (r->mode >= HOCS_REC_HASH) {
+        e->hash = rec_hash(src, bytes);
+    }
+    if (flags & HOCS_DESC_F_RESIDENT) {
+        uint32_t slot = HOCS_DESC_SLOT(flags);
+        e->whash = dev->wslot[slot].hash;
+
+        if (r->mode == HOCS_REC_DATA) {
+            const float *b = dev->wstage + (size_t)slot * (HOCS_WEIGHT_SLOT_BYTES / sizeof(float));
+            e->wdata = rec_weights(r, e->whash, b, e->dim);
+            if (e->wdata == HOCS_REC_NO_DATA) {
+                hdr->dropped++;
+                return;
+            }
+        }
+    }
+    if (r->mode == HOCS_REC_DATA) {
+        e->data = rec_store(r, src, bytes);
+        if (e->data == HOCS_REC_NO_DATA) {
+            hdr->dropped++;
+            return;
+        }
+    }
+
+    /* 3. Timing */
+    if (hdr->count == 0) {
+        r->t_first = now;
+        r->t_last = now;
+    }
+    dt = now - r->t_last;
+    e->dt_ns = (dt > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : (uint32_t)dt;
+    r->t_last = now;
+    hdr->count++;
+}
+
+/*
+ * hocs_record_finish
+ * Detaches the recorder, packs the payload behind the last record and
+ * seals the header. Returns the log's size in bytes.
+ */
+size_t hocs_record_finish(hocs_recorder_t *r) {
+    hocs_rec_hdr_t *hdr = r->hdr;
+    uint64_t off, recs_end;
+    uint8_t *log = (uint8_t *)hdr;
+
+    if (r->dev->rec == r) {
+        r->dev->rec = NULL;
+    }
+
+    /* 1. Payload down behind the records (moving down, copy forwards) */
+    off = rec_payload_off(hdr->count);
+    if (log + off != r->payload) {
+        for (uint64_t i = 0; i < hdr->payload_bytes; i++) {
+            log[off + i] = r->payload[i];
+        }
+        r->payload = log + off;
+    }
+    recs_end = sizeof(*hdr) + (uint64_t)hdr->count * sizeof(hocs_rec_t);
+    for (uint64_t i = recs_end; i < off; i++) {
+        log[i] = 0;
+    }
+
+    /* 2. Seal */
+    hdr->span_ns = r->t_last - r->t_first;
+    hdr->crc = crc16_ccitt(hdr + 1, (uint32_t)(off + hdr->payload_bytes - sizeof(*hdr)));
+    return (size_t)(off + hdr->payload_bytes);
+}
+
+/*
+ * ======================================================================================
+ * REPLAY
+ * ======================================================================================
+ */
+
+static void replay_done(hocs_job_t *job, void *ctx) {
+    hocs_replay_t *rp = (hocs_replay_t *)ctx;
+    uint64_t now = rec_now(rp->dev), t = rp->t_submit[job - rp->job];
+
+    hocs_hist_add(&rp->latency, (now > t) ? now - t : 0);
+    if (job->state == HOCS_JOB_ERROR) {
+        rp->errors++;
+    }
+}
+
+/* Reaps; nonzero once 'since' is HOCS_REPLAY_TIMEOUT_US in the past */
+static int replay_reap(hocs_device_t *dev, uint64_t since) {
+    hocs_poll(dev, HOCS_RING_ENTRIES);
+    return timer_ticks_to_us(timer_get_ticks() - since) > HOCS_REPLAY_TIMEOUT_US;
+}
+
+/*
+ * replay_synth
+ * Stand-in weight matrix for a recorded hash: a fixed pattern stamped
+ * with the hash, so distinct hashes give distinct contents and the
+ * driver's cache sees the recorded hit/miss sequence.
+ */
+static void replay_synth(float *b, uint64_t whash) {
+    uint32_t *w = (uint32_t *)b;
+
+    w[0] = (uint32_t)whash;
+    w[1] = (uint32_t)(whash >> 32);
+}
+
+/*
+ * replay_weights
+ * Handle for a record's weight matrix, registering it if it is not
+ * resident under a handle this replay already holds.
+ */
+static int replay_weights(hocs_replay_t *rp, const hocs_rec_t *e, const uint8_t *payload,
+                          float *wbuf, uint32_t *handle) {
+    const float *b = wbuf;
+    uint32_t i;
+    int rc;
+
+    for (i = 0; i < HOCS_REC_WEIGHTS; i++) {
+        if (rp->handle[i] && rp->whash[i] == e->whash) {
+            if (hocs_weights_resident(rp->dev, rp->handle[i])) {
+                *handle = rp->handle[i];
+                return HOCS_OK;
+            }
+            break;
+        }
+    }
+    if (i == HOCS_REC_WEIGHTS) {
+        i = rp->wnext++ % HOCS_REC_WEIGHTS;
+    }
+
+    if (e->wdata != HOCS_REC_NO_DATA) {
+        b = (const float *)(payload + (uint64_t)e->wdata * HOCS_REC_ALIGN);
+    } else {
+        replay_synth(wbuf, e->whash);
+    }
+    rc = hocs_weights_register(rp->dev, b, e->dim, handle);
+    if (rc == HOCS_OK) {
+        rp->whash[i] = e->whash;
+        rp->handle[i] = *handle;
+    }
+    return rc;
+}
+
+/*
+ * hocs_replay
+ * Re-issues the jobs in 'log' on 'dev' at rp->speed_pct of the recorded
+ * rate (0: back to back), measuring each job from submission to reap.
+ * Jobs whose recorded time has passed go out immediately; how far behind
+ * schedule the worst one was is reported as max_lag_ns. Thread context,
+ * with the ring owned by the caller.
+ */
+int hocs_replay(hocs_device_t *dev, const void *log, size_t size, hocs_replay_t *rp) {
+    const hocs_rec_hdr_t *hdr = (const hocs_rec_hdr_t *)log;
+    const hocs_rec_t *recs = (const hocs_rec_t *)(hdr + 1);
+    const uint8_t *payload;
+    uint64_t off, t0, sched = 0, loads0 = dev->weight_loads;
+    uint8_t *pattern, *dst;
+    float *wbuf;
+    int rc = HOCS_OK;
+
+    /* 1. Validate */
+    if (hdr == NULL || size < sizeof(*hdr) || hdr->magic != HOCS_REC_MAGIC ||
+        hdr->version != HOCS_REC_VERSION || hdr->rec_bytes != sizeof(hocs_rec_t)) {
+        return HOCS_ERR_INVALID;
+    }
+    off = rec_payload_off(hdr->count);
+    if (off + hdr->payload_bytes > size ||
+        crc16_ccitt(hdr + 1, (uint32_t)(off + hdr->payload_bytes - sizeof(*hdr))) != hdr->crc) {
+        return HOCS_ERR_INVALID;
+    }
+    if (dev->user) {
+        return HOCS_ERR_BUSY;
+    }
+    payload = (const uint8_t *)log + off;
+
+    /* 2. Buffers: a shared result buffer, stand-in operands if not recorded */
+    pattern = (uint8_t *)hocs_buf_alloc_on(dev, 2 * HOCS_WEIGHT_SLOT_BYTES);
+    dst = (uint8_t *)hocs_buf_alloc_on(dev, HOCS_WEIGHT_SLOT_BYTES);
+    wbuf = (float *)hocs_buf_alloc(HOCS_WEIGHT_SLOT_BYTES);
+    if (pattern == NULL || dst == NULL || wbuf == NULL) {
+        rc = HOCS_ERR_INVALID;
+        goto out;
+    }
+    for (uint32_t i = 0; i < 2 * HOCS_WEIGHT_SLOT_BYTES; i++) {
+        pattern[i] = (uint8_t)(i * 7 + 0x30);
+    }
+    for (uint32_t i = 0; i < HOCS_MAX_DIM * HOCS_MAX_DIM; i++) {
+        wbuf[i] = (float)(i % 61) * (1.0f / 64.0f);
+    }
+
+    rp->dev = dev;
+    rp->jobs = 0;
+    rp->errors = 0;
+    rp->busy_retries = 0;
+    rp->weight_loads = 0;
+    rp->span_ns = hdr->span_ns;
+    rp->in_bytes = 0;
+    rp->max_lag_ns = 0;
+    rp->latency = (hocs_hist_t){ 0 };
+    rp->wnext = 0;
+    for (uint32_t i = 0; i < HOCS_REC_WEIGHTS; i++) {
+        rp->handle[i] = 0;
+    }
+    for (uint32_t i = 0; i < HOCS_RING_ENTRIES; i++) {
+        rp->job[i].state = HOCS_JOB_IDLE;
+    }
+
+    t0 = rec_now(dev);
+    for (uint32_t n = 0; n < hdr->count && rc == HOCS_OK; n++) {
+        const hocs_rec_t *e = &recs[n];
+        hocs_job_t *job = &rp->job[n & (HOCS_RING_ENTRIES - 1)];
+        uint64_t since = timer_get_ticks(), now = 0;
+
+        /* 3. Wait for the recorded arrival, then for the pool entry */
+        if (rp->speed_pct) {
+            sched += (uint64_t)e->dt_ns * 100 / rp->speed_pct;
+            while (rec_now(dev) - t0 < sched) {
+                hocs_poll(dev, HOCS_RING_ENTRIES);
+            }
+        }
+        while (job->state == HOCS_JOB_QUEUED) {
+            if (replay_reap(dev, since)) {
+                rc = HOCS_ERR_TIMEOUT;
+                break;
+            }
+        }
+
+        job->src_addr = (uint64_t)(uintptr_t)((e->data != HOCS_REC_NO_DATA) ?
+                        payload + (uint64_t)e->data * HOCS_REC_ALIGN : pattern);
+        job->dst_addr = (uint64_t)(uintptr_t)dst;
+        job->matrix_dim = e->dim;
+        job->flags = e->flags & ~HOCS_DESC_F_DRIVER_MASK;
+        job->done = replay_done;
+        job->ctx = rp;
+        job->scratch = NULL;
+        job->weights = 0;
+        job->rows = 0;
+
+        /* 4. Submit, reaping while the ring or the weight slots are full */
+        while (rc == HOCS_OK) {
+            int err = HOCS_OK;
+
+            if (e->flags & HOCS_DESC_F_RESIDENT) {
+                err = replay_weights(rp, e, payload, wbuf, &job->weights);
+                job->rows = e->rows;
+            }
+            if (err == HOCS_OK) {
+                now = rec_now(dev);
+                rp->t_submit[job - rp->job] = now;
+                err = hocs_submit(dev, job);
+            }
+            if (err == HOCS_OK) {
+                if (rp->speed_pct && now - t0 > sched && now - t0 - sched > rp->max_lag_ns) {
+                    rp->max_lag_ns = now - t0 - sched;
+                }
+                rp->jobs++;
+                rp->in_bytes += rec_src_bytes(e->flags, e->dim, e->rows);
+                break;
+            }
+            if (err != HOCS_ERR_BUSY && err != HOCS_ERR_EVICTED) {
+                rp->errors++;       // Not accepted by this driver: skipped
+                break;
+            }
+            rp->busy_retries++;
+            if (replay_reap(dev, since)) {
+                rc = HOCS_ERR_TIMEOUT;
+            }
+        }
+    }
+
+    /* 5. Drain */
+    for (uint32_t i = 0; i < HOCS_RING_ENTRIES; i++) {
+        if (rp->job[i].state == HOCS_JOB_QUEUED &&
+            hocs_wait(dev, &rp->job[i], HOCS_REPLAY_TIMEOUT_US) == HOCS_ERR_TIMEOUT) {
+            rc = HOCS_ERR_TIMEOUT;
+        }
+    }
+    rp->wall_ns = rec_now(dev) - t0;
+    rp->weight_loads = dev->weight_loads - loads0;
+
+out:
+    hocs_buf_free(pattern, 2 * HOCS_WEIGHT_SLOT_BYTES);
+    hocs_buf_free(dst, HOCS_WEIGHT_SLOT_BYTES);
+    hocs_buf_free(wbuf, HOCS_WEIGHT_SLOT_BYTES);
+    return rc;
+}
+
+/*
+ * hocs_replay_report
+ * Console summary of a replay: throughput and latency percentiles.
+ */
+void hocs_replay_report(const hocs_replay_t *rp, const char *label) {
+    const hocs_hist_t *h = &rp->latency;
+    uint64_t wall_us = rp->wall_ns / 1000 ? rp->wall_ns / 1000 : 1;
+
+    kprintf("[HOCS] Replay %s: %lu jobs (%lu errors) in %lu us, recorded %lu us, speed %u%%\n",
+            label, rp->jobs, rp->errors, wall_us, rp->span_ns / 1000, rp->speed_pct);
+    kprintf("  throughput: %lu jobs/s, %lu MB/s in, max lag %lu us, %lu retries, %lu weight loads\n",
+            rp->jobs * 1000000 / wall_us, rp->in_bytes / wall_us, rp->max_lag_ns / 1000,
+            rp->busy_retries, rp->weight_loads);
+    kprintf("  latency ns: mean %lu, p50 %lu, p90 %lu, p99 %lu, max %lu\n",
+            h->count ? h->sum_ns / h->count : 0, hocs_hist_percentile(h, 50),
+            hocs_hist_percentile(h, 90), hocs_hist_percentile(h, 99), h->max_ns);
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK: RECORD A MIXED STREAM, REPLAY IT AT 1x, 4x AND FLAT OUT (HOCS MODEL)
+ * ======================================================================================
+ * The "production" stream alternates quiet stretches (~40 us between jobs)
+ * with bursts that outrun the IP, mixing resident-weight jobs over more
+ * layers than there are weight slots with fp32 and int8 full jobs. It is
+ * recorded once per capture mode (the generator is deterministic), then
+ * the hash log is replayed on a fresh model at each speed and the data
+ * log (operands from the log itself) flat out. The model runs on the system
+ * timer, so pacing and latencies are real time; at 100% the replay
+ * latencies should match the recording's telemetry.
+ */
+
+#define BENCH_JOBS              2048
+#define BENCH_PHASE_JOBS        128
+#define BENCH_QUIET_NS          40000
+#define BENCH_BURST_NS          2000
+#define BENCH_LAYERS            6
+#define BENCH_LAYER_DIM         128
+#define BENCH_ROWS              16
+#define BENCH_OPS_FLOATS        (2 * 128 * 128 + 1024 * 16)
+#define BENCH_LOG_BYTES         (64UL << 20)
+
+static hocs_job_t bench_jobs[HOCS_RING_ENTRIES];
+static hocs_telem_t bench_telem;
+static hocs_recorder_t bench_rec;
+static hocs_replay_t bench_rp;
+
+/*
+ * bench_generate
+ * Issues the benchmark stream on 'dev' (deterministic apart from
+ * timing).
+ */
+static void bench_generate(hocs_device_t *dev, float *ops, float *dst, float *layers) {
+    uint32_t seed = 0x2545F491;
+    uint64_t next = hocs_bench_real_ns();
+
+    for (uint32_t i = 0; i < BENCH_JOBS; i++) {
+        hocs_job_t *job = &bench_jobs[i & (HOCS_RING_ENTRIES - 1)];
+        uint32_t mean = ((i / BENCH_PHASE_JOBS) & 1) ? BENCH_BURST_NS : BENCH_QUIET_NS;
+        uint32_t kind;
+
+        /* 1. Arrival (reaping throughout, as the IRQ would) */
+        seed = seed * 1664525 + 1013904223;
+        next += (seed >> 8) % (2 * mean);
+        do {
+            hocs_poll(dev, HOCS_RING_ENTRIES);
+        } while (hocs_bench_real_ns() < next || job->state == HOCS_JOB_QUEUED);
+
+        /* 2. Shape */
+        seed = seed * 1664525 + 1013904223;
+        kind = (seed >> 8) % 100;
+        job->src_addr = (uint64_t)(uintptr_t)(ops + ((seed >> 20) % 1024) * 16);
+        job->dst_addr = (uint64_t)(uintptr_t)dst;
+        job->done = NULL;
+        job->scratch = NULL;
+        job->weights = 0;
+        job->rows = 0;
+        job->flags = 0;
+        job->matrix_dim = 64;
+        if (kind >= 85) {
+            job->matrix_dim = 128;
+            job->flags = HOCS_DESC_F_IN_FMT(HOCS_FMT_INT8);
+        }
+
+        /* 3. Submit (resident jobs look their layer up by content) */
+        for (;;) {
+            int rc = HOCS_OK;
+
+            if (kind < 55) {
+                uint32_t l = (seed >> 4) % BENCH_LAYERS;
+                rc = hocs_weights_register(dev,
+                                           layers + (size_t)l * BENCH_LAYER_DIM * BENCH_LAYER_DIM,
+                                           BENCH_LAYER_DIM, &job->weights);
+                job->rows = BENCH_ROWS;
+            }
+            if (rc == HOCS_OK) {
+                rc = hocs_submit(dev, job);
+            }
+            if (rc == HOCS_OK) {
+                break;
+            }
+            hocs_poll(dev, HOCS_RING_ENTRIES);
+        }
+    }
+
+    for (uint32_t i = 0; i < HOCS_RING_ENTRIES; i++) {
+        hocs_wait(dev, &bench_jobs[i], HOCS_REPLAY_TIMEOUT_US);
+    }
+}
+
+void hocs_record_benchmark(void) {
+    static const uint32_t speeds[] = { 100, 400, 0 };
+    static const char *const mode_name[] = { "shape", "hash", "data" };
+    float *ops = (float *)hocs_buf_alloc(BENCH_OPS_FLOATS * sizeof(float));
+    float *dst = (float *)hocs_buf_alloc(HOCS_WEIGHT_SLOT_BYTES);
+    float *layers = (float *)hocs_buf_alloc(BENCH_LAYERS * BENCH_LAYER_DIM * BENCH_LAYER_DIM *
+                                            sizeof(float));
+    uint8_t *log = (uint8_t *)hocs_buf_alloc(BENCH_LOG_BYTES);
+    uint8_t *hlog = (uint8_t *)hocs_buf_alloc(BENCH_LOG_BYTES / 16);
+    size_t hbytes = 0, dbytes = 0;
+    hocs_device_t *dev;
+
+    if (ops == NULL || dst == NULL || layers == NULL || log == NULL || hlog == NULL) {
+        kprintf("[HOCS] record benchmark: out of memory\n");
+        goto out;
+    }
+    for (uint32_t i = 0; i < BENCH_OPS_FLOATS; i++) {
+        ops[i] = (float)(i % 251) * 0.01f;
+    }
+    for (uint32_t i = 0; i < BENCH_LAYERS * BENCH_LAYER_DIM * BENCH_LAYER_DIM; i++) {
+        layers[i] = (float)((i * 31) % 509) * 0.002f;
+    }
+
+    /* 1. Record the stream in each capture mode */
+    kprintf("[HOCS] Recording %u jobs (%u resident layers, %u weight slots):\n",
+            BENCH_JOBS, BENCH_LAYERS, HOCS_WEIGHT_SLOTS);
+    for (uint32_t mode = HOCS_REC_SHAPE; mode <= HOCS_REC_DATA; mode++) {
+        uint8_t *buf = (mode == HOCS_REC_HASH) ? hlog : log;
+        size_t cap = (mode == HOCS_REC_HASH) ? BENCH_LOG_BYTES / 16 : BENCH_LOG_BYTES;
+        size_t bytes;
+
+        dev = hocs_bench_init(0, "hocs-rec-bench", hocs_bench_real_ns, 0);
+        hocs_telemetry_attach(dev, &bench_telem);
+        hocs_record_attach(dev, &bench_rec, buf, cap, BENCH_JOBS, mode);
+        bench_generate(dev, ops, dst, layers);
+        bytes = hocs_record_finish(&bench_rec);
+        hocs_telemetry_attach(dev, NULL);
+
+        kprintf("  %s: %lu bytes (%lu per job), %u dropped, span %lu us, live p50 %lu ns, p99 %lu ns\n",
+                mode_name[mode], (uint64_t)bytes, (uint64_t)bytes / BENCH_JOBS,
+                ((hocs_rec_hdr_t *)buf)->dropped, ((hocs_rec_hdr_t *)buf)->span_ns / 1000,
+                hocs_hist_percentile(&bench_telem.hist[HOCS_PH_TOTAL], 50),
+                hocs_hist_percentile(&bench_telem.hist[HOCS_PH_TOTAL], 99));
+        if (mode == HOCS_REC_HASH) {
+            hbytes = bytes;
+        } else if (mode == HOCS_REC_DATA) {
+            dbytes = bytes;
+        }
+    }
+
+    /* 2. Replay the hash log at each speed, the data log flat out */
+    for (uint32_t i = 0; i <= sizeof(speeds) / sizeof(speeds[0]); i++) {
+        int data = (i == sizeof(speeds) / sizeof(speeds[0]));
+        int rc;
+
+        dev = hocs_bench_init(0, "hocs-rec-bench", hocs_bench_real_ns, 0);
+        bench_rp.speed_pct = data ? 0 : speeds[i];
+        rc = hocs_replay(dev, data ? log : hlog, data ? dbytes : hbytes, &bench_rp);
+        if (rc != HOCS_OK) {
+            kprintf("[HOCS] Replay failed (%d)\n", rc);
+            break;
+        }
+        hocs_replay_report(&bench_rp, data ? "data log" : "hash log");
+    }
+
+out:
+    hocs_buf_free(ops, BENCH_OPS_FLOATS * sizeof(float));
+    hocs_buf_free(dst, HOCS_WEIGHT_SLOT_BYTES);
+    hocs_buf_free(layers, BENCH_LAYERS * BENCH_LAYER_DIM * BENCH_LAYER_DIM * sizeof(float));
+    hocs_buf_free(log, BENCH_LOG_BYTES);
+    hocs_buf_free(hlog, BENCH_LOG_BYTES / 16);
+}
@@ -0,0 +1,310 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_stripe.c
+ * Module:      HOCS Multi-Port Striping Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Port choice only looks at ring occupancy (prod - cons), which both the
+ * submitter and the reaper keep current; no extra bookkeeping is shared
+ * with the completion path.
+ * ======================================================================================
+ */
+
+#include "drivers/hocs_stripe.h"
+#include "drivers/hocs_model.h"
+#include "kernel/timer_heavy.h"
+#include "mm/pmm.h"
+#include "lib/kprintf.h"
+
+static inline uint32_t port_depth(const hocs_device_t *dev) {
+    return dev->prod - dev->cons;
+}
+
+/* Is 'addr' in the DDR window 'dev''s buffers are homed in? */
+static int port_home(const hocs_device_t *dev, uint64_t addr) {
+    int high = addr >= ZYNQMP_DDR_HIGH_BASE;
+    return high == ((dev->buf_flags & PMM_F_HIGH) != 0);
+}
+
+int hocs_stripe_init(hocs_stripe_t *s, hocs_device_t *const *ports, uint32_t nports) {
+    if (nports == 0 || nports > HOCS_STRIPE_MAX_PORTS) {
+        return HOCS_ERR_INVALID;
+    }
+
+    s->nports = nports;
+    s->rr = 0;
+    s->home_hits = 0;
+    s->spills = 0;
+    s->matmuls = 0;
+    for (uint32_t i = 0; i < nports; i++) {
+        s->port[i] = ports[i];
+        s->jobs[i] = 0;
+    }
+    return HOCS_OK;
+}
+
+/*
+ * ======================================================================================
+ * JOB STRIPING
+ * ======================================================================================
+ */
+
+/*
+ * hocs_stripe_submit
+ * Queues 'job' on one port: its home port if the queues are roughly level,
+ * else the shortest queue. HOCS_ERR_BUSY only if every ring is full.
+ */
+int hocs_stripe_submit(hocs_stripe_t *s, hocs_job_t *job) {
+    uint32_t best = s->rr % s->nports, home = s->nports;
+    uint32_t pick;
+    int rc = HOCS_ERR_BUSY;
+
+    if (job == NULL || job->weights) {
+        return HOCS_ERR_INVALID;
+    }
+
+    /* 1. Shortest queue (rotating start breaks ties) and the home port */
+    for (uint32_t k = 0; k < s->nports; k++) {
+        uint32_t i = (s->rr + k) % s->nports;
+        if (port_depth(s->port[i]) < port_depth(s->port[best])) {
+            best = i;
+        }
+        if (home == s->nports && port_home(s->port[i], job->src_addr) &&
+            port_home(s->port[i], job->dst_addr)) {
+            home = i;
+        }
+    }
+    s->rr++;
+
+    pick = best;
+    if (home < s->nports &&
+        port_depth(s->port[home]) <= port_depth(s->port[best]) + HOCS_STRIPE_SLACK) {
+        pick = home;
+    }
+
+    /* 2. Queue there, or on any port with room */
+    for (uint32_t k = 0; k < s->nports && rc == HOCS_ERR_BUSY; k++) {
+        uint32_t i = (pick + k) % s->nports;
+        rc = hocs_submit(s->port[i], job);
+        if (rc == HOCS_OK) {
+            s->jobs[i]++;
+            if (i == home) s->home_hits++;
+            else if (home < s->nports) s->spills++;
+        }
+    }
+    return rc;
+}
+
+uint32_t hocs_stripe_poll(hocs_stripe_t *s, uint32_t budget) {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < s->nports; i++) {
+        n += hocs_poll(s->port[i], budget);
+    }
+    return n;
+}
+
+/*
+ * hocs_stripe_wait
+ * hocs_wait() for a job whose port the caller does not track.
+ */
+int hocs_stripe_wait(hocs_stripe_t *s, hocs_job_t *job, uint64_t timeout_us) {
+    uint64_t start = timer_get_ticks();
+
+    while (job->state == HOCS_JOB_QUEUED) {
+        hocs_stripe_poll(s, HOCS_RING_ENTRIES);
+
+        if (timeout_us && timer_ticks_to_us(timer_get_ticks() - start) > timeout_us) {
+            return HOCS_ERR_TIMEOUT;
+        }
+    }
+
+    return (job->state == HOCS_JOB_DONE) ? HOCS_OK : HOCS_ERR_HW;
+}
+
+/*
+ * ======================================================================================
+ * MATRIX STRIPING
+ * ======================================================================================
+ */
+
+/*
+ * hocs_stripe_matmul
+ * C = A x B (n x n) with the rows of A and C split across the ports.
+ * Nothing is queued unless every part fits, so HOCS_ERR_BUSY leaves no
+ * half-submitted product behind (reap and retry).
+ */
+int hocs_stripe_matmul(hocs_stripe_t *s, hocs_stripe_op_t *op,
+                       const float *a, const float *b, float *c, uint32_t n) {
+    uint32_t parts = (n < s->nports) ? n : s->nports;
+    uint32_t row = 0;
+    int rc;
+
+    if (a == NULL || b == NULL || c == NULL || n == 0 || n > HOCS_MAX_DIM) {
+        return HOCS_ERR_INVALID;
+    }
+
+    /* 1. B resident on every port used (a cache hit after the first call) */
+    for (uint32_t i = 0; i < parts; i++) {
+        rc = hocs_weights_register(s->port[i], b, n, &op->handle[i]);
+        if (rc != HOCS_OK) {
+            return rc;
+        }
+        if (port_depth(s->port[i]) >= HOCS_RING_ENTRIES) {
+            return HOCS_ERR_BUSY;
+        }
+    }
+
+    /* 2. One row band per port */
+    op->nparts = parts;
+    for (uint32_t i = 0; i < parts; i++) {
+        hocs_job_t *job = &op->part[i];
+        uint32_t rows = n / parts + (i < n % parts);
+
+        job->src_addr = (uint64_t)(uintptr_t)(a + (size_t)row * n);
+        job->dst_addr = (uint64_t)(uintptr_t)(c + (size_t)row * n);
+        job->flags = 0;
+        job->done = NULL;
+        job->ctx = NULL;
+        job->scratch = NULL;
+        job->weights = op->handle[i];
+        job->rows = rows;
+
+        rc = hocs_submit(s->port[i], job);
+        if (rc != HOCS_OK) {
+            return rc;  // Only if the load above was evicted concurrently
+        }
+        s->jobs[i]++;
+        row += rows;
+    }
+
+    s->matmuls++;
+    return HOCS_OK;
+}
+
+int hocs_stripe_wait_op(hocs_stripe_t *s, hocs_stripe_op_t *op, uint64_t timeout_us) {
+    int result = HOCS_OK;
+
+    for (uint32_t i = 0; i < op->nparts; i++) {
+        int rc = hocs_stripe_wait(s, &op->part[i], timeout_us);
+        if (rc != HOCS_OK) result = rc;
+    }
+    return result;
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK: DMA BANDWIDTH, ONE PORT vs. TWO (HOCS MODEL, VIRTUAL TIME)
+ * ======================================================================================
+ * Each port is a separate model with its own engine and link bandwidth on a
+ * shared virtual clock. DDR itself (~19 GB/s on the KV260) is not modelled
+ * as a limit; two HPC ports at ~4.8 GB/s stay well below it.
+ */
+
+#define BENCH_DIM               HOCS_MAX_DIM
+#define BENCH_JOBS              128
+
+static hocs_job_t bench_jobs[HOCS_RING_ENTRIES];
+static hocs_stripe_op_t bench_ops[HOCS_RING_ENTRIES / HOCS_STRIPE_MAX_PORTS];
+
+/* Jump to the next completion on any port, then reap */
+static void bench_step(hocs_stripe_t *s) {
+    uint64_t t = 0;
+
+    for (uint32_t i = 0; i < s->nports; i++) {
+        const hocs_model_t *m = s->port[i]->model;
+        if (m->busy && (t == 0 || m->busy_until_ns < t)) {
+            t = m->busy_until_ns;
+        }
+    }
+    if (t > hocs_bench.now) {
+        hocs_bench.now = t;
+    }
+    hocs_stripe_poll(s, HOCS_RING_ENTRIES);
+}
+
+static void bench_run(const char *label, uint32_t nports, int split, float *buf) {
+    static const char *const names[HOCS_STRIPE_MAX_PORTS] = { "hocs-bench0", "hocs-bench1" };
+    static const uint32_t homes[HOCS_STRIPE_MAX_PORTS] = { PMM_F_HIGH, PMM_F_LOW };
+    hocs_device_t *ports[HOCS_STRIPE_MAX_PORTS];
+    const uint32_t nn = BENCH_DIM * BENCH_DIM;
+    hocs_stripe_t s;
+    uint64_t bytes = 0;
+
+    for (uint32_t i = 0; i < nports; i++) {
+        ports[i] = hocs_bench_init(i, names[i], hocs_bench_virtual_ns, 0);
+        ports[i]->buf_flags = homes[i];
+    }
+    hocs_stripe_init(&s, ports, nports);
+
+    for (uint32_t j = 0; j < BENCH_JOBS; j++) {
+        if (split) {
+            /* One product at a time across the ports, B resident */
+            hocs_stripe_op_t *op = &bench_ops[j % (sizeof(bench_ops) / sizeof(bench_ops[0]))];
+            for (uint32_t i = 0; i < op->nparts; i++) {
+                while (op->part[i].state == HOCS_JOB_QUEUED) bench_step(&s);
+            }
+            while (hocs_stripe_matmul(&s, op, buf, buf + nn, buf + 2 * nn, BENCH_DIM) == HOCS_ERR_BUSY) {
+                bench_step(&s);
+            }
+        } else {
+            /* Whole jobs, [A | B] uploaded every time */
+            hocs_job_t *job = &bench_jobs[j & (HOCS_RING_ENTRIES - 1)];
+            while (job->state == HOCS_JOB_QUEUED) bench_step(&s);
+            job->src_addr = (uint64_t)(uintptr_t)buf;
+            job->dst_addr = (uint64_t)(uintptr_t)(buf + 2 * nn);
+            job->matrix_dim = BENCH_DIM;
+            job->flags = 0;
+            job->done = NULL;
+            job->scratch = NULL;
+            job->weights = 0;
+            while (hocs_stripe_submit(&s, job) == HOCS_ERR_BUSY) bench_step(&s);
+        }
+    }
+
+    for (uint32_t i = 0; i < nports; i++) {
+        while (ports[i]->cons != ports[i]->prod) bench_step(&s);
+        bytes += ports[i]->model->dma_bytes;
+    }
+
+    /* bytes per ns = GB/s; report MB/s */
+    kprintf("  %s %lu MB/s, %lu products/s (jobs per port:", label,
+            bytes * 1000 / (hocs_bench.now ? hocs_bench.now : 1),
+            (uint64_t)BENCH_JOBS * NS_PER_SEC / (hocs_bench.now ? hocs_bench.now : 1));
+    for (uint32_t i = 0; i < nports; i++) {
+        kprintf(" %lu", s.jobs[i]);
+    }
+    kprintf(")\n");
+
+    for (uint32_t i = 0; i < sizeof(bench_ops) / sizeof(bench_ops[0]); i++) {
+        bench_ops[i].nparts = 0;
+    }
+}
+
+/*
+ * hocs_stripe_benchmark
+ * BENCH_JOBS products of BENCH_DIM x BENCH_DIM on one and two ports.
+ */
+void hocs_stripe_benchmark(void) {
+    size_t bytes = 3 * (size_t)BENCH_DIM * BENCH_DIM * sizeof(float);
+    float *buf = (float *)hocs_buf_alloc(bytes);
+
+    if (buf == NULL) {
+        kprintf("[HOCS] stripe benchmark: out of memory\n");
+        return;
+    }
+    for (uint32_t i = 0; i < bytes / sizeof(float); i++) {
+        buf[i] = (float)(i % 97);
+    }
+
+    kprintf("[HOCS] Port striping benchmark: %u products of %ux%u\n",
+            BENCH_JOBS, BENCH_DIM, BENCH_DIM);
+    bench_run("1 port,  whole jobs:   ", 1, 0, buf);
+    bench_run("2 ports, whole jobs:   ", 2, 0, buf);
+    bench_run("1 port,  resident B:   ", 1, 1, buf);
+    bench_run("2 ports, rows striped: ", 2, 1, buf);
+
+    hocs_buf_free(buf, bytes);
+}
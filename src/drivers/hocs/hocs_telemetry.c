@@ -0,0 +1,337 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_telemetry.c
+ * Module:      HOCS Per-Job Latency Telemetry Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Called from the driver's submit and reap paths when a telemetry block is
+ * attached; a device without one pays a NULL check. Records are indexed by
+ * descriptor tag, so a record lives until the tag comes round again
+ * HOCS_TELEM_RECORDS submissions later.
+ * ======================================================================================
+ */
+
+#include "drivers/hocs_telemetry.h"
+#include "drivers/hocs_model.h"
+#include "kernel/timer_heavy.h"
+#include "kernel/trace.h"
+#include "lib/kprintf.h"
+
+#define HIST_BAR_WIDTH          40
+
+static const char *const phase_name[HOCS_PH_COUNT] = {
+    "queue  ", "dma_in ", "compute", "dma_out", "irq    ", "wake   ", "total  "
+};
+
+/* Driver-side clock, in the same base as the descriptor timestamps */
+static inline uint64_t telem_now(hocs_device_t *dev) {
+    if (dev->model) {
+        return dev->model->clock_ns();
+    }
+    return timer_ticks_to_ns(timer_get_ticks());
+}
+
+/* Descriptor timestamp to ns (the model already writes ns) */
+static inline uint64_t telem_hw_ns(hocs_device_t *dev, uint64_t ts) {
+    if (ts == 0 || dev->model) {
+        return ts;
+    }
+    return timer_ticks_to_ns(ts);
+}
+
+static inline uint64_t telem_delta(uint64_t from, uint64_t to) {
+    return (to > from) ? to - from : 0;
+}
+
+static inline uint32_t telem_sat32(uint64_t v) {
+    return (v > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : (uint32_t)v;
+}
+
+/*
+ * hocs_hist_add
+ * Counts one sample into its log2 bucket.
+ */
+void hocs_hist_add(hocs_hist_t *h, uint64_t ns) {
+    uint32_t b = ns ? 63 - (uint32_t)__builtin_clzll(ns) : 0;
+
+    if (b >= HOCS_TELEM_BUCKETS) {
+        b = HOCS_TELEM_BUCKETS - 1;
+    }
+    h->bucket[b]++;
+    h->count++;
+    h->sum_ns += ns;
+    if (ns > h->max_ns) {
+        h->max_ns = ns;
+    }
+}
+
+/*
+ * ======================================================================================
+ * DRIVER HOOKS
+ * ======================================================================================
+ */
+
+static void telem_clear(hocs_telem_t *t) {
+    uint8_t *p = (uint8_t *)t;
+
+    for (uint64_t i = 0; i < sizeof(*t); i++) {
+        p[i] = 0;
+    }
+}
+
+/*
+ * hocs_telemetry_attach
+ * Starts collecting into 't' (cleared). Jobs already in flight are not
+ * recorded. NULL detaches.
+ */
+void hocs_telemetry_attach(hocs_device_t *dev, hocs_telem_t *t) {
+    dev->telem = NULL;
+    if (t == NULL) {
+        return;
+    }
+    telem_clear(t);
+    asm volatile("" ::: "memory");
+    dev->telem = t;
+}
+
+/*
+ * hocs_telemetry_reset
+ * Clears histograms and records. Thread context with the device quiet.
+ */
+void hocs_telemetry_reset(hocs_device_t *dev) {
+    if (dev->telem) {
+        telem_clear(dev->telem);
+    }
+}
+
+/*
+ * hocs_telemetry_submit
+ * Descriptor 'd' has been filled (tag set) and is about to be published.
+ */
+void hocs_telemetry_submit(hocs_device_t *dev, hocs_desc_t *d) {
+    hocs_job_rec_t *r = &dev->telem->rec[d->tag & (HOCS_TELEM_RECORDS - 1)];
+
+    r->tag = d->tag;
+    r->dim = (uint16_t)d->matrix_dim;
+    r->status = HOCS_DESC_PENDING;
+    r->kind = (d->flags & HOCS_DESC_F_LOAD_W) ? HOCS_JOB_KIND_LOAD_W :
+              (d->flags & HOCS_DESC_F_RESIDENT) ? HOCS_JOB_KIND_RESIDENT : HOCS_JOB_KIND_FULL;
+    r->t_start = 0;
+    r->t_dma_in = 0;
+    r->t_compute = 0;
+    r->t_dma_out = 0;
+    r->t_irq = 0;
+    r->t_wake = 0;
+
+    /* The IP fills these in; 0 marks a phase it has not reached */
+    d->ts_start = 0;
+    d->ts_dma_in = 0;
+    d->ts_compute = 0;
+    d->ts_dma_out = 0;
+
+    r->t_submit = telem_now(dev);
+}
+
+/*
+ * hocs_telemetry_irq
+ * Completion interrupt entry; stamps every job the following reap retires.
+ */
+void hocs_telemetry_irq(hocs_device_t *dev) {
+    dev->telem->irq_ns = telem_now(dev);
+}
+
+/*
+ * hocs_telemetry_complete
+ * Reap of descriptor 'd', just before its consumer is notified.
+ */
+void hocs_telemetry_complete(hocs_device_t *dev, const hocs_desc_t *d) {
+    hocs_telem_t *t = dev->telem;
+    hocs_job_rec_t *r = &t->rec[d->tag & (HOCS_TELEM_RECORDS - 1)];
+    uint64_t now = telem_now(dev);
+    uint64_t ph[HOCS_PH_COUNT];
+
+    if (r->tag != d->tag || r->t_submit == 0) {
+        return;                     // Submitted before attach
+    }
+
+    /* 1. Engine phases from the write-back */
+    r->status = (uint8_t)d->status;
+    r->t_start = telem_hw_ns(dev, d->ts_start);
+    r->t_dma_in = telem_hw_ns(dev, d->ts_dma_in);
+    r->t_compute = telem_hw_ns(dev, d->ts_compute);
+    r->t_dma_out = telem_hw_ns(dev, d->ts_dma_out);
+
+    /*
+     * 2. Delivery. A job that finished after the IRQ was taken was picked
+     * up by the same reap loop; its "IRQ" is the reap itself.
+     */
+    r->t_irq = (t->irq_ns && t->irq_ns >= r->t_dma_out) ? t->irq_ns : now;
+    r->t_wake = now;
+    t->jobs++;
+
+    ph[HOCS_PH_TOTAL] = telem_delta(r->t_submit, r->t_wake);
+    hocs_hist_add(&t->hist[HOCS_PH_TOTAL], ph[HOCS_PH_TOTAL]);
+
+    if (r->t_start == 0 || r->t_dma_out == 0) {
+        t->partial++;
+        return;
+    }
+
+    ph[HOCS_PH_QUEUE] = telem_delta(r->t_submit, r->t_start);
+    ph[HOCS_PH_DMA_IN] = telem_delta(r->t_start, r->t_dma_in);
+    ph[HOCS_PH_COMPUTE] = telem_delta(r->t_dma_in, r->t_compute);
+    ph[HOCS_PH_DMA_OUT] = telem_delta(r->t_compute, r->t_dma_out);
+    ph[HOCS_PH_IRQ] = telem_delta(r->t_dma_out, r->t_irq);
+    ph[HOCS_PH_WAKE] = telem_delta(r->t_irq, r->t_wake);
+    for (uint32_t i = 0; i < HOCS_PH_TOTAL; i++) {
+        hocs_hist_add(&t->hist[i], ph[i]);
+    }
+
+    /* 3. Binary trace: four engine phases, then delivery */
+    trace_emit(TRACE_EV_HOCS_PHASES, r->tag,
+               ((uint64_t)telem_sat32(ph[HOCS_PH_QUEUE]) << 32) | telem_sat32(ph[HOCS_PH_DMA_IN]),
+               ((uint64_t)telem_sat32(ph[HOCS_PH_COMPUTE]) << 32) | telem_sat32(ph[HOCS_PH_DMA_OUT]));
+    trace_emit(TRACE_EV_HOCS_DELIVER, r->tag, ph[HOCS_PH_IRQ], ph[HOCS_PH_WAKE]);
+}
+
+/*
+ * ======================================================================================
+ * REPORTING
+ * ======================================================================================
+ */
+
+/*
+ * hocs_hist_percentile
+ * Upper bound of the bucket holding the pct-th percentile (capped at the
+ * observed maximum): a log2 histogram is exact to a factor of two.
+ */
+uint64_t hocs_hist_percentile(const hocs_hist_t *h, uint32_t pct) {
+    uint64_t target, cum = 0;
+
+    if (h->count == 0) {
+        return 0;
+    }
+    target = (h->count * pct + 99) / 100;
+
+    for (uint32_t b = 0; b < HOCS_TELEM_BUCKETS; b++) {
+        cum += h->bucket[b];
+        if (cum >= target) {
+            uint64_t upper = 2ULL << b;
+            return (upper < h->max_ns) ? upper : h->max_ns;
+        }
+    }
+    return h->max_ns;
+}
+
+/*
+ * hocs_telemetry_export
+ * Copies the newest completed records, oldest first. At most
+ * HOCS_TELEM_RECORDS - HOCS_RING_ENTRIES are returned, so none can be
+ * overwritten by a job still in flight. Returns the number copied.
+ */
+uint32_t hocs_telemetry_export(hocs_device_t *dev, hocs_job_rec_t *out, uint32_t max) {
+    hocs_telem_t *t = dev->telem;
+    uint32_t n, cons;
+
+    if (t == NULL) {
+        return 0;
+    }
+
+    cons = dev->cons;
+    n = max;
+    if (n > HOCS_TELEM_RECORDS - HOCS_RING_ENTRIES) n = HOCS_TELEM_RECORDS - HOCS_RING_ENTRIES;
+    if (n > t->jobs) n = (uint32_t)t->jobs;
+
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = t->rec[(cons - n + i) & (HOCS_TELEM_RECORDS - 1)];
+    }
+    return n;
+}
+
+/*
+ * hocs_telemetry_dump
+ * Console summary: per-phase mean / p50 / p99 / max and which phase
+ * dominates. 'verbose' adds the histograms.
+ */
+void hocs_telemetry_dump(hocs_device_t *dev, int verbose) {
+    hocs_telem_t *t = dev->telem;
+    uint64_t mean[HOCS_PH_COUNT], engine;
+    const char *bound;
+
+    if (t == NULL || t->jobs == 0) {
+        kprintf("[HOCS] %s: no telemetry\n", dev->name);
+        return;
+    }
+
+    kprintf("[HOCS] %s latency: %lu jobs, %lu without engine timestamps\n",
+            dev->name, t->jobs, t->partial);
+
+    for (uint32_t i = 0; i < HOCS_PH_COUNT; i++) {
+        const hocs_hist_t *h = &t->hist[i];
+
+        mean[i] = h->count ? h->sum_ns / h->count : 0;
+        if (h->count == 0) {
+            continue;
+        }
+        kprintf("  %s mean %lu ns  p50 <%lu  p99 <%lu  max %lu\n", phase_name[i],
+                mean[i], hocs_hist_percentile(h, 50), hocs_hist_percentile(h, 99), h->max_ns);
+
+        if (!verbose) {
+            continue;
+        }
+        for (uint32_t b = 0; b < HOCS_TELEM_BUCKETS; b++) {
+            char bar[HIST_BAR_WIDTH + 1];
+            uint32_t len;
+
+            if (h->bucket[b] == 0) {
+                continue;
+            }
+            len = (uint32_t)((h->bucket[b] * HIST_BAR_WIDTH + h->count - 1) / h->count);
+            for (uint32_t k = 0; k < len; k++) bar[k] = '#';
+            bar[len] = '\0';
+            kprintf("      >= %lu ns: %s %u\n", (uint64_t)1 << b, bar, h->bucket[b]);
+        }
+    }
+
+    /* Where does submit-to-written go? */
+    engine = mean[HOCS_PH_QUEUE] + mean[HOCS_PH_DMA_IN] + mean[HOCS_PH_COMPUTE] + mean[HOCS_PH_DMA_OUT];
+    if (engine == 0) {
+        return;
+    }
+    if (mean[HOCS_PH_QUEUE] >= mean[HOCS_PH_DMA_IN] + mean[HOCS_PH_DMA_OUT] &&
+        mean[HOCS_PH_QUEUE] >= mean[HOCS_PH_COMPUTE]) {
+        bound = "queue";
+    } else if (mean[HOCS_PH_DMA_IN] + mean[HOCS_PH_DMA_OUT] >= mean[HOCS_PH_COMPUTE]) {
+        bound = "DMA";
+    } else {
+        bound = "compute";
+    }
+    kprintf("  %s-bound: queue %lu%%, DMA %lu%%, compute %lu%% of submit-to-written\n", bound,
+            mean[HOCS_PH_QUEUE] * 100 / engine,
+            (mean[HOCS_PH_DMA_IN] + mean[HOCS_PH_DMA_OUT]) * 100 / engine,
+            mean[HOCS_PH_COMPUTE] * 100 / engine);
+}
+
+/*
+ * hocs_telemetry_trace_summary
+ * The aggregates as trace records, one per phase:
+ * arg0 = irq_num << 8 | phase, arg1 = count, arg2 = mean << 32 | p99.
+ */
+void hocs_telemetry_trace_summary(hocs_device_t *dev) {
+    hocs_telem_t *t = dev->telem;
+
+    if (t == NULL) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < HOCS_PH_COUNT; i++) {
+        const hocs_hist_t *h = &t->hist[i];
+        uint64_t mean = h->count ? h->sum_ns / h->count : 0;
+
+        trace_emit(TRACE_EV_HOCS_STATS, (dev->irq_num << 8) | i, h->count,
+                   ((uint64_t)telem_sat32(mean) << 32) | telem_sat32(hocs_hist_percentile(h, 99)));
+    }
+}
@@ -0,0 +1,391 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_uring.c
+ * Module:      HOCS Kernel-Bypass Submission Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * One grant at a time, matching the one-task-at-a-time EL0 runner. The
+ * ring indices continue from where the kernel left them, so attach and
+ * detach need no IP reset (resident weights excepted, see detach).
+ * ======================================================================================
+ */
+
+#include "drivers/hocs_uring.h"
+#include "drivers/hocs_model.h"
+#include "kernel/timer_heavy.h"
+#include "mm/pmm.h"
+#include "lib/kprintf.h"
+
+#define HOCS_URING_RING_BYTES   (HOCS_RING_ENTRIES * sizeof(hocs_desc_t))
+
+typedef struct {
+    hocs_device_t *dev;
+    uint32_t mode;
+    hocs_uring_t *ctl;              // Doorbell page (kernel view)
+    uint64_t mr_pa;
+    uint64_t mr_size;
+    uint32_t reported;              // SYSCALL mode: completions handed to the task
+
+    /* Statistics */
+    uint64_t waits;
+    uint64_t sys_submits;
+} hocs_uring_grant_t;
+
+static hocs_uring_grant_t grant;
+static hocs_job_t sys_jobs[HOCS_RING_ENTRIES];      // SYSCALL mode, one per ring slot
+static int syscalls_registered;
+
+/*
+ * ======================================================================================
+ * SYSTEM CALLS
+ * ======================================================================================
+ */
+
+/* The region a task address range must lie in */
+static int mr_check(uint64_t va, uint64_t len) {
+    return va >= HOCS_URING_MR_VA && len <= grant.mr_size &&
+           va - HOCS_URING_MR_VA <= grant.mr_size - len;
+}
+
+/*
+ * sys_hocs_submit
+ * SYSCALL mode: (src_va, dst_va, dim) checked against the region, then
+ * queued with hocs_submit() like any kernel job.
+ */
+static int64_t sys_hocs_submit(uint64_t src_va, uint64_t dst_va, uint64_t dim) {
+    hocs_device_t *dev = grant.dev;
+    hocs_job_t *job;
+    uint64_t bytes = dim * dim * sizeof(float);
+
+    if (dev == NULL || grant.mode != HOCS_URING_SYSCALL) {
+        return HOCS_ERR_INVALID;
+    }
+    if (dim == 0 || dim > HOCS_MAX_DIM ||
+        !mr_check(src_va, 2 * bytes) || !mr_check(dst_va, bytes)) {
+        return HOCS_ERR_INVALID;
+    }
+
+    job = &sys_jobs[dev->prod & (HOCS_RING_ENTRIES - 1)];
+    job->src_addr = grant.mr_pa + (src_va - HOCS_URING_MR_VA);
+    job->dst_addr = grant.mr_pa + (dst_va - HOCS_URING_MR_VA);
+    job->matrix_dim = (uint32_t)dim;
+    job->flags = 0;
+    job->done = NULL;
+    job->scratch = NULL;
+    job->weights = 0;
+    job->rows = 0;
+    grant.sys_submits++;
+    return hocs_submit(dev, job);
+}
+
+/*
+ * sys_hocs_reap
+ * SYSCALL mode: completions since the last call, whether reaped here or
+ * already by the IRQ path.
+ */
+static int64_t sys_hocs_reap(uint64_t a0, uint64_t a1, uint64_t a2) {
+    hocs_device_t *dev = grant.dev;
+    uint32_t n;
+    (void)a0; (void)a1; (void)a2;
+
+    if (dev == NULL || grant.mode != HOCS_URING_SYSCALL) {
+        return 0;
+    }
+    hocs_poll(dev, HOCS_RING_ENTRIES);
+    n = dev->cons - grant.reported;
+    grant.reported = dev->cons;
+    return n;
+}
+
+/*
+ * sys_hocs_wait
+ * Sleeps until the completion index moves past 'cons'. In BYPASS mode the
+ * instance IRQ is enabled only here; hocs_irq_poll() masks it again.
+ * The behavioral model only runs when its registers are touched, so with a
+ * model attached the wait polls instead of sleeping.
+ */
+static int64_t sys_hocs_wait(uint64_t cons, uint64_t a1, uint64_t a2) {
+    hocs_device_t *dev = grant.dev;
+    uint64_t start = timer_get_ticks();
+    (void)a1; (void)a2;
+
+    if (dev == NULL) {
+        return HOCS_ERR_INVALID;
+    }
+    grant.waits++;
+
+    while (hocs_rd(dev, HOCS_RING_COMPLETED_OFFSET) == (uint32_t)cons) {
+        if (timer_ticks_to_us(timer_get_ticks() - start) > HOCS_URING_WAIT_TIMEOUT_US) {
+            return HOCS_ERR_TIMEOUT;
+        }
+        if (dev->model) {
+            continue;
+        }
+
+        /* 1. Arm, then re-check: the level IRQ covers a completion in between */
+        if (grant.mode == HOCS_URING_BYPASS) {
+            hocs_wr(dev, HOCS_IRQ_ENABLE_OFFSET, HOCS_IRQ_DONE | HOCS_IRQ_ERROR);
+        }
+        if (hocs_rd(dev, HOCS_RING_COMPLETED_OFFSET) != (uint32_t)cons) {
+            break;
+        }
+
+        /* 2. Sleep with IRQs open (ELR/SPSR are held by the EL0 entry stub) */
+        asm volatile("msr daifclr, #2; wfi; msr daifset, #2" ::: "memory");
+    }
+
+    return HOCS_OK;
+}
+
+/*
+ * ======================================================================================
+ * ATTACH / DETACH
+ * ======================================================================================
+ */
+
+/*
+ * hocs_uring_attach
+ * Grants 'dev' to the next task run with user_run(..., *task_arg).
+ * The instance must be idle: reap its kernel jobs first.
+ * 'mr_size' bytes of buffer are allocated in the port's home window.
+ */
+int hocs_uring_attach(hocs_device_t *dev, uint32_t mode, uint64_t mr_size, uint64_t *task_arg) {
+    uint64_t ctl_pa, ring_pa = (uint64_t)(uintptr_t)dev->ring;
+    hocs_uring_t *u;
+
+    if (grant.dev != NULL || dev->ring == NULL || mr_size == 0 || mr_size > HOCS_URING_MR_MAX) {
+        return HOCS_ERR_INVALID;
+    }
+    hocs_poll(dev, HOCS_RING_ENTRIES);
+    if (dev->prod != dev->cons) {
+        return HOCS_ERR_BUSY;
+    }
+
+    if (!syscalls_registered) {
+        user_syscall_register(SYS_HOCS_SUBMIT, sys_hocs_submit);
+        user_syscall_register(SYS_HOCS_REAP, sys_hocs_reap);
+        user_syscall_register(SYS_HOCS_WAIT, sys_hocs_wait);
+        syscalls_registered = 1;
+    }
+    if (user_init() != 0) {
+        return HOCS_ERR_INVALID;
+    }
+
+    /* 1. Doorbell page and registered region */
+    mr_size = (mr_size + PMM_PAGE_SIZE - 1) & ~(PMM_PAGE_SIZE - 1);
+    ctl_pa = pmm_alloc(PMM_PAGE_SIZE, PMM_F_LOW | PMM_F_ZERO);
+    grant.mr_pa = pmm_alloc(mr_size, dev->buf_flags | PMM_F_ZERO);
+    if (ctl_pa == 0 || grant.mr_pa == 0) {
+        if (ctl_pa) pmm_free(ctl_pa, PMM_PAGE_SIZE);
+        if (grant.mr_pa) pmm_free(grant.mr_pa, mr_size);
+        return HOCS_ERR_INVALID;
+    }
+
+    /* 2. Map them (and the ring, for bypass) into the user window */
+    if (user_map(HOCS_URING_CTL_VA, ctl_pa, PMM_PAGE_SIZE, 1) != 0 ||
+        user_map(HOCS_URING_MR_VA, grant.mr_pa, mr_size, 1) != 0 ||
+        (mode == HOCS_URING_BYPASS &&
+         user_map(HOCS_URING_RING_VA, ring_pa, HOCS_URING_RING_BYTES, 1) != 0)) {
+        user_unmap(HOCS_URING_CTL_VA, PMM_PAGE_SIZE);
+        user_unmap(HOCS_URING_MR_VA, mr_size);
+        pmm_free(ctl_pa, PMM_PAGE_SIZE);
+        pmm_free(grant.mr_pa, mr_size);
+        return HOCS_ERR_INVALID;
+    }
+
+    /* 3. Task view, continuing the kernel's ring indices */
+    u = (hocs_uring_t *)(uintptr_t)ctl_pa;
+    u->sq_tail = dev->prod;
+    u->cq_tail = dev->prod;
+    u->ring = HOCS_URING_RING_VA;
+    u->entries = HOCS_RING_ENTRIES;
+    u->mode = mode;
+    u->mr_va = HOCS_URING_MR_VA;
+    u->mr_pa = grant.mr_pa;
+    u->mr_size = mr_size;
+    u->prod = dev->prod;
+    u->cons = dev->prod;
+
+    grant.dev = dev;
+    grant.mode = mode;
+    grant.ctl = u;
+    grant.mr_size = mr_size;
+    grant.reported = dev->cons;
+    grant.waits = 0;
+    grant.sys_submits = 0;
+
+    /* 4. Hand the ring over: kernel off, doorbell from memory, IRQ only on wait */
+    if (mode == HOCS_URING_BYPASS) {
+        dev->user = 1;
+        hocs_wr(dev, HOCS_IRQ_ENABLE_OFFSET, 0);
+        hocs_wr(dev, HOCS_DB_ADDR_L_OFFSET, (uint32_t)ctl_pa);
+        hocs_wr(dev, HOCS_DB_ADDR_H_OFFSET, (uint32_t)(ctl_pa >> 32));
+        asm volatile("dsb st" ::: "memory");
+        hocs_wr(dev, HOCS_CONTROL_OFFSET,
+                hocs_rd(dev, HOCS_CONTROL_OFFSET) | HOCS_CTRL_DB_SHADOW);
+    }
+
+    *task_arg = HOCS_URING_CTL_VA;
+    kprintf("[HOCS] %s granted to task (%s), %lu KB region\n", dev->name,
+            mode == HOCS_URING_BYPASS ? "bypass" : "syscall", mr_size >> 10);
+    return HOCS_OK;
+}
+
+/*
+ * hocs_uring_detach
+ * Takes the instance back once the task's descriptors have drained.
+ * The task may have reloaded weight slots, so the driver forgets them.
+ */
+int hocs_uring_detach(void) {
+    hocs_device_t *dev = grant.dev;
+    hocs_uring_t *u = grant.ctl;
+    uint64_t start = timer_get_ticks();
+
+    if (dev == NULL) {
+        return HOCS_ERR_INVALID;
+    }
+
+    if (grant.mode == HOCS_URING_BYPASS) {
+        uint32_t tail = u->sq_tail;
+
+        /* 1. Drain */
+        while (hocs_rd(dev, HOCS_RING_COMPLETED_OFFSET) != tail) {
+            if (timer_ticks_to_us(timer_get_ticks() - start) > HOCS_URING_WAIT_TIMEOUT_US) {
+                return HOCS_ERR_TIMEOUT;
+            }
+        }
+
+        /* 2. Back to the register doorbell at the task's tail */
+        hocs_wr(dev, HOCS_RING_DOORBELL_OFFSET, tail);
+        hocs_wr(dev, HOCS_CONTROL_OFFSET,
+                hocs_rd(dev, HOCS_CONTROL_OFFSET) & ~HOCS_CTRL_DB_SHADOW);
+        dev->prod = tail;
+        dev->cons = tail;
+        for (uint32_t i = 0; i < HOCS_WEIGHT_SLOTS; i++) {
+            dev->wslot[i].valid = 0;
+        }
+
+        hocs_wr(dev, HOCS_IRQ_STATUS_OFFSET, 0xFFFFFFFF);
+        dev->user = 0;
+        hocs_irq_unmask(dev);
+        user_unmap(HOCS_URING_RING_VA, HOCS_URING_RING_BYTES);
+    } else {
+        while (dev->prod != dev->cons) {
+            if (timer_ticks_to_us(timer_get_ticks() - start) > HOCS_URING_WAIT_TIMEOUT_US) {
+                return HOCS_ERR_TIMEOUT;
+            }
+            hocs_poll(dev, HOCS_RING_ENTRIES);
+        }
+    }
+
+    /* 3. Unmap and free */
+    user_unmap(HOCS_URING_CTL_VA, PMM_PAGE_SIZE);
+    user_unmap(HOCS_URING_MR_VA, grant.mr_size);
+    pmm_free((uint64_t)(uintptr_t)u, PMM_PAGE_SIZE);
+    pmm_free(grant.mr_pa, grant.mr_size);
+    grant.dev = NULL;
+    grant.ctl = NULL;
+    return HOCS_OK;
+}
+
+/* Kernel view of the registered region (to stage operands) */
+void *hocs_uring_mr(void) {
+    return grant.dev ? (void *)(uintptr_t)grant.mr_pa : NULL;
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK
+ * ======================================================================================
+ * The engine is made (nearly) free so the figures are the cost of getting
+ * descriptors in and completions out. The same task runs in both modes,
+ * keeping the ring as full as it can.
+ */
+
+#define BENCH_JOBS              (64 * 1024)
+#define BENCH_DIM               16
+#define BENCH_MR_SIZE           (16 * 1024)
+
+/*
+ * bench_task (EL0)
+ * Region layout: [jobs, dim] at +0, operands at +4KB, result at +8KB.
+ */
+static void USER_TEXT bench_task(uint64_t arg) {
+    hocs_uring_t *u = (hocs_uring_t *)(uintptr_t)arg;
+    const volatile uint32_t *param = (const volatile uint32_t *)(uintptr_t)u->mr_va;
+    uint32_t jobs = param[0], dim = param[1];
+    uint64_t src = u->mr_va + 0x1000, dst = u->mr_va + 0x2000;
+    uint32_t sent = 0, done = 0;
+
+    while (done < jobs) {
+        while (sent < jobs && hocs_uring_submit(u, src, dst, dim) == HOCS_OK) {
+            sent++;
+        }
+        hocs_uring_commit(u);
+
+        uint32_t n = hocs_uring_reap(u);
+        if (n == 0 && hocs_uring_wait(u) != HOCS_OK) {
+            user_exit(-1);
+        }
+        done += n;
+    }
+
+    user_exit(u->errors ? -1 : 0);
+}
+
+/*
+ * hocs_uring_benchmark
+ * Submissions per second: one system call per job against the mapped ring.
+ */
+void hocs_uring_benchmark(void) {
+    static const char *const names[2] = { "bypass ", "syscall" };
+    uint64_t rate[2] = { 0, 0 };
+    hocs_device_t *dev;
+
+    kprintf("[HOCS] uring benchmark: %u jobs, %ux%u, engine time ~0\n",
+            BENCH_JOBS, BENCH_DIM, BENCH_DIM);
+
+    dev = hocs_bench_init(0, "hocs-uring-bench", hocs_bench_real_ns, 0);     // Waits poll
+    dev->buf_flags = PMM_F_LOW;
+    dev->model->setup_ns = 0;
+    dev->model->compute_ns = 0;
+    dev->model->dma_bytes_per_us = 0xFFFFFFFF;
+
+    for (uint32_t mode = HOCS_URING_BYPASS; mode <= HOCS_URING_SYSCALL; mode++) {
+        uint64_t arg, sys0, t0, ns;
+        volatile uint32_t *param;
+        int64_t code;
+
+        if (hocs_uring_attach(dev, mode, BENCH_MR_SIZE, &arg) != HOCS_OK) {
+            kprintf("[HOCS] ERR: attach failed\n");
+            return;
+        }
+        param = (volatile uint32_t *)hocs_uring_mr();
+        param[0] = BENCH_JOBS;
+        param[1] = BENCH_DIM;
+
+        sys0 = user_syscalls();
+        t0 = timer_get_ticks();
+        code = user_run(bench_task, arg);
+        ns = timer_ticks_to_ns(timer_get_ticks() - t0);
+        sys0 = user_syscalls() - sys0;
+
+        hocs_uring_detach();
+
+        if (code != 0 || ns == 0) {
+            kprintf("  %s: task failed (%ld)\n", names[mode], code);
+            continue;
+        }
+        rate[mode] = (uint64_t)BENCH_JOBS * 1000000000ULL / ns;
+        kprintf("  %s: %lu submits/s, %lu ns/job, %lu kernel entries (%lu waits)\n",
+                names[mode], rate[mode], ns / BENCH_JOBS, sys0, grant.waits);
+    }
+
+    if (rate[HOCS_URING_SYSCALL]) {
+        kprintf("  bypass rate: %lu%% of syscall\n",
+                rate[HOCS_URING_BYPASS] * 100 / rate[HOCS_URING_SYSCALL]);
+    }
+}
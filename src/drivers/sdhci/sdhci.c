@@ -0,0 +1,815 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        sdhci.c
+ * Module:      SD/eMMC Host Controller Driver Implementation
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Card bring-up is polled and synchronous (sdhci_cmd). Block transfers go
+ * through the request queue: every data command is a single ADMA2 chain,
+ * completed on TRANSFER_COMPLETE or an error from sdhci_poll(), which the
+ * interrupt handler also calls. Queue state is guarded with a priority-
+ * mask section at the kernel ceiling, so submitters and the handler can
+ * share it on one core.
+ * ======================================================================================
+ */
+
+#include "drivers/sdhci.h"
+#include "drivers/gic_v2.h"
+#include "kernel/irq_prio.h"
+#include "kernel/timer_heavy.h"
+#include "lib/dcache.h"
+#include "lib/kprintf.h"
+
+#define MMIO_READ32(addr)       (*(volatile uint32_t *)(addr))
+#define MMIO_WRITE32(addr, val) (*(volatile uint32_t *)(addr) = (val))
+
+#define SDHCI_QUEUE_MASK        (SDHCI_QUEUE_DEPTH - 1)
+
+/* Timeouts */
+#define SDHCI_RESET_TIMEOUT_US  100000
+#define SDHCI_CLOCK_TIMEOUT_US  20000
+#define SDHCI_CMD_TIMEOUT_US    100000
+#define SDHCI_BUSY_TIMEOUT_US   500000      // R1b, init data phase, card busy before issue
+#define SDHCI_POWERUP_US        1000000     // ACMD41 / CMD1 loop
+#define SDHCI_XFER_TIMEOUT_US   100000      // Per command, plus:
+#define SDHCI_XFER_US_PER_BLK   500         // 1 MB/s, worst-case card write
+
+/* Bus Clocks */
+#define SDHCI_ID_HZ             400000
+#define SDHCI_DS_HZ             25000000
+#define SDHCI_HS_HZ             50000000
+#define SDHCI_DEFAULT_BASE_HZ   200000000   // When CAPS leaves the base clock 0
+
+/* CRL_APB: SDIOx_REF_CTRL clock gate, RST_LPD_IOU2 resets */
+#define CRL_CLKACT              (1U << 24)
+#define CRL_RST_SDIO(n)         (1U << (5 + (n)))
+
+#define SDHCI_STATUS_MASK       (SDHCI_INT_CMD_DONE | SDHCI_INT_XFER_DONE | SDHCI_INT_ERR_MASK)
+#define SDHCI_SIGNAL_MASK       (SDHCI_INT_XFER_DONE | SDHCI_INT_ERR_MASK)
+
+sdhci_device_t sdhci0 = { .name = "sd0" };
+sdhci_device_t sdhci1 = { .name = "sd1" };
+
+/* CMD6 switch status / EXT_CSD during bring-up */
+static uint8_t sdhci_bounce[SDHCI_BLOCK_SIZE] __attribute__((aligned(DCACHE_LINE)));
+
+/*
+ * ======================================================================================
+ * HELPERS
+ * ======================================================================================
+ */
+
+static int sdhci_spin(sdhci_device_t *dev, uint32_t offset, uint32_t mask, uint32_t want,
+                      uint64_t timeout_us) {
+    uint64_t t0 = timer_get_ticks();
+
+    while ((sdhci_rd(dev, offset) & mask) != want) {
+        if (timer_ticks_to_us(timer_get_ticks() - t0) > timeout_us) {
+            return SDHCI_ERR_TIMEOUT;
+        }
+    }
+    return SDHCI_OK;
+}
+
+static int sdhci_reset(sdhci_device_t *dev, uint32_t what) {
+    uint32_t clk = sdhci_rd(dev, SDHCI_CLOCK_OFFSET) & 0x00FFFFFF;
+
+    sdhci_wr(dev, SDHCI_CLOCK_OFFSET, clk | what);
+    return sdhci_spin(dev, SDHCI_CLOCK_OFFSET, what, 0, SDHCI_RESET_TIMEOUT_US);
+}
+
+static inline void sdhci_adma_set(sdhci_adma_desc_t *d, uint64_t addr, uint32_t len, uint32_t attr) {
+    d->attr = (uint16_t)(SDHCI_ADMA_VALID | SDHCI_ADMA_TRAN | attr);
+    d->len = (uint16_t)len;                     // SDHCI_ADMA_MAX_LEN wraps to 0
+    d->addr_lo = (uint32_t)addr;
+    d->addr_hi = (uint32_t)(addr >> 32);
+}
+
+static inline void sdhci_adma_base(sdhci_device_t *dev) {
+    uint64_t pa = (uint64_t)(uintptr_t)dev->adma;
+
+    sdhci_wr(dev, SDHCI_ADMA_ADDR_L_OFFSET, (uint32_t)pa);
+    sdhci_wr(dev, SDHCI_ADMA_ADDR_H_OFFSET, (uint32_t)(pa >> 32));
+}
+
+/*
+ * sdhci_clock_enable
+ * Reference clock on and the controller out of reset, for a slot the
+ * FSBL left alone. Touches nothing when both already are.
+ */
+static void sdhci_clock_enable(uintptr_t base) {
+    uintptr_t ref;
+    uint32_t n, v;
+
+    if (base == ZYNQMP_SD0_BASE) {
+        n = 0;
+        ref = CRL_APB_SDIO0_REF_CTRL;
+    } else if (base == ZYNQMP_SD1_BASE) {
+        n = 1;
+        ref = CRL_APB_SDIO1_REF_CTRL;
+    } else {
+        return;
+    }
+
+    v = MMIO_READ32(ref);
+    if (!(v & CRL_CLKACT)) {
+        MMIO_WRITE32(ref, v | CRL_CLKACT);
+    }
+    v = MMIO_READ32(CRL_APB_RST_LPD_IOU2);
+    if (v & CRL_RST_SDIO(n)) {
+        MMIO_WRITE32(CRL_APB_RST_LPD_IOU2, v & ~CRL_RST_SDIO(n));
+    }
+}
+
+/*
+ * sdhci_set_clock
+ * Highest card clock not above 'hz' (10-bit divider, f = base / 2n).
+ */
+static int sdhci_set_clock(sdhci_device_t *dev, uint32_t hz) {
+    uint32_t div = 0;
+
+    if (hz < dev->base_clock_hz) {
+        div = (dev->base_clock_hz + 2 * hz - 1) / (2 * hz);
+        if (div > 0x3FF) div = 0x3FF;
+    }
+
+    /* 1. Card clock off while the divider changes */
+    sdhci_wr(dev, SDHCI_CLOCK_OFFSET, SDHCI_TIMEOUT_MAX);
+
+    /* 2. Internal clock, then wait for it to settle */
+    sdhci_wr(dev, SDHCI_CLOCK_OFFSET, SDHCI_TIMEOUT_MAX | SDHCI_CLOCK_DIV(div) | SDHCI_CLOCK_INT_EN);
+    if (sdhci_spin(dev, SDHCI_CLOCK_OFFSET, SDHCI_CLOCK_INT_STABLE, SDHCI_CLOCK_INT_STABLE,
+                   SDHCI_CLOCK_TIMEOUT_US) != SDHCI_OK) {
+        kprintf("[SDHCI] ERR: %s internal clock not stable\n", dev->name);
+        return SDHCI_ERR_HW;
+    }
+
+    /* 3. Out to the card */
+    sdhci_wr(dev, SDHCI_CLOCK_OFFSET, SDHCI_TIMEOUT_MAX | SDHCI_CLOCK_DIV(div) |
+                                      SDHCI_CLOCK_INT_EN | SDHCI_CLOCK_CARD_EN);
+    dev->clock_hz = div ? dev->base_clock_hz / (2 * div) : dev->base_clock_hz;
+    return SDHCI_OK;
+}
+
+/*
+ * ======================================================================================
+ * COMMANDS (bring-up, polled)
+ * ======================================================================================
+ */
+
+static int sdhci_wait_int(sdhci_device_t *dev, uint32_t bit, uint64_t timeout_us) {
+    uint64_t t0 = timer_get_ticks();
+    uint32_t sts;
+
+    for (;;) {
+        sts = sdhci_rd(dev, SDHCI_INT_STATUS_OFFSET);
+        if (sts & SDHCI_INT_ERR_MASK) {
+            return (sts & (SDHCI_INT_CMD_TIMEOUT | SDHCI_INT_DATA_TIMEOUT)) ? SDHCI_ERR_TIMEOUT
+                                                                            : SDHCI_ERR_IO;
+        }
+        if (sts & bit) {
+            sdhci_wr(dev, SDHCI_INT_STATUS_OFFSET, bit);
+            return SDHCI_OK;
+        }
+        if (timer_ticks_to_us(timer_get_ticks() - t0) > timeout_us) {
+            return SDHCI_ERR_TIMEOUT;
+        }
+    }
+}
+
+/*
+ * sdhci_cmd
+ * One command, waited for. With 'data', reads a single 'len'-byte block
+ * into it through one descriptor. 'resp' gets 4 words for R2, else 1.
+ */
+static int sdhci_cmd(sdhci_device_t *dev, uint32_t idx, uint32_t arg, uint32_t rsp,
+                     void *data, uint32_t len, uint32_t *resp) {
+    uint32_t inhibit = SDHCI_PRESENT_CMD_INHIBIT, mode = 0;
+    int rc;
+
+    if (data || (rsp & SDHCI_CMD_RESP_48_BUSY) == SDHCI_CMD_RESP_48_BUSY) {
+        inhibit |= SDHCI_PRESENT_DAT_INHIBIT;
+    }
+    if (sdhci_spin(dev, SDHCI_PRESENT_OFFSET, inhibit, 0, SDHCI_CMD_TIMEOUT_US) != SDHCI_OK) {
+        return SDHCI_ERR_TIMEOUT;
+    }
+    sdhci_wr(dev, SDHCI_INT_STATUS_OFFSET, 0xFFFFFFFF);
+
+    /* 1. Data phase through a single descriptor */
+    if (data) {
+        sdhci_adma_set(&dev->adma[0], (uint64_t)(uintptr_t)data, len, SDHCI_ADMA_END);
+        dcache_clean(dev->adma, sizeof(dev->adma[0]));
+        dcache_flush(data, len);
+        sdhci_adma_base(dev);
+        sdhci_wr(dev, SDHCI_BLOCK_OFFSET, len | (1U << 16));
+        mode = SDHCI_XFER_DMA | SDHCI_XFER_READ;
+        rsp |= SDHCI_CMD_DATA;
+    }
+
+    /* 2. Issue, wait for the response */
+    sdhci_wr(dev, SDHCI_ARG_OFFSET, arg);
+    sdhci_wr(dev, SDHCI_CMD_OFFSET, SDHCI_CMD(idx, rsp) | mode);
+    rc = sdhci_wait_int(dev, SDHCI_INT_CMD_DONE, SDHCI_CMD_TIMEOUT_US);
+    if (rc == SDHCI_OK && resp) {
+        uint32_t words = ((rsp & 0x3) == SDHCI_CMD_RESP_136) ? 4 : 1;
+        for (uint32_t i = 0; i < words; i++) {
+            resp[i] = sdhci_rd(dev, SDHCI_RESP_OFFSET(i));
+        }
+    }
+
+    /* 3. Data or busy phase */
+    if (rc == SDHCI_OK && (inhibit & SDHCI_PRESENT_DAT_INHIBIT)) {
+        rc = sdhci_wait_int(dev, SDHCI_INT_XFER_DONE, SDHCI_BUSY_TIMEOUT_US);
+        if (data) {
+            dcache_inval(data, len);
+        }
+    }
+
+    if (rc != SDHCI_OK) {
+        sdhci_reset(dev, SDHCI_RESET_CMD | SDHCI_RESET_DATA);
+    }
+    sdhci_wr(dev, SDHCI_INT_STATUS_OFFSET, 0xFFFFFFFF);
+    return rc;
+}
+
+/* CSD bits [hi:lo]; the controller drops the CRC byte, so bit n is response bit n - 8 */
+static uint32_t sdhci_csd_bits(const uint32_t csd[4], uint32_t hi, uint32_t lo) {
+    uint32_t v = 0;
+
+    for (uint32_t b = hi + 1; b-- > lo; ) {
+        uint32_t n = b - 8;
+        v = (v << 1) | ((csd[n / 32] >> (n % 32)) & 1);
+    }
+    return v;
+}
+
+static uint64_t sdhci_csd_blocks(const sdhci_device_t *dev) {
+    uint32_t c_size, mult, bl_len;
+
+    /* SD CSD 2.0: (C_SIZE + 1) * 512 KB */
+    if (dev->card != SDHCI_CARD_MMC && sdhci_csd_bits(dev->csd, 127, 126) == 1) {
+        return ((uint64_t)sdhci_csd_bits(dev->csd, 69, 48) + 1) * 1024;
+    }
+
+    /* SD CSD 1.0 / MMC (EXT_CSD overrides above 2 GB) */
+    c_size = sdhci_csd_bits(dev->csd, 73, 62);
+    mult = sdhci_csd_bits(dev->csd, 49, 47);
+    bl_len = sdhci_csd_bits(dev->csd, 83, 80);
+    return ((uint64_t)(c_size + 1) << (mult + 2 + bl_len)) / SDHCI_BLOCK_SIZE;
+}
+
+/*
+ * sdhci_identify
+ * Power-up and addressing: SD (CMD8 / ACMD41) first, MMC (CMD1) when the
+ * card ignores CMD55. Leaves the card selected, in transfer state.
+ */
+static int sdhci_identify(sdhci_device_t *dev) {
+    uint32_t r[4], hcs = 0;
+    uint64_t t0;
+    int rc;
+
+    /* 1. Idle; SEND_IF_COND is answered by SD 2.0 and later only */
+    sdhci_cmd(dev, SD_CMD_GO_IDLE, 0, SDHCI_RSP_NONE, NULL, 0, NULL);
+    if (sdhci_cmd(dev, SD_CMD_SEND_IF_COND, 0x1AA, SDHCI_RSP_R7, NULL, 0, r) == SDHCI_OK) {
+        if ((r[0] & 0xFFF) != 0x1AA) {
+            kprintf("[SDHCI] ERR: %s card rejects 3.3 V (%x)\n", dev->name, r[0]);
+            return SDHCI_ERR_HW;
+        }
+        hcs = SD_OCR_CCS;
+    }
+
+    /* 2. SD power-up */
+    dev->card = SDHCI_CARD_NONE;
+    t0 = timer_get_ticks();
+    for (;;) {
+        if (sdhci_cmd(dev, SD_CMD_APP, 0, SDHCI_RSP_R1, NULL, 0, r) != SDHCI_OK ||
+            sdhci_cmd(dev, SD_ACMD_SEND_OP_COND, hcs | 0x00FF8000, SDHCI_RSP_R3, NULL, 0,
+                      &dev->ocr) != SDHCI_OK) {
+            break;                          // Not SD
+        }
+        if (dev->ocr & SD_OCR_BUSY) {
+            dev->card = (dev->ocr & SD_OCR_CCS) ? SDHCI_CARD_SDHC : SDHCI_CARD_SD;
+            break;
+        }
+        if (timer_ticks_to_us(timer_get_ticks() - t0) > SDHCI_POWERUP_US) {
+            return SDHCI_ERR_TIMEOUT;
+        }
+        udelay(1000);
+    }
+
+    /* 3. MMC power-up, sector addressing requested */
+    if (dev->card == SDHCI_CARD_NONE) {
+        sdhci_cmd(dev, SD_CMD_GO_IDLE, 0, SDHCI_RSP_NONE, NULL, 0, NULL);
+        t0 = timer_get_ticks();
+        for (;;) {
+            if (sdhci_cmd(dev, MMC_CMD_SEND_OP_COND, 0x40FF8080, SDHCI_RSP_R3, NULL, 0,
+                          &dev->ocr) != SDHCI_OK) {
+                return SDHCI_ERR_NO_CARD;
+            }
+            if (dev->ocr & SD_OCR_BUSY) {
+                break;
+            }
+            if (timer_ticks_to_us(timer_get_ticks() - t0) > SDHCI_POWERUP_US) {
+                return SDHCI_ERR_TIMEOUT;
+            }
+            udelay(1000);
+        }
+        dev->card = SDHCI_CARD_MMC;
+    }
+
+    /* 4. CID, relative address (SD publishes one, MMC is given one), CSD */
+    rc = sdhci_cmd(dev, SD_CMD_ALL_SEND_CID, 0, SDHCI_RSP_R2, NULL, 0, dev->cid);
+    if (rc != SDHCI_OK) return rc;
+
+    if (dev->card == SDHCI_CARD_MMC) {
+        dev->rca = 1U << 16;
+        rc = sdhci_cmd(dev, SD_CMD_SEND_RCA, dev->rca, SDHCI_RSP_R1, NULL, 0, r);
+    } else {
+        rc = sdhci_cmd(dev, SD_CMD_SEND_RCA, 0, SDHCI_RSP_R6, NULL, 0, r);
+        dev->rca = r[0] & 0xFFFF0000;
+    }
+    if (rc != SDHCI_OK) return rc;
+
+    rc = sdhci_cmd(dev, SD_CMD_SEND_CSD, dev->rca, SDHCI_RSP_R2, NULL, 0, dev->csd);
+    if (rc != SDHCI_OK) return rc;
+    dev->blocks = sdhci_csd_blocks(dev);
+
+    /* 5. Transfer state */
+    return sdhci_cmd(dev, SD_CMD_SELECT, dev->rca, SDHCI_RSP_R1B, NULL, 0, r);
+}
+
+/*
+ * sdhci_setup_bus
+ * 4-bit bus, then high speed (50 MHz) when card and controller have it.
+ * MMC also reads EXT_CSD for the real capacity.
+ */
+static int sdhci_setup_bus(sdhci_device_t *dev, uint32_t caps) {
+    uint32_t r;
+    int hs = 0, rc;
+
+    if (dev->card != SDHCI_CARD_MMC) {
+        /* 1. ACMD6: 4 bits */
+        rc = sdhci_cmd(dev, SD_CMD_APP, dev->rca, SDHCI_RSP_R1, NULL, 0, &r);
+        if (rc == SDHCI_OK) rc = sdhci_cmd(dev, SD_ACMD_BUS_WIDTH, 2, SDHCI_RSP_R1, NULL, 0, &r);
+        if (rc != SDHCI_OK) return rc;
+
+        /* 2. CMD6 set, group 1 function 1; status bits 379:376 echo the function taken */
+        if ((caps & SDHCI_CAPS_HISPD) &&
+            sdhci_cmd(dev, SD_CMD_SWITCH, 0x80FFFFF1, SDHCI_RSP_R1, sdhci_bounce, 64, &r) == SDHCI_OK &&
+            (sdhci_bounce[16] & 0xF) == 1) {
+            hs = 1;
+        }
+
+        /* 3. SDSC block length may default to something else */
+        if (dev->card == SDHCI_CARD_SD) {
+            rc = sdhci_cmd(dev, SD_CMD_SET_BLOCKLEN, SDHCI_BLOCK_SIZE, SDHCI_RSP_R1, NULL, 0, &r);
+            if (rc != SDHCI_OK) return rc;
+        }
+    } else {
+        /* 1. EXT_CSD: SEC_COUNT [215:212], CARD_TYPE [196] */
+        rc = sdhci_cmd(dev, SD_CMD_SEND_IF_COND, 0, SDHCI_RSP_R1, sdhci_bounce, SDHCI_BLOCK_SIZE, &r);
+        if (rc != SDHCI_OK) return rc;
+        r = (uint32_t)sdhci_bounce[212] | ((uint32_t)sdhci_bounce[213] << 8) |
+            ((uint32_t)sdhci_bounce[214] << 16) | ((uint32_t)sdhci_bounce[215] << 24);
+        if (r) {
+            dev->blocks = r;
+        }
+
+        /* 2. SWITCH (write byte): BUS_WIDTH [183] = 4 bits, HS_TIMING [185] = 1 */
+        rc = sdhci_cmd(dev, SD_CMD_SWITCH, (3U << 24) | (183U << 16) | (1U << 8), SDHCI_RSP_R1B,
+                       NULL, 0, &r);
+        if (rc != SDHCI_OK) return rc;
+        if ((caps & SDHCI_CAPS_HISPD) && (sdhci_bounce[196] & 0x2) &&
+            sdhci_cmd(dev, SD_CMD_SWITCH, (3U << 24) | (185U << 16) | (1U << 8), SDHCI_RSP_R1B,
+                      NULL, 0, &r) == SDHCI_OK) {
+            hs = 1;
+        }
+    }
+
+    dev->host_ctrl |= SDHCI_CTRL_4BIT | (hs ? SDHCI_CTRL_HISPD : 0);
+    sdhci_wr(dev, SDHCI_HOST_CTRL_OFFSET, dev->host_ctrl);
+    return sdhci_set_clock(dev, hs ? SDHCI_HS_HZ : SDHCI_DS_HZ);
+}
+
+/*
+ * ======================================================================================
+ * INITIALIZATION
+ * ======================================================================================
+ */
+
+/*
+ * sdhci_init
+ * Resets the controller and brings up the card in its slot. irq = 0
+ * leaves the device polled (sdhci_poll from the caller's loop).
+ */
+int sdhci_init(sdhci_device_t *dev, uintptr_t base, uint32_t irq) {
+    static const char *const card_names[] = { "none", "SDSC", "SDHC", "eMMC" };
+    uint32_t caps;
+    int rc;
+
+    dev->base = base;
+    dev->irq_num = irq;
+    dev->card = SDHCI_CARD_NONE;
+    dev->rca = 0;
+    dev->blocks = 0;
+    dev->clock_hz = 0;
+    dev->head = 0;
+    dev->tail = 0;
+    dev->plugged = 0;
+    dev->nactive = 0;
+    dev->requests = 0;
+    dev->commands = 0;
+    dev->merged = 0;
+    dev->blocks_read = 0;
+    dev->blocks_written = 0;
+    dev->errors = 0;
+    dev->timeouts = 0;
+    dev->irqs = 0;
+
+    if (!base) {
+        return SDHCI_ERR_INVALID;
+    }
+
+    /* 1. Controller clocked, out of reset, with 64-bit ADMA2 */
+    sdhci_clock_enable(base);
+    if (sdhci_reset(dev, SDHCI_RESET_ALL) != SDHCI_OK) {
+        kprintf("[SDHCI] ERR: %s reset timed out\n", dev->name);
+        return SDHCI_ERR_HW;
+    }
+    caps = sdhci_rd(dev, SDHCI_CAPS_OFFSET);
+    if (!(caps & SDHCI_CAPS_ADMA2) || !(caps & SDHCI_CAPS_64BIT)) {
+        kprintf("[SDHCI] ERR: %s has no 64-bit ADMA2 (caps %x)\n", dev->name, caps);
+        return SDHCI_ERR_HW;
+    }
+    dev->base_clock_hz = SDHCI_CAPS_BASE_CLK(caps) * 1000000;
+    if (!dev->base_clock_hz) {
+        dev->base_clock_hz = SDHCI_DEFAULT_BASE_HZ;
+    }
+
+    /* 2. Status for what the driver waits on; the line stays off until the card is up */
+    sdhci_wr(dev, SDHCI_SIGNAL_ENABLE_OFFSET, 0);
+    sdhci_wr(dev, SDHCI_INT_ENABLE_OFFSET, SDHCI_STATUS_MASK);
+    sdhci_wr(dev, SDHCI_INT_STATUS_OFFSET, 0xFFFFFFFF);
+
+    /* 3. 3.3 V, 1-bit bus, identification clock, 74 cycles before CMD0 */
+    dev->host_ctrl = SDHCI_POWER_330 | SDHCI_CTRL_ADMA2_64;
+    sdhci_wr(dev, SDHCI_HOST_CTRL_OFFSET, dev->host_ctrl);
+    rc = sdhci_set_clock(dev, SDHCI_ID_HZ);
+    if (rc != SDHCI_OK) {
+        return rc;
+    }
+    udelay(1000);
+
+    /* 4. Card */
+    rc = sdhci_identify(dev);
+    if (rc == SDHCI_OK) {
+        rc = sdhci_setup_bus(dev, caps);
+    }
+    if (rc != SDHCI_OK || dev->blocks == 0) {
+        kprintf("[SDHCI] %s: no usable card (%d)\n", dev->name, rc);
+        dev->card = SDHCI_CARD_NONE;
+        dev->blocks = 0;
+        return (rc != SDHCI_OK) ? rc : SDHCI_ERR_NO_CARD;
+    }
+
+    /* 5. Completion interrupt */
+    if (irq) {
+        gic_register_handler(irq, sdhci_irq_handler, dev);
+        sdhci_wr(dev, SDHCI_SIGNAL_ENABLE_OFFSET, SDHCI_SIGNAL_MASK);
+        gic_enable_irq(irq);
+    }
+
+    kprintf("[SDHCI] %s: %s, %lu MB, %u MHz 4-bit, ADMA2\n", dev->name, card_names[dev->card],
+            dev->blocks / 2048, dev->clock_hz / 1000000);
+    return SDHCI_OK;
+}
+
+/*
+ * ======================================================================================
+ * REQUEST QUEUE
+ * ======================================================================================
+ */
+
+void sdhci_req_init(sdhci_req_t *req, uint32_t op, uint64_t lba, uint32_t count, void *buf,
+                    void (*done)(sdhci_req_t *req), void *arg) {
+    req->op = op;
+    req->state = SDHCI_REQ_IDLE;
+    req->result = SDHCI_OK;
+    req->count = count;
+    req->lba = lba;
+    req->buf = buf;
+    req->done = done;
+    req->arg = arg;
+    req->submit_ticks = 0;
+}
+
+/*
+ * sdhci_issue
+ * Starts the next command if the controller is free: the request at the
+ * head plus every queued request that continues it, one descriptor chain.
+ * Called with the queue section held.
+ */
+static void sdhci_issue(sdhci_device_t *dev) {
+    sdhci_req_t *first, *r;
+    uint32_t n = 0, d = 0, blocks = 0, idx, mode;
+    uint64_t arg;
+
+    if (dev->nactive || dev->head == dev->tail) {
+        return;
+    }
+    if (sdhci_rd(dev, SDHCI_PRESENT_OFFSET) & (SDHCI_PRESENT_CMD_INHIBIT | SDHCI_PRESENT_DAT_INHIBIT)) {
+        return;                             // Card still busy; the next poll retries
+    }
+
+    /* 1. Gather, one or more descriptors per request */
+    first = dev->queue[dev->head & SDHCI_QUEUE_MASK];
+    while (dev->head != dev->tail) {
+        uint32_t bytes, nd;
+        uint64_t a;
+
+        r = dev->queue[dev->head & SDHCI_QUEUE_MASK];
+        bytes = r->count * SDHCI_BLOCK_SIZE;
+        nd = (bytes + SDHCI_ADMA_MAX_LEN - 1) / SDHCI_ADMA_MAX_LEN;
+        if (n && (r->op != first->op || r->lba != first->lba + blocks ||
+                  blocks + r->count > SDHCI_MAX_XFER_BLOCKS || d + nd > SDHCI_ADMA_DESCS)) {
+            break;
+        }
+
+        if (r->op == SDHCI_OP_WRITE) {
+            dcache_clean(r->buf, bytes);
+        } else {
+            dcache_flush(r->buf, bytes);
+        }
+        for (a = (uint64_t)(uintptr_t)r->buf; bytes; ) {
+            uint32_t len = (bytes > SDHCI_ADMA_MAX_LEN) ? SDHCI_ADMA_MAX_LEN : bytes;
+            sdhci_adma_set(&dev->adma[d++], a, len, 0);
+            a += len;
+            bytes -= len;
+        }
+
+        r->state = SDHCI_REQ_ACTIVE;
+        dev->active[n++] = r;
+        blocks += r->count;
+        dev->head++;
+    }
+    dev->adma[d - 1].attr |= SDHCI_ADMA_END;
+    dcache_clean(dev->adma, d * sizeof(sdhci_adma_desc_t));
+
+    /* 2. Multi-block commands stop themselves (Auto-CMD12) */
+    if (first->op == SDHCI_OP_WRITE) {
+        idx = (blocks > 1) ? SD_CMD_WRITE_MULTI : SD_CMD_WRITE_SINGLE;
+        mode = SDHCI_XFER_DMA;
+    } else {
+        idx = (blocks > 1) ? SD_CMD_READ_MULTI : SD_CMD_READ_SINGLE;
+        mode = SDHCI_XFER_DMA | SDHCI_XFER_READ;
+    }
+    if (blocks > 1) {
+        mode |= SDHCI_XFER_BLKCNT_EN | SDHCI_XFER_MULTI | SDHCI_XFER_ACMD12;
+    }
+    arg = (dev->card == SDHCI_CARD_SD) ? first->lba * SDHCI_BLOCK_SIZE : first->lba;
+
+    dev->nactive = n;
+    dev->active_blocks = blocks;
+    dev->active_ticks = timer_get_ticks();
+    dev->commands++;
+    dev->merged += n - 1;
+
+    /* 3. Go */
+    sdhci_adma_base(dev);
+    sdhci_wr(dev, SDHCI_INT_STATUS_OFFSET, SDHCI_STATUS_MASK);
+    sdhci_wr(dev, SDHCI_BLOCK_OFFSET, SDHCI_BLOCK_SIZE | (blocks << 16));
+    sdhci_wr(dev, SDHCI_ARG_OFFSET, (uint32_t)arg);
+    sdhci_wr(dev, SDHCI_CMD_OFFSET, SDHCI_CMD(idx, SDHCI_RSP_R1 | SDHCI_CMD_DATA) | mode);
+}
+
+/*
+ * sdhci_expire
+ * Nothing in flight, but the card has held CMD/DAT busy for
+ * SDHCI_BUSY_TIMEOUT_US since the head request was queued or the last
+ * command retired, whichever is later: resets both lines and fails the
+ * head request. Returns 1 with it in 'done[0]', else 0.
+ */
+static uint32_t sdhci_expire(sdhci_device_t *dev, sdhci_req_t **done) {
+    sdhci_req_t *r;
+    uint64_t since, now;
+
+    if (dev->head == dev->tail ||
+        !(sdhci_rd(dev, SDHCI_PRESENT_OFFSET) & (SDHCI_PRESENT_CMD_INHIBIT | SDHCI_PRESENT_DAT_INHIBIT))) {
+        return 0;
+    }
+    r = dev->queue[dev->head & SDHCI_QUEUE_MASK];
+    since = (r->submit_ticks > dev->active_ticks) ? r->submit_ticks : dev->active_ticks;
+    now = timer_get_ticks();
+    if (timer_ticks_to_us(now - since) <= SDHCI_BUSY_TIMEOUT_US) {
+        return 0;
+    }
+
+    kprintf("[SDHCI] ERR: %s card busy for %lu ms, %s at %lu failed\n", dev->name,
+            timer_ticks_to_us(now - since) / 1000, r->op == SDHCI_OP_WRITE ? "write" : "read", r->lba);
+    sdhci_reset(dev, SDHCI_RESET_CMD | SDHCI_RESET_DATA);
+    dev->head++;
+    dev->active_ticks = timer_get_ticks();  // The next request gets a full wait
+    dev->timeouts++;
+    dev->errors++;
+    r->result = SDHCI_ERR_TIMEOUT;
+    done[0] = r;
+    return 1;
+}
+
+/*
+ * sdhci_complete
+ * Retires the command in flight once it has finished, failed or timed
+ * out, or expires the head request on a stuck card. Moves the requests to
+ * 'done' and returns how many.
+ */
+static uint32_t sdhci_complete(sdhci_device_t *dev, sdhci_req_t **done) {
+    uint32_t sts, n = dev->nactive;
+    int rc = SDHCI_OK;
+
+    if (n == 0) {
+        return sdhci_expire(dev, done);
+    }
+
+    sts = sdhci_rd(dev, SDHCI_INT_STATUS_OFFSET);
+    if (sts & SDHCI_INT_ERR_MASK) {
+        rc = (sts & (SDHCI_INT_CMD_TIMEOUT | SDHCI_INT_DATA_TIMEOUT)) ? SDHCI_ERR_TIMEOUT : SDHCI_ERR_IO;
+        kprintf("[SDHCI] ERR: %s %s of %u blocks at %lu failed (status %x, ADMA %x)\n", dev->name,
+                dev->active[0]->op == SDHCI_OP_WRITE ? "write" : "read", dev->active_blocks,
+                dev->active[0]->lba, sts, sdhci_rd(dev, SDHCI_ADMA_ERROR_OFFSET));
+        sdhci_reset(dev, SDHCI_RESET_CMD | SDHCI_RESET_DATA);
+    } else if (!(sts & SDHCI_INT_XFER_DONE)) {
+        uint64_t limit = SDHCI_XFER_TIMEOUT_US + (uint64_t)dev->active_blocks * SDHCI_XFER_US_PER_BLK;
+        if (timer_ticks_to_us(timer_get_ticks() - dev->active_ticks) <= limit) {
+            return 0;
+        }
+        rc = SDHCI_ERR_TIMEOUT;
+        dev->timeouts++;
+        kprintf("[SDHCI] ERR: %s transfer of %u blocks at %lu timed out\n", dev->name,
+                dev->active_blocks, dev->active[0]->lba);
+        sdhci_reset(dev, SDHCI_RESET_CMD | SDHCI_RESET_DATA);
+    }
+    sdhci_wr(dev, SDHCI_INT_STATUS_OFFSET, sts | SDHCI_STATUS_MASK);
+
+    if (rc != SDHCI_OK) {
+        dev->errors++;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        sdhci_req_t *r = dev->active[i];
+
+        if (r->op == SDHCI_OP_READ) {
+            /* Lines the CPU may have speculated in during the transfer */
+            dcache_inval(r->buf, (uint64_t)r->count * SDHCI_BLOCK_SIZE);
+            if (rc == SDHCI_OK) dev->blocks_read += r->count;
+        } else if (rc == SDHCI_OK) {
+            dev->blocks_written += r->count;
+        }
+        r->result = rc;
+        done[i] = r;
+    }
+    dev->nactive = 0;
+    dev->active_ticks = timer_get_ticks();
+    return n;
+}
+
+/*
+ * sdhci_submit
+ * Queues 'req' and starts it if the controller is idle and the queue is
+ * not plugged. SDHCI_ERR_BUSY when the queue is full: poll and retry.
+ * Read buffers must be cache-line aligned (the invalidate after the DMA
+ * works on whole lines), write buffers 4-byte aligned.
+ */
+int sdhci_submit(sdhci_device_t *dev, sdhci_req_t *req) {
+    uint32_t irq;
+
+    if (dev->blocks == 0) {
+        return SDHCI_ERR_NO_CARD;
+    }
+    if (req->op > SDHCI_OP_WRITE || req->count == 0 || req->count > SDHCI_MAX_REQ_BLOCKS ||
+        req->lba + req->count > dev->blocks || ((uintptr_t)req->buf & 3) ||
+        (req->op == SDHCI_OP_READ && ((uintptr_t)req->buf & (DCACHE_LINE - 1)))) {
+        return SDHCI_ERR_INVALID;
+    }
+
+    irq = irq_prio_save_and_raise(IRQ_PRIO_CEIL_KERNEL);
+    if (dev->tail - dev->head >= SDHCI_QUEUE_DEPTH) {
+        irq_prio_restore(irq);
+        return SDHCI_ERR_BUSY;
+    }
+    req->state = SDHCI_REQ_QUEUED;
+    req->result = SDHCI_OK;
+    req->submit_ticks = timer_get_ticks();
+    dev->queue[dev->tail & SDHCI_QUEUE_MASK] = req;
+    dev->tail++;
+    dev->requests++;
+    if (!dev->plugged) {
+        sdhci_issue(dev);
+    }
+    irq_prio_restore(irq);
+    return SDHCI_OK;
+}
+
+/*
+ * sdhci_poll
+ * Retires the command in flight if it is over, starts the next one, then
+ * completes the retired requests. Returns how many completed. Issues even
+ * while plugged, so a full queue always drains.
+ */
+uint32_t sdhci_poll(sdhci_device_t *dev) {
+    sdhci_req_t *done[SDHCI_ADMA_DESCS];
+    uint32_t irq, n;
+
+    irq = irq_prio_save_and_raise(IRQ_PRIO_CEIL_KERNEL);
+    n = sdhci_complete(dev, done);
+    sdhci_issue(dev);                       // Card busy again while the callbacks run
+    for (uint32_t i = 0; i < n; i++) {
+        sdhci_req_t *r = done[i];
+        r->state = SDHCI_REQ_DONE;
+        if (r->done) {
+            r->done(r);
+        }
+    }
+    irq_prio_restore(irq);
+    return n;
+}
+
+/*
+ * sdhci_wait
+ * Spins until 'req' is done. Every command ends, at the latest on the
+ * driver's transfer timeout, and a card that stays busy fails the queued
+ * requests one SDHCI_BUSY_TIMEOUT_US at a time, so this does not take a
+ * timeout of its own.
+ */
+int sdhci_wait(sdhci_device_t *dev, sdhci_req_t *req) {
+    while (req->state != SDHCI_REQ_DONE) {
+        if (req->state == SDHCI_REQ_IDLE) {
+            return SDHCI_ERR_INVALID;       // Never submitted
+        }
+        sdhci_poll(dev);
+    }
+    return req->result;
+}
+
+void sdhci_plug(sdhci_device_t *dev) {
+    uint32_t irq = irq_prio_save_and_raise(IRQ_PRIO_CEIL_KERNEL);
+
+    dev->plugged++;
+    irq_prio_restore(irq);
+}
+
+void sdhci_unplug(sdhci_device_t *dev) {
+    uint32_t irq = irq_prio_save_and_raise(IRQ_PRIO_CEIL_KERNEL);
+
+    if (dev->plugged && --dev->plugged == 0) {
+        sdhci_issue(dev);
+    }
+    irq_prio_restore(irq);
+}
+
+static int sdhci_rw(sdhci_device_t *dev, uint32_t op, uint64_t lba, uint32_t count, void *buf) {
+    uint8_t *p = (uint8_t *)buf;
+    sdhci_req_t req;
+    int rc;
+
+    while (count) {
+        uint32_t n = (count > SDHCI_MAX_REQ_BLOCKS) ? SDHCI_MAX_REQ_BLOCKS : count;
+
+        sdhci_req_init(&req, op, lba, n, p, NULL, NULL);
+        while ((rc = sdhci_submit(dev, &req)) == SDHCI_ERR_BUSY) {
+            sdhci_poll(dev);
+        }
+        if (rc == SDHCI_OK) {
+            rc = sdhci_wait(dev, &req);
+        }
+        if (rc != SDHCI_OK) {
+            return rc;
+        }
+        lba += n;
+        count -= n;
+        p += (uint64_t)n * SDHCI_BLOCK_SIZE;
+    }
+    return SDHCI_OK;
+}
+
+/*
+ * sdhci_read / sdhci_write
+ * Blocking transfers through the queue.
+ */
+int sdhci_read(sdhci_device_t *dev, uint64_t lba, uint32_t count, void *buf) {
+    return sdhci_rw(dev, SDHCI_OP_READ, lba, count, buf);
+}
+
+int sdhci_write(sdhci_device_t *dev, uint64_t lba, uint32_t count, const void *buf) {
+    return sdhci_rw(dev, SDHCI_OP_WRITE, lba, count, (void *)buf);
+}
+
+void sdhci_irq_handler(uint32_t irq_id, void *arg) {
+    sdhci_device_t *dev = (sdhci_device_t *)arg;
+    (void)irq_id;
+
+    dev->irqs++;
+    sdhci_poll(dev);
+}
@@ -0,0 +1,284 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        sdhci_bench.c
+ * Module:      SD/eMMC Host Controller Driver (Benchmark)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Throughput and IOPS of the card in sdhci1 (the card slot), or sdhci0:
+ * - sequential MB/s by transfer size, one request at a time;
+ * - 4 KB sequential at queue depth 32, i.e. what request merging buys;
+ * - random 4 KB IOPS at queue depth 1 and 32, reads and writes;
+ * - the block cache: 4 KB sequential reads with and without read-ahead,
+ *   random reads inside a cached working set, random writes + sync.
+ * Runs on the last BENCH_SIZE bytes of the card, saved first and written
+ * back at the end. On QEMU (-drive if=sd,index=1) the figures are the
+ * emulator's, not a card's.
+ * ======================================================================================
+ */
+
+#include "drivers/sdhci.h"
+#include "drivers/sdhci_cache.h"
+#include "kernel/timer_heavy.h"
+#include "mm/pmm.h"
+#include "lib/kprintf.h"
+
+#define BENCH_SIZE              (4 * 1024 * 1024)
+#define BENCH_BLOCKS            (BENCH_SIZE / SDHCI_BLOCK_SIZE)
+#define BENCH_RUNS              3
+#define BENCH_IOS               1024        // Requests per queued run
+#define BENCH_QD                32
+#define BENCH_4K                (4096 / SDHCI_BLOCK_SIZE)
+#define BENCH_WSET              (SDHCI_CACHE_SLOTS / 2)     // Blocks, fits the cache
+
+static sdhci_req_t bench_req[BENCH_QD];
+static sdhci_cache_t bench_cache;
+static int bench_cache_ready;
+static uint32_t bench_rng = 0x9E3779B9;
+
+static uint32_t bench_rand(void) {
+    bench_rng ^= bench_rng << 13;
+    bench_rng ^= bench_rng >> 17;
+    bench_rng ^= bench_rng << 5;
+    return bench_rng;
+}
+
+/* Bytes per microsecond is MB/s */
+static uint64_t bench_mbps(uint64_t bytes, uint64_t ticks) {
+    uint64_t ns = timer_ticks_to_ns(ticks);
+    return ns ? (bytes * 1000) / ns : 0;
+}
+
+static uint64_t bench_iops(uint64_t ios, uint64_t ticks) {
+    uint64_t ns = timer_ticks_to_ns(ticks);
+    return ns ? (ios * 1000000000ULL) / ns : 0;
+}
+
+/*
+ * bench_seq
+ * The whole region in 'blocks'-sized blocking transfers, best of
+ * BENCH_RUNS. 0 on error.
+ */
+static uint64_t bench_seq(sdhci_device_t *dev, uint32_t op, uint64_t lba0, uint8_t *buf,
+                          uint32_t blocks) {
+    uint64_t best = UINT64_MAX;
+
+    for (uint32_t r = 0; r < BENCH_RUNS; r++) {
+        uint64_t t0 = timer_get_ticks(), t;
+
+        for (uint32_t b = 0; b < BENCH_BLOCKS; b += blocks) {
+            uint8_t *p = buf + (uint64_t)b * SDHCI_BLOCK_SIZE;
+            int rc = (op == SDHCI_OP_READ) ? sdhci_read(dev, lba0 + b, blocks, p)
+                                           : sdhci_write(dev, lba0 + b, blocks, p);
+            if (rc != SDHCI_OK) {
+                kprintf("[SDHCI] ERR: Benchmark transfer failed (%d)\n", rc);
+                return 0;
+            }
+        }
+        t = timer_get_ticks() - t0;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+/*
+ * bench_queued
+ * BENCH_IOS requests of 'blocks', sequential or at random aligned offsets
+ * in the region, with up to 'qd' in flight. Returns the elapsed ticks,
+ * 0 on error.
+ */
+static uint64_t bench_queued(sdhci_device_t *dev, uint32_t op, uint64_t lba0, uint8_t *buf,
+                             uint32_t blocks, uint32_t qd, int random) {
+    uint32_t slots = BENCH_BLOCKS / blocks, issued = 0, done = 0;
+    uint64_t t0 = timer_get_ticks();
+
+    for (uint32_t q = 0; q < qd; q++) {
+        bench_req[q].state = SDHCI_REQ_IDLE;
+    }
+    while (done < BENCH_IOS) {
+        for (uint32_t q = 0; q < qd; q++) {
+            sdhci_req_t *r = &bench_req[q];
+            uint32_t k;
+
+            if (r->state == SDHCI_REQ_QUEUED || r->state == SDHCI_REQ_ACTIVE) {
+                continue;
+            }
+            if (r->state == SDHCI_REQ_DONE) {
+                if (r->result != SDHCI_OK) {
+                    kprintf("[SDHCI] ERR: Benchmark request failed (%d)\n", r->result);
+                    while (sdhci_poll(dev) || dev->nactive) ;     // Drain
+                    return 0;
+                }
+                r->state = SDHCI_REQ_IDLE;
+                done++;
+            }
+            if (issued == BENCH_IOS) {
+                continue;
+            }
+            k = random ? bench_rand() % slots : issued % slots;
+            sdhci_req_init(r, op, lba0 + (uint64_t)k * blocks, blocks,
+                           buf + (uint64_t)k * blocks * SDHCI_BLOCK_SIZE, NULL, NULL);
+            if (sdhci_submit(dev, r) != SDHCI_OK) {
+                kprintf("[SDHCI] ERR: Benchmark submit failed\n");
+                return 0;
+            }
+            issued++;
+        }
+        sdhci_poll(dev);
+    }
+    return timer_get_ticks() - t0;
+}
+
+static void bench_report_queued(sdhci_device_t *dev, const char *label, uint32_t op,
+                                uint64_t lba0, uint8_t *buf, uint32_t qd, int random) {
+    uint64_t cmds = dev->commands;
+    uint64_t t = bench_queued(dev, op, lba0, buf, BENCH_4K, qd, random);
+
+    if (t == 0) {
+        return;
+    }
+    kprintf("[SDHCI] %s: %lu IOPS, %lu MB/s (%lu commands for %u requests)\n", label,
+            bench_iops(BENCH_IOS, t), bench_mbps((uint64_t)BENCH_IOS * 4096, t),
+            dev->commands - cmds, BENCH_IOS);
+}
+
+/* 4 KB sequential reads through the cache, cold, best of BENCH_RUNS */
+static uint64_t bench_cache_seq(sdhci_cache_t *c, uint64_t lba0, uint8_t *buf) {
+    uint64_t best = UINT64_MAX;
+
+    for (uint32_t r = 0; r < BENCH_RUNS; r++) {
+        uint64_t t0, t;
+
+        sdhci_cache_drop(c);
+        t0 = timer_get_ticks();
+        for (uint32_t b = 0; b < BENCH_BLOCKS; b += BENCH_4K) {
+            if (sdhci_cache_read(c, lba0 + b, BENCH_4K, buf + (uint64_t)b * SDHCI_BLOCK_SIZE) != SDHCI_OK) {
+                kprintf("[SDHCI] ERR: Cached read failed\n");
+                return 0;
+            }
+        }
+        t = timer_get_ticks() - t0;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+static void bench_cached(sdhci_device_t *dev, uint64_t lba0, uint8_t *buf) {
+    sdhci_cache_t *c = &bench_cache;
+    uint64_t t0, t, hits, ios;
+    uint32_t wslots = BENCH_WSET / BENCH_4K;
+
+    if (!bench_cache_ready) {
+        if (sdhci_cache_init(c, dev) != SDHCI_OK) {
+            return;
+        }
+        bench_cache_ready = 1;
+    }
+    c->dev = dev;
+
+    /* 1. Sequential, read-ahead off / on */
+    c->ra_max = 0;
+    t = bench_cache_seq(c, lba0, buf);
+    kprintf("[SDHCI] Cache 4K seq read, no read-ahead: %lu MB/s\n", bench_mbps(BENCH_SIZE, t));
+    c->ra_max = SDHCI_CACHE_RA_MAX;
+    ios = c->ra_hits;
+    t = bench_cache_seq(c, lba0, buf);
+    kprintf("[SDHCI] Cache 4K seq read, read-ahead:    %lu MB/s (%lu blocks found read ahead)\n",
+            bench_mbps(BENCH_SIZE, t), (c->ra_hits - ios) / BENCH_RUNS);
+
+    /* 2. Random reads in a working set that fits */
+    sdhci_cache_drop(c);
+    sdhci_cache_read(c, lba0, BENCH_WSET, buf);
+    hits = c->hits;
+    t0 = timer_get_ticks();
+    for (uint32_t i = 0; i < BENCH_IOS; i++) {
+        uint32_t k = bench_rand() % wslots;
+        sdhci_cache_read(c, lba0 + (uint64_t)k * BENCH_4K, BENCH_4K, buf);
+    }
+    t = timer_get_ticks() - t0;
+    kprintf("[SDHCI] Cache 4K rand read (hot):   %lu IOPS, %lu%% hits\n", bench_iops(BENCH_IOS, t),
+            ((c->hits - hits) * 100) / ((uint64_t)BENCH_IOS * BENCH_4K));
+
+    /* 3. Random writes, write-back included */
+    t0 = timer_get_ticks();
+    for (uint32_t i = 0; i < BENCH_IOS; i++) {
+        uint32_t k = bench_rand() % wslots;
+        sdhci_cache_write(c, lba0 + (uint64_t)k * BENCH_4K, BENCH_4K,
+                          buf + (uint64_t)k * BENCH_4K * SDHCI_BLOCK_SIZE);
+    }
+    ios = c->writebacks;
+    if (sdhci_cache_sync(c) != SDHCI_OK) {
+        kprintf("[SDHCI] ERR: Cache sync failed\n");
+    }
+    t = timer_get_ticks() - t0;
+    kprintf("[SDHCI] Cache 4K rand write + sync: %lu IOPS (%lu blocks written back at sync)\n",
+            bench_iops(BENCH_IOS, t), c->writebacks - ios);
+    sdhci_cache_drop(c);
+}
+
+/*
+ * sdhci_benchmark
+ * Needs an initialized device with a card of at least BENCH_SIZE.
+ */
+void sdhci_benchmark(void) {
+    static const uint32_t sizes[] = { 8, 128, 2048 };       // 4 KB, 64 KB, 1 MB
+    sdhci_device_t *dev = sdhci1.blocks ? &sdhci1 : &sdhci0;
+    uint64_t pa, lba0, t;
+    uint8_t *save, *buf;
+
+    if (dev->blocks < BENCH_BLOCKS) {
+        kprintf("[SDHCI] ERR: Benchmark needs a card (sdhci0/1 not initialized)\n");
+        return;
+    }
+
+    pa = pmm_alloc(2 * BENCH_SIZE, PMM_F_LOW);
+    if (pa == 0) {
+        kprintf("[SDHCI] ERR: No memory for the benchmark buffers\n");
+        return;
+    }
+    save = (uint8_t *)(uintptr_t)pa;
+    buf = save + BENCH_SIZE;
+    lba0 = dev->blocks - BENCH_BLOCKS;
+
+    kprintf("\n[SDHCI] Benchmark: %s, %u KB at block %lu, best of %u\n", dev->name,
+            BENCH_SIZE / 1024, lba0, BENCH_RUNS);
+
+    /* 0. Keep what is there */
+    if (sdhci_read(dev, lba0, BENCH_BLOCKS, save) != SDHCI_OK) {
+        kprintf("[SDHCI] ERR: Could not save the benchmark region\n");
+        pmm_free(pa, 2 * BENCH_SIZE);
+        return;
+    }
+    for (uint32_t i = 0; i < BENCH_SIZE; i++) {
+        buf[i] = (uint8_t)(i * 131 + (i >> 11));
+    }
+
+    /* 1. Sequential, one request at a time */
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint64_t tw = bench_seq(dev, SDHCI_OP_WRITE, lba0, buf, sizes[s]);
+        t = bench_seq(dev, SDHCI_OP_READ, lba0, buf, sizes[s]);
+        kprintf("[SDHCI] Seq %u KB: read %lu MB/s, write %lu MB/s\n", sizes[s] / 2,
+                bench_mbps(BENCH_SIZE, t), bench_mbps(BENCH_SIZE, tw));
+    }
+
+    /* 2. Queued: merging, then random */
+    bench_report_queued(dev, "4K seq read   QD32", SDHCI_OP_READ, lba0, buf, BENCH_QD, 0);
+    bench_report_queued(dev, "4K rand read  QD1 ", SDHCI_OP_READ, lba0, buf, 1, 1);
+    bench_report_queued(dev, "4K rand read  QD32", SDHCI_OP_READ, lba0, buf, BENCH_QD, 1);
+    bench_report_queued(dev, "4K rand write QD1 ", SDHCI_OP_WRITE, lba0, buf, 1, 1);
+    bench_report_queued(dev, "4K rand write QD32", SDHCI_OP_WRITE, lba0, buf, BENCH_QD, 1);
+
+    /* 3. Block cache */
+    bench_cached(dev, lba0, buf);
+
+    /* 4. Put the region back */
+    if (sdhci_write(dev, lba0, BENCH_BLOCKS, save) != SDHCI_OK) {
+        kprintf("[SDHCI] ERR: Could not restore the benchmark region\n");
+    }
+    kprintf("[SDHCI] %lu commands carried %lu requests, %lu errors\n", dev->commands,
+            dev->requests, dev->errors);
+    pmm_free(pa, 2 * BENCH_SIZE);
+}
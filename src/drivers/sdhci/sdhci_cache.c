@@ -0,0 +1,490 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        sdhci_cache.c
+ * Module:      SD/eMMC Block Cache Implementation
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Slots sit on one doubly linked LRU list (indices, MRU at the head) and,
+ * once they hold a block, on a hash chain. Lookup, replacement and the
+ * stream state belong to the caller; the completion only moves a slot's
+ * flags out of BUSY, so nothing here needs the queue's IRQ section.
+ * ======================================================================================
+ */
+
+#include <string.h>
+#include "drivers/sdhci_cache.h"
+#include "mm/pmm.h"
+#include "lib/kprintf.h"
+
+#define CACHE_NO_LBA            UINT64_MAX
+#define CACHE_ALLOC_ROUNDS      8           // Write-back retries before a victim search gives up
+
+/*
+ * ======================================================================================
+ * LOOKUP AND REPLACEMENT
+ * ======================================================================================
+ */
+
+static inline uint32_t cache_bucket(uint64_t lba) {
+    return (uint32_t)(lba ^ (lba >> 16)) & (SDHCI_CACHE_HASH - 1);
+}
+
+static inline uint16_t cache_index(const sdhci_cache_t *c, const sdhci_cache_slot_t *s) {
+    return (uint16_t)(s - c->slot);
+}
+
+static sdhci_cache_slot_t *cache_lookup(sdhci_cache_t *c, uint64_t lba) {
+    for (uint16_t i = c->hash[cache_bucket(lba)]; i != SDHCI_CACHE_NIL; i = c->slot[i].hnext) {
+        if (c->slot[i].lba == lba) {
+            return &c->slot[i];
+        }
+    }
+    return NULL;
+}
+
+static void cache_hash_add(sdhci_cache_t *c, sdhci_cache_slot_t *s) {
+    uint16_t *head = &c->hash[cache_bucket(s->lba)];
+
+    s->hnext = *head;
+    *head = cache_index(c, s);
+}
+
+static void cache_hash_del(sdhci_cache_t *c, sdhci_cache_slot_t *s) {
+    uint16_t *p = &c->hash[cache_bucket(s->lba)];
+    uint16_t i = cache_index(c, s);
+
+    while (*p != i) {
+        p = &c->slot[*p].hnext;
+    }
+    *p = s->hnext;
+}
+
+/* To the MRU end */
+static void cache_touch(sdhci_cache_t *c, sdhci_cache_slot_t *s) {
+    uint16_t i = cache_index(c, s);
+
+    if (c->mru == i) {
+        return;
+    }
+    c->slot[s->prev].next = s->next;        // Not the MRU, so prev exists
+    if (s->next != SDHCI_CACHE_NIL) {
+        c->slot[s->next].prev = s->prev;
+    } else {
+        c->lru = s->prev;
+    }
+    s->prev = SDHCI_CACHE_NIL;
+    s->next = c->mru;
+    c->slot[c->mru].prev = i;
+    c->mru = i;
+}
+
+/*
+ * ======================================================================================
+ * BLOCK I/O
+ * ======================================================================================
+ */
+
+static void cache_io_done(sdhci_req_t *req) {
+    sdhci_cache_slot_t *s = (sdhci_cache_slot_t *)req;
+    sdhci_cache_t *c = (sdhci_cache_t *)req->arg;
+
+    if (req->result != SDHCI_OK) {
+        c->io_errors++;                     // Fill: stays invalid. Write-back: stays dirty
+    } else if (req->op == SDHCI_OP_READ) {
+        s->flags |= SDHCI_CS_VALID;
+    } else {
+        s->flags &= ~SDHCI_CS_DIRTY;
+        __atomic_fetch_sub(&c->dirty, 1, __ATOMIC_RELAXED);
+    }
+    s->flags &= ~SDHCI_CS_BUSY;
+}
+
+static int cache_io(sdhci_cache_t *c, sdhci_cache_slot_t *s, uint32_t op) {
+    int rc;
+
+    s->flags |= SDHCI_CS_BUSY;
+    sdhci_req_init(&s->req, op, s->lba, 1, s->data, cache_io_done, c);
+    while ((rc = sdhci_submit(c->dev, &s->req)) == SDHCI_ERR_BUSY) {
+        sdhci_poll(c->dev);
+    }
+    if (rc != SDHCI_OK) {
+        s->flags &= ~SDHCI_CS_BUSY;
+    }
+    return rc;
+}
+
+/* Dirty and not already on its way to the card */
+static inline int cache_wb_ready(const sdhci_cache_slot_t *s) {
+    return (s->flags & (SDHCI_CS_DIRTY | SDHCI_CS_BUSY)) == SDHCI_CS_DIRTY;
+}
+
+/*
+ * cache_writeback_run
+ * Writes back the run of dirty blocks around 's', queued plugged so it
+ * leaves as one command. Returns the blocks submitted.
+ */
+static uint32_t cache_writeback_run(sdhci_cache_t *c, sdhci_cache_slot_t *s) {
+    sdhci_cache_slot_t *p;
+    uint64_t lba = s->lba;
+    uint32_t n = 0;
+
+    while (lba > 0 && s->lba - lba < SDHCI_CACHE_RUN_MAX / 2 &&
+           (p = cache_lookup(c, lba - 1)) != NULL && cache_wb_ready(p)) {
+        lba--;
+    }
+
+    sdhci_plug(c->dev);
+    while (n < SDHCI_CACHE_RUN_MAX && (p = cache_lookup(c, lba)) != NULL && cache_wb_ready(p)) {
+        if (cache_io(c, p, SDHCI_OP_WRITE) != SDHCI_OK) {
+            break;
+        }
+        lba++;
+        n++;
+    }
+    sdhci_unplug(c->dev);
+
+    c->writebacks += n;
+    return n;
+}
+
+/*
+ * cache_alloc
+ * Takes the least recently used slot that is clean, idle and not pinned
+ * for 'lba' and puts it at the MRU end. Dirty slots passed over on the
+ * way are written back; when no slot is free yet, waits for the card.
+ * NULL if write-backs keep failing.
+ */
+static sdhci_cache_slot_t *cache_alloc(sdhci_cache_t *c, uint64_t lba) {
+    uint32_t rounds = 0;
+
+    for (;;) {
+        int waiting = 0, wrote = 0;
+
+        for (uint16_t i = c->lru; i != SDHCI_CACHE_NIL; i = c->slot[i].prev) {
+            sdhci_cache_slot_t *s = &c->slot[i];
+
+            if (s->pinned || (s->flags & SDHCI_CS_BUSY)) {
+                waiting |= !s->pinned;
+                continue;
+            }
+            if (s->flags & SDHCI_CS_DIRTY) {
+                if (cache_writeback_run(c, s)) {
+                    waiting = 1;
+                    wrote = 1;
+                }
+                continue;
+            }
+
+            if (s->lba != CACHE_NO_LBA) {
+                cache_hash_del(c, s);
+                c->evictions++;
+            }
+            s->lba = lba;
+            s->flags = 0;
+            s->ra = 0;
+            cache_hash_add(c, s);
+            cache_touch(c, s);
+            return s;
+        }
+
+        rounds += wrote;
+        if (!waiting || rounds > CACHE_ALLOC_ROUNDS) {
+            kprintf("[SDHCI] ERR: %s block cache has no free slot\n", c->dev->name);
+            return NULL;
+        }
+        sdhci_poll(c->dev);
+    }
+}
+
+/*
+ * cache_writeback
+ * Starts writing back about 'want' of the oldest dirty blocks.
+ */
+static void cache_writeback(sdhci_cache_t *c, uint32_t want) {
+    uint32_t n = 0;
+
+    for (uint16_t i = c->lru; i != SDHCI_CACHE_NIL && n < want; i = c->slot[i].prev) {
+        if (cache_wb_ready(&c->slot[i])) {
+            n += cache_writeback_run(c, &c->slot[i]);
+        }
+    }
+}
+
+/*
+ * cache_readahead
+ * Keeps the stream's window in flight beyond 'end'. Tops it up only when
+ * less than half of it is left, so refills go out in batches.
+ */
+static void cache_readahead(sdhci_cache_t *c, uint64_t end) {
+    uint64_t from, to;
+
+    if (c->ra_window == 0 || c->ra_next > end + c->ra_window / 2) {
+        return;
+    }
+    from = (c->ra_next > end) ? c->ra_next : end;
+    to = end + c->ra_window;
+    if (to > c->dev->blocks) {
+        to = c->dev->blocks;
+    }
+
+    for (uint64_t b = from; b < to; b++) {
+        sdhci_cache_slot_t *s = cache_lookup(c, b);
+
+        if (s && (s->flags & (SDHCI_CS_VALID | SDHCI_CS_BUSY))) {
+            continue;
+        }
+        if (!s && (s = cache_alloc(c, b)) == NULL) {
+            to = b;
+            break;
+        }
+        if (cache_io(c, s, SDHCI_OP_READ) != SDHCI_OK) {
+            to = b;
+            break;
+        }
+        s->ra = 1;
+        c->ra_blocks++;
+    }
+    c->ra_next = to;
+}
+
+/*
+ * ======================================================================================
+ * INTERFACE
+ * ======================================================================================
+ */
+
+/*
+ * sdhci_cache_init
+ * Empty cache in front of 'dev', read-ahead on. The block pool comes
+ * from low memory.
+ */
+int sdhci_cache_init(sdhci_cache_t *c, sdhci_device_t *dev) {
+    uint64_t pa = pmm_alloc((size_t)SDHCI_CACHE_SLOTS * SDHCI_BLOCK_SIZE, PMM_F_LOW);
+
+    if (pa == 0) {
+        kprintf("[SDHCI] ERR: No memory for the block cache\n");
+        return SDHCI_ERR_NOMEM;
+    }
+    c->dev = dev;
+    c->data = (uint8_t *)(uintptr_t)pa;
+    c->ra_max = SDHCI_CACHE_RA_MAX;
+
+    for (uint32_t i = 0; i < SDHCI_CACHE_HASH; i++) {
+        c->hash[i] = SDHCI_CACHE_NIL;
+    }
+    for (uint32_t i = 0; i < SDHCI_CACHE_SLOTS; i++) {
+        sdhci_cache_slot_t *s = &c->slot[i];
+        s->lba = CACHE_NO_LBA;
+        s->data = c->data + (size_t)i * SDHCI_BLOCK_SIZE;
+        s->flags = 0;
+        s->ra = 0;
+        s->pinned = 0;
+        s->hnext = SDHCI_CACHE_NIL;
+        s->prev = i ? (uint16_t)(i - 1) : SDHCI_CACHE_NIL;
+        s->next = (i + 1 < SDHCI_CACHE_SLOTS) ? (uint16_t)(i + 1) : SDHCI_CACHE_NIL;
+        s->req.state = SDHCI_REQ_IDLE;
+    }
+    c->mru = 0;
+    c->lru = SDHCI_CACHE_SLOTS - 1;
+    c->dirty = 0;
+
+    c->seq_next = CACHE_NO_LBA;
+    c->ra_next = 0;
+    c->ra_window = 0;
+
+    c->hits = 0;
+    c->misses = 0;
+    c->ra_blocks = 0;
+    c->ra_hits = 0;
+    c->writebacks = 0;
+    c->evictions = 0;
+    c->io_errors = 0;
+    return SDHCI_OK;
+}
+
+/*
+ * cache_read_chunk
+ * Up to SDHCI_CACHE_CHUNK blocks: fills for the misses go out together
+ * (with the read-ahead top-up when 'ra'), then blocks are copied out as
+ * they land. The chunk's slots are pinned so filling one cannot evict
+ * another.
+ */
+static int cache_read_chunk(sdhci_cache_t *c, uint64_t lba, uint32_t n, uint8_t *out, int ra) {
+    sdhci_cache_slot_t *sl[SDHCI_CACHE_CHUNK];
+    uint32_t got = 0;
+    int rc = SDHCI_OK;
+
+    /* 1. Look up, start the fills */
+    sdhci_plug(c->dev);
+    for (; got < n; got++) {
+        sdhci_cache_slot_t *s = cache_lookup(c, lba + got);
+
+        if (s && (s->flags & (SDHCI_CS_VALID | SDHCI_CS_BUSY))) {
+            c->hits++;
+            if (s->ra) {
+                c->ra_hits++;
+                s->ra = 0;
+            }
+            cache_touch(c, s);
+        } else {
+            c->misses++;
+            if (!s) {
+                s = cache_alloc(c, lba + got);
+            } else {
+                cache_touch(c, s);          // Earlier fill failed: retry
+            }
+            if (!s || cache_io(c, s, SDHCI_OP_READ) != SDHCI_OK) {
+                rc = SDHCI_ERR_IO;
+                break;
+            }
+        }
+        s->pinned = 1;
+        sl[got] = s;
+    }
+    if (ra && rc == SDHCI_OK) {
+        cache_readahead(c, lba + n);
+    }
+    sdhci_unplug(c->dev);
+
+    /* 2. Copy out as the blocks land */
+    for (uint32_t i = 0; i < got; i++) {
+        sdhci_cache_slot_t *s = sl[i];
+
+        while ((s->flags & (SDHCI_CS_VALID | SDHCI_CS_BUSY)) == SDHCI_CS_BUSY) {
+            sdhci_poll(c->dev);
+        }
+        if (s->flags & SDHCI_CS_VALID) {
+            memcpy(out + (size_t)i * SDHCI_BLOCK_SIZE, s->data, SDHCI_BLOCK_SIZE);
+        } else {
+            rc = SDHCI_ERR_IO;
+        }
+        s->pinned = 0;
+    }
+    return rc;
+}
+
+/*
+ * sdhci_cache_read
+ * 'count' blocks from 'lba' into 'buf', through the cache.
+ */
+int sdhci_cache_read(sdhci_cache_t *c, uint64_t lba, uint32_t count, void *buf) {
+    uint8_t *out = (uint8_t *)buf;
+    int rc;
+
+    if (lba + count > c->dev->blocks || lba + count < lba) {
+        return SDHCI_ERR_INVALID;
+    }
+
+    /* 1. Stream detection: the window doubles while reads keep continuing each other */
+    if (c->ra_max && lba == c->seq_next) {
+        c->ra_window = c->ra_window ? 2 * c->ra_window : SDHCI_CACHE_RA_MIN;
+        if (c->ra_window > c->ra_max) c->ra_window = c->ra_max;
+    } else {
+        c->ra_window = 0;
+        c->ra_next = 0;
+    }
+    c->seq_next = lba + count;
+
+    /* 2. Chunks, read-ahead with the last */
+    while (count) {
+        uint32_t n = (count > SDHCI_CACHE_CHUNK) ? SDHCI_CACHE_CHUNK : count;
+
+        rc = cache_read_chunk(c, lba, n, out, n == count);
+        if (rc != SDHCI_OK) {
+            return rc;
+        }
+        lba += n;
+        count -= n;
+        out += (size_t)n * SDHCI_BLOCK_SIZE;
+    }
+    return SDHCI_OK;
+}
+
+/*
+ * sdhci_cache_write
+ * 'count' blocks from 'buf' into the cache; write-back is deferred.
+ */
+int sdhci_cache_write(sdhci_cache_t *c, uint64_t lba, uint32_t count, const void *buf) {
+    const uint8_t *in = (const uint8_t *)buf;
+
+    if (lba + count > c->dev->blocks || lba + count < lba) {
+        return SDHCI_ERR_INVALID;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        sdhci_cache_slot_t *s = cache_lookup(c, lba + i);
+
+        if (s) {
+            /* Fill or write-back of the old contents still in flight */
+            while (s->flags & SDHCI_CS_BUSY) {
+                sdhci_poll(c->dev);
+            }
+            cache_touch(c, s);
+        } else if ((s = cache_alloc(c, lba + i)) == NULL) {
+            return SDHCI_ERR_IO;
+        }
+
+        memcpy(s->data, in + (size_t)i * SDHCI_BLOCK_SIZE, SDHCI_BLOCK_SIZE);
+        if (!(s->flags & SDHCI_CS_DIRTY)) {
+            __atomic_fetch_add(&c->dirty, 1, __ATOMIC_RELAXED);
+        }
+        s->flags |= SDHCI_CS_VALID | SDHCI_CS_DIRTY;
+        s->ra = 0;
+    }
+
+    if (c->dirty > SDHCI_CACHE_DIRTY_HIGH) {
+        cache_writeback(c, c->dirty - SDHCI_CACHE_DIRTY_LOW);
+    }
+    return SDHCI_OK;
+}
+
+/*
+ * sdhci_cache_sync
+ * Writes back every dirty block and waits for the card. SDHCI_ERR_IO if
+ * any transfer failed meanwhile; the blocks that did not make it stay
+ * dirty.
+ */
+int sdhci_cache_sync(sdhci_cache_t *c) {
+    uint64_t errors = c->io_errors;
+
+    for (uint32_t i = 0; i < SDHCI_CACHE_SLOTS; i++) {
+        if (cache_wb_ready(&c->slot[i])) {
+            cache_writeback_run(c, &c->slot[i]);
+        }
+    }
+    for (uint32_t i = 0; i < SDHCI_CACHE_SLOTS; i++) {
+        while (c->slot[i].flags & SDHCI_CS_BUSY) {
+            sdhci_poll(c->dev);
+        }
+    }
+    return (c->dirty || c->io_errors != errors) ? SDHCI_ERR_IO : SDHCI_OK;
+}
+
+/*
+ * sdhci_cache_drop
+ * Sync, then forget every block that is safely on the card (cold cache,
+ * or after the card was written behind the cache's back).
+ */
+int sdhci_cache_drop(sdhci_cache_t *c) {
+    int rc = sdhci_cache_sync(c);
+
+    for (uint32_t i = 0; i < SDHCI_CACHE_SLOTS; i++) {
+        sdhci_cache_slot_t *s = &c->slot[i];
+
+        if (s->lba == CACHE_NO_LBA || (s->flags & SDHCI_CS_DIRTY)) {
+            continue;
+        }
+        cache_hash_del(c, s);
+        s->lba = CACHE_NO_LBA;
+        s->flags = 0;
+        s->ra = 0;
+    }
+    c->seq_next = CACHE_NO_LBA;
+    c->ra_next = 0;
+    c->ra_window = 0;
+    return rc;
+}
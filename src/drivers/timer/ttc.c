@@ -0,0 +1,79 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        ttc.c
+ * Module:      Cadence Triple Timer Counter (TTC) Driver Implementation
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * ======================================================================================
+ */
+
+#include "drivers/ttc.h"
+
+/* Helper Macros for Memory Mapped I/O */
+#define MMIO_READ32(addr)       (*(volatile uint32_t *)(addr))
+#define MMIO_WRITE32(addr, val) (*(volatile uint32_t *)(addr) = (val))
+
+/*
+ * ttc_isr
+ * Reading the status register clears it; then forward to the owner.
+ */
+static void ttc_isr(uint32_t irq_id, void *arg) {
+    ttc_timer_t *t = (ttc_timer_t *)arg;
+
+    if (MMIO_READ32(t->base + TTC_ISR_OFFSET) & TTC_IXR_INTERVAL) {
+        t->ticks++;
+        if (t->callback) {
+            t->callback(irq_id, t->arg);
+        }
+    }
+}
+
+/*
+ * ttc_init
+ * Stops the counter and hooks the interrupt. Does not start ticking.
+ */
+void ttc_init(ttc_timer_t *t, uintptr_t base, uint32_t irq, irq_handler_t callback, void *arg) {
+    t->base = base;
+    t->irq_num = irq;
+    t->callback = callback;
+    t->arg = arg;
+    t->period_us = 0;
+    t->ticks = 0;
+
+    /* 1. Stop counter, no prescaler (100 MHz -> 10ns resolution) */
+    MMIO_WRITE32(base + TTC_CNT_CTRL_OFFSET, TTC_CNT_CTRL_DIS);
+    MMIO_WRITE32(base + TTC_CLK_CTRL_OFFSET, 0);
+    MMIO_WRITE32(base + TTC_IER_OFFSET, 0);
+    (void)MMIO_READ32(base + TTC_ISR_OFFSET);
+
+    /* 2. Hook into GIC (lower priority than the generic timer) */
+    gic_register_handler(irq, ttc_isr, t);
+    gic_set_priority(irq, GIC_PRIO_HIGH);
+    gic_enable_irq(irq);
+}
+
+/*
+ * ttc_start_periodic
+ * (Re)starts the counter in interval mode. Safe to call while running.
+ */
+void ttc_start_periodic(ttc_timer_t *t, uint32_t period_us) {
+    uint32_t interval = (uint32_t)((TTC_INPUT_CLK_HZ / 1000000UL) * period_us);
+
+    if (period_us == t->period_us) {
+        return;
+    }
+
+    t->period_us = period_us;
+    MMIO_WRITE32(t->base + TTC_CNT_CTRL_OFFSET, TTC_CNT_CTRL_DIS);
+    MMIO_WRITE32(t->base + TTC_INTERVAL_OFFSET, interval);
+    MMIO_WRITE32(t->base + TTC_IER_OFFSET, TTC_IXR_INTERVAL);
+    MMIO_WRITE32(t->base + TTC_CNT_CTRL_OFFSET, TTC_CNT_CTRL_INT | TTC_CNT_CTRL_RST);
+}
+
+void ttc_stop(ttc_timer_t *t) {
+    MMIO_WRITE32(t->base + TTC_CNT_CTRL_OFFSET, TTC_CNT_CTRL_DIS);
+    MMIO_WRITE32(t->base + TTC_IER_OFFSET, 0);
+    (void)MMIO_READ32(t->base + TTC_ISR_OFFSET);
+    t->period_us = 0;
+}
@@ -10,19 +10,41 @@
 
 #include "drivers/uart_ps.h"
 #include "drivers/gic_v2.h"
+#include "kernel/irq_prio.h"
 #include "kernel/timer_heavy.h"
 
+/* Ring Storage */
+static uint8_t console_tx_storage[UART_RING_BUFFER_SIZE];
+static uint8_t console_rx_storage[UART_RING_BUFFER_SIZE];
+static uint8_t data_tx_storage[UART_DATA_RING_SIZE];
+static uint8_t data_rx_storage[UART_DATA_RING_SIZE];
+
 /* Primary Console Instance (UART0 or UART1 based on board config) */
 /* On Kria KV260, UART1 is usually the USB-UART */
 uart_driver_t console_uart = {
+    .name      = "uart1",
     .base_addr = ZYNQMP_UART1_BASE, 
     .baud_rate = 115200,
-    .irq_num   = 54 // SPI 22 + 32 = 54 for UART1
+    .irq_num   = UART1_IRQ_ID, // SPI 22 + 32 = 54 for UART1
+    .flags     = UART_F_CRLF,
+    .tx_buffer = { .buffer = console_tx_storage, .size = UART_RING_BUFFER_SIZE },
+    .rx_buffer = { .buffer = console_rx_storage, .size = UART_RING_BUFFER_SIZE }
+};
+
+/* High-Speed Data Link (binary HOCS command channel) */
+uart_driver_t data_uart = {
+    .name      = "uart0",
+    .base_addr = ZYNQMP_UART0_BASE,
+    .baud_rate = 3000000,
+    .irq_num   = UART0_IRQ_ID,
+    .flags     = UART_F_IRQ,
+    .tx_buffer = { .buffer = data_tx_storage, .size = UART_DATA_RING_SIZE },
+    .rx_buffer = { .buffer = data_rx_storage, .size = UART_DATA_RING_SIZE }
 };
 
 /* Register Access Macros */
-#define UART_READ(reg)          (*(volatile uint32_t *)(console_uart.base_addr + reg))
-#define UART_WRITE(reg, val)    (*(volatile uint32_t *)(console_uart.base_addr + reg) = (val))
+#define UART_READ(u, reg)       (*(volatile uint32_t *)((u)->base_addr + (reg)))
+#define UART_WRITE(u, reg, val) (*(volatile uint32_t *)((u)->base_addr + (reg)) = (val))
 
 /*
  * ======================================================================================
@@ -30,22 +52,22 @@ uart_driver_t console_uart = {
  * ======================================================================================
  * We use circular buffers to allow the Kernel to write thousands of logs
  * without waiting for the slow serial port to physically send each byte.
+ * Producer only writes head, consumer only writes tail. The TX ring has
+ * a consumer on both sides (the ISR and a thread draining a full ring),
+ * so thread-side TX first masks TXEMPTY at the UART: the ISR only pops
+ * while that source is enabled. The priority-mask section around it
+ * keeps the rest of the ISR (RX) off the FIFO registers meanwhile.
  */
 
-static void rb_push(ring_buffer_t *rb, uint8_t data) {
-    uint32_t next = (rb->head + 1) % UART_RING_BUFFER_SIZE;
-    
-    /* If buffer is full, overwrite the oldest data (Drop strategy)
-     * In a critical system, we might want to block or panic here.
-     */
-    if (next == rb->tail) {
-        rb->tail = (rb->tail + 1) % UART_RING_BUFFER_SIZE;
-        /* TODO: Increment overflow counter */
+static int rb_push(ring_buffer_t *rb, uint8_t data) {
+    if (ring_used(rb) >= rb->size) {
+        return 0; // Full: caller decides (drop RX byte / drain TX)
     }
 
-    rb->buffer[rb->head] = data;
-    rb->head = next;
-    rb->count++;
+    rb->buffer[rb->head & (rb->size - 1)] = data;
+    asm volatile("dmb ish" ::: "memory");
+    rb->head++;
+    return 1;
 }
 
 static int rb_pop(ring_buffer_t *rb, uint8_t *data) {
@@ -53,11 +75,12 @@ static int rb_pop(ring_buffer_t *rb, uint8_t *data) {
         return 0; // Empty
     }
 
-    *data = rb->buffer[rb->tail];
-    rb->tail = (rb->tail + 1) % UART_RING_BUFFER_SIZE;
-    rb->count--;
+    *data = rb->buffer[rb->tail & (rb->size - 1)];
+    asm volatile("dmb ish" ::: "memory");
+    rb->tail++;
     return 1; // Success
 }
+
 /*
  * ======================================================================================
  * INITIALIZATION & CONFIGURATION
@@ -101,95 +124,266 @@ static void uart_calc_baud_divisors(uint32_t target_baud, uint32_t *cd, uint32_t
     *bdiv = best_bdiv;
 }
 
-void uart_init_controller(void) {
+/*
+ * uart_dev_init
+ * Brings up one controller instance. Instances with UART_F_IRQ get their
+ * RX path interrupt-driven into rx_buffer and their TX path drained from
+ * tx_buffer by the TX-empty interrupt.
+ */
+void uart_dev_init(uart_driver_t *u) {
     /* 1. Disable UART (TX and RX) */
-    UART_WRITE(UART_CR_OFFSET, UART_CR_TX_DIS | UART_CR_RX_DIS);
+    UART_WRITE(u, UART_CR_OFFSET, UART_CR_TX_DIS | UART_CR_RX_DIS);
+    UART_WRITE(u, UART_IDR_OFFSET, 0xFFFFFFFF);
 
     /* 2. Configure Mode Register */
     /* 8 Data bits, No Parity, 1 Stop bit */
-    UART_WRITE(UART_MR_OFFSET, UART_MR_CHARLEN_8 | UART_MR_PAR_NONE | UART_MR_NBSTOP_1);
+    UART_WRITE(u, UART_MR_OFFSET, UART_MR_CHARLEN_8 | UART_MR_PAR_NONE | UART_MR_NBSTOP_1);
 
     /* 3. Configure Baud Rate */
     uint32_t cd, bdiv;
-    uart_calc_baud_divisors(console_uart.baud_rate, &cd, &bdiv);
+    uart_calc_baud_divisors(u->baud_rate, &cd, &bdiv);
     
-    UART_WRITE(UART_BAUDGEN_OFFSET, cd);   // CD
-    UART_WRITE(UART_BAUDDIV_OFFSET, bdiv); // BDIV
+    UART_WRITE(u, UART_BAUDGEN_OFFSET, cd);   // CD
+    UART_WRITE(u, UART_BAUDDIV_OFFSET, bdiv); // BDIV
 
     /* 4. Reset FIFOs */
-    UART_WRITE(UART_CR_OFFSET, UART_CR_TXRST | UART_CR_RXRST);
+    UART_WRITE(u, UART_CR_OFFSET, UART_CR_TXRST | UART_CR_RXRST);
     
     /* Spin wait for reset to complete */
     volatile int delay = 1000;
     while(delay--);
 
-    /* 5. Set Trigger Levels */
-    UART_WRITE(UART_RXWM_OFFSET, 1);  // Trigger IRQ on 1 byte received
-    UART_WRITE(UART_TXWM_OFFSET, 32); // Trigger IRQ when TX buffer is half empty
+    /* 5. Initialize Ring Buffers */
+    u->tx_buffer.head = 0;
+    u->tx_buffer.tail = 0;
+    u->rx_buffer.head = 0;
+    u->rx_buffer.tail = 0;
 
-    /* 6. Enable UART (TX and RX) */
-    UART_WRITE(UART_CR_OFFSET, UART_CR_TX_EN | UART_CR_RX_EN | UART_CR_TORST);
+    /* 6. Set Trigger Levels */
+    if (u->flags & UART_F_IRQ) {
+        UART_WRITE(u, UART_RXWM_OFFSET, UART_FIFO_DEPTH / 2); // Batch RX IRQs
+        UART_WRITE(u, UART_RXTOUT_OFFSET, 8);                 // Flush partial FIFO after ~32 bit times
+    } else {
+        UART_WRITE(u, UART_RXWM_OFFSET, 1);  // Trigger IRQ on 1 byte received
+    }
+    UART_WRITE(u, UART_TXWM_OFFSET, 32); // Trigger IRQ when TX buffer is half empty
 
-    /* 7. Initialize Ring Buffers */
-    console_uart.tx_buffer.head = 0;
-    console_uart.tx_buffer.tail = 0;
-    console_uart.rx_buffer.head = 0;
-    console_uart.rx_buffer.tail = 0;
+    /* 7. Enable UART (TX and RX) */
+    UART_WRITE(u, UART_CR_OFFSET, UART_CR_TX_EN | UART_CR_RX_EN | UART_CR_TORST);
+
+    /* 8. Enable Interrupts (Polled mode preferred for early boot console) */
+    if (u->flags & UART_F_IRQ) {
+        UART_WRITE(u, UART_ISR_OFFSET, 0xFFFFFFFF);
+        gic_register_handler(u->irq_num, uart_dev_irq_handler, u);
+        gic_enable_irq(u->irq_num);
+        UART_WRITE(u, UART_IER_OFFSET, UART_IXR_RXTRIG | UART_IXR_TOUT | UART_IXR_RXOVR);
+    }
+}
+
+void uart_init_controller(void) {
+    uart_dev_init(&console_uart);
 
-    /* 8. Enable Interrupts (Optional - Polled mode preferred for early boot) */
-    /* UART_WRITE(UART_IER_OFFSET, UART_IXR_RXOVR | UART_IXR_RXFULL | UART_IXR_TXEMPTY); */
-    
     /* Mark as active */
     uart_send_string("\n[UART] Controller Initialized Successfully.\n");
 }
+
 /*
  * ======================================================================================
  * DATA TRANSMISSION & RECEPTION
  * ======================================================================================
  */
 
-int uart_is_busy(void) {
-    return !(UART_READ(UART_SR_OFFSET) & UART_SR_TXEMPTY);
+int uart_dev_is_busy(uart_driver_t *u) {
+    return (ring_used(&u->tx_buffer) != 0) || !(UART_READ(u, UART_SR_OFFSET) & UART_SR_TXEMPTY);
 }
 
-void uart_send_byte(uint8_t c) {
-    /*
-     * Blocking Mode for Safety:
-     * Wait until the Hardware FIFO is not full (TNFUL).
-     */
-    while (UART_READ(UART_SR_OFFSET) & UART_SR_TXFULL) {
+/*
+ * uart_fifo_put
+ * Blocking Mode for Safety:
+ * Wait until the Hardware FIFO is not full (TNFUL).
+ */
+static void uart_fifo_put(uart_driver_t *u, uint8_t c) {
+    while (UART_READ(u, UART_SR_OFFSET) & UART_SR_TXFULL) {
         asm volatile("nop");
     }
+    UART_WRITE(u, UART_FIFO_OFFSET, c);
+}
+
+/*
+ * uart_tx_refill
+ * Moves bytes from the TX ring into the hardware FIFO until it is full.
+ * Returns 1 if the ring still holds data.
+ */
+static int uart_tx_refill(uart_driver_t *u) {
+    uint8_t c;
+
+    while (!(UART_READ(u, UART_SR_OFFSET) & UART_SR_TXFULL)) {
+        if (!rb_pop(&u->tx_buffer, &c)) {
+            return 0;
+        }
+        UART_WRITE(u, UART_FIFO_OFFSET, c);
+        u->tx_count++;
+    }
+    return 1;
+}
+
+void uart_dev_putc(uart_driver_t *u, uint8_t c) {
+    if (u->flags & UART_F_IRQ) {
+        uart_dev_write(u, &c, 1);
+        return;
+    }
 
     /* Write byte to FIFO */
-    UART_WRITE(UART_FIFO_OFFSET, c);
+    uart_fifo_put(u, c);
     
     /* CRLF Conversion: If \n, send \r too */
-    if (c == '\n') {
-        while (UART_READ(UART_SR_OFFSET) & UART_SR_TXFULL);
-        UART_WRITE(UART_FIFO_OFFSET, '\r');
+    if (c == '\n' && (u->flags & UART_F_CRLF)) {
+        uart_fifo_put(u, '\r');
     }
 
-    console_uart.tx_count++;
+    u->tx_count++;
 }
 
-void uart_send_string(const char *s) {
-    while (*s) {
-        uart_send_byte((uint8_t)*s++);
+/*
+ * uart_dev_write
+ * Raw byte stream (no CRLF translation). Interrupt-driven instances queue
+ * into the TX ring and return; if the ring is full the caller drains the
+ * FIFO itself rather than dropping data.
+ */
+void uart_dev_write(uart_driver_t *u, const uint8_t *buf, uint32_t len) {
+    uint32_t irq;
+
+    if (!(u->flags & UART_F_IRQ)) {
+        for (uint32_t i = 0; i < len; i++) {
+            uart_fifo_put(u, buf[i]);
+        }
+        u->tx_count += len;
+        return;
+    }
+
+    irq = irq_prio_save_and_raise(IRQ_PRIO_CEIL_KERNEL);
+    UART_WRITE(u, UART_IDR_OFFSET, UART_IXR_TXEMPTY);     // Sole TX consumer from here
+    for (uint32_t i = 0; i < len; i++) {
+        while (!rb_push(&u->tx_buffer, buf[i])) {
+            uart_tx_refill(u);
+        }
+    }
+
+    /* Prime the FIFO, then let TXEMPTY keep it fed */
+    if (uart_tx_refill(u)) {
+        UART_WRITE(u, UART_IER_OFFSET, UART_IXR_TXEMPTY);
     }
+    irq_prio_restore(irq);
 }
 
-uint8_t uart_recv_byte(void) {
+uint8_t uart_dev_getc(uart_driver_t *u) {
+    uint8_t c;
+
+    if (u->flags & UART_F_IRQ) {
+        while (!rb_pop(&u->rx_buffer, &c)) {
+            asm volatile("wfi");
+        }
+        return c;
+    }
+
     /* Wait until data is available (RXEMPTY must be 0) */
-    while (UART_READ(UART_SR_OFFSET) & UART_SR_RXEMPTY) {
+    while (UART_READ(u, UART_SR_OFFSET) & UART_SR_RXEMPTY) {
         asm volatile("nop");
     }
 
-    console_uart.rx_count++;
-    return (uint8_t)(UART_READ(UART_FIFO_OFFSET));
+    u->rx_count++;
+    return (uint8_t)(UART_READ(u, UART_FIFO_OFFSET));
 }
 
-void uart_flush(void) {
+/*
+ * uart_dev_read
+ * Non-blocking copy out of the RX ring. Returns bytes copied.
+ */
+int uart_dev_read(uart_driver_t *u, uint8_t *buf, uint32_t len) {
+    uint32_t n = 0;
+
+    while (n < len && rb_pop(&u->rx_buffer, &buf[n])) {
+        n++;
+    }
+    return (int)n;
+}
+
+void uart_dev_flush(uart_driver_t *u) {
+    uint32_t irq = irq_prio_save_and_raise(IRQ_PRIO_CEIL_KERNEL);
+
+    UART_WRITE(u, UART_IDR_OFFSET, UART_IXR_TXEMPTY);
+    while (ring_used(&u->tx_buffer)) {
+        uart_tx_refill(u);
+    }
+    irq_prio_restore(irq);
     /* Wait until all bits are shifted out */
-    while (!(UART_READ(UART_SR_OFFSET) & UART_SR_TXEMPTY));
+    while (!(UART_READ(u, UART_SR_OFFSET) & UART_SR_TXEMPTY));
+}
+
+/*
+ * uart_dev_irq_handler
+ * Drains the RX FIFO into the ring and refills the TX FIFO from the ring.
+ */
+void uart_dev_irq_handler(uint32_t irq_id, void *arg) {
+    uart_driver_t *u = (uart_driver_t *)arg;
+    uint32_t isr = UART_READ(u, UART_ISR_OFFSET) & UART_READ(u, UART_IMR_OFFSET);
+    (void)irq_id;
+
+    UART_WRITE(u, UART_ISR_OFFSET, isr); // W1C
+
+    if (isr & (UART_IXR_RXTRIG | UART_IXR_TOUT | UART_IXR_RXFULL)) {
+        while (!(UART_READ(u, UART_SR_OFFSET) & UART_SR_RXEMPTY)) {
+            uint8_t c = (uint8_t)UART_READ(u, UART_FIFO_OFFSET);
+            if (!rb_push(&u->rx_buffer, c)) {
+                u->overrun_count++;
+            }
+            u->rx_count++;
+        }
+
+        if (isr & UART_IXR_TOUT) {
+            UART_WRITE(u, UART_CR_OFFSET, UART_READ(u, UART_CR_OFFSET) | UART_CR_TORST);
+        }
+
+        if (u->rx_notify) {
+            u->rx_notify(u->rx_arg);
+        }
+    }
+
+    if (isr & (UART_IXR_RXOVR | UART_IXR_FRAMING | UART_IXR_PARITY)) {
+        u->error_count++;
+    }
+
+    if (isr & UART_IXR_TXEMPTY) {
+        if (!uart_tx_refill(u)) {
+            UART_WRITE(u, UART_IDR_OFFSET, UART_IXR_TXEMPTY);
+        }
+    }
+}
+
+/*
+ * ======================================================================================
+ * CONSOLE API (Legacy single-instance wrappers)
+ * ======================================================================================
+ */
+
+int uart_is_busy(void) {
+    return uart_dev_is_busy(&console_uart);
+}
+
+void uart_send_byte(uint8_t c) {
+    uart_dev_putc(&console_uart, c);
+}
+
+void uart_send_string(const char *s) {
+    while (*s) {
+        uart_send_byte((uint8_t)*s++);
+    }
+}
+
+uint8_t uart_recv_byte(void) {
+    return uart_dev_getc(&console_uart);
+}
+
+void uart_flush(void) {
+    uart_dev_flush(&console_uart);
 }
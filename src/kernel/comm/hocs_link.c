@@ -0,0 +1,698 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hocs_link.c
+ * Module:      HOCS Serial Command Channel Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Parsing runs in thread context (hocs_link_poll from the idle loop); the
+ * UART ISR only fills the RX ring and flags pending data. Job completions
+ * are reaped by the HOCS IRQ path and turned into JOB_RESULT frames on the
+ * next poll, in submission order.
+ * ======================================================================================
+ */
+
+#include "kernel/hocs_link.h"
+#include "drivers/hocs_telemetry.h"
+#include "kernel/timer_heavy.h"
+#include "lib/cobs.h"
+#include "lib/crc16.h"
+#include "lib/kprintf.h"
+
+#define PING_ECHO_MAX           64
+
+/*
+ * ======================================================================================
+ * RX RING VIEW
+ * ======================================================================================
+ */
+
+/*
+ * link_decode_ring
+ * COBS-decodes [start, start + enc_len) in place inside the ring.
+ * The write index trails the read index, so no byte is overwritten before
+ * it has been consumed. Returns the decoded length or -1.
+ */
+static int link_decode_ring(ring_buffer_t *rb, uint32_t start, uint32_t enc_len) {
+    uint32_t r = 0;
+    uint32_t w = 0;
+
+    while (r < enc_len) {
+        uint8_t code = ring_peek(rb, start + r++);
+
+        if (code == 0 || (r + code - 1) > enc_len) {
+            return -1;
+        }
+
+        for (uint8_t i = 1; i < code; i++) {
+            *ring_slot(rb, start + w++) = ring_peek(rb, start + r++);
+        }
+
+        if (code != 0xFF && r < enc_len) {
+            *ring_slot(rb, start + w++) = 0;
+        }
+    }
+
+    return (int)w;
+}
+
+static void link_view(ring_buffer_t *rb, uint32_t start, uint32_t len, hocs_link_view_t *v) {
+    uint32_t off = start & (rb->size - 1);
+    uint32_t first = rb->size - off;
+
+    if (first > len) {
+        first = len;
+    }
+
+    v->seg[0] = &rb->buffer[off];
+    v->seg_len[0] = first;
+    v->seg[1] = rb->buffer;
+    v->seg_len[1] = len - first;
+    v->len = len;
+}
+
+/*
+ * hocs_link_view_copy
+ * Gathers 'len' bytes at 'off' out of a (possibly wrapped) view.
+ */
+uint32_t hocs_link_view_copy(const hocs_link_view_t *v, uint32_t off, void *dst, uint32_t len) {
+    uint8_t *d = (uint8_t *)dst;
+    uint32_t n = 0;
+
+    if (off >= v->len) {
+        return 0;
+    }
+    if (len > v->len - off) {
+        len = v->len - off;
+    }
+
+    while (n < len) {
+        uint32_t pos = off + n;
+        d[n++] = (pos < v->seg_len[0]) ? v->seg[0][pos] : v->seg[1][pos - v->seg_len[0]];
+    }
+
+    return n;
+}
+
+static uint16_t link_view_crc(const hocs_link_view_t *v, uint32_t len) {
+    uint32_t first = (len < v->seg_len[0]) ? len : v->seg_len[0];
+    uint16_t crc = crc16_update(CRC16_INIT, v->seg[0], first);
+
+    return crc16_update(crc, v->seg[1], len - first);
+}
+
+/*
+ * ======================================================================================
+ * TRANSMIT
+ * ======================================================================================
+ */
+
+static void link_emit(const uint8_t *data, uint32_t len, void *arg) {
+    uart_dev_write((uart_driver_t *)arg, data, len);
+}
+
+/*
+ * hocs_link_send
+ * Frames msg + body on the fly: the streaming COBS encoder reads the body
+ * where it lives (e.g. the HOCS result buffer), so nothing is staged.
+ */
+void hocs_link_send(hocs_link_t *l, uint8_t type, uint8_t seq,
+                    const void *msg, uint32_t msg_len,
+                    const void *body, uint32_t body_len) {
+    hocs_link_hdr_t h;
+    cobs_enc_t enc;
+    uint8_t crc_le[2];
+    uint16_t crc;
+
+    h.type = type;
+    h.seq = seq;
+    h.len = (uint16_t)(msg_len + body_len);
+
+    crc = crc16_update(CRC16_INIT, &h, sizeof(h));
+    crc = crc16_update(crc, msg, msg_len);
+    crc = crc16_update(crc, body, body_len);
+    crc_le[0] = (uint8_t)crc;
+    crc_le[1] = (uint8_t)(crc >> 8);
+
+    cobs_enc_begin(&enc, link_emit, l->uart);
+    cobs_enc_feed(&enc, &h, sizeof(h));
+    cobs_enc_feed(&enc, msg, msg_len);
+    cobs_enc_feed(&enc, body, body_len);
+    cobs_enc_feed(&enc, crc_le, sizeof(crc_le));
+    cobs_enc_end(&enc);
+
+    l->frames_tx++;
+}
+
+static void link_nack(hocs_link_t *l, uint8_t seq, uint8_t reason) {
+    hocs_msg_nack_t n = { .reason = reason };
+    hocs_link_send(l, HOCS_MSG_NACK, seq, &n, sizeof(n), NULL, 0);
+}
+
+/*
+ * ======================================================================================
+ * JOB HANDLING
+ * ======================================================================================
+ */
+
+/*
+ * link_can_pin
+ * Pinning holds RX bytes away from the UART. Only pin while the ring can
+ * still take a maximum-size frame behind the held region.
+ */
+static int link_can_pin(hocs_link_t *l) {
+    ring_buffer_t *rb = &l->uart->rx_buffer;
+    uint32_t held = (l->scan + 1) - rb->tail;
+
+    return held + COBS_MAX_ENCODED(HOCS_LINK_MAX_FRAME) + 1 <= rb->size;
+}
+
+static void link_job(hocs_link_t *l, const hocs_link_view_t *v, uint8_t seq, uint32_t start) {
+    uint32_t plen = v->len - HOCS_LINK_HDR_BYTES - HOCS_LINK_CRC_BYTES;
+    uint32_t off = HOCS_LINK_HDR_BYTES + sizeof(hocs_msg_job_t);
+    hocs_link_slot_t *s = &l->slot[l->slot_head % HOCS_LINK_MAX_INFLIGHT];
+    hocs_msg_job_t m;
+    const uint8_t *src;
+    uint32_t bytes;
+
+    if (plen < sizeof(m)) {
+        l->format_errors++;
+        link_nack(l, seq, HOCS_NACK_FORMAT);
+        return;
+    }
+
+    hocs_link_view_copy(v, HOCS_LINK_HDR_BYTES, &m, sizeof(m));
+    bytes = 2U * m.dim * m.dim * sizeof(float);
+
+    /*
+     * fp32 operands and results only (the frame sizes assume it), and no
+     * checksum shortcuts: those are for in-kernel producers
+     */
+    if (m.flags & ~HOCS_LINK_JOB_FLAGS) {
+        l->format_errors++;
+        link_nack(l, seq, HOCS_NACK_FORMAT);
+        return;
+    }
+
+    if (m.dim == 0 || m.dim > HOCS_LINK_MAX_DIM || plen != sizeof(m) + bytes) {
+        l->format_errors++;
+        link_nack(l, seq, HOCS_NACK_DIM);
+        return;
+    }
+
+    /* 1. Operands: in place if contiguous + aligned, else bounce */
+    src = v->seg[0] + off;
+    if (off + bytes <= v->seg_len[0] && ((uintptr_t)src & 3) == 0 && link_can_pin(l)) {
+        s->pinned = 1;
+        l->zero_copy++;
+    } else {
+        hocs_link_view_copy(v, off, s->bounce, bytes);
+        src = (const uint8_t *)s->bounce;
+        s->pinned = 0;
+        l->bounced++;
+    }
+
+    /* 2. Queue on the accelerator */
+    s->job_id = m.job_id;
+    s->seq = seq;
+    s->ring_start = start;
+    s->job.src_addr = (uint64_t)(uintptr_t)src;
+    s->job.dst_addr = (uint64_t)(uintptr_t)s->dst;
+    s->job.matrix_dim = m.dim;
+    s->job.flags = m.flags;
+    s->job.done = NULL;
+    s->job.ctx = l;
+
+    if (hocs_submit(l->hocs, &s->job) != HOCS_OK) {
+        l->jobs_failed++;
+        link_nack(l, seq, HOCS_NACK_HW);
+        return;
+    }
+
+    l->slot_head++;
+}
+
+/*
+ * link_telemetry
+ * Exports the newest per-job latency records of the linked instance.
+ * NACK_HW if it has no telemetry attached.
+ */
+static void link_telemetry(hocs_link_t *l, const hocs_link_view_t *v, uint8_t seq, uint32_t len) {
+    static hocs_job_rec_t recs[HOCS_LINK_TELEM_MAX];
+    hocs_msg_telem_req_t req = { .max_records = HOCS_LINK_TELEM_MAX };
+    hocs_msg_telem_t m;
+    uint32_t n;
+
+    if (l->hocs->telem == NULL) {
+        link_nack(l, seq, HOCS_NACK_HW);
+        return;
+    }
+
+    if (len >= sizeof(req)) {
+        hocs_link_view_copy(v, HOCS_LINK_HDR_BYTES, &req, sizeof(req));
+    }
+    if (req.max_records == 0 || req.max_records > HOCS_LINK_TELEM_MAX) {
+        req.max_records = HOCS_LINK_TELEM_MAX;
+    }
+
+    n = hocs_telemetry_export(l->hocs, recs, req.max_records);
+    m.jobs = (uint32_t)l->hocs->telem->jobs;
+    m.count = (uint16_t)n;
+    m.rec_bytes = sizeof(hocs_job_rec_t);
+    hocs_link_send(l, HOCS_MSG_TELEMETRY_DATA, seq, &m, sizeof(m), recs, n * sizeof(hocs_job_rec_t));
+}
+
+/*
+ * link_retire
+ * Streams results of completed jobs back to the host, oldest first.
+ */
+static void link_retire(hocs_link_t *l) {
+    while (l->slot_tail != l->slot_head) {
+        hocs_link_slot_t *s = &l->slot[l->slot_tail % HOCS_LINK_MAX_INFLIGHT];
+        hocs_msg_result_t r;
+
+        if (s->job.state == HOCS_JOB_QUEUED) {
+            break;
+        }
+
+        r.job_id = s->job_id;
+        r.dim = (uint16_t)s->job.matrix_dim;
+
+        if (s->job.state == HOCS_JOB_DONE) {
+            r.status = HOCS_OK;
+            hocs_link_send(l, HOCS_MSG_JOB_RESULT, s->seq, &r, sizeof(r),
+                           s->dst, r.dim * r.dim * sizeof(float));
+            l->jobs_done++;
+        } else {
+            r.status = HOCS_ERR_HW;
+            hocs_link_send(l, HOCS_MSG_JOB_RESULT, s->seq, &r, sizeof(r), NULL, 0);
+            l->jobs_failed++;
+        }
+
+        l->slot_tail++;
+    }
+}
+
+/*
+ * link_release
+ * Returns RX bytes to the UART up to the oldest byte still needed: either
+ * a pinned operand block or the partially received frame.
+ */
+static void link_release(hocs_link_t *l) {
+    uint32_t keep = l->frame_start;
+
+    for (uint32_t i = l->slot_tail; i != l->slot_head; i++) {
+        hocs_link_slot_t *s = &l->slot[i % HOCS_LINK_MAX_INFLIGHT];
+        if (s->pinned) {
+            keep = s->ring_start;
+            break;
+        }
+    }
+
+    ring_release(&l->uart->rx_buffer, keep);
+}
+
+/*
+ * ======================================================================================
+ * RECEIVE
+ * ======================================================================================
+ */
+
+static void link_frame(hocs_link_t *l, uint32_t start, uint32_t end) {
+    ring_buffer_t *rb = &l->uart->rx_buffer;
+    hocs_link_view_t v;
+    hocs_link_hdr_t h;
+    uint8_t crc_le[2];
+    int n;
+
+    /* 1. Decode in place, validate */
+    n = link_decode_ring(rb, start, end - start);
+    if (n < HOCS_LINK_HDR_BYTES + HOCS_LINK_CRC_BYTES) {
+        l->format_errors++;
+        return;
+    }
+
+    link_view(rb, start, (uint32_t)n, &v);
+    hocs_link_view_copy(&v, 0, &h, sizeof(h));
+    hocs_link_view_copy(&v, n - HOCS_LINK_CRC_BYTES, crc_le, sizeof(crc_le));
+
+    if (link_view_crc(&v, n - HOCS_LINK_CRC_BYTES) != (uint16_t)(crc_le[0] | (crc_le[1] << 8))) {
+        l->crc_errors++;
+        link_nack(l, h.seq, HOCS_NACK_CRC);
+        return;
+    }
+
+    if (h.len != (uint32_t)n - HOCS_LINK_HDR_BYTES - HOCS_LINK_CRC_BYTES) {
+        l->format_errors++;
+        link_nack(l, h.seq, HOCS_NACK_FORMAT);
+        return;
+    }
+
+    l->frames_rx++;
+
+    /* 2. Dispatch */
+    switch (h.type) {
+        case HOCS_MSG_PING: {
+            uint8_t echo[PING_ECHO_MAX];
+            uint32_t len = hocs_link_view_copy(&v, HOCS_LINK_HDR_BYTES, echo,
+                                               (h.len < PING_ECHO_MAX) ? h.len : PING_ECHO_MAX);
+            hocs_link_send(l, HOCS_MSG_PONG, h.seq, echo, len, NULL, 0);
+            break;
+        }
+
+        case HOCS_MSG_JOB_SUBMIT:
+            link_job(l, &v, h.seq, start);
+            break;
+
+        case HOCS_MSG_TELEMETRY:
+            link_telemetry(l, &v, h.seq, h.len);
+            break;
+
+        default:
+            l->format_errors++;
+            link_nack(l, h.seq, HOCS_NACK_FORMAT);
+            break;
+    }
+}
+
+static void link_rx_notify(void *arg) {
+    ((hocs_link_t *)arg)->rx_pending = 1;
+}
+
+/*
+ * hocs_link_init
+ * Binds the protocol to an (already initialised) UART and a HOCS instance.
+ */
+void hocs_link_init(hocs_link_t *l, uart_driver_t *uart, hocs_device_t *hocs) {
+    l->uart = uart;
+    l->hocs = hocs;
+    l->scan = uart->rx_buffer.tail;
+    l->frame_start = l->scan;
+    l->resync = 0;
+    l->rx_pending = 0;
+    l->slot_head = 0;
+    l->slot_tail = 0;
+
+    l->frames_rx = 0;
+    l->frames_tx = 0;
+    l->crc_errors = 0;
+    l->format_errors = 0;
+    l->oversize = 0;
+    l->zero_copy = 0;
+    l->bounced = 0;
+    l->jobs_done = 0;
+    l->jobs_failed = 0;
+
+    uart->rx_arg = l;
+    uart->rx_notify = link_rx_notify;
+
+    kprintf("[LINK] %s <-> %s: COBS/CRC16 frames @ %u baud\n",
+            uart->name, hocs->name, uart->baud_rate);
+}
+
+/*
+ * hocs_link_poll
+ * Called from thread context. Emits finished results, then parses every
+ * complete frame currently in the RX ring.
+ */
+void hocs_link_poll(hocs_link_t *l) {
+    ring_buffer_t *rb = &l->uart->rx_buffer;
+    uint32_t head;
+
+    /* 1. Results out first: frees slots and unpins RX bytes */
+    link_retire(l);
+
+    /* 2. Scan for delimiters */
+    l->rx_pending = 0;
+    head = rb->head;
+    asm volatile("dmb ish" ::: "memory");
+
+    while (l->scan != head) {
+        if (ring_peek(rb, l->scan) != 0) {
+            l->scan++;
+            if (l->resync) {
+                l->frame_start = l->scan;
+            } else if ((l->scan - l->frame_start) > COBS_MAX_ENCODED(HOCS_LINK_MAX_FRAME)) {
+                l->oversize++;
+                l->resync = 1;
+                l->frame_start = l->scan;
+            }
+            continue;
+        }
+
+        if (!l->resync && l->scan != l->frame_start) {
+            /* Backpressure: leave the frame in the ring until a slot frees */
+            if ((l->slot_head - l->slot_tail) >= HOCS_LINK_MAX_INFLIGHT) {
+                break;
+            }
+            link_frame(l, l->frame_start, l->scan);
+        }
+
+        l->resync = 0;
+        l->scan++;
+        l->frame_start = l->scan;
+    }
+
+    /* 3. Hand consumed bytes back to the UART */
+    link_release(l);
+}
+
+void hocs_link_dump_stats(const hocs_link_t *l) {
+    kprintf("[LINK] %s: rx %u tx %u | crc %u fmt %u oversize %u | overrun %u\n",
+            l->uart->name, (unsigned int)l->frames_rx, (unsigned int)l->frames_tx,
+            (unsigned int)l->crc_errors, (unsigned int)l->format_errors,
+            (unsigned int)l->oversize, (unsigned int)l->uart->overrun_count);
+    kprintf("[LINK] jobs done %u failed %u | operands zero-copy %u bounced %u\n",
+            (unsigned int)l->jobs_done, (unsigned int)l->jobs_failed,
+            (unsigned int)l->zero_copy, (unsigned int)l->bounced);
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK: BINARY (COBS + CRC16) vs ASCII (hex text) FRAMING
+ * ======================================================================================
+ * Both encodings carry the same JOB_SUBMIT. The ASCII reference is the
+ * NMEA-style line a host script would otherwise send:
+ *
+ *   $JOB,<id>,<dim>,<flags>,XXXXXXXX,...,XXXXXXXX*CCCC\r\n
+ *
+ * floats as raw IEEE-754 hex (lossless, same information as binary).
+ * Effective throughput = operand bytes delivered per second at 10 bits per
+ * UART character, capped by the CPU cost of encode + decode.
+ */
+
+#define BENCH_ITERS             16
+#define BENCH_ASCII_MAX         (32 + (9 * 2 * HOCS_LINK_MAX_DIM * HOCS_LINK_MAX_DIM) + 8)
+
+static uint8_t bench_raw[HOCS_LINK_MAX_FRAME];
+static uint8_t bench_wire[COBS_MAX_ENCODED(HOCS_LINK_MAX_FRAME) + 1];
+static uint8_t bench_scratch[COBS_MAX_ENCODED(HOCS_LINK_MAX_FRAME) + 1];
+static char bench_ascii[BENCH_ASCII_MAX];
+static uint32_t bench_ops[2 * HOCS_LINK_MAX_DIM * HOCS_LINK_MAX_DIM];
+static uint32_t bench_out[2 * HOCS_LINK_MAX_DIM * HOCS_LINK_MAX_DIM];
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+static char *bench_put_dec(char *p, uint32_t v) {
+    char tmp[10];
+    int n = 0;
+
+    do {
+        tmp[n++] = (char)('0' + (v % 10));
+        v /= 10;
+    } while (v);
+
+    while (n) {
+        *p++ = tmp[--n];
+    }
+    return p;
+}
+
+static char *bench_put_hex(char *p, uint32_t v, int digits) {
+    for (int i = (digits - 1) * 4; i >= 0; i -= 4) {
+        *p++ = hex_digits[(v >> i) & 0xF];
+    }
+    return p;
+}
+
+static int bench_hex_val(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static uint32_t bench_binary_encode(uint32_t dim, uint32_t words) {
+    hocs_link_hdr_t *h = (hocs_link_hdr_t *)bench_raw;
+    hocs_msg_job_t *m = (hocs_msg_job_t *)(bench_raw + HOCS_LINK_HDR_BYTES);
+    uint8_t *p = bench_raw + HOCS_LINK_HDR_BYTES + sizeof(*m);
+    const uint8_t *ops = (const uint8_t *)bench_ops;
+    uint16_t crc;
+
+    h->type = HOCS_MSG_JOB_SUBMIT;
+    h->seq = 1;
+    h->len = (uint16_t)(sizeof(*m) + words * 4);
+    m->job_id = 42;
+    m->dim = (uint16_t)dim;
+    m->flags = 0;
+
+    for (uint32_t i = 0; i < words * 4; i++) {
+        p[i] = ops[i];
+    }
+    p += words * 4;
+
+    crc = crc16_ccitt(bench_raw, (uint32_t)(p - bench_raw));
+    *p++ = (uint8_t)crc;
+    *p++ = (uint8_t)(crc >> 8);
+
+    uint32_t n = cobs_encode(bench_raw, (uint32_t)(p - bench_raw), bench_wire);
+    bench_wire[n++] = 0;
+    return n;
+}
+
+static int bench_binary_decode(uint32_t wire_len) {
+    for (uint32_t i = 0; i < wire_len; i++) {
+        bench_scratch[i] = bench_wire[i];
+    }
+
+    int n = cobs_decode(bench_scratch, wire_len - 1, bench_scratch);
+    if (n < HOCS_LINK_HDR_BYTES + HOCS_LINK_CRC_BYTES) {
+        return -1;
+    }
+
+    uint16_t crc = crc16_ccitt(bench_scratch, n - HOCS_LINK_CRC_BYTES);
+    if (crc != (uint16_t)(bench_scratch[n - 2] | (bench_scratch[n - 1] << 8))) {
+        return -1;
+    }
+    return n;
+}
+
+static uint32_t bench_ascii_encode(uint32_t dim, uint32_t words) {
+    char *p = bench_ascii;
+    uint16_t crc;
+
+    *p++ = '$';
+    *p++ = 'J'; *p++ = 'O'; *p++ = 'B'; *p++ = ',';
+    p = bench_put_dec(p, 42);
+    *p++ = ',';
+    p = bench_put_dec(p, dim);
+    *p++ = ',';
+    p = bench_put_dec(p, 0);
+
+    for (uint32_t i = 0; i < words; i++) {
+        *p++ = ',';
+        p = bench_put_hex(p, bench_ops[i], 8);
+    }
+
+    crc = crc16_ccitt(bench_ascii + 1, (uint32_t)(p - bench_ascii - 1));
+    *p++ = '*';
+    p = bench_put_hex(p, crc, 4);
+    *p++ = '\r';
+    *p++ = '\n';
+
+    return (uint32_t)(p - bench_ascii);
+}
+
+static int bench_ascii_decode(uint32_t len, uint32_t words) {
+    const char *p = bench_ascii + 1;
+    const char *end = bench_ascii + len;
+    const char *star;
+    uint32_t n = 0;
+    int commas = 0;
+
+    /* 1. Skip "JOB,<id>,<dim>,<flags>" */
+    while (p < end && commas < 4) {
+        if (*p++ == ',') commas++;
+    }
+
+    /* 2. Hex words */
+    while (p < end && *p != '*' && n < words) {
+        uint32_t v = 0;
+        for (int i = 0; i < 8; i++) {
+            int d = bench_hex_val(*p++);
+            if (d < 0) return -1;
+            v = (v << 4) | (uint32_t)d;
+        }
+        bench_out[n++] = v;
+        if (*p == ',') p++;
+    }
+
+    /* 3. Checksum */
+    if (p >= end || *p != '*') return -1;
+    star = p++;
+
+    uint32_t want = 0;
+    for (int i = 0; i < 4; i++) {
+        int d = bench_hex_val(*p++);
+        if (d < 0) return -1;
+        want = (want << 4) | (uint32_t)d;
+    }
+
+    if (crc16_ccitt(bench_ascii + 1, (uint32_t)(star - bench_ascii - 1)) != want) {
+        return -1;
+    }
+    return (int)n;
+}
+
+/*
+ * hocs_link_benchmark
+ * Prints wire efficiency, CPU cost and effective operand throughput for
+ * both framings at 'baud'.
+ */
+void hocs_link_benchmark(uint32_t baud) {
+    static const uint32_t dims[] = { 4, 8, 16, 32 };
+    uint32_t char_rate = baud / 10;
+
+    kprintf("\n[LINK] Framing benchmark @ %u baud (%u chars/s)\n", baud, char_rate);
+    kprintf("  dim | payload | bin wire  eff  cpu(ns)  KB/s | ascii wire  eff  cpu(ns)  KB/s | speedup\n");
+
+    for (uint32_t d = 0; d < sizeof(dims) / sizeof(dims[0]); d++) {
+        uint32_t dim = dims[d];
+        uint32_t words = 2 * dim * dim;
+        uint32_t payload = words * 4;
+        uint32_t bin_len = 0, asc_len = 0;
+        uint64_t t0, bin_ns, asc_ns;
+        int ok = 1;
+
+        /* Operands: small values, plenty of 0x00 bytes like real weights */
+        for (uint32_t i = 0; i < words; i++) {
+            union { float f; uint32_t u; } v = { .f = (float)((int)(i % 7) - 3) * 0.25f };
+            bench_ops[i] = v.u;
+        }
+
+        /* 1. Binary: encode + decode */
+        t0 = timer_get_ticks();
+        for (int it = 0; it < BENCH_ITERS; it++) {
+            bin_len = bench_binary_encode(dim, words);
+            ok &= (bench_binary_decode(bin_len) > 0);
+        }
+        bin_ns = timer_ticks_to_ns(timer_get_ticks() - t0) / BENCH_ITERS;
+
+        /* 2. ASCII: encode + decode */
+        t0 = timer_get_ticks();
+        for (int it = 0; it < BENCH_ITERS; it++) {
+            asc_len = bench_ascii_encode(dim, words);
+            ok &= (bench_ascii_decode(asc_len, words) == (int)words);
+        }
+        asc_ns = timer_ticks_to_ns(timer_get_ticks() - t0) / BENCH_ITERS;
+
+        /* 3. Effective throughput: min(wire-limited, CPU-limited) */
+        uint64_t bin_wire_bps = (uint64_t)payload * char_rate / bin_len;
+        uint64_t asc_wire_bps = (uint64_t)payload * char_rate / asc_len;
+        uint64_t bin_cpu_bps = bin_ns ? ((uint64_t)payload * 1000000000ULL / bin_ns) : bin_wire_bps;
+        uint64_t asc_cpu_bps = asc_ns ? ((uint64_t)payload * 1000000000ULL / asc_ns) : asc_wire_bps;
+        uint64_t bin_bps = (bin_cpu_bps < bin_wire_bps) ? bin_cpu_bps : bin_wire_bps;
+        uint64_t asc_bps = (asc_cpu_bps < asc_wire_bps) ? asc_cpu_bps : asc_wire_bps;
+
+        kprintf("  %d  | %u   | %u  %u%%  %u  %u | %u  %u%%  %u  %u | %u.%ux %s\n",
+                (int)dim, payload,
+                bin_len, (unsigned int)((uint64_t)payload * 100 / bin_len),
+                (unsigned int)bin_ns, (unsigned int)(bin_bps / 1024),
+                asc_len, (unsigned int)((uint64_t)payload * 100 / asc_len),
+                (unsigned int)asc_ns, (unsigned int)(asc_bps / 1024),
+                (unsigned int)(bin_bps / asc_bps),
+                (unsigned int)((bin_bps * 10 / asc_bps) % 10),
+                ok ? "" : "(VERIFY FAILED)");
+    }
+}
@@ -0,0 +1,421 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        memguard.c
+ * Module:      Memory Bandwidth Regulator Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * PMU registers are per core, so everything that touches them runs on the
+ * regulated core itself: setup through smp_run_on(), the period reload in
+ * the SGI handler, the reclaim/throttle decision in the PMU overflow handler.
+ *
+ * Accounting per period: 'consumed' collects the events of windows that
+ * already ran out; the live window is 'window' events long and the counter
+ * was preloaded with -window, so (counter + window) is what it has counted.
+ * ======================================================================================
+ */
+
+#include "kernel/memguard.h"
+#include "kernel/timer_heavy.h"
+#include "drivers/gic_v2.h"
+#include "drivers/ttc.h"
+#include "mm/pmm.h"
+#include "lib/kprintf.h"
+
+/* PMCR_EL0 */
+#define PMCR_E                  (1 << 0)    // Enable all counters
+#define PMCR_DP                 (1 << 5)    // Disable cycle counter when prohibited
+
+#define PMU_CNT0                (1 << 0)
+
+typedef struct {
+    memguard_core_t s;
+    uint32_t consumed;              // Events of exhausted windows this period
+    uint32_t window;                // Length of the armed window
+} __attribute__((aligned(64))) mg_core_t;
+
+static mg_core_t mg[SMP_MAX_CORES];
+static ttc_timer_t mg_ttc;
+static uint32_t mg_event = PMU_EV_L2D_CACHE_REFILL;
+static uint8_t mg_mask;                     // Regulated cores
+static volatile uint32_t mg_pool;           // Reclaimable events this period
+static volatile uint32_t mg_period_seq;
+static volatile int mg_running;
+
+/*
+ * ======================================================================================
+ * PMU ACCESS (local core)
+ * ======================================================================================
+ */
+
+static inline uint32_t pmu_read(void) {
+    uint64_t v;
+    asm volatile("mrs %0, pmevcntr0_el0" : "=r" (v));
+    return (uint32_t)v;
+}
+
+/* Overflow after 'events' more counts */
+static inline void pmu_arm(uint32_t events) {
+    asm volatile("msr pmevcntr0_el0, %0" :: "r" ((uint64_t)(uint32_t)(0U - events)));
+}
+
+static inline void pmu_start(void) {
+    asm volatile("msr pmcntenset_el0, %0; isb" :: "r" ((uint64_t)PMU_CNT0));
+}
+
+static inline void pmu_halt(void) {
+    asm volatile("msr pmcntenclr_el0, %0; isb" :: "r" ((uint64_t)PMU_CNT0));
+}
+
+static inline void pmu_clear_overflow(void) {
+    asm volatile("msr pmovsclr_el0, %0; isb" :: "r" ((uint64_t)PMU_CNT0));
+}
+
+/*
+ * ======================================================================================
+ * INTERRUPT HANDLERS
+ * ======================================================================================
+ */
+
+/*
+ * mg_pool_take
+ * Takes up to one reclaim chunk from the shared pool.
+ */
+static uint32_t mg_pool_take(void) {
+    uint32_t avail = __atomic_load_n(&mg_pool, __ATOMIC_RELAXED);
+
+    while (avail) {
+        uint32_t take = (avail < MEMGUARD_RECLAIM_CHUNK) ? avail : MEMGUARD_RECLAIM_CHUNK;
+        if (__atomic_compare_exchange_n(&mg_pool, &avail, avail - take, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            return take;
+        }
+    }
+    return 0;
+}
+
+/*
+ * mg_period_isr (SGI, every regulated core)
+ * Closes the last period and arms the next one.
+ */
+static void mg_period_isr(uint32_t irq_id, void *arg) {
+    mg_core_t *m = &mg[smp_core_id()];
+    uint32_t used, predict;
+
+    (void)irq_id;
+    (void)arg;
+
+    /* 1. Account the last period */
+    pmu_halt();
+    used = m->consumed + (pmu_read() + m->window);
+    pmu_clear_overflow();
+    m->s.last_used = used;
+    m->s.periods++;
+
+    m->consumed = 0;
+    m->window = 0;
+    pmu_arm(0);
+
+    if (m->s.budget == 0) {
+        m->s.assigned = 0;
+        return; // Unregulated: counter stays off
+    }
+
+    /* 2. Predict this period's need, donate the rest */
+    predict = used + used / 4;
+    if (predict < MEMGUARD_MIN_PREDICT) predict = MEMGUARD_MIN_PREDICT;
+    if (predict > m->s.budget) predict = m->s.budget;
+
+    if (m->s.budget > predict) {
+        __atomic_fetch_add(&mg_pool, m->s.budget - predict, __ATOMIC_RELEASE);
+        m->s.donated += m->s.budget - predict;
+    }
+
+    /* 3. Arm the counter */
+    m->s.assigned = predict;
+    m->window = predict;
+    pmu_arm(predict);
+    pmu_start();
+}
+
+/*
+ * mg_overflow_isr (APU PMU SPI, routed to its own core)
+ * The window is spent: extend it from the pool, or stall until the next
+ * period. Stalling here (IRQs masked) is what stops the core's traffic.
+ */
+static void mg_overflow_isr(uint32_t irq_id, void *arg) {
+    mg_core_t *m = &mg[smp_core_id()];
+    uint32_t seq = mg_period_seq;
+    uint32_t take;
+    uint64_t t0;
+
+    (void)irq_id;
+    (void)arg;
+
+    /* 1. Close the window (the counter has wrapped past zero) */
+    pmu_clear_overflow();
+    m->consumed += m->window + pmu_read();
+
+    /* 2. Reclaim */
+    take = mg_pool_take();
+    if (take) {
+        m->window = take;
+        m->s.assigned += take;
+        m->s.reclaimed += take;
+        pmu_arm(take);
+        return;
+    }
+
+    /* 3. Throttle until core 0 starts the next period */
+    pmu_halt();
+    m->window = 0;
+    pmu_arm(0);
+
+    m->s.throttle_count++;
+    m->s.throttled = 1;
+    t0 = timer_get_timestamp_ns();
+
+    while (mg_period_seq == seq && mg_running) {
+        asm volatile("wfe");
+    }
+
+    m->s.throttle_ns += timer_get_timestamp_ns() - t0;
+    m->s.throttled = 0;
+    // The period SGI is pending and is taken right after this EOI
+}
+
+/*
+ * mg_tick (TTC1, core 0)
+ */
+static void mg_tick(uint32_t irq_id, void *arg) {
+    (void)irq_id;
+    (void)arg;
+
+    __atomic_store_n(&mg_pool, 0, __ATOMIC_RELAXED);
+    mg_period_seq++;
+    asm volatile("dsb ish; sev" ::: "memory");
+    gic_send_sgi(MEMGUARD_SGI_PERIOD, mg_mask);
+}
+
+/*
+ * ======================================================================================
+ * SETUP
+ * ======================================================================================
+ */
+
+/* Runs on the regulated core (via smp_run_on) */
+static void mg_core_setup(void *arg) {
+    uint64_t pmcr;
+
+    (void)arg;
+
+    /* 1. Counter 0 counts 'mg_event' at EL0 and EL1 */
+    pmu_halt();
+    asm volatile("msr pmevtyper0_el0, %0" :: "r" ((uint64_t)mg_event));
+    pmu_arm(0);
+    pmu_clear_overflow();
+    asm volatile("msr pmintenset_el1, %0" :: "r" ((uint64_t)PMU_CNT0));
+
+    asm volatile("mrs %0, pmcr_el0" : "=r" (pmcr));
+    pmcr = (pmcr | PMCR_E) & ~(uint64_t)PMCR_DP;
+    asm volatile("msr pmcr_el0, %0; isb" :: "r" (pmcr));
+
+    /* 2. SGIs are banked: enable the period SGI from this core */
+    gic_enable_irq(MEMGUARD_SGI_PERIOD);
+}
+
+/*
+ * memguard_init
+ * Regulates every online secondary with 'budget' events ('event' is a PMU
+ * event number, 0 selects L2 refills) per MEMGUARD_PERIOD_US. Call after
+ * smp_init().
+ */
+void memguard_init(uint32_t event, uint32_t budget) {
+    mg_event = event ? event : PMU_EV_L2D_CACHE_REFILL;
+    mg_mask = 0;
+
+    gic_register_handler(MEMGUARD_SGI_PERIOD, mg_period_isr, NULL);
+
+    for (uint32_t core = 1; core < SMP_MAX_CORES; core++) {
+        uint32_t irq = APU_PMU0_IRQ_ID + core;
+
+        if (!smp_core_online(core)) {
+            continue;
+        }
+
+        /* 1. Per-core PMU programming */
+        smp_wait(core);
+        smp_run_on(core, mg_core_setup, NULL);
+        smp_wait(core);
+
+        /* 2. Overflow interrupt goes to the core that owns the counter */
+        gic_register_handler(irq, mg_overflow_isr, NULL);
+        gic_set_priority(irq, GIC_PRIO_MEDIUM);
+        gic_set_target(irq, (uint8_t)(1U << core));
+        gic_enable_irq(irq);
+
+        mg[core].s.budget = budget;
+        mg_mask |= (uint8_t)(1U << core);
+    }
+
+    if (mg_mask == 0) {
+        kprintf("[MEMGUARD] No secondary cores online, nothing to regulate\n");
+        return;
+    }
+
+    /* 3. Period tick */
+    mg_running = 1;
+    ttc_init(&mg_ttc, ZYNQMP_TTC1_BASE, TTC1_IRQ_ID, mg_tick, NULL);
+    ttc_start_periodic(&mg_ttc, MEMGUARD_PERIOD_US);
+
+    kprintf("[MEMGUARD] cores 0x%x: %u events (0x%x) per %u us\n",
+            mg_mask, budget, mg_event, MEMGUARD_PERIOD_US);
+}
+
+/*
+ * memguard_set_budget
+ * 0 lifts regulation. Takes effect at the next period.
+ */
+void memguard_set_budget(uint32_t core, uint32_t budget) {
+    if (core == 0 || core >= SMP_MAX_CORES) {
+        return;
+    }
+    mg[core].s.budget = budget;
+}
+
+void memguard_stop(void) {
+    ttc_stop(&mg_ttc);
+    mg_running = 0;
+    for (uint32_t core = 1; core < SMP_MAX_CORES; core++) {
+        mg[core].s.budget = 0;
+    }
+    asm volatile("dsb ish; sev" ::: "memory");
+    gic_send_sgi(MEMGUARD_SGI_PERIOD, mg_mask); // Turns the counters off
+}
+
+void memguard_dump_stats(void) {
+    kprintf("[MEMGUARD] Per-core statistics:\n");
+    for (uint32_t core = 1; core < SMP_MAX_CORES; core++) {
+        const memguard_core_t *s = &mg[core].s;
+
+        if (!(mg_mask & (1U << core))) {
+            continue;
+        }
+        kprintf("  cpu%u: budget %u, last %u, periods %lu, throttled %lu (%lu us), "
+                "reclaimed %lu, donated %lu\n",
+                core, s->budget, s->last_used, s->periods, s->throttle_count,
+                s->throttle_ns / 1000, s->reclaimed, s->donated);
+    }
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK
+ * ======================================================================================
+ */
+
+#define BENCH_RT_BYTES          (2 * 1024 * 1024)   // > L2: every pass goes to DDR
+#define BENCH_HOG_BYTES         (8 * 1024 * 1024)
+#define BENCH_LINE              64
+#define BENCH_ITERS             200
+
+static volatile int bench_stop;
+
+static void bench_stream(uint64_t pa, uint32_t bytes) {
+    volatile uint64_t *p = (volatile uint64_t *)(uintptr_t)pa;
+    for (uint32_t off = 0; off < bytes / 8; off += BENCH_LINE / 8) {
+        p[off] = p[off] + 1;
+    }
+}
+
+/* Co-runner: streams its buffer until told to stop */
+static void bench_hog(void *arg) {
+    uint64_t pa = (uint64_t)(uintptr_t)arg;
+    while (!bench_stop) {
+        bench_stream(pa, BENCH_HOG_BYTES);
+    }
+}
+
+static void bench_run(const char *label, uint64_t rt, const uint64_t *hog) {
+    uint64_t sum = 0, worst = 0;
+
+    /* 1. Start the co-runners */
+    bench_stop = 0;
+    for (uint32_t core = 1; hog && core < SMP_MAX_CORES; core++) {
+        if (hog[core]) {
+            smp_run_on(core, bench_hog, (void *)(uintptr_t)hog[core]);
+        }
+    }
+    mdelay(5); // Let the hogs (and the regulator) settle
+
+    /* 2. Control-loop pass latency on core 0 */
+    for (uint32_t it = 0; it < BENCH_ITERS; it++) {
+        uint64_t t0 = timer_get_ticks();
+        bench_stream(rt, BENCH_RT_BYTES);
+        uint64_t ns = timer_ticks_to_ns(timer_get_ticks() - t0);
+        sum += ns;
+        if (ns > worst) worst = ns;
+    }
+
+    /* 3. Stop them */
+    bench_stop = 1;
+    asm volatile("dsb ish; sev" ::: "memory");
+    for (uint32_t core = 1; core < SMP_MAX_CORES; core++) {
+        smp_wait(core);
+    }
+
+    kprintf("  %s avg %lu ns, worst %lu ns\n", label, sum / BENCH_ITERS, worst);
+}
+
+/*
+ * memguard_benchmark
+ * Core 0 pass latency alone, with unregulated hogs on cores 1..3, and with
+ * the same hogs under their budgets.
+ */
+void memguard_benchmark(void) {
+    uint64_t hog[SMP_MAX_CORES] = {0};
+    uint32_t budget[SMP_MAX_CORES];
+    uint64_t rt;
+
+    kprintf("[MEMGUARD] Benchmark: %u KB control loop, %u KB hog per secondary\n",
+            BENCH_RT_BYTES / 1024, BENCH_HOG_BYTES / 1024);
+
+    rt = pmm_alloc(BENCH_RT_BYTES, PMM_F_LOW);
+    if (rt == 0) {
+        kprintf("[MEMGUARD] benchmark: out of memory\n");
+        return;
+    }
+    for (uint32_t core = 1; core < SMP_MAX_CORES; core++) {
+        budget[core] = mg[core].s.budget;
+        if (smp_core_online(core)) {
+            hog[core] = pmm_alloc(BENCH_HOG_BYTES, PMM_F_LOW);
+        }
+    }
+
+    /* 1. Alone */
+    bench_run("alone:           ", rt, NULL);
+
+    /* 2. Hogs, unregulated */
+    for (uint32_t core = 1; core < SMP_MAX_CORES; core++) {
+        memguard_set_budget(core, 0);
+    }
+    mdelay(2);
+    bench_run("hogs, no budget: ", rt, hog);
+
+    /* 3. Hogs, regulated */
+    for (uint32_t core = 1; core < SMP_MAX_CORES; core++) {
+        memguard_set_budget(core, budget[core] ? budget[core] : MEMGUARD_DEFAULT_BUDGET);
+    }
+    mdelay(2);
+    bench_run("hogs, regulated: ", rt, hog);
+
+    for (uint32_t core = 1; core < SMP_MAX_CORES; core++) {
+        memguard_set_budget(core, budget[core]);
+        if (hog[core]) pmm_free(hog[core], BENCH_HOG_BYTES);
+    }
+    pmm_free(rt, BENCH_RT_BYTES);
+
+    memguard_dump_stats();
+}
@@ -10,6 +10,8 @@
 
 #include "hocs_kernel.h"
 #include "platform/zynqmp_hardware.h"
+#include "mm/pmm.h"
+#include "kernel/irq_prio.h"
 #include "lib/kprintf.h"
 
 /* Configuration Macros */
@@ -51,6 +53,7 @@ typedef struct process {
     /* Memory Map */
     uintptr_t stack_base;       // Bottom of stack
     uintptr_t stack_ptr;        // Current SP
+    uint16_t cache_colors;      // L2 page colors owned (PMM_COLOR_ALL: shared)
     
     /* Linked List pointers */
     struct process *next;
@@ -68,6 +71,8 @@ static pcb_t *ready_queue[PRIORITY_LEVELS]; // Queue for each priority
 /* Forward Declarations */
 extern void switch_to(pcb_t *prev, pcb_t *next); // Assembly function
 void scheduler_tick(void);
+int create_process_colored(const char *name, void (*entry_point)(void), uint32_t priority,
+                           uint16_t colors);
 
 /*
  * system_init_scheduler
@@ -97,6 +102,18 @@ void system_init_scheduler(void) {
  * Allocates a new PCB, sets up the stack frame for ARM64 return.
  */
 int create_process(const char *name, void (*entry_point)(void), uint32_t priority) {
+    return create_process_colored(name, entry_point, priority, PMM_COLOR_ALL);
+}
+
+/*
+ * create_process_colored
+ * As create_process, but the task exclusively owns the L2 page colors in
+ * 'colors' (claimed from the page allocator, disjoint from every other
+ * colored task). Its stack comes from those colors; the task allocates its
+ * working set with pmm_alloc_colored(size, p->cache_colors, ...).
+ */
+int create_process_colored(const char *name, void (*entry_point)(void), uint32_t priority,
+                           uint16_t colors) {
     if (priority >= PRIORITY_LEVELS) return -1;
 
     // Find free slot
@@ -125,6 +142,28 @@ int create_process(const char *name, void (*entry_point)(void), uint32_t priorit
     // In full version, use kmalloc()
     static uint8_t stack_pool[MAX_PROCESSES][STACK_SIZE]; 
     p->stack_base = (uintptr_t)&stack_pool[pid][STACK_SIZE];
+    p->cache_colors = PMM_COLOR_ALL;
+
+    // Colored task: claim the colors, stack from the task's own colors
+    if (colors != PMM_COLOR_ALL) {
+        uint64_t stack;
+
+        if (pmm_color_claim(colors) != 0) {
+            kprintf("[ERR] Cache colors 0x%x already claimed!\n", colors);
+            p->state = PROC_UNUSED;
+            return -1;
+        }
+
+        stack = pmm_alloc_colored(STACK_SIZE, colors, PMM_F_LOW);
+        if (stack == 0) {
+            kprintf("[ERR] No free pages in colors 0x%x!\n", colors);
+            pmm_color_release(colors);
+            p->state = PROC_UNUSED;
+            return -1;
+        }
+        p->stack_base = (uintptr_t)(stack + STACK_SIZE);
+        p->cache_colors = colors;
+    }
     p->stack_ptr = p->stack_base;
 
     // Setup Context for Context Switching
@@ -133,13 +172,15 @@ int create_process(const char *name, void (*entry_point)(void), uint32_t priorit
     p->context.sp = p->stack_ptr;
     p->context.pstate = 0x3C5; // EL1h, Interrupts masked initially
 
-    // Add to Ready Queue
+    // Add to Ready Queue (every line masked: the tick, at 0x00, may reschedule)
+    uint32_t irq = irq_prio_save_and_raise(IRQ_PRIO_CEIL_ALL);
     p->state = PROC_READY;
     
     // Simple Queue Insertion (Head)
     // In full version, implement a proper linked list append
     p->next = ready_queue[priority];
     ready_queue[priority] = p;
+    irq_prio_restore(irq);
 
     kprintf("[SCHED] Created PID %d: %s\n", pid, name);
     return pid;
@@ -152,6 +193,7 @@ int create_process(const char *name, void (*entry_point)(void), uint32_t priorit
 void schedule(void) {
     pcb_t *next = NULL;
     pcb_t *prev = current_process;
+    uint32_t irq = irq_prio_save_and_raise(IRQ_PRIO_CEIL_ALL);
 
     // 1. Check for high priority tasks
     for (int prio = 0; prio < PRIORITY_LEVELS; prio++) {
@@ -170,6 +212,7 @@ void schedule(void) {
     // 2. If no task ready, run Idle
     if (next == NULL) {
         if (current_process->pid == 0 && current_process->state == PROC_RUNNING) {
+            irq_prio_restore(irq);
             return; // Already idling
         }
         next = &process_table[0]; // PID 0
@@ -185,11 +228,14 @@ void schedule(void) {
         
         next->state = PROC_RUNNING;
         current_process = next;
+        irq_prio_restore(irq);
         
         // Low-level assembly switch
         // kprintf("[SW] %s -> %s\n", prev->name, next->name);
         switch_to(prev, next);
+        return;
     }
+    irq_prio_restore(irq);
 }
 
 /*
@@ -0,0 +1,133 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        smp.c
+ * Module:      Secondary Core Bring-Up Implementation
+ * Author:      PhotonX R&D Team
+ * ======================================================================================
+ */
+
+#include "kernel/smp.h"
+#include "kernel/psci.h"
+#include "kernel/hyp.h"
+#include "kernel/timer_heavy.h"
+#include "drivers/gic_v2.h"
+#include "lib/kprintf.h"
+
+smp_boot_regs_t smp_boot_regs;
+static smp_core_t cores[SMP_MAX_CORES];
+
+/*
+ * smp_init
+ * Starts cores 1..3. Returns the number of cores online, core 0 included.
+ * Needs the MMU on (secondaries copy its registers) and PSCI.
+ */
+uint32_t smp_init(void) {
+    uint32_t count = 1;
+
+    cores[0].online = 1;
+
+    /* 1. Publish the translation regime past the caches */
+    asm volatile("mrs %0, mair_el1" : "=r" (smp_boot_regs.mair));
+    asm volatile("mrs %0, tcr_el1" : "=r" (smp_boot_regs.tcr));
+    asm volatile("mrs %0, ttbr0_el1" : "=r" (smp_boot_regs.ttbr0));
+    asm volatile("mrs %0, sctlr_el1" : "=r" (smp_boot_regs.sctlr));
+    asm volatile("dc cvac, %0; dsb sy" :: "r" (&smp_boot_regs) : "memory");
+
+    /* 2. Power up each secondary and wait for it to check in (guest cores are not ours) */
+    for (uint32_t core = 1; core < SMP_MAX_CORES; core++) {
+        int rc;
+        uint64_t start;
+
+        if (!hyp_core_is_rt(core)) {
+            continue;
+        }
+
+        rc = hyp_cpu_on(core, (uint64_t)(uintptr_t)secondary_entry, core);
+        start = timer_get_ticks();
+
+        if (rc != PSCI_RET_SUCCESS) {
+            kprintf("[SMP] cpu%u: CPU_ON failed (%d)\n", core, rc);
+            continue;
+        }
+
+        /* Spin, not WFE: IRQs masked, no event stream, a silent core would never wake us */
+        while (!cores[core].online &&
+               timer_ticks_to_us(timer_get_ticks() - start) < SMP_BOOT_TIMEOUT_US) {
+            asm volatile("yield");
+        }
+
+        if (cores[core].online) {
+            count++;
+        } else {
+            kprintf("[SMP] cpu%u: no response\n", core);
+        }
+    }
+
+    kprintf("[SMP] %u of %u cores online\n", count, SMP_MAX_CORES);
+    return count;
+}
+
+int smp_core_online(uint32_t core) {
+    return core < SMP_MAX_CORES && cores[core].online;
+}
+
+/*
+ * smp_run_on
+ * Hands 'fn(arg)' to an idle secondary. Does not wait.
+ */
+int smp_run_on(uint32_t core, smp_fn_t fn, void *arg) {
+    if (core == 0 || !smp_core_online(core) || cores[core].fn != NULL) {
+        return -1;
+    }
+
+    cores[core].arg = arg;
+    asm volatile("dmb ish" ::: "memory");
+    cores[core].fn = fn;
+    asm volatile("dsb ish; sev" ::: "memory");
+    return 0;
+}
+
+int smp_core_busy(uint32_t core) {
+    return core < SMP_MAX_CORES && cores[core].fn != NULL;
+}
+
+void smp_wait(uint32_t core) {
+    while (smp_core_busy(core)) {
+        asm volatile("wfe");
+    }
+}
+
+/*
+ * secondary_main
+ * C entry of cores 1..3 (from startup.S, MMU already on).
+ */
+void secondary_main(uint64_t core) {
+    smp_core_t *self = &cores[core];
+
+    /* 1. Banked GIC state: CPU interface, SGIs/PPIs */
+    gic_cpu_interface_init();
+
+    /* 2. Check in, take interrupts from here on */
+    self->online = 1;
+    asm volatile("dsb ish; sev" ::: "memory");
+    asm volatile("msr daifclr, #2");
+
+    /* 3. Work loop */
+    for (;;) {
+        smp_fn_t fn;
+
+        while ((fn = self->fn) == NULL) {
+            asm volatile("wfe");
+        }
+        asm volatile("dmb ish" ::: "memory");
+
+        fn(self->arg);
+        self->runs++;
+
+        asm volatile("dmb ish" ::: "memory");
+        self->fn = NULL;
+        asm volatile("dsb ish; sev" ::: "memory");
+    }
+}
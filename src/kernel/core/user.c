@@ -0,0 +1,188 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        user.c
+ * Module:      EL0 Task & System Call Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * One task at a time, on core 0. The page tables are shared with the
+ * kernel; only the user window carries EL0 permissions.
+ * ======================================================================================
+ */
+
+#include "kernel/user.h"
+#include "mm/mmu.h"
+#include "mm/pmm.h"
+#include "lib/kprintf.h"
+
+#define ESR_EC_SHIFT                26
+#define ESR_EC_SVC64                0x15
+
+/* Section bounds provided by the linker for 'user_text' */
+extern char __start_user_text[];
+extern char __stop_user_text[];
+
+static syscall_fn_t sys_table[USER_MAX_SYSCALLS];
+static user_kctx_t *user_current;
+static uint64_t user_text_base;     // Page containing __start_user_text
+static int user_ready;
+
+static uint64_t syscall_count;
+static uint64_t fault_count;
+
+/*
+ * user_map
+ * Maps [pa, pa + size) at 'va' in the user window, page by page.
+ */
+int user_map(uint64_t va, uint64_t pa, uint64_t size, int writable) {
+    uint64_t flags = writable ? VMM_USER_RW : VMM_USER_RO;
+
+    if (va < USER_MAP_VA || va + size > USER_MAP_VA + USER_MAP_SIZE) {
+        return -1;
+    }
+
+    for (uint64_t off = 0; off < size; off += PMM_PAGE_SIZE) {
+        if (vmm_map_page(va + off, pa + off, flags) != 0) {
+            user_unmap(va, off);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void user_unmap(uint64_t va, uint64_t size) {
+    for (uint64_t off = 0; off < size; off += PMM_PAGE_SIZE) {
+        vmm_unmap_page(va + off);
+    }
+}
+
+/*
+ * user_init
+ * Aliases the task code and maps the stack. Needs the MMU and pmm_init().
+ */
+int user_init(void) {
+    uint64_t end, stack;
+
+    if (user_ready) {
+        return 0;
+    }
+
+    /* 1. Code: read-only, executable at EL0 only */
+    user_text_base = (uint64_t)(uintptr_t)__start_user_text & ~(PMM_PAGE_SIZE - 1);
+    end = ((uint64_t)(uintptr_t)__stop_user_text + PMM_PAGE_SIZE - 1) & ~(PMM_PAGE_SIZE - 1);
+    for (uint64_t pa = user_text_base; pa < end; pa += PMM_PAGE_SIZE) {
+        if (vmm_map_page(USER_TEXT_VA + (pa - user_text_base), pa, VMM_USER_RX) != 0) {
+            return -1;
+        }
+    }
+
+    /* 2. Stack */
+    stack = pmm_alloc(USER_STACK_SIZE, PMM_F_LOW | PMM_F_ZERO);
+    if (stack == 0) {
+        return -1;
+    }
+    for (uint64_t off = 0; off < USER_STACK_SIZE; off += PMM_PAGE_SIZE) {
+        if (vmm_map_page(USER_STACK_TOP - USER_STACK_SIZE + off, stack + off, VMM_USER_RW) != 0) {
+            return -1;
+        }
+    }
+
+    user_ready = 1;
+    kprintf("[USER] %lu KB task code, %u KB stack\n",
+            (end - user_text_base) >> 10, USER_STACK_SIZE / 1024);
+    return 0;
+}
+
+int user_syscall_register(uint32_t nr, syscall_fn_t fn) {
+    if (nr == SYS_EXIT || nr >= USER_MAX_SYSCALLS) {
+        return -1;
+    }
+    sys_table[nr] = fn;
+    return 0;
+}
+
+/* Kernel entries through SVC since boot */
+uint64_t user_syscalls(void) {
+    return syscall_count;
+}
+
+/*
+ * user_text_va
+ * EL0 address of 'fn' (a USER_TEXT function), or 0.
+ */
+uint64_t user_text_va(const void *fn) {
+    uint64_t addr = (uint64_t)(uintptr_t)fn;
+
+    if (user_init() != 0 || addr < (uint64_t)(uintptr_t)__start_user_text ||
+        addr >= (uint64_t)(uintptr_t)__stop_user_text) {
+        return 0;
+    }
+    return USER_TEXT_VA + (addr - user_text_base);
+}
+
+/*
+ * user_run_stack
+ * Runs 'fn' (a USER_TEXT function) at EL0 with its stack pointer at 'sp'
+ * (mapped EL0 read-write by the caller) and returns its exit code, or -1
+ * if it faulted. Not reentrant.
+ */
+int64_t user_run_stack(user_fn_t fn, uint64_t arg, uint64_t sp) {
+    static user_kctx_t kctx;
+    uint64_t entry = user_text_va((const void *)fn);
+    int64_t code;
+
+    if (user_current != NULL) {
+        return -1;
+    }
+    if (entry == 0) {
+        kprintf("[USER] ERR: %p is not task code\n", (void *)fn);
+        return -1;
+    }
+
+    user_current = &kctx;
+    code = user_enter(entry, arg, sp, &kctx);
+    user_current = NULL;
+    return code;
+}
+
+/*
+ * user_run
+ * Runs 'fn' at EL0 on the task stack (see user_run_stack()).
+ */
+int64_t user_run(user_fn_t fn, uint64_t arg) {
+    return user_run_stack(fn, arg, USER_STACK_TOP);
+}
+
+/*
+ * el0_sync_c_handler
+ * Synchronous exception from the task. 'frame' is the saved X0..X30.
+ * SVCs are dispatched; anything else ends the task.
+ */
+void el0_sync_c_handler(uint64_t *frame) {
+    uint64_t esr, elr, far;
+    uint64_t nr = frame[8];
+
+    asm volatile("mrs %0, esr_el1" : "=r" (esr));
+
+    if (((esr >> ESR_EC_SHIFT) & 0x3F) == ESR_EC_SVC64) {
+        syscall_count++;
+        if (nr == SYS_EXIT) {
+            user_leave(user_current, (int64_t)frame[0]);
+        }
+        if (nr < USER_MAX_SYSCALLS && sys_table[nr] != NULL) {
+            frame[0] = (uint64_t)sys_table[nr](frame[0], frame[1], frame[2]);
+        } else {
+            frame[0] = (uint64_t)USER_ERR_NOSYS;
+        }
+        return;
+    }
+
+    asm volatile("mrs %0, elr_el1" : "=r" (elr));
+    asm volatile("mrs %0, far_el1" : "=r" (far));
+    fault_count++;
+    kprintf("[USER] Task fault: ESR 0x%x at 0x%lx (FAR 0x%lx), killed\n",
+            (uint32_t)esr, elr, far);
+    user_leave(user_current, -1);
+}
@@ -0,0 +1,200 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        bootprof.c
+ * Module:      Boot-Phase Profiler Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Output formats:
+ * - bootprof_report(): phases sorted by duration, with start offset and
+ *   share of the whole timeline, plus the time no phase accounts for.
+ * - bootprof_export_chrome(): Trace Event Format ("ph":"X" complete
+ *   events), loadable in chrome://tracing or Perfetto. Timestamps are
+ *   microseconds since the counter started (cntpct_el0 == 0).
+ * ======================================================================================
+ */
+
+#include "kernel/bootprof.h"
+#include "kernel/timer_heavy.h"
+#include "lib/kprintf.h"
+
+#define BOOTPROF_NAME_WIDTH     28
+
+static bootprof_phase_t phases[BOOTPROF_MAX_PHASES];
+static uint32_t phase_count = 0;
+static uint8_t phase_depth = 0;
+
+static inline uint64_t bootprof_now(void) {
+    uint64_t t;
+    asm volatile("isb; mrs %0, cntpct_el0" : "=r" (t) :: "memory");
+    return t;
+}
+
+static int bootprof_add(const char *name, uint64_t start, uint64_t end, uint8_t depth) {
+    if (phase_count >= BOOTPROF_MAX_PHASES) {
+        return -1;
+    }
+
+    bootprof_phase_t *p = &phases[phase_count];
+    p->name = name;
+    p->start = start;
+    p->end = end;
+    p->depth = depth;
+    return (int)phase_count++;
+}
+
+/*
+ * bootprof_init
+ * Turns the assembly stamps into phases. Call first thing in kernel_main.
+ */
+void bootprof_init(void) {
+    const uint64_t *s = boot_stamps_early;
+
+    phase_count = 0;
+    phase_depth = 0;
+
+    if (s[BOOT_STAMP_START] == 0) {
+        return; // startup.S did not stamp (e.g. loaded by a debugger at kernel_main)
+    }
+
+    bootprof_add("pre-kernel (ROM/FSBL/ATF)", 0, s[BOOT_STAMP_START], 0);
+    bootprof_add("el_drop", s[BOOT_STAMP_START], s[BOOT_STAMP_EL1], 0);
+    bootprof_add("cpu_setup", s[BOOT_STAMP_EL1], s[BOOT_STAMP_BSS], 0);
+    bootprof_add("bss_clear", s[BOOT_STAMP_BSS], s[BOOT_STAMP_KERNEL], 0);
+}
+
+/*
+ * bootprof_begin / bootprof_end
+ * Phases may nest; the depth is kept for the "untracked time" figure.
+ */
+int bootprof_begin(const char *name) {
+    int id = bootprof_add(name, bootprof_now(), 0, phase_depth);
+
+    if (id >= 0) {
+        phase_depth++;
+    }
+    return id;
+}
+
+void bootprof_end(int id) {
+    if (id < 0 || (uint32_t)id >= phase_count || phases[id].end) {
+        return;
+    }
+
+    phases[id].end = bootprof_now();
+    if (phase_depth) {
+        phase_depth--;
+    }
+}
+
+/*
+ * ======================================================================================
+ * OUTPUT
+ * ======================================================================================
+ */
+
+static uint64_t phase_end(const bootprof_phase_t *p) {
+    return p->end ? p->end : bootprof_now();
+}
+
+/* Prints ns as "<ms>.<3 digits>" or "<us>.<3 digits>" (kprintf has no padding) */
+static void bootprof_put_fixed(uint64_t value, uint32_t unit) {
+    uint32_t frac = (uint32_t)((value % unit) * 1000 / unit);
+
+    kprintf("%lu.", value / unit);
+    if (frac < 100) kprintf("0");
+    if (frac < 10) kprintf("0");
+    kprintf("%u", frac);
+}
+
+static void bootprof_put_name(const char *name) {
+    int n = 0;
+
+    while (name[n]) n++;
+    kprintf("%s", name);
+    while (n++ < BOOTPROF_NAME_WIDTH) kprintf(" ");
+}
+
+void bootprof_report(void) {
+    uint8_t order[BOOTPROF_MAX_PHASES];
+    uint64_t t_begin, t_end = 0, top_sum = 0, total;
+
+    if (phase_count == 0) {
+        return;
+    }
+
+    /* 1. Timeline span and top-level coverage */
+    t_begin = phases[0].start;
+    for (uint32_t i = 0; i < phase_count; i++) {
+        uint64_t e = phase_end(&phases[i]);
+        if (phases[i].start < t_begin) t_begin = phases[i].start;
+        if (e > t_end) t_end = e;
+        if (phases[i].depth == 0) top_sum += e - phases[i].start;
+        order[i] = (uint8_t)i;
+    }
+    total = t_end - t_begin;
+
+    /* 2. Sort by duration, longest first (insertion sort, n <= 32) */
+    for (uint32_t i = 1; i < phase_count; i++) {
+        uint8_t k = order[i];
+        uint64_t dk = phase_end(&phases[k]) - phases[k].start;
+        int j = (int)i - 1;
+        while (j >= 0 && (phase_end(&phases[order[j]]) - phases[order[j]].start) < dk) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = k;
+    }
+
+    /* 3. Table */
+    kprintf("\n[BOOT] Boot timeline: %u phases, ", phase_count);
+    bootprof_put_fixed(timer_ticks_to_ns(total), 1000000);
+    kprintf(" ms since counter start\n");
+    kprintf("  phase                       start(ms)   dur(ms)    share\n");
+
+    for (uint32_t i = 0; i < phase_count; i++) {
+        const bootprof_phase_t *p = &phases[order[i]];
+        uint64_t dur = phase_end(p) - p->start;
+        uint32_t permille = total ? (uint32_t)((dur * 1000) / total) : 0;
+
+        kprintf("  ");
+        bootprof_put_name(p->name);
+        bootprof_put_fixed(timer_ticks_to_ns(p->start - t_begin), 1000000);
+        kprintf("    ");
+        bootprof_put_fixed(timer_ticks_to_ns(dur), 1000000);
+        kprintf("    %u.%u%%%s\n", permille / 10, permille % 10, p->depth ? " (nested)" : "");
+    }
+
+    if (total > top_sum) {
+        kprintf("  ");
+        bootprof_put_name("(untracked)");
+        kprintf("            ");
+        bootprof_put_fixed(timer_ticks_to_ns(total - top_sum), 1000000);
+        kprintf("\n");
+    }
+}
+
+/*
+ * bootprof_export_chrome
+ * Dumps the timeline as Trace Event JSON between marker lines; copy the
+ * text between the markers into a .json file.
+ */
+void bootprof_export_chrome(void) {
+    kprintf("\n----- BEGIN BOOT TRACE JSON -----\n");
+    kprintf("{\"traceEvents\":[\n");
+
+    for (uint32_t i = 0; i < phase_count; i++) {
+        const bootprof_phase_t *p = &phases[i];
+
+        kprintf("{\"name\":\"%s\",\"cat\":\"boot\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":", p->name);
+        bootprof_put_fixed(timer_ticks_to_ns(p->start), 1000);
+        kprintf(",\"dur\":");
+        bootprof_put_fixed(timer_ticks_to_ns(phase_end(p) - p->start), 1000);
+        kprintf("}%s\n", (i + 1 < phase_count) ? "," : "");
+    }
+
+    kprintf("],\"displayTimeUnit\":\"ms\"}\n");
+    kprintf("----- END BOOT TRACE JSON -----\n");
+}
@@ -0,0 +1,246 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        pstore.c
+ * Module:      Crash-Persistent Log & Trace Store Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Boot sequence:
+ * 1. Scan both banks; the valid one with the highest boot_seq is the
+ *    previous run.
+ * 2. Claim the other bank, write its header (magic last), attach the
+ *    kprintf and trace sinks.
+ * 3. Once the console is up, pstore_dump_previous() prints the tail of the
+ *    previous run's log and traces.
+ * ======================================================================================
+ */
+
+#include "kernel/pstore.h"
+#include "kernel/irq_prio.h"
+#include "drivers/uart_ps.h"
+#include "lib/kprintf.h"
+
+/* Helper Macros for Memory Mapped I/O */
+#define MMIO_READ32(addr)       (*(volatile uint32_t *)(addr))
+#define MMIO_WRITE32(addr, val) (*(volatile uint32_t *)(addr) = (val))
+
+pstore_bank_t *pstore_live = NULL;
+static pstore_bank_t *pstore_prev = NULL;
+
+static uint8_t pstore_log_spin;         // Normal WB memory: the bank is Write-Through
+
+static pstore_bank_t *pstore_bank(uint32_t idx) {
+    return (pstore_bank_t *)(ZYNQMP_PSTORE_BASE + (uintptr_t)idx * PSTORE_BANK_SIZE);
+}
+
+/*
+ * pstore_csum
+ * FNV-1a over the static header fields (version .. timer_hz).
+ */
+static uint32_t pstore_csum(const pstore_hdr_t *h) {
+    const uint8_t *p = (const uint8_t *)&h->version;
+    const uint8_t *end = (const uint8_t *)&h->layout_csum;
+    uint32_t c = 0x811C9DC5;
+
+    while (p < end) {
+        c = (c ^ *p++) * 0x01000193;
+    }
+    return c;
+}
+
+static int pstore_valid(const pstore_hdr_t *h) {
+    if (h->magic != PSTORE_MAGIC || h->version != PSTORE_VERSION) return 0;
+    if (h->layout_csum != pstore_csum(h)) return 0;
+    if (h->bank_size != PSTORE_BANK_SIZE || h->log_size != PSTORE_LOG_SIZE) return 0;
+    if (h->trace_cpus != TRACE_MAX_CPUS || h->trace_entries != TRACE_RING_ENTRIES) return 0;
+    if (h->state != PSTORE_STATE_RUNNING && h->state != PSTORE_STATE_PANIC) return 0;
+    return 1;
+}
+
+/*
+ * pstore_init
+ * Must run before the first kprintf so the whole boot log is captured.
+ */
+void pstore_init(void) {
+    uint32_t reason = MMIO_READ32(CRL_APB_RESET_REASON);
+    uint32_t prev_idx = PSTORE_BANKS;
+    uint32_t live_idx = 0;
+    uint32_t seq = 0;
+    uint64_t freq, now;
+
+    /* 1. Find the previous run (DDR content is garbage after power-on) */
+    if (!(reason & (RESET_REASON_EXT_POR | RESET_REASON_INT_POR))) {
+        for (uint32_t i = 0; i < PSTORE_BANKS; i++) {
+            pstore_hdr_t *h = &pstore_bank(i)->hdr;
+            if (pstore_valid(h) && (prev_idx == PSTORE_BANKS || h->boot_seq > seq)) {
+                prev_idx = i;
+                seq = h->boot_seq;
+            }
+        }
+    }
+
+    if (prev_idx < PSTORE_BANKS) {
+        pstore_prev = pstore_bank(prev_idx);
+        live_idx = (prev_idx + 1) % PSTORE_BANKS;
+    }
+
+    /* 2. Claim the live bank: invalidate, fill, then publish the magic */
+    pstore_bank_t *b = pstore_bank(live_idx);
+    pstore_hdr_t *h = &b->hdr;
+
+    asm volatile("mrs %0, cntfrq_el0" : "=r" (freq));
+    asm volatile("mrs %0, cntpct_el0" : "=r" (now));
+
+    h->magic = 0;
+    asm volatile("dmb ish" ::: "memory");
+
+    h->version = PSTORE_VERSION;
+    h->boot_seq = seq + 1;
+    h->reset_reason = reason;
+    h->bank_size = PSTORE_BANK_SIZE;
+    h->log_size = PSTORE_LOG_SIZE;
+    h->trace_cpus = TRACE_MAX_CPUS;
+    h->trace_entries = TRACE_RING_ENTRIES;
+    h->boot_ts = now;
+    h->timer_hz = freq;
+    h->layout_csum = pstore_csum(h);
+    h->state = PSTORE_STATE_RUNNING;
+    h->log_head = 0;
+    h->panic_msg[0] = '\0';
+
+    for (uint32_t i = 0; i < TRACE_MAX_CPUS; i++) {
+        b->trace[i].head = 0;
+    }
+
+    asm volatile("dmb ish" ::: "memory");
+    h->magic = PSTORE_MAGIC;
+
+    /* 3. Reset reason is sticky: clear it so the next boot sees only its own */
+    MMIO_WRITE32(CRL_APB_RESET_REASON, reason);
+
+    /* 4. Go live */
+    pstore_live = b;
+    for (uint32_t i = 0; i < TRACE_MAX_CPUS; i++) {
+        trace_attach(i, &b->trace[i]);
+    }
+
+    trace_emit(TRACE_EV_BOOT, h->boot_seq, reason, 0);
+}
+
+int pstore_has_previous(void) {
+    return pstore_prev != NULL;
+}
+
+static const char *pstore_reason_str(uint32_t r) {
+    if (r & RESET_REASON_SRST)      return "software system reset";
+    if (r & RESET_REASON_SOFT)      return "soft reset";
+    if (r & RESET_REASON_DEBUG_SYS) return "debugger system reset";
+    if (r & RESET_REASON_PSONLY)    return "PS-only reset";
+    if (r & RESET_REASON_PMU_SYS)   return "PMU (watchdog/error) reset";
+    return "unknown";
+}
+
+/*
+ * pstore_dump_previous
+ * Prints what the previous run left behind. The old log tail goes straight
+ * to the UART (not through kprintf) so it is not duplicated into this
+ * boot's log.
+ */
+void pstore_dump_previous(void) {
+    if (pstore_prev == NULL) {
+        kprintf("[PSTORE] No previous run recorded (cold boot).\n");
+        return;
+    }
+
+    pstore_hdr_t *h = &pstore_prev->hdr;
+    uint64_t head = h->log_head;
+    uint64_t n = head;
+
+    kprintf("[PSTORE] Previous run: boot #%u, ended by %s, state %s\n",
+            h->boot_seq, pstore_reason_str(pstore_live->hdr.reset_reason),
+            (h->state == PSTORE_STATE_PANIC) ? "PANIC" : "RUNNING (hang/reset)");
+
+    if (h->state == PSTORE_STATE_PANIC) {
+        h->panic_msg[PSTORE_PANIC_MSG_LEN - 1] = '\0';
+        kprintf("[PSTORE] Panic reason: %s\n", h->panic_msg);
+    }
+
+    /* 1. Log tail */
+    if (n > PSTORE_DUMP_LOG_TAIL) n = PSTORE_DUMP_LOG_TAIL;
+    if (n > PSTORE_LOG_SIZE) n = PSTORE_LOG_SIZE;
+
+    kprintf("[PSTORE] ---- last %u of %u log bytes ----\n", (unsigned int)n, (unsigned int)head);
+    for (uint64_t i = head - n; i < head; i++) {
+        char c = pstore_prev->log[i & (PSTORE_LOG_SIZE - 1)];
+        if ((c < 0x20 || c > 0x7E) && c != '\n' && c != '\r' && c != '\t' && c != '\033') {
+            c = '.';
+        }
+        uart_send_byte((uint8_t)c);
+    }
+    kprintf("\n[PSTORE] ---- end of previous log ----\n");
+
+    /* 2. Trace tails */
+    for (uint32_t cpu = 0; cpu < TRACE_MAX_CPUS; cpu++) {
+        trace_ring_t *r = &pstore_prev->trace[cpu];
+        if (r->head == 0) {
+            continue;
+        }
+        kprintf("[PSTORE] cpu%u: last %u of %u trace events\n", cpu,
+                (r->head < PSTORE_DUMP_TRACE_TAIL) ? (unsigned int)r->head : PSTORE_DUMP_TRACE_TAIL,
+                (unsigned int)r->head);
+        trace_dump_ring(r, PSTORE_DUMP_TRACE_TAIL, h->boot_ts, h->timer_hz);
+    }
+}
+
+/*
+ * pstore_log_putc
+ * kprintf's persistent sink: one store and one index update. Every core
+ * logs, and so do handlers of every priority, hence all lines masked and
+ * the spinlock for the length of those two stores.
+ */
+void pstore_log_putc(char c) {
+    pstore_bank_t *b = pstore_live;
+    uint32_t irq;
+    uint64_t h;
+
+    if (b == NULL) {
+        return;
+    }
+
+    irq = irq_prio_save_and_raise(IRQ_PRIO_CEIL_ALL);
+    while (__atomic_test_and_set(&pstore_log_spin, __ATOMIC_ACQUIRE)) {
+        asm volatile("yield");
+    }
+
+    h = b->hdr.log_head;
+    b->log[h & (PSTORE_LOG_SIZE - 1)] = c;
+    b->hdr.log_head = h + 1;
+
+    __atomic_clear(&pstore_log_spin, __ATOMIC_RELEASE);
+    irq_prio_restore(irq);
+}
+
+/*
+ * pstore_panic
+ * Marks the live bank before anything touches the (slow, maybe broken) UART.
+ */
+void pstore_panic(const char *reason) {
+    pstore_bank_t *b = pstore_live;
+    uint32_t i = 0;
+
+    if (b == NULL) {
+        return;
+    }
+
+    while (reason && reason[i] && i < PSTORE_PANIC_MSG_LEN - 1) {
+        b->hdr.panic_msg[i] = reason[i];
+        i++;
+    }
+    b->hdr.panic_msg[i] = '\0';
+    b->hdr.state = PSTORE_STATE_PANIC;
+
+    trace_emit(TRACE_EV_PANIC, 0, 0, 0);
+    asm volatile("dsb sy" ::: "memory");
+}
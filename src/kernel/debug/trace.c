@@ -0,0 +1,64 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        trace.c
+ * Module:      Binary Event Trace (Ring Management & Decode)
+ * ======================================================================================
+ */
+
+#include "kernel/trace.h"
+#include "lib/kprintf.h"
+
+trace_ring_t *trace_rings[TRACE_MAX_CPUS];
+
+/*
+ * trace_attach
+ * Points a core's trace_emit() at 'ring'. The ring contents are left alone
+ * (the caller decides whether it is fresh or being resumed).
+ */
+void trace_attach(uint32_t cpu, trace_ring_t *ring) {
+    if (cpu >= TRACE_MAX_CPUS) {
+        return;
+    }
+
+    asm volatile("dmb ish" ::: "memory");
+    trace_rings[cpu] = ring;
+}
+
+const char *trace_event_name(uint16_t id) {
+    switch (id) {
+        case TRACE_EV_BOOT:         return "boot";
+        case TRACE_EV_PANIC:        return "panic";
+        case TRACE_EV_SYNC_ABORT:   return "sync_abort";
+        case TRACE_EV_HOCS_SUBMIT:  return "hocs_submit";
+        case TRACE_EV_HOCS_DONE:    return "hocs_done";
+        case TRACE_EV_HOCS_PHASES:  return "hocs_phases";
+        case TRACE_EV_HOCS_DELIVER: return "hocs_deliver";
+        case TRACE_EV_HOCS_STATS:   return "hocs_stats";
+        default:                    return "?";
+    }
+}
+
+/*
+ * trace_dump_ring
+ * Prints the newest 'last_n' records, oldest first. Timestamps are shown
+ * in microseconds relative to 'ts_base'.
+ */
+void trace_dump_ring(const trace_ring_t *ring, uint32_t last_n, uint64_t ts_base, uint64_t timer_hz) {
+    uint64_t head = ring->head;
+    uint64_t n = (head < last_n) ? head : last_n;
+
+    if (n > TRACE_RING_ENTRIES) {
+        n = TRACE_RING_ENTRIES;
+    }
+
+    for (uint64_t i = head - n; i < head; i++) {
+        const trace_rec_t *e = &ring->rec[i & (TRACE_RING_ENTRIES - 1)];
+        uint64_t us = (timer_hz && e->ts >= ts_base) ? ((e->ts - ts_base) * 1000000ULL) / timer_hz : 0;
+
+        kprintf("  [%u us] cpu%u %s (0x%x) a0=0x%x a1=%p a2=%p\n",
+                (unsigned int)us, (unsigned int)e->cpu, trace_event_name(e->id),
+                (unsigned int)e->id, e->arg0, (void *)(uintptr_t)e->arg1, (void *)(uintptr_t)e->arg2);
+    }
+}
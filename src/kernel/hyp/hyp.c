@@ -0,0 +1,601 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hyp.c
+ * Module:      Partitioning Hypervisor - Setup and Control (EL1)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Runs in PhotonX at EL1. hyp_init() builds the EL2 identity map and both
+ * stage 2 tables, turns the EL2 MMU on and moves core 0 into the RT
+ * partition; the rest of the kernel then only sees a few cores less.
+ * Guest start/stop goes through PSCI at EL2 and the HYP_SGI_STOP line.
+ * ======================================================================================
+ */
+
+#include "kernel/hyp.h"
+#include "kernel/psci.h"
+#include "kernel/smp.h"
+#include "kernel/cpuidle.h"
+#include "kernel/timer_heavy.h"
+#include "drivers/gic_v2.h"
+#include "mm/pmm.h"
+#include "mm/mmu_defs.h"
+#include "lib/kprintf.h"
+
+#define GEM3_BASE               0xFF0E0000UL
+#define GEM3_IRQ                95
+#define GEM3_PM_NODE            32          // EEMI NODE_ETH_3
+#define GEM3_PM_RESET           1032        // EEMI RESET_GEM3
+#define HYP_STOP_TIMEOUT_US     100000
+#define HYP_RT_MAX_HOLES        (HYP_MAX_REGIONS + 1)
+
+#define VMID_RT                 1UL
+#define VMID_GUEST              2UL
+#define VTTBR_VMID_SHIFT        48
+
+#define EL2_ATTR_NORMAL         (PT_BLOCK_DESC | PT_AF | PT_SH_INNER | PT_ACCESS_FULL | (1 << 2))
+#define EL2_ATTR_DEVICE         (PT_BLOCK_DESC | PT_AF | PT_ACCESS_FULL | PT_UXN | (0 << 2))
+
+hyp_state_t hyp;
+static uint64_t hyp_el2_l1[512] __attribute__((aligned(4096)));
+static cpuidle_latency_req_t hyp_idle_qos;
+
+/* =========================================================================
+ * GUEST CONFIGURATIONS
+ * ========================================================================= */
+
+/* Linux on cores 2-3 with the second Ethernet MAC (kernel at +2MB, DTB at base) */
+const hyp_partition_t hyp_guest_linux = {
+    .name = "linux",
+    .core_mask = 0xC,
+    .flags = 0,
+    .entry = HYP_GUEST_ENTRY,
+    .boot_arg = HYP_GUEST_DTB,
+    .regions = {
+        { HYP_GUEST_RAM_BASE, HYP_GUEST_RAM_SIZE, HYP_MEM_RAM },
+        { GEM3_BASE, 0x1000, HYP_MEM_IO },
+    },
+    .num_regions = 2,
+    .irqs = { GEM3_IRQ },
+    .num_irqs = 1,
+    .pm_nodes = { GEM3_PM_NODE },
+    .num_pm_nodes = 1,
+    .pm_resets = { GEM3_PM_RESET },
+    .num_pm_resets = 1,
+};
+
+/* Built-in noisy neighbour (hyp_entry.S): no image needed */
+const hyp_partition_t hyp_guest_noise = {
+    .name = "noise",
+    .core_mask = 0xC,
+    .flags = HYP_PART_MMU_OFF,
+    .entry = (uint64_t)(uintptr_t)hyp_noise_guest,
+    .boot_arg = HYP_GUEST_RAM_BASE,
+    .regions = {
+        { HYP_GUEST_RAM_BASE, HYP_GUEST_RAM_SIZE, HYP_MEM_R | HYP_MEM_W },
+        { (uint64_t)(uintptr_t)hyp_noise_guest, PMM_PAGE_SIZE, HYP_MEM_R | HYP_MEM_X },
+    },
+    .num_regions = 2,
+    .num_irqs = 0,
+    .num_pm_nodes = 0,
+    .num_pm_resets = 0,
+};
+
+/* =========================================================================
+ * STAGE 2 TABLES
+ * ========================================================================= */
+
+/* Next-level table behind 'desc', allocated on first use */
+static uint64_t *s2_table(uint64_t *desc) {
+    uint64_t pa;
+
+    if ((*desc & 0x3) == PT_TABLE_DESC) {
+        return (uint64_t *)(uintptr_t)(*desc & PT_ADDR_MASK);
+    }
+
+    pa = pmm_alloc(PMM_PAGE_SIZE, PMM_F_LOW | PMM_F_ZERO);
+    if (pa == 0) {
+        return NULL;
+    }
+    asm volatile("dsb ishst" ::: "memory");
+    *desc = pa | PT_TABLE_DESC;
+    return (uint64_t *)(uintptr_t)pa;
+}
+
+static uint64_t s2_attr(uint32_t flags) {
+    uint64_t attr = S2_AF | ((flags & HYP_MEM_W) ? S2_AP_RW : S2_AP_RO);
+
+    if (flags & HYP_MEM_DEVICE) {
+        attr |= S2_MEMATTR_DEVICE;
+    } else {
+        attr |= S2_MEMATTR_NORMAL | S2_SH_INNER;
+    }
+    if (!(flags & HYP_MEM_X)) {
+        attr |= S2_XN;
+    }
+    return attr;
+}
+
+/*
+ * s2_map
+ * Maps [ipa, ipa + size) to 'pa' with the largest blocks alignment allows.
+ * Ranges must not overlap earlier ones (blocks are never split).
+ */
+static int s2_map(uint64_t *root, uint64_t ipa, uint64_t pa, uint64_t size, uint64_t attr) {
+    while (size > 0) {
+        uint64_t *l2, *l3;
+        uint64_t *l1e = &root[(ipa >> 30) & 0x3F];
+
+        /* 1. 1GB block */
+        if (((ipa | pa) & (PMM_GIGA_SIZE - 1)) == 0 && size >= PMM_GIGA_SIZE) {
+            *l1e = pa | attr | PT_BLOCK_DESC;
+            ipa += PMM_GIGA_SIZE;
+            pa += PMM_GIGA_SIZE;
+            size -= PMM_GIGA_SIZE;
+            continue;
+        }
+
+        /* 2. 2MB block */
+        l2 = s2_table(l1e);
+        if (l2 == NULL) {
+            return -1;
+        }
+        if (((ipa | pa) & (PMM_HUGE_SIZE - 1)) == 0 && size >= PMM_HUGE_SIZE) {
+            l2[(ipa >> 21) & 0x1FF] = pa | attr | PT_BLOCK_DESC;
+            ipa += PMM_HUGE_SIZE;
+            pa += PMM_HUGE_SIZE;
+            size -= PMM_HUGE_SIZE;
+            continue;
+        }
+
+        /* 3. 4KB page */
+        l3 = s2_table(&l2[(ipa >> 21) & 0x1FF]);
+        if (l3 == NULL) {
+            return -1;
+        }
+        l3[(ipa >> 12) & 0x1FF] = pa | attr | PT_PAGE_DESC;
+        ipa += PMM_PAGE_SIZE;
+        pa += PMM_PAGE_SIZE;
+        size -= PMM_PAGE_SIZE;
+    }
+    return 0;
+}
+
+/* Identity map of [lo, hi) minus the sorted, disjoint 'holes' */
+static int s2_map_except(uint64_t *root, uint64_t lo, uint64_t hi,
+                         const hyp_region_t *holes, uint32_t n, uint64_t attr) {
+    uint64_t at = lo;
+
+    for (uint32_t i = 0; i < n && at < hi; i++) {
+        uint64_t end = holes[i].base + holes[i].size;
+
+        if (end <= at || holes[i].base >= hi) {
+            continue;
+        }
+        if (holes[i].base > at && s2_map(root, at, at, holes[i].base - at, attr) != 0) {
+            return -1;
+        }
+        at = end;
+    }
+    if (at < hi) {
+        return s2_map(root, at, at, hi - at, attr);
+    }
+    return 0;
+}
+
+/*
+ * hyp_build_rt
+ * RT stage 2: low 4GB and the high DDR, identity, without the guest's
+ * writable regions and the GIC virtualization pages. Stage 1 keeps
+ * choosing the memory type (Normal WB here never upgrades it).
+ */
+static uint64_t *hyp_build_rt(const hyp_partition_t *g) {
+    hyp_region_t holes[HYP_RT_MAX_HOLES];
+    const pmm_region_t *r;
+    uint32_t n = 0, nr;
+    uint64_t attr = s2_attr(HYP_MEM_RAM);
+    uint64_t *root;
+    uint64_t pa;
+
+    /* 1. Holes, sorted by base */
+    holes[n].base = GIC_HYP_BASE;
+    holes[n].size = GIC_VCPU_BASE + GIC_CPU_SIZE - GIC_HYP_BASE;
+    holes[n++].flags = 0;
+    for (uint32_t i = 0; i < g->num_regions; i++) {
+        if (g->regions[i].flags & HYP_MEM_W) {
+            holes[n++] = g->regions[i];
+        }
+    }
+    for (uint32_t i = 1; i < n; i++) {
+        hyp_region_t h = holes[i];
+        uint32_t j = i;
+
+        while (j > 0 && holes[j - 1].base > h.base) {
+            holes[j] = holes[j - 1];
+            j--;
+        }
+        holes[j] = h;
+    }
+
+    /* 2. Tables */
+    pa = pmm_alloc(PMM_PAGE_SIZE, PMM_F_LOW | PMM_F_ZERO);
+    if (pa == 0) {
+        return NULL;
+    }
+    root = (uint64_t *)(uintptr_t)pa;
+
+    if (s2_map_except(root, 0, 1UL << 32, holes, n, attr) != 0) {
+        return NULL;
+    }
+    nr = pmm_regions(&r);
+    for (uint32_t i = 0; i < nr; i++) {
+        uint64_t lo = r[i].base & ~(PMM_HUGE_SIZE - 1);
+        uint64_t hi = (r[i].base + r[i].size + PMM_HUGE_SIZE - 1) & ~(PMM_HUGE_SIZE - 1);
+
+        if (lo < (1UL << 32) || hi > HYP_IPA_SIZE) {
+            continue;
+        }
+        if (s2_map_except(root, lo, hi, holes, n, attr) != 0) {
+            return NULL;
+        }
+    }
+    return root;
+}
+
+/*
+ * hyp_build_guest
+ * Guest stage 2: its regions at IPA == PA, plus the GICV pages where the
+ * guest expects GICC. The distributor stays unmapped (trapped).
+ */
+static uint64_t *hyp_build_guest(const hyp_partition_t *g) {
+    uint64_t pa = pmm_alloc(PMM_PAGE_SIZE, PMM_F_LOW | PMM_F_ZERO);
+    uint64_t *root = (uint64_t *)(uintptr_t)pa;
+
+    if (pa == 0) {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < g->num_regions; i++) {
+        const hyp_region_t *rg = &g->regions[i];
+
+        if (s2_map(root, rg->base, rg->base, rg->size, s2_attr(rg->flags)) != 0) {
+            return NULL;
+        }
+    }
+    if (s2_map(root, GIC_CPU_BASE, GIC_VCPU_BASE, GIC_CPU_SIZE, s2_attr(HYP_MEM_IO)) != 0) {
+        return NULL;
+    }
+    return root;
+}
+
+/* =========================================================================
+ * EL2 TRANSLATION REGIME
+ * ========================================================================= */
+
+/*
+ * hyp_el2_enable
+ * Identity map for EL2 (the EL1 one marks kernel memory UXN, which EL2
+ * reads as XN), published past the caches for cores coming up with the
+ * EL2 MMU off, then switched on for core 0.
+ */
+static int hyp_el2_enable(void) {
+    register uint64_t x0 asm("x0") = HYP_HVC_ENABLE;
+    uint64_t mair;
+
+    /* 1. 1GB blocks: low DDR, MMIO, high DDR */
+    for (uint32_t i = 0; i < 64; i++) {
+        uint64_t pa = (uint64_t)i << 30;
+
+        if (i < 2 || i >= 32) {
+            hyp_el2_l1[i] = pa | EL2_ATTR_NORMAL;
+        } else if (i < 4) {
+            hyp_el2_l1[i] = pa | EL2_ATTR_DEVICE;
+        }
+    }
+
+    /* 2. Registers, same MAIR layout as EL1 */
+    asm volatile("mrs %0, mair_el1" : "=r" (mair));
+    hyp_el2_regs.mair = mair;
+    hyp_el2_regs.tcr = TCR_EL2_VALUE;
+    hyp_el2_regs.ttbr0 = (uint64_t)(uintptr_t)hyp_el2_l1;
+    hyp_el2_regs.sctlr = SCTLR_EL2_VALUE;
+    hyp_el2_regs.ready = 1;
+
+    for (uint32_t off = 0; off < sizeof(hyp_el2_l1); off += 64) {
+        asm volatile("dc cvac, %0" :: "r" ((uintptr_t)hyp_el2_l1 + off) : "memory");
+    }
+    asm volatile("dc cvac, %0; dsb sy" :: "r" (&hyp_el2_regs) : "memory");
+
+    /* 3. Core 0 */
+    asm volatile("hvc #0" : "+r" (x0) :: "x1", "x2", "x3", "memory");
+    return (x0 == 0) ? 0 : -1;
+}
+
+/*
+ * hyp_call
+ * Runs fn(arg) at EL2 on this core (RT partition only).
+ */
+uint64_t hyp_call(hyp_fn_t fn, uint64_t arg) {
+    register uint64_t x0 asm("x0") = HYP_HVC_CALL;
+    register uint64_t x1 asm("x1") = (uint64_t)(uintptr_t)fn;
+    register uint64_t x2 asm("x2") = arg;
+
+    asm volatile("hvc #0" : "+r" (x0), "+r" (x1), "+r" (x2) :: "memory");
+    return x0;
+}
+
+/* =========================================================================
+ * INITIALIZATION
+ * ========================================================================= */
+
+/* Carves the guest's RAM out of the PMM; fails if any page is in use */
+static int hyp_reserve_ram(const hyp_partition_t *g) {
+    for (uint32_t i = 0; i < g->num_regions; i++) {
+        const hyp_region_t *rg = &g->regions[i];
+        uint64_t before;
+
+        if ((rg->flags & (HYP_MEM_W | HYP_MEM_DEVICE)) != HYP_MEM_W) {
+            continue;                               // Devices and shared read-only code
+        }
+
+        before = pmm_zone(PMM_ZONE_LOW)->reserved + pmm_zone(PMM_ZONE_HIGH)->reserved;
+        pmm_reserve(rg->base, rg->size);
+        if (pmm_zone(PMM_ZONE_LOW)->reserved + pmm_zone(PMM_ZONE_HIGH)->reserved - before != rg->size) {
+            kprintf("[HYP] ERR: Guest RAM 0x%lx+0x%lx is not free DDR\n", rg->base, rg->size);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * hyp_init
+ * Partitions the machine: the cores in guest->core_mask become the guest's,
+ * core 0 and the remaining cores stay with PhotonX. Must run on core 0
+ * before smp_init(), with the MMU and the GIC up. The guest is not
+ * started (hyp_guest_start()).
+ */
+int hyp_init(const hyp_partition_t *guest) {
+    uint64_t *rt_root, *guest_root;
+    uint32_t vcpu = 0;
+
+    /* 1. Preconditions */
+    if (!hyp_boot_el2) {
+        kprintf("[HYP] ERR: Not entered at EL2, partitioning unavailable\n");
+        return -1;
+    }
+    if ((guest->core_mask & 1) || guest->core_mask == 0 ||
+        (guest->core_mask >> HYP_MAX_CORES) != 0) {
+        kprintf("[HYP] ERR: Bad guest core mask 0x%x\n", guest->core_mask);
+        return -1;
+    }
+    for (uint32_t core = 1; core < HYP_MAX_CORES; core++) {
+        if (smp_core_online(core)) {
+            kprintf("[HYP] ERR: cpu%u already online (call before smp_init)\n", core);
+            return -1;
+        }
+    }
+    for (uint32_t i = 0; i < guest->num_regions; i++) {
+        if ((guest->regions[i].base | guest->regions[i].size) & (PMM_PAGE_SIZE - 1)) {
+            kprintf("[HYP] ERR: Region %u not page aligned\n", i);
+            return -1;
+        }
+    }
+    for (uint32_t i = 0; i < guest->num_irqs; i++) {
+        if (guest->irqs[i] < 32 || guest->irqs[i] >= MAX_IRQS) {
+            kprintf("[HYP] ERR: IRQ %u is not an SPI\n", guest->irqs[i]);
+            return -1;
+        }
+    }
+
+    /* 2. Guest RAM leaves the kernel's allocators */
+    if (hyp_reserve_ram(guest) != 0) {
+        return -1;
+    }
+
+    /* 3. EL2 MMU */
+    if (hyp_el2_enable() != 0) {
+        kprintf("[HYP] ERR: EL2 MMU enable refused\n");
+        return -1;
+    }
+
+    /* 4. Stage 2 and per-core state */
+    rt_root = hyp_build_rt(guest);
+    guest_root = hyp_build_guest(guest);
+    if (rt_root == NULL || guest_root == NULL) {
+        kprintf("[HYP] ERR: Out of memory for stage 2 tables\n");
+        return -1;
+    }
+
+    hyp.guest = guest;
+    hyp.guest_mask = guest->core_mask;
+    hyp.rt_mask = ((1U << HYP_MAX_CORES) - 1) & ~guest->core_mask;
+    hyp.rt_vttbr = (VMID_RT << VTTBR_VMID_SHIFT) | (uint64_t)(uintptr_t)rt_root;
+    hyp.guest_vttbr = (VMID_GUEST << VTTBR_VMID_SHIFT) | (uint64_t)(uintptr_t)guest_root;
+    hyp.guest_hcr = HCR_GUEST | ((guest->flags & HYP_PART_MMU_OFF) ? HCR_DC : 0);
+
+    for (uint32_t core = 0; core < HYP_MAX_CORES; core++) {
+        hyp_cpu_t *cpu = &hyp.cpu[core];
+
+        cpu->core = core;
+        cpu->state = HYP_CPU_OFF;
+        if (hyp.guest_mask & (1U << core)) {
+            cpu->vcpu = vcpu;
+            hyp.vcpu_core[vcpu++] = (uint8_t)core;
+        }
+    }
+    hyp.nr_vcpus = vcpu;
+
+    /* 5. Guest lines: off until the guest enables them, aimed at vCPU 0 */
+    for (uint32_t i = 0; i < guest->num_irqs; i++) {
+        uint32_t irq = guest->irqs[i];
+
+        gic_disable_irq(irq);
+        gic_set_target(irq, (uint8_t)(1U << hyp.vcpu_core[0]));
+        hyp.guest_spi[irq / 32] |= 1U << (irq % 32);
+    }
+
+    /* 6. Core 0 joins the RT partition */
+    asm volatile("dsb ish" ::: "memory");
+    hyp.active = 1;
+    hyp_call(hyp_el2_rt_join, 0);
+
+    /* 7. Deep idle states would lose EL2 state on RT cores */
+    cpuidle_latency_req_add(&hyp_idle_qos, "hyp", HYP_IDLE_LATENCY_US);
+
+    kprintf("[HYP] Partitioned: RT cores 0x%x, guest '%s' cores 0x%x (%u vCPUs)\n",
+            hyp.rt_mask, guest->name, hyp.guest_mask, hyp.nr_vcpus);
+    return 0;
+}
+
+/* =========================================================================
+ * RT-SIDE CONTROL
+ * ========================================================================= */
+
+int hyp_active(void) {
+    return hyp.active;
+}
+
+int hyp_core_is_rt(uint32_t core) {
+    return !hyp.active || ((hyp.rt_mask >> core) & 1);
+}
+
+/*
+ * hyp_cpu_on
+ * PSCI CPU_ON for an RT core once the hypervisor is active: the core
+ * passes through EL2 (hyp_cpu_entry) and arrives at 'entry' at EL1.
+ */
+int hyp_cpu_on(uint32_t core, uint64_t entry, uint64_t arg) {
+    hyp_cpu_t *cpu;
+
+    if (!hyp.active) {
+        return psci_cpu_on(core, entry, arg);
+    }
+    if (core >= HYP_MAX_CORES || !((hyp.rt_mask >> core) & 1)) {
+        return PSCI_RET_DENIED;
+    }
+
+    cpu = &hyp.cpu[core];
+    cpu->entry = entry;
+    cpu->arg = arg;
+    asm volatile("dsb ish" ::: "memory");
+    return (int)(int64_t)hyp_call(hyp_el2_cpu_on, core);
+}
+
+int hyp_guest_running(void) {
+    for (uint32_t core = 0; core < HYP_MAX_CORES; core++) {
+        if (hyp.cpu[core].state == HYP_CPU_GUEST) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * hyp_guest_start
+ * Powers up vCPU 0 at the guest's entry; the guest starts the rest itself.
+ */
+int hyp_guest_start(void) {
+    hyp_cpu_t *cpu;
+    int rc;
+
+    if (!hyp.active || hyp_guest_running()) {
+        return -1;
+    }
+
+    cpu = &hyp.cpu[hyp.vcpu_core[0]];
+    cpu->entry = hyp.guest->entry;
+    cpu->arg = hyp.guest->boot_arg;
+    cpu->stop = 0;
+    asm volatile("dsb ish" ::: "memory");
+
+    rc = (int)(int64_t)hyp_call(hyp_el2_cpu_on, cpu->core);
+    if (rc != PSCI_RET_SUCCESS) {
+        kprintf("[HYP] ERR: Guest '%s' CPU_ON failed (%d)\n", hyp.guest->name, rc);
+        return -1;
+    }
+
+    kprintf("[HYP] Guest '%s' started on cpu%u\n", hyp.guest->name, cpu->core);
+    return 0;
+}
+
+/*
+ * hyp_guest_stop
+ * Powers the guest's cores off from the RT side and quiesces its lines.
+ * The guest gets no notice; its RAM keeps whatever it held.
+ */
+int hyp_guest_stop(void) {
+    uint32_t mask = 0;
+    uint64_t start;
+    int rc = 0;
+
+    if (!hyp.active) {
+        return -1;
+    }
+
+    /* 1. Stop request to every running guest core */
+    for (uint32_t core = 0; core < HYP_MAX_CORES; core++) {
+        if (hyp.cpu[core].state == HYP_CPU_GUEST) {
+            hyp.cpu[core].stop = 1;
+            mask |= 1U << core;
+        }
+    }
+    asm volatile("dsb ish" ::: "memory");
+    if (mask) {
+        gic_send_sgi(HYP_SGI_STOP, (uint8_t)mask);
+    }
+
+    /* 2. Wait until firmware reports them off */
+    start = timer_get_ticks();
+    for (uint32_t core = 0; core < HYP_MAX_CORES; core++) {
+        if (!(mask & (1U << core))) {
+            continue;
+        }
+        while (hyp.cpu[core].state != HYP_CPU_OFF ||
+               psci_call(PSCI_FN_AFFINITY_INFO, core, 0, 0) != 1) {
+            if (timer_ticks_to_us(timer_get_ticks() - start) >= HYP_STOP_TIMEOUT_US) {
+                kprintf("[HYP] ERR: cpu%u did not stop\n", core);
+                rc = -1;
+                break;
+            }
+        }
+    }
+
+    /* 3. Guest lines back to their reset state */
+    for (uint32_t i = 0; i < hyp.guest->num_irqs; i++) {
+        uint32_t irq = hyp.guest->irqs[i];
+
+        gic_disable_irq(irq);
+        *(volatile uint32_t *)GICD_ICPENDR(irq / 32) = 1U << (irq % 32);
+        gic_set_target(irq, (uint8_t)(1U << hyp.vcpu_core[0]));
+    }
+
+    if (mask) {
+        kprintf("[HYP] Guest '%s' stopped\n", hyp.guest->name);
+    }
+    return rc;
+}
+
+/*
+ * hyp_dump_stats
+ * Per-core partition state and EL2 exit counters.
+ */
+void hyp_dump_stats(void) {
+    static const char *const names[] = { "off", "rt", "guest" };
+
+    if (!hyp.active) {
+        kprintf("[HYP] Not active\n");
+        return;
+    }
+
+    for (uint32_t core = 0; core < HYP_MAX_CORES; core++) {
+        hyp_cpu_t *cpu = &hyp.cpu[core];
+
+        kprintf("[HYP] cpu%u %s: irq %lu mmio %lu smc %lu fault %lu dropped %lu\n",
+                core, names[cpu->state], cpu->irqs, cpu->mmio, cpu->smc,
+                cpu->faults, cpu->dropped);
+    }
+}
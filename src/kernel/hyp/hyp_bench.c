@@ -0,0 +1,161 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hyp_bench.c
+ * Module:      Partitioning Hypervisor (Benchmark)
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * What the guest costs the RT partition: interrupt latency on core 0
+ * (CNTV deadline to ISR entry) and the run time of a cache-bound RT job,
+ * with the guest powered off and with it running. Use hyp_guest_noise
+ * for a guest that is busy for sure (memory streams plus a 50 kHz
+ * virtual timer on each vCPU).
+ * ======================================================================================
+ */
+
+#include "kernel/hyp.h"
+#include "kernel/timer_heavy.h"
+#include "drivers/gic_v2.h"
+#include "mm/pmm.h"
+#include "lib/kprintf.h"
+
+#define BENCH_TIMER_IRQ         27          // CNTV (PPI): free on RT cores
+#define BENCH_SAMPLES           1000
+#define BENCH_JOB_SIZE          (256 * 1024)    // Fits the shared 1MB L2 alone
+#define BENCH_JOB_RUNS          200
+#define BENCH_SETTLE_MS         200
+
+#define CNTV_CTL_ENABLE         (1UL << 0)
+#define CNTV_CTL_IMASK          (1UL << 1)
+
+static volatile uint64_t bench_deadline;
+static volatile uint64_t bench_latency;
+static volatile uint32_t bench_fired;
+
+static inline uint64_t bench_counter(void) {
+    uint64_t v;
+    asm volatile("isb; mrs %0, cntvct_el0" : "=r" (v) :: "memory");
+    return v;
+}
+
+static void bench_timer_isr(uint32_t irq_id, void *arg) {
+    uint64_t now = bench_counter();
+    (void)irq_id;
+    (void)arg;
+
+    asm volatile("msr cntv_ctl_el0, %0" :: "r" (CNTV_CTL_ENABLE | CNTV_CTL_IMASK));
+    bench_latency = now - bench_deadline;
+    bench_fired = 1;
+}
+
+/* One pass of the RT job: read-modify-write per cache line */
+static void bench_job(volatile uint64_t *buf) {
+    for (uint32_t i = 0; i < BENCH_JOB_SIZE / sizeof(uint64_t); i += 8) {
+        buf[i] = buf[i] + 1;
+    }
+}
+
+/*
+ * bench_run
+ * Timer latency over BENCH_SAMPLES staggered deadlines (the job runs
+ * while waiting), then the job alone.
+ */
+static void bench_run(const char *label, volatile uint64_t *buf) {
+    uint64_t sum = 0, max = 0, t0, best = UINT64_MAX, total = 0;
+    uint32_t seed = 0x9E3779B9U;
+
+    /* 1. Latency */
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        bench_fired = 0;
+        bench_deadline = bench_counter() + 50 + (seed >> 22);   // ~0.5-10 us at 100 MHz
+        asm volatile("msr cntv_cval_el0, %0" :: "r" (bench_deadline));
+        asm volatile("msr cntv_ctl_el0, %0; isb" :: "r" (CNTV_CTL_ENABLE) : "memory");
+
+        while (!bench_fired) {
+            bench_job(buf);
+        }
+        sum += bench_latency;
+        if (bench_latency > max) {
+            max = bench_latency;
+        }
+    }
+
+    /* 2. Job time */
+    for (uint32_t i = 0; i < BENCH_JOB_RUNS; i++) {
+        uint64_t t;
+
+        t0 = bench_counter();
+        bench_job(buf);
+        t = bench_counter() - t0;
+        total += t;
+        if (t < best) {
+            best = t;
+        }
+    }
+
+    kprintf("[HYP] %s IRQ latency avg %lu ns, worst %lu ns; job avg %lu ns, best %lu ns\n",
+            label, timer_ticks_to_ns(sum / BENCH_SAMPLES), timer_ticks_to_ns(max),
+            timer_ticks_to_ns(total / BENCH_JOB_RUNS), timer_ticks_to_ns(best));
+}
+
+/*
+ * hyp_benchmark
+ * RT interference with the guest off and on. Needs IRQs unmasked and the
+ * hypervisor active; leaves the guest as it found it.
+ */
+void hyp_benchmark(void) {
+    uint64_t ctl, cval, pa;
+    uint32_t enabled;
+    int was_running;
+
+    if (!hyp_active()) {
+        kprintf("[HYP] ERR: Benchmark needs the partitioned boot (HYP_PARTITIONED)\n");
+        return;
+    }
+
+    pa = pmm_alloc(BENCH_JOB_SIZE, PMM_F_LOW | PMM_F_ZERO);
+    if (pa == 0) {
+        kprintf("[HYP] ERR: No memory for the RT job\n");
+        return;
+    }
+
+    kprintf("\n[HYP] Benchmark: guest '%s', %u samples, %u KB RT job\n",
+            hyp.guest->name, BENCH_SAMPLES, BENCH_JOB_SIZE / 1024);
+
+    /* 1. Take over CNTV at top priority */
+    asm volatile("mrs %0, cntv_ctl_el0" : "=r" (ctl));
+    asm volatile("mrs %0, cntv_cval_el0" : "=r" (cval));
+    enabled = (*(volatile uint32_t *)GICD_ISENABLER(0) >> BENCH_TIMER_IRQ) & 1;
+    gic_register_handler(BENCH_TIMER_IRQ, bench_timer_isr, NULL);
+    gic_set_priority(BENCH_TIMER_IRQ, GIC_PRIO_HIGHEST);
+    gic_enable_irq(BENCH_TIMER_IRQ);
+
+    /* 2. Guest off, then on */
+    was_running = hyp_guest_running();
+    if (was_running) {
+        hyp_guest_stop();
+    }
+    bench_run("guest off:", (volatile uint64_t *)(uintptr_t)pa);
+
+    if (hyp_guest_start() == 0) {
+        mdelay(BENCH_SETTLE_MS);
+        bench_run("guest on: ", (volatile uint64_t *)(uintptr_t)pa);
+        if (!was_running) {
+            hyp_guest_stop();
+        }
+    }
+    hyp_dump_stats();
+
+    /* 3. Give the timer back */
+    gic_unregister_handler(BENCH_TIMER_IRQ);
+    if (enabled) {
+        gic_enable_irq(BENCH_TIMER_IRQ);
+    }
+    asm volatile("msr cntv_cval_el0, %0" :: "r" (cval));
+    asm volatile("msr cntv_ctl_el0, %0; isb" :: "r" (ctl) : "memory");
+    pmm_free(pa, BENCH_JOB_SIZE);
+}
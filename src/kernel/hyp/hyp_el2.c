@@ -0,0 +1,586 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hyp_el2.c
+ * Module:      Partitioning Hypervisor - EL2 Trap Handling
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Everything here runs at EL2 on the EL2 identity map, entered from
+ * hyp_entry.S. RT cores only come here for HYP_HVC_CALL and stage 2
+ * faults; guest cores for IRQs, PSCI/SMCCC calls, distributor accesses
+ * and CNTP accesses. Integer registers only (guest FP state is live).
+ * ======================================================================================
+ */
+
+#pragma GCC target("general-regs-only")
+
+#include "kernel/hyp.h"
+#include "kernel/psci.h"
+#include "drivers/gic_v2.h"
+#include "lib/kprintf.h"
+
+#define SPSR_EL1H_MASKED        0x3C5UL
+#define SMCCC_NOT_SUPPORTED     ((uint64_t)-1)
+#define SMCCC_OWNER(fn)         (((fn) >> 24) & 0x3F)
+#define SMCCC_OWNER_ARCH        0
+#define SMCCC_OWNER_SIP         2       // ZynqMP EEMI, see hyp_guest_eemi()
+#define FN32(fn)                ((fn) & ~(1U << 30))    // SMC32 and SMC64 IDs alike
+
+#define PSCI_FN_MIGRATE_INFO_TYPE   0x84000006U
+
+/* ZynqMP EEMI over SiP: x0 = 0xC2000000 | API ID, x1 = arg0 | arg1 << 32 */
+#define EEMI_API(fn)                ((fn) & 0xFFFF)
+#define EEMI_GET_API_VERSION        1
+#define EEMI_GET_NODE_STATUS        3
+#define EEMI_GET_OP_CHARACTERISTIC  4
+#define EEMI_REGISTER_NOTIFIER      5
+#define EEMI_REQUEST_SUSPEND        6
+#define EEMI_FORCE_POWERDOWN        8
+#define EEMI_ABORT_SUSPEND          9
+#define EEMI_REQUEST_WAKEUP         10
+#define EEMI_SET_WAKEUP_SOURCE      11
+#define EEMI_SYSTEM_SHUTDOWN        12
+#define EEMI_REQUEST_NODE           13
+#define EEMI_RELEASE_NODE           14
+#define EEMI_SET_REQUIREMENT        15
+#define EEMI_SET_MAX_LATENCY        16
+#define EEMI_RESET_ASSERT           17
+#define EEMI_RESET_GET_STATUS       18
+#define EEMI_GET_CHIPID             24
+#define EEMI_PINCTRL_GET_FUNCTION   30
+#define EEMI_PINCTRL_CONFIG_GET     32
+#define EEMI_QUERY_DATA             35
+#define EEMI_CLOCK_GETSTATE         38
+#define EEMI_CLOCK_GETDIVIDER       40
+#define EEMI_CLOCK_GETRATE          42
+#define EEMI_CLOCK_GETPARENT        44
+#define EEMI_FEATURE_CHECK          63
+#define EEMI_GET_CALLBACK_DATA      0xA01
+#define EEMI_GET_TRUSTZONE_VERSION  0xA03
+#define EEMI_SHUTDOWN_TYPE_RESET    1
+#define PSCI_AFFINITY_ON            0
+#define PSCI_AFFINITY_OFF           1
+
+static const char *const fatal_names[] = { "", "FIQ", "SError", "AArch32", "EL2 fault" };
+
+static inline hyp_cpu_t *hyp_this_cpu(void) {
+    uint64_t v;
+    asm volatile("mrs %0, tpidr_el2" : "=r" (v));
+    return (hyp_cpu_t *)(uintptr_t)v;
+}
+
+static inline uint32_t hyp_core_id(void) {
+    uint64_t mpidr;
+    asm volatile("mrs %0, mpidr_el1" : "=r" (mpidr));     // Real MPIDR at EL2
+    return (uint32_t)(mpidr & 0xFF);
+}
+
+/*
+ * hyp_smc
+ * Firmware call from EL2 (SMCCC: x4-x17 may be clobbered).
+ */
+static int64_t hyp_smc(uint64_t fn, uint64_t a1, uint64_t a2, uint64_t a3) {
+    register uint64_t x0 asm("x0") = fn;
+    register uint64_t x1 asm("x1") = a1;
+    register uint64_t x2 asm("x2") = a2;
+    register uint64_t x3 asm("x3") = a3;
+
+    asm volatile("smc #0"
+                 : "+r" (x0), "+r" (x1), "+r" (x2), "+r" (x3)
+                 :
+                 : "x4", "x5", "x6", "x7", "x8", "x9", "x10", "x11",
+                   "x12", "x13", "x14", "x15", "x16", "x17", "memory");
+    return (int64_t)x0;
+}
+
+/* Passes a guest call to firmware unchanged: x0-x7 in, x0-x3 out */
+static void hyp_smc_forward(hyp_frame_t *f) {
+    register uint64_t x0 asm("x0") = f->x[0];
+    register uint64_t x1 asm("x1") = f->x[1];
+    register uint64_t x2 asm("x2") = f->x[2];
+    register uint64_t x3 asm("x3") = f->x[3];
+    register uint64_t x4 asm("x4") = f->x[4];
+    register uint64_t x5 asm("x5") = f->x[5];
+    register uint64_t x6 asm("x6") = f->x[6];
+    register uint64_t x7 asm("x7") = f->x[7];
+
+    asm volatile("smc #0"
+                 : "+r" (x0), "+r" (x1), "+r" (x2), "+r" (x3),
+                   "+r" (x4), "+r" (x5), "+r" (x6), "+r" (x7)
+                 :
+                 : "x8", "x9", "x10", "x11", "x12", "x13", "x14", "x15",
+                   "x16", "x17", "memory");
+    f->x[0] = x0;
+    f->x[1] = x1;
+    f->x[2] = x2;
+    f->x[3] = x3;
+}
+
+/*
+ * hyp_enter_partition
+ * Loads the partition's EL2 controls on this core.
+ */
+static void hyp_enter_partition(hyp_cpu_t *cpu, int guest) {
+    uint64_t hcr, vttbr, cnthctl;
+
+    if (guest) {
+        hcr = hyp.guest_hcr;
+        vttbr = hyp.guest_vttbr;
+        cnthctl = CNTHCTL_EL1PCTEN;                         // CNTP traps, CNTV is the guest's
+        asm volatile("msr vmpidr_el2, %0" :: "r" ((1UL << 31) | cpu->vcpu));
+    } else {
+        hcr = HCR_RT;
+        vttbr = hyp.rt_vttbr;
+        cnthctl = CNTHCTL_EL1PCTEN | CNTHCTL_EL1PCEN;
+    }
+
+    asm volatile("msr tpidr_el2, %0" :: "r" (cpu));
+    asm volatile("msr cnthctl_el2, %0" :: "r" (cnthctl));
+    asm volatile("msr cntvoff_el2, xzr");
+    asm volatile("msr vtcr_el2, %0" :: "r" (VTCR_VALUE));
+    asm volatile("msr vttbr_el2, %0" :: "r" (vttbr));
+    asm volatile("msr hcr_el2, %0" :: "r" (hcr));
+    asm volatile("isb; tlbi vmalls12e1; dsb nsh; isb" ::: "memory");
+}
+
+/*
+ * hyp_el2_rt_join
+ * HYP_HVC_CALL target: puts the calling core (already at EL1) into the RT
+ * partition. Core 0 uses it from hyp_init().
+ */
+uint64_t hyp_el2_rt_join(uint64_t arg) {
+    hyp_cpu_t *cpu = &hyp.cpu[hyp_core_id()];
+    (void)arg;
+
+    hyp_enter_partition(cpu, 0);
+    cpu->state = HYP_CPU_RT;
+    return 0;
+}
+
+/*
+ * hyp_el2_cpu_on
+ * Powers up 'core' at hyp_cpu_entry, so it arrives at EL2 whatever EL the
+ * firmware would pick for an EL1 caller. cpu->entry/arg say where it goes.
+ */
+uint64_t hyp_el2_cpu_on(uint64_t core) {
+    return (uint64_t)hyp_smc(PSCI_FN_CPU_ON, core, (uint64_t)(uintptr_t)hyp_cpu_entry, core);
+}
+
+/*
+ * hyp_cpu_boot
+ * First C code of a core started by hyp_el2_cpu_on(). Fills the frame that
+ * hyp_entry.S erets into: EL1h, everything masked, x0 = cpu->arg.
+ */
+void hyp_cpu_boot(uint64_t core, hyp_frame_t *f) {
+    hyp_cpu_t *cpu = &hyp.cpu[core];
+    int guest = (hyp.guest_mask >> core) & 1;
+
+    /* 1. EL1 from its reset state, under the partition's controls */
+    asm volatile("msr sctlr_el1, %0" :: "r" (SCTLR_EL1_RESET));
+    hyp_enter_partition(cpu, guest);
+
+    /* 2. Guest cores: EL2 owns the physical CPU interface */
+    if (guest) {
+        hyp_vgic_cpu_init(cpu);
+    }
+
+    /* 3. First EL1 instruction */
+    for (uint32_t i = 0; i < 31; i++) {
+        f->x[i] = 0;
+    }
+    f->x[0] = cpu->arg;
+    f->elr = cpu->entry;
+    f->spsr = SPSR_EL1H_MASKED;
+
+    cpu->state = guest ? HYP_CPU_GUEST : HYP_CPU_RT;
+    asm volatile("dsb ish; sev" ::: "memory");
+}
+
+/*
+ * hyp_el2_cpu_off
+ * Takes this guest core down for good (CPU_OFF, stop request, shutdown).
+ */
+void hyp_el2_cpu_off(hyp_cpu_t *cpu) {
+    hyp_vgic_cpu_off(cpu);
+
+    cpu->stop = 0;
+    cpu->state = HYP_CPU_OFF;
+    asm volatile("dsb ish; sev" ::: "memory");
+
+    hyp_smc(PSCI_FN_CPU_OFF, 0, 0, 0);
+    for (;;) {
+        asm volatile("wfi");                    // CPU_OFF does not return on success
+    }
+}
+
+/*
+ * hyp_guest_shutdown
+ * SYSTEM_OFF/RESET from the guest only ends the guest partition.
+ */
+static void hyp_guest_shutdown(hyp_cpu_t *cpu, uint32_t fn) {
+    uint32_t mask = 0;
+
+    for (uint32_t core = 0; core < HYP_MAX_CORES; core++) {
+        if (core != cpu->core && hyp.cpu[core].state == HYP_CPU_GUEST) {
+            hyp.cpu[core].stop = 1;
+            mask |= 1U << core;
+        }
+    }
+    asm volatile("dsb ish" ::: "memory");
+    if (mask) {
+        *(volatile uint32_t *)GICD_SGIR = (mask << 16) | HYP_SGI_STOP;
+    }
+
+    kprintf("[HYP] Guest '%s' requested %s: partition stopped\n", hyp.guest->name,
+            (FN32(fn) == PSCI_FN_SYSTEM_RESET) ? "SYSTEM_RESET" : "SYSTEM_OFF");
+    hyp_el2_cpu_off(cpu);
+}
+
+/*
+ * hyp_guest_cpu_on
+ * PSCI CPU_ON for a guest vCPU (MPIDR Aff0 = vCPU index).
+ */
+static int64_t hyp_guest_cpu_on(uint64_t target, uint64_t entry, uint64_t ctx) {
+    uint32_t vcpu = (uint32_t)(target & 0xFF);
+    hyp_cpu_t *t;
+
+    if ((target & 0xFF00FFFF00UL) || vcpu >= hyp.nr_vcpus) {
+        return PSCI_RET_INVALID_PARAMS;
+    }
+
+    t = &hyp.cpu[hyp.vcpu_core[vcpu]];
+    if (t->state != HYP_CPU_OFF) {
+        return PSCI_RET_ALREADY_ON;
+    }
+
+    t->entry = entry;
+    t->arg = ctx;
+    t->stop = 0;
+    return (int64_t)hyp_el2_cpu_on(t->core);
+}
+
+static int hyp_pm_owned(const uint32_t *ids, uint32_t n, uint32_t id) {
+    for (uint32_t i = 0; i < n; i++) {
+        if (ids[i] == id) return 1;
+    }
+    return 0;
+}
+
+/*
+ * hyp_guest_eemi
+ * SiP call from the guest. The PMU serves the whole SoC, so only queries
+ * and requests on the partition's own nodes and resets reach firmware:
+ * APU cores, RT devices, clocks, pins, MMIO and PM_INIT_FINALIZE (which
+ * powers down every node nobody requested) stay out of reach.
+ */
+static void hyp_guest_eemi(hyp_cpu_t *cpu, hyp_frame_t *f) {
+    const hyp_partition_t *g = hyp.guest;
+    uint32_t fn = (uint32_t)f->x[0];
+    uint32_t arg0 = (uint32_t)f->x[1];
+
+    if ((FN32(fn) & 0xFFFF0000U) != 0x82000000U) {
+        f->x[0] = SMCCC_NOT_SUPPORTED;
+        return;
+    }
+
+    switch (EEMI_API(fn)) {
+    case EEMI_GET_API_VERSION:
+    case EEMI_GET_NODE_STATUS:
+    case EEMI_GET_OP_CHARACTERISTIC:
+    case EEMI_RESET_GET_STATUS:
+    case EEMI_GET_CHIPID:
+    case EEMI_PINCTRL_GET_FUNCTION:
+    case EEMI_PINCTRL_CONFIG_GET:
+    case EEMI_QUERY_DATA:
+    case EEMI_CLOCK_GETSTATE:
+    case EEMI_CLOCK_GETDIVIDER:
+    case EEMI_CLOCK_GETRATE:
+    case EEMI_CLOCK_GETPARENT:
+    case EEMI_FEATURE_CHECK:
+    case EEMI_GET_CALLBACK_DATA:
+    case EEMI_GET_TRUSTZONE_VERSION:
+        hyp_smc_forward(f);
+        return;
+
+    case EEMI_REGISTER_NOTIFIER:
+    case EEMI_REQUEST_SUSPEND:
+    case EEMI_FORCE_POWERDOWN:
+    case EEMI_ABORT_SUSPEND:
+    case EEMI_REQUEST_WAKEUP:
+    case EEMI_SET_WAKEUP_SOURCE:
+    case EEMI_REQUEST_NODE:
+    case EEMI_RELEASE_NODE:
+    case EEMI_SET_REQUIREMENT:
+    case EEMI_SET_MAX_LATENCY:
+        if (hyp_pm_owned(g->pm_nodes, g->num_pm_nodes, arg0)) {
+            hyp_smc_forward(f);
+            return;
+        }
+        break;
+
+    case EEMI_RESET_ASSERT:
+        if (hyp_pm_owned(g->pm_resets, g->num_pm_resets, arg0)) {
+            hyp_smc_forward(f);
+            return;
+        }
+        break;
+
+    case EEMI_SYSTEM_SHUTDOWN:
+        hyp_guest_shutdown(cpu, (arg0 == EEMI_SHUTDOWN_TYPE_RESET) ?
+                           PSCI_FN_SYSTEM_RESET : PSCI_FN_SYSTEM_OFF);
+        return;
+
+    default:
+        break;
+    }
+    f->x[0] = SMCCC_NOT_SUPPORTED;
+}
+
+/*
+ * hyp_guest_smccc
+ * Trapped SMC (HCR.TSC) or HVC from the guest. PSCI is virtualized over
+ * the guest's cores; SMCCC architecture calls go to firmware, SiP calls
+ * through hyp_guest_eemi().
+ */
+static void hyp_guest_smccc(hyp_cpu_t *cpu, hyp_frame_t *f) {
+    uint32_t fn = (uint32_t)f->x[0];
+    uint32_t vcpu;
+
+    cpu->smc++;
+
+    switch (FN32(fn)) {
+    case FN32(PSCI_FN_VERSION):
+    case FN32(PSCI_FN_FEATURES):
+    case PSCI_FN_MIGRATE_INFO_TYPE:
+        hyp_smc_forward(f);
+        return;
+
+    case FN32(PSCI_FN_CPU_ON):
+        f->x[0] = (uint64_t)hyp_guest_cpu_on(f->x[1], f->x[2], f->x[3]);
+        return;
+
+    case FN32(PSCI_FN_AFFINITY_INFO):
+        vcpu = (uint32_t)(f->x[1] & 0xFF);
+        if (vcpu >= hyp.nr_vcpus || f->x[2] != 0) {
+            f->x[0] = (uint64_t)(int64_t)PSCI_RET_INVALID_PARAMS;
+        } else {
+            f->x[0] = (hyp.cpu[hyp.vcpu_core[vcpu]].state == HYP_CPU_OFF) ?
+                      PSCI_AFFINITY_OFF : PSCI_AFFINITY_ON;
+        }
+        return;
+
+    case FN32(PSCI_FN_CPU_SUSPEND):
+        /* Powerdown would lose EL2 state: every request becomes standby */
+        asm volatile("dsb sy; wfi" ::: "memory");
+        f->x[0] = PSCI_RET_SUCCESS;
+        return;
+
+    case FN32(PSCI_FN_CPU_OFF):
+        hyp_el2_cpu_off(cpu);
+        return;
+
+    case FN32(PSCI_FN_SYSTEM_OFF):
+    case FN32(PSCI_FN_SYSTEM_RESET):
+        hyp_guest_shutdown(cpu, fn);
+        return;
+
+    default:
+        break;
+    }
+
+    if (SMCCC_OWNER(fn) == SMCCC_OWNER_ARCH) {
+        hyp_smc_forward(f);
+    } else if (SMCCC_OWNER(fn) == SMCCC_OWNER_SIP) {
+        hyp_guest_eemi(cpu, f);
+    } else {
+        f->x[0] = SMCCC_NOT_SUPPORTED;
+    }
+}
+
+/*
+ * hyp_guest_mmio
+ * Distributor access from the guest (unmapped in its stage 2).
+ * Returns 0 if emulated, -1 to reflect the abort.
+ */
+static int hyp_guest_mmio(hyp_cpu_t *cpu, hyp_frame_t *f, uint64_t esr) {
+    uint64_t hpfar, far, ipa, val;
+    uint32_t size, srt, write;
+
+    if (!(esr & ESR_ISV)) {
+        return -1;                                  // Not a single-register load/store
+    }
+
+    asm volatile("mrs %0, hpfar_el2" : "=r" (hpfar));
+    asm volatile("mrs %0, far_el2" : "=r" (far));
+    ipa = ((hpfar >> 4) << 12) | (far & 0xFFF);
+    if (ipa < GIC_DIST_BASE || ipa >= GIC_DIST_BASE + 0x10000) {
+        return -1;
+    }
+
+    size = 1U << ((esr >> 22) & 0x3);
+    srt = (esr >> 16) & 0x1F;
+    write = (esr >> 6) & 0x1;
+    val = (srt == 31) ? 0 : f->x[srt];
+
+    if (hyp_vgicd_access(cpu, (uint32_t)(ipa - GIC_DIST_BASE), size, write, &val) != 0) {
+        return -1;
+    }
+
+    if (!write && srt != 31) {
+        if ((esr & (1UL << 21)) && size < 8) {                  // SSE: sign-extend
+            uint32_t shift = 64 - size * 8;
+            val = (uint64_t)((int64_t)(val << shift) >> shift);
+        }
+        if (!(esr & (1UL << 15))) {                             // SF = 0: Wt
+            val &= 0xFFFFFFFFUL;
+        }
+        f->x[srt] = val;
+    }
+
+    cpu->mmio++;
+    return 0;
+}
+
+/*
+ * hyp_guest_sysreg
+ * CNTP_{TVAL,CTL,CVAL}_EL0 from the guest: RAZ/WI (its timer is CNTV).
+ */
+static int hyp_guest_sysreg(hyp_frame_t *f, uint64_t esr) {
+    uint32_t op0 = (esr >> 20) & 0x3, op1 = (esr >> 14) & 0x7;
+    uint32_t crn = (esr >> 10) & 0xF, crm = (esr >> 1) & 0xF;
+    uint32_t rt = (esr >> 5) & 0x1F, read = esr & 0x1;
+
+    if (op0 != 3 || op1 != 3 || crn != 14 || crm != 2) {
+        return -1;
+    }
+    if (read && rt != 31) {
+        f->x[rt] = 0;
+    }
+    return 0;
+}
+
+/*
+ * hyp_reflect
+ * Hands an exception EL2 will not handle to the lower EL's own vectors, as
+ * if stage 1 had raised it: aborts keep their syndrome, the rest become
+ * undefined instructions.
+ */
+static void hyp_reflect(hyp_cpu_t *cpu, hyp_frame_t *f, uint64_t esr) {
+    uint64_t ec = esr >> ESR_EC_SHIFT, mode = f->spsr & 0xF;
+    uint64_t far = 0, vbar, offset;
+
+    if (cpu) {
+        cpu->faults++;
+    }
+
+    if (ec == ESR_EC_DABT_LOW || ec == ESR_EC_IABT_LOW) {
+        asm volatile("mrs %0, far_el2" : "=r" (far));
+        if (mode != 0) {
+            esr += 1UL << ESR_EC_SHIFT;                 // Lower-EL class -> same-EL class
+        }
+    } else {
+        esr = (ESR_EC_UNKNOWN << ESR_EC_SHIFT) | ESR_IL;
+    }
+
+    /* EL0 -> lower-EL sync, EL1t -> current SP0 sync, EL1h -> current SPx sync */
+    offset = (mode == 0) ? 0x400 : (mode == 4) ? 0x000 : 0x200;
+
+    asm volatile("msr esr_el1, %0" :: "r" (esr));
+    asm volatile("msr far_el1, %0" :: "r" (far));
+    asm volatile("msr elr_el1, %0" :: "r" (f->elr));
+    asm volatile("msr spsr_el1, %0" :: "r" (f->spsr));
+    asm volatile("mrs %0, vbar_el1" : "=r" (vbar));
+
+    f->elr = vbar + offset;
+    f->spsr = SPSR_EL1H_MASKED;
+}
+
+/*
+ * hyp_handle_sync
+ * Synchronous exception from EL1/EL0 of either partition.
+ */
+void hyp_handle_sync(hyp_frame_t *f) {
+    hyp_cpu_t *cpu = hyp_this_cpu();
+    uint64_t esr, ec;
+
+    asm volatile("mrs %0, esr_el2" : "=r" (esr));
+    ec = esr >> ESR_EC_SHIFT;
+
+    /* 1. RT partition (or core 0 before it joined): service calls only */
+    if (cpu == NULL || cpu->state == HYP_CPU_RT) {
+        if (ec == ESR_EC_HVC64 && (uint32_t)f->x[0] == HYP_HVC_CALL) {
+            f->x[0] = ((hyp_fn_t)(uintptr_t)f->x[1])(f->x[2]);
+        } else if (ec == ESR_EC_HVC64) {
+            f->x[0] = SMCCC_NOT_SUPPORTED;
+        } else {
+            hyp_reflect(cpu, f, esr);               // Stage 2 fault: an RT bug
+        }
+        return;
+    }
+
+    /* 2. Guest */
+    switch (ec) {
+    case ESR_EC_SMC64:
+        f->elr += 4;                                // Trapped SMC: ELR is the SMC itself
+        hyp_guest_smccc(cpu, f);
+        return;
+    case ESR_EC_HVC64:
+        hyp_guest_smccc(cpu, f);
+        return;
+    case ESR_EC_DABT_LOW:
+        if (hyp_guest_mmio(cpu, f, esr) == 0) {
+            f->elr += 4;
+            return;
+        }
+        break;
+    case ESR_EC_SYS64:
+        if (hyp_guest_sysreg(f, esr) == 0) {
+            f->elr += 4;
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+
+    hyp_reflect(cpu, f, esr);
+}
+
+/*
+ * hyp_handle_irq
+ * Physical IRQ on a guest core (HCR.IMO). RT cores never get here.
+ */
+void hyp_handle_irq(hyp_frame_t *f) {
+    hyp_cpu_t *cpu = hyp_this_cpu();
+    (void)f;
+
+    if (cpu != NULL && cpu->state == HYP_CPU_GUEST) {
+        hyp_vgic_irq(cpu);
+    }
+}
+
+/*
+ * hyp_handle_fatal
+ * FIQ/SError/AArch32 from a partition, or a fault in EL2 itself. A guest
+ * core is taken offline; anything else is parked where JTAG can see it.
+ */
+void hyp_handle_fatal(hyp_frame_t *f, uint64_t kind) {
+    hyp_cpu_t *cpu = hyp_this_cpu();
+    uint64_t esr, far;
+
+    asm volatile("mrs %0, esr_el2" : "=r" (esr));
+    asm volatile("mrs %0, far_el2" : "=r" (far));
+    kprintf("[HYP] ERR: %s on cpu%u (ESR 0x%lx, ELR 0x%lx, FAR 0x%lx)\n",
+            (kind < sizeof(fatal_names) / sizeof(fatal_names[0])) ? fatal_names[kind] : "?",
+            hyp_core_id(), esr, f->elr, far);
+
+    if (cpu != NULL && cpu->state == HYP_CPU_GUEST && kind != HYP_FATAL_EL2) {
+        hyp_el2_cpu_off(cpu);
+    }
+    for (;;) {
+        asm volatile("wfi");
+    }
+}
@@ -0,0 +1,360 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        hyp_vgic.c
+ * Module:      Partitioning Hypervisor - Virtual GIC
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (GIC-400)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Interrupt virtualization for guest cores, at EL2.
+ *
+ * 1. Injection: EL2 acknowledges every physical IRQ on a guest core with
+ *    EOImode = 1, so EOIR only drops the running priority. Peripheral
+ *    lines go into a list register with the HW bit and stay active until
+ *    the guest's virtual EOI deactivates them. SGIs are deactivated here
+ *    and injected as pure virtual interrupts.
+ * 2. Full list registers: the LR value waits in a short per-core backlog
+ *    and the underflow maintenance interrupt refills the LRs.
+ * 3. Distributor: the guest's GICD accesses trap (the page is not in its
+ *    stage 2) and are applied to the physical distributor for the lines
+ *    it owns only. Targets and SGIs are translated vCPU <-> core.
+ * ======================================================================================
+ */
+
+#pragma GCC target("general-regs-only")
+
+#include "kernel/hyp.h"
+#include "drivers/gic_v2.h"
+
+#define REG32(a)                (*(volatile uint32_t *)(uintptr_t)(a))
+#define REG8(a)                 (*(volatile uint8_t *)(uintptr_t)(a))
+
+#define GIC_SPURIOUS_MIN        1020
+#define VGIC_GUEST_PMR          0xF8        // Everything reaches EL2
+#define VGIC_SGIR_FILTER_LIST   0
+#define VGIC_SGIR_FILTER_OTHERS 1
+#define VGIC_SGIR_FILTER_SELF   2
+
+static uint32_t vgic_nr_lr;
+
+/* Lines the guest may see and program */
+static int vgic_owned(uint32_t id) {
+    if (id < 32) {
+        return id != GICH_MAINT_IRQ && id != HYP_SGI_STOP;
+    }
+    if (id >= 32 * 32) {
+        return 0;
+    }
+    return (hyp.guest_spi[id / 32] >> (id % 32)) & 1;
+}
+
+/* One bit per line: the owned subset of bank 'n' */
+static uint32_t vgic_bank_mask(uint32_t n) {
+    if (n == 0) {
+        return ~((1U << GICH_MAINT_IRQ) | (1U << HYP_SGI_STOP));
+    }
+    return (n < 32) ? hyp.guest_spi[n] : 0;
+}
+
+/* vCPU bit mask <-> physical core bit mask */
+static uint32_t vgic_vcpus_to_cores(uint32_t vmask) {
+    uint32_t pmask = 0;
+
+    for (uint32_t v = 0; v < hyp.nr_vcpus; v++) {
+        if (vmask & (1U << v)) {
+            pmask |= 1U << hyp.vcpu_core[v];
+        }
+    }
+    return pmask;
+}
+
+static uint32_t vgic_cores_to_vcpus(uint32_t pmask) {
+    uint32_t vmask = 0;
+
+    for (uint32_t v = 0; v < hyp.nr_vcpus; v++) {
+        if (pmask & (1U << hyp.vcpu_core[v])) {
+            vmask |= 1U << v;
+        }
+    }
+    return vmask;
+}
+
+/*
+ * hyp_vgic_cpu_init
+ * Takes over this core's physical CPU interface for a guest vCPU.
+ */
+void hyp_vgic_cpu_init(hyp_cpu_t *cpu) {
+    /* 1. Physical interface: EL2 acknowledges, the guest deactivates */
+    REG32(GICC_PMR) = VGIC_GUEST_PMR;
+    REG32(GICC_BPR) = 0;
+    REG32(GICC_CTLR) = GICC_CTLR_ENABLE | GICC_CTLR_EOIMODE;
+
+    /* 2. Empty virtual interface */
+    vgic_nr_lr = (REG32(GICH_VTR) & 0x3F) + 1;
+    for (uint32_t i = 0; i < vgic_nr_lr; i++) {
+        REG32(GICH_LR(i)) = 0;
+    }
+    REG32(GICH_APR) = 0;
+    REG32(GICH_VMCR) = 0;
+    cpu->nr_backlog = 0;
+
+    /* 3. Banked lines the hypervisor keeps: maintenance and stop */
+    REG8(GICD_IPRIORITYR(0) + GICH_MAINT_IRQ) = GIC_PRIO_HIGHEST;
+    REG8(GICD_IPRIORITYR(0) + HYP_SGI_STOP) = GIC_PRIO_HIGHEST;
+    REG32(GICD_ISENABLER(0)) = (1U << GICH_MAINT_IRQ) | (1U << HYP_SGI_STOP);
+
+    REG32(GICH_HCR) = GICH_HCR_EN;
+}
+
+/*
+ * hyp_vgic_cpu_off
+ * Drops every interrupt still owed to the guest on this core. HW-linked
+ * ones are deactivated, or their lines would stay active for good.
+ */
+void hyp_vgic_cpu_off(hyp_cpu_t *cpu) {
+    uint32_t lr;
+
+    for (uint32_t i = 0; i < vgic_nr_lr; i++) {
+        lr = REG32(GICH_LR(i));
+        if ((lr & GICH_LR_HW) && (lr & (GICH_LR_PENDING | GICH_LR_ACTIVE))) {
+            REG32(GICC_DIR) = (lr >> 10) & 0x3FF;
+        }
+        REG32(GICH_LR(i)) = 0;
+    }
+    for (uint32_t i = 0; i < cpu->nr_backlog; i++) {
+        if (cpu->backlog[i] & GICH_LR_HW) {
+            REG32(GICC_DIR) = (cpu->backlog[i] >> 10) & 0x3FF;
+        }
+    }
+    cpu->nr_backlog = 0;
+
+    REG32(GICH_HCR) = 0;
+    REG32(GICC_CTLR) = 0;
+}
+
+/* Moves backlog entries into free list registers, oldest first */
+static void vgic_refill(hyp_cpu_t *cpu) {
+    uint32_t free = REG32(GICH_ELSR0) & ((vgic_nr_lr < 32) ? ((1U << vgic_nr_lr) - 1) : ~0U);
+    uint32_t done = 0;
+
+    while (free && done < cpu->nr_backlog) {
+        uint32_t i = (uint32_t)__builtin_ctz(free);
+
+        REG32(GICH_LR(i)) = cpu->backlog[done++];
+        free &= free - 1;
+    }
+    for (uint32_t i = done; i < cpu->nr_backlog; i++) {
+        cpu->backlog[i - done] = cpu->backlog[i];
+    }
+    cpu->nr_backlog -= done;
+
+    REG32(GICH_HCR) = cpu->nr_backlog ? (GICH_HCR_EN | GICH_HCR_UIE) : GICH_HCR_EN;
+}
+
+static void vgic_inject(hyp_cpu_t *cpu, uint32_t lr) {
+    /* 1. Behind a backlog: keep the order */
+    if (cpu->nr_backlog == 0) {
+        uint32_t free = REG32(GICH_ELSR0) & ((vgic_nr_lr < 32) ? ((1U << vgic_nr_lr) - 1) : ~0U);
+
+        if (free) {
+            REG32(GICH_LR((uint32_t)__builtin_ctz(free))) = lr;
+            return;
+        }
+    }
+
+    /* 2. No free list register */
+    if (cpu->nr_backlog < HYP_LR_BACKLOG) {
+        cpu->backlog[cpu->nr_backlog++] = lr;
+        REG32(GICH_HCR) = GICH_HCR_EN | GICH_HCR_UIE;
+        return;
+    }
+
+    cpu->dropped++;
+    if (lr & GICH_LR_HW) {
+        REG32(GICC_DIR) = (lr >> 10) & 0x3FF;   // Let the line fire again
+    }
+}
+
+/*
+ * hyp_vgic_irq
+ * Physical IRQ taken at EL2 on a guest core.
+ */
+void hyp_vgic_irq(hyp_cpu_t *cpu) {
+    uint32_t iar = REG32(GICC_IAR);
+    uint32_t id = iar & 0x3FF;
+    uint32_t prio, lr;
+
+    if (id >= GIC_SPURIOUS_MIN) {
+        return;
+    }
+
+    /* 1. Hypervisor's own lines */
+    if (id == HYP_SGI_STOP || id == GICH_MAINT_IRQ) {
+        REG32(GICC_EOIR) = iar;
+        REG32(GICC_DIR) = iar;
+        if (id == GICH_MAINT_IRQ) {
+            vgic_refill(cpu);
+        } else if (cpu->stop) {
+            hyp_el2_cpu_off(cpu);
+        }
+        return;
+    }
+
+    /* 2. Guest line: priority as the guest programmed it */
+    prio = REG8(GICD_IPRIORITYR(0) + id);
+    REG32(GICC_EOIR) = iar;
+
+    if (id < 16) {
+        /* SGI: done here, the source core becomes the source vCPU */
+        REG32(GICC_DIR) = iar;
+        lr = GICH_LR_VID(id) | GICH_LR_CPUID(hyp.cpu[(iar >> 10) & 0x7].vcpu) |
+             GICH_LR_PRIO(prio) | GICH_LR_PENDING;
+    } else {
+        lr = GICH_LR_HW | GICH_LR_PID(id) | GICH_LR_VID(id) |
+             GICH_LR_PRIO(prio) | GICH_LR_PENDING;
+    }
+
+    vgic_inject(cpu, lr);
+    cpu->irqs++;
+}
+
+/* GICD_SGIR from the guest */
+static void vgic_sgir(hyp_cpu_t *cpu, uint32_t val) {
+    uint32_t id = val & 0xF;
+    uint32_t vmask;
+
+    if (!vgic_owned(id)) {
+        return;
+    }
+
+    switch ((val >> 24) & 0x3) {
+    case VGIC_SGIR_FILTER_LIST:
+        vmask = (val >> 16) & 0xFF;
+        break;
+    case VGIC_SGIR_FILTER_OTHERS:
+        vmask = ((1U << hyp.nr_vcpus) - 1) & ~(1U << cpu->vcpu);
+        break;
+    case VGIC_SGIR_FILTER_SELF:
+        vmask = 1U << cpu->vcpu;
+        break;
+    default:
+        return;
+    }
+
+    vmask = vgic_vcpus_to_cores(vmask);
+    if (vmask) {
+        REG32(GICD_SGIR) = (vmask << 16) | id;
+    }
+}
+
+/* GICD_ITARGETSR byte for 'id' */
+static uint32_t vgic_target_read(hyp_cpu_t *cpu, uint32_t id) {
+    if (id < 32) {
+        return 1U << cpu->vcpu;
+    }
+    return vgic_cores_to_vcpus(REG8(GICD_ITARGETSR(0) + id));
+}
+
+static void vgic_target_write(uint32_t id, uint32_t vmask) {
+    uint32_t pmask = vgic_vcpus_to_cores(vmask);
+
+    if (id < 32) {
+        return;                                     // Banked, read-only
+    }
+    REG8(GICD_ITARGETSR(0) + id) = (uint8_t)(pmask ? pmask : (1U << hyp.vcpu_core[0]));
+}
+
+/*
+ * hyp_vgicd_access
+ * Emulates one guest access to distributor 'offset'. Returns -1 for
+ * accesses the GIC itself would not accept (the abort is reflected).
+ */
+int hyp_vgicd_access(hyp_cpu_t *cpu, uint32_t offset, uint32_t size, int write, uint64_t *val) {
+    uint32_t v = (uint32_t)*val;
+    uint32_t r = 0;
+
+    if (size == 8 || (offset & (size - 1))) {
+        return -1;
+    }
+
+    /* 1. Byte-accessible registers: priorities and targets */
+    if (offset >= 0x400 && offset < 0xC00) {
+        for (uint32_t i = 0; i < size; i++) {
+            uint32_t reg = offset + i;
+            uint32_t id = (reg & 0x3FF);
+            uint32_t b = (v >> (8 * i)) & 0xFF;
+
+            if (!vgic_owned(id)) {
+                continue;
+            }
+            if (reg < 0x800) {
+                if (write) {
+                    REG8(GICD_IPRIORITYR(0) + id) = (uint8_t)b;
+                } else {
+                    r |= (uint32_t)REG8(GICD_IPRIORITYR(0) + id) << (8 * i);
+                }
+            } else {
+                if (write) {
+                    vgic_target_write(id, b);
+                } else {
+                    r |= vgic_target_read(cpu, id) << (8 * i);
+                }
+            }
+        }
+        if (!write) {
+            *val = r;
+        }
+        return 0;
+    }
+
+    /* 2. Word registers */
+    if (size != 4) {
+        return -1;
+    }
+
+    if (offset >= 0x100 && offset < 0x380) {
+        /* Set/clear enable, pending, active: one bit per line */
+        uint32_t mask = vgic_bank_mask((offset & 0x7F) / 4);
+
+        if (write) {
+            REG32(GIC_DIST_BASE + offset) = v & mask;
+        } else {
+            r = REG32(GIC_DIST_BASE + offset) & mask;
+        }
+    } else if (offset >= 0xC00 && offset < 0xD00) {
+        /* Trigger configuration: two bits per line, SPIs only writable */
+        uint32_t first = ((offset - 0xC00) / 4) * 16;
+        uint32_t mask = 0;
+
+        for (uint32_t i = 0; i < 16; i++) {
+            if (vgic_owned(first + i)) {
+                mask |= 3U << (2 * i);
+            }
+        }
+        if (write) {
+            if (first >= 32) {
+                REG32(GIC_DIST_BASE + offset) = (REG32(GIC_DIST_BASE + offset) & ~mask) | (v & mask);
+            }
+        } else {
+            r = REG32(GIC_DIST_BASE + offset) & mask;
+        }
+    } else if (offset == 0x000) {
+        r = GICD_CTLR_ENABLE;                       // PhotonX owns the real switch
+    } else if (offset == 0x004) {
+        r = (REG32(GICD_TYPER) & ~(0x7U << 5)) | ((hyp.nr_vcpus - 1) << 5);
+    } else if (offset == 0x008 || offset >= 0xFD0) {
+        r = REG32(GIC_DIST_BASE + offset);           // IIDR, peripheral/component IDs
+    } else if (offset == 0xF00) {
+        if (write) {
+            vgic_sgir(cpu, v);
+        }
+    }
+    /* Everything else (groups, SGI pending): RAZ/WI */
+
+    if (!write) {
+        *val = r;
+    }
+    return 0;
+}
@@ -24,6 +24,18 @@
 #define MMIO_READ32(addr)       (*(volatile uint32_t *)(addr))
 #define MMIO_WRITE32(addr, val) (*(volatile uint32_t *)(addr) = (val))
 
+/*
+ * IRQ Handler Table
+ * Indexed by interrupt ID. Unregistered lines are counted and ignored.
+ */
+typedef struct {
+    irq_handler_t handler;
+    void *arg;
+} irq_desc_t;
+
+static irq_desc_t irq_table[MAX_IRQS];
+static uint64_t irq_unhandled_count = 0;
+
 /*
  * ======================================================================================
  * FUNCTION: gic_dist_init
@@ -103,6 +115,14 @@ static void gic_cpu_init(void) {
     MMIO_WRITE32(GICC_CTLR, GICC_CTLR_ENABLE);
 }
 
+/*
+ * gic_cpu_interface_init
+ * Per-core entry for secondaries (the distributor is already up).
+ */
+void gic_cpu_interface_init(void) {
+    gic_cpu_init();
+}
+
 /*
  * ======================================================================================
  * FUNCTION: gic_init (GLOBAL ENTRY POINT)
@@ -158,6 +178,58 @@ void gic_set_priority(uint32_t irq_id, uint8_t priority) {
     MMIO_WRITE32(GICD_IPRIORITYR(reg_offset), val);
 }
 
+void gic_set_target(uint32_t irq_id, uint8_t cpu_mask) {
+    uint32_t reg_offset = (irq_id / 4);
+    uint32_t bit_shift  = (irq_id % 4) * 8;
+
+    /* Read-Modify-Write sequence (SPIs only; SGI/PPI targets are fixed) */
+    uint32_t val = MMIO_READ32(GICD_ITARGETSR(reg_offset));
+    val &= ~(0xFF << bit_shift);
+    val |= ((uint32_t)cpu_mask << bit_shift);
+
+    MMIO_WRITE32(GICD_ITARGETSR(reg_offset), val);
+}
+
+/*
+ * gic_send_sgi
+ * Raises SGI 'sgi_id' (0-15) on every core in 'cpu_mask'.
+ */
+void gic_send_sgi(uint32_t sgi_id, uint8_t cpu_mask) {
+    asm volatile("dsb ish" ::: "memory"); // Make prior stores visible to the targets
+    MMIO_WRITE32(GICD_SGIR, ((uint32_t)cpu_mask << 16) | (sgi_id & 0xF));
+}
+
+/*
+ * ======================================================================================
+ * DRIVER API: Handler Registration
+ * ======================================================================================
+ */
+
+/*
+ * gic_register_handler
+ * Installs 'handler' for 'irq_id'. Replaces any previous handler.
+ * The line is NOT enabled here; call gic_enable_irq() once the device is ready.
+ */
+int gic_register_handler(uint32_t irq_id, irq_handler_t handler, void *arg) {
+    if (irq_id >= MAX_IRQS || handler == NULL) {
+        return -1;
+    }
+
+    irq_table[irq_id].arg = arg;
+    irq_table[irq_id].handler = handler;
+    return 0;
+}
+
+void gic_unregister_handler(uint32_t irq_id) {
+    if (irq_id >= MAX_IRQS) {
+        return;
+    }
+
+    gic_disable_irq(irq_id);
+    irq_table[irq_id].handler = NULL;
+    irq_table[irq_id].arg = NULL;
+}
+
 /*
  * ======================================================================================
  * FUNCTION: gic_handle_irq (CRITICAL PATH)
@@ -177,19 +249,13 @@ void gic_handle_irq_c_handler(void) {
         return; // Noise on the line, ignore.
     }
 
-    /* 2. Dispatch Handling Logic */
-    /* In a real OS, we would look up a 'Handler Table' here. */
-    /* For HOCS, we check specific IDs manually. */
-    
-    // kprintf("[IRQ] Received Interrupt ID: %d\n", irq_id);
+    /* 2. Dispatch via Handler Table */
+    irq_desc_t *desc = &irq_table[irq_id];
 
-    /* Example: HOCS Optical Done Signal (Assume ID 120 from PL) */
-    if (irq_id == 120) {
-        // hocs_optical_isr(); 
-    }
-    /* Example: UART Receive Interrupt (ID 53 for UART0) */
-    else if (irq_id == 53) {
-        // uart_rx_isr();
+    if (desc->handler) {
+        desc->handler(irq_id, desc->arg);
+    } else {
+        irq_unhandled_count++;
     }
 
     /* 3. End of Interrupt (EOI) */
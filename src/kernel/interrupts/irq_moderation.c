@@ -0,0 +1,490 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        irq_moderation.c
+ * Module:      Adaptive Interrupt Moderation Implementation
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Every moderated source keeps a 1ms accounting window. At the end of each
+ * window the smoothed event rate is compared against thresholds derived from
+ * the measured IRQ cost:
+ *
+ *   high_eps = (CPU_BUDGET_PCT% of 1s) / irq_cost_ns
+ *   low_eps  = high_eps / 2
+ *
+ * Above high_eps the device IRQ is masked and the source is reaped from the
+ * TTC0 tick instead. Below low_eps it goes back to per-event interrupts.
+ * The gap between the two prevents flapping at the boundary.
+ * ======================================================================================
+ */
+
+#include "kernel/irq_moderation.h"
+#include "kernel/timer_heavy.h"
+#include "drivers/gic_v2.h"
+#include "drivers/ttc.h"
+#include "drivers/hocs.h"
+#include "drivers/hocs_model.h"
+#include "lib/kprintf.h"
+
+#define NS_PER_US               1000ULL
+#define NS_PER_MS               1000000ULL
+#define STORM_POLL_US           1000    // Tick rate while only storms are pending
+#define DEFAULT_IRQ_ENTRY_NS    600     // A53 @ 1.2GHz: vector + save_context + IAR/EOIR
+
+static irq_mod_env_t mod_env;
+static irq_mod_t *mod_list = NULL;
+static ttc_timer_t mod_ttc;
+
+/*
+ * ======================================================================================
+ * DEFAULT ENVIRONMENT (Generic Timer + TTC0)
+ * ======================================================================================
+ */
+
+static uint64_t default_now_ns(void) {
+    return timer_ticks_to_ns(timer_get_ticks());
+}
+
+static void default_tick_start(uint32_t period_us) {
+    ttc_start_periodic(&mod_ttc, period_us);
+}
+
+static void default_tick_stop(void) {
+    ttc_stop(&mod_ttc);
+}
+
+/*
+ * irq_mod_init
+ * NULL selects the hardware environment and hooks TTC0 as the poll tick.
+ */
+void irq_mod_init(const irq_mod_env_t *env) {
+    if (env) {
+        mod_env = *env;
+        return;
+    }
+
+    mod_env.now_ns = default_now_ns;
+    mod_env.tick_start = default_tick_start;
+    mod_env.tick_stop = default_tick_stop;
+    mod_env.irq_entry_ns = DEFAULT_IRQ_ENTRY_NS;
+    mod_env.attach_gic = 1;
+
+    ttc_init(&mod_ttc, ZYNQMP_TTC0_BASE, TTC0_IRQ_ID, irq_mod_tick, NULL);
+}
+
+/*
+ * ======================================================================================
+ * MODE CONTROL
+ * ======================================================================================
+ */
+
+/*
+ * mod_reschedule_tick
+ * Runs the shared tick at the fastest interval any source currently needs.
+ */
+static void mod_reschedule_tick(void) {
+    uint32_t period = 0;
+
+    for (irq_mod_t *m = mod_list; m; m = m->next) {
+        uint32_t need = 0;
+        if (m->mode == IRQ_MOD_BATCH_POLL) need = m->poll_interval_us;
+        if (m->mode == IRQ_MOD_STORM) need = STORM_POLL_US;
+        if (need && (period == 0 || need < period)) period = need;
+    }
+
+    if (period) {
+        mod_env.tick_start(period);
+    } else {
+        mod_env.tick_stop();
+    }
+}
+
+static void mod_set_mode(irq_mod_t *mod, irq_mod_mode_t mode, uint64_t now) {
+    if (mod->mode == mode) {
+        return;
+    }
+
+    switch (mode) {
+        case IRQ_MOD_BATCH_POLL:
+            mod->mask(mod->arg);
+            mod->next_poll_ns = now + mod->poll_interval_us * NS_PER_US;
+            break;
+
+        case IRQ_MOD_PER_EVENT:
+            if (mod->mode == IRQ_MOD_STORM && mod_env.attach_gic) {
+                gic_enable_irq(mod->irq_num);
+            }
+            mod->unmask(mod->arg);  // Pending events re-assert the line
+            break;
+
+        case IRQ_MOD_STORM:
+            mod->mask(mod->arg);
+            if (mod_env.attach_gic) {
+                gic_disable_irq(mod->irq_num);
+            }
+            mod->storm_rearm_ns = now + mod->storm_backoff_ms * NS_PER_MS;
+            mod->storms++;
+            kprintf("[IRQ-MOD] %s: interrupt storm on line %d, masked for %d ms\n",
+                    mod->name, mod->irq_num, mod->storm_backoff_ms);
+            if (mod->storm_backoff_ms < IRQ_MOD_STORM_BACKOFF_MAX) {
+                mod->storm_backoff_ms *= 2;
+            }
+            break;
+    }
+
+    mod->mode = mode;
+    mod->mode_switches++;
+    mod_reschedule_tick();
+}
+
+/*
+ * mod_window_close
+ * End-of-window evaluation: rate estimate, threshold tuning, transitions.
+ */
+static void mod_window_close(irq_mod_t *mod, uint64_t now) {
+    uint64_t elapsed = now - mod->window_start_ns;
+    uint32_t rate = (uint32_t)(((uint64_t)mod->window_events * 1000000000ULL) / elapsed);
+    uint64_t unclaimed_per_window = ((uint64_t)mod->window_unclaimed * IRQ_MOD_WINDOW_US * NS_PER_US) / elapsed;
+
+    /* 1. Smoothed rate (EWMA, alpha = 1/4) */
+    mod->rate_eps = (mod->rate_eps == 0) ? rate : (mod->rate_eps * 3 + rate) / 4;
+
+    /* 2. Threshold from measured IRQ cost */
+    uint64_t budget_ns = (1000000000ULL * IRQ_MOD_CPU_BUDGET_PCT) / 100;
+    uint32_t high = (uint32_t)(budget_ns / (mod->irq_cost_ns ? mod->irq_cost_ns : 1));
+    if (high < IRQ_MOD_MIN_THRESHOLD_EPS) high = IRQ_MOD_MIN_THRESHOLD_EPS;
+    mod->high_eps = high;
+    mod->low_eps = high / 2;
+
+    /* 3. Poll interval: target batch size, bounded by latency budget */
+    uint32_t interval = mod->rate_eps ? (uint32_t)((IRQ_MOD_TARGET_BATCH * 1000000ULL) / mod->rate_eps)
+                                      : mod->max_latency_us;
+    if (interval > mod->max_latency_us) interval = mod->max_latency_us;
+    if (interval < IRQ_MOD_MIN_POLL_US) interval = IRQ_MOD_MIN_POLL_US;
+
+    if (interval != mod->poll_interval_us) {
+        mod->poll_interval_us = interval;
+        if (mod->mode == IRQ_MOD_BATCH_POLL) mod_reschedule_tick();
+    }
+
+    /* 4. Transitions */
+    if (mod->mode != IRQ_MOD_STORM && unclaimed_per_window >= IRQ_MOD_STORM_UNCLAIMED) {
+        mod_set_mode(mod, IRQ_MOD_STORM, now);
+    } else if (!(mod->flags & IRQ_MOD_F_NO_BATCH)) {
+        if (mod->mode == IRQ_MOD_PER_EVENT && mod->rate_eps > mod->high_eps) {
+            mod_set_mode(mod, IRQ_MOD_BATCH_POLL, now);
+        } else if (mod->mode == IRQ_MOD_BATCH_POLL && mod->rate_eps < mod->low_eps) {
+            mod_set_mode(mod, IRQ_MOD_PER_EVENT, now);
+        }
+    }
+
+    /* 5. Quiet window after a storm: relax the back-off slowly */
+    if (mod->mode == IRQ_MOD_PER_EVENT && mod->window_unclaimed == 0 &&
+        mod->storm_backoff_ms > IRQ_MOD_STORM_BACKOFF_MS) {
+        mod->storm_backoff_ms /= 2;
+    }
+
+    /* 6. Open next window */
+    mod->window_start_ns = now;
+    mod->window_events = 0;
+    mod->window_irqs = 0;
+    mod->window_unclaimed = 0;
+}
+
+static void mod_account(irq_mod_t *mod, uint32_t n, uint64_t now) {
+    mod->window_events += n;
+    mod->events += n;
+
+    if (now - mod->window_start_ns >= IRQ_MOD_WINDOW_US * NS_PER_US) {
+        mod_window_close(mod, now);
+    }
+}
+
+/*
+ * ======================================================================================
+ * REGISTRATION
+ * ======================================================================================
+ */
+
+/*
+ * irq_mod_register
+ * Takes over the source's GIC line. The source starts in per-event mode.
+ */
+int irq_mod_register(irq_mod_t *mod) {
+    if (mod->poll == NULL || mod->mask == NULL || mod->unmask == NULL) {
+        return -1;
+    }
+
+    if (mod->max_latency_us == 0) mod->max_latency_us = 200;
+
+    mod->mode = IRQ_MOD_PER_EVENT;
+    mod->window_start_ns = mod_env.now_ns();
+    mod->window_events = 0;
+    mod->window_irqs = 0;
+    mod->window_unclaimed = 0;
+    mod->rate_eps = 0;
+    mod->irq_cost_ns = mod_env.irq_entry_ns * 2;
+    mod->high_eps = IRQ_MOD_MIN_THRESHOLD_EPS;
+    mod->low_eps = IRQ_MOD_MIN_THRESHOLD_EPS / 2;
+    mod->poll_interval_us = mod->max_latency_us;
+    mod->storm_backoff_ms = IRQ_MOD_STORM_BACKOFF_MS;
+    mod->irqs = mod->polls = mod->empty_polls = 0;
+    mod->events = mod->mode_switches = mod->storms = mod->cpu_ns = 0;
+
+    mod->next = mod_list;
+    mod_list = mod;
+
+    if (mod_env.attach_gic) {
+        gic_register_handler(mod->irq_num, irq_mod_isr, mod);
+        gic_enable_irq(mod->irq_num);
+    }
+    mod->unmask(mod->arg);
+
+    return 0;
+}
+
+void irq_mod_unregister(irq_mod_t *mod) {
+    irq_mod_t **pp = &mod_list;
+
+    while (*pp && *pp != mod) pp = &(*pp)->next;
+    if (*pp) *pp = mod->next;
+
+    if (mod_env.attach_gic) {
+        gic_unregister_handler(mod->irq_num);
+    }
+    mod_reschedule_tick();
+}
+
+/*
+ * ======================================================================================
+ * HOT PATHS
+ * ======================================================================================
+ */
+
+/*
+ * irq_mod_isr
+ * GIC dispatcher entry for moderated lines (per-event mode).
+ */
+void irq_mod_isr(uint32_t irq_id, void *arg) {
+    irq_mod_t *mod = (irq_mod_t *)arg;
+    uint64_t c0 = timer_get_ticks();
+    (void)irq_id;
+
+    uint32_t n = mod->poll(mod->arg, IRQ_MOD_POLL_BUDGET);
+
+    mod->irqs++;
+    mod->window_irqs++;
+    if (n == 0) mod->window_unclaimed++;
+
+    /* Handler time is always CNTPCT: the environment clock may be virtual */
+    uint32_t cost = (uint32_t)timer_ticks_to_ns(timer_get_ticks() - c0) + mod_env.irq_entry_ns;
+    mod->irq_cost_ns = (mod->irq_cost_ns * 7 + cost) / 8;
+    mod->cpu_ns += cost;
+
+    mod_account(mod, n, mod_env.now_ns());
+}
+
+/*
+ * irq_mod_tick
+ * Shared poll tick (TTC0). Reaps batch-mode sources and re-arms storms.
+ */
+void irq_mod_tick(uint32_t irq_id, void *arg) {
+    uint64_t now = mod_env.now_ns();
+    (void)irq_id;
+    (void)arg;
+
+    for (irq_mod_t *mod = mod_list; mod; mod = mod->next) {
+        if (mod->mode == IRQ_MOD_BATCH_POLL && now >= mod->next_poll_ns) {
+            uint64_t c0 = timer_get_ticks();
+            uint32_t total = 0;
+            uint32_t n;
+
+            do {
+                n = mod->poll(mod->arg, IRQ_MOD_POLL_BUDGET);
+                total += n;
+            } while (n == IRQ_MOD_POLL_BUDGET);
+
+            mod->polls++;
+            if (total == 0) mod->empty_polls++;
+
+            mod->cpu_ns += timer_ticks_to_ns(timer_get_ticks() - c0) + mod_env.irq_entry_ns;
+            mod->next_poll_ns = now + mod->poll_interval_us * NS_PER_US;
+
+            mod_account(mod, total, mod_env.now_ns());
+        } else if (mod->mode == IRQ_MOD_STORM && now >= mod->storm_rearm_ns) {
+            kprintf("[IRQ-MOD] %s: re-arming line %d\n", mod->name, mod->irq_num);
+            mod->window_start_ns = now;
+            mod->window_events = 0;
+            mod->window_irqs = 0;
+            mod->window_unclaimed = 0;
+            mod_set_mode(mod, IRQ_MOD_PER_EVENT, now);
+        }
+    }
+}
+
+/*
+ * irq_mod_dump_stats
+ */
+void irq_mod_dump_stats(void) {
+    static const char *mode_names[] = { "per-event", "batch-poll", "storm" };
+
+    kprintf("\n--- IRQ MODERATION ---\n");
+    for (irq_mod_t *m = mod_list; m; m = m->next) {
+        kprintf("%s (IRQ %d): mode=%s rate=%u ev/s thr=%u/%u poll=%u us\n",
+                m->name, m->irq_num, mode_names[m->mode],
+                m->rate_eps, m->high_eps, m->low_eps, m->poll_interval_us);
+        kprintf("  irqs=%u polls=%u empty=%u events=%u switches=%u storms=%u cost=%u ns\n",
+                (unsigned int)m->irqs, (unsigned int)m->polls, (unsigned int)m->empty_polls,
+                (unsigned int)m->events, (unsigned int)m->mode_switches,
+                (unsigned int)m->storms, m->irq_cost_ns);
+    }
+    kprintf("----------------------\n");
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK: CPU OVERHEAD vs EVENT RATE (HOCS MODEL, VIRTUAL TIME)
+ * ======================================================================================
+ * Drives the real HOCS driver and moderation code against the behavioral
+ * model on a virtual clock. Handler CPU time is measured with CNTPCT on the
+ * real core (this includes model MMIO emulation, so absolute numbers are
+ * pessimistic) plus the fixed exception entry cost per interrupt/tick.
+ */
+
+#define BENCH_DURATION_NS       (50 * NS_PER_MS)
+#define BENCH_DIM               8
+
+static uint32_t bench_tick_us;
+static uint64_t bench_next_tick;
+static hocs_job_t bench_jobs[HOCS_RING_ENTRIES];
+static uint64_t bench_submit_ns[HOCS_RING_ENTRIES];
+static float bench_buf[3 * BENCH_DIM * BENCH_DIM];
+static uint64_t bench_lat_sum;
+static uint64_t bench_lat_max;
+static uint64_t bench_done;
+
+static void bench_tick_start(uint32_t period_us) {
+    if (bench_tick_us != period_us) {
+        bench_tick_us = period_us;
+        bench_next_tick = hocs_bench.now + period_us * NS_PER_US;
+    }
+}
+
+static void bench_tick_stop(void) { bench_tick_us = 0; }
+
+static void bench_job_done(hocs_job_t *job, void *ctx) {
+    uint64_t lat = hocs_bench.now - bench_submit_ns[(uintptr_t)ctx];
+    (void)job;
+
+    bench_lat_sum += lat;
+    if (lat > bench_lat_max) bench_lat_max = lat;
+    bench_done++;
+}
+
+static void bench_run(uint32_t rate_eps, uint32_t flags) {
+    irq_mod_t mod = {
+        .name = "hocs-bench", .irq_num = HOCS_IRQ_ID, .flags = flags,
+        .max_latency_us = 200,
+        .poll = hocs_irq_poll, .mask = hocs_irq_mask, .unmask = hocs_irq_unmask,
+        .arg = &hocs_bench.dev[0]
+    };
+    uint64_t interarrival = 1000000000ULL / rate_eps;
+    uint64_t next_submit = 0;
+    uint32_t seq = 0;
+    uint32_t dropped = 0;
+
+    hocs_model_t *model = &hocs_bench.model[0];
+    hocs_device_t *dev = hocs_bench_init(0, "hocs-bench", hocs_bench_virtual_ns, 0);
+
+    bench_tick_us = 0;
+    bench_lat_sum = bench_lat_max = bench_done = 0;
+    irq_mod_register(&mod);
+
+    while (hocs_bench.now < BENCH_DURATION_NS) {
+        /* 1. Jump to the next event */
+        uint64_t t = next_submit;
+        if (model->busy && model->busy_until_ns < t) t = model->busy_until_ns;
+        if (bench_tick_us && bench_next_tick < t) t = bench_next_tick;
+        if (t > hocs_bench.now) hocs_bench.now = t;
+
+        /* 2. Arrivals */
+        if (hocs_bench.now >= next_submit) {
+            uint32_t slot = seq & (HOCS_RING_ENTRIES - 1);
+            hocs_job_t *job = &bench_jobs[slot];
+
+            if (job->state != HOCS_JOB_QUEUED) {
+                job->src_addr = (uint64_t)(uintptr_t)bench_buf;
+                job->dst_addr = (uint64_t)(uintptr_t)&bench_buf[2 * BENCH_DIM * BENCH_DIM];
+                job->matrix_dim = BENCH_DIM;
+                job->flags = 0;
+                job->done = bench_job_done;
+                job->ctx = (void *)(uintptr_t)slot;
+                bench_submit_ns[slot] = hocs_bench.now;
+                if (hocs_submit(dev, job) != HOCS_OK) dropped++;
+            } else {
+                dropped++;
+            }
+            seq++;
+            next_submit += interarrival;
+        }
+
+        /* 3. Poll tick */
+        if (bench_tick_us && hocs_bench.now >= bench_next_tick) {
+            irq_mod_tick(0, NULL);
+            bench_next_tick += bench_tick_us * NS_PER_US;
+        }
+
+        /* 4. Level-sensitive IRQ line */
+        hocs_model_advance(model);
+        if (model->regs[HOCS_IRQ_STATUS_OFFSET >> 2] & model->regs[HOCS_IRQ_ENABLE_OFFSET >> 2]) {
+            irq_mod_isr(HOCS_IRQ_ID, &mod);
+        }
+    }
+
+    /* cpu share in 1/100 percent */
+    uint32_t cpu_bp = (uint32_t)((mod.cpu_ns * 10000) / BENCH_DURATION_NS);
+    uint32_t avg_lat = bench_done ? (uint32_t)(bench_lat_sum / bench_done) : 0;
+
+    kprintf("%u ev/s %s: irqs=%u polls=%u cpu=%u.%u%% lat avg=%u ns max=%u ns drop=%u\n",
+            rate_eps, (flags & IRQ_MOD_F_NO_BATCH) ? "per-event" : "adaptive ",
+            (unsigned int)mod.irqs, (unsigned int)mod.polls,
+            cpu_bp / 100, cpu_bp % 100,
+            avg_lat, (unsigned int)bench_lat_max, dropped);
+
+    irq_mod_unregister(&mod);
+}
+
+/*
+ * irq_mod_benchmark
+ * Compares per-event interrupts against adaptive moderation at 10k-1M ev/s.
+ */
+void irq_mod_benchmark(void) {
+    static const uint32_t rates[] = { 10000, 50000, 100000, 250000, 500000, 1000000 };
+    irq_mod_env_t saved = mod_env;
+    irq_mod_env_t bench_env = {
+        .now_ns = hocs_bench_virtual_ns,
+        .tick_start = bench_tick_start,
+        .tick_stop = bench_tick_stop,
+        .irq_entry_ns = DEFAULT_IRQ_ENTRY_NS,
+        .attach_gic = 0
+    };
+
+    /* Keep real sources out of the virtual-time run */
+    irq_mod_t *saved_list = mod_list;
+    mod_list = NULL;
+    irq_mod_init(&bench_env);
+
+    kprintf("\n[IRQ-MOD] Benchmark: HOCS model, %d ms virtual per point\n",
+            (int)(BENCH_DURATION_NS / NS_PER_MS));
+
+    for (uint32_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        bench_run(rates[i], IRQ_MOD_F_NO_BATCH);
+        bench_run(rates[i], 0);
+    }
+
+    mod_list = saved_list;
+    mod_env = saved;
+}
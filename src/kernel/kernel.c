@@ -18,7 +18,30 @@
 #include "drivers/uart_ps.h"
 #include "drivers/gic_v2.h"
 #include "kernel/timer_heavy.h"
+#include "kernel/cpuidle.h"
+#include "kernel/irq_moderation.h"
+#include "kernel/hocs_link.h"
+#include "kernel/pstore.h"
+#include "kernel/trace.h"
+#include "kernel/bootprof.h"
+#include "kernel/smp.h"
+#include "kernel/memguard.h"
+#include "kernel/hyp.h"
+#include "drivers/hocs.h"
+#include "drivers/hocs_model.h"
+#include "drivers/hocs_cal.h"
+#include "drivers/hocs_stripe.h"
+#include "drivers/hocs_telemetry.h"
+#include "drivers/hocs_lincal.h"
+#include "drivers/csu.h"
+#include "drivers/csu_model.h"
+#include "drivers/sdhci.h"
+#include "drivers/sdhci_cache.h"
 #include "kernel/memory.h"      /* Placeholder for future MMU module */
+#include "mm/pmm.h"
+#include "mm/mem_detect.h"
+#include "mm/mmu.h"
+#include "mm/kmalloc.h"
 #include "lib/kprintf.h"
 #include "platform/zynqmp_hardware.h"
 
@@ -36,11 +59,87 @@
 #define KERNEL_VER  "v0.1.0-ALPHA"
 #define BUILD_DATE  "2026-02-14"
 
+/* Dump the boot timeline as Chrome trace JSON on the console */
+#define BOOTPROF_CHROME_JSON    1
+
+/* Wake-up latency budget of the photonic control loop */
+#define HOCS_LOOP_MAX_WAKE_US   50
+
+static cpuidle_latency_req_t hocs_loop_qos;
+
+/*
+ * HOCS Backend
+ * QEMU has no PL fabric; route the driver to the behavioral model there.
+ * Set to 0 when booting on the KV260 with the HOCS bitstream loaded.
+ */
+#define HOCS_USE_MODEL          1
+
+static hocs_model_t hocs0_model;
+static hocs_model_t hocs1_model;
+
+/*
+ * CSU Crypto Backend
+ * QEMU does not emulate the CSU SHA3/AES engines either.
+ */
+#define CSU_USE_MODEL           1
+
+static csu_model_t csu0_model;
+
+/* Per-job latency records (~66KB each) */
+static hocs_telem_t hocs0_telem;
+static hocs_telem_t hocs1_telem;
+
+/* Result linearity tables, recalibrated on thermal drift */
+static hocs_lincal_t hocs0_lincal;
+static hocs_lincal_t hocs1_lincal;
+
+/* HOCS completion moderation (batch-polls above a few tens of k jobs/s) */
+static irq_mod_t hocs0_irq_mod = {
+    .name           = "hocs0",
+    .irq_num        = HOCS_IRQ_ID,
+    .max_latency_us = 100,
+    .poll           = hocs_irq_poll,
+    .mask           = hocs_irq_mask,
+    .unmask         = hocs_irq_unmask,
+    .arg            = &hocs0
+};
+
+static irq_mod_t hocs1_irq_mod = {
+    .name           = "hocs1",
+    .irq_num        = HOCS1_IRQ_ID,
+    .max_latency_us = 100,
+    .poll           = hocs_irq_poll,
+    .mask           = hocs_irq_mask,
+    .unmask         = hocs_irq_unmask,
+    .arg            = &hocs1
+};
+
+/* Both AXI HPC ports, for bulk work */
+static hocs_device_t *const hocs_ports[] = { &hocs0, &hocs1 };
+static hocs_stripe_t hocs_stripe0;
+
+/* Host command channel (binary job frames over UART0) */
+static hocs_link_t hocs_link0;
+
+/* Block cache in front of the SD card slot (~560KB with its slots) */
+static sdhci_cache_t sdhci1_cache;
+
+/* Linker symbols (end of image / boot stacks) and discovery result */
+extern char _bss_end[], _stack_top[];
+static mem_source_t mem_source;
+
+static uint64_t hocs_model_clock_ns(void) {
+    return timer_ticks_to_ns(timer_get_ticks());
+}
+
 /*
  * panic
  * Critical failure handler. Stops the system and dumps registers.
  */
 void panic(const char *reason) {
+    /* Record first: the console may be what is broken */
+    pstore_panic(reason);
+
     kprintf("\n" K_RED K_BOLD "[KERNEL PANIC] SYSTEM HALTED: %s" K_RESET "\n", reason);
     kprintf(K_RED "CPU Core 0 Frozen. Please reset hardware via JTAG." K_RESET "\n");
     
@@ -49,6 +148,17 @@ void panic(const char *reason) {
     }
 }
 
+/*
+ * kernel_sync_abort
+ * Called from the EL1 synchronous exception vector with the fault syndrome.
+ */
+void kernel_sync_abort(uint64_t esr, uint64_t elr, uint64_t far) {
+    trace_emit(TRACE_EV_SYNC_ABORT, (uint32_t)esr, elr, far);
+    kprintf("\n" K_RED "[ABORT] ESR=0x%x ELR=%p FAR=%p" K_RESET "\n",
+            (unsigned int)esr, (void *)elr, (void *)far);
+    panic("Synchronous Abort");
+}
+
 /*
  * boot_logo
  * Displays the ASCII art logo of PhotonX.
@@ -70,6 +180,36 @@ void boot_logo(void) {
  * ======================================================================================
  */
 
+/*
+ * memory_init
+ * Registers installed DDR with the page allocator, carves out what must
+ * never be handed out, then builds the identity map (1GB blocks for high
+ * DDR) and turns on the MMU and caches.
+ */
+static void memory_init(void) {
+    uint64_t bss_end = (uint64_t)(uintptr_t)_bss_end;
+    uint64_t stack_top = (uint64_t)(uintptr_t)_stack_top;
+    uint64_t image_end = (stack_top > bss_end) ? stack_top : bss_end;
+
+    pmm_init();
+    mem_source = mem_detect((const void *)(uintptr_t)boot_dtb_addr);
+
+    /* Vectors, image and boot stacks from 0, and the persistent block */
+    pmm_reserve(ZYNQMP_DDR_LOW_BASE, image_end - ZYNQMP_DDR_LOW_BASE);
+    pmm_reserve(ZYNQMP_PERSIST_BASE, ZYNQMP_PERSIST_SIZE);
+
+    mmu_create_identity_map();
+    mmu_map_high_memory();
+
+    /* Caches only work for Normal memory, i.e. with the MMU on */
+    mmu_init_mair();
+    mmu_init_tcr();
+    mmu_enable();
+
+    kheap_init(KHEAP_DEFAULT_SIZE);
+    pmm_dump();
+}
+
 /*
  * probe_hardware
  * Scans the AXI Bus to detect FPGA peripherals.
@@ -77,12 +217,14 @@ void boot_logo(void) {
 void probe_hardware(void) {
     kprintf(K_BLUE "[HW] Probing System Bus..." K_RESET "\n");
     
-    /* 1. Check RAM Size */
-    // Placeholder logic - In real HW we read DDR Controller registers
-    kprintf("  > DDR4 SDRAM: " K_GREEN "2048 MB DETECTED" K_RESET "\n");
+    /* 1. Check RAM Size (discovered by memory_init) */
+    kprintf("  > DDR4 SDRAM: " K_GREEN "%lu MB DETECTED" K_RESET " (low %lu MB, high %lu MB, via %s)\n",
+            pmm_total_present() >> 20, pmm_zone(PMM_ZONE_LOW)->present >> 20,
+            pmm_zone(PMM_ZONE_HIGH)->present >> 20, mem_source_name(mem_source));
 
     /* 2. Check UART */
     kprintf("  > UART Controller: " K_GREEN "Cadence PS UART (115200 Baud)" K_RESET "\n");
+    kprintf("  > Data Link: " K_GREEN "Cadence PS UART0 (%u Baud, binary)" K_RESET "\n", data_uart.baud_rate);
 
     /* 3. Check GIC */
     kprintf("  > Interrupt Controller: " K_GREEN "ARM GIC-400 (Distributor Active)" K_RESET "\n");
@@ -102,18 +244,19 @@ void probe_hardware(void) {
 
 /*
  * calibrate_lasers
- * Simulates the thermal calibration sequence of VCSEL arrays.
+ * Restores the stored VCSEL calibration on a warm boot, or runs the full
+ * thermal/phase/power calibration (and stores it) otherwise.
  */
 void calibrate_lasers(void) {
-    kprintf(K_BLUE "[HOCS] Starting Laser Calibration Sequence..." K_RESET "\n");
-    
-    for(int i=0; i<4; i++) {
-        kprintf("  > Channel Group %d: " K_YELLOW "Warming Up (%d C)..." K_RESET "\r", i, 25+(i*5));
-        mdelay(150);
-        kprintf("  > Channel Group %d: " K_GREEN "STABLE (45 C)     " K_RESET "\n", i);
+    hocs_cal_result_t res;
+
+    if (hocs_cal_boot(&hocs0, &res) != HOCS_OK) {
+        kprintf("[HOCS] " K_RED "Calibration incomplete (%s)" K_RESET "\n", res.reason);
+        return;
     }
-    
-    kprintf("[HOCS] " K_GREEN "All 144 VCSEL Channels Ready." K_RESET "\n");
+
+    kprintf("[HOCS] " K_GREEN "%s calibration OK" K_RESET "\n",
+            (res.path == HOCS_CAL_PATH_WARM) ? "Warm" : "Full");
 }
 /*
  * ======================================================================================
@@ -124,9 +267,20 @@ void calibrate_lasers(void) {
  */
 
 void kernel_main(void) {
+    int bp;
+
+    /* 0. Boot profiler (imports startup.S stamps), then the crash log */
+    bootprof_init();
+
+    bp = bootprof_begin("pstore_init");
+    pstore_init();
+    bootprof_end(bp);
+
     /* 1. Initialize Core Drivers */
     /* UART is already init in bootloader/early_init, but we re-init for safety */
+    bp = bootprof_begin("uart_init");
     uart_init_controller();
+    bootprof_end(bp);
     
     /* Clear Screen */
     uart_send_string("\033[2J\033[H");
@@ -136,27 +290,126 @@ void kernel_main(void) {
     
     kprintf("[KERNEL] Booting " K_BOLD "%s %s" K_RESET "...\n", KERNEL_NAME, KERNEL_VER);
 
+    /* Previous run's last words (warm reset after panic/hang) */
+    bp = bootprof_begin("pstore_dump");
+    pstore_dump_previous();
+    bootprof_end(bp);
+
+    /* 1b. Physical Memory (DTB / DDR controller discovery) */
+    bp = bootprof_begin("memory_init");
+    memory_init();
+    bootprof_end(bp);
+
     /* 2. Initialize Interrupt Subsystem */
     kprintf("[KERNEL] Initializing GICv2..." K_RESET);
+    bp = bootprof_begin("gic_init");
     gic_init();
+    bootprof_end(bp);
     kprintf(K_GREEN " [OK]" K_RESET "\n");
 
     /* 3. Initialize High-Resolution Timer */
     kprintf("[KERNEL] Calibrating ARMv8 Generic Timer..." K_RESET);
+    bp = bootprof_begin("timer_core_init");
     timer_core_init();
+    bootprof_end(bp);
     kprintf(K_GREEN " [OK] (%lu Hz)" K_RESET "\n", 100000000UL); // Hardcoded for display
 
+    /* 3b. Idle Governor (PSCI via ATF, or QEMU's built-in emulation) */
+    bp = bootprof_begin("cpuidle_init");
+    cpuidle_init(PSCI_CONDUIT_SMC);
+    cpuidle_latency_req_add(&hocs_loop_qos, "hocs_loop", HOCS_LOOP_MAX_WAKE_US);
+    bootprof_end(bp);
+
+#if HYP_PARTITIONED
+    /* 3c. Hand the guest its cores before PhotonX starts the rest */
+    bp = bootprof_begin("hyp_init");
+    hyp_init(&HYP_GUEST_CFG);
+    bootprof_end(bp);
+#endif
+
+    /* 3d. Secondary cores (best-effort work), bandwidth-capped to protect core 0 */
+    bp = bootprof_begin("smp_init");
+    smp_init();
+    memguard_init(PMU_EV_L2D_CACHE_REFILL, MEMGUARD_DEFAULT_BUDGET);
+    bootprof_end(bp);
+
     /* 4. Probe Hardware */
+    bp = bootprof_begin("hocs_probe");
     probe_hardware();
+    bootprof_end(bp);
+
+    /* 4a. CSU crypto engines, known-answer tested before they verify anything */
+    bp = bootprof_begin("csu_init");
+#if CSU_USE_MODEL
+    csu_model_init(&csu0_model, hocs_model_clock_ns);
+    csu_init(&csu0, ZYNQMP_CSU_BASE, ZYNQMP_CSU_DMA_BASE, &csu0_model);
+#else
+    csu_init(&csu0, ZYNQMP_CSU_BASE, ZYNQMP_CSU_DMA_BASE, NULL);
+#endif
+    if (csu_selftest(&csu0) != CSU_OK) {
+        csu_init(&csu0, 0, 0, NULL);        // Software from here on
+    }
+    bootprof_end(bp);
 
     /* 5. Start HOCS Optical Engine */
+    bp = bootprof_begin("hocs_init");
+#if HOCS_USE_MODEL
+    hocs_model_init(&hocs0_model, hocs_model_clock_ns);
+    hocs0_model.raise_irq = hocs_model_raise_gic;
+    hocs0_model.irq_arg = (void *)(uintptr_t)HOCS_IRQ_ID;
+    hocs_init(&hocs0, HOCS_AXI_BASE, HOCS_IRQ_ID, &hocs0_model);
+    hocs_model_init(&hocs1_model, hocs_model_clock_ns);
+    hocs1_model.raise_irq = hocs_model_raise_gic;
+    hocs1_model.irq_arg = (void *)(uintptr_t)HOCS1_IRQ_ID;
+    hocs_init(&hocs1, HOCS1_AXI_BASE, HOCS1_IRQ_ID, &hocs1_model);
+#else
+    hocs_init(&hocs0, HOCS_AXI_BASE, HOCS_IRQ_ID, NULL);
+    hocs_init(&hocs1, HOCS1_AXI_BASE, HOCS1_IRQ_ID, NULL);
+#endif
+    hocs_telemetry_attach(&hocs0, &hocs0_telem);
+    hocs_telemetry_attach(&hocs1, &hocs1_telem);
+    irq_mod_init(NULL);
+    irq_mod_register(&hocs0_irq_mod);
+    irq_mod_register(&hocs1_irq_mod);
+    hocs_stripe_init(&hocs_stripe0, hocs_ports, 2);
+    bootprof_end(bp);
+
+    /* Calibration talks to the IP through hocs0, so it follows hocs_init */
+    bp = bootprof_begin("laser_calibration");
     calibrate_lasers();
+    hocs_lincal_attach(&hocs0, &hocs0_lincal);
+    hocs_lincal_attach(&hocs1, &hocs1_lincal);
+    bootprof_end(bp);
+
+    /* 5b. Host Data Link (UART0, interrupt-driven) */
+    bp = bootprof_begin("data_link_init");
+    uart_dev_init(&data_uart);
+    hocs_link_init(&hocs_link0, &data_uart, &hocs0);
+    bootprof_end(bp);
+
+    /* 5c. SD Card (SD1 is the card slot on ZCU102/KV260; QEMU: -drive if=sd,index=1) */
+    bp = bootprof_begin("sdhci_init");
+    if (sdhci_init(&sdhci1, ZYNQMP_SD1_BASE, SD1_IRQ_ID) == SDHCI_OK) {
+        sdhci_cache_init(&sdhci1_cache, &sdhci1);
+    }
+    bootprof_end(bp);
 
     /* 6. Enable Interrupts Globally */
     kprintf("[KERNEL] Enabling IRQs (PSTATE.I = 0)..." K_RESET);
     asm volatile("msr daifclr, #2"); // Unmask IRQ
     kprintf(K_GREEN " [OK]" K_RESET "\n");
 
+#if HYP_PARTITIONED && HYP_GUEST_AUTOSTART
+    /* 6a. Guest partition (no-op if hyp_init failed) */
+    hyp_guest_start();
+#endif
+
+    /* 6b. Where did boot time go? */
+    bootprof_report();
+#if BOOTPROF_CHROME_JSON
+    bootprof_export_chrome();
+#endif
+
     kprintf("\n" K_BOLD "System Ready. Jumping to User Space Shell." K_RESET "\n");
     kprintf("------------------------------------------------------------\n");
 
@@ -180,9 +433,16 @@ void kernel_main(void) {
             // gpio_toggle(LED_PIN);
         }
 
+        /* Serve host job frames / stream back finished results */
+        hocs_link_poll(&hocs_link0);
+
+        /* Readout linearity: first calibration, then on thermal drift */
+        hocs_lincal_service(&hocs0_lincal);
+        hocs_lincal_service(&hocs1_lincal);
+
         /* * Put CPU to sleep until next interrupt 
-         * This saves power and lowers temperature.
+         * The governor picks WFI or a PSCI state within the latency budget.
          */
-        asm volatile("wfi"); 
+        cpuidle_enter();
     }
 }
@@ -0,0 +1,387 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        src/kernel/power/cpuidle.c
+ * Module:      CPU Idle Framework & Latency-Aware Governor
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC (Cortex-A53)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Replaces the bare 'wfi' in the idle loop with a governed choice between
+ * WFI, PSCI core retention, core powerdown and cluster powerdown.
+ *
+ * PREDICTION:
+ * 1. Start from the time until the next armed CNTP event.
+ * 2. Scale it by a per-bucket correction factor learned from how often we
+ *    actually get woken early (by device IRQs) for timers of that length.
+ * 3. If the last CPUIDLE_HISTORY_LEN intervals were stable, use their
+ *    average when it is shorter (catches periodic device wake-ups).
+ *
+ * All arithmetic is integer; the governor runs with IRQs masked.
+ * ======================================================================================
+ */
+
+#include "kernel/cpuidle.h"
+#include "kernel/timer_heavy.h"
+#include "lib/kprintf.h"
+
+/* Governor Tuning */
+#define CORR_RESOLUTION         1024
+#define CORR_DECAY              8
+#define CORR_UNITY              (CORR_RESOLUTION * CORR_DECAY)
+#define REJECT_LIMIT            4       // Consecutive PSCI failures before disabling
+#define NO_TIMER_US             0xFFFFFFFFU
+
+/*
+ * Idle State Table (shallow -> deep)
+ * Latencies are measured worst cases on KV260 with ATF v2.6 and include the
+ * context save/restore path in cpu_suspend.S.
+ */
+static cpuidle_state_t idle_states[CPUIDLE_MAX_STATES] = {
+    { .name = "WFI",         .exit_latency_us = 1,   .target_residency_us = 1,
+      .psci_state = 0,                          .flags = CPUIDLE_FLAG_WFI  },
+    { .name = "CORE-RET",    .exit_latency_us = 10,  .target_residency_us = 40,
+      .psci_state = PSCI_STATE_CORE_RETENTION,  .flags = CPUIDLE_FLAG_PSCI },
+    { .name = "CORE-OFF",    .exit_latency_us = 250, .target_residency_us = 1500,
+      .psci_state = PSCI_STATE_CORE_OFF,        .flags = CPUIDLE_FLAG_PSCI },
+    { .name = "CLUSTER-OFF", .exit_latency_us = 800, .target_residency_us = 5000,
+      .psci_state = PSCI_STATE_CLUSTER_OFF,     .flags = CPUIDLE_FLAG_PSCI },
+};
+
+/* Governor State */
+static struct {
+    uint32_t correction[CPUIDLE_BUCKETS];
+    uint32_t history[CPUIDLE_HISTORY_LEN];
+    uint32_t history_idx;
+    uint32_t reject_streak[CPUIDLE_MAX_STATES];
+    uint8_t  initialized;
+} gov;
+
+/* Latency Constraints */
+static cpuidle_latency_req_t *latency_reqs[CPUIDLE_MAX_LATENCY_REQS];
+
+/*
+ * ======================================================================================
+ * LATENCY CONSTRAINTS (QoS)
+ * ======================================================================================
+ */
+
+int cpuidle_latency_req_add(cpuidle_latency_req_t *req, const char *owner, uint32_t max_latency_us) {
+    for (int i = 0; i < CPUIDLE_MAX_LATENCY_REQS; i++) {
+        if (latency_reqs[i] == NULL) {
+            req->owner = owner;
+            req->max_latency_us = max_latency_us;
+            req->active = 1;
+            latency_reqs[i] = req;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+void cpuidle_latency_req_update(cpuidle_latency_req_t *req, uint32_t max_latency_us) {
+    req->max_latency_us = max_latency_us;
+}
+
+void cpuidle_latency_req_remove(cpuidle_latency_req_t *req) {
+    for (int i = 0; i < CPUIDLE_MAX_LATENCY_REQS; i++) {
+        if (latency_reqs[i] == req) {
+            latency_reqs[i] = NULL;
+            req->active = 0;
+            return;
+        }
+    }
+}
+
+/*
+ * cpuidle_latency_limit_us
+ * Returns the tightest active wake-up latency constraint.
+ */
+uint32_t cpuidle_latency_limit_us(void) {
+    uint32_t limit = CPUIDLE_LATENCY_NONE;
+
+    for (int i = 0; i < CPUIDLE_MAX_LATENCY_REQS; i++) {
+        if (latency_reqs[i] && latency_reqs[i]->active &&
+            latency_reqs[i]->max_latency_us < limit) {
+            limit = latency_reqs[i]->max_latency_us;
+        }
+    }
+    return limit;
+}
+
+/*
+ * ======================================================================================
+ * GOVERNOR: PREDICTION
+ * ======================================================================================
+ */
+
+/*
+ * gov_bucket
+ * Groups timer distances by decade: <10us, <100us, ... , >=100ms.
+ */
+static uint32_t gov_bucket(uint32_t next_us) {
+    uint32_t bucket = 0;
+    uint32_t limit = 10;
+
+    while (bucket < CPUIDLE_BUCKETS - 1 && next_us >= limit) {
+        limit *= 10;
+        bucket++;
+    }
+    return bucket;
+}
+
+/*
+ * gov_typical_interval
+ * Returns the average of recent idle intervals if they are consistent
+ * (stddev below 1/6 of the mean), or 0 if no pattern is visible.
+ * Up to two outliers (largest samples) are discarded.
+ */
+static uint32_t gov_typical_interval(void) {
+    uint32_t threshold = 0xFFFFFFFFU;
+
+    for (int pass = 0; pass < 3; pass++) {
+        uint64_t sum = 0;
+        uint64_t sq_sum = 0;
+        uint32_t max = 0;
+        uint32_t n = 0;
+
+        for (int i = 0; i < CPUIDLE_HISTORY_LEN; i++) {
+            uint32_t v = gov.history[i];
+            if (v == 0 || v > threshold) continue;
+            sum += v;
+            sq_sum += (uint64_t)v * v;
+            if (v > max) max = v;
+            n++;
+        }
+
+        if (n < CPUIDLE_HISTORY_LEN / 2) {
+            return 0;
+        }
+
+        uint64_t avg = sum / n;
+        uint64_t variance = (sq_sum / n) - (avg * avg);
+
+        if ((avg * avg) > (36 * variance) || variance <= 400) {
+            return (uint32_t)avg;
+        }
+
+        /* Drop the largest sample and retry */
+        threshold = max - 1;
+    }
+    return 0;
+}
+
+/*
+ * gov_predict
+ * Combines the next timer event with learned correction and history.
+ */
+static uint32_t gov_predict(uint32_t next_us, uint32_t bucket) {
+    uint64_t predicted = ((uint64_t)next_us * gov.correction[bucket]) / CORR_UNITY;
+    uint32_t typical = gov_typical_interval();
+
+    if (typical && typical < predicted) {
+        predicted = typical;
+    }
+    return (uint32_t)predicted;
+}
+
+/*
+ * gov_select
+ * Picks the deepest usable state for the predicted idle time.
+ */
+static int gov_select(uint32_t predicted_us, uint32_t latency_limit_us) {
+    int selected = 0; // WFI is always available
+
+    for (int i = 1; i < CPUIDLE_MAX_STATES; i++) {
+        cpuidle_state_t *s = &idle_states[i];
+
+        if (s->flags & CPUIDLE_FLAG_DISABLED) continue;
+        if (s->exit_latency_us > latency_limit_us) break;
+        if (s->target_residency_us > predicted_us) break;
+
+        selected = i;
+    }
+    return selected;
+}
+
+/*
+ * gov_reflect
+ * Post-wake bookkeeping: statistics, correction factor and history.
+ */
+static void gov_reflect(int idx, uint32_t measured_us, uint32_t next_us,
+                        uint32_t bucket, uint32_t latency_limit_us) {
+    cpuidle_state_t *s = &idle_states[idx];
+
+    /* 1. Discount the exit latency so it does not inflate the sample */
+    if (measured_us > s->exit_latency_us) {
+        measured_us -= s->exit_latency_us;
+    }
+
+    /* 2. Per-state accounting */
+    s->usage++;
+    s->residency_us += measured_us;
+
+    if (measured_us < s->target_residency_us) {
+        s->above++;
+    } else {
+        for (int i = idx + 1; i < CPUIDLE_MAX_STATES; i++) {
+            cpuidle_state_t *d = &idle_states[i];
+            if (d->flags & CPUIDLE_FLAG_DISABLED) continue;
+            if (d->exit_latency_us > latency_limit_us) break;
+            if (d->target_residency_us <= measured_us) {
+                s->below++;
+                break;
+            }
+        }
+    }
+
+    /* 3. Correction factor: exponential decay towards measured/next ratio */
+    if (next_us != NO_TIMER_US && next_us > 0) {
+        uint32_t factor = gov.correction[bucket];
+        factor -= factor / CORR_DECAY;
+
+        if (measured_us < next_us) {
+            factor += (uint32_t)(((uint64_t)CORR_RESOLUTION * measured_us) / next_us);
+        } else {
+            factor += CORR_RESOLUTION;
+        }
+
+        /* Never let the factor collapse to zero (would pin us in WFI) */
+        if (factor == 0) factor = 1;
+        gov.correction[bucket] = factor;
+    }
+
+    /* 4. History ring */
+    gov.history[gov.history_idx] = measured_us;
+    gov.history_idx = (gov.history_idx + 1) % CPUIDLE_HISTORY_LEN;
+}
+
+/*
+ * ======================================================================================
+ * STATE ENTRY
+ * ======================================================================================
+ */
+
+static int state_enter(int idx) {
+    cpuidle_state_t *s = &idle_states[idx];
+
+    if (s->flags & CPUIDLE_FLAG_WFI) {
+        asm volatile("dsb sy");
+        asm volatile("wfi");
+        return 0;
+    }
+
+    int ret = psci_cpu_suspend(s->psci_state);
+    if (ret != PSCI_RET_SUCCESS) {
+        /* Firmware refused (e.g. cluster still has awake cores). Fall back. */
+        s->rejected++;
+        if (++gov.reject_streak[idx] >= REJECT_LIMIT) {
+            s->flags |= CPUIDLE_FLAG_DISABLED;
+            kprintf("[IDLE] State %s disabled (PSCI error %d)\n", s->name, ret);
+        }
+        asm volatile("dsb sy");
+        asm volatile("wfi");
+        return 0;
+    }
+
+    gov.reject_streak[idx] = 0;
+    return idx;
+}
+
+/*
+ * ======================================================================================
+ * PUBLIC API
+ * ======================================================================================
+ */
+
+/*
+ * cpuidle_init
+ * Must be called after timer_core_init(). Deep states are disabled when
+ * no PSCI firmware answers, leaving plain WFI.
+ */
+void cpuidle_init(psci_conduit_t conduit) {
+    for (int i = 0; i < CPUIDLE_BUCKETS; i++) {
+        gov.correction[i] = CORR_UNITY;
+    }
+
+    if (conduit == PSCI_CONDUIT_NONE || psci_init(conduit) != PSCI_RET_SUCCESS) {
+        for (int i = 0; i < CPUIDLE_MAX_STATES; i++) {
+            if (idle_states[i].flags & CPUIDLE_FLAG_PSCI) {
+                idle_states[i].flags |= CPUIDLE_FLAG_DISABLED;
+            }
+        }
+    }
+
+    gov.initialized = 1;
+}
+
+/*
+ * cpuidle_enter
+ * Idle the calling core once. Returns after the wake-up interrupt has
+ * been taken, or with it still pending if the caller had IRQs masked
+ * (the mask is restored as found). Safe to call in a loop from the idle
+ * task.
+ */
+void cpuidle_enter(void) {
+    uint64_t daif;
+
+    if (!gov.initialized) {
+        asm volatile("wfi");
+        return;
+    }
+
+    /* 1. Mask IRQs: a pending interrupt still wakes WFI/PSCI, but its
+     *    handler runs only after the bookkeeping below. */
+    asm volatile("mrs %0, daif; msr daifset, #2" : "=r" (daif) :: "memory");
+
+    /* 2. Predict */
+    uint64_t next_ns = timer_get_next_event_ns();
+    uint32_t next_us = (next_ns == UINT64_MAX || next_ns / 1000 >= NO_TIMER_US)
+                       ? NO_TIMER_US : (uint32_t)(next_ns / 1000);
+    uint32_t bucket = gov_bucket(next_us);
+    uint32_t predicted_us = gov_predict(next_us, bucket);
+    uint32_t limit_us = cpuidle_latency_limit_us();
+
+    /* 3. Select & enter */
+    int idx = gov_select(predicted_us, limit_us);
+    uint64_t t0 = timer_get_ticks();
+    idx = state_enter(idx);
+    uint64_t t1 = timer_get_ticks();
+
+    /* 4. Learn */
+    uint64_t measured = timer_ticks_to_us(t1 - t0);
+    gov_reflect(idx, (measured > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : (uint32_t)measured,
+                next_us, bucket, limit_us);
+
+    /* 5. Let the wake-up interrupt in, unless the caller had it masked */
+    asm volatile("msr daif, %0" :: "r" (daif) : "memory");
+}
+
+/*
+ * cpuidle_dump_stats
+ * Prints per-state residency and miss counters.
+ */
+void cpuidle_dump_stats(void) {
+    uint32_t limit = cpuidle_latency_limit_us();
+
+    kprintf("\n--- CPUIDLE STATISTICS ---\n");
+    if (limit == CPUIDLE_LATENCY_NONE) {
+        kprintf("Latency limit: none\n");
+    } else {
+        kprintf("Latency limit: %u us\n", limit);
+    }
+
+    for (int i = 0; i < CPUIDLE_MAX_STATES; i++) {
+        cpuidle_state_t *s = &idle_states[i];
+        kprintf("%s%s: usage=%u time=%u ms above=%u below=%u rejected=%u\n",
+                s->name,
+                (s->flags & CPUIDLE_FLAG_DISABLED) ? " (off)" : "",
+                (unsigned int)s->usage,
+                (unsigned int)(s->residency_us / 1000),
+                (unsigned int)s->above,
+                (unsigned int)s->below,
+                (unsigned int)s->rejected);
+    }
+    kprintf("--------------------------\n");
+}
@@ -0,0 +1,97 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        src/kernel/power/psci.c
+ * Module:      PSCI Client Implementation
+ * Platform:    Xilinx Zynq UltraScale+ MPSoC
+ *
+ * DESCRIPTION:
+ * Thin wrapper around the SMC/HVC firmware calls. All arguments follow the
+ * SMC Calling Convention: function ID in W0, parameters in X1-X3, result in X0.
+ * ======================================================================================
+ */
+
+#include "kernel/psci.h"
+#include "lib/kprintf.h"
+
+/* Active Conduit (NONE until psci_init succeeds) */
+static psci_conduit_t psci_conduit = PSCI_CONDUIT_NONE;
+
+/*
+ * psci_call
+ * Issues a PSCI call through the configured conduit.
+ * Returns PSCI_RET_NOT_SUPPORTED if no firmware interface is available.
+ */
+int64_t psci_call(uint32_t fn, uint64_t a1, uint64_t a2, uint64_t a3) {
+    register uint64_t x0 asm("x0") = fn;
+    register uint64_t x1 asm("x1") = a1;
+    register uint64_t x2 asm("x2") = a2;
+    register uint64_t x3 asm("x3") = a3;
+
+    if (psci_conduit == PSCI_CONDUIT_SMC) {
+        asm volatile("smc #0"
+                     : "+r" (x0)
+                     : "r" (x1), "r" (x2), "r" (x3)
+                     : "memory");
+    } else if (psci_conduit == PSCI_CONDUIT_HVC) {
+        asm volatile("hvc #0"
+                     : "+r" (x0)
+                     : "r" (x1), "r" (x2), "r" (x3)
+                     : "memory");
+    } else {
+        return PSCI_RET_NOT_SUPPORTED;
+    }
+
+    return (int64_t)x0;
+}
+
+/*
+ * psci_init
+ * Selects the conduit and verifies that firmware answers PSCI_VERSION.
+ */
+int psci_init(psci_conduit_t conduit) {
+    psci_conduit = conduit;
+
+    uint32_t ver = psci_get_version();
+    if (ver == (uint32_t)PSCI_RET_NOT_SUPPORTED) {
+        psci_conduit = PSCI_CONDUIT_NONE;
+        kprintf("[PSCI] No firmware interface. Deep idle states disabled.\n");
+        return PSCI_RET_NOT_SUPPORTED;
+    }
+
+    kprintf("[PSCI] Firmware v%d.%d (%s conduit)\n",
+            ver >> 16, ver & 0xFFFF,
+            (conduit == PSCI_CONDUIT_SMC) ? "SMC" : "HVC");
+    return PSCI_RET_SUCCESS;
+}
+
+uint32_t psci_get_version(void) {
+    return (uint32_t)psci_call(PSCI_FN_VERSION, 0, 0, 0);
+}
+
+/*
+ * psci_cpu_suspend
+ * Standby states return straight from firmware with context intact.
+ * Powerdown states lose the register file, so they go through the assembly
+ * save/restore path which registers cpu_resume as the warm entry point.
+ */
+int psci_cpu_suspend(uint32_t power_state) {
+    if (psci_conduit == PSCI_CONDUIT_NONE) {
+        return PSCI_RET_NOT_SUPPORTED;
+    }
+
+    if (power_state & PSCI_STATE_TYPE_POWERDOWN) {
+        return cpu_suspend_enter(power_state);
+    }
+
+    return (int)psci_call(PSCI_FN_CPU_SUSPEND, power_state, 0, 0);
+}
+
+/*
+ * psci_cpu_on
+ * Powers up a secondary core at 'entry' (physical address).
+ */
+int psci_cpu_on(uint64_t mpidr, uint64_t entry, uint64_t context_id) {
+    return (int)psci_call(PSCI_FN_CPU_ON, mpidr, entry, context_id);
+}
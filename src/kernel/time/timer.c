@@ -213,6 +213,50 @@ uint64_t timer_get_uptime_ns(void) {
 uint64_t timer_get_boot_ticks(void) {
     return sys_uptime.boot_timestamp;
 }
+
+/*
+ * timer_get_ticks
+ * Returns the raw physical counter (CNTPCT_EL0).
+ * Cheaper than timer_get_uptime_ns(): no conversion, no global update.
+ */
+uint64_t timer_get_ticks(void) {
+    return read_cntpct_el0();
+}
+
+/*
+ * timer_ticks_to_ns / timer_ticks_to_us
+ * Public wrappers around the fixed-point conversion helpers.
+ */
+uint64_t timer_ticks_to_ns(uint64_t ticks) {
+    return ticks_to_ns(ticks);
+}
+
+uint64_t timer_ticks_to_us(uint64_t ticks) {
+    return ticks_to_us(ticks);
+}
+
+/*
+ * timer_get_next_event_ns
+ * Returns the time remaining until the programmed CNTP compare value fires.
+ * Returns 0 if the deadline already passed, UINT64_MAX if no event is armed
+ * (timer disabled or IRQ masked). Used by the cpuidle governor.
+ */
+uint64_t timer_get_next_event_ns(void) {
+    uint64_t ctl = read_cntp_ctl_el0();
+
+    if (!(ctl & TIMER_ENABLE_BIT) || (ctl & TIMER_IMASK_BIT)) {
+        return UINT64_MAX;
+    }
+
+    uint64_t cval = read_cntp_cval_el0();
+    uint64_t now = read_cntpct_el0();
+
+    if (cval <= now) {
+        return 0;
+    }
+
+    return ticks_to_ns(cval - now);
+}
 /*
  * ======================================================================================
  * SECTION: INITIALIZATION & CALIBRATION
@@ -0,0 +1,1358 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        wasm_aot.c
+ * Module:      WebAssembly AOT Compiler (AArch64)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * One forward pass per function over the loader's IR. Every value has a
+ * fixed home, so control-flow merges need no reconciliation:
+ *   - the 8 most used locals (uses inside loops weigh more) live in
+ *     X19-X26, the rest in the frame
+ *   - operand stack height h lives in the h-th of X9-X15, X0-X7, deeper
+ *     heights in the frame
+ * All values, floats included, are raw bits in general registers (i32
+ * and f32 zero-extended); FP instructions go through D0-D2. Constants
+ * fold into add/sub/compare/shift immediates, and a compare feeding
+ * br_if, if or select becomes the branch/select condition.
+ *
+ * Register and calling conventions:
+ *   X28 vmctx, X27 linear memory base (both preserved by every function)
+ *   X0-X15 arguments (X8 included), X0 result, X16/X17/X8 scratch
+ * Linear memory accesses are [X27 + zero-extended address + offset] with
+ * no bounds check (see the reservation in kernel/wasm.h). Code is placed
+ * as: entry thunks (per canonical type, AAPCS in), import stubs, function
+ * bodies, each body followed by its trap stubs.
+ * ======================================================================================
+ */
+
+#include <string.h>
+#include "kernel/wasm.h"
+
+/* Registers */
+#define R_ARG8                  8       // Also the address scratch
+#define R_S0                    16
+#define R_S1                    17
+#define R_MEM                   27
+#define R_VM                    28
+#define R_FP                    29
+#define R_LR                    30
+#define R_SP                    31      // Or XZR, by instruction
+#define R_ZR                    31
+
+#define AOT_OPND_REGS           15
+#define AOT_LOCAL_REGS          8
+#define AOT_LOCAL_REG0          19
+
+static const uint8_t aot_opnd_reg[AOT_OPND_REGS] = { 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+/* Condition codes */
+#define CC_EQ                   0
+#define CC_NE                   1
+#define CC_HS                   2
+#define CC_LO                   3
+#define CC_MI                   4
+#define CC_VS                   6
+#define CC_HI                   8
+#define CC_LS                   9
+#define CC_GE                   10
+#define CC_LT                   11
+#define CC_GT                   12
+#define CC_LE                   13
+#define CC_NONE                 0xFF
+
+#define AOT_FIX_TRAP            0x80000000U     // Fixup target: trap stub
+#define AOT_TRAP_DYNAMIC        WASM_TRAP_NONE  // Stub raising vm->trap
+
+/* =========================================================================
+ * A64 ENCODINGS
+ * ========================================================================= */
+#define A64_RRR(op, sf, d, n, m)    ((uint32_t)(sf) << 31 | (op) | (uint32_t)(m) << 16 | (uint32_t)(n) << 5 | (d))
+#define A64_ADD                 0x0B000000U
+#define A64_SUB                 0x4B000000U
+#define A64_SUBS                0x6B000000U
+#define A64_AND                 0x0A000000U
+#define A64_ORR                 0x2A000000U
+#define A64_EOR                 0x4A000000U
+#define A64_LSLV                0x1AC02000U
+#define A64_LSRV                0x1AC02400U
+#define A64_ASRV                0x1AC02800U
+#define A64_RORV                0x1AC02C00U
+#define A64_UDIV                0x1AC00800U
+#define A64_SDIV                0x1AC00C00U
+#define A64_MUL                 0x1B007C00U     // MADD, Ra = ZR
+#define A64_CLZ                 0x5AC01000U
+#define A64_RBIT                0x5AC00000U
+
+#define A64_MOV(sf, d, m)       A64_RRR(A64_ORR, sf, d, R_ZR, m)
+#define A64_CMP(sf, n, m)       A64_RRR(A64_SUBS, sf, R_ZR, n, m)
+#define A64_MSUB(sf, d, n, m, a) (A64_RRR(0x1B008000U, sf, d, n, m) | (uint32_t)(a) << 10)
+#define A64_ADDI(sf, d, n, imm) ((uint32_t)(sf) << 31 | 0x11000000U | (uint32_t)(imm) << 10 | (uint32_t)(n) << 5 | (d))
+#define A64_SUBI(sf, d, n, imm) ((uint32_t)(sf) << 31 | 0x51000000U | (uint32_t)(imm) << 10 | (uint32_t)(n) << 5 | (d))
+#define A64_LSL12               0x00400000U     // ADDI/SUBI: imm << 12
+#define A64_CMPI(sf, n, imm)    ((uint32_t)(sf) << 31 | 0x71000000U | (uint32_t)(imm) << 10 | (uint32_t)(n) << 5 | R_ZR)
+#define A64_CMNI(sf, n, imm)    ((uint32_t)(sf) << 31 | 0x31000000U | (uint32_t)(imm) << 10 | (uint32_t)(n) << 5 | R_ZR)
+#define A64_ADDX_UXTW(d, n, m, s) (0x8B204000U | (uint32_t)(m) << 16 | (uint32_t)(s) << 10 | (uint32_t)(n) << 5 | (d))
+#define A64_CSET(sf, d, cc)     ((uint32_t)(sf) << 31 | 0x1A9F07E0U | (uint32_t)((cc) ^ 1) << 12 | (d))
+#define A64_CSEL(sf, d, n, m, cc) (A64_RRR(0x1A800000U, sf, d, n, m) | (uint32_t)(cc) << 12)
+#define A64_CCMPI(sf, n, imm, nzcv, cc) \
+    ((uint32_t)(sf) << 31 | 0x7A400800U | (uint32_t)(imm) << 16 | (uint32_t)(cc) << 12 | (uint32_t)(n) << 5 | (nzcv))
+#define A64_BITFIELD(op, d, n, r, s) ((op) | (uint32_t)(r) << 16 | (uint32_t)(s) << 10 | (uint32_t)(n) << 5 | (d))
+#define A64_UBFM(sf, d, n, r, s) A64_BITFIELD((sf) ? 0xD3400000U : 0x53000000U, d, n, r, s)
+#define A64_SBFM(sf, d, n, r, s) A64_BITFIELD((sf) ? 0x93400000U : 0x13000000U, d, n, r, s)
+#define A64_BFM(sf, d, n, r, s)  A64_BITFIELD((sf) ? 0xB3400000U : 0x33000000U, d, n, r, s)
+#define A64_AND_NOSIGN(sf, d, n) (((sf) ? 0x9240F800U : 0x12007800U) | (uint32_t)(n) << 5 | (d))
+#define A64_EOR_SIGN(sf, d, n)   (((sf) ? 0xD2410000U : 0x52010000U) | (uint32_t)(n) << 5 | (d))
+#define A64_MOVZ(sf, d, imm, hw) ((uint32_t)(sf) << 31 | 0x52800000U | (uint32_t)(hw) << 21 | (uint32_t)(imm) << 5 | (d))
+#define A64_MOVN(sf, d, imm, hw) ((uint32_t)(sf) << 31 | 0x12800000U | (uint32_t)(hw) << 21 | (uint32_t)(imm) << 5 | (d))
+#define A64_MOVK(sf, d, imm, hw) ((uint32_t)(sf) << 31 | 0x72800000U | (uint32_t)(hw) << 21 | (uint32_t)(imm) << 5 | (d))
+
+/* Loads/stores: size log2, opc (0 store, 1 load, 2 load signed to X, 3 signed to W) */
+#define A64_LDST_U(size, opc, t, n, imm) \
+    (0x39000000U | (uint32_t)(size) << 30 | (uint32_t)(opc) << 22 | (uint32_t)(imm) << 10 | (uint32_t)(n) << 5 | (t))
+#define A64_LDST_R(size, opc, t, n, m, option) \
+    (0x38200800U | (uint32_t)(size) << 30 | (uint32_t)(opc) << 22 | (uint32_t)(m) << 16 | (uint32_t)(option) << 13 | \
+     (uint32_t)(n) << 5 | (t))
+#define A64_OPT_UXTW            2
+#define A64_OPT_LSL             3
+#define A64_LDRX(t, n, off)     A64_LDST_U(3, 1, t, n, (off) / 8)
+#define A64_STRX(t, n, off)     A64_LDST_U(3, 0, t, n, (off) / 8)
+#define A64_LDRW(t, n, off)     A64_LDST_U(2, 1, t, n, (off) / 4)
+#define A64_STP(t1, t2, n, off) (0xA9000000U | (uint32_t)(((off) / 8) & 0x7F) << 15 | (uint32_t)(t2) << 10 | (uint32_t)(n) << 5 | (t1))
+#define A64_LDP(t1, t2, n, off) (0xA9400000U | (uint32_t)(((off) / 8) & 0x7F) << 15 | (uint32_t)(t2) << 10 | (uint32_t)(n) << 5 | (t1))
+#define A64_STP_PRE_FP_LR(size) (0xA9807BFDU | (uint32_t)((-(size) / 8) & 0x7F) << 15)   // stp x29, x30, [sp, #-size]!
+#define A64_LDP_POST_FP_LR(size) (0xA8C07BFDU | (uint32_t)(((size) / 8) & 0x7F) << 15)  // ldp x29, x30, [sp], #size
+
+/* FP: 'dbl' selects double precision */
+#define A64_FMOV_TO_FP(sf, d, n)    (((sf) ? 0x9E670000U : 0x1E270000U) | (uint32_t)(n) << 5 | (d))
+#define A64_FMOV_FROM_FP(sf, d, n)  (((sf) ? 0x9E660000U : 0x1E260000U) | (uint32_t)(n) << 5 | (d))
+#define A64_FMOV_D(d, n)        (0x1E604000U | (uint32_t)(n) << 5 | (d))
+#define A64_FP2(op, dbl, d, n, m)   ((op) | (uint32_t)(dbl) << 22 | (uint32_t)(m) << 16 | (uint32_t)(n) << 5 | (d))
+#define A64_FMUL                0x1E200800U
+#define A64_FDIV                0x1E201800U
+#define A64_FADD                0x1E202800U
+#define A64_FSUB                0x1E203800U
+#define A64_FMAX                0x1E204800U
+#define A64_FMIN                0x1E205800U
+#define A64_FP1(op, dbl, d, n)  ((op) | (uint32_t)(dbl) << 22 | (uint32_t)(n) << 5 | (d))
+#define A64_FSQRT               0x1E21C000U
+#define A64_FRINTN              0x1E244000U
+#define A64_FRINTP              0x1E24C000U
+#define A64_FRINTM              0x1E254000U
+#define A64_FRINTZ              0x1E25C000U
+#define A64_FCMP(dbl, n, m)     (0x1E202000U | (uint32_t)(dbl) << 22 | (uint32_t)(m) << 16 | (uint32_t)(n) << 5)
+#define A64_FCVT_S2D(d, n)      (0x1E22C000U | (uint32_t)(n) << 5 | (d))
+#define A64_FCVT_D2S(d, n)      (0x1E624000U | (uint32_t)(n) << 5 | (d))
+#define A64_CVTF(u, sf, dbl, d, n)  ((uint32_t)(sf) << 31 | ((u) ? 0x1E230000U : 0x1E220000U) | (uint32_t)(dbl) << 22 | \
+                                     (uint32_t)(n) << 5 | (d))
+#define A64_FCVTZ(u, sf, dbl, d, n) ((uint32_t)(sf) << 31 | ((u) ? 0x1E390000U : 0x1E380000U) | (uint32_t)(dbl) << 22 | \
+                                     (uint32_t)(n) << 5 | (d))
+#define A64_CNT8B(d, n)         (0x0E205800U | (uint32_t)(n) << 5 | (d))
+#define A64_ADDV8B(d, n)        (0x0E31B800U | (uint32_t)(n) << 5 | (d))
+
+/* Branches (offsets patched later) */
+#define A64_B                   0x14000000U
+#define A64_BL                  0x94000000U
+#define A64_BCOND(cc)           (0x54000000U | (cc))
+#define A64_CBZ(sf, t)          ((uint32_t)(sf) << 31 | 0x34000000U | (t))
+#define A64_CBNZ(sf, t)         ((uint32_t)(sf) << 31 | 0x35000000U | (t))
+#define A64_BR(n)               (0xD61F0000U | (uint32_t)(n) << 5)
+#define A64_BLR(n)              (0xD63F0000U | (uint32_t)(n) << 5)
+#define A64_RET                 0xD65F03C0U
+#define A64_ADR(d, off)         (0x10000000U | (uint32_t)((off) & 3) << 29 | (uint32_t)(((off) >> 2) & 0x7FFFF) << 5 | (d))
+
+typedef struct {
+    uint32_t pos;                   // Branch instruction (word index)
+    uint32_t target;                // IR index, function index or AOT_FIX_TRAP | code
+} aot_fix_t;
+
+typedef struct {
+    wasm_module_t *m;
+    uint32_t *code;
+    uint32_t pos;                   // Words emitted
+    uint32_t cap;
+    int err;
+
+    /* Function being compiled */
+    const wasm_ins_t *ir;
+    uint32_t n;
+    uint32_t first;                 // IR index of ir[0]
+    uint32_t nlocals;
+    uint32_t base;                  // Frame offset of slot 0
+    uint32_t frame;
+    uint32_t nsaved;
+    int32_t *lheight;               // Per IR index: height at a label, or -1
+    uint32_t *lpos;                 // Per IR index: code position
+    int32_t *depth;                 // Loop nesting deltas
+    uint32_t *weight;               // Per local
+    uint8_t *lreg;                  // Per local: register, or 0 (frame)
+    aot_fix_t *fix;
+    uint32_t nfix;
+    uint32_t fix_cap;
+    uint32_t trap_used;
+    uint32_t trap_pos[WASM_TRAP_HOST + 1];
+
+    /* Direct calls, patched when every body is placed */
+    aot_fix_t *calls;
+    uint32_t ncalls;
+    uint32_t calls_cap;
+} aot_t;
+
+/* =========================================================================
+ * EMITTER
+ * ========================================================================= */
+
+static inline void aot_emit(aot_t *a, uint32_t insn) {
+    if (a->pos < a->cap) {
+        a->code[a->pos] = insn;
+    } else {
+        a->err = WASM_ERR_NOMEM;
+    }
+    a->pos++;
+}
+
+/* Branch to an IR index or a trap stub, resolved at the end of the function */
+static void aot_branch(aot_t *a, uint32_t insn, uint32_t target) {
+    if (a->nfix == a->fix_cap) {
+        a->err = WASM_ERR_NOMEM;
+        return;
+    }
+    if (target & AOT_FIX_TRAP) {
+        a->trap_used |= 1U << (target & ~AOT_FIX_TRAP);
+    }
+    a->fix[a->nfix].pos = a->pos;
+    a->fix[a->nfix].target = target;
+    a->nfix++;
+    aot_emit(a, insn);
+}
+
+/* Sets the offset of the branch at 'at' to reach 'to' */
+static void aot_patch(aot_t *a, uint32_t at, uint32_t to) {
+    int64_t d = (int64_t)to - (int64_t)at;
+    uint32_t insn;
+
+    if (at >= a->cap) {
+        return;
+    }
+    insn = a->code[at];
+    if ((insn & 0x7C000000U) == A64_B) {
+        if (d < -(1LL << 25) || d >= (1LL << 25)) {
+            a->err = WASM_ERR_UNSUPPORTED;
+            return;
+        }
+        a->code[at] = insn | ((uint32_t)d & 0x3FFFFFFU);
+    } else {
+        if (d < -(1LL << 18) || d >= (1LL << 18)) {
+            a->err = WASM_ERR_UNSUPPORTED;      // Function body over 1 MB
+            return;
+        }
+        a->code[at] = insn | ((uint32_t)d & 0x7FFFFU) << 5;
+    }
+}
+
+static void aot_movi(aot_t *a, uint32_t sf, uint32_t d, uint64_t v) {
+    uint32_t hws = sf ? 4 : 2, zeros = 0, ones = 0, first = 1, inv;
+
+    if (!sf) {
+        v &= 0xFFFFFFFFU;
+    }
+    for (uint32_t i = 0; i < hws; i++) {
+        uint32_t hw = (uint32_t)(v >> (16 * i)) & 0xFFFF;
+        zeros += hw == 0;
+        ones += hw == 0xFFFF;
+    }
+    /* MOVN when more halfwords are all-ones than zero */
+    inv = ones > zeros;
+    for (uint32_t i = 0; i < hws; i++) {
+        uint32_t hw = (uint32_t)(v >> (16 * i)) & 0xFFFF;
+        if (hw == (inv ? 0xFFFFU : 0)) {
+            continue;
+        }
+        if (first) {
+            aot_emit(a, inv ? A64_MOVN(sf, d, ~hw & 0xFFFF, i) : A64_MOVZ(sf, d, hw, i));
+            first = 0;
+        } else {
+            aot_emit(a, A64_MOVK(sf, d, hw, i));
+        }
+    }
+    if (first) {
+        aot_emit(a, inv ? A64_MOVN(sf, d, 0, 0) : A64_MOVZ(sf, d, 0, 0));
+    }
+}
+
+/* d = n +/- imm for any imm below 16 MB (n, d may be SP) */
+static void aot_addi(aot_t *a, uint32_t sub, uint32_t d, uint32_t n, uint32_t imm) {
+    uint32_t op = sub ? A64_SUBI(1, 0, 0, 0) : A64_ADDI(1, 0, 0, 0);
+
+    if (imm >> 12) {
+        aot_emit(a, op | A64_LSL12 | (imm >> 12) << 10 | n << 5 | d);
+        n = d;
+    }
+    if ((imm & 0xFFF) || !(imm >> 12)) {
+        aot_emit(a, op | (imm & 0xFFF) << 10 | n << 5 | d);
+    }
+}
+
+/* 64-bit frame access at SP + off */
+static void aot_frame(aot_t *a, int load, uint32_t reg, uint32_t off) {
+    uint32_t tmp;
+
+    if (off < 32768) {
+        aot_emit(a, load ? A64_LDRX(reg, R_SP, off) : A64_STRX(reg, R_SP, off));
+        return;
+    }
+    // A load addresses through its own target; a store through X8 (X17 when storing X8)
+    tmp = load ? reg : (reg == R_ARG8 ? R_S1 : R_ARG8);
+    aot_emit(a, A64_ADDI(1, tmp, R_SP, off >> 12) | A64_LSL12);
+    aot_emit(a, load ? A64_LDRX(reg, tmp, off & 0xFFF) : A64_STRX(reg, tmp, off & 0xFFF));
+}
+
+/* =========================================================================
+ * VALUE HOMES
+ * ========================================================================= */
+
+static inline uint32_t aot_slot_off(const aot_t *a, uint32_t slot) {
+    return a->base + 8 * slot;
+}
+
+/* Register holding operand height h (loaded into 'scratch' if in the frame) */
+static uint32_t aot_src(aot_t *a, uint32_t h, uint32_t scratch) {
+    if (h < AOT_OPND_REGS) {
+        return aot_opnd_reg[h];
+    }
+    aot_frame(a, 1, scratch, aot_slot_off(a, a->nlocals + h));
+    return scratch;
+}
+
+/* Register to compute height h into; aot_commit() completes it */
+static inline uint32_t aot_dst(uint32_t h) {
+    return h < AOT_OPND_REGS ? aot_opnd_reg[h] : R_S0;
+}
+
+static void aot_commit(aot_t *a, uint32_t h, uint32_t reg) {
+    if (h >= AOT_OPND_REGS) {
+        aot_frame(a, 0, reg, aot_slot_off(a, a->nlocals + h));
+    }
+}
+
+/* Height h = reg */
+static void aot_set(aot_t *a, uint32_t h, uint32_t reg) {
+    if (h < AOT_OPND_REGS) {
+        if (aot_opnd_reg[h] != reg) {
+            aot_emit(a, A64_MOV(1, aot_opnd_reg[h], reg));
+        }
+    } else {
+        aot_frame(a, 0, reg, aot_slot_off(a, a->nlocals + h));
+    }
+}
+
+/* Carried branch value: height 'from' to height 'to' */
+static void aot_move(aot_t *a, uint32_t from, uint32_t to) {
+    if (from != to) {
+        aot_set(a, to, aot_src(a, from, R_S0));
+    }
+}
+
+static void aot_local_set(aot_t *a, uint32_t l, uint32_t reg) {
+    if (a->lreg[l]) {
+        if (a->lreg[l] != reg) {
+            aot_emit(a, A64_MOV(1, a->lreg[l], reg));
+        }
+    } else {
+        aot_frame(a, 0, reg, aot_slot_off(a, l));
+    }
+}
+
+/* =========================================================================
+ * CALLS
+ * ========================================================================= */
+
+/* Saves register-homed heights below 'top' to their frame slots */
+static void aot_spill(aot_t *a, uint32_t top) {
+    for (uint32_t h = 0; h < top && h < AOT_OPND_REGS; h++) {
+        aot_frame(a, 0, aot_opnd_reg[h], aot_slot_off(a, a->nlocals + h));
+    }
+}
+
+static void aot_reload(aot_t *a, uint32_t top) {
+    for (uint32_t h = 0; h < top && h < AOT_OPND_REGS; h++) {
+        aot_frame(a, 1, aot_opnd_reg[h], aot_slot_off(a, a->nlocals + h));
+    }
+}
+
+/* Arguments at heights b.. into X0..; everything below b saved */
+static void aot_call_args(aot_t *a, uint32_t b, uint32_t n) {
+    aot_spill(a, b);
+    if (b + n <= 7) {
+        // All in X9-X15: no overlap with X0-X6
+        for (uint32_t k = 0; k < n; k++) {
+            aot_emit(a, A64_MOV(1, k, aot_opnd_reg[b + k]));
+        }
+        return;
+    }
+    for (uint32_t h = b; h < b + n && h < AOT_OPND_REGS; h++) {
+        aot_frame(a, 0, aot_opnd_reg[h], aot_slot_off(a, a->nlocals + h));
+    }
+    for (uint32_t k = 0; k < n; k++) {
+        if (k != R_ARG8) {
+            aot_frame(a, 1, k, aot_slot_off(a, a->nlocals + b + k));
+        }
+    }
+    if (n > R_ARG8) {
+        aot_frame(a, 1, R_ARG8, aot_slot_off(a, a->nlocals + b + R_ARG8));
+    }
+}
+
+/* Result (X0) to height b, saved heights back */
+static void aot_call_done(aot_t *a, uint32_t b, const wasm_type_t *t) {
+    if (t->nresults) {
+        aot_set(a, b, 0);
+    }
+    aot_reload(a, b);
+}
+
+/*
+ * Call through vm->host_call: import 'index' or a builtin, 'n' arguments
+ * at height b (their frame slots are the args[] array)
+ */
+static void aot_host_call(aot_t *a, uint32_t b, uint32_t n, uint32_t index, const wasm_type_t *t) {
+    aot_spill(a, b + n);
+    aot_emit(a, A64_MOV(1, 0, R_VM));
+    aot_movi(a, 0, 1, index);
+    aot_addi(a, 0, 2, R_SP, aot_slot_off(a, a->nlocals + b));
+    aot_emit(a, A64_LDRX(R_S0, R_VM, WASM_VM_HOST_CALL));
+    aot_emit(a, A64_BLR(R_S0));
+    aot_emit(a, A64_LDRW(R_S0, R_VM, WASM_VM_TRAP));
+    aot_branch(a, A64_CBNZ(0, R_S0), AOT_FIX_TRAP | AOT_TRAP_DYNAMIC);
+    if (t->nresults && (t->result == WASM_I32 || t->result == WASM_F32)) {
+        aot_emit(a, A64_MOV(0, 0, 0));
+    }
+    aot_call_done(a, b, t);
+}
+
+/* =========================================================================
+ * FUNCTION FRAME
+ * ========================================================================= */
+
+static void aot_prologue(aot_t *a, const wasm_type_t *ft) {
+    /* 1. Stack limit */
+    aot_emit(a, A64_LDRX(R_S0, R_VM, WASM_VM_STACK_LIMIT));
+    aot_addi(a, 1, R_S1, R_SP, a->frame);
+    aot_emit(a, A64_CMP(1, R_S1, R_S0));
+    aot_branch(a, A64_BCOND(CC_LO), AOT_FIX_TRAP | WASM_TRAP_STACK);
+
+    /* 2. Frame, callee-saved registers */
+    aot_addi(a, 1, R_SP, R_SP, a->frame);
+    aot_emit(a, A64_STP(R_FP, R_LR, R_SP, 0));
+    aot_emit(a, A64_ADDI(1, R_FP, R_SP, 0));
+    for (uint32_t i = 0; i < a->nsaved; i += 2) {
+        aot_emit(a, A64_STP(AOT_LOCAL_REG0 + i, AOT_LOCAL_REG0 + i + 1, R_SP, 16 + 8 * i));
+    }
+
+    /* 3. Parameters from X0.. (X8 first: far frame stores go through it), other locals zeroed */
+    if (ft->nparams > R_ARG8) {
+        aot_local_set(a, R_ARG8, R_ARG8);
+    }
+    for (uint32_t l = 0; l < ft->nparams; l++) {
+        if (l != R_ARG8) {
+            aot_local_set(a, l, l);
+        }
+    }
+    for (uint32_t l = ft->nparams; l < a->nlocals; l++) {
+        aot_local_set(a, l, R_ZR);
+    }
+}
+
+static void aot_epilogue(aot_t *a) {
+    for (uint32_t i = 0; i < a->nsaved; i += 2) {
+        aot_emit(a, A64_LDP(AOT_LOCAL_REG0 + i, AOT_LOCAL_REG0 + i + 1, R_SP, 16 + 8 * i));
+    }
+    aot_emit(a, A64_LDP(R_FP, R_LR, R_SP, 0));
+    aot_addi(a, 0, R_SP, R_SP, a->frame);
+    aot_emit(a, A64_RET);
+}
+
+/* Trap stubs: trap_fn(vmctx, code), which does not return */
+static void aot_trap_stubs(aot_t *a) {
+    for (uint32_t code = 0; code <= WASM_TRAP_HOST; code++) {
+        if (!(a->trap_used & (1U << code))) {
+            continue;
+        }
+        a->trap_pos[code] = a->pos;
+        aot_emit(a, A64_MOV(1, 0, R_VM));
+        if (code == AOT_TRAP_DYNAMIC) {
+            aot_emit(a, A64_LDRW(1, R_VM, WASM_VM_TRAP));
+        } else {
+            aot_emit(a, A64_MOVZ(0, 1, code, 0));
+        }
+        aot_emit(a, A64_LDRX(R_S0, R_VM, WASM_VM_TRAP_FN));
+        aot_emit(a, A64_BLR(R_S0));
+    }
+}
+
+/* =========================================================================
+ * ANALYSIS
+ * ========================================================================= */
+
+static void aot_label(aot_t *a, uint32_t at, uint32_t slot, uint32_t arity, uint32_t from) {
+    uint32_t t = at - a->first;
+
+    a->lheight[t] = (int32_t)(slot - a->nlocals + arity);
+    if (t <= from) {
+        a->depth[t]++;                              // Backward branch: a loop
+        a->depth[from + 1]--;
+    }
+}
+
+/*
+ * Labels with their heights, then local weights: each use counts 8^depth
+ * of the loops around it. The heaviest locals get X19-X26.
+ */
+static void aot_analyze(aot_t *a) {
+    const wasm_module_t *m = a->m;
+    uint32_t d = 0;
+
+    for (uint32_t i = 0; i <= a->n; i++) {
+        a->lheight[i] = -1;
+        a->depth[i] = 0;
+    }
+    for (uint32_t i = 0; i < a->n; i++) {
+        const wasm_ins_t *in = &a->ir[i];
+        switch (in->op) {
+        case 0x04:
+            aot_label(a, in->a, (uint32_t)in->b, 0, i);
+            break;
+        case 0x05:
+        case 0x0C:
+        case 0x0D:
+            aot_label(a, in->a, (uint32_t)in->b, in->arity, i);
+            break;
+        case 0x0E:
+            for (uint32_t e = 0; e < (uint32_t)in->b; e++) {
+                const wasm_brtab_t *t = &m->brtab[in->a + e];
+                aot_label(a, t->pc, t->slot, in->arity, i);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    memset(a->weight, 0, a->nlocals * sizeof(uint32_t));
+    for (uint32_t i = 0; i < a->n; i++) {
+        const wasm_ins_t *in = &a->ir[i];
+        d += (uint32_t)a->depth[i];
+        if (in->op >= 0x20 && in->op <= 0x22) {
+            uint32_t w = 1U << (3 * (d < 8 ? d : 8));
+            a->weight[in->a] = (a->weight[in->a] + w < a->weight[in->a]) ? 0xFFFFFFFFU : a->weight[in->a] + w;
+        }
+    }
+
+    memset(a->lreg, 0, a->nlocals);
+    a->nsaved = 0;
+    while (a->nsaved < AOT_LOCAL_REGS) {
+        uint32_t best = 0, bw = 0;
+        for (uint32_t l = 0; l < a->nlocals; l++) {
+            if (!a->lreg[l] && a->weight[l] > bw) {
+                best = l;
+                bw = a->weight[l];
+            }
+        }
+        if (bw == 0) {
+            break;
+        }
+        a->lreg[best] = (uint8_t)(AOT_LOCAL_REG0 + a->nsaved++);
+    }
+}
+
+/* =========================================================================
+ * INSTRUCTIONS
+ * ========================================================================= */
+
+/* Integer compare conditions, wasm opcode order eq ne lt_s lt_u gt_s gt_u le_s le_u ge_s ge_u */
+static const uint8_t aot_icc[10] = { CC_EQ, CC_NE, CC_LT, CC_LO, CC_GT, CC_HI, CC_LE, CC_LS, CC_GE, CC_HS };
+/* Float: eq ne lt gt le ge (all false on unordered except ne) */
+static const uint8_t aot_fcc[6] = { CC_EQ, CC_NE, CC_MI, CC_GT, CC_LS, CC_GE };
+
+/* Float to integer: [lo, hi] exclusive bounds as doubles, see wasm_interp.c */
+static const double aot_trunc_bound[8][2] = {
+    { -2147483904.0, 2147483648.0 }, { -1.0, 4294967296.0 },
+    { -2147483649.0, 2147483648.0 }, { -1.0, 4294967296.0 },
+    { -9223373136366403584.0, 9223372036854775808.0 }, { -1.0, 18446744073709551616.0 },
+    { -9223372036854777856.0, 9223372036854775808.0 }, { -1.0, 18446744073709551616.0 },
+};
+
+static inline int aot_is_cmp(uint16_t op) {
+    return (op >= 0x45 && op <= 0x66);
+}
+
+/* Whether a constant at IR i can be the immediate of ir[i + 1] */
+static int aot_fold_const(const aot_t *a, uint32_t i, int64_t *imm) {
+    const wasm_ins_t *c = &a->ir[i], *next;
+    uint16_t op;
+    int64_t v;
+
+    if (i + 1 >= a->n || a->lheight[i + 1] >= 0) {
+        return 0;
+    }
+    next = &a->ir[i + 1];
+    op = next->op;
+    if (c->op == 0x41) {
+        v = (int32_t)(uint32_t)c->b;
+        if (op == 0x74 || op == 0x75 || op == 0x76) {
+            *imm = v & 31;
+            return 1;
+        }
+        if (!(op == 0x6A || op == 0x6B || (op >= 0x46 && op <= 0x4F))) {
+            return 0;
+        }
+    } else if (c->op == 0x42) {
+        v = (int64_t)c->b;
+        if (op == 0x86 || op == 0x87 || op == 0x88) {
+            *imm = v & 63;
+            return 1;
+        }
+        if (!(op == 0x7C || op == 0x7D || (op >= 0x51 && op <= 0x5A))) {
+            return 0;
+        }
+    } else {
+        return 0;
+    }
+    if (v <= -4096 || v >= 4096) {
+        return 0;
+    }
+    *imm = v;
+    return 1;
+}
+
+/* Memory access of 2^size bytes: t <-> [X27 + uxtw(addr) + off] */
+static void aot_mem(aot_t *a, uint32_t size, uint32_t opc, uint32_t t, uint32_t addr, uint32_t off) {
+    if (off == 0) {
+        aot_emit(a, A64_LDST_R(size, opc, t, R_MEM, addr, A64_OPT_UXTW));
+    } else if (!(off & ((1U << size) - 1)) && (off >> size) < 4096) {
+        aot_emit(a, A64_ADDX_UXTW(R_ARG8, R_MEM, addr, 0));
+        aot_emit(a, A64_LDST_U(size, opc, t, R_ARG8, off >> size));
+    } else {
+        aot_movi(a, 1, R_ARG8, off);
+        aot_emit(a, A64_ADDX_UXTW(R_ARG8, R_ARG8, addr, 0));
+        aot_emit(a, A64_LDST_R(size, opc, t, R_MEM, R_ARG8, A64_OPT_LSL));
+    }
+}
+
+/* Flags for a compare at height h (operands h-2, h-1 or h-1 for eqz); returns the condition */
+static uint32_t aot_compare(aot_t *a, uint16_t op, uint32_t h, int has_imm, int64_t imm) {
+    uint32_t ra, rb;
+
+    if (op == 0x45 || op == 0x50) {
+        ra = aot_src(a, h - 1, R_S0);
+        aot_emit(a, A64_CMPI(op == 0x50, ra, 0));
+        return CC_EQ;
+    }
+    ra = aot_src(a, h - 2, R_S0);
+    if (op <= 0x5A) {
+        uint32_t sf = op >= 0x51;
+        if (has_imm) {
+            aot_emit(a, imm >= 0 ? A64_CMPI(sf, ra, (uint32_t)imm) : A64_CMNI(sf, ra, (uint32_t)-imm));
+        } else {
+            rb = aot_src(a, h - 1, R_S1);
+            aot_emit(a, A64_CMP(sf, ra, rb));
+        }
+        return aot_icc[op - (sf ? 0x51 : 0x46)];
+    }
+    {
+        uint32_t dbl = op >= 0x61;
+        rb = aot_src(a, h - 1, R_S1);
+        aot_emit(a, A64_FMOV_TO_FP(dbl, 0, ra));
+        aot_emit(a, A64_FMOV_TO_FP(dbl, 1, rb));
+        aot_emit(a, A64_FCMP(dbl, 0, 1));
+        return aot_fcc[op - (dbl ? 0x61 : 0x5B)];
+    }
+}
+
+/* Integer binary op, a at h-2, b at h-1 (or 'imm'), result at h-2 */
+static void aot_int_binop(aot_t *a, uint16_t op, uint32_t h, int has_imm, int64_t imm) {
+    static const uint32_t alu[15] = {
+        A64_ADD, A64_SUB, A64_MUL, 0, 0, 0, 0, A64_AND, A64_ORR, A64_EOR, A64_LSLV, A64_ASRV, A64_LSRV, 0, A64_RORV };
+    uint32_t sf = op >= 0x7C, k = op - (sf ? 0x7C : 0x6A), bits = sf ? 64 : 32;
+    uint32_t ra = aot_src(a, h - 2, R_S0), rb = R_ZR, d = aot_dst(h - 2);
+
+    if (has_imm) {
+        switch (k) {
+        case 0:                                     // add
+        case 1:                                     // sub
+            if ((k == 0) == (imm >= 0)) {
+                aot_emit(a, A64_ADDI(sf, d, ra, (uint32_t)(imm >= 0 ? imm : -imm)));
+            } else {
+                aot_emit(a, A64_SUBI(sf, d, ra, (uint32_t)(imm >= 0 ? imm : -imm)));
+            }
+            break;
+        case 10:                                    // shl
+            aot_emit(a, A64_UBFM(sf, d, ra, (bits - (uint32_t)imm) & (bits - 1), bits - 1 - (uint32_t)imm));
+            break;
+        case 11:                                    // shr_s
+            aot_emit(a, A64_SBFM(sf, d, ra, (uint32_t)imm, bits - 1));
+            break;
+        default:                                    // shr_u
+            aot_emit(a, A64_UBFM(sf, d, ra, (uint32_t)imm, bits - 1));
+            break;
+        }
+        aot_commit(a, h - 2, d);
+        return;
+    }
+
+    rb = aot_src(a, h - 1, R_S1);
+    switch (k) {
+    case 3:                                         // div_s
+    case 5:                                         // rem_s
+        aot_branch(a, A64_CBZ(sf, rb), AOT_FIX_TRAP | WASM_TRAP_DIV_ZERO);
+        if (k == 3) {
+            // b == -1 && a == MIN: 'cmp a, #1' overflows only for MIN
+            aot_emit(a, A64_CMNI(sf, rb, 1));
+            aot_emit(a, A64_CCMPI(sf, ra, 1, 0, CC_EQ));
+            aot_branch(a, A64_BCOND(CC_VS), AOT_FIX_TRAP | WASM_TRAP_OVERFLOW);
+            aot_emit(a, A64_RRR(A64_SDIV, sf, d, ra, rb));
+        } else {
+            aot_emit(a, A64_RRR(A64_SDIV, sf, R_ARG8, ra, rb));
+            aot_emit(a, A64_MSUB(sf, d, R_ARG8, rb, ra));
+        }
+        break;
+    case 4:                                         // div_u
+    case 6:                                         // rem_u
+        aot_branch(a, A64_CBZ(sf, rb), AOT_FIX_TRAP | WASM_TRAP_DIV_ZERO);
+        if (k == 4) {
+            aot_emit(a, A64_RRR(A64_UDIV, sf, d, ra, rb));
+        } else {
+            aot_emit(a, A64_RRR(A64_UDIV, sf, R_ARG8, ra, rb));
+            aot_emit(a, A64_MSUB(sf, d, R_ARG8, rb, ra));
+        }
+        break;
+    case 13:                                        // rotl = rotr by -b
+        aot_emit(a, A64_RRR(A64_SUB, sf, R_ARG8, R_ZR, rb));
+        aot_emit(a, A64_RRR(A64_RORV, sf, d, ra, R_ARG8));
+        break;
+    default:
+        aot_emit(a, A64_RRR(alu[k], sf, d, ra, rb));
+        break;
+    }
+    aot_commit(a, h - 2, d);
+}
+
+/* Float binary op (0x92-0x98, 0xA0-0xA6) */
+static void aot_float_binop(aot_t *a, uint16_t op, uint32_t h) {
+    static const uint32_t fop[6] = { A64_FADD, A64_FSUB, A64_FMUL, A64_FDIV, A64_FMIN, A64_FMAX };
+    uint32_t dbl = op >= 0xA0, k = op - (dbl ? 0xA0 : 0x92);
+    uint32_t ra = aot_src(a, h - 2, R_S0), rb = aot_src(a, h - 1, R_S1), d = aot_dst(h - 2);
+
+    if (k == 6) {                                   // copysign: sign of b, rest of a
+        aot_emit(a, A64_MOV(1, R_S1, rb));
+        aot_emit(a, A64_BFM(dbl, R_S1, ra, 0, dbl ? 62 : 30));
+        aot_emit(a, A64_MOV(1, d, R_S1));
+    } else {
+        aot_emit(a, A64_FMOV_TO_FP(dbl, 0, ra));
+        aot_emit(a, A64_FMOV_TO_FP(dbl, 1, rb));
+        aot_emit(a, A64_FP2(fop[k], dbl, 0, 0, 1));
+        aot_emit(a, A64_FMOV_FROM_FP(dbl, d, 0));
+    }
+    aot_commit(a, h - 2, d);
+}
+
+/* Unary ops and conversions on height h-1 */
+static int aot_unop(aot_t *a, uint16_t op, uint32_t h) {
+    uint32_t r, d = aot_dst(h - 1), sf, dbl;
+
+    if (op >= 0xBC && op <= 0xBF) {
+        return WASM_OK;                             // reinterpret: same bits
+    }
+    r = aot_src(a, h - 1, R_S0);
+    switch (op) {
+    case 0x67: case 0x79:                           // clz
+        aot_emit(a, A64_RRR(A64_CLZ, op == 0x79, d, r, 0));
+        break;
+    case 0x68: case 0x7A:                           // ctz
+        aot_emit(a, A64_RRR(A64_RBIT, op == 0x7A, R_S1, r, 0));
+        aot_emit(a, A64_RRR(A64_CLZ, op == 0x7A, d, R_S1, 0));
+        break;
+    case 0x69: case 0x7B:                           // popcnt
+        aot_emit(a, A64_FMOV_TO_FP(op == 0x7B, 0, r));
+        aot_emit(a, A64_CNT8B(0, 0));
+        aot_emit(a, A64_ADDV8B(0, 0));
+        aot_emit(a, A64_FMOV_FROM_FP(0, d, 0));
+        break;
+    case 0x8B: case 0x99:                           // abs
+        aot_emit(a, A64_AND_NOSIGN(op == 0x99, d, r));
+        break;
+    case 0x8C: case 0x9A:                           // neg
+        aot_emit(a, A64_EOR_SIGN(op == 0x9A, d, r));
+        break;
+    case 0x8D: case 0x8E: case 0x8F: case 0x90: case 0x91:
+    case 0x9B: case 0x9C: case 0x9D: case 0x9E: case 0x9F: {
+        static const uint32_t fop[5] = { A64_FRINTP, A64_FRINTM, A64_FRINTZ, A64_FRINTN, A64_FSQRT };
+        dbl = op >= 0x9B;
+        aot_emit(a, A64_FMOV_TO_FP(dbl, 0, r));
+        aot_emit(a, A64_FP1(fop[op - (dbl ? 0x9B : 0x8D)], dbl, 0, 0));
+        aot_emit(a, A64_FMOV_FROM_FP(dbl, d, 0));
+        break;
+    }
+    case 0xA7: case 0xAD:                           // wrap, extend_u
+        aot_emit(a, A64_MOV(0, d, r));
+        break;
+    case 0xAC: case 0xC4:                           // extend_s, extend32_s
+        aot_emit(a, A64_SBFM(1, d, r, 0, 31));
+        break;
+    case 0xC0: case 0xC1: case 0xC2: case 0xC3:     // extend8_s, extend16_s
+        aot_emit(a, A64_SBFM(op >= 0xC2, d, r, 0, (op & 1) ? 15 : 7));
+        break;
+    case 0xB2: case 0xB3: case 0xB4: case 0xB5:     // f32.convert
+    case 0xB7: case 0xB8: case 0xB9: case 0xBA:     // f64.convert
+        dbl = op >= 0xB7;
+        sf = (uint32_t)(op - (dbl ? 0xB7 : 0xB2));
+        aot_emit(a, A64_CVTF(sf & 1, sf >= 2, dbl, 0, r));
+        aot_emit(a, A64_FMOV_FROM_FP(dbl, d, 0));
+        break;
+    case 0xB6:                                      // demote
+        aot_emit(a, A64_FMOV_TO_FP(1, 0, r));
+        aot_emit(a, A64_FCVT_D2S(0, 0));
+        aot_emit(a, A64_FMOV_FROM_FP(0, d, 0));
+        break;
+    case 0xBB:                                      // promote
+        aot_emit(a, A64_FMOV_TO_FP(0, 0, r));
+        aot_emit(a, A64_FCVT_S2D(0, 0));
+        aot_emit(a, A64_FMOV_FROM_FP(1, d, 0));
+        break;
+    default:
+        if ((op >= 0xA8 && op <= 0xAB) || (op >= 0xAE && op <= 0xB1) ||
+            (op >= WASM_OP_FC && op <= WASM_OP_FC + 7)) {
+            // trunc: i32 f32_s f32_u f64_s f64_u, then i64 (trapping and saturating alike)
+            uint32_t k = (op >= WASM_OP_FC) ? op - WASM_OP_FC : (op <= 0xAB ? op - 0xA8 : op - 0xAE + 4);
+            uint32_t u = k & 1;
+            union { double f; uint64_t u; } lo, hi;
+            dbl = (k >> 1) & 1;
+            sf = k >= 4;
+            aot_emit(a, A64_FMOV_TO_FP(dbl, 0, r));
+            if (op < WASM_OP_FC) {
+                // NaN, then range (compared in double precision)
+                aot_emit(a, A64_FCMP(dbl, 0, 0));
+                aot_branch(a, A64_BCOND(CC_VS), AOT_FIX_TRAP | WASM_TRAP_CONVERSION);
+                aot_emit(a, dbl ? A64_FMOV_D(1, 0) : A64_FCVT_S2D(1, 0));
+                lo.f = aot_trunc_bound[k][0];
+                hi.f = aot_trunc_bound[k][1];
+                aot_movi(a, 1, R_S1, lo.u);
+                aot_emit(a, A64_FMOV_TO_FP(1, 2, R_S1));
+                aot_emit(a, A64_FCMP(1, 1, 2));
+                aot_branch(a, A64_BCOND(CC_LS), AOT_FIX_TRAP | WASM_TRAP_OVERFLOW);
+                aot_movi(a, 1, R_S1, hi.u);
+                aot_emit(a, A64_FMOV_TO_FP(1, 2, R_S1));
+                aot_emit(a, A64_FCMP(1, 1, 2));
+                aot_branch(a, A64_BCOND(CC_GE), AOT_FIX_TRAP | WASM_TRAP_OVERFLOW);
+            }
+            // FCVTZ[SU] saturates and maps NaN to 0: the *_sat semantics
+            aot_emit(a, A64_FCVTZ(u, sf, dbl, d, 0));
+            break;
+        }
+        return WASM_ERR_UNSUPPORTED;
+    }
+    aot_commit(a, h - 1, d);
+    return WASM_OK;
+}
+
+/* =========================================================================
+ * FUNCTION BODY
+ * ========================================================================= */
+
+static int aot_function(aot_t *a, uint32_t fi) {
+    wasm_module_t *m = a->m;
+    wasm_func_t *f = &m->funcs[fi];
+    const wasm_type_t *ft = &m->types[f->type];
+    uint32_t h = 0, live = 1, cc = CC_NONE;
+    int has_imm = 0;
+    int64_t imm = 0;
+
+    a->ir = m->ir + f->ir;
+    a->n = f->ir_len;
+    a->first = f->ir;
+    a->nlocals = f->nlocals;
+    a->nfix = 0;
+    a->trap_used = 0;
+    aot_analyze(a);
+    a->base = 16 + 8 * ((a->nsaved + 1) & ~1U);
+    a->frame = (a->base + 8 * (f->nlocals + f->max_height) + 15) & ~15U;
+
+    f->aot = a->pos * 4;
+    aot_prologue(a, ft);
+
+    for (uint32_t i = 0; i < a->n && !a->err; i++) {
+        const wasm_ins_t *in = &a->ir[i];
+        uint16_t op = in->op;
+        uint32_t r, d;
+
+        a->lpos[i] = a->pos;
+        if (a->lheight[i] >= 0) {
+            if (live && h != (uint32_t)a->lheight[i]) {
+                kprintf("[WASM] ERR: AOT: stack height mismatch at IR %u\n", a->first + i);
+                return WASM_ERR_INVALID;
+            }
+            h = (uint32_t)a->lheight[i];
+            live = 1;
+        }
+        if (!live) {
+            continue;                               // After br/return/unreachable, up to a label
+        }
+
+        switch (op) {
+        /* ===== CONTROL ===== */
+        case 0x00:                                  // unreachable
+            aot_branch(a, A64_B, AOT_FIX_TRAP | WASM_TRAP_UNREACHABLE);
+            live = 0;
+            break;
+
+        case 0x04:                                  // if: false edge to a
+            h--;
+            if (cc != CC_NONE) {
+                aot_branch(a, A64_BCOND(cc ^ 1), in->a - a->first);
+                cc = CC_NONE;
+            } else {
+                aot_branch(a, A64_CBZ(0, aot_src(a, h, R_S0)), in->a - a->first);
+            }
+            break;
+
+        case 0x05:                                  // else, br
+        case 0x0C:
+            if (in->arity) {
+                aot_move(a, h - 1, (uint32_t)in->b - a->nlocals);
+            }
+            aot_branch(a, A64_B, in->a - a->first);
+            live = 0;
+            break;
+
+        case 0x0D: {                                // br_if
+            uint32_t t = (uint32_t)in->b - a->nlocals, skip;
+            h--;
+            if (!in->arity || h - 1 == t) {
+                if (cc != CC_NONE) {
+                    aot_branch(a, A64_BCOND(cc), in->a - a->first);
+                } else {
+                    aot_branch(a, A64_CBNZ(0, aot_src(a, h, R_S0)), in->a - a->first);
+                }
+            } else {
+                uint32_t insn = (cc != CC_NONE) ? A64_BCOND(cc ^ 1) : A64_CBZ(0, aot_src(a, h, R_S0));
+                skip = a->pos;
+                aot_emit(a, insn);
+                aot_move(a, h - 1, t);
+                aot_branch(a, A64_B, in->a - a->first);
+                aot_patch(a, skip, a->pos);
+            }
+            cc = CC_NONE;
+            break;
+        }
+
+        case 0x0E: {                                // br_table
+            const wasm_brtab_t *tab = &m->brtab[in->a];
+            uint32_t count = (uint32_t)in->b, table;
+            h--;
+            r = aot_src(a, h, R_S0);
+            aot_movi(a, 0, R_S1, count - 1);
+            aot_emit(a, A64_CMP(0, r, R_S1));
+            aot_emit(a, A64_CSEL(0, R_S0, r, R_S1, CC_LO));
+            aot_emit(a, A64_ADR(R_S1, 12));
+            aot_emit(a, A64_ADDX_UXTW(R_S1, R_S1, R_S0, 2));
+            aot_emit(a, A64_BR(R_S1));
+            table = a->pos;
+            for (uint32_t e = 0; e < count; e++) {
+                aot_emit(a, A64_B);
+            }
+            for (uint32_t e = 0; e < count; e++) {
+                uint32_t t = tab[e].slot - a->nlocals;
+                if (in->arity && h - 1 != t) {
+                    aot_patch(a, table + e, a->pos);
+                    aot_move(a, h - 1, t);
+                    aot_branch(a, A64_B, tab[e].pc - a->first);
+                } else if (a->nfix < a->fix_cap) {
+                    a->fix[a->nfix].pos = table + e;
+                    a->fix[a->nfix].target = tab[e].pc - a->first;
+                    a->nfix++;
+                } else {
+                    a->err = WASM_ERR_NOMEM;
+                }
+            }
+            live = 0;
+            break;
+        }
+
+        case 0x0F:                                  // return
+            if (in->arity) {
+                r = aot_src(a, h - 1, R_S0);
+                aot_emit(a, A64_MOV(1, 0, r));
+            }
+            aot_epilogue(a);
+            live = 0;
+            break;
+
+        case 0x10:                                  // call
+        case WASM_OP_CALL_HOST: {
+            const wasm_type_t *t = &m->types[m->funcs[in->a].type];
+            h -= t->nparams;
+            if (op == WASM_OP_CALL_HOST) {
+                aot_host_call(a, h, t->nparams, in->a, t);
+            } else {
+                aot_call_args(a, h, t->nparams);
+                if (a->ncalls == a->calls_cap) {
+                    a->err = WASM_ERR_NOMEM;
+                    break;
+                }
+                a->calls[a->ncalls].pos = a->pos;
+                a->calls[a->ncalls].target = in->a;
+                a->ncalls++;
+                aot_emit(a, A64_BL);
+                aot_call_done(a, h, t);
+            }
+            h += t->nresults;
+            break;
+        }
+
+        case 0x11: {                                // call_indirect
+            const wasm_type_t *t = &m->types[in->a];
+            h--;
+            r = aot_src(a, h, R_ARG8);
+            aot_emit(a, A64_LDRW(R_S0, R_VM, WASM_VM_TABLE_SIZE));
+            aot_emit(a, A64_CMP(0, r, R_S0));
+            aot_branch(a, A64_BCOND(CC_HS), AOT_FIX_TRAP | WASM_TRAP_TABLE);
+            aot_emit(a, A64_ADDI(1, R_S1, R_VM, WASM_VM_TABLE));
+            aot_emit(a, A64_ADDX_UXTW(R_S1, R_S1, r, 4));
+            aot_emit(a, A64_LDRW(R_S0, R_S1, 8));
+            aot_emit(a, A64_CMNI(0, R_S0, 1));
+            aot_branch(a, A64_BCOND(CC_EQ), AOT_FIX_TRAP | WASM_TRAP_TABLE);
+            aot_emit(a, A64_CMPI(0, R_S0, in->a));
+            aot_branch(a, A64_BCOND(CC_NE), AOT_FIX_TRAP | WASM_TRAP_SIGNATURE);
+            aot_emit(a, A64_LDRX(R_S1, R_S1, 0));
+            h -= t->nparams;
+            aot_call_args(a, h, t->nparams);
+            aot_emit(a, A64_BLR(R_S1));
+            aot_call_done(a, h, t);
+            h += t->nresults;
+            break;
+        }
+
+        /* ===== PARAMETRIC / VARIABLES ===== */
+        case 0x1A:                                  // drop
+            h--;
+            break;
+
+        case 0x1B: {                                // select
+            uint32_t c = cc;
+            if (c == CC_NONE) {
+                aot_emit(a, A64_CMPI(0, aot_src(a, h - 1, R_S0), 0));
+                c = CC_NE;
+            }
+            cc = CC_NONE;
+            h -= 2;
+            r = aot_src(a, h - 1, R_S0);
+            d = aot_dst(h - 1);
+            aot_emit(a, A64_CSEL(1, d, r, aot_src(a, h, R_S1), c));
+            aot_commit(a, h - 1, d);
+            break;
+        }
+
+        case 0x20:                                  // local.get
+            d = aot_dst(h);
+            if (a->lreg[in->a]) {
+                aot_emit(a, A64_MOV(1, d, a->lreg[in->a]));
+            } else {
+                aot_frame(a, 1, d, aot_slot_off(a, in->a));
+            }
+            aot_commit(a, h, d);
+            h++;
+            break;
+        case 0x21:                                  // local.set
+            h--;
+            aot_local_set(a, in->a, aot_src(a, h, R_S0));
+            break;
+        case 0x22:                                  // local.tee
+            aot_local_set(a, in->a, aot_src(a, h - 1, R_S0));
+            break;
+        case 0x23:                                  // global.get
+            d = aot_dst(h);
+            aot_emit(a, A64_LDRX(d, R_VM, WASM_VM_GLOBALS + 8 * in->a));
+            aot_commit(a, h, d);
+            h++;
+            break;
+        case 0x24:                                  // global.set
+            h--;
+            aot_emit(a, A64_STRX(aot_src(a, h, R_S0), R_VM, WASM_VM_GLOBALS + 8 * in->a));
+            break;
+
+        /* ===== MEMORY ===== */
+        case 0x28: case 0x29: case 0x2A: case 0x2B: case 0x2C: case 0x2D: case 0x2E:
+        case 0x2F: case 0x30: case 0x31: case 0x32: case 0x33: case 0x34: case 0x35: {
+            static const uint8_t size[14] = { 2, 3, 2, 3, 0, 0, 1, 1, 0, 0, 1, 1, 2, 2 };
+            static const uint8_t opc[14] = { 1, 1, 1, 1, 3, 1, 3, 1, 2, 1, 2, 1, 2, 1 };
+            r = aot_src(a, h - 1, R_S0);
+            d = aot_dst(h - 1);
+            aot_mem(a, size[op - 0x28], opc[op - 0x28], d, r, in->a);
+            aot_commit(a, h - 1, d);
+            break;
+        }
+        case 0x36: case 0x37: case 0x38: case 0x39: case 0x3A:
+        case 0x3B: case 0x3C: case 0x3D: case 0x3E: {
+            static const uint8_t size[9] = { 2, 3, 2, 3, 0, 1, 0, 1, 2 };
+            r = aot_src(a, h - 1, R_S0);
+            aot_mem(a, size[op - 0x36], 0, r, aot_src(a, h - 2, R_S1), in->a);
+            h -= 2;
+            break;
+        }
+        case 0x3F:                                  // memory.size
+            d = aot_dst(h);
+            aot_emit(a, A64_LDRX(R_S0, R_VM, WASM_VM_MEM_SIZE));
+            aot_emit(a, A64_UBFM(1, d, R_S0, 16, 63));
+            aot_commit(a, h, d);
+            h++;
+            break;
+        case 0x40: {                                // memory.grow
+            static const wasm_type_t grow = { 1, 1, WASM_I32, { WASM_I32 } };
+            aot_host_call(a, h - 1, 1, WASM_BUILTIN_GROW, &grow);
+            break;
+        }
+        case WASM_OP_FC + 10:                       // memory.copy, memory.fill
+        case WASM_OP_FC + 11: {
+            static const wasm_type_t none = { 3, 0, 0, { WASM_I32, WASM_I32, WASM_I32 } };
+            h -= 3;
+            aot_host_call(a, h, 3, op == WASM_OP_FC + 10 ? WASM_BUILTIN_COPY : WASM_BUILTIN_FILL, &none);
+            break;
+        }
+
+        /* ===== CONSTANTS ===== */
+        case 0x41: case 0x42: case 0x43: case 0x44:
+            if (aot_fold_const(a, i, &imm)) {
+                has_imm = 1;                        // Consumed by ir[i + 1]
+            } else {
+                d = aot_dst(h);
+                aot_movi(a, op == 0x42 || op == 0x44, d, in->b);
+                aot_commit(a, h, d);
+            }
+            h++;
+            break;
+
+        /* ===== NUMERIC ===== */
+        default:
+            if (aot_is_cmp(op)) {
+                uint32_t c = aot_compare(a, op, h, has_imm, imm);
+                const wasm_ins_t *next = (i + 1 < a->n && a->lheight[i + 1] < 0) ? &a->ir[i + 1] : NULL;
+                h -= (op == 0x45 || op == 0x50) ? 0 : 1;
+                if (next != NULL && (next->op == 0x04 || next->op == 0x0D || next->op == 0x1B)) {
+                    cc = c;                         // Fused into the branch/select
+                } else {
+                    d = aot_dst(h - 1);
+                    aot_emit(a, A64_CSET(0, d, c));
+                    aot_commit(a, h - 1, d);
+                }
+            } else if ((op >= 0x6A && op <= 0x78) || (op >= 0x7C && op <= 0x8A)) {
+                aot_int_binop(a, op, h, has_imm, imm);
+                h--;
+            } else if ((op >= 0x92 && op <= 0x98) || (op >= 0xA0 && op <= 0xA6)) {
+                aot_float_binop(a, op, h);
+                h--;
+            } else if (aot_unop(a, op, h) != WASM_OK) {
+                kprintf("[WASM] ERR: AOT: no lowering for op 0x%x\n", op);
+                return WASM_ERR_UNSUPPORTED;
+            }
+            if (op != 0x41 && op != 0x42) {
+                has_imm = 0;
+            }
+            break;
+        }
+    }
+    if (a->err) {
+        return a->err;
+    }
+    a->lpos[a->n] = a->pos;
+
+    /* Trap stubs, then branches */
+    aot_trap_stubs(a);
+    for (uint32_t k = 0; k < a->nfix; k++) {
+        uint32_t t = a->fix[k].target;
+        aot_patch(a, a->fix[k].pos, (t & AOT_FIX_TRAP) ? a->trap_pos[t & ~AOT_FIX_TRAP] : a->lpos[t]);
+    }
+    return a->err;
+}
+
+/* =========================================================================
+ * ENTRY THUNKS / IMPORT STUBS
+ * ========================================================================= */
+
+/*
+ * thunk(vmctx, fn, args): AAPCS entry. Sets up X27/X28, loads fn's
+ * parameters from args[], stores the result to args[0].
+ */
+static void aot_thunk(aot_t *a, const wasm_type_t *t) {
+    aot_emit(a, A64_STP_PRE_FP_LR(96));
+    aot_emit(a, A64_ADDI(1, R_FP, R_SP, 0));
+    for (uint32_t r = 19; r < 29; r += 2) {
+        aot_emit(a, A64_STP(r, r + 1, R_SP, 16 + 8 * (r - 19)));
+    }
+    aot_emit(a, A64_MOV(1, R_VM, 0));
+    aot_emit(a, A64_LDRX(R_MEM, R_VM, WASM_VM_MEM_BASE));
+    aot_emit(a, A64_MOV(1, 19, 2));
+    aot_emit(a, A64_MOV(1, R_S0, 1));
+    for (uint32_t k = 0; k < t->nparams; k++) {
+        if (t->params[k] == WASM_I32 || t->params[k] == WASM_F32) {
+            aot_emit(a, A64_LDRW(k, 19, 8 * k));
+        } else {
+            aot_emit(a, A64_LDRX(k, 19, 8 * k));
+        }
+    }
+    aot_emit(a, A64_BLR(R_S0));
+    if (t->nresults) {
+        aot_emit(a, A64_STRX(0, 19, 0));
+    }
+    for (uint32_t r = 19; r < 29; r += 2) {
+        aot_emit(a, A64_LDP(r, r + 1, R_SP, 16 + 8 * (r - 19)));
+    }
+    aot_emit(a, A64_LDP_POST_FP_LR(96));
+    aot_emit(a, A64_RET);
+}
+
+/* Import 'index' with the compiled-code convention (call_indirect target) */
+static void aot_import_stub(aot_t *a, uint32_t index, const wasm_type_t *t) {
+    aot_emit(a, A64_STP_PRE_FP_LR(160));
+    aot_emit(a, A64_ADDI(1, R_FP, R_SP, 0));
+    for (uint32_t k = 0; k < t->nparams; k++) {
+        aot_emit(a, A64_STRX(k, R_SP, 16 + 8 * k));
+    }
+    aot_emit(a, A64_MOV(1, 0, R_VM));
+    aot_movi(a, 0, 1, index);
+    aot_emit(a, A64_ADDI(1, 2, R_SP, 16));
+    aot_emit(a, A64_LDRX(R_S0, R_VM, WASM_VM_HOST_CALL));
+    aot_emit(a, A64_BLR(R_S0));
+    aot_emit(a, A64_LDRW(R_S0, R_VM, WASM_VM_TRAP));
+    aot_emit(a, A64_CBNZ(0, R_S0) | 4 << 5);        // To the trap tail below
+    // Result bits: i32/f32 zero-extended (one instruction either way)
+    aot_emit(a, A64_MOV(t->nresults && (t->result == WASM_I64 || t->result == WASM_F64), 0, 0));
+    aot_emit(a, A64_LDP_POST_FP_LR(160));
+    aot_emit(a, A64_RET);
+    aot_emit(a, A64_MOV(1, 0, R_VM));
+    aot_emit(a, A64_LDRW(1, R_VM, WASM_VM_TRAP));
+    aot_emit(a, A64_LDRX(R_S0, R_VM, WASM_VM_TRAP_FN));
+    aot_emit(a, A64_BLR(R_S0));
+}
+
+/* =========================================================================
+ * MODULE
+ * ========================================================================= */
+
+static int aot_module(aot_t *a) {
+    wasm_module_t *m = a->m;
+
+    /* 1. Thunks per canonical type, import stubs */
+    for (uint32_t t = 0; t < m->ntypes; t++) {
+        if (m->canon[t] == t) {
+            m->thunk[t] = a->pos * 4;
+            aot_thunk(a, &m->types[t]);
+        }
+    }
+    for (uint32_t t = 0; t < m->ntypes; t++) {
+        m->thunk[t] = m->thunk[m->canon[t]];
+    }
+    for (uint32_t i = 0; i < m->nimports; i++) {
+        m->funcs[i].aot = a->pos * 4;
+        aot_import_stub(a, i, &m->types[m->funcs[i].type]);
+    }
+
+    /* 2. Bodies */
+    a->ncalls = 0;
+    for (uint32_t i = m->nimports; i < m->nfuncs; i++) {
+        int rc = aot_function(a, i);
+        if (rc != WASM_OK) {
+            return rc;
+        }
+    }
+
+    /* 3. Direct calls */
+    for (uint32_t k = 0; k < a->ncalls; k++) {
+        aot_patch(a, a->calls[k].pos, m->funcs[a->calls[k].target].aot / 4);
+    }
+    return a->err;
+}
+
+/*
+ * wasm_aot_compile
+ * Compiles every defined function of 'm'. Afterwards instances can be
+ * created with WASM_MODE_AOT; the code is shared by all of them.
+ */
+int wasm_aot_compile(wasm_module_t *m) {
+    uint64_t t0 = wasm_sys_now_ns();
+    uint32_t max_ir = 0, max_locals = 0;
+    size_t scratch_size, code_bytes;
+    uint8_t *scratch;
+    aot_t a;
+    int rc;
+
+    if (m->code != NULL) {
+        return WASM_OK;
+    }
+    for (uint32_t i = m->nimports; i < m->nfuncs; i++) {
+        max_ir = m->funcs[i].ir_len > max_ir ? m->funcs[i].ir_len : max_ir;
+        max_locals = m->funcs[i].nlocals > max_locals ? m->funcs[i].nlocals : max_locals;
+    }
+
+    /* 1. Working arrays */
+    memset(&a, 0, sizeof(a));
+    a.m = m;
+    a.fix_cap = 3 * m->nir + m->nbrtab + 8;
+    a.calls_cap = m->nir + 1;
+    scratch_size = (max_ir + 1) * (2 * sizeof(int32_t) + sizeof(uint32_t)) +
+                   max_locals * (sizeof(uint32_t) + 1) + 8 +
+                   (a.fix_cap + a.calls_cap) * sizeof(aot_fix_t);
+    scratch = wasm_sys_alloc(scratch_size);
+    m->thunk = wasm_mod_alloc(m, m->ntypes * sizeof(uint32_t));
+    if (scratch == NULL || m->thunk == NULL) {
+        if (scratch != NULL) {
+            wasm_sys_free(scratch, scratch_size);
+        }
+        return WASM_ERR_NOMEM;
+    }
+    a.fix = (aot_fix_t *)scratch;
+    a.calls = a.fix + a.fix_cap;
+    a.lheight = (int32_t *)(a.calls + a.calls_cap);
+    a.depth = a.lheight + max_ir + 1;
+    a.lpos = (uint32_t *)(a.depth + max_ir + 1);
+    a.weight = a.lpos + max_ir + 1;
+    a.lreg = (uint8_t *)(a.weight + max_locals);
+
+    /* 2. Compile; a first estimate that turns out short is retried larger */
+    a.cap = 64 * m->nfuncs + 16 * m->nir + 32 * m->ntypes + 4 * m->nbrtab + 1024;
+    for (;;) {
+        code_bytes = ((size_t)a.cap * 4 + 0xFFF) & ~(size_t)0xFFF;
+        a.cap = (uint32_t)(code_bytes / 4);
+        a.code = wasm_sys_code_alloc(code_bytes);
+        if (a.code == NULL) {
+            rc = WASM_ERR_NOMEM;
+            break;
+        }
+        a.pos = 0;
+        a.err = WASM_OK;
+        rc = aot_module(&a);
+        if (rc == WASM_OK) {
+            break;
+        }
+        wasm_sys_code_free(a.code, code_bytes);
+        a.code = NULL;
+        if (rc != WASM_ERR_NOMEM || a.pos <= a.cap || (uint64_t)a.cap * 8 > WASM_SLOT_CODE_MAX) {
+            break;
+        }
+        a.cap *= 2;
+    }
+    wasm_sys_free(scratch, scratch_size);
+    if (rc != WASM_OK) {
+        if (rc == WASM_ERR_UNSUPPORTED) {
+            kprintf("[WASM] ERR: AOT: branch or call out of range\n");
+        }
+        return rc;
+    }
+
+    m->code = a.code;
+    m->code_size = (size_t)a.pos * 4;
+    m->code_alloc = code_bytes;
+    m->aot_ns = wasm_sys_now_ns() - t0;
+    return WASM_OK;
+}
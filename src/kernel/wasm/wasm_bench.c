@@ -0,0 +1,518 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        wasm_bench.c
+ * Module:      WebAssembly Runtime Benchmark
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Builds a module in memory holding the usual small-kernel suite (call
+ * overhead, byte-array loops, f64 GEMM, bitwise CRC, 64-bit integer
+ * mixing) and runs each kernel through the interpreter, the AOT compiler
+ * and as native C, checking all three agree. Reports load and compile
+ * cost too: the interpreter's case is cold start, the compiler's is
+ * steady state.
+ * ======================================================================================
+ */
+
+#include <string.h>
+#include "kernel/wasm.h"
+
+#define BENCH_FIB_N             30
+#define BENCH_SIEVE_N           (1U << 20)
+#define BENCH_MAT_N             128
+#define BENCH_MAT_A             0x100000U
+#define BENCH_MAT_B             (BENCH_MAT_A + BENCH_MAT_N * BENCH_MAT_N * 8)
+#define BENCH_MAT_C             (BENCH_MAT_B + BENCH_MAT_N * BENCH_MAT_N * 8)
+#define BENCH_CRC_N             (1U << 20)
+#define BENCH_XS_N              10000000U
+#define BENCH_MODULE_MAX        2048
+
+/* =========================================================================
+ * MODULE
+ * ========================================================================= */
+
+/* Opcode shorthands (immediates below 64 only) */
+#define LGET(i)     0x20, (i)
+#define LSET(i)     0x21, (i)
+#define LTEE(i)     0x22, (i)
+#define I32C(v)     0x41, (v)
+#define BLOCK       0x02, 0x40
+#define LOOP        0x03, 0x40
+#define IF          0x04, 0x40
+#define BR(d)       0x0C, (d)
+#define BR_IF(d)    0x0D, (d)
+#define CALL(f)     0x10, (f)
+#define END         0x0B
+#define MEM(op, a)  (op), (a), 0x00
+#define I32_ADD     0x6A
+#define I32_SUB     0x6B
+#define I32_MUL     0x6C
+#define I32_SHL     0x74
+#define I32_GE_U    0x4F
+
+/*
+ * Function indices: 0 photonx.now_ns (import), 1 fib, 2 sieve, 3 gemm,
+ * 4 crc32, 5 xorshift, 6 dispatch
+ */
+
+/* fib(n): n < 2 ? n : fib(n - 1) + fib(n - 2) */
+static const uint8_t bench_fib[] = {
+    0x00,
+    LGET(0), I32C(2), 0x49, 0x04, WASM_I32,
+        LGET(0),
+    0x05,
+        LGET(0), I32C(1), I32_SUB, CALL(1),
+        LGET(0), I32C(2), I32_SUB, CALL(1), I32_ADD,
+    END, END,
+};
+
+/* sieve(n): primes below n, flags at 0 (marks multiples from 2i) */
+static const uint8_t bench_sieve[] = {
+    0x01, 0x03, WASM_I32,                       // i, j, count
+    I32C(0), I32C(1), LGET(0), 0xFC, 0x0B, 0x00,
+    I32C(2), LSET(1),
+    BLOCK, LOOP,
+        LGET(1), LGET(0), I32_GE_U, BR_IF(1),
+        LGET(1), MEM(0x2D, 0),
+        IF,
+            LGET(3), I32C(1), I32_ADD, LSET(3),
+            LGET(1), LGET(1), I32_ADD, LSET(2),
+            BLOCK, LOOP,
+                LGET(2), LGET(0), I32_GE_U, BR_IF(1),
+                LGET(2), I32C(0), MEM(0x3A, 0),
+                LGET(2), LGET(1), I32_ADD, LSET(2),
+                BR(0),
+            END, END,
+        END,
+        LGET(1), I32C(1), I32_ADD, LSET(1),
+        BR(0),
+    END, END,
+    LGET(3),
+    END,
+};
+
+/* gemm(n, a, b, c): C = A x B, f64 row-major */
+static const uint8_t bench_gemm[] = {
+    0x02, 0x03, WASM_I32, 0x01, WASM_F64,       // i, j, k; s
+    I32C(0), LSET(4),
+    BLOCK, LOOP,
+        LGET(4), LGET(0), I32_GE_U, BR_IF(1),
+        I32C(0), LSET(5),
+        BLOCK, LOOP,
+            LGET(5), LGET(0), I32_GE_U, BR_IF(1),
+            0x44, 0, 0, 0, 0, 0, 0, 0, 0, LSET(7),
+            I32C(0), LSET(6),
+            BLOCK, LOOP,
+                LGET(6), LGET(0), I32_GE_U, BR_IF(1),
+                LGET(7),
+                LGET(1), LGET(4), LGET(0), I32_MUL, LGET(6), I32_ADD, I32C(3), I32_SHL, I32_ADD,
+                MEM(0x2B, 3),
+                LGET(2), LGET(6), LGET(0), I32_MUL, LGET(5), I32_ADD, I32C(3), I32_SHL, I32_ADD,
+                MEM(0x2B, 3),
+                0xA2, 0xA0, LSET(7),
+                LGET(6), I32C(1), I32_ADD, LSET(6),
+                BR(0),
+            END, END,
+            LGET(3), LGET(4), LGET(0), I32_MUL, LGET(5), I32_ADD, I32C(3), I32_SHL, I32_ADD,
+            LGET(7), MEM(0x39, 3),
+            LGET(5), I32C(1), I32_ADD, LSET(5),
+            BR(0),
+        END, END,
+        LGET(4), I32C(1), I32_ADD, LSET(4),
+        BR(0),
+    END, END,
+    END,
+};
+
+/* crc32(p, n): CRC-32 (IEEE, reflected), one bit at a time */
+static const uint8_t bench_crc32[] = {
+    0x01, 0x02, WASM_I32,                       // c, k
+    0x41, 0x7F, LSET(2),
+    BLOCK, LOOP,
+        LGET(1), 0x45, BR_IF(1),
+        LGET(2), LGET(0), MEM(0x2D, 0), 0x73, LSET(2),
+        I32C(8), LSET(3),
+        LOOP,
+            LGET(2), I32C(1), 0x76,
+            0x41, 0xA0, 0x86, 0xE2, 0xED, 0x7E,     // 0xEDB88320
+            I32C(0), LGET(2), I32C(1), 0x71, I32_SUB, 0x71,
+            0x73, LSET(2),
+            LGET(3), I32C(1), I32_SUB, LTEE(3), BR_IF(0),
+        END,
+        LGET(0), I32C(1), I32_ADD, LSET(0),
+        LGET(1), I32C(1), I32_SUB, LSET(1),
+        BR(0),
+    END, END,
+    LGET(2), 0x41, 0x7F, 0x73,
+    END,
+};
+
+/* xorshift(n): sum of n xorshift64 outputs */
+static const uint8_t bench_xorshift[] = {
+    0x01, 0x02, WASM_I64,                       // x, s
+    0x42, 0xC4, 0xF4, 0xFD, 0xDD, 0xDC, 0x91, 0xD0, 0x9C, 0x01, LSET(1),
+    BLOCK, LOOP,
+        LGET(0), 0x45, BR_IF(1),
+        LGET(1), LGET(1), 0x42, 13, 0x86, 0x85, LSET(1),
+        LGET(1), LGET(1), 0x42, 7, 0x88, 0x85, LSET(1),
+        LGET(1), LGET(1), 0x42, 17, 0x86, 0x85, LSET(1),
+        LGET(2), LGET(1), 0x7C, LSET(2),
+        LGET(0), I32C(1), I32_SUB, LSET(0),
+        BR(0),
+    END, END,
+    LGET(2),
+    END,
+};
+
+/* dispatch(i, x): table[i](x) */
+static const uint8_t bench_dispatch[] = {
+    0x00,
+    LGET(1), LGET(0), 0x11, 0x00, 0x00,
+    END,
+};
+
+static const uint8_t bench_types[] = {
+    5,
+    0x60, 1, WASM_I32, 1, WASM_I32,                             // 0: (i32) -> i32
+    0x60, 4, WASM_I32, WASM_I32, WASM_I32, WASM_I32, 0,         // 1: gemm
+    0x60, 2, WASM_I32, WASM_I32, 1, WASM_I32,                   // 2: (i32 i32) -> i32
+    0x60, 1, WASM_I32, 1, WASM_I64,                             // 3: (i32) -> i64
+    0x60, 0, 1, WASM_I64,                                       // 4: () -> i64
+};
+
+static const uint8_t bench_imports[] = {
+    1, 7, 'p', 'h', 'o', 't', 'o', 'n', 'x', 6, 'n', 'o', 'w', '_', 'n', 's', 0x00, 4,
+};
+
+static const uint8_t bench_funcs[] = { 6, 0, 0, 1, 2, 3, 2 };
+static const uint8_t bench_table[] = { 1, 0x70, 0x00, 2 };
+static const uint8_t bench_memory[] = { 1, 0x00, 32 };
+static const uint8_t bench_elems[] = { 1, 0x00, I32C(0), END, 2, 1, 2 };
+
+static const uint8_t bench_exports[] = {
+    6,
+    3, 'f', 'i', 'b', 0, 1,
+    5, 's', 'i', 'e', 'v', 'e', 0, 2,
+    4, 'g', 'e', 'm', 'm', 0, 3,
+    5, 'c', 'r', 'c', '3', '2', 0, 4,
+    8, 'x', 'o', 'r', 's', 'h', 'i', 'f', 't', 0, 5,
+    8, 'd', 'i', 's', 'p', 'a', 't', 'c', 'h', 0, 6,
+};
+
+typedef struct {
+    uint8_t *p;
+    uint32_t n;
+} bench_buf_t;
+
+static void bb_byte(bench_buf_t *b, uint8_t v) {
+    if (b->n < BENCH_MODULE_MAX) {
+        b->p[b->n] = v;
+    }
+    b->n++;
+}
+
+static void bb_leb(bench_buf_t *b, uint32_t v) {
+    do {
+        bb_byte(b, (uint8_t)((v & 0x7F) | (v > 0x7F ? 0x80 : 0)));
+        v >>= 7;
+    } while (v);
+}
+
+static void bb_bytes(bench_buf_t *b, const uint8_t *p, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        bb_byte(b, p[i]);
+    }
+}
+
+static void bb_section(bench_buf_t *b, uint8_t id, const uint8_t *p, uint32_t n) {
+    bb_byte(b, id);
+    bb_leb(b, n);
+    bb_bytes(b, p, n);
+}
+
+static uint32_t bench_build(uint8_t *out) {
+    static const uint8_t *const bodies[] = {
+        bench_fib, bench_sieve, bench_gemm, bench_crc32, bench_xorshift, bench_dispatch };
+    static const uint32_t sizes[] = {
+        sizeof(bench_fib), sizeof(bench_sieve), sizeof(bench_gemm), sizeof(bench_crc32),
+        sizeof(bench_xorshift), sizeof(bench_dispatch) };
+    static uint8_t code[BENCH_MODULE_MAX];
+    bench_buf_t b = { out, 0 }, c = { code, 0 };
+
+    bb_bytes(&b, (const uint8_t *)"\0asm\1\0\0\0", 8);
+    bb_section(&b, 1, bench_types, sizeof(bench_types));
+    bb_section(&b, 2, bench_imports, sizeof(bench_imports));
+    bb_section(&b, 3, bench_funcs, sizeof(bench_funcs));
+    bb_section(&b, 4, bench_table, sizeof(bench_table));
+    bb_section(&b, 5, bench_memory, sizeof(bench_memory));
+    bb_section(&b, 7, bench_exports, sizeof(bench_exports));
+    bb_section(&b, 9, bench_elems, sizeof(bench_elems));
+
+    bb_leb(&c, 6);
+    for (uint32_t i = 0; i < 6; i++) {
+        bb_leb(&c, sizes[i]);
+        bb_bytes(&c, bodies[i], sizes[i]);
+    }
+    bb_section(&b, 10, code, c.n);
+    return b.n;
+}
+
+/* =========================================================================
+ * NATIVE REFERENCES
+ * ========================================================================= */
+
+static uint32_t ref_fib(uint32_t n) {
+    return n < 2 ? n : ref_fib(n - 1) + ref_fib(n - 2);
+}
+
+static uint32_t ref_sieve(uint8_t *flags, uint32_t n) {
+    uint32_t count = 0;
+
+    memset(flags, 1, n);
+    for (uint32_t i = 2; i < n; i++) {
+        if (flags[i]) {
+            count++;
+            for (uint32_t j = i + i; j < n; j += i) {
+                flags[j] = 0;
+            }
+        }
+    }
+    return count;
+}
+
+static uint64_t ref_gemm(uint8_t *mem, uint32_t n) {
+    const double *a = (const double *)(mem + BENCH_MAT_A), *b = (const double *)(mem + BENCH_MAT_B);
+    double *c = (double *)(mem + BENCH_MAT_C);
+
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint32_t j = 0; j < n; j++) {
+            double s = 0.0;
+            for (uint32_t k = 0; k < n; k++) {
+                s += a[i * n + k] * b[k * n + j];
+            }
+            c[i * n + j] = s;
+        }
+    }
+    return 0;
+}
+
+static uint32_t ref_crc32(const uint8_t *p, uint32_t n) {
+    uint32_t c = 0xFFFFFFFFU;
+
+    while (n--) {
+        c ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            c = (c >> 1) ^ (0xEDB88320U & (0U - (c & 1)));
+        }
+    }
+    return ~c;
+}
+
+static uint64_t ref_xorshift(uint32_t n) {
+    uint64_t x = 88172645463325252ULL, s = 0;
+
+    while (n--) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        s += x;
+    }
+    return s;
+}
+
+/* =========================================================================
+ * RUNS
+ * ========================================================================= */
+
+#define BENCH_KERNELS           5
+
+static const char *const bench_names[BENCH_KERNELS] = { "fib", "sieve", "gemm", "crc32", "xorshift" };
+
+/* Operands in linear memory (identical before every run) */
+static void bench_prep(uint8_t *mem, uint32_t k) {
+    if (k == 2) {
+        double *a = (double *)(mem + BENCH_MAT_A), *b = (double *)(mem + BENCH_MAT_B);
+        for (uint32_t i = 0; i < BENCH_MAT_N * BENCH_MAT_N; i++) {
+            a[i] = (double)(i % 17) * 0.25 - 2.0;
+            b[i] = (double)(i % 13) * 0.5 - 3.0;
+        }
+    } else if (k == 3) {
+        for (uint32_t i = 0; i < BENCH_CRC_N; i++) {
+            mem[i] = (uint8_t)(i * 2654435761U >> 24);
+        }
+    }
+}
+
+/* Checksum of a GEMM result */
+static uint64_t bench_gemm_sum(const uint8_t *mem) {
+    const uint64_t *c = (const uint64_t *)(mem + BENCH_MAT_C);
+    uint64_t h = 0;
+
+    for (uint32_t i = 0; i < BENCH_MAT_N * BENCH_MAT_N; i++) {
+        h = (h ^ c[i]) * 0x100000001B3ULL;
+    }
+    return h;
+}
+
+static int bench_run(wasm_instance_t *inst, uint32_t k, uint64_t *result, uint64_t *ns) {
+    uint8_t *mem = wasm_mem_ptr(inst, 0, BENCH_MAT_C + BENCH_MAT_N * BENCH_MAT_N * 8);
+    uint64_t args[4] = { 0 }, t0;
+    int rc;
+
+    bench_prep(mem, k);
+    switch (k) {
+    case 0: args[0] = BENCH_FIB_N; break;
+    case 1: args[0] = BENCH_SIEVE_N; break;
+    case 2: args[0] = BENCH_MAT_N; args[1] = BENCH_MAT_A; args[2] = BENCH_MAT_B; args[3] = BENCH_MAT_C; break;
+    case 3: args[0] = 0; args[1] = BENCH_CRC_N; break;
+    default: args[0] = BENCH_XS_N; break;
+    }
+
+    t0 = wasm_sys_now_ns();
+    rc = wasm_call_export(inst, bench_names[k], args);
+    *ns = wasm_sys_now_ns() - t0;
+    *result = (k == 2) ? bench_gemm_sum(mem) : args[0];
+    return rc;
+}
+
+static uint64_t bench_native(uint8_t *mem, uint32_t k, uint64_t *ns) {
+    uint64_t t0, r;
+
+    bench_prep(mem, k);
+    t0 = wasm_sys_now_ns();
+    switch (k) {
+    case 0: r = ref_fib(BENCH_FIB_N); break;
+    case 1: r = ref_sieve(mem, BENCH_SIEVE_N); break;
+    case 2: ref_gemm(mem, BENCH_MAT_N); r = 0; break;
+    case 3: r = ref_crc32(mem, BENCH_CRC_N); break;
+    default: r = ref_xorshift(BENCH_XS_N); break;
+    }
+    *ns = wasm_sys_now_ns() - t0;
+    return (k == 2) ? bench_gemm_sum(mem) : r;
+}
+
+/* Speedup of 'fast' over 'slow' in tenths */
+static uint64_t bench_x10(uint64_t slow, uint64_t fast) {
+    return fast ? slow * 10 / fast : 0;
+}
+
+/*
+ * wasm_benchmark
+ * Loads the suite, compiles it and runs every kernel on both engines
+ * against native C.
+ */
+void wasm_benchmark(void) {
+    static uint8_t bin[BENCH_MODULE_MAX];
+    static wasm_module_t mod;
+    static wasm_instance_t interp, aot;
+    uint64_t native_ns, interp_ns, aot_ns, ref, r_interp, r_aot, t0, inst_ns;
+    uint32_t len = bench_build(bin);
+    int aot_ok, fails = 0;
+    uint8_t *scratch;
+
+    kprintf("\n[WASM] ========== Runtime Benchmark ==========\n");
+    wasm_host_init();
+
+    /* 1. Cold start: decode + validate + lower, then instantiate */
+    if (len > BENCH_MODULE_MAX || wasm_load(&mod, bin, len) != WASM_OK) {
+        kprintf("[WASM] ERR: benchmark module rejected\n");
+        return;
+    }
+    t0 = wasm_sys_now_ns();
+    if (wasm_instantiate(&interp, &mod, WASM_MODE_INTERP) != WASM_OK) {
+        kprintf("[WASM] ERR: instantiation failed\n");
+        wasm_unload(&mod);
+        return;
+    }
+    inst_ns = wasm_sys_now_ns() - t0;
+    kprintf("[WASM] Module: %u bytes, %u functions, %u IR instructions\n", len, mod.nfuncs, mod.nir);
+    kprintf("[WASM] Load + validate %lu us, instantiate %lu us\n", mod.load_ns / 1000, inst_ns / 1000);
+
+    /* 2. Ahead-of-time compile */
+    aot_ok = wasm_aot_compile(&mod) == WASM_OK;
+    if (aot_ok) {
+        kprintf("[WASM] AOT compile %lu us, %lu bytes of AArch64\n", mod.aot_ns / 1000, (uint64_t)mod.code_size);
+        aot_ok = wasm_instantiate(&aot, &mod, WASM_MODE_AOT) == WASM_OK;
+    }
+    if (aot_ok) {
+        uint64_t probe[2] = { 0, 1 };
+        if (wasm_call_export(&aot, "dispatch", probe) == WASM_ERR_NOAOT) {
+            kprintf("[WASM] AOT code cannot run on this host: interpreter only\n");
+            wasm_instance_free(&aot);
+            aot_ok = 0;
+        }
+    }
+
+    /* 3. Kernels */
+    scratch = wasm_sys_alloc(BENCH_MAT_C + BENCH_MAT_N * BENCH_MAT_N * 8);
+    if (scratch == NULL) {
+        kprintf("[WASM] ERR: no memory for the native runs\n");
+        fails++;
+    }
+    for (uint32_t k = 0; k < BENCH_KERNELS && scratch != NULL; k++) {
+        int rc_i, rc_a = WASM_ERR_NOAOT;
+
+        ref = bench_native(scratch, k, &native_ns);
+        rc_i = bench_run(&interp, k, &r_interp, &interp_ns);
+        if (aot_ok) {
+            rc_a = bench_run(&aot, k, &r_aot, &aot_ns);
+        }
+
+        if (rc_i != WASM_OK || r_interp != ref) {
+            kprintf("[WASM] ERR: %s: interpreter %s (got 0x%lx, want 0x%lx)\n", bench_names[k],
+                    rc_i == WASM_OK ? "mismatch" : wasm_trap_name(interp.trap), r_interp, ref);
+            fails++;
+        }
+        if (aot_ok && (rc_a != WASM_OK || r_aot != ref)) {
+            kprintf("[WASM] ERR: %s: AOT %s (got 0x%lx, want 0x%lx)\n", bench_names[k],
+                    rc_a == WASM_OK ? "mismatch" : wasm_trap_name(aot.trap), r_aot, ref);
+            fails++;
+        }
+        if (rc_a == WASM_OK) {
+            kprintf("[WASM] %s: native %lu us, interp %lu us, aot %lu us (%lu.%lux)\n", bench_names[k],
+                    native_ns / 1000, interp_ns / 1000, aot_ns / 1000,
+                    bench_x10(interp_ns, aot_ns) / 10, bench_x10(interp_ns, aot_ns) % 10);
+        } else {
+            kprintf("[WASM] %s: native %lu us, interp %lu us (%lu.%lux native)\n", bench_names[k],
+                    native_ns / 1000, interp_ns / 1000,
+                    bench_x10(interp_ns, native_ns) / 10, bench_x10(interp_ns, native_ns) % 10);
+        }
+    }
+
+    /* 4. Indirect calls and a trap, on both engines */
+    for (uint32_t e = 0; e < 2; e++) {
+        wasm_instance_t *inst = e ? &aot : &interp;
+        uint64_t args[2] = { 0, 20 };
+
+        if (e && !aot_ok) {
+            break;
+        }
+        if (wasm_call_export(inst, "dispatch", args) != WASM_OK || args[0] != 6765) {
+            kprintf("[WASM] ERR: %s: call_indirect\n", e ? "aot" : "interp");
+            fails++;
+        }
+        args[0] = 7;                                // Past the table
+        args[1] = 1;
+        if (wasm_call_export(inst, "dispatch", args) != WASM_ERR_TRAP || inst->trap != WASM_TRAP_TABLE) {
+            kprintf("[WASM] ERR: %s: table bounds not trapped\n", e ? "aot" : "interp");
+            fails++;
+        }
+        args[0] = 0x7FFFFFF0U;                      // sieve(n) with n past memory
+        if (wasm_call_export(inst, "sieve", args) != WASM_ERR_TRAP || inst->trap != WASM_TRAP_MEMORY) {
+            kprintf("[WASM] ERR: %s: out-of-bounds access not trapped\n", e ? "aot" : "interp");
+            fails++;
+        }
+    }
+
+    if (scratch != NULL) {
+        wasm_sys_free(scratch, BENCH_MAT_C + BENCH_MAT_N * BENCH_MAT_N * 8);
+    }
+    if (aot_ok) {
+        wasm_instance_free(&aot);
+    }
+    wasm_instance_free(&interp);
+    wasm_unload(&mod);
+    kprintf("[WASM] %s\n", fails ? "FAILED" : "All results match native");
+}
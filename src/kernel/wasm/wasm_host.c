@@ -0,0 +1,286 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        wasm_host.c
+ * Module:      WebAssembly Host Module "photonx"
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Imports offered to containers:
+ *
+ *   log(ptr, len)                      console line
+ *   now_ns() -> i64                    monotonic clock
+ *   chan_send(ch, ptr, len) -> i32     0, -1 ring full, -2 bad channel/range
+ *   chan_recv(ch, ptr, cap) -> i32     length, -1 empty, -2 bad channel/range,
+ *                                      -3 message longer than cap (left queued)
+ *   hocs_submit(src, dst, dim) -> i32  job slot, or a HOCS_ERR_* code
+ *   hocs_wait(slot, timeout_us) -> i32 HOCS_OK or a HOCS_ERR_* code
+ *
+ * HOCS jobs are full fp32 jobs ([A | B] at src, C at dst, linear memory
+ * offsets). An operand range that is physically contiguous in the
+ * instance's memory goes to the IP as is; otherwise it is staged through
+ * a HOCS buffer (copied in at submit, out at wait).
+ *
+ * Channels carry length-prefixed messages through a single-producer,
+ * single-consumer ring; the kernel binds them to instance channel numbers
+ * with wasm_chan_bind().
+ * ======================================================================================
+ */
+
+#include <string.h>
+#include "kernel/wasm.h"
+
+#define CHAN_HDR                4
+#define CHAN_ALIGN(n)           (((n) + 3) & ~3U)
+#define HOST_LOG_MAX            160
+
+/* =========================================================================
+ * MESSAGE CHANNELS
+ * ========================================================================= */
+
+void wasm_chan_init(wasm_chan_t *c) {
+    memset(c, 0, sizeof(*c));
+}
+
+int wasm_chan_bind(wasm_instance_t *inst, uint32_t index, wasm_chan_t *c) {
+    if (index >= WASM_MAX_CHANNELS) {
+        return WASM_ERR_INVALID;
+    }
+    inst->chan[index] = c;
+    return WASM_OK;
+}
+
+static void chan_copy_in(wasm_chan_t *c, uint32_t pos, const void *src, uint32_t len) {
+    uint32_t off = pos & (WASM_CHAN_BYTES - 1), first = WASM_CHAN_BYTES - off;
+
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&c->ring[off], src, first);
+    memcpy(&c->ring[0], (const uint8_t *)src + first, len - first);
+}
+
+static void chan_copy_out(const wasm_chan_t *c, uint32_t pos, void *dst, uint32_t len) {
+    uint32_t off = pos & (WASM_CHAN_BYTES - 1), first = WASM_CHAN_BYTES - off;
+
+    if (first > len) {
+        first = len;
+    }
+    memcpy(dst, &c->ring[off], first);
+    memcpy((uint8_t *)dst + first, &c->ring[0], len - first);
+}
+
+/*
+ * wasm_chan_send
+ * Producer side. Returns 0, or -1 if the ring has no room (counted in
+ * 'dropped') or the message is too long.
+ */
+int wasm_chan_send(wasm_chan_t *c, const void *msg, uint32_t len) {
+    uint32_t head = c->head, tail = __atomic_load_n(&c->tail, __ATOMIC_ACQUIRE);
+    uint32_t need = CHAN_HDR + CHAN_ALIGN(len);
+
+    if (len > WASM_CHAN_MSG_MAX || need > WASM_CHAN_BYTES - (head - tail)) {
+        c->dropped++;
+        return -1;
+    }
+    chan_copy_in(c, head, &len, CHAN_HDR);
+    chan_copy_in(c, head + CHAN_HDR, msg, len);
+    __atomic_store_n(&c->head, head + need, __ATOMIC_RELEASE);
+    c->sent++;
+    return 0;
+}
+
+/*
+ * wasm_chan_recv
+ * Consumer side. Returns the message length, -1 if the ring is empty, or
+ * -3 if the next message does not fit in 'cap' bytes.
+ */
+int wasm_chan_recv(wasm_chan_t *c, void *buf, uint32_t cap) {
+    uint32_t tail = c->tail, head = __atomic_load_n(&c->head, __ATOMIC_ACQUIRE);
+    uint32_t len;
+
+    if (head == tail) {
+        return -1;
+    }
+    chan_copy_out(c, tail, &len, CHAN_HDR);
+    if (len > cap) {
+        return -3;
+    }
+    chan_copy_out(c, tail + CHAN_HDR, buf, len);
+    __atomic_store_n(&c->tail, tail + CHAN_HDR + CHAN_ALIGN(len), __ATOMIC_RELEASE);
+    return (int)len;
+}
+
+/* =========================================================================
+ * HOST FUNCTIONS
+ * ========================================================================= */
+
+static uint64_t host_log(wasm_instance_t *inst, const uint64_t *args) {
+    uint32_t len = (uint32_t)args[1];
+    char line[HOST_LOG_MAX + 1];
+    const char *s;
+
+    if (len > HOST_LOG_MAX) {
+        len = HOST_LOG_MAX;
+    }
+    s = wasm_mem_ptr(inst, (uint32_t)args[0], len);
+    if (s == NULL) {
+        wasm_trap(inst, WASM_TRAP_MEMORY);
+        return 0;
+    }
+    memcpy(line, s, len);
+    line[len] = 0;
+    kprintf("[WASM %u] %s\n", inst->slot, line);
+    return 0;
+}
+
+static uint64_t host_now_ns(wasm_instance_t *inst, const uint64_t *args) {
+    (void)inst;
+    (void)args;
+    return wasm_sys_now_ns();
+}
+
+static uint64_t host_chan_send(wasm_instance_t *inst, const uint64_t *args) {
+    uint32_t ch = (uint32_t)args[0], len = (uint32_t)args[2];
+    const void *msg = wasm_mem_ptr(inst, (uint32_t)args[1], len);
+
+    if (ch >= WASM_MAX_CHANNELS || inst->chan[ch] == NULL || msg == NULL) {
+        return (uint32_t)-2;
+    }
+    return (uint32_t)wasm_chan_send(inst->chan[ch], msg, len);
+}
+
+static uint64_t host_chan_recv(wasm_instance_t *inst, const uint64_t *args) {
+    uint32_t ch = (uint32_t)args[0], cap = (uint32_t)args[2];
+    void *buf = wasm_mem_ptr(inst, (uint32_t)args[1], cap);
+
+    if (ch >= WASM_MAX_CHANNELS || inst->chan[ch] == NULL || buf == NULL) {
+        return (uint32_t)-2;
+    }
+    return (uint32_t)wasm_chan_recv(inst->chan[ch], buf, cap);
+}
+
+#if WASM_HOST_HOCS
+
+/* Address the IP can read/write 'bytes' at linear offset 'off' through, or 0 */
+static uint64_t hocs_operand(wasm_instance_t *inst, uint32_t off, uint32_t bytes, void **bounce) {
+    const void *p = wasm_mem_ptr(inst, off, bytes);
+    uint64_t pa;
+
+    *bounce = NULL;
+    if (p == NULL) {
+        return 0;
+    }
+    pa = wasm_sys_mem_phys(inst, off, bytes);
+    if (pa != 0) {
+        return pa;
+    }
+    *bounce = hocs_buf_alloc(bytes);
+    if (*bounce == NULL) {
+        return 0;
+    }
+    memcpy(*bounce, p, bytes);
+    return (uint64_t)(uintptr_t)*bounce;
+}
+
+static void hocs_release(struct wasm_hocs_ctx *h, uint32_t slot) {
+    if (h->src_bounce[slot] != NULL) {
+        hocs_buf_free(h->src_bounce[slot], h->src_bytes[slot]);
+        h->src_bounce[slot] = NULL;
+    }
+    if (h->dst_bounce[slot] != NULL) {
+        hocs_buf_free(h->dst_bounce[slot], h->dst_bytes[slot]);
+        h->dst_bounce[slot] = NULL;
+    }
+    h->busy &= ~(1U << slot);
+}
+
+static uint64_t host_hocs_submit(wasm_instance_t *inst, const uint64_t *args) {
+    struct wasm_hocs_ctx *h = inst->hocs;
+    uint32_t src = (uint32_t)args[0], dst = (uint32_t)args[1], dim = (uint32_t)args[2];
+    uint32_t slot, bytes = dim * dim * sizeof(float);
+    hocs_job_t *job;
+    int rc;
+
+    if (h == NULL || dim == 0 || dim > HOCS_MAX_DIM) {
+        return (uint32_t)HOCS_ERR_INVALID;
+    }
+    if (h->busy == (1U << WASM_HOCS_JOBS) - 1) {
+        return (uint32_t)HOCS_ERR_BUSY;
+    }
+    slot = (uint32_t)__builtin_ctz(~h->busy);
+    job = &h->job[slot];
+
+    /* 1. Operands: in place when contiguous, staged otherwise */
+    memset(job, 0, sizeof(*job));
+    h->busy |= 1U << slot;
+    h->src_bytes[slot] = 2 * bytes;
+    h->dst_bytes[slot] = bytes;
+    h->dst_off[slot] = dst;
+    job->src_addr = hocs_operand(inst, src, 2 * bytes, &h->src_bounce[slot]);
+    job->dst_addr = hocs_operand(inst, dst, bytes, &h->dst_bounce[slot]);
+    if (job->src_addr == 0 || job->dst_addr == 0) {
+        hocs_release(h, slot);
+        return (uint32_t)HOCS_ERR_INVALID;
+    }
+    job->matrix_dim = dim;
+
+    /* 2. Queue */
+    rc = hocs_submit(h->dev, job);
+    if (rc != HOCS_OK) {
+        hocs_release(h, slot);
+        return (uint32_t)rc;
+    }
+    h->submitted++;
+    return slot;
+}
+
+static uint64_t host_hocs_wait(wasm_instance_t *inst, const uint64_t *args) {
+    struct wasm_hocs_ctx *h = inst->hocs;
+    uint32_t slot = (uint32_t)args[0];
+    int rc;
+
+    if (h == NULL || slot >= WASM_HOCS_JOBS || !(h->busy & (1U << slot))) {
+        return (uint32_t)HOCS_ERR_INVALID;
+    }
+    rc = hocs_wait(h->dev, &h->job[slot], (uint32_t)args[1]);
+    if (rc == HOCS_ERR_TIMEOUT) {
+        return (uint32_t)rc;                        // Still queued: slot stays busy
+    }
+    if (rc == HOCS_OK && h->dst_bounce[slot] != NULL) {
+        memcpy(wasm_mem_ptr(inst, h->dst_off[slot], h->dst_bytes[slot]),
+               h->dst_bounce[slot], h->dst_bytes[slot]);
+    }
+    hocs_release(h, slot);
+    return (uint32_t)rc;
+}
+
+/*
+ * wasm_hocs_attach
+ * Lets 'inst' submit jobs to 'dev'. 'h' is owned by the caller and must
+ * outlive the instance's last wait.
+ */
+int wasm_hocs_attach(wasm_instance_t *inst, wasm_hocs_ctx_t *h, hocs_device_t *dev) {
+    memset(h, 0, sizeof(*h));
+    h->dev = dev;
+    inst->hocs = h;
+    return WASM_OK;
+}
+
+#endif /* WASM_HOST_HOCS */
+
+static const wasm_host_t host_photonx[] = {
+    { "photonx", "log",         "ii:",   host_log },
+    { "photonx", "now_ns",      ":I",    host_now_ns },
+    { "photonx", "chan_send",   "iii:i", host_chan_send },
+    { "photonx", "chan_recv",   "iii:i", host_chan_recv },
+#if WASM_HOST_HOCS
+    { "photonx", "hocs_submit", "iii:i", host_hocs_submit },
+    { "photonx", "hocs_wait",   "ii:i",  host_hocs_wait },
+#endif
+};
+
+void wasm_host_init(void) {
+    wasm_host_register(host_photonx, sizeof(host_photonx) / sizeof(host_photonx[0]));
+}
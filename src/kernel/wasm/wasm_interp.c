@@ -0,0 +1,648 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        wasm_interp.c
+ * Module:      WebAssembly Interpreter
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Threaded dispatch (computed goto) over the loader's IR. Values live in
+ * 64-bit slots; i32 and f32 occupy the low half with the high half zero.
+ * A frame is the callee's locals followed by its operand stack, and the
+ * caller's outgoing arguments become the callee's first locals in place,
+ * so calls copy nothing. Every linear memory access is bounds checked.
+ * ======================================================================================
+ */
+
+#include <string.h>
+#include "kernel/wasm.h"
+
+typedef struct {
+    const wasm_ins_t *pc;           // Call instruction (NULL: return to the host)
+    uint64_t *fp;
+    const wasm_func_t *f;
+} interp_frame_t;
+
+#define INTERP_FRAMES_BYTES     (WASM_INTERP_FRAMES * sizeof(interp_frame_t))
+
+/* =========================================================================
+ * FLOATING POINT HELPERS
+ * ========================================================================= */
+
+static inline float f32_of(uint64_t v) {
+    union { uint32_t u; float f; } c = { (uint32_t)v };
+    return c.f;
+}
+
+static inline double f64_of(uint64_t v) {
+    union { uint64_t u; double f; } c = { v };
+    return c.f;
+}
+
+static inline uint64_t f32_bits(float f) {
+    union { float f; uint32_t u; } c = { f };
+    return c.u;
+}
+
+static inline uint64_t f64_bits(double f) {
+    union { double f; uint64_t u; } c = { f };
+    return c.u;
+}
+
+#if defined(__aarch64__)
+#define INTERP_FUNARY(name, insn)                                                           \
+    static inline float name##_f32(float x) { asm(insn " %s0, %s1" : "=w" (x) : "w" (x)); return x; } \
+    static inline double name##_f64(double x) { asm(insn " %d0, %d1" : "=w" (x) : "w" (x)); return x; }
+INTERP_FUNARY(fceil, "frintp")
+INTERP_FUNARY(ffloor, "frintm")
+INTERP_FUNARY(ftrunc, "frintz")
+INTERP_FUNARY(fnearest, "frintn")
+INTERP_FUNARY(fsqrt, "fsqrt")
+#else
+static inline float fceil_f32(float x) { return __builtin_ceilf(x); }
+static inline double fceil_f64(double x) { return __builtin_ceil(x); }
+static inline float ffloor_f32(float x) { return __builtin_floorf(x); }
+static inline double ffloor_f64(double x) { return __builtin_floor(x); }
+static inline float ftrunc_f32(float x) { return __builtin_truncf(x); }
+static inline double ftrunc_f64(double x) { return __builtin_trunc(x); }
+static inline float fnearest_f32(float x) { return __builtin_nearbyintf(x); }
+static inline double fnearest_f64(double x) { return __builtin_nearbyint(x); }
+static inline float fsqrt_f32(float x) { return __builtin_sqrtf(x); }
+static inline double fsqrt_f64(double x) { return __builtin_sqrt(x); }
+#endif
+
+/* min/max: NaN if either is NaN, -0 below +0 */
+static inline float fmin_f32(float a, float b) {
+    if (a != a || b != b) return a + b;
+    if (a == b) return f32_of(f32_bits(a) | f32_bits(b));
+    return a < b ? a : b;
+}
+
+static inline float fmax_f32(float a, float b) {
+    if (a != a || b != b) return a + b;
+    if (a == b) return f32_of(f32_bits(a) & f32_bits(b));
+    return a > b ? a : b;
+}
+
+static inline double fmin_f64(double a, double b) {
+    if (a != a || b != b) return a + b;
+    if (a == b) return f64_of(f64_bits(a) | f64_bits(b));
+    return a < b ? a : b;
+}
+
+static inline double fmax_f64(double a, double b) {
+    if (a != a || b != b) return a + b;
+    if (a == b) return f64_of(f64_bits(a) & f64_bits(b));
+    return a > b ? a : b;
+}
+
+/*
+ * Float to integer conversion ranges. A value converts if lo < x < hi;
+ * the bounds are the nearest representable values outside the range.
+ */
+#define TRUNC_I32_S_F32         (-2147483904.0f), 2147483648.0f
+#define TRUNC_I32_S_F64         (-2147483649.0), 2147483648.0
+#define TRUNC_I32_U             (-1.0), 4294967296.0
+#define TRUNC_I64_S_F32         (-9223373136366403584.0f), 9223372036854775808.0f
+#define TRUNC_I64_S_F64         (-9223372036854777856.0), 9223372036854775808.0
+#define TRUNC_I64_U             (-1.0), 18446744073709551616.0
+
+#define TRUNC_OK(x, lo, hi)     ((x) > (lo) && (x) < (hi))
+
+/* =========================================================================
+ * INTERPRETER
+ * ========================================================================= */
+
+#define NEXT()                  do { pc++; goto *disp[pc->op]; } while (0)
+#define JUMP(target)            do { pc = ir + (target); goto *disp[pc->op]; } while (0)
+#define TRAP(code)              do { trap = (code); goto trapped; } while (0)
+
+#define I32(v)                  ((uint32_t)(v))
+#define S32(v)                  ((int32_t)(uint32_t)(v))
+#define S64(v)                  ((int64_t)(v))
+
+#define BIN_I32(expr)           { uint32_t b = I32(sp[-1]), a = I32(sp[-2]); sp--; sp[-1] = (uint32_t)(expr); NEXT(); }
+#define BIN_I64(expr)           { uint64_t b = sp[-1], a = sp[-2]; sp--; sp[-1] = (uint64_t)(expr); NEXT(); }
+#define BIN_F32(expr)           { float b = f32_of(sp[-1]), a = f32_of(sp[-2]); sp--; sp[-1] = f32_bits(expr); NEXT(); }
+#define BIN_F64(expr)           { double b = f64_of(sp[-1]), a = f64_of(sp[-2]); sp--; sp[-1] = f64_bits(expr); NEXT(); }
+#define CMP_F32(expr)           { float b = f32_of(sp[-1]), a = f32_of(sp[-2]); sp--; sp[-1] = (expr); NEXT(); }
+#define CMP_F64(expr)           { double b = f64_of(sp[-1]), a = f64_of(sp[-2]); sp--; sp[-1] = (expr); NEXT(); }
+#define UN(expr)                { uint64_t a = sp[-1]; sp[-1] = (uint64_t)(expr); NEXT(); }
+
+/* Linear memory access: 'ea' is the first byte, N bytes wide */
+#define EA(n)                   uint64_t ea = (uint64_t)I32(sp[-1]) + pc->a; \
+                                if (ea + (n) > mem_size) TRAP(WASM_TRAP_MEMORY)
+#define LOAD(T, n, conv)        { EA(n); T v; memcpy(&v, mem + ea, n); sp[-1] = (uint64_t)(conv); NEXT(); }
+#define STORE(T, n)             { T v = (T)sp[-1]; sp -= 2; { uint64_t ea = (uint64_t)I32(sp[0]) + pc->a; \
+                                  if (ea + (n) > mem_size) TRAP(WASM_TRAP_MEMORY); \
+                                  memcpy(mem + ea, &v, n); } NEXT(); }
+
+/* Trapping float to integer conversion */
+#define TRUNC(F, x, range, T, U) { F v = (x); \
+                                  if (v != v) TRAP(WASM_TRAP_CONVERSION); \
+                                  if (!TRUNC_OK(v, range)) TRAP(WASM_TRAP_OVERFLOW); \
+                                  sp[-1] = (U)(T)v; NEXT(); }
+/* Saturating conversion */
+#define TRUNC_SAT(F, x, range, T, U, tmin, tmax) { F v = (x); \
+                                  sp[-1] = (v != v) ? 0 : !TRUNC_OK(v, range) ? (U)(v < 0 ? (tmin) : (tmax)) : (U)(T)v; \
+                                  NEXT(); }
+
+/*
+ * wasm_interp_call
+ * Runs defined function 'func' to completion (see wasm_call()).
+ */
+int wasm_interp_call(wasm_instance_t *inst, uint32_t func, uint64_t *args) {
+    /* The loader emits nothing outside this table */
+    static const void *const disp[WASM_OP_COUNT] = {
+        [0x00] = &&op_unreachable, [0x04] = &&op_if, [0x05] = &&op_else, [0x0C] = &&op_br,
+        [0x0D] = &&op_br_if, [0x0E] = &&op_br_table, [0x0F] = &&op_return, [0x10] = &&op_call,
+        [0x11] = &&op_call_indirect, [WASM_OP_CALL_HOST] = &&op_call_host,
+        [0x1A] = &&op_drop, [0x1B] = &&op_select,
+        [0x20] = &&op_local_get, [0x21] = &&op_local_set, [0x22] = &&op_local_tee,
+        [0x23] = &&op_global_get, [0x24] = &&op_global_set,
+        [0x28] = &&op_i32_load, [0x29] = &&op_i64_load, [0x2A] = &&op_f32_load, [0x2B] = &&op_f64_load,
+        [0x2C] = &&op_i32_load8_s, [0x2D] = &&op_i32_load8_u, [0x2E] = &&op_i32_load16_s,
+        [0x2F] = &&op_i32_load16_u, [0x30] = &&op_i64_load8_s, [0x31] = &&op_i64_load8_u,
+        [0x32] = &&op_i64_load16_s, [0x33] = &&op_i64_load16_u, [0x34] = &&op_i64_load32_s,
+        [0x35] = &&op_i64_load32_u,
+        [0x36] = &&op_i32_store, [0x37] = &&op_i64_store, [0x38] = &&op_i32_store, [0x39] = &&op_i64_store,
+        [0x3A] = &&op_store8, [0x3B] = &&op_store16, [0x3C] = &&op_store8, [0x3D] = &&op_store16,
+        [0x3E] = &&op_i32_store,
+        [0x3F] = &&op_memory_size, [0x40] = &&op_memory_grow,
+        [0x41] = &&op_const, [0x42] = &&op_const, [0x43] = &&op_const, [0x44] = &&op_const,
+        [0x45] = &&op_i32_eqz, [0x46] = &&op_i32_eq, [0x47] = &&op_i32_ne, [0x48] = &&op_i32_lt_s,
+        [0x49] = &&op_i32_lt_u, [0x4A] = &&op_i32_gt_s, [0x4B] = &&op_i32_gt_u, [0x4C] = &&op_i32_le_s,
+        [0x4D] = &&op_i32_le_u, [0x4E] = &&op_i32_ge_s, [0x4F] = &&op_i32_ge_u,
+        [0x50] = &&op_i64_eqz, [0x51] = &&op_i64_eq, [0x52] = &&op_i64_ne, [0x53] = &&op_i64_lt_s,
+        [0x54] = &&op_i64_lt_u, [0x55] = &&op_i64_gt_s, [0x56] = &&op_i64_gt_u, [0x57] = &&op_i64_le_s,
+        [0x58] = &&op_i64_le_u, [0x59] = &&op_i64_ge_s, [0x5A] = &&op_i64_ge_u,
+        [0x5B] = &&op_f32_eq, [0x5C] = &&op_f32_ne, [0x5D] = &&op_f32_lt, [0x5E] = &&op_f32_gt,
+        [0x5F] = &&op_f32_le, [0x60] = &&op_f32_ge,
+        [0x61] = &&op_f64_eq, [0x62] = &&op_f64_ne, [0x63] = &&op_f64_lt, [0x64] = &&op_f64_gt,
+        [0x65] = &&op_f64_le, [0x66] = &&op_f64_ge,
+        [0x67] = &&op_i32_clz, [0x68] = &&op_i32_ctz, [0x69] = &&op_i32_popcnt,
+        [0x6A] = &&op_i32_add, [0x6B] = &&op_i32_sub, [0x6C] = &&op_i32_mul, [0x6D] = &&op_i32_div_s,
+        [0x6E] = &&op_i32_div_u, [0x6F] = &&op_i32_rem_s, [0x70] = &&op_i32_rem_u, [0x71] = &&op_i32_and,
+        [0x72] = &&op_i32_or, [0x73] = &&op_i32_xor, [0x74] = &&op_i32_shl, [0x75] = &&op_i32_shr_s,
+        [0x76] = &&op_i32_shr_u, [0x77] = &&op_i32_rotl, [0x78] = &&op_i32_rotr,
+        [0x79] = &&op_i64_clz, [0x7A] = &&op_i64_ctz, [0x7B] = &&op_i64_popcnt,
+        [0x7C] = &&op_i64_add, [0x7D] = &&op_i64_sub, [0x7E] = &&op_i64_mul, [0x7F] = &&op_i64_div_s,
+        [0x80] = &&op_i64_div_u, [0x81] = &&op_i64_rem_s, [0x82] = &&op_i64_rem_u, [0x83] = &&op_i64_and,
+        [0x84] = &&op_i64_or, [0x85] = &&op_i64_xor, [0x86] = &&op_i64_shl, [0x87] = &&op_i64_shr_s,
+        [0x88] = &&op_i64_shr_u, [0x89] = &&op_i64_rotl, [0x8A] = &&op_i64_rotr,
+        [0x8B] = &&op_f32_abs, [0x8C] = &&op_f32_neg, [0x8D] = &&op_f32_ceil, [0x8E] = &&op_f32_floor,
+        [0x8F] = &&op_f32_trunc, [0x90] = &&op_f32_nearest, [0x91] = &&op_f32_sqrt,
+        [0x92] = &&op_f32_add, [0x93] = &&op_f32_sub, [0x94] = &&op_f32_mul, [0x95] = &&op_f32_div,
+        [0x96] = &&op_f32_min, [0x97] = &&op_f32_max, [0x98] = &&op_f32_copysign,
+        [0x99] = &&op_f64_abs, [0x9A] = &&op_f64_neg, [0x9B] = &&op_f64_ceil, [0x9C] = &&op_f64_floor,
+        [0x9D] = &&op_f64_trunc, [0x9E] = &&op_f64_nearest, [0x9F] = &&op_f64_sqrt,
+        [0xA0] = &&op_f64_add, [0xA1] = &&op_f64_sub, [0xA2] = &&op_f64_mul, [0xA3] = &&op_f64_div,
+        [0xA4] = &&op_f64_min, [0xA5] = &&op_f64_max, [0xA6] = &&op_f64_copysign,
+        [0xA7] = &&op_i32_wrap, [0xA8] = &&op_i32_trunc_f32_s, [0xA9] = &&op_i32_trunc_f32_u,
+        [0xAA] = &&op_i32_trunc_f64_s, [0xAB] = &&op_i32_trunc_f64_u, [0xAC] = &&op_i64_extend_s,
+        [0xAD] = &&op_i64_extend_u, [0xAE] = &&op_i64_trunc_f32_s, [0xAF] = &&op_i64_trunc_f32_u,
+        [0xB0] = &&op_i64_trunc_f64_s, [0xB1] = &&op_i64_trunc_f64_u,
+        [0xB2] = &&op_f32_convert_i32_s, [0xB3] = &&op_f32_convert_i32_u, [0xB4] = &&op_f32_convert_i64_s,
+        [0xB5] = &&op_f32_convert_i64_u, [0xB6] = &&op_f32_demote,
+        [0xB7] = &&op_f64_convert_i32_s, [0xB8] = &&op_f64_convert_i32_u, [0xB9] = &&op_f64_convert_i64_s,
+        [0xBA] = &&op_f64_convert_i64_u, [0xBB] = &&op_f64_promote,
+        [0xBC] = &&op_nop, [0xBD] = &&op_nop, [0xBE] = &&op_nop, [0xBF] = &&op_nop,
+        [0xC0] = &&op_i32_extend8_s, [0xC1] = &&op_i32_extend16_s, [0xC2] = &&op_i64_extend8_s,
+        [0xC3] = &&op_i64_extend16_s, [0xC4] = &&op_i64_extend32_s,
+        [WASM_OP_FC + 0] = &&op_i32_trunc_sat_f32_s, [WASM_OP_FC + 1] = &&op_i32_trunc_sat_f32_u,
+        [WASM_OP_FC + 2] = &&op_i32_trunc_sat_f64_s, [WASM_OP_FC + 3] = &&op_i32_trunc_sat_f64_u,
+        [WASM_OP_FC + 4] = &&op_i64_trunc_sat_f32_s, [WASM_OP_FC + 5] = &&op_i64_trunc_sat_f32_u,
+        [WASM_OP_FC + 6] = &&op_i64_trunc_sat_f64_s, [WASM_OP_FC + 7] = &&op_i64_trunc_sat_f64_u,
+        [WASM_OP_FC + 10] = &&op_memory_copy, [WASM_OP_FC + 11] = &&op_memory_fill,
+    };
+    const wasm_module_t *m = inst->mod;
+    wasm_vmctx_t *vm = inst->vm;
+    const wasm_ins_t *ir = m->ir, *pc;
+    const wasm_func_t *f = &m->funcs[func], *callee;
+    uint64_t *stack = inst->stack, *stack_end, *fp, *sp;
+    interp_frame_t *frames, *frame, *frames_end;
+    uint8_t *mem = (uint8_t *)(uintptr_t)vm->mem_base;
+    uint64_t mem_size = vm->mem_size;
+    const wasm_type_t *ft = &m->types[f->type];
+    uint32_t trap = WASM_TRAP_NONE, idx;
+
+    if (inst->running) {
+        return WASM_ERR_UNSUPPORTED;                // No reentry from host functions
+    }
+
+    /* 1. Frame stack shares the slot allocation's tail */
+    stack_end = stack + WASM_INTERP_SLOTS - INTERP_FRAMES_BYTES / sizeof(uint64_t);
+    frames = (interp_frame_t *)stack_end;
+    frames_end = frames + WASM_INTERP_FRAMES;
+    if (f->nlocals + f->max_height > (uint64_t)(stack_end - stack)) {
+        inst->trap = WASM_TRAP_STACK;
+        return WASM_ERR_TRAP;
+    }
+
+    /* 2. Entry frame: arguments, zeroed locals */
+    inst->running = 1;
+    frame = frames;
+    frame->pc = NULL;
+    fp = stack;
+    for (uint32_t i = 0; i < ft->nparams; i++) {
+        fp[i] = (ft->params[i] == WASM_I32 || ft->params[i] == WASM_F32) ? (uint32_t)args[i] : args[i];
+    }
+    memset(fp + ft->nparams, 0, (f->nlocals - ft->nparams) * sizeof(uint64_t));
+    sp = fp + f->nlocals;
+    pc = ir + f->ir;
+    goto *disp[pc->op];
+
+    /* =====================================================================
+     * CONTROL
+     * ===================================================================== */
+op_unreachable:
+    TRAP(WASM_TRAP_UNREACHABLE);
+
+op_nop:
+    NEXT();
+
+op_if:
+    if (I32(*--sp) == 0) {
+        JUMP(pc->a);
+    }
+    NEXT();
+
+op_else:
+    JUMP(pc->a);
+
+op_br_if:
+    if (I32(*--sp) == 0) {
+        NEXT();
+    }
+    /* fall through */
+op_br: {
+    uint64_t *dst = fp + (uint32_t)pc->b;
+    if (pc->arity) {
+        *dst = sp[-1];
+    }
+    sp = dst + pc->arity;
+    JUMP(pc->a);
+}
+
+op_br_table: {
+    const wasm_brtab_t *e;
+    uint64_t *dst;
+    idx = I32(*--sp);
+    if (idx >= (uint32_t)pc->b) {
+        idx = (uint32_t)pc->b - 1;
+    }
+    e = &m->brtab[pc->a + idx];
+    dst = fp + e->slot;
+    if (pc->arity) {
+        *dst = sp[-1];
+    }
+    sp = dst + pc->arity;
+    JUMP(e->pc);
+}
+
+op_return:
+    if (pc->arity) {
+        fp[0] = sp[-1];
+    }
+    sp = fp + pc->arity;
+    pc = frame->pc;
+    if (pc == NULL) {
+        goto done;
+    }
+    fp = frame->fp;
+    f = frame->f;
+    frame--;
+    NEXT();
+
+op_call_indirect: {
+    const wasm_elem_slot_t *s;
+    idx = I32(*--sp);
+    if (idx >= vm->table_size || (s = &vm->table[idx])->type == 0xFFFFFFFFU) {
+        TRAP(WASM_TRAP_TABLE);
+    }
+    if (s->type != pc->a) {
+        TRAP(WASM_TRAP_SIGNATURE);
+    }
+    idx = s->func;
+    if (idx < m->nimports) {
+        goto call_host;
+    }
+    goto call;
+}
+
+op_call_host:
+    idx = pc->a;
+call_host: {
+    const wasm_type_t *t = &m->types[m->funcs[idx].type];
+    const wasm_host_t *h = inst->host[idx];
+    uint64_t r;
+
+    sp -= t->nparams;
+    inst->host_calls++;
+    r = h->fn(inst, sp);
+    if (inst->trap) {
+        TRAP(inst->trap);
+    }
+    if (t->nresults) {
+        *sp++ = (t->result == WASM_I32 || t->result == WASM_F32) ? (uint32_t)r : r;
+    }
+    mem = (uint8_t *)(uintptr_t)vm->mem_base;
+    mem_size = vm->mem_size;
+    NEXT();
+}
+
+op_call:
+    idx = pc->a;
+call: {
+    uint64_t *nfp;
+    uint32_t np;
+
+    callee = &m->funcs[idx];
+    np = m->types[callee->type].nparams;
+    nfp = sp - np;
+    if (++frame == frames_end || nfp + callee->nlocals + callee->max_height > stack_end) {
+        frame--;
+        TRAP(WASM_TRAP_STACK);
+    }
+    frame->pc = pc;
+    frame->fp = fp;
+    frame->f = f;
+    for (uint32_t i = np; i < callee->nlocals; i++) {
+        nfp[i] = 0;
+    }
+    fp = nfp;
+    sp = fp + callee->nlocals;
+    f = callee;
+    JUMP(callee->ir);
+}
+
+    /* =====================================================================
+     * PARAMETRIC / VARIABLES
+     * ===================================================================== */
+op_drop:
+    sp--;
+    NEXT();
+
+op_select:
+    sp -= 2;
+    if (I32(sp[1]) == 0) {
+        sp[-1] = sp[0];
+    }
+    NEXT();
+
+op_local_get:
+    *sp++ = fp[pc->a];
+    NEXT();
+op_local_set:
+    fp[pc->a] = *--sp;
+    NEXT();
+op_local_tee:
+    fp[pc->a] = sp[-1];
+    NEXT();
+op_global_get:
+    *sp++ = vm->globals[pc->a];
+    NEXT();
+op_global_set:
+    vm->globals[pc->a] = *--sp;
+    NEXT();
+op_const:
+    *sp++ = pc->b;
+    NEXT();
+
+    /* =====================================================================
+     * MEMORY
+     * ===================================================================== */
+op_i32_load:        LOAD(uint32_t, 4, v)
+op_i64_load:        LOAD(uint64_t, 8, v)
+op_f32_load:        LOAD(uint32_t, 4, v)
+op_f64_load:        LOAD(uint64_t, 8, v)
+op_i32_load8_s:     LOAD(int8_t, 1, (uint32_t)(int32_t)v)
+op_i32_load8_u:     LOAD(uint8_t, 1, v)
+op_i32_load16_s:    LOAD(int16_t, 2, (uint32_t)(int32_t)v)
+op_i32_load16_u:    LOAD(uint16_t, 2, v)
+op_i64_load8_s:     LOAD(int8_t, 1, (int64_t)v)
+op_i64_load8_u:     LOAD(uint8_t, 1, v)
+op_i64_load16_s:    LOAD(int16_t, 2, (int64_t)v)
+op_i64_load16_u:    LOAD(uint16_t, 2, v)
+op_i64_load32_s:    LOAD(int32_t, 4, (int64_t)v)
+op_i64_load32_u:    LOAD(uint32_t, 4, v)
+op_i32_store:       STORE(uint32_t, 4)
+op_i64_store:       STORE(uint64_t, 8)
+op_store8:          STORE(uint8_t, 1)
+op_store16:         STORE(uint16_t, 2)
+
+op_memory_size:
+    *sp++ = mem_size / WASM_PAGE_SIZE;
+    NEXT();
+
+op_memory_grow:
+    sp[-1] = (uint32_t)wasm_mem_grow(inst, I32(sp[-1]));
+    mem = (uint8_t *)(uintptr_t)vm->mem_base;
+    mem_size = vm->mem_size;
+    NEXT();
+
+op_memory_copy: {
+    uint64_t dst = I32(sp[-3]), src = I32(sp[-2]), n = I32(sp[-1]);
+    sp -= 3;
+    if (dst + n > mem_size || src + n > mem_size) {
+        TRAP(WASM_TRAP_MEMORY);
+    }
+    memmove(mem + dst, mem + src, n);
+    NEXT();
+}
+
+op_memory_fill: {
+    uint64_t dst = I32(sp[-3]), n = I32(sp[-1]);
+    uint8_t val = (uint8_t)sp[-2];
+    sp -= 3;
+    if (dst + n > mem_size) {
+        TRAP(WASM_TRAP_MEMORY);
+    }
+    memset(mem + dst, val, n);
+    NEXT();
+}
+
+    /* =====================================================================
+     * NUMERIC
+     * ===================================================================== */
+op_i32_eqz:         UN(I32(a) == 0)
+op_i32_eq:          BIN_I32(a == b)
+op_i32_ne:          BIN_I32(a != b)
+op_i32_lt_s:        BIN_I32((int32_t)a < (int32_t)b)
+op_i32_lt_u:        BIN_I32(a < b)
+op_i32_gt_s:        BIN_I32((int32_t)a > (int32_t)b)
+op_i32_gt_u:        BIN_I32(a > b)
+op_i32_le_s:        BIN_I32((int32_t)a <= (int32_t)b)
+op_i32_le_u:        BIN_I32(a <= b)
+op_i32_ge_s:        BIN_I32((int32_t)a >= (int32_t)b)
+op_i32_ge_u:        BIN_I32(a >= b)
+op_i64_eqz:         UN(a == 0)
+op_i64_eq:          BIN_I64(a == b)
+op_i64_ne:          BIN_I64(a != b)
+op_i64_lt_s:        BIN_I64((int64_t)a < (int64_t)b)
+op_i64_lt_u:        BIN_I64(a < b)
+op_i64_gt_s:        BIN_I64((int64_t)a > (int64_t)b)
+op_i64_gt_u:        BIN_I64(a > b)
+op_i64_le_s:        BIN_I64((int64_t)a <= (int64_t)b)
+op_i64_le_u:        BIN_I64(a <= b)
+op_i64_ge_s:        BIN_I64((int64_t)a >= (int64_t)b)
+op_i64_ge_u:        BIN_I64(a >= b)
+op_f32_eq:          CMP_F32(a == b)
+op_f32_ne:          CMP_F32(a != b)
+op_f32_lt:          CMP_F32(a < b)
+op_f32_gt:          CMP_F32(a > b)
+op_f32_le:          CMP_F32(a <= b)
+op_f32_ge:          CMP_F32(a >= b)
+op_f64_eq:          CMP_F64(a == b)
+op_f64_ne:          CMP_F64(a != b)
+op_f64_lt:          CMP_F64(a < b)
+op_f64_gt:          CMP_F64(a > b)
+op_f64_le:          CMP_F64(a <= b)
+op_f64_ge:          CMP_F64(a >= b)
+
+op_i32_clz:         UN(I32(a) ? __builtin_clz(I32(a)) : 32)
+op_i32_ctz:         UN(I32(a) ? __builtin_ctz(I32(a)) : 32)
+op_i32_popcnt:      UN(__builtin_popcount(I32(a)))
+op_i32_add:         BIN_I32(a + b)
+op_i32_sub:         BIN_I32(a - b)
+op_i32_mul:         BIN_I32(a * b)
+op_i32_div_s:
+    if (I32(sp[-1]) == 0) TRAP(WASM_TRAP_DIV_ZERO);
+    if (S32(sp[-1]) == -1 && I32(sp[-2]) == 0x80000000U) TRAP(WASM_TRAP_OVERFLOW);
+    BIN_I32((int32_t)a / (int32_t)b)
+op_i32_div_u:
+    if (I32(sp[-1]) == 0) TRAP(WASM_TRAP_DIV_ZERO);
+    BIN_I32(a / b)
+op_i32_rem_s:
+    if (I32(sp[-1]) == 0) TRAP(WASM_TRAP_DIV_ZERO);
+    BIN_I32((int32_t)b == -1 ? 0 : (int32_t)a % (int32_t)b)
+op_i32_rem_u:
+    if (I32(sp[-1]) == 0) TRAP(WASM_TRAP_DIV_ZERO);
+    BIN_I32(a % b)
+op_i32_and:         BIN_I32(a & b)
+op_i32_or:          BIN_I32(a | b)
+op_i32_xor:         BIN_I32(a ^ b)
+op_i32_shl:         BIN_I32(a << (b & 31))
+op_i32_shr_s:       BIN_I32((int32_t)a >> (b & 31))
+op_i32_shr_u:       BIN_I32(a >> (b & 31))
+op_i32_rotl:        BIN_I32((a << (b & 31)) | (a >> ((32 - b) & 31)))
+op_i32_rotr:        BIN_I32((a >> (b & 31)) | (a << ((32 - b) & 31)))
+
+op_i64_clz:         UN(a ? __builtin_clzll(a) : 64)
+op_i64_ctz:         UN(a ? __builtin_ctzll(a) : 64)
+op_i64_popcnt:      UN(__builtin_popcountll(a))
+op_i64_add:         BIN_I64(a + b)
+op_i64_sub:         BIN_I64(a - b)
+op_i64_mul:         BIN_I64(a * b)
+op_i64_div_s:
+    if (sp[-1] == 0) TRAP(WASM_TRAP_DIV_ZERO);
+    if (S64(sp[-1]) == -1 && sp[-2] == 0x8000000000000000ULL) TRAP(WASM_TRAP_OVERFLOW);
+    BIN_I64((int64_t)a / (int64_t)b)
+op_i64_div_u:
+    if (sp[-1] == 0) TRAP(WASM_TRAP_DIV_ZERO);
+    BIN_I64(a / b)
+op_i64_rem_s:
+    if (sp[-1] == 0) TRAP(WASM_TRAP_DIV_ZERO);
+    BIN_I64((int64_t)b == -1 ? 0 : (int64_t)a % (int64_t)b)
+op_i64_rem_u:
+    if (sp[-1] == 0) TRAP(WASM_TRAP_DIV_ZERO);
+    BIN_I64(a % b)
+op_i64_and:         BIN_I64(a & b)
+op_i64_or:          BIN_I64(a | b)
+op_i64_xor:         BIN_I64(a ^ b)
+op_i64_shl:         BIN_I64(a << (b & 63))
+op_i64_shr_s:       BIN_I64((int64_t)a >> (b & 63))
+op_i64_shr_u:       BIN_I64(a >> (b & 63))
+op_i64_rotl:        BIN_I64((a << (b & 63)) | (a >> ((64 - b) & 63)))
+op_i64_rotr:        BIN_I64((a >> (b & 63)) | (a << ((64 - b) & 63)))
+
+op_f32_abs:         UN(I32(a) & 0x7FFFFFFFU)
+op_f32_neg:         UN(I32(a) ^ 0x80000000U)
+op_f32_ceil:        UN(f32_bits(fceil_f32(f32_of(a))))
+op_f32_floor:       UN(f32_bits(ffloor_f32(f32_of(a))))
+op_f32_trunc:       UN(f32_bits(ftrunc_f32(f32_of(a))))
+op_f32_nearest:     UN(f32_bits(fnearest_f32(f32_of(a))))
+op_f32_sqrt:        UN(f32_bits(fsqrt_f32(f32_of(a))))
+op_f32_add:         BIN_F32(a + b)
+op_f32_sub:         BIN_F32(a - b)
+op_f32_mul:         BIN_F32(a * b)
+op_f32_div:         BIN_F32(a / b)
+op_f32_min:         BIN_F32(fmin_f32(a, b))
+op_f32_max:         BIN_F32(fmax_f32(a, b))
+op_f32_copysign:
+    sp--;
+    sp[-1] = (I32(sp[-1]) & 0x7FFFFFFFU) | (I32(sp[0]) & 0x80000000U);
+    NEXT();
+
+op_f64_abs:         UN(a & 0x7FFFFFFFFFFFFFFFULL)
+op_f64_neg:         UN(a ^ 0x8000000000000000ULL)
+op_f64_ceil:        UN(f64_bits(fceil_f64(f64_of(a))))
+op_f64_floor:       UN(f64_bits(ffloor_f64(f64_of(a))))
+op_f64_trunc:       UN(f64_bits(ftrunc_f64(f64_of(a))))
+op_f64_nearest:     UN(f64_bits(fnearest_f64(f64_of(a))))
+op_f64_sqrt:        UN(f64_bits(fsqrt_f64(f64_of(a))))
+op_f64_add:         BIN_F64(a + b)
+op_f64_sub:         BIN_F64(a - b)
+op_f64_mul:         BIN_F64(a * b)
+op_f64_div:         BIN_F64(a / b)
+op_f64_min:         BIN_F64(fmin_f64(a, b))
+op_f64_max:         BIN_F64(fmax_f64(a, b))
+op_f64_copysign:
+    sp--;
+    sp[-1] = (sp[-1] & 0x7FFFFFFFFFFFFFFFULL) | (sp[0] & 0x8000000000000000ULL);
+    NEXT();
+
+    /* =====================================================================
+     * CONVERSIONS
+     * ===================================================================== */
+op_i32_wrap:        UN(I32(a))
+op_i32_trunc_f32_s: TRUNC(float, f32_of(sp[-1]), TRUNC_I32_S_F32, int32_t, uint32_t)
+op_i32_trunc_f32_u: TRUNC(float, f32_of(sp[-1]), TRUNC_I32_U, uint32_t, uint32_t)
+op_i32_trunc_f64_s: TRUNC(double, f64_of(sp[-1]), TRUNC_I32_S_F64, int32_t, uint32_t)
+op_i32_trunc_f64_u: TRUNC(double, f64_of(sp[-1]), TRUNC_I32_U, uint32_t, uint32_t)
+op_i64_extend_s:    UN((int64_t)S32(a))
+op_i64_extend_u:    UN(I32(a))
+op_i64_trunc_f32_s: TRUNC(float, f32_of(sp[-1]), TRUNC_I64_S_F32, int64_t, uint64_t)
+op_i64_trunc_f32_u: TRUNC(float, f32_of(sp[-1]), TRUNC_I64_U, uint64_t, uint64_t)
+op_i64_trunc_f64_s: TRUNC(double, f64_of(sp[-1]), TRUNC_I64_S_F64, int64_t, uint64_t)
+op_i64_trunc_f64_u: TRUNC(double, f64_of(sp[-1]), TRUNC_I64_U, uint64_t, uint64_t)
+op_f32_convert_i32_s: UN(f32_bits((float)S32(a)))
+op_f32_convert_i32_u: UN(f32_bits((float)I32(a)))
+op_f32_convert_i64_s: UN(f32_bits((float)S64(a)))
+op_f32_convert_i64_u: UN(f32_bits((float)a))
+op_f32_demote:      UN(f32_bits((float)f64_of(a)))
+op_f64_convert_i32_s: UN(f64_bits((double)S32(a)))
+op_f64_convert_i32_u: UN(f64_bits((double)I32(a)))
+op_f64_convert_i64_s: UN(f64_bits((double)S64(a)))
+op_f64_convert_i64_u: UN(f64_bits((double)a))
+op_f64_promote:     UN(f64_bits((double)f32_of(a)))
+op_i32_extend8_s:   UN((uint32_t)(int32_t)(int8_t)a)
+op_i32_extend16_s:  UN((uint32_t)(int32_t)(int16_t)a)
+op_i64_extend8_s:   UN((int64_t)(int8_t)a)
+op_i64_extend16_s:  UN((int64_t)(int16_t)a)
+op_i64_extend32_s:  UN((int64_t)(int32_t)a)
+
+op_i32_trunc_sat_f32_s: TRUNC_SAT(float, f32_of(sp[-1]), TRUNC_I32_S_F32, int32_t, uint32_t, 0x80000000U, 0x7FFFFFFFU)
+op_i32_trunc_sat_f32_u: TRUNC_SAT(float, f32_of(sp[-1]), TRUNC_I32_U, uint32_t, uint32_t, 0, 0xFFFFFFFFU)
+op_i32_trunc_sat_f64_s: TRUNC_SAT(double, f64_of(sp[-1]), TRUNC_I32_S_F64, int32_t, uint32_t, 0x80000000U, 0x7FFFFFFFU)
+op_i32_trunc_sat_f64_u: TRUNC_SAT(double, f64_of(sp[-1]), TRUNC_I32_U, uint32_t, uint32_t, 0, 0xFFFFFFFFU)
+op_i64_trunc_sat_f32_s: TRUNC_SAT(float, f32_of(sp[-1]), TRUNC_I64_S_F32, int64_t, uint64_t,
+                                  0x8000000000000000ULL, 0x7FFFFFFFFFFFFFFFULL)
+op_i64_trunc_sat_f32_u: TRUNC_SAT(float, f32_of(sp[-1]), TRUNC_I64_U, uint64_t, uint64_t, 0, ~0ULL)
+op_i64_trunc_sat_f64_s: TRUNC_SAT(double, f64_of(sp[-1]), TRUNC_I64_S_F64, int64_t, uint64_t,
+                                  0x8000000000000000ULL, 0x7FFFFFFFFFFFFFFFULL)
+op_i64_trunc_sat_f64_u: TRUNC_SAT(double, f64_of(sp[-1]), TRUNC_I64_U, uint64_t, uint64_t, 0, ~0ULL)
+
+done:
+    if (ft->nresults) {
+        args[0] = stack[0];
+    }
+    inst->running = 0;
+    return WASM_OK;
+
+trapped:
+    inst->trap = trap;
+    inst->running = 0;
+    return WASM_ERR_TRAP;
+}
@@ -0,0 +1,1283 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        wasm_load.c
+ * Module:      WebAssembly Decoder, Validator and IR Lowering
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * One pass over the binary. Function bodies are validated with the usual
+ * operand-type and control stacks and lowered into wasm_ins_t on the fly:
+ *   - block/loop/end produce nothing; branches get their target IR index
+ *     (forward targets through a fixup chain threaded through the 'a'
+ *     fields until the label's end is reached) and the frame slot their
+ *     values land in, so neither back end tracks labels at run time
+ *   - code behind br/return/unreachable/br_table is validated but not
+ *     emitted
+ *   - the function's final end becomes a return; branches to the function
+ *     label target it
+ * The IR never outgrows the code section (every instruction consumes at
+ * least one byte), which sizes its allocation up front.
+ * ======================================================================================
+ */
+
+#include <string.h>
+#include "kernel/wasm.h"
+
+#define LD_NONE                 0xFFFFFFFFU
+#define LD_FIX_BRTAB            0x80000000U     // Fixup chain entry in brtab[]
+#define LD_ANY                  0               // Operand of unknown type (dead code)
+#define LD_CHUNK_SIZE           (64 * 1024)
+
+/* Control Frame Kinds */
+#define CTL_FUNC                0
+#define CTL_BLOCK               1
+#define CTL_LOOP                2
+#define CTL_IF                  3
+#define CTL_ELSE                4
+
+struct wasm_chunk {
+    struct wasm_chunk *next;
+    size_t size;
+    size_t used;
+    size_t pad;
+};
+
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+    int err;
+} ld_rd_t;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t result;                 // Value type, or 0
+    uint8_t unreachable;
+    uint8_t dead;                   // Opened in dead code: nothing inside is emitted
+    uint32_t height;
+    uint32_t label;                 // Loop: IR index; else: fixup chain
+    uint32_t ifpc;                  // If: the IF instruction
+} ld_ctl_t;
+
+typedef struct {
+    wasm_module_t *m;
+    ld_rd_t *r;
+    uint8_t vt[WASM_MAX_HEIGHT];
+    ld_ctl_t ctl[WASM_MAX_NESTING];
+    uint32_t h;
+    uint32_t max_h;
+    uint32_t nctl;
+    uint32_t nlocals;
+    const uint8_t *locals;
+    uint32_t ir_cap;
+    uint32_t brtab_cap;
+    int err;
+} ld_t;
+
+/* Operand and result types of the numeric opcodes (b = 0: one operand) */
+static const struct {
+    uint16_t lo, hi;
+    uint8_t a, b, r;
+} ld_num_sig[] = {
+    { 0x45, 0x45, WASM_I32, 0,        WASM_I32 }, { 0x46, 0x4F, WASM_I32, WASM_I32, WASM_I32 },
+    { 0x50, 0x50, WASM_I64, 0,        WASM_I32 }, { 0x51, 0x5A, WASM_I64, WASM_I64, WASM_I32 },
+    { 0x5B, 0x60, WASM_F32, WASM_F32, WASM_I32 }, { 0x61, 0x66, WASM_F64, WASM_F64, WASM_I32 },
+    { 0x67, 0x69, WASM_I32, 0,        WASM_I32 }, { 0x6A, 0x78, WASM_I32, WASM_I32, WASM_I32 },
+    { 0x79, 0x7B, WASM_I64, 0,        WASM_I64 }, { 0x7C, 0x8A, WASM_I64, WASM_I64, WASM_I64 },
+    { 0x8B, 0x91, WASM_F32, 0,        WASM_F32 }, { 0x92, 0x98, WASM_F32, WASM_F32, WASM_F32 },
+    { 0x99, 0x9F, WASM_F64, 0,        WASM_F64 }, { 0xA0, 0xA6, WASM_F64, WASM_F64, WASM_F64 },
+    { 0xA7, 0xA7, WASM_I64, 0,        WASM_I32 }, { 0xA8, 0xA9, WASM_F32, 0,        WASM_I32 },
+    { 0xAA, 0xAB, WASM_F64, 0,        WASM_I32 }, { 0xAC, 0xAD, WASM_I32, 0,        WASM_I64 },
+    { 0xAE, 0xAF, WASM_F32, 0,        WASM_I64 }, { 0xB0, 0xB1, WASM_F64, 0,        WASM_I64 },
+    { 0xB2, 0xB3, WASM_I32, 0,        WASM_F32 }, { 0xB4, 0xB5, WASM_I64, 0,        WASM_F32 },
+    { 0xB6, 0xB6, WASM_F64, 0,        WASM_F32 }, { 0xB7, 0xB8, WASM_I32, 0,        WASM_F64 },
+    { 0xB9, 0xBA, WASM_I64, 0,        WASM_F64 }, { 0xBB, 0xBB, WASM_F32, 0,        WASM_F64 },
+    { 0xBC, 0xBC, WASM_F32, 0,        WASM_I32 }, { 0xBD, 0xBD, WASM_F64, 0,        WASM_I64 },
+    { 0xBE, 0xBE, WASM_I32, 0,        WASM_F32 }, { 0xBF, 0xBF, WASM_I64, 0,        WASM_F64 },
+    { 0xC0, 0xC1, WASM_I32, 0,        WASM_I32 }, { 0xC2, 0xC4, WASM_I64, 0,        WASM_I64 },
+    { 0x100, 0x101, WASM_F32, 0,      WASM_I32 }, { 0x102, 0x103, WASM_F64, 0,      WASM_I32 },
+    { 0x104, 0x105, WASM_F32, 0,      WASM_I64 }, { 0x106, 0x107, WASM_F64, 0,      WASM_I64 },
+};
+
+/* =========================================================================
+ * MODULE ALLOCATOR
+ * ========================================================================= */
+
+/*
+ * wasm_mod_alloc
+ * Zeroed memory that lives as long as the module (bump allocation in
+ * chunks from the platform layer).
+ */
+void *wasm_mod_alloc(wasm_module_t *m, size_t size) {
+    struct wasm_chunk *c = m->chunks;
+    size_t csize;
+    void *p;
+
+    size = (size + 15) & ~(size_t)15;
+    if (c == NULL || c->used + size > c->size) {
+        csize = size + sizeof(struct wasm_chunk);
+        if (csize < LD_CHUNK_SIZE) {
+            csize = LD_CHUNK_SIZE;
+        }
+        c = wasm_sys_alloc(csize);
+        if (c == NULL) {
+            return NULL;
+        }
+        c->size = csize;
+        c->used = sizeof(struct wasm_chunk);
+
+        // An oversized chunk goes behind the current one, which keeps filling
+        if (m->chunks != NULL && csize > LD_CHUNK_SIZE) {
+            c->next = m->chunks->next;
+            m->chunks->next = c;
+        } else {
+            c->next = m->chunks;
+            m->chunks = c;
+        }
+    }
+
+    p = (uint8_t *)c + c->used;
+    c->used += size;
+    return p;
+}
+
+void wasm_unload(wasm_module_t *m) {
+    struct wasm_chunk *c = m->chunks, *next;
+
+    if (m->code != NULL) {
+        wasm_sys_code_free(m->code, m->code_alloc);
+    }
+    while (c != NULL) {
+        next = c->next;
+        wasm_sys_free(c, c->size);
+        c = next;
+    }
+    m->chunks = NULL;
+    m->code = NULL;
+}
+
+/* =========================================================================
+ * READER
+ * ========================================================================= */
+
+static uint8_t rd_u8(ld_rd_t *r) {
+    if (r->p >= r->end) {
+        r->err = WASM_ERR_MALFORMED;
+        return 0;
+    }
+    return *r->p++;
+}
+
+/* LEB128 of at most 'bits' bits */
+static uint64_t rd_leb(ld_rd_t *r, uint32_t bits, int sign) {
+    uint64_t v = 0;
+    uint32_t shift = 0, n = 0;
+    uint8_t b;
+
+    do {
+        if (r->p >= r->end || n++ == (bits + 6) / 7) {
+            r->err = WASM_ERR_MALFORMED;
+            return 0;
+        }
+        b = *r->p++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+
+    if (sign && shift < 64 && (b & 0x40)) {
+        v |= ~0ULL << shift;
+    }
+    if (bits < 64) {
+        if (sign) {
+            int64_t s = (int64_t)v;
+            if (s < -(1LL << (bits - 1)) || s >= (1LL << (bits - 1))) {
+                r->err = WASM_ERR_MALFORMED;
+            }
+        } else if (v >> bits) {
+            r->err = WASM_ERR_MALFORMED;
+        }
+    }
+    return v;
+}
+
+static inline uint32_t rd_u32(ld_rd_t *r) {
+    return (uint32_t)rd_leb(r, 32, 0);
+}
+
+static uint64_t rd_fixed(ld_rd_t *r, uint32_t bytes) {
+    uint64_t v = 0;
+
+    if ((size_t)(r->end - r->p) < bytes) {
+        r->err = WASM_ERR_MALFORMED;
+        return 0;
+    }
+    for (uint32_t i = 0; i < bytes; i++) {
+        v |= (uint64_t)r->p[i] << (8 * i);
+    }
+    r->p += bytes;
+    return v;
+}
+
+static const char *rd_name(ld_rd_t *r, uint32_t *len) {
+    const char *s;
+
+    *len = rd_u32(r);
+    if (r->err || (size_t)(r->end - r->p) < *len) {
+        r->err = WASM_ERR_MALFORMED;
+        return NULL;
+    }
+    s = (const char *)r->p;
+    r->p += *len;
+    return s;
+}
+
+static inline int ld_valtype(uint8_t t) {
+    return t == WASM_I32 || t == WASM_I64 || t == WASM_F32 || t == WASM_F64;
+}
+
+static uint8_t rd_valtype(ld_rd_t *r) {
+    uint8_t t = rd_u8(r);
+
+    if (!r->err && !ld_valtype(t)) {
+        r->err = (t == 0x7B || t == 0x70 || t == 0x6F) ? WASM_ERR_UNSUPPORTED : WASM_ERR_MALFORMED;
+    }
+    return t;
+}
+
+static void rd_limits(ld_rd_t *r, uint32_t *min, uint32_t *max, uint32_t cap) {
+    uint8_t flags = rd_u8(r);
+
+    if (flags > 1) {
+        r->err = (flags <= 3) ? WASM_ERR_UNSUPPORTED : WASM_ERR_MALFORMED;     // Shared memory
+        return;
+    }
+    *min = rd_u32(r);
+    *max = flags ? rd_u32(r) : cap;
+    if (!r->err && (*min > *max || *max > cap)) {
+        r->err = WASM_ERR_INVALID;
+    }
+}
+
+/* Constant expression of type 't' (no imported globals to refer to) */
+static uint64_t rd_const_expr(ld_rd_t *r, uint8_t t) {
+    uint8_t op = rd_u8(r);
+    uint64_t v = 0;
+
+    switch (op) {
+    case 0x41: v = (uint32_t)rd_leb(r, 32, 1); break;
+    case 0x42: v = rd_leb(r, 64, 1); break;
+    case 0x43: v = rd_fixed(r, 4); break;
+    case 0x44: v = rd_fixed(r, 8); break;
+    default:
+        r->err = WASM_ERR_UNSUPPORTED;
+        return 0;
+    }
+    if (op != 0x41 + (WASM_I32 - t) || rd_u8(r) != 0x0B) {
+        r->err = r->err ? r->err : WASM_ERR_INVALID;
+    }
+    return v;
+}
+
+/*
+ * wasm_parse_sig
+ * Host function signature: "params:result", e.g. "iI:f" (i i32, I i64,
+ * f f32, F f64), result optional.
+ */
+int wasm_parse_sig(const char *sig, wasm_type_t *t) {
+    uint8_t *dst = t->params;
+    uint32_t n = 0;
+
+    t->nparams = 0;
+    t->nresults = 0;
+    t->result = 0;
+    for (; *sig; sig++) {
+        uint8_t v;
+        switch (*sig) {
+        case 'i': v = WASM_I32; break;
+        case 'I': v = WASM_I64; break;
+        case 'f': v = WASM_F32; break;
+        case 'F': v = WASM_F64; break;
+        case ':':
+            if (dst != t->params) return -1;
+            t->nparams = (uint8_t)n;
+            dst = &t->result;
+            n = 0;
+            continue;
+        default:
+            return -1;
+        }
+        if ((dst == t->params && n == WASM_MAX_PARAMS) || (dst == &t->result && n == 1)) {
+            return -1;
+        }
+        dst[n++] = v;
+    }
+    if (dst == t->params) {
+        t->nparams = (uint8_t)n;
+    } else {
+        t->nresults = (uint8_t)n;
+    }
+    return 0;
+}
+
+/* =========================================================================
+ * FUNCTION BODIES
+ * ========================================================================= */
+
+static inline int ld_live(ld_t *ld) {
+    ld_ctl_t *c = &ld->ctl[ld->nctl - 1];
+    return !c->unreachable && !c->dead;
+}
+
+static void ld_push(ld_t *ld, uint8_t t) {
+    if (ld->h == WASM_MAX_HEIGHT) {
+        ld->err = WASM_ERR_UNSUPPORTED;
+        return;
+    }
+    ld->vt[ld->h++] = t;
+    if (ld->h > ld->max_h) {
+        ld->max_h = ld->h;
+    }
+}
+
+/* Pops a value of type 'want' (LD_ANY: any type) and returns its type */
+static uint8_t ld_pop(ld_t *ld, uint8_t want) {
+    ld_ctl_t *c = &ld->ctl[ld->nctl - 1];
+    uint8_t t;
+
+    if (ld->h == c->height) {
+        if (!c->unreachable) {
+            ld->err = WASM_ERR_INVALID;
+        }
+        return want;
+    }
+    t = ld->vt[--ld->h];
+    if (want != LD_ANY && t != LD_ANY && t != want) {
+        ld->err = WASM_ERR_INVALID;
+    }
+    return t != LD_ANY ? t : want;
+}
+
+static void ld_unreachable(ld_t *ld) {
+    ld_ctl_t *c = &ld->ctl[ld->nctl - 1];
+
+    c->unreachable = 1;
+    ld->h = c->height;
+}
+
+static uint32_t ld_emit(ld_t *ld, uint16_t op, uint8_t type, uint8_t arity, uint32_t a, uint64_t b) {
+    wasm_module_t *m = ld->m;
+    wasm_ins_t *i;
+
+    if (!ld_live(ld)) {
+        return LD_NONE;
+    }
+    if (m->nir == ld->ir_cap) {
+        ld->err = WASM_ERR_MALFORMED;
+        return LD_NONE;
+    }
+    i = &m->ir[m->nir];
+    i->op = op;
+    i->type = type;
+    i->arity = arity;
+    i->a = a;
+    i->b = b;
+    return m->nir++;
+}
+
+static void ld_patch(wasm_module_t *m, uint32_t chain, uint32_t pc) {
+    uint32_t next;
+
+    while (chain != LD_NONE) {
+        if (chain & LD_FIX_BRTAB) {
+            wasm_brtab_t *e = &m->brtab[chain & ~LD_FIX_BRTAB];
+            next = e->pc;
+            e->pc = pc;
+        } else {
+            next = m->ir[chain].a;
+            m->ir[chain].a = pc;
+        }
+        chain = next;
+    }
+}
+
+static void ld_push_ctl(ld_t *ld, uint8_t kind, uint8_t result) {
+    ld_ctl_t *c;
+    int dead = ld->nctl && !ld_live(ld);
+
+    if (ld->nctl == WASM_MAX_NESTING) {
+        ld->err = WASM_ERR_UNSUPPORTED;
+        return;
+    }
+    c = &ld->ctl[ld->nctl++];
+    c->kind = kind;
+    c->result = result;
+    c->unreachable = 0;
+    c->dead = (uint8_t)dead;
+    c->height = ld->h;
+    c->label = (kind == CTL_LOOP) ? ld->m->nir : LD_NONE;
+    c->ifpc = LD_NONE;
+}
+
+static uint8_t ld_blocktype(ld_t *ld) {
+    ld_rd_t *r = ld->r;
+    int64_t idx;
+    const wasm_type_t *t;
+
+    if (r->p < r->end && (*r->p == WASM_VOID || ld_valtype(*r->p))) {
+        uint8_t b = *r->p++;
+        return b == WASM_VOID ? 0 : b;
+    }
+    idx = (int64_t)rd_leb(r, 33, 1);
+    if (r->err || idx < 0 || (uint64_t)idx >= ld->m->ntypes) {
+        ld->err = WASM_ERR_INVALID;
+        return 0;
+    }
+    t = &ld->m->types[idx];
+    if (t->nparams) {
+        ld->err = WASM_ERR_UNSUPPORTED;            // Multi-value blocks
+        return 0;
+    }
+    return t->nresults ? t->result : 0;
+}
+
+/* Label 'depth' levels out: its frame, arity and the slot values land in */
+static ld_ctl_t *ld_label(ld_t *ld, uint32_t depth, uint8_t *arity, uint8_t *type) {
+    ld_ctl_t *c;
+
+    if (depth >= ld->nctl) {
+        ld->err = WASM_ERR_INVALID;
+        return NULL;
+    }
+    c = &ld->ctl[ld->nctl - 1 - depth];
+    *type = (c->kind == CTL_LOOP) ? 0 : c->result;
+    *arity = *type ? 1 : 0;
+    return c;
+}
+
+/* Records a branch instruction 'pc' towards frame 'c' */
+static void ld_branch_to(ld_t *ld, ld_ctl_t *c, uint32_t pc) {
+    if (pc == LD_NONE) {
+        return;
+    }
+    if (c->kind == CTL_LOOP) {
+        ld->m->ir[pc].a = c->label;
+    } else {
+        ld->m->ir[pc].a = c->label;
+        c->label = pc;
+    }
+}
+
+static void ld_br_table(ld_t *ld) {
+    wasm_module_t *m = ld->m;
+    ld_rd_t *r = ld->r;
+    uint32_t n = rd_u32(r), first = m->nbrtab;
+    uint8_t arity = 0, type = 0, a, t;
+    int live = ld_live(ld);
+
+    if (r->err || n >= ld->brtab_cap - m->nbrtab) {
+        ld->err = r->err ? r->err : WASM_ERR_MALFORMED;
+        return;
+    }
+    ld_pop(ld, WASM_I32);
+
+    for (uint32_t i = 0; i <= n; i++) {
+        ld_ctl_t *c = ld_label(ld, rd_u32(r), &a, &t);
+        wasm_brtab_t *e = &m->brtab[first + i];
+
+        if (c == NULL || r->err) {
+            ld->err = ld->err ? ld->err : r->err;
+            return;
+        }
+        if (i == 0) {
+            arity = a;
+            type = t;
+        } else if (a != arity || (t != type && !ld->ctl[ld->nctl - 1].unreachable)) {
+            ld->err = WASM_ERR_INVALID;
+            return;
+        }
+        if (live) {
+            e->slot = ld->nlocals + c->height;
+            if (c->kind == CTL_LOOP) {
+                e->pc = c->label;
+            } else {
+                e->pc = c->label;
+                c->label = LD_FIX_BRTAB | (first + i);
+            }
+        }
+    }
+    if (type) {
+        ld_pop(ld, type);
+    }
+    if (live) {
+        m->nbrtab += n + 1;
+        ld_emit(ld, 0x0E, 0, arity, first, n + 1);
+    }
+    ld_unreachable(ld);
+}
+
+static void ld_call(ld_t *ld, const wasm_type_t *t) {
+    for (int i = t->nparams - 1; i >= 0; i--) {
+        ld_pop(ld, t->params[i]);
+    }
+    if (t->nresults) {
+        ld_push(ld, t->result);
+    }
+}
+
+static void ld_memarg(ld_t *ld, uint32_t natural_log2, uint32_t *offset) {
+    uint32_t align = rd_u32(ld->r);
+
+    *offset = rd_u32(ld->r);
+    if (!ld->m->has_mem || align > natural_log2) {
+        ld->err = WASM_ERR_INVALID;
+    }
+}
+
+/*
+ * ld_body
+ * Validates and lowers the body of defined function 'f'.
+ */
+static int ld_body(ld_t *ld, wasm_func_t *f, const wasm_type_t *ft) {
+    static const uint8_t load_type[14] = {
+        WASM_I32, WASM_I64, WASM_F32, WASM_F64, WASM_I32, WASM_I32, WASM_I32, WASM_I32,
+        WASM_I64, WASM_I64, WASM_I64, WASM_I64, WASM_I64, WASM_I64 };
+    static const uint8_t load_log2[14] = { 2, 3, 2, 3, 0, 0, 1, 1, 0, 0, 1, 1, 2, 2 };
+    static const uint8_t store_type[9] = {
+        WASM_I32, WASM_I64, WASM_F32, WASM_F64, WASM_I32, WASM_I32, WASM_I64, WASM_I64, WASM_I64 };
+    static const uint8_t store_log2[9] = { 2, 3, 2, 3, 0, 1, 0, 1, 2 };
+    wasm_module_t *m = ld->m;
+    ld_rd_t *r = ld->r;
+    uint32_t op, idx, off;
+    uint8_t t, a;
+    ld_ctl_t *c;
+
+    ld->h = 0;
+    ld->max_h = 0;
+    ld->nctl = 0;
+    ld->nlocals = f->nlocals;
+    ld->locals = f->local_types;
+    f->ir = m->nir;
+    ld_push_ctl(ld, CTL_FUNC, ft->nresults ? ft->result : 0);
+
+    while (ld->nctl) {
+        if (ld->err || r->err) {
+            break;
+        }
+        op = rd_u8(r);
+
+        switch (op) {
+        case 0x00:                                  // unreachable
+            ld_emit(ld, 0x00, 0, 0, 0, 0);
+            ld_unreachable(ld);
+            break;
+
+        case 0x01:                                  // nop
+            break;
+
+        case 0x02:                                  // block
+        case 0x03:                                  // loop
+            t = ld_blocktype(ld);
+            ld_push_ctl(ld, op == 0x02 ? CTL_BLOCK : CTL_LOOP, t);
+            break;
+
+        case 0x04:                                  // if
+            t = ld_blocktype(ld);
+            ld_pop(ld, WASM_I32);
+            idx = ld_emit(ld, 0x04, 0, 0, LD_NONE, ld->nlocals + ld->h);
+            ld_push_ctl(ld, CTL_IF, t);
+            ld->ctl[ld->nctl - 1].ifpc = idx;
+            break;
+
+        case 0x05:                                  // else
+            c = &ld->ctl[ld->nctl - 1];
+            if (c->kind != CTL_IF) {
+                ld->err = WASM_ERR_INVALID;
+                break;
+            }
+            if (c->result) {
+                ld_pop(ld, c->result);
+            }
+            if (ld->h != c->height) {
+                ld->err = WASM_ERR_INVALID;
+                break;
+            }
+            idx = ld_emit(ld, 0x05, c->result, c->result ? 1 : 0, c->label, ld->nlocals + c->height);
+            if (idx != LD_NONE) {
+                c->label = idx;
+            }
+            if (c->ifpc != LD_NONE) {
+                m->ir[c->ifpc].a = m->nir;
+            }
+            c->kind = CTL_ELSE;
+            c->unreachable = 0;
+            break;
+
+        case 0x0B:                                  // end
+            c = &ld->ctl[ld->nctl - 1];
+            if (c->result) {
+                ld_pop(ld, c->result);
+            }
+            if (ld->h != c->height || (c->kind == CTL_IF && c->result)) {
+                ld->err = WASM_ERR_INVALID;
+                break;
+            }
+            if (c->kind == CTL_IF && c->ifpc != LD_NONE) {
+                m->ir[c->ifpc].a = m->nir;
+            }
+            if (c->kind == CTL_FUNC) {
+                // Emitted even if unreachable: branches to the function label land here
+                c->unreachable = 0;
+                ld_patch(m, c->label, m->nir);
+                ld_emit(ld, 0x0F, c->result, c->result ? 1 : 0, 0, 0);
+            } else if (c->kind != CTL_LOOP) {
+                ld_patch(m, c->label, m->nir);
+            }
+            ld->nctl--;
+            if (ld->nctl && c->result) {
+                ld_push(ld, c->result);
+            }
+            break;
+
+        case 0x0C:                                  // br
+        case 0x0D:                                  // br_if
+            c = ld_label(ld, rd_u32(r), &a, &t);
+            if (c == NULL) {
+                break;
+            }
+            if (op == 0x0D) {
+                ld_pop(ld, WASM_I32);
+            }
+            if (t) {
+                ld_pop(ld, t);
+            }
+            if (op == 0x0C && c == &ld->ctl[0]) {
+                ld_emit(ld, 0x0F, t, a, 0, 0);
+            } else {
+                ld_branch_to(ld, c, ld_emit(ld, (uint16_t)op, t, a, LD_NONE, ld->nlocals + c->height));
+            }
+            if (op == 0x0C) {
+                ld_unreachable(ld);
+            } else if (t) {
+                ld_push(ld, t);
+            }
+            break;
+
+        case 0x0E:                                  // br_table
+            ld_br_table(ld);
+            break;
+
+        case 0x0F:                                  // return
+            t = ld->ctl[0].result;
+            if (t) {
+                ld_pop(ld, t);
+            }
+            ld_emit(ld, 0x0F, t, t ? 1 : 0, 0, 0);
+            ld_unreachable(ld);
+            break;
+
+        case 0x10:                                  // call
+            idx = rd_u32(r);
+            if (idx >= m->nfuncs) {
+                ld->err = WASM_ERR_INVALID;
+                break;
+            }
+            ld_call(ld, &m->types[m->funcs[idx].type]);
+            ld_emit(ld, idx < m->nimports ? WASM_OP_CALL_HOST : 0x10, 0, 0, idx, 0);
+            break;
+
+        case 0x11:                                  // call_indirect
+            idx = rd_u32(r);
+            if (idx >= m->ntypes || rd_u8(r) != 0 || !m->has_table) {
+                ld->err = WASM_ERR_INVALID;
+                break;
+            }
+            ld_pop(ld, WASM_I32);
+            ld_call(ld, &m->types[idx]);
+            ld_emit(ld, 0x11, 0, 0, m->canon[idx], 0);
+            break;
+
+        case 0x1A:                                  // drop
+            t = ld_pop(ld, LD_ANY);
+            ld_emit(ld, 0x1A, t, 0, 0, 0);
+            break;
+
+        case 0x1C:                                  // select t
+            if (rd_u32(r) != 1) {
+                ld->err = WASM_ERR_INVALID;
+                break;
+            }
+            t = rd_valtype(r);
+            ld_pop(ld, WASM_I32);
+            ld_pop(ld, t);
+            ld_pop(ld, t);
+            ld_push(ld, t);
+            ld_emit(ld, 0x1B, t, 0, 0, 0);
+            break;
+
+        case 0x1B:                                  // select
+            ld_pop(ld, WASM_I32);
+            t = ld_pop(ld, LD_ANY);
+            t = ld_pop(ld, t);
+            ld_push(ld, t);
+            ld_emit(ld, 0x1B, t, 0, 0, 0);
+            break;
+
+        case 0x20:                                  // local.get
+        case 0x21:                                  // local.set
+        case 0x22:                                  // local.tee
+            idx = rd_u32(r);
+            if (idx >= ld->nlocals) {
+                ld->err = WASM_ERR_INVALID;
+                break;
+            }
+            t = ld->locals[idx];
+            if (op != 0x20) {
+                ld_pop(ld, t);
+            }
+            if (op != 0x21) {
+                ld_push(ld, t);
+            }
+            ld_emit(ld, (uint16_t)op, t, 0, idx, 0);
+            break;
+
+        case 0x23:                                  // global.get
+        case 0x24:                                  // global.set
+            idx = rd_u32(r);
+            if (idx >= m->nglobals || (op == 0x24 && !m->globals[idx].mut)) {
+                ld->err = WASM_ERR_INVALID;
+                break;
+            }
+            t = m->globals[idx].type;
+            if (op == 0x23) {
+                ld_push(ld, t);
+            } else {
+                ld_pop(ld, t);
+            }
+            ld_emit(ld, (uint16_t)op, t, 0, idx, 0);
+            break;
+
+        case 0x28: case 0x29: case 0x2A: case 0x2B: case 0x2C: case 0x2D: case 0x2E:
+        case 0x2F: case 0x30: case 0x31: case 0x32: case 0x33: case 0x34: case 0x35:
+            ld_memarg(ld, load_log2[op - 0x28], &off);
+            ld_pop(ld, WASM_I32);
+            ld_push(ld, load_type[op - 0x28]);
+            ld_emit(ld, (uint16_t)op, load_type[op - 0x28], 0, off, 0);
+            break;
+
+        case 0x36: case 0x37: case 0x38: case 0x39: case 0x3A:
+        case 0x3B: case 0x3C: case 0x3D: case 0x3E:
+            ld_memarg(ld, store_log2[op - 0x36], &off);
+            ld_pop(ld, store_type[op - 0x36]);
+            ld_pop(ld, WASM_I32);
+            ld_emit(ld, (uint16_t)op, store_type[op - 0x36], 0, off, 0);
+            break;
+
+        case 0x3F:                                  // memory.size
+        case 0x40:                                  // memory.grow
+            if (rd_u8(r) != 0 || !m->has_mem) {
+                ld->err = WASM_ERR_INVALID;
+                break;
+            }
+            if (op == 0x40) {
+                ld_pop(ld, WASM_I32);
+            }
+            ld_push(ld, WASM_I32);
+            ld_emit(ld, (uint16_t)op, WASM_I32, 0, 0, 0);
+            break;
+
+        case 0x41:
+            ld_push(ld, WASM_I32);
+            ld_emit(ld, 0x41, WASM_I32, 0, 0, (uint32_t)rd_leb(r, 32, 1));
+            break;
+        case 0x42:
+            ld_push(ld, WASM_I64);
+            ld_emit(ld, 0x42, WASM_I64, 0, 0, rd_leb(r, 64, 1));
+            break;
+        case 0x43:
+            ld_push(ld, WASM_F32);
+            ld_emit(ld, 0x43, WASM_F32, 0, 0, rd_fixed(r, 4));
+            break;
+        case 0x44:
+            ld_push(ld, WASM_F64);
+            ld_emit(ld, 0x44, WASM_F64, 0, 0, rd_fixed(r, 8));
+            break;
+
+        case 0xFC:
+            op = WASM_OP_FC + rd_u32(r);
+            if (op == WASM_OP_FC + 10 || op == WASM_OP_FC + 11) {
+                // memory.copy dst src n / memory.fill dst val n
+                if (rd_u8(r) != 0 || (op == WASM_OP_FC + 10 && rd_u8(r) != 0) || !m->has_mem) {
+                    ld->err = WASM_ERR_INVALID;
+                    break;
+                }
+                ld_pop(ld, WASM_I32);
+                ld_pop(ld, WASM_I32);
+                ld_pop(ld, WASM_I32);
+                ld_emit(ld, (uint16_t)op, 0, 0, 0, 0);
+                break;
+            }
+            /* trunc_sat: numeric */
+            /* fall through */
+        default: {
+            uint32_t i, n = sizeof(ld_num_sig) / sizeof(ld_num_sig[0]);
+
+            for (i = 0; i < n; i++) {
+                if (op >= ld_num_sig[i].lo && op <= ld_num_sig[i].hi) {
+                    break;
+                }
+            }
+            if (i == n) {
+                ld->err = WASM_ERR_UNSUPPORTED;
+                break;
+            }
+            if (ld_num_sig[i].b) {
+                ld_pop(ld, ld_num_sig[i].b);
+            }
+            ld_pop(ld, ld_num_sig[i].a);
+            ld_push(ld, ld_num_sig[i].r);
+            ld_emit(ld, (uint16_t)op, ld_num_sig[i].r, 0, 0, 0);
+            break;
+        }
+        }
+    }
+
+    if (ld->err || r->err) {
+        return ld->err ? ld->err : r->err;
+    }
+    if (r->p != r->end) {
+        return WASM_ERR_MALFORMED;
+    }
+    f->ir_len = m->nir - f->ir;
+    f->max_height = ld->max_h;
+    return WASM_OK;
+}
+
+/* =========================================================================
+ * SECTIONS
+ * ========================================================================= */
+
+static int ld_types(wasm_module_t *m, ld_rd_t *r) {
+    uint32_t n = rd_u32(r);
+
+    if (r->err || n > WASM_MAX_TYPES) {
+        return r->err ? r->err : WASM_ERR_UNSUPPORTED;
+    }
+    m->ntypes = n;
+    m->types = wasm_mod_alloc(m, n * sizeof(wasm_type_t) + 1);
+    m->canon = wasm_mod_alloc(m, n * sizeof(uint32_t) + 1);
+    if (m->types == NULL || m->canon == NULL) {
+        return WASM_ERR_NOMEM;
+    }
+
+    for (uint32_t i = 0; i < n && !r->err; i++) {
+        wasm_type_t *t = &m->types[i];
+        uint32_t np, nr;
+
+        if (rd_u8(r) != 0x60) {
+            return WASM_ERR_MALFORMED;
+        }
+        np = rd_u32(r);
+        if (np > WASM_MAX_PARAMS) {
+            return WASM_ERR_UNSUPPORTED;
+        }
+        for (uint32_t j = 0; j < np; j++) {
+            t->params[j] = rd_valtype(r);
+        }
+        nr = rd_u32(r);
+        if (nr > 1) {
+            return WASM_ERR_UNSUPPORTED;           // Multi-value
+        }
+        t->nparams = (uint8_t)np;
+        t->nresults = (uint8_t)nr;
+        t->result = nr ? rd_valtype(r) : 0;
+
+        // Canonical index: first structurally equal type
+        m->canon[i] = i;
+        for (uint32_t j = 0; j < i; j++) {
+            const wasm_type_t *u = &m->types[j];
+            if (u->nparams == t->nparams && u->nresults == t->nresults && u->result == t->result &&
+                memcmp(u->params, t->params, t->nparams) == 0) {
+                m->canon[i] = j;
+                break;
+            }
+        }
+    }
+    return r->err;
+}
+
+static int ld_imports(wasm_module_t *m, ld_rd_t *r) {
+    uint32_t n = rd_u32(r);
+
+    if (r->err || n > WASM_MAX_IMPORTS) {
+        return r->err ? r->err : WASM_ERR_UNSUPPORTED;
+    }
+    m->imports = wasm_mod_alloc(m, n * sizeof(wasm_import_t) + 1);
+    if (m->imports == NULL) {
+        return WASM_ERR_NOMEM;
+    }
+    for (uint32_t i = 0; i < n && !r->err; i++) {
+        wasm_import_t *im = &m->imports[i];
+
+        im->module = rd_name(r, &im->module_len);
+        im->name = rd_name(r, &im->name_len);
+        if (rd_u8(r) != 0) {
+            return r->err ? r->err : WASM_ERR_UNSUPPORTED;     // Table, memory and global imports
+        }
+        im->type = rd_u32(r);
+        if (im->type >= m->ntypes) {
+            return WASM_ERR_INVALID;
+        }
+        im->type = m->canon[im->type];
+    }
+    m->nimports = n;
+    m->nfuncs = n;
+    return r->err;
+}
+
+static int ld_funcs_alloc(wasm_module_t *m, uint32_t defined) {
+    if (m->nimports + defined > WASM_MAX_FUNCS) {
+        return WASM_ERR_UNSUPPORTED;
+    }
+    m->nfuncs = m->nimports + defined;
+    m->funcs = wasm_mod_alloc(m, m->nfuncs * sizeof(wasm_func_t) + 1);
+    if (m->funcs == NULL) {
+        return WASM_ERR_NOMEM;
+    }
+    for (uint32_t i = 0; i < m->nimports; i++) {
+        m->funcs[i].type = m->imports[i].type;
+    }
+    return WASM_OK;
+}
+
+static int ld_functions(wasm_module_t *m, ld_rd_t *r) {
+    uint32_t n = rd_u32(r);
+    int rc;
+
+    if (r->err) {
+        return r->err;
+    }
+    rc = ld_funcs_alloc(m, n);
+    for (uint32_t i = 0; i < n && rc == WASM_OK && !r->err; i++) {
+        uint32_t t = rd_u32(r);
+        if (t >= m->ntypes) {
+            return WASM_ERR_INVALID;
+        }
+        m->funcs[m->nimports + i].type = m->canon[t];
+    }
+    return rc ? rc : r->err;
+}
+
+static int ld_globals(wasm_module_t *m, ld_rd_t *r) {
+    uint32_t n = rd_u32(r);
+
+    if (r->err || n > WASM_MAX_GLOBALS) {
+        return r->err ? r->err : WASM_ERR_UNSUPPORTED;
+    }
+    m->nglobals = n;
+    m->globals = wasm_mod_alloc(m, n * sizeof(wasm_global_t) + 1);
+    if (m->globals == NULL) {
+        return WASM_ERR_NOMEM;
+    }
+    for (uint32_t i = 0; i < n && !r->err; i++) {
+        wasm_global_t *g = &m->globals[i];
+
+        g->type = rd_valtype(r);
+        g->mut = rd_u8(r);
+        if (g->mut > 1) {
+            return WASM_ERR_MALFORMED;
+        }
+        g->init = rd_const_expr(r, g->type);
+    }
+    return r->err;
+}
+
+static int ld_exports(wasm_module_t *m, ld_rd_t *r) {
+    uint32_t n = rd_u32(r), lim;
+
+    if (r->err) {
+        return r->err;
+    }
+    m->nexports = n;
+    m->exports = wasm_mod_alloc(m, n * sizeof(wasm_export_t) + 1);
+    if (m->exports == NULL) {
+        return WASM_ERR_NOMEM;
+    }
+    for (uint32_t i = 0; i < n && !r->err; i++) {
+        wasm_export_t *e = &m->exports[i];
+
+        e->name = rd_name(r, &e->name_len);
+        e->kind = rd_u8(r);
+        e->index = rd_u32(r);
+        switch (e->kind) {
+        case 0: lim = m->nfuncs; break;
+        case 1: lim = m->has_table; break;
+        case 2: lim = m->has_mem; break;
+        case 3: lim = m->nglobals; break;
+        default: lim = 0; break;
+        }
+        if (!r->err && e->index >= lim) {
+            return WASM_ERR_INVALID;
+        }
+    }
+    return r->err;
+}
+
+static int ld_elems(wasm_module_t *m, ld_rd_t *r) {
+    uint32_t n = rd_u32(r);
+
+    if (r->err) {
+        return r->err;
+    }
+    m->nelems = n;
+    m->elems = wasm_mod_alloc(m, n * sizeof(wasm_elem_t) + 1);
+    if (m->elems == NULL) {
+        return WASM_ERR_NOMEM;
+    }
+    for (uint32_t i = 0; i < n && !r->err; i++) {
+        wasm_elem_t *e = &m->elems[i];
+        uint32_t *funcs;
+
+        if (rd_u32(r) != 0) {
+            return r->err ? r->err : WASM_ERR_UNSUPPORTED;     // Passive/declarative/expression segments
+        }
+        if (!m->has_table) {
+            return WASM_ERR_INVALID;
+        }
+        e->offset = (uint32_t)rd_const_expr(r, WASM_I32);
+        e->count = rd_u32(r);
+        if (r->err || e->count > WASM_MAX_TABLE) {
+            return r->err ? r->err : WASM_ERR_UNSUPPORTED;
+        }
+        funcs = wasm_mod_alloc(m, e->count * sizeof(uint32_t) + 1);
+        if (funcs == NULL) {
+            return WASM_ERR_NOMEM;
+        }
+        for (uint32_t j = 0; j < e->count; j++) {
+            funcs[j] = rd_u32(r);
+            if (funcs[j] >= m->nfuncs) {
+                return r->err ? r->err : WASM_ERR_INVALID;
+            }
+        }
+        e->funcs = funcs;
+    }
+    return r->err;
+}
+
+static int ld_data(wasm_module_t *m, ld_rd_t *r) {
+    uint32_t n = rd_u32(r), flags;
+
+    if (r->err) {
+        return r->err;
+    }
+    m->ndata = n;
+    m->data = wasm_mod_alloc(m, n * sizeof(wasm_data_t) + 1);
+    if (m->data == NULL) {
+        return WASM_ERR_NOMEM;
+    }
+    for (uint32_t i = 0; i < n && !r->err; i++) {
+        wasm_data_t *d = &m->data[i];
+
+        flags = rd_u32(r);
+        if (flags == 1) {
+            return WASM_ERR_UNSUPPORTED;           // Passive (memory.init)
+        }
+        if ((flags != 0 && flags != 2) || (flags == 2 && rd_u32(r) != 0) || !m->has_mem) {
+            return r->err ? r->err : WASM_ERR_INVALID;
+        }
+        d->offset = (uint32_t)rd_const_expr(r, WASM_I32);
+        d->bytes = (const uint8_t *)rd_name(r, &d->len);
+    }
+    return r->err;
+}
+
+static int ld_code(wasm_module_t *m, ld_rd_t *r, size_t section_size) {
+    uint32_t n = rd_u32(r), defined = m->nfuncs - m->nimports;
+    ld_t *ld;
+    int rc = WASM_OK;
+
+    if (r->err || n != defined) {
+        return r->err ? r->err : WASM_ERR_INVALID;
+    }
+
+    m->ir = wasm_mod_alloc(m, (section_size + 1) * sizeof(wasm_ins_t));
+    m->brtab = wasm_mod_alloc(m, (section_size + 1) * sizeof(wasm_brtab_t));
+    ld = wasm_sys_alloc(sizeof(ld_t));
+    if (m->ir == NULL || m->brtab == NULL || ld == NULL) {
+        if (ld != NULL) {
+            wasm_sys_free(ld, sizeof(ld_t));
+        }
+        return WASM_ERR_NOMEM;
+    }
+    ld->m = m;
+    ld->ir_cap = (uint32_t)section_size + 1;
+    ld->brtab_cap = (uint32_t)section_size + 1;
+
+    for (uint32_t i = 0; i < n && rc == WASM_OK; i++) {
+        wasm_func_t *f = &m->funcs[m->nimports + i];
+        const wasm_type_t *ft = &m->types[f->type];
+        uint32_t size = rd_u32(r), groups, nlocals = ft->nparams;
+        ld_rd_t body;
+        uint8_t *lt;
+        const uint8_t *p;
+
+        if (r->err || (size_t)(r->end - r->p) < size) {
+            rc = WASM_ERR_MALFORMED;
+            break;
+        }
+        body.p = r->p;
+        body.end = r->p + size;
+        body.err = 0;
+        r->p += size;
+
+        // Local declarations: counted first, then expanded
+        groups = rd_u32(&body);
+        p = body.p;
+        for (uint32_t g = 0; g < groups && !body.err; g++) {
+            uint32_t cnt = rd_u32(&body);
+            rd_valtype(&body);
+            if (cnt > WASM_MAX_LOCALS || nlocals + cnt > WASM_MAX_LOCALS) {
+                body.err = WASM_ERR_UNSUPPORTED;
+            }
+            nlocals += cnt;
+        }
+        lt = wasm_mod_alloc(m, nlocals + 1);
+        if (body.err || lt == NULL) {
+            rc = body.err ? body.err : WASM_ERR_NOMEM;
+            break;
+        }
+        memcpy(lt, ft->params, ft->nparams);
+        body.p = p;
+        for (uint32_t g = 0, k = ft->nparams; g < groups; g++) {
+            uint32_t cnt = rd_u32(&body);
+            uint8_t t = rd_valtype(&body);
+            while (cnt--) {
+                lt[k++] = t;
+            }
+        }
+        f->nlocals = nlocals;
+        f->local_types = lt;
+
+        ld->r = &body;
+        ld->err = 0;
+        rc = ld_body(ld, f, ft);
+    }
+
+    wasm_sys_free(ld, sizeof(ld_t));
+    return rc;
+}
+
+/*
+ * wasm_load
+ * Decodes and validates 'bin' into 'm' (zeroed by this call). 'bin' must
+ * stay valid until wasm_unload(). Returns WASM_OK or a WASM_ERR_* code.
+ */
+int wasm_load(wasm_module_t *m, const uint8_t *bin, size_t len) {
+    /* Section order; the data count section (12) sits between 9 and 10 */
+    static const uint8_t rank[13] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 11, 12, 10 };
+    uint64_t t0 = wasm_sys_now_ns();
+    ld_rd_t r = { bin, bin + len, 0 };
+    uint32_t last = 0, code_seen = 0;
+    int rc = WASM_OK;
+
+    memset(m, 0, sizeof(*m));
+    m->start = -1;
+
+    /* 1. Header */
+    if (rd_fixed(&r, 4) != 0x6D736100 || rd_fixed(&r, 4) != 1) {
+        return WASM_ERR_MALFORMED;
+    }
+
+    /* 2. Sections */
+    while (rc == WASM_OK && r.p < r.end) {
+        uint32_t id = rd_u8(&r), size = rd_u32(&r);
+        ld_rd_t s;
+
+        if (r.err || (size_t)(r.end - r.p) < size || id > 12) {
+            rc = WASM_ERR_MALFORMED;
+            break;
+        }
+        s.p = r.p;
+        s.end = r.p + size;
+        s.err = 0;
+        r.p += size;
+
+        if (id == 0) {
+            continue;                               // Custom
+        }
+        if (rank[id] <= last) {
+            rc = WASM_ERR_MALFORMED;
+            break;
+        }
+        last = rank[id];
+        if (id > 3 && m->funcs == NULL) {
+            rc = ld_funcs_alloc(m, 0);
+            if (rc != WASM_OK) {
+                break;
+            }
+        }
+
+        switch (id) {
+        case 1: rc = ld_types(m, &s); break;
+        case 2: rc = ld_imports(m, &s); break;
+        case 3: rc = ld_functions(m, &s); break;
+        case 4:
+            if (rd_u32(&s) > 1 || rd_u8(&s) != 0x70) {
+                rc = s.err ? s.err : WASM_ERR_UNSUPPORTED;
+                break;
+            }
+            rd_limits(&s, &m->table_min, &m->table_max, 0xFFFFFFFFU);
+            if (m->table_max > WASM_MAX_TABLE) {
+                m->table_max = WASM_MAX_TABLE;
+            }
+            if (!s.err && m->table_min > WASM_MAX_TABLE) {
+                rc = WASM_ERR_UNSUPPORTED;
+            }
+            m->has_table = 1;
+            break;
+        case 5:
+            if (rd_u32(&s) > 1) {
+                rc = s.err ? s.err : WASM_ERR_INVALID;
+                break;
+            }
+            rd_limits(&s, &m->mem_min, &m->mem_max, WASM_MAX_PAGES);
+            m->has_mem = 1;
+            break;
+        case 6: rc = ld_globals(m, &s); break;
+        case 7: rc = ld_exports(m, &s); break;
+        case 8:
+            m->start = (int32_t)rd_u32(&s);
+            if (!s.err && ((uint32_t)m->start >= m->nfuncs ||
+                           m->types[m->funcs[m->start].type].nparams ||
+                           m->types[m->funcs[m->start].type].nresults)) {
+                rc = WASM_ERR_INVALID;
+            }
+            break;
+        case 9: rc = ld_elems(m, &s); break;
+        case 10:
+            rc = ld_code(m, &s, size);
+            code_seen = 1;
+            break;
+        case 11: rc = ld_data(m, &s); break;
+        case 12: rd_u32(&s); break;
+        }
+        if (rc == WASM_OK && (s.err || s.p != s.end)) {
+            rc = s.err ? s.err : WASM_ERR_MALFORMED;
+        }
+    }
+
+    /* 3. Every declared function needs a body */
+    if (rc == WASM_OK && m->funcs == NULL) {
+        rc = ld_funcs_alloc(m, 0);
+    }
+    if (rc == WASM_OK && !code_seen && m->nfuncs != m->nimports) {
+        rc = WASM_ERR_INVALID;
+    }
+    if (rc != WASM_OK) {
+        wasm_unload(m);
+        return rc;
+    }
+
+    m->load_ns = wasm_sys_now_ns() - t0;
+    return WASM_OK;
+}
@@ -0,0 +1,363 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        wasm_runtime.c
+ * Module:      WebAssembly Instances, Linking and Calls
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Instantiation links imports against the registered host tables, lays
+ * out the vmctx (globals, table, memory bounds) and applies the element
+ * and data segments. Calls go to the interpreter or, for AOT instances,
+ * through the module's per-type entry thunk on the platform layer.
+ *
+ * Host functions see raw 64-bit argument slots and return raw result
+ * bits. wasm_trap() records a trap; the caller (interpreter loop or the
+ * compiled code behind host_call) raises it when the function returns.
+ * ======================================================================================
+ */
+
+#include <string.h>
+#include "kernel/wasm.h"
+
+#define RT_NULL_TYPE            0xFFFFFFFFU
+
+static const wasm_host_t *host_table[WASM_MAX_HOST_TABLES];
+static uint32_t host_count[WASM_MAX_HOST_TABLES];
+static uint32_t host_tables;
+
+/*
+ * wasm_host_register
+ * Adds a table of host functions. Lookups go in registration order, so an
+ * earlier table shadows later ones. 'fns' must stay valid.
+ */
+int wasm_host_register(const wasm_host_t *fns, uint32_t count) {
+    wasm_type_t t;
+
+    for (uint32_t i = 0; i < host_tables; i++) {
+        if (host_table[i] == fns) {
+            return WASM_OK;
+        }
+    }
+    if (host_tables == WASM_MAX_HOST_TABLES) {
+        return WASM_ERR_NOMEM;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (wasm_parse_sig(fns[i].sig, &t) != 0) {
+            kprintf("[WASM] ERR: bad signature '%s' for %s.%s\n", fns[i].sig, fns[i].module, fns[i].name);
+            return WASM_ERR_INVALID;
+        }
+    }
+    host_table[host_tables] = fns;
+    host_count[host_tables] = count;
+    host_tables++;
+    return WASM_OK;
+}
+
+static int rt_name_eq(const char *s, const char *name, uint32_t len) {
+    return strncmp(s, name, len) == 0 && s[len] == 0;
+}
+
+/* Copies a length-delimited name for printing */
+static const char *rt_name(char *buf, uint32_t cap, const char *name, uint32_t len) {
+    if (len >= cap) {
+        len = cap - 1;
+    }
+    memcpy(buf, name, len);
+    buf[len] = 0;
+    return buf;
+}
+
+static int rt_link(wasm_instance_t *inst) {
+    const wasm_module_t *m = inst->mod;
+    char mod[32], name[48];
+
+    for (uint32_t i = 0; i < m->nimports; i++) {
+        const wasm_import_t *im = &m->imports[i];
+        const wasm_type_t *want = &m->types[im->type];
+        const wasm_host_t *h = NULL;
+        wasm_type_t t;
+
+        for (uint32_t k = 0; k < host_tables && h == NULL; k++) {
+            for (uint32_t j = 0; j < host_count[k]; j++) {
+                if (rt_name_eq(host_table[k][j].module, im->module, im->module_len) &&
+                    rt_name_eq(host_table[k][j].name, im->name, im->name_len)) {
+                    h = &host_table[k][j];
+                    break;
+                }
+            }
+        }
+        if (h == NULL) {
+            kprintf("[WASM] ERR: unresolved import %s.%s\n",
+                    rt_name(mod, sizeof(mod), im->module, im->module_len),
+                    rt_name(name, sizeof(name), im->name, im->name_len));
+            return WASM_ERR_LINK;
+        }
+        wasm_parse_sig(h->sig, &t);
+        if (t.nparams != want->nparams || t.nresults != want->nresults || t.result != want->result ||
+            memcmp(t.params, want->params, t.nparams) != 0) {
+            kprintf("[WASM] ERR: import %s.%s: signature mismatch (host '%s')\n",
+                    h->module, h->name, h->sig);
+            return WASM_ERR_LINK;
+        }
+        inst->host[i] = h;
+    }
+    return WASM_OK;
+}
+
+/*
+ * wasm_mem_grow
+ * memory.grow: commits 'delta' more pages. Returns the previous size in
+ * pages, or -1.
+ */
+int32_t wasm_mem_grow(wasm_instance_t *inst, uint32_t delta) {
+    uint32_t old = inst->pages;
+
+    if (delta == 0) {
+        return (int32_t)old;
+    }
+    if (delta > inst->max_pages - old) {
+        return -1;
+    }
+    if (wasm_sys_mem_commit(inst, old + delta) != 0) {
+        return -1;
+    }
+    inst->pages = old + delta;
+    inst->vm->mem_size = (uint64_t)inst->pages * WASM_PAGE_SIZE;
+    return (int32_t)old;
+}
+
+/*
+ * wasm_mem_ptr
+ * Kernel pointer to [off, off + len) of linear memory, or NULL if the
+ * range is out of bounds.
+ */
+void *wasm_mem_ptr(wasm_instance_t *inst, uint32_t off, uint32_t len) {
+    if ((uint64_t)off + len > inst->vm->mem_size) {
+        return NULL;
+    }
+    return (uint8_t *)(uintptr_t)inst->vm->mem_base + off;
+}
+
+void wasm_trap(wasm_instance_t *inst, uint32_t code) {
+    inst->trap = code;
+    inst->vm->trap = code;
+}
+
+const char *wasm_trap_name(uint32_t code) {
+    static const char *const names[] = {
+        "none", "unreachable", "out of bounds memory access", "integer divide by zero",
+        "integer overflow", "invalid conversion to integer", "undefined element",
+        "indirect call type mismatch", "call stack exhausted", "host trap" };
+
+    return code < sizeof(names) / sizeof(names[0]) ? names[code] : "?";
+}
+
+/*
+ * wasm_host_dispatch
+ * host_call target of compiled code: import 'index' (or a builtin) with
+ * arguments at 'args'. On PhotonX it runs behind SYS_WASM_HOST.
+ */
+uint64_t wasm_host_dispatch(uint64_t vmctx, uint64_t index, uint64_t *args) {
+    wasm_vmctx_t *vm = (wasm_vmctx_t *)(uintptr_t)vmctx;
+    wasm_instance_t *inst = (wasm_instance_t *)(uintptr_t)vm->inst;
+    uint8_t *dst, *src;
+    uint32_t n;
+
+    inst->host_calls++;
+    switch ((uint32_t)index) {
+    case WASM_BUILTIN_GROW:
+        return (uint32_t)wasm_mem_grow(inst, (uint32_t)args[0]);
+
+    case WASM_BUILTIN_COPY:
+        n = (uint32_t)args[2];
+        dst = wasm_mem_ptr(inst, (uint32_t)args[0], n);
+        src = wasm_mem_ptr(inst, (uint32_t)args[1], n);
+        if (dst == NULL || src == NULL) {
+            wasm_trap(inst, WASM_TRAP_MEMORY);
+            return 0;
+        }
+        memmove(dst, src, n);
+        return 0;
+
+    case WASM_BUILTIN_FILL:
+        n = (uint32_t)args[2];
+        dst = wasm_mem_ptr(inst, (uint32_t)args[0], n);
+        if (dst == NULL) {
+            wasm_trap(inst, WASM_TRAP_MEMORY);
+            return 0;
+        }
+        memset(dst, (uint8_t)args[1], n);
+        return 0;
+
+    default:
+        if (index >= inst->mod->nimports) {
+            wasm_trap(inst, WASM_TRAP_HOST);
+            return 0;
+        }
+        return inst->host[index]->fn(inst, args);
+    }
+}
+
+/*
+ * wasm_instantiate
+ * Links 'm' and creates an instance running in 'mode' (WASM_MODE_AOT
+ * needs wasm_aot_compile() first). Runs the start function.
+ */
+int wasm_instantiate(wasm_instance_t *inst, const wasm_module_t *m, uint32_t mode) {
+    wasm_vmctx_t *vm;
+    int rc;
+
+    memset(inst, 0, sizeof(*inst));
+    inst->mod = m;
+    inst->mode = mode;
+    if (mode == WASM_MODE_AOT && m->code == NULL) {
+        return WASM_ERR_NOAOT;
+    }
+
+    /* 1. Imports */
+    rc = rt_link(inst);
+    if (rc != WASM_OK) {
+        return rc;
+    }
+
+    /* 2. vmctx, memory reservation, stacks */
+    if (wasm_sys_instance_init(inst) != 0) {
+        return WASM_ERR_NOMEM;
+    }
+    vm = inst->vm;
+    vm->inst = (uint64_t)(uintptr_t)inst;
+    if (mode == WASM_MODE_INTERP) {
+        inst->stack = wasm_sys_alloc(WASM_INTERP_SLOTS * sizeof(uint64_t));
+        if (inst->stack == NULL) {
+            wasm_instance_free(inst);
+            return WASM_ERR_NOMEM;
+        }
+    } else if (wasm_sys_code_map(inst) != 0) {
+        wasm_instance_free(inst);
+        return WASM_ERR_NOMEM;
+    }
+
+    /* 3. Linear memory */
+    if (m->has_mem) {
+        inst->max_pages = m->mem_max;
+        if (m->mem_min && wasm_sys_mem_commit(inst, m->mem_min) != 0) {
+            wasm_instance_free(inst);
+            return WASM_ERR_NOMEM;
+        }
+        inst->pages = m->mem_min;
+        vm->mem_size = (uint64_t)inst->pages * WASM_PAGE_SIZE;
+    }
+
+    /* 4. Globals and table */
+    for (uint32_t i = 0; i < m->nglobals; i++) {
+        vm->globals[i] = m->globals[i].init;
+    }
+    vm->table_size = m->table_min;
+    for (uint32_t i = 0; i < m->table_min; i++) {
+        vm->table[i].type = RT_NULL_TYPE;
+    }
+
+    /* 5. Segments: all bounds checked before anything is written */
+    for (uint32_t i = 0; i < m->nelems; i++) {
+        if ((uint64_t)m->elems[i].offset + m->elems[i].count > vm->table_size) {
+            rc = WASM_ERR_LINK;
+        }
+    }
+    for (uint32_t i = 0; i < m->ndata; i++) {
+        if ((uint64_t)m->data[i].offset + m->data[i].len > vm->mem_size) {
+            rc = WASM_ERR_LINK;
+        }
+    }
+    if (rc != WASM_OK) {
+        kprintf("[WASM] ERR: segment out of bounds\n");
+        wasm_instance_free(inst);
+        return rc;
+    }
+    for (uint32_t i = 0; i < m->nelems; i++) {
+        const wasm_elem_t *e = &m->elems[i];
+        for (uint32_t j = 0; j < e->count; j++) {
+            wasm_elem_slot_t *s = &vm->table[e->offset + j];
+            s->func = e->funcs[j];
+            s->type = m->funcs[s->func].type;
+            s->code = inst->code_va + m->funcs[s->func].aot;
+        }
+    }
+    for (uint32_t i = 0; i < m->ndata; i++) {
+        if (m->data[i].len) {
+            memcpy(wasm_mem_ptr(inst, m->data[i].offset, m->data[i].len), m->data[i].bytes, m->data[i].len);
+        }
+    }
+
+    /* 6. Start function */
+    if (m->start >= 0) {
+        uint64_t none[1];
+        rc = wasm_call(inst, (uint32_t)m->start, none);
+        if (rc != WASM_OK) {
+            kprintf("[WASM] ERR: start function trapped: %s\n", wasm_trap_name(inst->trap));
+            wasm_instance_free(inst);
+            return rc;
+        }
+    }
+    return WASM_OK;
+}
+
+void wasm_instance_free(wasm_instance_t *inst) {
+    if (inst->stack != NULL) {
+        wasm_sys_free(inst->stack, WASM_INTERP_SLOTS * sizeof(uint64_t));
+        inst->stack = NULL;
+    }
+    if (inst->vm != NULL) {
+        wasm_sys_instance_free(inst);
+        inst->vm = NULL;
+    }
+}
+
+int wasm_find_export(const wasm_module_t *m, const char *name, uint32_t *func) {
+    for (uint32_t i = 0; i < m->nexports; i++) {
+        const wasm_export_t *e = &m->exports[i];
+        if (e->kind == 0 && rt_name_eq(name, e->name, e->name_len)) {
+            *func = e->index;
+            return WASM_OK;
+        }
+    }
+    return WASM_ERR_NOTFOUND;
+}
+
+/*
+ * wasm_call
+ * Calls function 'func' with its parameters in args[] (one slot each);
+ * the result, if any, comes back in args[0]. WASM_ERR_TRAP leaves the
+ * trap code in inst->trap.
+ */
+int wasm_call(wasm_instance_t *inst, uint32_t func, uint64_t *args) {
+    const wasm_module_t *m = inst->mod;
+    uint32_t type;
+
+    if (func >= m->nfuncs) {
+        return WASM_ERR_NOTFOUND;
+    }
+    inst->trap = WASM_TRAP_NONE;
+    inst->vm->trap = WASM_TRAP_NONE;
+
+    if (func < m->nimports) {
+        args[0] = inst->host[func]->fn(inst, args);
+        return inst->trap ? WASM_ERR_TRAP : WASM_OK;
+    }
+    if (inst->mode == WASM_MODE_INTERP) {
+        return wasm_interp_call(inst, func, args);
+    }
+
+    type = m->funcs[func].type;
+    return wasm_sys_aot_call(inst, inst->code_va + m->thunk[type], inst->code_va + m->funcs[func].aot, args);
+}
+
+int wasm_call_export(wasm_instance_t *inst, const char *name, uint64_t *args) {
+    uint32_t func;
+
+    if (wasm_find_export(inst->mod, name, &func) != WASM_OK) {
+        return WASM_ERR_NOTFOUND;
+    }
+    return wasm_call(inst, func, args);
+}
@@ -0,0 +1,327 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        wasm_sys.c
+ * Module:      WebAssembly Platform Layer (PhotonX)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Each instance owns one 16 GB slot of the WASM window (kernel/wasm.h):
+ *
+ *   +0            vmctx          EL0 read-write
+ *   +STACK_TOP    native stack   EL0 read-write, 1 MB downwards
+ *   +CODE         module code    EL0 read-only + executable
+ *   +MEM          linear memory  EL0 read-write, committed pages only
+ *
+ * The kernel uses the same mappings (one translation regime, no PAN), so
+ * host functions read linear memory at vm->mem_base like the compiled
+ * code does. Linear memory is committed in physically contiguous chunks
+ * so HOCS jobs can usually address it in place.
+ *
+ * AOT calls run through user_run_stack() on the slot's stack: the EL0
+ * stubs below (in 'user_text') call the thunk, turn host calls into
+ * SYS_WASM_HOST and traps into SYS_EXIT. A guard fault ends the task and
+ * is reported as an out-of-bounds access.
+ * ======================================================================================
+ */
+
+#include <string.h>
+#include "kernel/wasm.h"
+#include "kernel/user.h"
+#include "kernel/timer_heavy.h"
+#include "mm/mmu.h"
+#include "mm/pmm.h"
+#include "lib/kprintf.h"
+
+#define SYS_PAGE_ALIGN(n)           (((n) + PMM_PAGE_SIZE - 1) & ~(PMM_PAGE_SIZE - 1))
+#define SYS_EXIT_TRAP               0x100       // user_exit() code for a trap: + WASM_TRAP_*
+
+static uint32_t sys_slots;                      // Bitmap of slots in use
+static wasm_instance_t *sys_current;            // Instance running at EL0
+static int sys_ready;
+
+/* =========================================================================
+ * EL0 STUBS
+ * ========================================================================= */
+
+typedef void (*sys_thunk_t)(uint64_t vmctx, uint64_t fn, uint64_t *args);
+
+/* Task entry: 'arg' is the slot address of vm->call */
+USER_TEXT static void wasm_el0_entry(uint64_t arg) {
+    wasm_call_t *c = (wasm_call_t *)(uintptr_t)arg;
+
+    ((sys_thunk_t)(uintptr_t)c->thunk)(c->vmctx, c->fn, c->args);
+    user_exit(0);
+}
+
+/* vm->host_call */
+USER_TEXT static uint64_t wasm_el0_host(uint64_t vmctx, uint64_t index, uint64_t *args) {
+    return (uint64_t)user_syscall(SYS_WASM_HOST, vmctx, index, (uint64_t)(uintptr_t)args);
+}
+
+/* vm->trap_fn */
+USER_TEXT static void wasm_el0_trap(uint64_t vmctx, uint64_t code) {
+    (void)vmctx;
+    user_exit(SYS_EXIT_TRAP + (uint32_t)code);
+}
+
+/*
+ * sys_host
+ * SYS_WASM_HOST handler. The instance is the one running, whatever the
+ * task passes as vmctx; 'args' must lie on its stack.
+ */
+static int64_t sys_host(uint64_t vmctx, uint64_t index, uint64_t args) {
+    wasm_instance_t *inst = sys_current;
+    uint64_t lo, hi;
+
+    (void)vmctx;
+    if (inst == NULL) {
+        return USER_ERR_NOSYS;
+    }
+    hi = inst->stack_top - WASM_MAX_PARAMS * sizeof(uint64_t);
+    lo = inst->stack_top - WASM_STACK_SIZE;
+    if (args < lo || args > hi || (args & 7)) {
+        wasm_trap(inst, WASM_TRAP_HOST);
+        return 0;
+    }
+    return (int64_t)wasm_host_dispatch((uint64_t)(uintptr_t)inst->vm, index, (uint64_t *)(uintptr_t)args);
+}
+
+/* =========================================================================
+ * HELPERS
+ * ========================================================================= */
+
+static inline uint64_t sys_slot_va(const wasm_instance_t *inst) {
+    return WASM_WINDOW_BASE + (uint64_t)inst->slot * WASM_SLOT_SIZE;
+}
+
+static int sys_map(uint64_t va, uint64_t pa, uint64_t size, uint64_t flags) {
+    for (uint64_t off = 0; off < size; off += PMM_PAGE_SIZE) {
+        if (vmm_map_page(va + off, pa + off, flags) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void sys_unmap(uint64_t va, uint64_t size) {
+    for (uint64_t off = 0; off < size; off += PMM_PAGE_SIZE) {
+        vmm_unmap_page(va + off);
+    }
+}
+
+/* New code reaches the instruction side: clean to PoU, drop the I-cache */
+static void sys_sync_icache(const void *p, size_t size) {
+    uint64_t ctr, line;
+    uint64_t start = (uint64_t)(uintptr_t)p, end = start + size;
+
+    asm volatile("mrs %0, ctr_el0" : "=r" (ctr));
+    line = 4UL << ((ctr >> 16) & 0xF);
+    for (uint64_t a = start & ~(line - 1); a < end; a += line) {
+        asm volatile("dc cvau, %0" : : "r" (a) : "memory");
+    }
+    asm volatile("dsb ish\n\tic iallu\n\tdsb ish\n\tisb" : : : "memory");
+}
+
+/* =========================================================================
+ * PLATFORM INTERFACE
+ * ========================================================================= */
+
+uint64_t wasm_sys_now_ns(void) {
+    return timer_get_timestamp_ns();
+}
+
+void *wasm_sys_alloc(size_t size) {
+    return (void *)(uintptr_t)pmm_alloc(SYS_PAGE_ALIGN(size), PMM_F_HIGH | PMM_F_ZERO);
+}
+
+void wasm_sys_free(void *p, size_t size) {
+    pmm_free((uint64_t)(uintptr_t)p, SYS_PAGE_ALIGN(size));
+}
+
+/*
+ * wasm_sys_instance_init
+ * Claims a slot and maps its vmctx and stack. inst->vm is the kernel
+ * (identity) address of the vmctx; compiled code sees the slot address.
+ */
+int wasm_sys_instance_init(wasm_instance_t *inst) {
+    uint64_t base, pa;
+    wasm_vmctx_t *vm;
+
+    /* 1. Once: EL0 tasks and the host call */
+    if (!sys_ready) {
+        if (user_init() != 0 || user_syscall_register(SYS_WASM_HOST, sys_host) != 0) {
+            return -1;
+        }
+        sys_ready = 1;
+    }
+
+    /* 2. Slot */
+    if (sys_slots == 0xFFFFFFFFU) {
+        kprintf("[WASM] ERR: all %u slots in use\n", WASM_MAX_INSTANCES);
+        return -1;
+    }
+    inst->slot = (uint32_t)__builtin_ctz(~sys_slots);
+    base = sys_slot_va(inst);
+
+    /* 3. vmctx + stack, one allocation */
+    pa = pmm_alloc(WASM_VMCTX_SIZE + WASM_STACK_SIZE, PMM_F_HIGH | PMM_F_ZERO);
+    if (pa == 0) {
+        return -1;
+    }
+    if (sys_map(base + WASM_SLOT_VMCTX, pa, WASM_VMCTX_SIZE, VMM_USER_RW) != 0 ||
+        sys_map(base + WASM_SLOT_STACK_TOP - WASM_STACK_SIZE, pa + WASM_VMCTX_SIZE,
+                WASM_STACK_SIZE, VMM_USER_RW) != 0) {
+        sys_unmap(base + WASM_SLOT_VMCTX, WASM_VMCTX_SIZE);
+        sys_unmap(base + WASM_SLOT_STACK_TOP - WASM_STACK_SIZE, WASM_STACK_SIZE);
+        pmm_free(pa, WASM_VMCTX_SIZE + WASM_STACK_SIZE);
+        return -1;
+    }
+    sys_slots |= 1U << inst->slot;
+
+    vm = (wasm_vmctx_t *)(uintptr_t)pa;
+    vm->mem_base = base + WASM_SLOT_MEM;
+    vm->host_call = user_text_va((const void *)wasm_el0_host);
+    vm->trap_fn = user_text_va((const void *)wasm_el0_trap);
+    vm->stack_limit = base + WASM_SLOT_STACK_TOP - WASM_STACK_SIZE + WASM_STACK_RESERVE;
+    inst->vm = vm;
+    inst->stack_top = base + WASM_SLOT_STACK_TOP;
+    return 0;
+}
+
+void wasm_sys_instance_free(wasm_instance_t *inst) {
+    uint64_t base = sys_slot_va(inst);
+
+    for (uint32_t i = 0; i < inst->nchunks; i++) {
+        sys_unmap(base + WASM_SLOT_MEM + inst->chunk[i].off, inst->chunk[i].size);
+        pmm_free(inst->chunk[i].pa, inst->chunk[i].size);
+    }
+    inst->nchunks = 0;
+    if (inst->code_va != 0) {
+        sys_unmap(inst->code_va, SYS_PAGE_ALIGN(inst->mod->code_size));
+        inst->code_va = 0;
+    }
+    sys_unmap(base + WASM_SLOT_STACK_TOP - WASM_STACK_SIZE, WASM_STACK_SIZE);
+    sys_unmap(base + WASM_SLOT_VMCTX, WASM_VMCTX_SIZE);
+    pmm_free((uint64_t)(uintptr_t)inst->vm, WASM_VMCTX_SIZE + WASM_STACK_SIZE);
+    sys_slots &= ~(1U << inst->slot);
+}
+
+/*
+ * wasm_sys_mem_commit
+ * Grows the committed part of linear memory to 'pages': one contiguous
+ * chunk if the allocator has it, else one chunk per Wasm page.
+ */
+int wasm_sys_mem_commit(wasm_instance_t *inst, uint32_t pages) {
+    uint64_t mem = sys_slot_va(inst) + WASM_SLOT_MEM;
+    uint32_t have = 0, want = pages * WASM_PAGE_SIZE, first = inst->nchunks;
+
+    if (inst->nchunks > 0) {
+        have = inst->chunk[inst->nchunks - 1].off + inst->chunk[inst->nchunks - 1].size;
+    }
+    while (have < want) {
+        uint32_t size = want - have;
+        uint64_t pa;
+
+        if (inst->nchunks == WASM_MAX_MEM_CHUNKS) {
+            goto fail;
+        }
+        pa = pmm_alloc(size, PMM_F_HIGH | PMM_F_ZERO);
+        if (pa == 0) {
+            size = WASM_PAGE_SIZE;
+            pa = pmm_alloc(size, PMM_F_HIGH | PMM_F_ZERO);
+        }
+        if (pa == 0 || sys_map(mem + have, pa, size, VMM_USER_RW) != 0) {
+            if (pa != 0) {
+                sys_unmap(mem + have, size);
+                pmm_free(pa, size);
+            }
+            goto fail;
+        }
+        inst->chunk[inst->nchunks].off = have;
+        inst->chunk[inst->nchunks].size = size;
+        inst->chunk[inst->nchunks].pa = pa;
+        inst->nchunks++;
+        have += size;
+    }
+    return 0;
+
+fail:
+    /* Nothing committed by this call stays */
+    while (inst->nchunks > first) {
+        wasm_mem_chunk_t *c = &inst->chunk[--inst->nchunks];
+        sys_unmap(mem + c->off, c->size);
+        pmm_free(c->pa, c->size);
+    }
+    return -1;
+}
+
+/* Physical address of [off, off + len) if one chunk holds all of it, else 0 */
+uint64_t wasm_sys_mem_phys(wasm_instance_t *inst, uint32_t off, uint32_t len) {
+    for (uint32_t i = 0; i < inst->nchunks; i++) {
+        const wasm_mem_chunk_t *c = &inst->chunk[i];
+        if (off >= c->off && (uint64_t)off + len <= (uint64_t)c->off + c->size) {
+            return c->pa + (off - c->off);
+        }
+    }
+    return 0;
+}
+
+void *wasm_sys_code_alloc(size_t size) {
+    return (void *)(uintptr_t)pmm_alloc(SYS_PAGE_ALIGN(size), PMM_F_HIGH);
+}
+
+void wasm_sys_code_free(void *code, size_t size) {
+    pmm_free((uint64_t)(uintptr_t)code, SYS_PAGE_ALIGN(size));
+}
+
+/* Maps the module's code into the slot, executable at EL0 only */
+int wasm_sys_code_map(wasm_instance_t *inst) {
+    const wasm_module_t *m = inst->mod;
+    uint64_t va = sys_slot_va(inst) + WASM_SLOT_CODE, size = SYS_PAGE_ALIGN(m->code_size);
+
+    if (size > WASM_SLOT_CODE_MAX) {
+        return -1;
+    }
+    if (sys_map(va, (uint64_t)(uintptr_t)m->code, size, VMM_USER_RX) != 0) {
+        sys_unmap(va, size);
+        return -1;
+    }
+    sys_sync_icache(m->code, m->code_size);
+    inst->code_va = va;
+    return 0;
+}
+
+/*
+ * wasm_sys_aot_call
+ * Runs thunk(vmctx, fn, args) at EL0 on the slot's stack.
+ */
+int wasm_sys_aot_call(wasm_instance_t *inst, uint64_t thunk, uint64_t fn, uint64_t *args) {
+    wasm_vmctx_t *vm = inst->vm;
+    uint64_t vmctx = sys_slot_va(inst) + WASM_SLOT_VMCTX;
+    wasm_instance_t *prev = sys_current;
+    int64_t code;
+
+    /* 1. Request in the vmctx: the task cannot see 'args' */
+    if (prev != NULL) {
+        return WASM_ERR_INVALID;                    // EL0 tasks do not nest
+    }
+    vm->call.thunk = thunk;
+    vm->call.fn = fn;
+    vm->call.vmctx = vmctx;
+    memcpy(vm->call.args, args, sizeof(vm->call.args));
+
+    /* 2. Run */
+    sys_current = inst;
+    code = user_run_stack(wasm_el0_entry, vmctx + offsetof(wasm_vmctx_t, call), inst->stack_top);
+    sys_current = NULL;
+
+    /* 3. Result or trap */
+    if (code == 0) {
+        args[0] = vm->call.args[0];
+        return WASM_OK;
+    }
+    inst->trap = code > SYS_EXIT_TRAP ? (uint32_t)(code - SYS_EXIT_TRAP) : WASM_TRAP_MEMORY;
+    return WASM_ERR_TRAP;
+}
@@ -0,0 +1,178 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        wasm_sys_linux.c
+ * Module:      WebAssembly Platform Layer (Linux Hosted Build)
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Stands in for wasm_sys.c when the runtime is built as a Linux program
+ * (see the build line in kernel/wasm.h): the linear memory reservation is
+ * a PROT_NONE mapping with the committed pages made read-write, guard
+ * faults arrive as SIGSEGV and unwind the call with siglongjmp, and
+ * compiled code runs in-process on the calling thread's stack. AOT calls
+ * need an aarch64 host (native or QEMU user mode); elsewhere they report
+ * WASM_ERR_NOAOT and only the interpreter runs.
+ * ======================================================================================
+ */
+
+#define _GNU_SOURCE
+#include <setjmp.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include "kernel/wasm.h"
+
+static __thread sigjmp_buf *linux_jmp;
+static __thread wasm_instance_t *linux_inst;
+static struct sigaction linux_old_segv;
+
+void kprintf(const char *fmt, ...) {
+    va_list ap;
+
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+}
+
+uint64_t wasm_sys_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void *wasm_sys_alloc(size_t size) {
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    return p == MAP_FAILED ? NULL : p;
+}
+
+void wasm_sys_free(void *p, size_t size) {
+    munmap(p, size);
+}
+
+/* Guard fault inside the running instance's reservation: a memory trap */
+static void linux_segv(int sig, siginfo_t *si, void *uc) {
+    wasm_instance_t *inst = linux_inst;
+    uint64_t addr = (uint64_t)(uintptr_t)si->si_addr;
+
+    if (linux_jmp != NULL && inst != NULL && addr >= inst->vm->mem_base &&
+        addr < inst->vm->mem_base + WASM_MEM_RESERVE) {
+        inst->trap = WASM_TRAP_MEMORY;
+        siglongjmp(*linux_jmp, 1);
+    }
+    (void)uc;
+    sigaction(sig, &linux_old_segv, NULL);          // Not ours: fault again, unhandled
+}
+
+static void linux_trap(wasm_vmctx_t *vm, uint32_t code) {
+    wasm_instance_t *inst = (wasm_instance_t *)(uintptr_t)vm->inst;
+
+    inst->trap = code;
+    siglongjmp(*linux_jmp, 1);
+}
+
+int wasm_sys_instance_init(wasm_instance_t *inst) {
+    static int handler;
+    void *mem;
+
+    if (!handler) {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_sigaction = linux_segv;
+        sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+        sigaction(SIGSEGV, &sa, &linux_old_segv);
+        sigaction(SIGBUS, &sa, NULL);
+        handler = 1;
+    }
+
+    inst->vm = wasm_sys_alloc(WASM_VMCTX_SIZE);
+    mem = mmap(NULL, WASM_MEM_RESERVE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (inst->vm == NULL || mem == MAP_FAILED) {
+        if (inst->vm != NULL) {
+            wasm_sys_free(inst->vm, WASM_VMCTX_SIZE);
+            inst->vm = NULL;
+        }
+        return -1;
+    }
+    inst->vm->mem_base = (uint64_t)(uintptr_t)mem;
+    inst->vm->host_call = (uint64_t)(uintptr_t)wasm_host_dispatch;
+    inst->vm->trap_fn = (uint64_t)(uintptr_t)linux_trap;
+    return 0;
+}
+
+void wasm_sys_instance_free(wasm_instance_t *inst) {
+    munmap((void *)(uintptr_t)inst->vm->mem_base, WASM_MEM_RESERVE);
+    wasm_sys_free(inst->vm, WASM_VMCTX_SIZE);
+}
+
+int wasm_sys_mem_commit(wasm_instance_t *inst, uint32_t pages) {
+    return mprotect((void *)(uintptr_t)inst->vm->mem_base, (size_t)pages * WASM_PAGE_SIZE,
+                    PROT_READ | PROT_WRITE);
+}
+
+/* No physical addresses in a process */
+uint64_t wasm_sys_mem_phys(wasm_instance_t *inst, uint32_t off, uint32_t len) {
+    (void)inst;
+    (void)off;
+    (void)len;
+    return 0;
+}
+
+void *wasm_sys_code_alloc(size_t size) {
+    return wasm_sys_alloc(size);
+}
+
+void wasm_sys_code_free(void *code, size_t size) {
+    wasm_sys_free(code, size);
+}
+
+/* Module code is shared: made executable in place */
+int wasm_sys_code_map(wasm_instance_t *inst) {
+    const wasm_module_t *m = inst->mod;
+
+    if (mprotect(m->code, m->code_alloc, PROT_READ | PROT_EXEC) != 0) {
+        return -1;
+    }
+    __builtin___clear_cache((char *)m->code, (char *)m->code + m->code_size);
+    inst->code_va = (uint64_t)(uintptr_t)m->code;
+    return 0;
+}
+
+int wasm_sys_aot_call(wasm_instance_t *inst, uint64_t thunk, uint64_t fn, uint64_t *args) {
+#if defined(__aarch64__)
+    sigjmp_buf jb, *prev_jmp = linux_jmp;
+    wasm_instance_t *prev_inst = linux_inst;
+    uint64_t sp = (uint64_t)(uintptr_t)__builtin_frame_address(0);
+
+    // The thread stack below here, less what host functions need
+    inst->vm->stack_limit = sp - WASM_STACK_SIZE + WASM_STACK_RESERVE;
+    if (sigsetjmp(jb, 0)) {
+        linux_jmp = prev_jmp;
+        linux_inst = prev_inst;
+        return WASM_ERR_TRAP;
+    }
+    linux_jmp = &jb;
+    linux_inst = inst;
+    ((void (*)(uint64_t, uint64_t, uint64_t *))(uintptr_t)thunk)((uint64_t)(uintptr_t)inst->vm, fn, args);
+    linux_jmp = prev_jmp;
+    linux_inst = prev_inst;
+    return WASM_OK;
+#else
+    (void)inst;
+    (void)thunk;
+    (void)fn;
+    (void)args;
+    return WASM_ERR_NOAOT;
+#endif
+}
+
+int main(void) {
+    wasm_benchmark();
+    return 0;
+}
@@ -0,0 +1,454 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        aes_gcm.c
+ * Module:      AES-256-GCM Implementation
+ * ======================================================================================
+ */
+
+#include "lib/aes_gcm.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+static uint8_t aes_sbox[256];
+static uint32_t aes_te0[256];          // {2s, s, s, 3s}; the other three are rotations
+static int aes_tables_ready = 0;
+
+/* GHASH reduction of the nibble shifted out (portable path) */
+static const uint64_t ghash_last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+static inline uint32_t ror32(uint32_t v, uint32_t n) {
+    return (v >> n) | (v << (32 - n));
+}
+
+static inline uint8_t rol8(uint8_t v, uint32_t n) {
+    return (uint8_t)((v << n) | (v >> (8 - n)));
+}
+
+static inline uint32_t load_be32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void store_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline uint64_t load_be64(const uint8_t *p) {
+    return ((uint64_t)load_be32(p) << 32) | load_be32(p + 4);
+}
+
+static inline void store_be64(uint8_t *p, uint64_t v) {
+    store_be32(p, (uint32_t)(v >> 32));
+    store_be32(p + 4, (uint32_t)v);
+}
+
+/*
+ * aes_build_tables
+ * S-box from the inverse in GF(2^8) (walking the powers of 3 and 3^-1
+ * together) plus the affine map, then the round table.
+ */
+static void aes_build_tables(void) {
+    uint8_t p = 1, q = 1;
+
+    do {
+        p = (uint8_t)(p ^ (p << 1) ^ ((p & 0x80) ? 0x1B : 0));
+        q ^= (uint8_t)(q << 1);
+        q ^= (uint8_t)(q << 2);
+        q ^= (uint8_t)(q << 4);
+        if (q & 0x80) {
+            q ^= 0x09;
+        }
+        aes_sbox[p] = (uint8_t)(q ^ rol8(q, 1) ^ rol8(q, 2) ^ rol8(q, 3) ^ rol8(q, 4) ^ 0x63);
+    } while (p != 1);
+    aes_sbox[0] = 0x63;
+
+    for (uint32_t i = 0; i < 256; i++) {
+        uint8_t s = aes_sbox[i];
+        uint8_t s2 = (uint8_t)((s << 1) ^ ((s & 0x80) ? 0x1B : 0));
+        aes_te0[i] = ((uint32_t)s2 << 24) | ((uint32_t)s << 16) | ((uint32_t)s << 8) | (uint8_t)(s2 ^ s);
+    }
+    aes_tables_ready = 1;
+}
+
+static inline uint32_t aes_subword(uint32_t w) {
+    return ((uint32_t)aes_sbox[w >> 24] << 24) | ((uint32_t)aes_sbox[(w >> 16) & 0xFF] << 16) |
+           ((uint32_t)aes_sbox[(w >> 8) & 0xFF] << 8) | aes_sbox[w & 0xFF];
+}
+
+static void aes_encrypt_block(const uint32_t *rk, const uint8_t in[16], uint8_t out[16]) {
+    uint32_t s0 = load_be32(in) ^ rk[0];
+    uint32_t s1 = load_be32(in + 4) ^ rk[1];
+    uint32_t s2 = load_be32(in + 8) ^ rk[2];
+    uint32_t s3 = load_be32(in + 12) ^ rk[3];
+    uint32_t t0, t1, t2, t3;
+
+    for (uint32_t r = 1; r < AES_256_ROUNDS; r++) {
+        rk += 4;
+        t0 = aes_te0[s0 >> 24] ^ ror32(aes_te0[(s1 >> 16) & 0xFF], 8) ^
+             ror32(aes_te0[(s2 >> 8) & 0xFF], 16) ^ ror32(aes_te0[s3 & 0xFF], 24) ^ rk[0];
+        t1 = aes_te0[s1 >> 24] ^ ror32(aes_te0[(s2 >> 16) & 0xFF], 8) ^
+             ror32(aes_te0[(s3 >> 8) & 0xFF], 16) ^ ror32(aes_te0[s0 & 0xFF], 24) ^ rk[1];
+        t2 = aes_te0[s2 >> 24] ^ ror32(aes_te0[(s3 >> 16) & 0xFF], 8) ^
+             ror32(aes_te0[(s0 >> 8) & 0xFF], 16) ^ ror32(aes_te0[s1 & 0xFF], 24) ^ rk[2];
+        t3 = aes_te0[s3 >> 24] ^ ror32(aes_te0[(s0 >> 16) & 0xFF], 8) ^
+             ror32(aes_te0[(s1 >> 8) & 0xFF], 16) ^ ror32(aes_te0[s2 & 0xFF], 24) ^ rk[3];
+        s0 = t0;
+        s1 = t1;
+        s2 = t2;
+        s3 = t3;
+    }
+
+    /* Last round: no MixColumns */
+    rk += 4;
+    store_be32(out, (((uint32_t)aes_sbox[s0 >> 24] << 24) | ((uint32_t)aes_sbox[(s1 >> 16) & 0xFF] << 16) |
+                     ((uint32_t)aes_sbox[(s2 >> 8) & 0xFF] << 8) | aes_sbox[s3 & 0xFF]) ^ rk[0]);
+    store_be32(out + 4, (((uint32_t)aes_sbox[s1 >> 24] << 24) | ((uint32_t)aes_sbox[(s2 >> 16) & 0xFF] << 16) |
+                         ((uint32_t)aes_sbox[(s3 >> 8) & 0xFF] << 8) | aes_sbox[s0 & 0xFF]) ^ rk[1]);
+    store_be32(out + 8, (((uint32_t)aes_sbox[s2 >> 24] << 24) | ((uint32_t)aes_sbox[(s3 >> 16) & 0xFF] << 16) |
+                         ((uint32_t)aes_sbox[(s0 >> 8) & 0xFF] << 8) | aes_sbox[s1 & 0xFF]) ^ rk[2]);
+    store_be32(out + 12, (((uint32_t)aes_sbox[s3 >> 24] << 24) | ((uint32_t)aes_sbox[(s0 >> 16) & 0xFF] << 16) |
+                          ((uint32_t)aes_sbox[(s1 >> 8) & 0xFF] << 8) | aes_sbox[s2 & 0xFF]) ^ rk[3]);
+}
+
+/*
+ * ghash_mul
+ * x = x * H, 4 bits at a time (Shoup's table).
+ */
+static void ghash_mul(const aes_gcm_ctx_t *ctx, uint8_t x[16]) {
+    uint64_t zh, zl;
+    uint8_t lo = x[15] & 0x0F, rem;
+
+    zh = ctx->hh[lo];
+    zl = ctx->hl[lo];
+
+    for (int i = 15; i >= 0; i--) {
+        uint8_t hi = x[i] >> 4;
+        lo = x[i] & 0x0F;
+
+        if (i != 15) {
+            rem = (uint8_t)(zl & 0x0F);
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ (ghash_last4[rem] << 48);
+            zh ^= ctx->hh[lo];
+            zl ^= ctx->hl[lo];
+        }
+        rem = (uint8_t)(zl & 0x0F);
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ (ghash_last4[rem] << 48);
+        zh ^= ctx->hh[hi];
+        zl ^= ctx->hl[hi];
+    }
+
+    store_be64(x, zh);
+    store_be64(x + 8, zl);
+}
+
+static void ghash_block(const aes_gcm_ctx_t *ctx, uint8_t x[16], const uint8_t *blk, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        x[i] ^= blk[i];
+    }
+    ghash_mul(ctx, x);
+}
+
+static inline void ctr_set(uint8_t cb[16], const uint8_t *iv, uint32_t ctr) {
+    for (uint32_t i = 0; i < AES_GCM_IV_SIZE; i++) {
+        cb[i] = iv[i];
+    }
+    store_be32(cb + 12, ctr);
+}
+
+/*
+ * gcm_crypt_scalar
+ * CTR from counter 2 and GHASH over the ciphertext; s gets E(J0) ^ GHASH.
+ */
+static void gcm_crypt_scalar(const aes_gcm_ctx_t *ctx, const uint8_t *iv, const uint8_t *in,
+                             uint8_t *out, uint64_t len, int encrypt, uint8_t s[16]) {
+    uint8_t x[16] = {0}, cb[16], ks[16], c[16];
+    uint64_t bits = len * 8;
+    uint32_t ctr = 2;
+
+    while (len > 0) {
+        uint32_t n = (len < 16) ? (uint32_t)len : 16;
+
+        ctr_set(cb, iv, ctr++);
+        aes_encrypt_block(ctx->rk, cb, ks);
+        for (uint32_t i = 0; i < n; i++) {
+            c[i] = encrypt ? (uint8_t)(in[i] ^ ks[i]) : in[i];
+            out[i] = (uint8_t)(in[i] ^ ks[i]);
+        }
+        ghash_block(ctx, x, c, n);
+        in += n;
+        out += n;
+        len -= n;
+    }
+
+    /* Length block: no AAD, so only len(C) */
+    store_be64(c, 0);
+    store_be64(c + 8, bits);
+    ghash_block(ctx, x, c, 16);
+
+    ctr_set(cb, iv, 1);
+    aes_encrypt_block(ctx->rk, cb, ks);
+    for (uint32_t i = 0; i < 16; i++) {
+        s[i] = (uint8_t)(x[i] ^ ks[i]);
+    }
+}
+
+#if defined(__aarch64__)
+#pragma GCC push_options
+#pragma GCC target("+crypto")
+
+static inline uint8x16_t aes_ce_block(const uint8x16_t k[AES_256_ROUNDS + 1], uint8x16_t b) {
+    for (uint32_t r = 0; r < AES_256_ROUNDS - 1; r++) {
+        b = vaesmcq_u8(vaeseq_u8(b, k[r]));
+    }
+    return veorq_u8(vaeseq_u8(b, k[AES_256_ROUNDS - 1]), k[AES_256_ROUNDS]);
+}
+
+/*
+ * ghash_ce_mul
+ * a * h in GF(2^128), both bit-reflected per byte so the field is plain
+ * little-endian polynomials: Karatsuba-free 4x PMULL, then two folds by
+ * x^128 = x^7 + x^2 + x + 1 (0x87).
+ */
+static inline uint64x2_t ghash_ce_mul(uint64x2_t a, uint64x2_t h) {
+    const poly64_t red = 0x87;
+    uint64x2_t lo, hi, mid, t;
+    uint64_t p0, p1, p2, p3;
+
+    lo = vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(a, 0), (poly64_t)vgetq_lane_u64(h, 0)));
+    hi = vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(a, 1), (poly64_t)vgetq_lane_u64(h, 1)));
+    mid = veorq_u64(vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(a, 0), (poly64_t)vgetq_lane_u64(h, 1))),
+                    vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(a, 1), (poly64_t)vgetq_lane_u64(h, 0))));
+
+    p0 = vgetq_lane_u64(lo, 0);
+    p1 = vgetq_lane_u64(lo, 1) ^ vgetq_lane_u64(mid, 0);
+    p2 = vgetq_lane_u64(hi, 0) ^ vgetq_lane_u64(mid, 1);
+    p3 = vgetq_lane_u64(hi, 1);
+
+    t = vreinterpretq_u64_p128(vmull_p64((poly64_t)p3, red));
+    p1 ^= vgetq_lane_u64(t, 0);
+    p2 ^= vgetq_lane_u64(t, 1);
+    t = vreinterpretq_u64_p128(vmull_p64((poly64_t)p2, red));
+    p0 ^= vgetq_lane_u64(t, 0);
+    p1 ^= vgetq_lane_u64(t, 1);
+
+    return vcombine_u64(vcreate_u64(p0), vcreate_u64(p1));
+}
+
+static inline uint64x2_t ghash_ce_step(uint64x2_t acc, uint8x16_t c, uint64x2_t h) {
+    return ghash_ce_mul(veorq_u64(acc, vreinterpretq_u64_u8(vrbitq_u8(c))), h);
+}
+
+static inline uint8x16_t ctr_ce(uint8x16_t j, uint32_t ctr) {
+    return vreinterpretq_u8_u32(vsetq_lane_u32(__builtin_bswap32(ctr), vreinterpretq_u32_u8(j), 3));
+}
+
+/*
+ * gcm_crypt_ce
+ * Same as gcm_crypt_scalar, four counter blocks per pass so the AESE/AESMC
+ * chains overlap (the A53 issues one every cycle but each has a 3-cycle
+ * latency).
+ */
+static void gcm_crypt_ce(const aes_gcm_ctx_t *ctx, const uint8_t *iv, const uint8_t *in,
+                         uint8_t *out, uint64_t len, int encrypt, uint8_t s[16]) {
+    uint8x16_t k[AES_256_ROUNDS + 1], j, b0, b1, b2, b3, c0, c1, c2, c3;
+    uint64x2_t h, acc = vdupq_n_u64(0);
+    uint8_t cb[16], tmp[16];
+    uint64_t bits = len * 8;
+    uint32_t ctr = 2;
+
+    for (uint32_t r = 0; r <= AES_256_ROUNDS; r++) {
+        k[r] = vld1q_u8(ctx->rk8 + 16 * r);
+    }
+    h = vreinterpretq_u64_u8(vrbitq_u8(vld1q_u8(ctx->h)));
+    ctr_set(cb, iv, 1);
+    j = vld1q_u8(cb);
+
+    /* 1. Four blocks at a time */
+    while (len >= 64) {
+        b0 = ctr_ce(j, ctr);
+        b1 = ctr_ce(j, ctr + 1);
+        b2 = ctr_ce(j, ctr + 2);
+        b3 = ctr_ce(j, ctr + 3);
+        ctr += 4;
+        for (uint32_t r = 0; r < AES_256_ROUNDS - 1; r++) {
+            b0 = vaesmcq_u8(vaeseq_u8(b0, k[r]));
+            b1 = vaesmcq_u8(vaeseq_u8(b1, k[r]));
+            b2 = vaesmcq_u8(vaeseq_u8(b2, k[r]));
+            b3 = vaesmcq_u8(vaeseq_u8(b3, k[r]));
+        }
+        b0 = veorq_u8(vaeseq_u8(b0, k[AES_256_ROUNDS - 1]), k[AES_256_ROUNDS]);
+        b1 = veorq_u8(vaeseq_u8(b1, k[AES_256_ROUNDS - 1]), k[AES_256_ROUNDS]);
+        b2 = veorq_u8(vaeseq_u8(b2, k[AES_256_ROUNDS - 1]), k[AES_256_ROUNDS]);
+        b3 = veorq_u8(vaeseq_u8(b3, k[AES_256_ROUNDS - 1]), k[AES_256_ROUNDS]);
+
+        c0 = vld1q_u8(in);
+        c1 = vld1q_u8(in + 16);
+        c2 = vld1q_u8(in + 32);
+        c3 = vld1q_u8(in + 48);
+        b0 = veorq_u8(b0, c0);
+        b1 = veorq_u8(b1, c1);
+        b2 = veorq_u8(b2, c2);
+        b3 = veorq_u8(b3, c3);
+        vst1q_u8(out, b0);
+        vst1q_u8(out + 16, b1);
+        vst1q_u8(out + 32, b2);
+        vst1q_u8(out + 48, b3);
+
+        if (encrypt) {
+            c0 = b0;
+            c1 = b1;
+            c2 = b2;
+            c3 = b3;
+        }
+        acc = ghash_ce_step(acc, c0, h);
+        acc = ghash_ce_step(acc, c1, h);
+        acc = ghash_ce_step(acc, c2, h);
+        acc = ghash_ce_step(acc, c3, h);
+
+        in += 64;
+        out += 64;
+        len -= 64;
+    }
+
+    /* 2. Tail, the last block zero-padded for GHASH */
+    while (len > 0) {
+        uint32_t n = (len < 16) ? (uint32_t)len : 16;
+
+        vst1q_u8(tmp, aes_ce_block(k, ctr_ce(j, ctr++)));
+        for (uint32_t i = 0; i < 16; i++) {
+            uint8_t x = (i < n) ? in[i] : 0;
+            if (i < n) {
+                out[i] = (uint8_t)(x ^ tmp[i]);
+            }
+            tmp[i] = (i < n) ? (encrypt ? out[i] : x) : 0;
+        }
+        acc = ghash_ce_step(acc, vld1q_u8(tmp), h);
+        in += n;
+        out += n;
+        len -= n;
+    }
+
+    /* 3. Length block and tag */
+    store_be64(tmp, 0);
+    store_be64(tmp + 8, bits);
+    acc = ghash_ce_step(acc, vld1q_u8(tmp), h);
+    vst1q_u8(s, veorq_u8(vrbitq_u8(vreinterpretq_u8_u64(acc)), aes_ce_block(k, j)));
+}
+
+#pragma GCC pop_options
+#endif
+
+/*
+ * aes_gcm_have_ce
+ * ID_AA64ISAR0_EL1.AES == 2: AESE/AESD plus PMULL/PMULL2.
+ */
+int aes_gcm_have_ce(void) {
+#if defined(__aarch64__)
+    uint64_t isar0;
+    asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+    return ((isar0 >> 4) & 0xF) == 2;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * aes_gcm_init
+ * Key schedule, hash key and its GHASH table.
+ */
+void aes_gcm_init(aes_gcm_ctx_t *ctx, const uint8_t key[AES_GCM_KEY_SIZE], uint32_t flags) {
+    static const uint8_t rcon[7] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40};
+    uint8_t zero[16] = {0};
+    uint64_t vh, vl;
+
+    if (!aes_tables_ready) {
+        aes_build_tables();
+    }
+
+    /* 1. Round keys */
+    for (uint32_t i = 0; i < 8; i++) {
+        ctx->rk[i] = load_be32(key + 4 * i);
+    }
+    for (uint32_t i = 8; i < 4 * (AES_256_ROUNDS + 1); i++) {
+        uint32_t t = ctx->rk[i - 1];
+        if ((i & 7) == 0) {
+            t = aes_subword(ror32(t, 24)) ^ ((uint32_t)rcon[i / 8 - 1] << 24);
+        } else if ((i & 7) == 4) {
+            t = aes_subword(t);
+        }
+        ctx->rk[i] = ctx->rk[i - 8] ^ t;
+    }
+    for (uint32_t i = 0; i < 4 * (AES_256_ROUNDS + 1); i++) {
+        store_be32(ctx->rk8 + 4 * i, ctx->rk[i]);
+    }
+
+    /* 2. H = E(K, 0) */
+    aes_encrypt_block(ctx->rk, zero, ctx->h);
+
+    /* 3. Multiples of H for the 4-bit table */
+    vh = load_be64(ctx->h);
+    vl = load_be64(ctx->h + 8);
+    ctx->hl[0] = 0;
+    ctx->hh[0] = 0;
+    ctx->hl[8] = vl;
+    ctx->hh[8] = vh;
+    for (uint32_t i = 4; i > 0; i >>= 1) {
+        uint64_t t = (vl & 1) * 0xe1000000ULL;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ (t << 32);
+        ctx->hl[i] = vl;
+        ctx->hh[i] = vh;
+    }
+    for (uint32_t i = 2; i <= 8; i *= 2) {
+        for (uint32_t k = 1; k < i; k++) {
+            ctx->hh[i + k] = ctx->hh[i] ^ ctx->hh[k];
+            ctx->hl[i + k] = ctx->hl[i] ^ ctx->hl[k];
+        }
+    }
+
+    ctx->use_ce = (uint8_t)(!(flags & AES_GCM_F_SCALAR) && aes_gcm_have_ce());
+}
+
+static void gcm_crypt(const aes_gcm_ctx_t *ctx, const uint8_t *iv, const void *in, void *out,
+                      uint64_t len, int encrypt, uint8_t s[16]) {
+#if defined(__aarch64__)
+    if (ctx->use_ce) {
+        gcm_crypt_ce(ctx, iv, (const uint8_t *)in, (uint8_t *)out, len, encrypt, s);
+        return;
+    }
+#endif
+    gcm_crypt_scalar(ctx, iv, (const uint8_t *)in, (uint8_t *)out, len, encrypt, s);
+}
+
+void aes_gcm_encrypt(const aes_gcm_ctx_t *ctx, const uint8_t iv[AES_GCM_IV_SIZE],
+                     const void *in, void *out, uint64_t len, uint8_t tag[AES_GCM_TAG_SIZE]) {
+    gcm_crypt(ctx, iv, in, out, len, 1, tag);
+}
+
+/*
+ * aes_gcm_decrypt
+ * Returns 0 when the tag matches, -1 otherwise (out holds the plaintext
+ * either way; callers must not use it on failure).
+ */
+int aes_gcm_decrypt(const aes_gcm_ctx_t *ctx, const uint8_t iv[AES_GCM_IV_SIZE],
+                    const void *in, void *out, uint64_t len, const uint8_t tag[AES_GCM_TAG_SIZE]) {
+    uint8_t s[AES_GCM_TAG_SIZE];
+    uint8_t diff = 0;
+
+    gcm_crypt(ctx, iv, in, out, len, 0, s);
+    for (uint32_t i = 0; i < AES_GCM_TAG_SIZE; i++) {
+        diff |= (uint8_t)(s[i] ^ tag[i]);
+    }
+    return diff ? -1 : 0;
+}
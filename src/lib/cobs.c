@@ -0,0 +1,113 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        cobs.c
+ * Module:      Consistent Overhead Byte Stuffing Implementation
+ * ======================================================================================
+ */
+
+#include "lib/cobs.h"
+
+/*
+ * cobs_encode
+ * One-shot encoder. 'dst' must hold COBS_MAX_ENCODED(len) bytes.
+ * Returns the encoded length (no delimiter is appended).
+ */
+uint32_t cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst) {
+    uint32_t code_idx = 0;
+    uint32_t w = 1;
+    uint8_t code = 1;
+
+    for (uint32_t r = 0; r < len; r++) {
+        if (src[r] == 0) {
+            dst[code_idx] = code;
+            code_idx = w++;
+            code = 1;
+            continue;
+        }
+
+        dst[w++] = src[r];
+        if (++code == 0xFF) {
+            dst[code_idx] = code;
+            code_idx = w++;
+            code = 1;
+        }
+    }
+
+    dst[code_idx] = code;
+    return w;
+}
+
+/*
+ * cobs_decode
+ * 'src' excludes the delimiter. dst == src is allowed.
+ * Returns the decoded length, or -1 on a malformed frame.
+ */
+int cobs_decode(const uint8_t *src, uint32_t len, uint8_t *dst) {
+    uint32_t r = 0;
+    uint32_t w = 0;
+
+    while (r < len) {
+        uint8_t code = src[r++];
+
+        if (code == 0 || (r + code - 1) > len) {
+            return -1;
+        }
+
+        for (uint8_t i = 1; i < code; i++) {
+            dst[w++] = src[r++];
+        }
+
+        if (code != 0xFF && r < len) {
+            dst[w++] = 0;
+        }
+    }
+
+    return (int)w;
+}
+
+/*
+ * ======================================================================================
+ * STREAMING ENCODER
+ * ======================================================================================
+ */
+
+static void cobs_enc_flush(cobs_enc_t *e) {
+    e->block[0] = (uint8_t)e->len;
+    e->emit(e->block, e->len, e->arg);
+    e->len = 1;
+}
+
+void cobs_enc_begin(cobs_enc_t *e, void (*emit)(const uint8_t *, uint32_t, void *), void *arg) {
+    e->emit = emit;
+    e->arg = arg;
+    e->len = 1;
+}
+
+void cobs_enc_feed(cobs_enc_t *e, const void *data, uint32_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    for (uint32_t i = 0; i < len; i++) {
+        if (p[i] == 0) {
+            cobs_enc_flush(e);
+            continue;
+        }
+
+        e->block[e->len++] = p[i];
+        if (e->len == 0xFF) {
+            cobs_enc_flush(e);
+        }
+    }
+}
+
+/*
+ * cobs_enc_end
+ * Emits the final block followed by the 0x00 frame delimiter.
+ */
+void cobs_enc_end(cobs_enc_t *e) {
+    static const uint8_t delim = 0;
+
+    cobs_enc_flush(e);
+    e->emit(&delim, 1, e->arg);
+}
@@ -0,0 +1,42 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        crc16.c
+ * Module:      CRC-16/CCITT-FALSE Implementation
+ * ======================================================================================
+ */
+
+#include "lib/crc16.h"
+
+static uint16_t crc16_table[256];
+static int crc16_table_ready = 0;
+
+static void crc16_build_table(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint16_t c = (uint16_t)(i << 8);
+        for (int b = 0; b < 8; b++) {
+            c = (c & 0x8000) ? (uint16_t)((c << 1) ^ 0x1021) : (uint16_t)(c << 1);
+        }
+        crc16_table[i] = c;
+    }
+    crc16_table_ready = 1;
+}
+
+/*
+ * crc16_update
+ * Continues a running CRC over 'len' more bytes (chainable across buffers).
+ */
+uint16_t crc16_update(uint16_t crc, const void *data, uint32_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    if (!crc16_table_ready) {
+        crc16_build_table();
+    }
+
+    while (len--) {
+        crc = (uint16_t)((crc << 8) ^ crc16_table[((crc >> 8) ^ *p++) & 0xFF]);
+    }
+
+    return crc;
+}
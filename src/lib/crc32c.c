@@ -0,0 +1,175 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        crc32c.c
+ * Module:      CRC-32C Implementation
+ * ======================================================================================
+ */
+
+#include "lib/crc32c.h"
+
+#define CRC32C_POLY_REV         0x82F63B78U
+
+static uint32_t crc32c_table[8][256];       // Slicing-by-8
+static int crc32c_table_ready = 0;
+
+/* Register after CRC32C_LANE / 2 * CRC32C_LANE zero bytes, by input byte */
+static uint32_t crc32c_shift1[4][256];
+static uint32_t crc32c_shift2[4][256];
+static int crc32c_shift_ready = 0;
+
+static void crc32c_build_table(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int b = 0; b < 8; b++) {
+            c = (c & 1) ? (c >> 1) ^ CRC32C_POLY_REV : (c >> 1);
+        }
+        crc32c_table[0][i] = c;
+    }
+    for (uint32_t k = 1; k < 8; k++) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = crc32c_table[k - 1][i];
+            crc32c_table[k][i] = (c >> 8) ^ crc32c_table[0][c & 0xFF];
+        }
+    }
+    crc32c_table_ready = 1;
+}
+
+/*
+ * crc32c_build_shift
+ * Appending n zero bytes is linear in the register: take the image of
+ * each of the 32 register bits, then tabulate by byte.
+ */
+static void crc32c_build_shift(uint32_t sh[4][256], uint32_t n) {
+    uint32_t basis[32];
+
+    for (uint32_t i = 0; i < 32; i++) {
+        uint32_t r = 1U << i;
+        for (uint32_t z = 0; z < n; z++) {
+            r = (r >> 8) ^ crc32c_table[0][r & 0xFF];
+        }
+        basis[i] = r;
+    }
+    for (uint32_t k = 0; k < 4; k++) {
+        for (uint32_t v = 0; v < 256; v++) {
+            uint32_t r = 0;
+            for (uint32_t b = 0; b < 8; b++) {
+                if (v & (1U << b)) r ^= basis[8 * k + b];
+            }
+            sh[k][v] = r;
+        }
+    }
+}
+
+static inline uint32_t crc32c_shift(const uint32_t sh[4][256], uint32_t r) {
+    return sh[0][r & 0xFF] ^ sh[1][(r >> 8) & 0xFF] ^ sh[2][(r >> 16) & 0xFF] ^ sh[3][r >> 24];
+}
+
+uint32_t crc32c_sw_u64(uint32_t r, uint64_t v) {
+    uint32_t lo, hi;
+
+    if (!crc32c_table_ready) {
+        crc32c_build_table();
+    }
+    lo = r ^ (uint32_t)v;
+    hi = (uint32_t)(v >> 32);
+    return crc32c_table[7][lo & 0xFF] ^ crc32c_table[6][(lo >> 8) & 0xFF] ^
+           crc32c_table[5][(lo >> 16) & 0xFF] ^ crc32c_table[4][lo >> 24] ^
+           crc32c_table[3][hi & 0xFF] ^ crc32c_table[2][(hi >> 8) & 0xFF] ^
+           crc32c_table[1][(hi >> 16) & 0xFF] ^ crc32c_table[0][hi >> 24];
+}
+
+/*
+ * crc32c_sw
+ * Byte at a time, no CRC instructions; the reference for the rest.
+ */
+uint32_t crc32c_sw(uint32_t crc, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t r = ~crc;
+
+    if (!crc32c_table_ready) {
+        crc32c_build_table();
+    }
+    while (len--) {
+        r = (r >> 8) ^ crc32c_table[0][(r ^ *p++) & 0xFF];
+    }
+    return ~r;
+}
+
+static inline uint64_t crc32c_load64(const uint8_t *p) {
+    uint64_t v;
+    __builtin_memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/*
+ * crc32c
+ * Head bytes to 8-byte alignment, 3-lane chunks, then the tail.
+ */
+uint32_t crc32c(uint32_t crc, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t r = ~crc;
+
+    /* 1. Align */
+    while (len && ((uintptr_t)p & 7)) {
+        r = crc32c_u8(r, *p++);
+        len--;
+    }
+
+    /* 2. Three independent chains, folded: A|B|C = A << 2L ^ B << L ^ C */
+    if (len >= 3 * CRC32C_LANE) {
+        if (!crc32c_shift_ready) {
+            if (!crc32c_table_ready) crc32c_build_table();
+            crc32c_build_shift(crc32c_shift1, CRC32C_LANE);
+            crc32c_build_shift(crc32c_shift2, 2 * CRC32C_LANE);
+            crc32c_shift_ready = 1;
+        }
+        do {
+            const uint64_t *a = (const uint64_t *)p;
+            const uint64_t *b = a + CRC32C_LANE / 8;
+            const uint64_t *c = b + CRC32C_LANE / 8;
+            uint32_t r1 = 0, r2 = 0;
+
+            for (uint32_t i = 0; i < CRC32C_LANE / 8; i++) {
+                r = crc32c_u64(r, a[i]);
+                r1 = crc32c_u64(r1, b[i]);
+                r2 = crc32c_u64(r2, c[i]);
+            }
+            r = crc32c_shift(crc32c_shift2, r) ^ crc32c_shift(crc32c_shift1, r1) ^ r2;
+            p += 3 * CRC32C_LANE;
+            len -= 3 * CRC32C_LANE;
+        } while (len >= 3 * CRC32C_LANE);
+    }
+
+    /* 3. Tail */
+    for (; len >= 8; p += 8, len -= 8) {
+        r = crc32c_u64(r, *(const uint64_t *)p);
+    }
+    while (len--) {
+        r = crc32c_u8(r, *p++);
+    }
+    return ~r;
+}
+
+/*
+ * crc32c_copy
+ * memcpy that returns the checksum of what it copied; each word is
+ * folded on its way through the registers.
+ */
+uint32_t crc32c_copy(uint32_t crc, void *dst, const void *src, size_t len) {
+    const uint8_t *s = (const uint8_t *)src;
+    uint8_t *d = (uint8_t *)dst;
+    uint32_t r = ~crc;
+
+    for (; len >= 8; s += 8, d += 8, len -= 8) {
+        uint64_t v = crc32c_load64(s);
+        __builtin_memcpy(d, &v, sizeof(v));
+        r = crc32c_u64(r, v);
+    }
+    while (len--) {
+        *d = *s++;
+        r = crc32c_u8(r, *d++);
+    }
+    return ~r;
+}
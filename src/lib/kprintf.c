@@ -11,6 +11,7 @@
  */
 
 #include "drivers/uart_ps.h"
+#include "kernel/pstore.h"
 #include <stdarg.h> /* Compiler builtin for variable arguments */
 #include <stdint.h>
 
@@ -86,6 +87,21 @@ static char* xtoa(uint64_t value, char* str) {
  * ======================================================================================
  */
 
+/*
+ * kputc / kputs
+ * Every character lands in the crash-persistent log ring and on the console.
+ */
+static inline void kputc(char c) {
+    pstore_log_putc(c);
+    uart_send_byte((uint8_t)c);
+}
+
+static void kputs(const char *s) {
+    while (*s) {
+        kputc(*s++);
+    }
+}
+
 void kprintf(const char* format, ...) {
     va_list args;
     va_start(args, format);
@@ -100,7 +116,7 @@ void kprintf(const char* format, ...) {
     while ((c = *format++) != 0) {
         
         if (c != '%') {
-            uart_send_byte(c);
+            kputc(c);
             continue;
         }
 
@@ -108,64 +124,72 @@ void kprintf(const char* format, ...) {
         c = *format++;
         if (c == 0) break;
 
+        /* Length Modifier: 'l' / 'll' take a 64-bit argument */
+        int is_long = 0;
+        while (c == 'l') {
+            is_long = 1;
+            c = *format++;
+        }
+        if (c == 0) break;
+
         switch (c) {
             /* Character */
             case 'c':
-                uart_send_byte((char)va_arg(args, int));
+                kputc((char)va_arg(args, int));
                 break;
 
             /* String */
             case 's':
                 str = va_arg(args, const char*);
                 if (!str) str = "(null)";
-                uart_send_string(str);
+                kputs(str);
                 break;
 
             /* Signed Decimal */
             case 'd':
             case 'i':
-                i_val = va_arg(args, int);
+                i_val = is_long ? va_arg(args, int64_t) : va_arg(args, int);
                 itoa(i_val, num_buffer, 10);
-                uart_send_string(num_buffer);
+                kputs(num_buffer);
                 break;
 
             /* Unsigned Decimal */
             case 'u':
-                u_val = va_arg(args, unsigned int);
+                u_val = is_long ? va_arg(args, uint64_t) : va_arg(args, unsigned int);
                 itoa(u_val, num_buffer, 10); // Re-use itoa for unsigned logic
-                uart_send_string(num_buffer);
+                kputs(num_buffer);
                 break;
 
             /* Hexadecimal (Lower case) */
             case 'x':
-                u_val = va_arg(args, unsigned int);
+                u_val = is_long ? va_arg(args, uint64_t) : va_arg(args, unsigned int);
                 itoa(u_val, num_buffer, 16);
-                uart_send_string(num_buffer);
+                kputs(num_buffer);
                 break;
 
             /* Pointer / Address (64-bit Hex) */
             case 'p':
                 ptr_val = va_arg(args, void*);
-                uart_send_string("0x");
+                kputs("0x");
                 xtoa((uint64_t)ptr_val, num_buffer);
-                uart_send_string(num_buffer);
+                kputs(num_buffer);
                 break;
             
             /* Binary */
             case 'b':
-                u_val = va_arg(args, unsigned int);
+                u_val = is_long ? va_arg(args, uint64_t) : va_arg(args, unsigned int);
                 itoa(u_val, num_buffer, 2);
-                uart_send_string(num_buffer);
+                kputs(num_buffer);
                 break;
 
             /* Percent escape */
             case '%':
-                uart_send_byte('%');
+                kputc('%');
                 break;
 
             default:
-                uart_send_byte('%');
-                uart_send_byte(c);
+                kputc('%');
+                kputc(c);
                 break;
         }
     }
@@ -0,0 +1,150 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        sha3.c
+ * Module:      SHA3-384 Implementation
+ * ======================================================================================
+ */
+
+#include "lib/sha3.h"
+
+static const uint64_t keccak_rc[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+/* rho offsets and pi destinations, in pi order starting from lane 1 */
+static const uint8_t keccak_rho[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+static const uint8_t keccak_pi[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+static inline uint64_t rol64(uint64_t v, uint32_t n) {
+    return (v << n) | (v >> (64 - n));
+}
+
+/*
+ * keccak_f1600
+ * The 24-round permutation, lanes in host (little-endian) order.
+ */
+void keccak_f1600(uint64_t s[25]) {
+    uint64_t c[5], t;
+
+    for (uint32_t round = 0; round < 24; round++) {
+        /* 1. Theta */
+        for (uint32_t x = 0; x < 5; x++) {
+            c[x] = s[x] ^ s[x + 5] ^ s[x + 10] ^ s[x + 15] ^ s[x + 20];
+        }
+        for (uint32_t x = 0; x < 5; x++) {
+            t = c[(x + 4) % 5] ^ rol64(c[(x + 1) % 5], 1);
+            for (uint32_t y = 0; y < 25; y += 5) {
+                s[y + x] ^= t;
+            }
+        }
+
+        /* 2. Rho and pi */
+        t = s[1];
+        for (uint32_t i = 0; i < 24; i++) {
+            uint32_t j = keccak_pi[i];
+            uint64_t next = s[j];
+
+            s[j] = rol64(t, keccak_rho[i]);
+            t = next;
+        }
+
+        /* 3. Chi */
+        for (uint32_t y = 0; y < 25; y += 5) {
+            for (uint32_t x = 0; x < 5; x++) {
+                c[x] = s[y + x];
+            }
+            for (uint32_t x = 0; x < 5; x++) {
+                s[y + x] = c[x] ^ (~c[(x + 1) % 5] & c[(x + 2) % 5]);
+            }
+        }
+
+        /* 4. Iota */
+        s[0] ^= keccak_rc[round];
+    }
+}
+
+/* XORs one rate-sized block into the state (lanes are little-endian) */
+static void sha3_absorb(sha3_ctx_t *ctx, const uint8_t *p) {
+    for (uint32_t i = 0; i < SHA3_384_BLOCK_SIZE / 8; i++) {
+        uint64_t lane = 0;
+
+        for (uint32_t b = 0; b < 8; b++) {
+            lane |= (uint64_t)p[8 * i + b] << (8 * b);
+        }
+        ctx->s[i] ^= lane;
+    }
+    keccak_f1600(ctx->s);
+}
+
+void sha3_384_init(sha3_ctx_t *ctx) {
+    for (uint32_t i = 0; i < 25; i++) {
+        ctx->s[i] = 0;
+    }
+    ctx->fill = 0;
+}
+
+void sha3_384_update(sha3_ctx_t *ctx, const void *data, uint64_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    /* 1. Top up a partial block */
+    if (ctx->fill) {
+        while (len && ctx->fill < SHA3_384_BLOCK_SIZE) {
+            ctx->buf[ctx->fill++] = *p++;
+            len--;
+        }
+        if (ctx->fill < SHA3_384_BLOCK_SIZE) {
+            return;
+        }
+        sha3_absorb(ctx, ctx->buf);
+        ctx->fill = 0;
+    }
+
+    /* 2. Whole blocks straight from the input */
+    while (len >= SHA3_384_BLOCK_SIZE) {
+        sha3_absorb(ctx, p);
+        p += SHA3_384_BLOCK_SIZE;
+        len -= SHA3_384_BLOCK_SIZE;
+    }
+
+    /* 3. Keep the tail */
+    while (len--) {
+        ctx->buf[ctx->fill++] = *p++;
+    }
+}
+
+/*
+ * sha3_384_final
+ * Pads (SHA3 domain bits 01, then pad10*1) and squeezes the digest.
+ */
+void sha3_384_final(sha3_ctx_t *ctx, uint8_t digest[SHA3_384_DIGEST_SIZE]) {
+    for (uint32_t i = ctx->fill; i < SHA3_384_BLOCK_SIZE; i++) {
+        ctx->buf[i] = 0;
+    }
+    ctx->buf[ctx->fill] ^= 0x06;
+    ctx->buf[SHA3_384_BLOCK_SIZE - 1] ^= 0x80;
+    sha3_absorb(ctx, ctx->buf);
+
+    for (uint32_t i = 0; i < SHA3_384_DIGEST_SIZE; i++) {
+        digest[i] = (uint8_t)(ctx->s[i / 8] >> (8 * (i % 8)));
+    }
+    ctx->fill = 0;
+}
+
+void sha3_384(const void *data, uint64_t len, uint8_t digest[SHA3_384_DIGEST_SIZE]) {
+    sha3_ctx_t ctx;
+
+    sha3_384_init(&ctx);
+    sha3_384_update(&ctx, data, len);
+    sha3_384_final(&ctx, digest);
+}
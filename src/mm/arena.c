@@ -0,0 +1,272 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        arena.c
+ * Module:      Scratch Arena Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Allocation and reset are not locked: one arena belongs to one submitter.
+ * Only the reference count is shared with the completion path (IRQ
+ * context), so it is updated atomically.
+ * ======================================================================================
+ */
+
+#include "mm/arena.h"
+#include "mm/kmalloc.h"
+#include "kernel/timer_heavy.h"
+#include "lib/kprintf.h"
+
+static int arena_grow(arena_t *a) {
+    uint64_t pa;
+
+    if (a->nchunks >= ARENA_MAX_CHUNKS) {
+        return -1;
+    }
+
+    pa = pmm_alloc(ARENA_CHUNK_SIZE, PMM_F_HIGH);
+    if (pa == 0) {
+        return -1;
+    }
+
+    a->chunk[a->nchunks++] = pa;
+    return 0;
+}
+
+/*
+ * arena_init
+ * 'prealloc_chunks' 2MB chunks are taken up front so the first jobs do
+ * not pay for the page allocator.
+ */
+int arena_init(arena_t *a, const char *name, uint32_t prealloc_chunks) {
+    a->name = name;
+    a->nchunks = 0;
+    a->cur = 0;
+    a->off = 0;
+    a->refs = 0;
+    a->used = 0;
+    a->high_water = 0;
+    a->allocs = 0;
+    a->resets = 0;
+    a->failures = 0;
+
+    for (uint32_t i = 0; i < prealloc_chunks; i++) {
+        if (arena_grow(a) != 0) {
+            kprintf("[ARENA] %s: only %u of %u chunks\n", name, a->nchunks, prealloc_chunks);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * arena_alloc_aligned
+ * 'align' must be a power of two; anything below a cache line is raised
+ * to one. A request never straddles two chunks.
+ */
+void *arena_alloc_aligned(arena_t *a, size_t size, size_t align) {
+    uint64_t off;
+
+    if (size == 0 || size > ARENA_CHUNK_SIZE) {
+        a->failures++;
+        return NULL;
+    }
+    if (align < ARENA_ALIGN) align = ARENA_ALIGN;
+
+    /* 1. Fits in the current chunk? */
+    off = (a->off + align - 1) & ~(uint64_t)(align - 1);
+    if (a->cur < a->nchunks && off + size <= ARENA_CHUNK_SIZE) {
+        a->off = off + size;
+        a->used += size;
+        a->allocs++;
+        return (void *)(uintptr_t)(a->chunk[a->cur] + off);
+    }
+
+    /* 2. Next chunk (kept from an earlier job, or new) */
+    if (a->cur < a->nchunks && a->off != 0) {
+        a->cur++;
+    }
+    if (a->cur >= a->nchunks && arena_grow(a) != 0) {
+        a->failures++;
+        return NULL;
+    }
+
+    a->off = size;
+    a->used += size;
+    a->allocs++;
+    return (void *)(uintptr_t)a->chunk[a->cur];
+}
+
+void *arena_alloc(arena_t *a, size_t size) {
+    return arena_alloc_aligned(a, size, ARENA_ALIGN);
+}
+
+/*
+ * arena_reset
+ * Frees everything in O(1). Chunks stay with the arena.
+ */
+void arena_reset(arena_t *a) {
+    if (a->used > a->high_water) {
+        a->high_water = a->used;
+    }
+    a->cur = 0;
+    a->off = 0;
+    a->used = 0;
+    a->resets++;
+}
+
+/*
+ * arena_destroy
+ * Returns the chunks to the page allocator. No references may remain.
+ */
+void arena_destroy(arena_t *a) {
+    for (uint32_t i = 0; i < a->nchunks; i++) {
+        pmm_free(a->chunk[i], ARENA_CHUNK_SIZE);
+    }
+    a->nchunks = 0;
+    a->cur = 0;
+    a->off = 0;
+    a->used = 0;
+}
+
+void arena_get(arena_t *a) {
+    __atomic_fetch_add(&a->refs, 1, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * arena_put
+ * Drops a reference; the last one resets the arena. Safe from IRQ context.
+ */
+void arena_put(arena_t *a) {
+    if (__atomic_sub_fetch(&a->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        arena_reset(a);
+    }
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK
+ * ======================================================================================
+ * A job allocates BENCH_TEMPS temporaries (64B .. 32KB, like tile and
+ * quantization buffers) and frees them at completion; every 8th temporary
+ * is a result that outlives its job by BENCH_KEEP jobs, which is what
+ * fragments a general heap.
+ */
+
+#define BENCH_JOBS              256
+#define BENCH_TEMPS             48
+#define BENCH_KEEP              4
+#define BENCH_MAX_SIZE          (32 * 1024)
+
+static uint32_t bench_seed;
+
+static uint32_t bench_rand(void) {
+    bench_seed = bench_seed * 1664525U + 1013904223U;
+    return bench_seed >> 8;
+}
+
+static size_t bench_size(void) {
+    return 64 + bench_rand() % (BENCH_MAX_SIZE - 64);
+}
+
+/*
+ * arena_benchmark
+ * Allocation cost and fragmentation: kmalloc/kfree against an arena
+ * reset per job. Needs kheap_init().
+ */
+void arena_benchmark(void) {
+    static void *temps[BENCH_TEMPS];
+    static void *kept[BENCH_KEEP][BENCH_TEMPS / 8];
+    static arena_t job_arena, result_arena[BENCH_KEEP];
+    kheap_stats_t hs;
+    uint64_t heap_ticks = 0, arena_ticks = 0, reset_ticks = 0;
+    uint64_t heap_n = 0, arena_n = 0, heap_fail = 0;
+
+    kprintf("[ARENA] Benchmark: %u jobs x %u temporaries (64 B .. %u KB)\n",
+            BENCH_JOBS, BENCH_TEMPS, BENCH_MAX_SIZE / 1024);
+
+    /* 1. General heap */
+    bench_seed = 0x1234567;
+    for (uint32_t j = 0; j < BENCH_JOBS; j++) {
+        uint32_t ring = j % BENCH_KEEP, k = 0;
+
+        for (uint32_t i = 0; i < BENCH_TEMPS / 8; i++) {
+            kfree(kept[ring][i]); // Results of job j - BENCH_KEEP
+            kept[ring][i] = NULL;
+        }
+
+        for (uint32_t i = 0; i < BENCH_TEMPS; i++) {
+            size_t size = bench_size();
+            uint64_t t0 = timer_get_ticks();
+            void *p = kmalloc(size);
+            heap_ticks += timer_get_ticks() - t0;
+            heap_n++;
+            if (p == NULL) heap_fail++;
+
+            if ((i & 7) == 7) {
+                kept[ring][k++] = p;
+                temps[i] = NULL;
+            } else {
+                temps[i] = p;
+            }
+        }
+
+        uint64_t t0 = timer_get_ticks();
+        for (uint32_t i = 0; i < BENCH_TEMPS; i++) {
+            kfree(temps[i]);
+        }
+        heap_ticks += timer_get_ticks() - t0;
+    }
+
+    kheap_get_stats(&hs);
+    for (uint32_t r = 0; r < BENCH_KEEP; r++) {
+        for (uint32_t i = 0; i < BENCH_TEMPS / 8; i++) {
+            kfree(kept[r][i]);
+            kept[r][i] = NULL;
+        }
+    }
+
+    /* 2. Arenas: one per job for temporaries, one per in-flight result set */
+    if (arena_init(&job_arena, "bench_job", 1) != 0) {
+        return;
+    }
+    for (uint32_t r = 0; r < BENCH_KEEP; r++) {
+        arena_init(&result_arena[r], "bench_result", 0);
+    }
+
+    bench_seed = 0x1234567;
+    for (uint32_t j = 0; j < BENCH_JOBS; j++) {
+        arena_t *res = &result_arena[j % BENCH_KEEP];
+        uint64_t t0;
+
+        arena_reset(res);
+        for (uint32_t i = 0; i < BENCH_TEMPS; i++) {
+            size_t size = bench_size();
+            t0 = timer_get_ticks();
+            (void)arena_alloc(((i & 7) == 7) ? res : &job_arena, size);
+            arena_ticks += timer_get_ticks() - t0;
+            arena_n++;
+        }
+
+        t0 = timer_get_ticks();
+        arena_reset(&job_arena);
+        reset_ticks += timer_get_ticks() - t0;
+    }
+
+    /* 3. Report */
+    kprintf("  kmalloc: %lu ns/op (alloc+free), %lu failures\n",
+            timer_ticks_to_ns(heap_ticks) / heap_n, heap_fail);
+    kprintf("           after %u jobs: %lu KB free in %u blocks, largest %lu KB\n",
+            BENCH_JOBS, hs.free >> 10, hs.free_blocks, hs.largest_free >> 10);
+    kprintf("  arena:   %lu ns/alloc, %lu ns/reset, %lu failures\n",
+            timer_ticks_to_ns(arena_ticks) / arena_n,
+            timer_ticks_to_ns(reset_ticks) / BENCH_JOBS, job_arena.failures);
+    kprintf("           job high water %lu KB in %u chunk(s), nothing left behind\n",
+            job_arena.high_water >> 10, job_arena.nchunks);
+
+    arena_destroy(&job_arena);
+    for (uint32_t r = 0; r < BENCH_KEEP; r++) {
+        arena_destroy(&result_arena[r]);
+    }
+}
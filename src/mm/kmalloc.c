@@ -0,0 +1,244 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        kmalloc.c
+ * Module:      Kernel Heap Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Block layout:  [ size | flags ][ payload ... ][ size ]
+ *                  header (16B)                  footer (8B)
+ * Free blocks link into a doubly linked list through their payload.
+ * The heap is bracketed by two zero-size "used" sentinels so coalescing
+ * never walks off either end.
+ * ======================================================================================
+ */
+
+#include "mm/kmalloc.h"
+#include "mm/pmm.h"
+#include "kernel/irq_prio.h"
+#include "lib/kprintf.h"
+
+#define BLK_USED                1UL
+#define BLK_HDR                 16
+#define BLK_FTR                 8
+#define BLK_MIN                 (BLK_HDR + 16 + BLK_FTR + 8)   // Room for the links, aligned
+
+typedef struct blk {
+    uint64_t size_flags;            // Whole block size | BLK_USED
+    uint64_t pad;
+    struct blk *next;               // Free blocks only
+    struct blk *prev;
+} blk_t;
+
+static uint8_t *heap_base;
+static uint64_t heap_size;
+static blk_t *free_list;
+static kheap_stats_t stats;
+
+static uint8_t kheap_spin;
+
+/* Interrupt masking up to the kernel ceiling, spinlock against the other cores */
+static inline uint32_t kheap_lock(void) {
+    uint32_t saved = irq_prio_save_and_raise(IRQ_PRIO_CEIL_KERNEL);
+
+    while (__atomic_test_and_set(&kheap_spin, __ATOMIC_ACQUIRE)) {
+        asm volatile("yield");
+    }
+    return saved;
+}
+
+static inline void kheap_unlock(uint32_t saved) {
+    __atomic_clear(&kheap_spin, __ATOMIC_RELEASE);
+    irq_prio_restore(saved);
+}
+
+/*
+ * ======================================================================================
+ * BLOCK HELPERS
+ * ======================================================================================
+ */
+
+static inline uint64_t blk_size(const blk_t *b) {
+    return b->size_flags & ~BLK_USED;
+}
+
+static inline int blk_used(const blk_t *b) {
+    return (int)(b->size_flags & BLK_USED);
+}
+
+static inline void blk_set(blk_t *b, uint64_t size, uint64_t used) {
+    b->size_flags = size | used;
+    *(uint64_t *)((uint8_t *)b + size - BLK_FTR) = size | used;
+}
+
+static inline blk_t *blk_next(blk_t *b) {
+    return (blk_t *)((uint8_t *)b + blk_size(b));
+}
+
+static inline blk_t *blk_prev(blk_t *b) {
+    uint64_t prev_size = *(uint64_t *)((uint8_t *)b - BLK_FTR) & ~BLK_USED;
+    return (blk_t *)((uint8_t *)b - prev_size);
+}
+
+static inline int blk_prev_used(blk_t *b) {
+    return (int)(*(uint64_t *)((uint8_t *)b - BLK_FTR) & BLK_USED);
+}
+
+static void list_push(blk_t *b) {
+    b->prev = NULL;
+    b->next = free_list;
+    if (free_list) free_list->prev = b;
+    free_list = b;
+}
+
+static void list_remove(blk_t *b) {
+    if (b->prev) b->prev->next = b->next;
+    else free_list = b->next;
+    if (b->next) b->next->prev = b->prev;
+}
+
+/*
+ * ======================================================================================
+ * PUBLIC API
+ * ======================================================================================
+ */
+
+/*
+ * kheap_init
+ * Takes 'size' bytes of low DDR from the page allocator (pmm_init and
+ * mem_detect first).
+ */
+int kheap_init(size_t size) {
+    uint64_t pa;
+    blk_t *first;
+
+    size = (size + PMM_PAGE_SIZE - 1) & ~(PMM_PAGE_SIZE - 1);
+    pa = pmm_alloc(size, PMM_F_LOW);
+    if (pa == 0) {
+        kprintf("[KHEAP] ERR: no memory for a %lu KB heap\n", (uint64_t)size >> 10);
+        return -1;
+    }
+
+    heap_base = (uint8_t *)(uintptr_t)pa;
+    heap_size = size;
+
+    /* 1. Sentinels: an 8-byte "used footer" at the start, a used header at the end */
+    *(uint64_t *)(heap_base + BLK_HDR - BLK_FTR) = BLK_USED;
+    ((blk_t *)(heap_base + size - BLK_HDR))->size_flags = BLK_USED;
+
+    /* 2. One free block in between */
+    first = (blk_t *)(heap_base + BLK_HDR);
+    blk_set(first, size - 2 * BLK_HDR, 0);
+    free_list = NULL;
+    list_push(first);
+
+    stats.size = size;
+    stats.free = blk_size(first);
+    kprintf("[KHEAP] %lu KB at 0x%lx\n", (uint64_t)size >> 10, pa);
+    return 0;
+}
+
+void *kmalloc(size_t size) {
+    uint64_t need = (size + BLK_HDR + BLK_FTR + KHEAP_ALIGN - 1) & ~(uint64_t)(KHEAP_ALIGN - 1);
+    uint32_t irq;
+    blk_t *b;
+
+    if (size == 0 || heap_base == NULL) {
+        return NULL;
+    }
+    if (need < BLK_MIN) need = BLK_MIN;
+
+    irq = kheap_lock();
+
+    /* 1. First fit */
+    for (b = free_list; b; b = b->next) {
+        if (blk_size(b) >= need) break;
+    }
+    if (b == NULL) {
+        stats.failures++;
+        kheap_unlock(irq);
+        return NULL;
+    }
+    list_remove(b);
+
+    /* 2. Split off the tail if it can stand on its own */
+    if (blk_size(b) - need >= BLK_MIN) {
+        blk_t *rest = (blk_t *)((uint8_t *)b + need);
+        blk_set(rest, blk_size(b) - need, 0);
+        list_push(rest);
+        blk_set(b, need, BLK_USED);
+    } else {
+        blk_set(b, blk_size(b), BLK_USED);
+    }
+
+    stats.used += blk_size(b);
+    stats.free -= blk_size(b);
+    stats.allocs++;
+    kheap_unlock(irq);
+
+    return (uint8_t *)b + BLK_HDR;
+}
+
+void kfree(void *ptr) {
+    blk_t *b, *n;
+    uint64_t size;
+    uint32_t irq;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    b = (blk_t *)((uint8_t *)ptr - BLK_HDR);
+    irq = kheap_lock();
+
+    if (!blk_used(b)) {
+        kheap_unlock(irq);
+        kprintf("[KHEAP] WARN: double free of %p\n", ptr);
+        return;
+    }
+
+    size = blk_size(b);
+    stats.used -= size;
+    stats.free += size;
+    stats.frees++;
+
+    /* 1. Merge with the following block */
+    n = blk_next(b);
+    if (!blk_used(n)) {
+        list_remove(n);
+        size += blk_size(n);
+    }
+
+    /* 2. Merge with the preceding block */
+    if (!blk_prev_used(b)) {
+        blk_t *p = blk_prev(b);
+        list_remove(p);
+        size += blk_size(p);
+        b = p;
+    }
+
+    blk_set(b, size, 0);
+    list_push(b);
+    kheap_unlock(irq);
+}
+
+/*
+ * kheap_get_stats
+ * Walks the free list for the fragmentation figures.
+ */
+void kheap_get_stats(kheap_stats_t *out) {
+    uint32_t irq = kheap_lock();
+
+    stats.largest_free = 0;
+    stats.free_blocks = 0;
+    for (blk_t *b = free_list; b; b = b->next) {
+        uint64_t payload = blk_size(b) - BLK_HDR - BLK_FTR;
+        if (payload > stats.largest_free) stats.largest_free = payload;
+        stats.free_blocks++;
+    }
+    *out = stats;
+
+    kheap_unlock(irq);
+}
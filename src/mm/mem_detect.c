@@ -0,0 +1,238 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        mem_detect.c
+ * Module:      DDR Discovery Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * DTB: only the structure block is walked (no libfdt). Root-level
+ * #address-cells / #size-cells are honoured, every /memory* node's 'reg'
+ * ranges are registered.
+ *
+ * DDRC: the highest HIF address bit used by the row/rank mapping gives the
+ * per-rank depth; times the bus width in bytes this is the DDR size. The
+ * registers read as zero when the FSBL did not program the controller
+ * (e.g. under QEMU), which is rejected by the range check.
+ * ======================================================================================
+ */
+
+#include "mm/mem_detect.h"
+#include "mm/pmm.h"
+#include "platform/zynqmp_hardware.h"
+#include "lib/kprintf.h"
+
+/* Helper Macros for Memory Mapped I/O */
+#define MMIO_READ32(addr)       (*(volatile uint32_t *)(addr))
+
+/* FDT Structure Tokens */
+#define FDT_BEGIN_NODE          0x1
+#define FDT_END_NODE            0x2
+#define FDT_PROP                0x3
+#define FDT_NOP                 0x4
+#define FDT_END                 0x9
+
+/* DDRC Registers (UG1087, DDRC module) */
+#define DDRC_MSTR               (ZYNQMP_DDRC_BASE + 0x000)
+#define DDRC_ADDRMAP0           (ZYNQMP_DDRC_BASE + 0x200)  // Rank (CS) bit
+#define DDRC_ADDRMAP5           (ZYNQMP_DDRC_BASE + 0x214)  // Row b0, b1, b2..10, b11
+#define DDRC_ADDRMAP6           (ZYNQMP_DDRC_BASE + 0x218)  // Row b12..b15
+#define DDRC_ADDRMAP7           (ZYNQMP_DDRC_BASE + 0x21C)  // Row b16, b17
+
+#define DDRC_MSTR_BUS_WIDTH(v)  (((v) >> 12) & 0x3)         // 0: 64-bit, 1: 32-bit, 2: 16-bit
+#define DDRC_MAP_UNUSED_ROW     15
+#define DDRC_MAP_UNUSED_CS      31
+
+#define MEM_MIN_PLAUSIBLE       (256ULL << 20)
+#define MEM_MAX_PLAUSIBLE       (ZYNQMP_DDR_LOW_SIZE + ZYNQMP_DDR_HIGH_SIZE)
+
+/*
+ * ======================================================================================
+ * DEVICE TREE
+ * ======================================================================================
+ */
+
+static inline uint32_t be32(const void *p) {
+    return __builtin_bswap32(*(const uint32_t *)p);
+}
+
+static uint64_t fdt_cells(const uint8_t *p, uint32_t cells) {
+    uint64_t v = 0;
+    for (uint32_t i = 0; i < cells; i++) {
+        v = (v << 32) | be32(p + 4 * i);
+    }
+    return v;
+}
+
+static int str_eq(const char *a, const char *b) {
+    while (*a && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+static int str_prefix(const char *s, const char *prefix) {
+    while (*prefix) {
+        if (*s++ != *prefix++) return 0;
+    }
+    return 1;
+}
+
+/*
+ * mem_from_dtb
+ * Returns the number of ranges registered.
+ */
+static int mem_from_dtb(const uint8_t *fdt) {
+    uint32_t addr_cells = 2, size_cells = 1;   // Spec defaults
+    uint32_t depth = 0, found = 0;
+    int in_memory = 0;
+
+    if (fdt == NULL || be32(fdt) != FDT_MAGIC) {
+        return 0;
+    }
+
+    const uint8_t *p = fdt + be32(fdt + 8);            // off_dt_struct
+    const char *strings = (const char *)fdt + be32(fdt + 12);
+    const uint8_t *end = p + be32(fdt + 36);           // size_dt_struct
+
+    while (p < end) {
+        uint32_t tok = be32(p);
+        p += 4;
+
+        if (tok == FDT_BEGIN_NODE) {
+            const char *name = (const char *)p;
+            uint32_t len = 0;
+            while (name[len]) len++;
+            p += (len + 4) & ~3U;
+
+            depth++;
+            in_memory = (depth == 2) && str_prefix(name, "memory") &&
+                        (name[6] == '\0' || name[6] == '@');
+        } else if (tok == FDT_END_NODE) {
+            depth--;
+            in_memory = 0;
+        } else if (tok == FDT_PROP) {
+            uint32_t len = be32(p);
+            const char *pname = strings + be32(p + 4);
+            const uint8_t *val = p + 8;
+            p += 8 + ((len + 3) & ~3U);
+
+            if (depth == 1 && str_eq(pname, "#address-cells")) {
+                addr_cells = be32(val);
+            } else if (depth == 1 && str_eq(pname, "#size-cells")) {
+                size_cells = be32(val);
+            } else if (in_memory && str_eq(pname, "reg")) {
+                uint32_t stride = 4 * (addr_cells + size_cells);
+                for (uint32_t off = 0; stride && off + stride <= len; off += stride) {
+                    uint64_t base = fdt_cells(val + off, addr_cells);
+                    uint64_t size = fdt_cells(val + off + 4 * addr_cells, size_cells);
+                    if (size && pmm_add_region(base, size) == 0) {
+                        found++;
+                    }
+                }
+            }
+        } else if (tok == FDT_END) {
+            break;
+        } else if (tok != FDT_NOP) {
+            break; // Corrupt blob
+        }
+    }
+
+    return (int)found;
+}
+
+/*
+ * ======================================================================================
+ * DDR CONTROLLER
+ * ======================================================================================
+ */
+
+static uint32_t ddrc_top_bit(uint32_t top, uint32_t field, uint32_t base, uint32_t unused) {
+    if (field != unused && field + base > top) {
+        return field + base;
+    }
+    return top;
+}
+
+/*
+ * mem_size_from_ddrc
+ * Returns the total DDR size in bytes, or 0 if the map is not programmed.
+ */
+static uint64_t mem_size_from_ddrc(void) {
+    uint32_t mstr = MMIO_READ32(DDRC_MSTR);
+    uint32_t map0 = MMIO_READ32(DDRC_ADDRMAP0);
+    uint32_t map5 = MMIO_READ32(DDRC_ADDRMAP5);
+    uint32_t map6 = MMIO_READ32(DDRC_ADDRMAP6);
+    uint32_t map7 = MMIO_READ32(DDRC_ADDRMAP7);
+    uint32_t top = 0;
+    uint64_t size;
+
+    if (mstr == 0) {
+        return 0;
+    }
+
+    /* 1. Highest row bit (row_bN sits at HIF bit field + N + 6) */
+    top = ddrc_top_bit(top, (map5 >> 24) & 0xF, 17, DDRC_MAP_UNUSED_ROW);  // b11
+    top = ddrc_top_bit(top, (map6 >> 0)  & 0xF, 18, DDRC_MAP_UNUSED_ROW);  // b12
+    top = ddrc_top_bit(top, (map6 >> 8)  & 0xF, 19, DDRC_MAP_UNUSED_ROW);  // b13
+    top = ddrc_top_bit(top, (map6 >> 16) & 0xF, 20, DDRC_MAP_UNUSED_ROW);  // b14
+    top = ddrc_top_bit(top, (map6 >> 24) & 0xF, 21, DDRC_MAP_UNUSED_ROW);  // b15
+    top = ddrc_top_bit(top, (map7 >> 0)  & 0xF, 22, DDRC_MAP_UNUSED_ROW);  // b16
+    top = ddrc_top_bit(top, (map7 >> 8)  & 0xF, 23, DDRC_MAP_UNUSED_ROW);  // b17
+
+    /* 2. Rank select above the rows (dual-rank DIMMs) */
+    top = ddrc_top_bit(top, map0 & 0x1F, 6, DDRC_MAP_UNUSED_CS);
+
+    /* 3. HIF words -> bytes */
+    size = (1ULL << (top + 1)) * (8U >> DDRC_MSTR_BUS_WIDTH(mstr));
+
+    if (size < MEM_MIN_PLAUSIBLE || size > MEM_MAX_PLAUSIBLE) {
+        return 0;
+    }
+    return size;
+}
+
+/*
+ * ======================================================================================
+ * PUBLIC API
+ * ======================================================================================
+ */
+
+/*
+ * mem_detect
+ * Registers all installed DDR with the page allocator (pmm_init first).
+ */
+mem_source_t mem_detect(const void *dtb) {
+    uint64_t size;
+
+    /* 1. Boot loader's device tree (kept: later drivers may parse it too) */
+    if (mem_from_dtb((const uint8_t *)dtb) > 0) {
+        pmm_reserve((uint64_t)(uintptr_t)dtb, be32((const uint8_t *)dtb + 4)); // totalsize
+        return MEM_SRC_DTB;
+    }
+
+    /* 2. DDR controller: first 2GB low, the rest in the high window */
+    size = mem_size_from_ddrc();
+    if (size) {
+        uint64_t low = (size < ZYNQMP_DDR_LOW_SIZE) ? size : ZYNQMP_DDR_LOW_SIZE;
+        pmm_add_region(ZYNQMP_DDR_LOW_BASE, low);
+        if (size > low) {
+            pmm_add_region(ZYNQMP_DDR_HIGH_BASE, size - low);
+        }
+        return MEM_SRC_DDRC;
+    }
+
+    /* 3. Nothing to go on */
+    pmm_add_region(ZYNQMP_DDR_LOW_BASE, ZYNQMP_DDR_LOW_SIZE);
+    return MEM_SRC_DEFAULT;
+}
+
+const char *mem_source_name(mem_source_t src) {
+    switch (src) {
+        case MEM_SRC_DTB:  return "device tree";
+        case MEM_SRC_DDRC: return "DDR controller";
+        default:           return "built-in default";
+    }
+}
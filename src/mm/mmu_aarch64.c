@@ -18,8 +18,11 @@
 
 #include "system.h"
 #include "mm/mmu_defs.h"
+#include "mm/mmu.h"
+#include "mm/pmm.h"
 #include "platform/zynqmp_hardware.h"
 #include "lib/stddef.h"
+#include "kernel/bootprof.h"
 
 /*
  * Global Translation Tables
@@ -38,6 +41,7 @@ __attribute__((aligned(4096))) uint64_t kernel_l2_table[512 * 4]; // Expanded fo
  * * Attr0: Device-nGnRnE (Strictly Ordered, Non-Cacheable) - For UART/FPGA Registers
  * Attr1: Normal Memory (Outer Write-Back, Inner Write-Back) - For RAM/Code
  * Attr2: Device-nGnRE (Non-Ordering) - For PCIe/DMA
+ * Attr3: Normal Memory (Write-Through) - For the crash-persistent store
  */
 void mmu_init_mair(void) {
     uint64_t mair_val = 0;
@@ -51,6 +55,9 @@ void mmu_init_mair(void) {
     // Attribute 2: 0x04 -> Device-nGnRE
     mair_val |= (MAIR_ATTR_DEVICE_nGnRE << (8 * 2));
 
+    // Attribute 3: 0xBB -> Normal Memory, Write-Through (stores reach DDR, no flush on crash)
+    mair_val |= ((uint64_t)MAIR_ATTR_NORMAL_WT << (8 * 3));
+
     // Write to MAIR_EL1
     asm volatile("msr mair_el1, %0" : : "r" (mair_val));
     asm volatile("isb"); // Instruction Synchronization Barrier
@@ -83,6 +90,10 @@ void mmu_init_tcr(void) {
     tcr_val |= (TCR_SH_INNER << TCR_SH0_SHIFT);
     tcr_val |= (TCR_SH_INNER << TCR_SH1_SHIFT);
 
+    // Table walks through the (Write-Back) caches, matching the kernel mapping
+    tcr_val |= (TCR_RGN_WBWA << TCR_IRGN0_SHIFT) | (TCR_RGN_WBWA << TCR_ORGN0_SHIFT);
+    tcr_val |= (TCR_RGN_WBWA << TCR_IRGN1_SHIFT) | (TCR_RGN_WBWA << TCR_ORGN1_SHIFT);
+
     // Write to TCR_EL1
     asm volatile("msr tcr_el1, %0" : : "r" (tcr_val));
     asm volatile("isb");
@@ -114,21 +125,54 @@ void mmu_create_identity_map(void) {
     // 0x00000000 -> 0x7FFFFFFF : Normal Memory, Executable
     phys_addr = 0;
     for (i = 0; i < 1024; i++) { // 1024 entries * 2MB = 2GB
-        uint64_t attr = PT_BLOCK_DESC | PT_ACCESS_FULL | PT_SH_INNER;
+        uint64_t attr = PT_BLOCK_DESC | PT_AF | PT_ACCESS_PRIV_RW | PT_SH_INNER | PT_UXN;
         
         // Mark strictly as 'Normal Memory' (Attr Index 1)
-        attr |= (1 << 2); 
+        // The persistent block is Write-Through (Attr Index 3) so it survives a hang
+        if (phys_addr == ZYNQMP_PERSIST_BASE) {
+            attr |= (3 << 2);
+        } else {
+            attr |= (1 << 2);
+        }
         
         // Define Physical Address
         kernel_l2_table[i] = phys_addr | attr;
         phys_addr += 0x200000; // Increment by 2MB
     }
 
-    /* 4. Setup L2 Table for MMIO (Device Registers) */
-    // 0x80000000 -> 0xFFFFFFFF : Device Memory (UART, GIC, FPGA AXI)
-    // Note: This requires extending the tables to cover the upper region
-    // For simplicity in this snippet, we assume identity mapping continues.
-    // In production, we map specific ranges like 0xFF000000 (UART).
+    /* 4. Setup L1 Blocks (1GB) for MMIO (Device Registers) */
+    // 0x80000000 -> 0xFFFFFFFF : Device-nGnRnE (PL/HOCS AXI, QSPI, UART, GIC, DDRC, OCM)
+    for (i = 2; i < 4; i++) {
+        phys_addr = (uint64_t)i << 30;
+        kernel_l1_table[i] = phys_addr | PT_BLOCK_DESC | PT_AF | PT_ACCESS_PRIV_RW |
+                             PT_UXN | PT_PXN | (0 << 2);
+    }
+}
+
+/*
+ * mmu_map_high_memory
+ * Identity-maps installed DDR in the high window (0x8_0000_0000+) with
+ * 1GB L1 block descriptors: one TLB entry per gigabyte of HOCS/graphics
+ * buffers. The page allocator only registers whole gigabytes there, so
+ * nothing absent is ever mapped as Normal memory.
+ */
+void mmu_map_high_memory(void) {
+    const pmm_region_t *r;
+    uint32_t n = pmm_regions(&r);
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t lo = r[i].base, hi = r[i].base + r[i].size;
+
+        if (lo < ZYNQMP_DDR_HIGH_BASE) lo = ZYNQMP_DDR_HIGH_BASE;
+        if (hi > ZYNQMP_DDR_HIGH_BASE + ZYNQMP_DDR_HIGH_SIZE) hi = ZYNQMP_DDR_HIGH_BASE + ZYNQMP_DDR_HIGH_SIZE;
+        lo = (lo + PMM_GIGA_SIZE - 1) & ~(PMM_GIGA_SIZE - 1);
+
+        // L0 entry 0 covers the first 512GB, so the high window stays in kernel_l1_table
+        for (uint64_t pa = lo; pa + PMM_GIGA_SIZE <= hi; pa += PMM_GIGA_SIZE) {
+            kernel_l1_table[pa >> 30] = pa | PT_BLOCK_DESC | PT_AF | PT_ACCESS_PRIV_RW |
+                                        PT_SH_INNER | PT_UXN | PT_PXN | (1 << 2);
+        }
+    }
 }
 
 /*
@@ -137,8 +181,10 @@ void mmu_create_identity_map(void) {
  */
 void mmu_enable(void) {
     uint64_t sctlr;
+    int bp = bootprof_begin("mmu_enable");
 
-    // 1. Set Translation Table Base Registers
+    // 1. Set Translation Table Base Registers (tables were written with the MMU off)
+    asm volatile("dsb ish");
     asm volatile("msr ttbr0_el1, %0" : : "r" (kernel_l0_table));
     asm volatile("msr ttbr1_el1, %0" : : "r" (kernel_l0_table));
     asm volatile("isb");
@@ -160,26 +206,80 @@ void mmu_enable(void) {
     
     // 4. Verify
     // If we are here, virtual memory is active.
+    bootprof_end(bp);
+}
+
+/*
+ * vmm_next_table
+ * Table behind 'entry', allocating a zeroed one if the entry is invalid.
+ * NULL for block entries: the boot identity map is never split here.
+ */
+static uint64_t *vmm_next_table(uint64_t *entry) {
+    uint64_t pa;
+
+    if ((*entry & 0x3) == PT_TABLE_DESC) {
+        return (uint64_t *)(uintptr_t)(*entry & PT_ADDR_MASK);
+    }
+    if (*entry & 0x1) {
+        return NULL;
+    }
+
+    pa = pmm_alloc(PMM_PAGE_SIZE, PMM_F_LOW | PMM_F_ZERO);
+    if (pa == 0) {
+        return NULL;
+    }
+    asm volatile("dsb ishst" ::: "memory");     // Zeroed table before it is linked
+    *entry = pa | PT_TABLE_DESC;
+    return (uint64_t *)(uintptr_t)pa;
+}
+
+static void vmm_flush_page(uint64_t va) {
+    asm volatile("dsb ishst" ::: "memory");
+    asm volatile("tlbi vaae1is, %0" :: "r" (va >> 12));
+    asm volatile("dsb ish; isb" ::: "memory");
 }
 
 /*
  * vmm_map_page
  * Dynamically maps a Virtual Page to a Physical Frame.
- * Used by the HOCS Process Loader when starting new tasks.
- * * @param va: Virtual Address
- * @param pa: Physical Address
- * @param flags: R/W/X permissions
+ * Used for EL0 task mappings (user window, see kernel/user.h). Tables are
+ * walked through the cacheable identity map, so no cache maintenance is
+ * needed with the MMU on.
+ * * @param va: Virtual Address (4KB aligned)
+ * @param pa: Physical Address (4KB aligned)
+ * @param flags: Descriptor attributes (AP, SH, XN, AttrIndx), e.g. VMM_USER_RW
+ * Returns 0, or -1 if a table could not be allocated or 'va' lies in a block.
  */
 int vmm_map_page(uint64_t va, uint64_t pa, uint64_t flags) {
-    // Traverse L0 -> L1 -> L2 -> L3
-    // If a table is missing, allocate a new physical page for the table.
-    
-    uint64_t l0_idx = (va >> 39) & 0x1FF;
-    uint64_t l1_idx = (va >> 30) & 0x1FF;
-    uint64_t l2_idx = (va >> 21) & 0x1FF;
-    uint64_t l3_idx = (va >> 12) & 0x1FF;
-
-    // Implementation omitted for brevity in this snippet.
-    // Full implementation requires Physical Memory Manager (PMM).
-    return 0; // Success
+    uint64_t *l1, *l2, *l3;
+
+    l1 = vmm_next_table(&kernel_l0_table[(va >> 39) & 0x1FF]);
+    if (l1 == NULL) return -1;
+    l2 = vmm_next_table(&l1[(va >> 30) & 0x1FF]);
+    if (l2 == NULL) return -1;
+    l3 = vmm_next_table(&l2[(va >> 21) & 0x1FF]);
+    if (l3 == NULL) return -1;
+
+    l3[(va >> 12) & 0x1FF] = (pa & PT_ADDR_MASK) | PT_PAGE_DESC | PT_AF | flags;
+    vmm_flush_page(va);
+    return 0;
+}
+
+/*
+ * vmm_unmap_page
+ * Invalidates the L3 entry for 'va' (tables are kept).
+ */
+void vmm_unmap_page(uint64_t va) {
+    uint64_t *t = kernel_l0_table;
+
+    for (int shift = 39; shift >= 21; shift -= 9) {
+        uint64_t e = t[(va >> shift) & 0x1FF];
+        if ((e & 0x3) != PT_TABLE_DESC) {
+            return;
+        }
+        t = (uint64_t *)(uintptr_t)(e & PT_ADDR_MASK);
+    }
+
+    t[(va >> 12) & 0x1FF] = PT_INVALID;
+    vmm_flush_page(va);
 }
@@ -0,0 +1,600 @@
+/*
+ * ======================================================================================
+ * COPYRIGHT (C) 2026 PHOTONX TECHNOLOGIES. ALL RIGHTS RESERVED.
+ * ======================================================================================
+ * File:        pmm.c
+ * Module:      Physical Memory Manager Implementation
+ * Author:      PhotonX R&D Team
+ *
+ * DESCRIPTION:
+ * Bitmap zones with next-fit search. Allocations are naturally aligned up
+ * to the zone's mapping block (2MB low, 1GB high) so large buffers can be
+ * covered by block descriptors. Address 0 is never handed out (the kernel
+ * image lives there), so it doubles as the failure value.
+ *
+ * Callers on core 0 (threads and IRQs) and on the secondaries running
+ * smp_run_on() work are serialized by masking IRQs up to
+ * IRQ_PRIO_CEIL_KERNEL on the local core plus a spinlock across cores.
+ * ======================================================================================
+ */
+
+#include "mm/pmm.h"
+#include "platform/zynqmp_hardware.h"
+#include "mm/mmu_defs.h"
+#include "kernel/timer_heavy.h"
+#include "kernel/irq_prio.h"
+#include "lib/kprintf.h"
+
+#define PMM_LOW_BITS            (uint32_t)(ZYNQMP_DDR_LOW_SIZE >> PMM_PAGE_SHIFT)
+#define PMM_HIGH_BITS           (uint32_t)(ZYNQMP_DDR_HIGH_SIZE >> PMM_HUGE_SHIFT)
+
+static uint64_t low_map[PMM_LOW_BITS / 64];
+static uint64_t high_map[PMM_HIGH_BITS / 64];
+
+static pmm_zone_t zones[PMM_ZONES] = {
+    [PMM_ZONE_LOW] = {
+        .name = "low",
+        .base = ZYNQMP_DDR_LOW_BASE,
+        .span = ZYNQMP_DDR_LOW_SIZE,
+        .granule_shift = PMM_PAGE_SHIFT,
+        .map = low_map,
+        .map_bits = PMM_LOW_BITS
+    },
+    [PMM_ZONE_HIGH] = {
+        .name = "high",
+        .base = ZYNQMP_DDR_HIGH_BASE,
+        .span = ZYNQMP_DDR_HIGH_SIZE,
+        .granule_shift = PMM_HUGE_SHIFT,
+        .map = high_map,
+        .map_bits = PMM_HIGH_BITS
+    }
+};
+
+static pmm_region_t regions[PMM_MAX_REGIONS];
+static uint32_t region_count = 0;
+static uint16_t colors_claimed = 0;
+
+static uint8_t pmm_spin;
+
+/* Priority-masked: the system timer stays live while the bitmaps are busy */
+static inline uint32_t pmm_lock(void) {
+    uint32_t saved = irq_prio_save_and_raise(IRQ_PRIO_CEIL_KERNEL);
+
+    while (__atomic_test_and_set(&pmm_spin, __ATOMIC_ACQUIRE)) {
+        asm volatile("yield");
+    }
+    return saved;
+}
+
+static inline void pmm_unlock(uint32_t saved) {
+    __atomic_clear(&pmm_spin, __ATOMIC_RELEASE);
+    irq_prio_restore(saved);
+}
+
+/*
+ * ======================================================================================
+ * BITMAP HELPERS
+ * ======================================================================================
+ */
+
+static inline int map_test(const pmm_zone_t *z, uint32_t i) {
+    return (z->map[i >> 6] >> (i & 63)) & 1;
+}
+
+static void map_fill(pmm_zone_t *z, uint32_t first, uint32_t count, int used) {
+    for (uint32_t i = first; i < first + count; i++) {
+        if (used) {
+            z->map[i >> 6] |= (1ULL << (i & 63));
+        } else {
+            z->map[i >> 6] &= ~(1ULL << (i & 63));
+        }
+    }
+}
+
+static inline uint32_t align_up32(uint32_t v, uint32_t a) {
+    return (v + a - 1) & ~(a - 1);
+}
+
+/*
+ * zone_clip
+ * Intersects [base, base+size) with the zone window, rounded to 'unit'
+ * (inward if shrink, outward otherwise). Returns the granule range.
+ */
+static int zone_clip(const pmm_zone_t *z, uint64_t base, uint64_t size, uint64_t unit,
+                     int shrink, uint32_t *first, uint32_t *count) {
+    uint64_t lo = base, hi = base + size;
+
+    if (lo < z->base) lo = z->base;
+    if (hi > z->base + z->span) hi = z->base + z->span;
+    if (hi <= lo) {
+        return 0;
+    }
+
+    if (shrink) {
+        lo = (lo + unit - 1) & ~(unit - 1);
+        hi &= ~(unit - 1);
+    } else {
+        lo &= ~(unit - 1);
+        hi = (hi + unit - 1) & ~(unit - 1);
+        if (hi > z->base + z->span) hi = z->base + z->span;
+    }
+    if (hi <= lo) {
+        return 0;
+    }
+
+    *first = (uint32_t)((lo - z->base) >> z->granule_shift);
+    *count = (uint32_t)((hi - lo) >> z->granule_shift);
+    return 1;
+}
+
+/*
+ * zone_find
+ * Next-fit search for 'n' clear bits starting on a multiple of 'align',
+ * at a granule whose page color is in 'start_colors'.
+ */
+static int64_t zone_find(const pmm_zone_t *z, uint32_t n, uint32_t align, uint16_t start_colors) {
+    for (int pass = 0; pass < 2; pass++) {
+        uint32_t i = pass ? 0 : align_up32(z->hint, align);
+        uint32_t limit = pass ? z->hint : z->map_bits;
+
+        while (i < limit && i + n <= z->map_bits) {
+            uint32_t j = 0;
+
+            /* Skip fully used words */
+            if ((i & 63) == 0 && z->map[i >> 6] == ~0ULL) {
+                i = align_up32(i + 64, align);
+                continue;
+            }
+
+            if (!((start_colors >> (i & (PMM_COLORS - 1))) & 1)) {
+                i += align;
+                continue;
+            }
+
+            while (j < n) {
+                uint32_t b = i + j;
+                if ((b & 63) == 0 && j + 64 <= n && z->map[b >> 6] == 0) {
+                    j += 64;
+                    continue;
+                }
+                if (map_test(z, b)) {
+                    break;
+                }
+                j++;
+            }
+
+            if (j == n) {
+                return (int64_t)i;
+            }
+            i = align_up32(i + j + 1, align);
+        }
+    }
+    return -1;
+}
+
+/*
+ * zone_alloc
+ * Natural alignment up to the zone's mapping block (2MB low, 1GB high).
+ * Colored requests are page aligned only: alignment would fix the color.
+ */
+static uint64_t zone_alloc(pmm_zone_t *z, size_t size, uint16_t start_colors) {
+    uint64_t granule = 1ULL << z->granule_shift;
+    uint64_t cap = (z == &zones[PMM_ZONE_HIGH]) ? PMM_GIGA_SIZE : PMM_HUGE_SIZE;
+    uint32_t n = (uint32_t)((size + granule - 1) >> z->granule_shift);
+    uint64_t align_bytes = granule;
+    int64_t idx;
+
+    if (n == 0 || (uint64_t)n * granule > z->free) {
+        return 0;
+    }
+
+    while (start_colors == PMM_COLOR_ALL && align_bytes < cap && align_bytes * 2 <= size) {
+        align_bytes *= 2;
+    }
+
+    idx = zone_find(z, n, (uint32_t)(align_bytes >> z->granule_shift), start_colors);
+    if (idx < 0) {
+        return 0;
+    }
+
+    map_fill(z, (uint32_t)idx, n, 1);
+    z->free -= (uint64_t)n * granule;
+    z->hint = (uint32_t)idx + n;
+    if (z->hint >= z->map_bits) z->hint = 0;
+
+    return z->base + ((uint64_t)idx << z->granule_shift);
+}
+
+static void pmm_zero(uint64_t pa, size_t size) {
+    uint64_t *p = (uint64_t *)(uintptr_t)pa;
+    for (size_t w = 0; w < (size + 7) / 8; w++) {
+        p[w] = 0;
+    }
+}
+
+/*
+ * ======================================================================================
+ * PUBLIC API
+ * ======================================================================================
+ */
+
+/*
+ * pmm_init
+ * Everything starts unavailable; regions are opened by pmm_add_region().
+ */
+void pmm_init(void) {
+    for (uint32_t z = 0; z < PMM_ZONES; z++) {
+        pmm_zone_t *zone = &zones[z];
+        for (uint32_t w = 0; w < zone->map_bits / 64; w++) {
+            zone->map[w] = ~0ULL;
+        }
+        zone->present = 0;
+        zone->reserved = 0;
+        zone->free = 0;
+        zone->hint = 0;
+    }
+    region_count = 0;
+}
+
+/*
+ * pmm_add_region
+ * Registers installed DDR. High-window memory is trimmed to whole
+ * gigabytes so every allocatable byte sits inside a 1GB block mapping.
+ */
+int pmm_add_region(uint64_t base, uint64_t size) {
+    int added = 0;
+
+    if (region_count >= PMM_MAX_REGIONS) {
+        return -1;
+    }
+
+    for (uint32_t zi = 0; zi < PMM_ZONES; zi++) {
+        pmm_zone_t *z = &zones[zi];
+        uint64_t unit = (zi == PMM_ZONE_HIGH) ? PMM_GIGA_SIZE : PMM_PAGE_SIZE;
+        uint32_t first, count;
+
+        if (!zone_clip(z, base, size, unit, 1, &first, &count)) {
+            continue;
+        }
+
+        uint64_t bytes = (uint64_t)count << z->granule_shift;
+        map_fill(z, first, count, 0);
+        z->present += bytes;
+        z->free += bytes;
+        added = 1;
+    }
+
+    if (!added) {
+        kprintf("[PMM] WARN: ignoring DDR range %p+%lu MB (outside both windows)\n",
+                (void *)base, size >> 20);
+        return -1;
+    }
+
+    regions[region_count].base = base;
+    regions[region_count].size = size;
+    region_count++;
+    return 0;
+}
+
+/*
+ * pmm_reserve
+ * Takes a range out of circulation (kernel image, DTB, persistent block).
+ * Rounds outward to whole granules.
+ */
+void pmm_reserve(uint64_t base, uint64_t size) {
+    for (uint32_t zi = 0; zi < PMM_ZONES; zi++) {
+        pmm_zone_t *z = &zones[zi];
+        uint64_t granule = 1ULL << z->granule_shift;
+        uint32_t first, count;
+
+        if (!zone_clip(z, base, size, granule, 0, &first, &count)) {
+            continue;
+        }
+
+        for (uint32_t i = first; i < first + count; i++) {
+            if (!map_test(z, i)) {
+                map_fill(z, i, 1, 1);
+                z->free -= granule;
+                z->reserved += granule;
+            }
+        }
+    }
+}
+
+/*
+ * pmm_alloc
+ * Returns a physical address, or 0 on failure.
+ * Zone order: PMM_F_LOW -> low only; PMM_F_HIGH -> high, then low unless
+ * PMM_F_STRICT (boards without high DDR still work); default -> low, high.
+ */
+uint64_t pmm_alloc(size_t size, uint32_t flags) {
+    pmm_zone_id_t order[PMM_ZONES];
+    uint32_t n = 0;
+    uint64_t pa = 0;
+    uint32_t irq;
+
+    if (flags & PMM_F_LOW) {
+        order[n++] = PMM_ZONE_LOW;
+    } else if (flags & PMM_F_HIGH) {
+        order[n++] = PMM_ZONE_HIGH;
+        if (!(flags & PMM_F_STRICT)) order[n++] = PMM_ZONE_LOW;
+    } else {
+        order[n++] = PMM_ZONE_LOW;
+        order[n++] = PMM_ZONE_HIGH;
+    }
+
+    irq = pmm_lock();
+    for (uint32_t i = 0; i < n && pa == 0; i++) {
+        pa = zone_alloc(&zones[order[i]], size, PMM_COLOR_ALL);
+    }
+    pmm_unlock(irq);
+
+    if (pa && (flags & PMM_F_ZERO)) {
+        pmm_zero(pa, size);
+    }
+
+    return pa;
+}
+
+/*
+ * pmm_alloc_colored
+ * Contiguous low-zone memory in which every page has a color in 'colors'.
+ * A run of n pages covers n consecutive colors, so 'colors' must contain
+ * such a run; for larger working sets allocate several runs.
+ */
+uint64_t pmm_alloc_colored(size_t size, uint16_t colors, uint32_t flags) {
+    uint32_t n = (uint32_t)((size + PMM_PAGE_SIZE - 1) >> PMM_PAGE_SHIFT);
+    uint16_t starts = 0;
+    uint64_t pa;
+    uint32_t irq;
+
+    if (colors == PMM_COLOR_ALL) {
+        return pmm_alloc(size, flags | PMM_F_LOW);
+    }
+    if (n == 0 || n > PMM_COLORS) {
+        return 0;
+    }
+
+    /* 1. Start colors whose run of n stays inside the set */
+    for (uint32_t c = 0; c < PMM_COLORS; c++) {
+        uint32_t k = 0;
+        while (k < n && ((colors >> ((c + k) & (PMM_COLORS - 1))) & 1)) k++;
+        if (k == n) starts |= (uint16_t)(1U << c);
+    }
+    if (starts == 0) {
+        return 0;
+    }
+
+    /* 2. High-zone granules (2MB) span every color: low zone only */
+    irq = pmm_lock();
+    pa = zone_alloc(&zones[PMM_ZONE_LOW], size, starts);
+    pmm_unlock(irq);
+
+    if (pa && (flags & PMM_F_ZERO)) {
+        pmm_zero(pa, size);
+    }
+
+    return pa;
+}
+
+/*
+ * pmm_color_claim
+ * Reserves a color set for one owner (e.g. the control loop). Fails if any
+ * color is already claimed, so claimed sets are always disjoint.
+ */
+int pmm_color_claim(uint16_t colors) {
+    int rc = -1;
+    uint32_t irq = pmm_lock();
+
+    if (colors && !(colors_claimed & colors)) {
+        colors_claimed |= colors;
+        rc = 0;
+    }
+
+    pmm_unlock(irq);
+    return rc;
+}
+
+void pmm_color_release(uint16_t colors) {
+    uint32_t irq = pmm_lock();
+    colors_claimed &= (uint16_t)~colors;
+    pmm_unlock(irq);
+}
+
+uint16_t pmm_colors_free(void) {
+    return (uint16_t)~colors_claimed;
+}
+
+/*
+ * pmm_free
+ * 'size' must match the allocation.
+ */
+void pmm_free(uint64_t pa, size_t size) {
+    uint32_t irq = pmm_lock();
+
+    for (uint32_t zi = 0; zi < PMM_ZONES; zi++) {
+        pmm_zone_t *z = &zones[zi];
+        uint64_t granule = 1ULL << z->granule_shift;
+        uint32_t first, count;
+
+        if (pa < z->base || pa >= z->base + z->span) {
+            continue;
+        }
+        if (zone_clip(z, pa, size, granule, 0, &first, &count)) {
+            map_fill(z, first, count, 0);
+            z->free += (uint64_t)count * granule;
+        }
+        break;
+    }
+
+    pmm_unlock(irq);
+}
+
+pmm_zone_t *pmm_zone(pmm_zone_id_t id) {
+    return (id < PMM_ZONES) ? &zones[id] : NULL;
+}
+
+uint32_t pmm_regions(const pmm_region_t **out) {
+    *out = regions;
+    return region_count;
+}
+
+uint64_t pmm_total_present(void) {
+    return zones[PMM_ZONE_LOW].present + zones[PMM_ZONE_HIGH].present;
+}
+
+void pmm_dump(void) {
+    for (uint32_t i = 0; i < region_count; i++) {
+        kprintf("[PMM] DDR range %u: %p - %p (%lu MB)\n", i, (void *)regions[i].base,
+                (void *)(regions[i].base + regions[i].size - 1), regions[i].size >> 20);
+    }
+
+    for (uint32_t zi = 0; zi < PMM_ZONES; zi++) {
+        const pmm_zone_t *z = &zones[zi];
+        kprintf("[PMM] zone %s: %lu MB present, %lu MB reserved, %lu MB free (%lu KB granule)\n",
+                z->name, z->present >> 20, z->reserved >> 20, z->free >> 20,
+                (1UL << z->granule_shift) >> 10);
+    }
+}
+
+/*
+ * ======================================================================================
+ * BENCHMARK
+ * ======================================================================================
+ * The secondary cores are parked, so the co-runner is time-sliced on the
+ * same core: between two control-loop periods it streams a buffer twice
+ * the size of the L2, as a render or bulk copy on another core would.
+ * That also wipes the L1, so the figure isolates what coloring protects:
+ * the control loop's L2 residency.
+ */
+
+#define BENCH_RT_COLORS         0x000F  // 4 of 16 colors: 256KB of L2
+#define BENCH_RT_BYTES          (128 * 1024)
+#define BENCH_HOG_BYTES         (2 * PMM_L2_SIZE)
+#define BENCH_ITERS             256
+#define BENCH_MAX_CHUNKS        64
+#define BENCH_LINE              64
+
+typedef struct {
+    uint64_t pa[BENCH_MAX_CHUNKS];
+    uint32_t chunk;                 // Bytes per chunk
+    uint32_t count;
+} bench_buf_t;
+
+/*
+ * bench_buf_alloc
+ * colors == PMM_COLOR_ALL: one contiguous block cut into chunks.
+ * Otherwise: chunks of one run through the color set (colors must be one
+ * contiguous run, as the benchmark sets are).
+ */
+static int bench_buf_alloc(bench_buf_t *b, uint32_t bytes, uint16_t colors) {
+    uint32_t run = 0;
+
+    for (uint32_t c = 0; c < PMM_COLORS; c++) {
+        if ((colors >> c) & 1) run++;
+    }
+    b->chunk = (colors == PMM_COLOR_ALL) ? bytes / BENCH_MAX_CHUNKS : run * PMM_PAGE_SIZE;
+    b->count = 0;
+
+    if (colors == PMM_COLOR_ALL) {
+        uint64_t pa = pmm_alloc(bytes, PMM_F_LOW);
+        if (pa == 0) return -1;
+        for (uint32_t i = 0; i < BENCH_MAX_CHUNKS; i++) {
+            b->pa[b->count++] = pa + (uint64_t)i * b->chunk;
+        }
+        return 0;
+    }
+
+    while (b->count * b->chunk < bytes && b->count < BENCH_MAX_CHUNKS) {
+        uint64_t pa = pmm_alloc_colored(b->chunk, colors, PMM_F_LOW);
+        if (pa == 0) return -1;
+        b->pa[b->count++] = pa;
+    }
+    return 0;
+}
+
+static void bench_buf_free(bench_buf_t *b, uint16_t colors) {
+    if (b->count == 0) {
+        return;
+    }
+    if (colors == PMM_COLOR_ALL) {
+        pmm_free(b->pa[0], (size_t)b->chunk * b->count);
+    } else {
+        for (uint32_t i = 0; i < b->count; i++) {
+            pmm_free(b->pa[i], b->chunk);
+        }
+    }
+    b->count = 0;
+}
+
+/* One control-loop period: read-modify-write every line of the working set */
+static void bench_touch(const bench_buf_t *b) {
+    for (uint32_t i = 0; i < b->count; i++) {
+        volatile uint64_t *p = (volatile uint64_t *)(uintptr_t)b->pa[i];
+        for (uint32_t off = 0; off < b->chunk / 8; off += BENCH_LINE / 8) {
+            p[off] = p[off] + 1;
+        }
+    }
+}
+
+static void bench_run(const char *label, const bench_buf_t *rt, const bench_buf_t *hog) {
+    uint64_t sum = 0, worst = 0;
+
+    bench_touch(rt); // Warm
+
+    for (uint32_t it = 0; it < BENCH_ITERS; it++) {
+        if (hog) {
+            bench_touch(hog);
+        }
+
+        uint64_t t0 = timer_get_ticks();
+        bench_touch(rt);
+        uint64_t dt = timer_ticks_to_ns(timer_get_ticks() - t0);
+
+        sum += dt;
+        if (dt > worst) worst = dt;
+    }
+
+    kprintf("[PMM]   %s avg %lu ns, worst %lu ns\n", label, sum / BENCH_ITERS, worst);
+}
+
+/*
+ * pmm_color_benchmark
+ * Control-loop period with a cache-thrashing co-runner, uncolored vs.
+ * control loop on BENCH_RT_COLORS and co-runner on the rest.
+ */
+void pmm_color_benchmark(void) {
+    static bench_buf_t rt, hog;
+    uint64_t sctlr;
+
+    asm volatile("mrs %0, sctlr_el1" : "=r" (sctlr));
+    kprintf("[PMM] Page coloring benchmark: %u KB control loop, %u KB co-runner, %u colors\n",
+            BENCH_RT_BYTES / 1024, BENCH_HOG_BYTES / 1024, (unsigned int)PMM_COLORS);
+    if (!(sctlr & SCTLR_C_BIT)) {
+        kprintf("[PMM] WARN: D-cache is off, all three runs measure DDR\n");
+    }
+
+    /* 1. Uncolored: both buffers use every color */
+    if (bench_buf_alloc(&rt, BENCH_RT_BYTES, PMM_COLOR_ALL) == 0 &&
+        bench_buf_alloc(&hog, BENCH_HOG_BYTES, PMM_COLOR_ALL) == 0) {
+        bench_run("alone:              ", &rt, NULL);
+        bench_run("co-runner, shared:  ", &rt, &hog);
+    }
+    bench_buf_free(&rt, PMM_COLOR_ALL);
+    bench_buf_free(&hog, PMM_COLOR_ALL);
+
+    /* 2. Colored: disjoint sets */
+    if (pmm_color_claim(BENCH_RT_COLORS) != 0) {
+        kprintf("[PMM] benchmark colors already claimed, skipping colored run\n");
+        return;
+    }
+    if (bench_buf_alloc(&rt, BENCH_RT_BYTES, BENCH_RT_COLORS) == 0 &&
+        bench_buf_alloc(&hog, BENCH_HOG_BYTES, (uint16_t)~BENCH_RT_COLORS) == 0) {
+        bench_run("co-runner, colored: ", &rt, &hog);
+    } else {
+        kprintf("[PMM] not enough free pages for the colored run\n");
+    }
+    bench_buf_free(&rt, BENCH_RT_COLORS);
+    bench_buf_free(&hog, (uint16_t)~BENCH_RT_COLORS);
+    pmm_color_release(BENCH_RT_COLORS);
+}